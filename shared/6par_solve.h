@@ -333,6 +333,19 @@ public:
 		Rsh = 100;
 	}
 
+	void guess_from( const module6par &ref )
+	{
+		// initial conditions scaled from the solution of a similar module (warm start).
+		// 'a' tracks Voc (series cell count), currents track Isc, and the resistances
+		// track the same datasheet ratios used by guess()
+		a = ref.a * Voc / ref.Voc;
+		Il = ref.Il * Isc / ref.Isc;
+		Io = ref.Io * Isc / ref.Isc;
+		Rs = ref.Rs * ( (Voc - Vmp)/Imp ) / ( (ref.Voc - ref.Vmp)/ref.Imp );
+		Rsh = ref.Rsh * ( Voc/(Isc - Imp) ) / ( ref.Voc/(ref.Isc - ref.Imp) );
+		Adj = ref.Adj;
+	}
+
 	int sanity()
 	{
 		// ensure values are in "reasonable" ranges
@@ -74,6 +74,7 @@ cec6par_module_t::cec6par_module_t( )
 {
 	Area = Vmp = Imp = Voc = Isc = alpha_isc = beta_voc 
 		= a = Il = Io = Rs = Rsh = Adj = std::numeric_limits<double>::quiet_NaN();
+	UseLambertW = false;
 }
 double air_mass_modifier( double Zenith_deg, double Elev_m, double a[5] )
 {
@@ -84,14 +85,11 @@ double air_mass_modifier( double Zenith_deg, double Elev_m, double a[5] )
 	return f1 > 0.0 ? f1 : 0.0;
 }
 
-bool cec6par_module_t::operator() ( pvinput_t &input, double TcellC, double opvoltage, pvoutput_t &out )
+bool cec6par_module_t::operating_conditions( const pvinput_t &input, double TcellC, oper_t &op, double &aoi_modifier )
 {
 	double muIsc = alpha_isc * (1-Adj/100);
 	//double muVoc = beta_voc * (1+Adj/100);
 	
-	/* initialize output first */
-	out.Power = out.Voltage = out.Current = out.Efficiency = out.Voc_oper = out.Isc_oper= out.AOIModifier = 0.0;
-	
 	double G_front, G_total, Geff_front_total, Geff_total;
 
 	if( input.radmode != 3){ // Determine if the model needs to skip the cover effects (will only be skipped if the user is using POA reference cell data) 
@@ -109,11 +107,10 @@ bool cec6par_module_t::operator() ( pvinput_t &input, double TcellC, double opvo
 
 		Geff_total = Geff_front_total + input.Irear;
 
-		double aoi_modifier = 0.0;
+		aoi_modifier = 0.0;
 		if (G_front > 0.) {
 			aoi_modifier = Geff_front_total / G_front;
 		}
-		out.AOIModifier = aoi_modifier;
 
 	
 		double theta_z = input.Zenith;
@@ -132,50 +129,137 @@ bool cec6par_module_t::operator() ( pvinput_t &input, double TcellC, double opvo
 
 	}
 
-	double T_cell = input.Tdry + 273.15;
-	if ( Geff_total >= 1.0 ) 
-	{
-		T_cell = TcellC + 273.15; // want cell temp in kelvin
+	op.G_total = G_total;
+	if ( !(Geff_total >= 1.0) ) return false;
+
+	op.T_cell = TcellC + 273.15; // want cell temp in kelvin
 
-		// calculation of IL and IO at operating conditions
-		double IL_oper = Geff_total/I_ref *( Il + muIsc*(T_cell-Tc_ref) );
-		if (IL_oper < 0.0) IL_oper = 0.0;
+	// calculation of IL and IO at operating conditions
+	op.IL = Geff_total/I_ref *( Il + muIsc*(op.T_cell-Tc_ref) );
+	if (op.IL < 0.0) op.IL = 0.0;
 		
-		double EG = eg0 * (1-0.0002677*(T_cell-Tc_ref));
-		double IO_oper = Io * pow(T_cell/Tc_ref, 3) * exp( 1/KB*(eg0/Tc_ref - EG/T_cell) );
-		double A_oper = a * T_cell / Tc_ref;
-		double Rsh_oper = Rsh*(I_ref/Geff_total);
-			
-		double V_oc = openvoltage_5par( Voc, A_oper, IL_oper, IO_oper, Rsh_oper );
-		double I_sc = IL_oper/(1+Rs/Rsh_oper);
+	double EG = eg0 * (1-0.0002677*(op.T_cell-Tc_ref));
+	op.IO = Io * pow(op.T_cell/Tc_ref, 3) * exp( 1/KB*(eg0/Tc_ref - EG/op.T_cell) );
+	op.A = a * op.T_cell / Tc_ref;
+	op.Rsh = Rsh*(I_ref/Geff_total);
+	return true;
+}
+
+void cec6par_module_t::set_output( const oper_t &op, double V_oc, double P, double V, double I, pvoutput_t &out )
+{
+	out.Power = P;
+	out.Voltage  = V;
+	out.Current = I;
+	out.Efficiency = P/(Area*op.G_total);
+	out.Voc_oper = V_oc;
+	out.Isc_oper = op.IL/(1+Rs/op.Rsh);
+	out.CellTemp = op.T_cell - 273.15;
+}
+
+bool cec6par_module_t::operator() ( pvinput_t &input, double TcellC, double opvoltage, pvoutput_t &out )
+{
+	/* initialize output first */
+	out.Power = out.Voltage = out.Current = out.Efficiency = out.Voc_oper = out.Isc_oper= out.AOIModifier = 0.0;
+
+	oper_t op;
+	if ( operating_conditions( input, TcellC, op, out.AOIModifier ) ) 
+	{
+		double V_oc = UseLambertW ? openvoltage_5par_lambertw( op.A, op.IL, op.IO, op.Rsh )
+			: openvoltage_5par( Voc, op.A, op.IL, op.IO, op.Rsh );
 		
 		double P, V, I;
 		
 		if ( opvoltage < 0 )
 		{
-			P = maxpower_5par( V_oc, A_oper, IL_oper, IO_oper, Rs, Rsh_oper, &V, &I );			
+			if ( UseLambertW )
+				P = maxpower_5par_lambertw( op.A, op.IL, op.IO, Rs, op.Rsh, &V, &I );
+			else
+				P = maxpower_5par( V_oc, op.A, op.IL, op.IO, Rs, op.Rsh, &V, &I );			
 		}
 		else
 		{ // calculate power at specified operating voltage
 			V = opvoltage;
 			if (V >= V_oc) I = 0;
-			else I = current_5par( V, 0.9*IL_oper, A_oper, IL_oper, IO_oper, Rs, Rsh_oper );
+			else if ( UseLambertW ) I = fmax( 0.0, current_5par_lambertw( V, op.A, op.IL, op.IO, Rs, op.Rsh ) );
+			else I = current_5par( V, 0.9*op.IL, op.A, op.IL, op.IO, Rs, op.Rsh );
 
 			P = V*I;
 		}
 		
-		out.Power = P;
-		out.Voltage  = V;
-		out.Current = I;
-		out.Efficiency = P/(Area*G_total);
-		out.Voc_oper = V_oc;
-		out.Isc_oper = I_sc;
-		out.CellTemp = T_cell - 273.15;
+		set_output( op, V_oc, P, V, I, out );
 	}
 
 	return out.Power >= 0;
 }
 
+bool cec6par_module_t::run_batch( const pvinput_soa &input, const double *TcellC, const double *opvoltage, pvoutput_soa &output )
+{
+/*
+	With the Lambert-W solution, consecutive records with the same inputs and cell temperature, as in
+	a voltage sweep, share their operating conditions and open circuit voltage, and maximum power 
+	points return the open circuit voltage they solve for. Results are identical to the scalar form.
+	The iterative solvers use the default loop.
+*/
+	if ( !UseLambertW )
+		return pvmodule_t::run_batch( input, TcellC, opvoltage, output );
+
+	bool ok = true;
+	oper_t op;
+	double V_oc = 0, aoi = 0, P_mp = 0, V_mp = 0, I_mp = 0;
+	bool lit = false, have_mp = false;
+	pvinput_t in;
+	pvoutput_t out;
+	for( size_t i=0; i<input.size(); i++ )
+	{
+		bool find_mp = ( !opvoltage || opvoltage[i] < 0 );
+		if ( i == 0 || TcellC[i] != TcellC[i-1] || !input.equal( i, i-1 ) )
+		{
+			input.get( i, in );
+			aoi = 0;
+			lit = operating_conditions( in, TcellC[i], op, aoi );
+			have_mp = false;
+			if ( lit && find_mp )
+			{
+				P_mp = maxpower_5par_lambertw( op.A, op.IL, op.IO, Rs, op.Rsh, &V_mp, &I_mp, &V_oc );
+				have_mp = true;
+			}
+			else if ( lit )
+				V_oc = openvoltage_5par_lambertw( op.A, op.IL, op.IO, op.Rsh );
+		}
+
+		output.get( i, out );
+		out.Power = out.Voltage = out.Current = out.Efficiency = out.Voc_oper = out.Isc_oper = 0.0;
+		out.AOIModifier = aoi;
+		if ( lit )
+		{
+			double P, V, I;
+			if ( find_mp )
+			{
+				if ( !have_mp )
+				{
+					P_mp = maxpower_5par_lambertw( op.A, op.IL, op.IO, Rs, op.Rsh, &V_mp, &I_mp );
+					have_mp = true;
+				}
+				P = P_mp;
+				V = V_mp;
+				I = I_mp;
+			}
+			else
+			{ // calculate power at specified operating voltage
+				V = opvoltage[i];
+				if (V >= V_oc) I = 0;
+				else I = fmax( 0.0, current_5par_lambertw( V, op.A, op.IL, op.IO, Rs, op.Rsh ) );
+				P = V*I;
+			}
+			set_output( op, V_oc, P, V, I, out );
+		}
+		output.set( i, out );
+
+		if ( !(out.Power >= 0) )
+			ok = false;
+	}
+	return ok;
+}
 
 
 /**********************************************************************************************
@@ -185,6 +269,34 @@ bool cec6par_module_t::operator() ( pvinput_t &input, double TcellC, double opvo
  *********************************************************************************************/
 
 bool noct_celltemp_t::operator() ( pvinput_t &input, pvmodule_t &module, double , double &Tcell )
+{
+	celltemp( input, module, Tcell );
+	return true;
+}
+
+bool noct_celltemp_t::run_batch( const pvinput_soa &input, pvmodule_t &module, const double *, double *Tcell )
+{
+/*
+	The cell temperature doesn't depend on the operating voltage, so consecutive records with the same
+	inputs share it. Results are identical to the scalar form.
+*/
+	double T = 0;
+	bool set = false;
+	pvinput_t in;
+	for( size_t i=0; i<input.size(); i++ )
+	{
+		if ( i == 0 || !input.equal( i, i-1 ) )
+		{
+			input.get( i, in );
+			set = celltemp( in, module, T );
+		}
+		if ( set )
+			Tcell[i] = T;
+	}
+	return true;
+}
+
+bool noct_celltemp_t::celltemp( pvinput_t &input, pvmodule_t &module, double &Tcell )
 {
 	double G_total, Geff_total;
 	double tau_al = fabs(TauAlpha);
@@ -245,7 +357,7 @@ bool noct_celltemp_t::operator() ( pvinput_t &input, pvmodule_t &module, double
 		Tcell = Tcell-273.15;
 	}
 
-	return true;
+	return Geff_total > 0;
 }
 
 
@@ -790,3 +902,30 @@ bool mcsp_celltemp_t::operator() ( pvinput_t &input, pvmodule_t &module, double
 	Tcell = TC - 273.15;
 	return true;
 }
+
+bool mcsp_celltemp_t::run_batch( const pvinput_soa &input, pvmodule_t &module, const double *opvoltage, double *Tcell )
+{
+/*
+	Consecutive records with the same inputs and operating voltage share the cell temperature energy 
+	balance. Records whose balance fails keep their cell temperature, as in the scalar form.
+*/
+	bool ok = true, ok_run = true;
+	double T = 0, V_run = 0;
+	pvinput_t in;
+	for( size_t i=0; i<input.size(); i++ )
+	{
+		double V = opvoltage ? opvoltage[i] : -1.0;
+		if ( i == 0 || V != V_run || !input.equal( i, i-1 ) )
+		{
+			input.get( i, in );
+			T = Tcell[i];
+			V_run = V;
+			ok_run = (*this)( in, module, V, T );
+		}
+		if ( ok_run )
+			Tcell[i] = T;
+		else
+			ok = false;
+	}
+	return ok;
+}
@@ -76,6 +76,7 @@ public:
 	double Rs;
 	double Rsh;
 	double Adj;
+	bool UseLambertW; // solve the I-V curve with the explicit Lambert-W form rather than iteratively
 
 	cec6par_module_t();
 
@@ -86,6 +87,20 @@ public:
 	virtual double IscRef() { return Isc; }
 
 	virtual bool operator() ( pvinput_t &input, double TcellC, double opvoltage, pvoutput_t &output );
+	virtual bool run_batch( const pvinput_soa &input, const double *TcellC, const double *opvoltage, pvoutput_soa &output );
+
+protected:
+	// single diode parameters at operating conditions
+	struct oper_t
+	{
+		double G_total; // total incident irradiance, W/m2
+		double T_cell; // cell temperature, K
+		double IL, IO, A, Rsh;
+	};
+
+	// returns false if there is too little effective irradiance to calculate the operating point
+	bool operating_conditions( const pvinput_t &input, double TcellC, oper_t &op, double &aoi_modifier );
+	void set_output( const oper_t &op, double V_oc, double P, double V, double I, pvoutput_t &out );
 };
 
 
@@ -97,6 +112,11 @@ public:
 	double Tnoct;
 
 	virtual bool operator() ( pvinput_t &input, pvmodule_t &module, double opvoltage, double &Tcell );
+	virtual bool run_batch( const pvinput_soa &input, pvmodule_t &module, const double *opvoltage, double *Tcell );
+
+protected:
+	// returns false, leaving Tcell unchanged, if there is no effective irradiance
+	bool celltemp( pvinput_t &input, pvmodule_t &module, double &Tcell );
 };
 
 
@@ -114,6 +134,7 @@ public:
 	double TbackInteg;  // back surface temperature for integrated modules ('C)
 	
 	virtual bool operator() ( pvinput_t &input, pvmodule_t &module, double opvoltage, double &Tcell );
+	virtual bool run_batch( const pvinput_soa &input, pvmodule_t &module, const double *opvoltage, double *Tcell );
 };
 
 #endif
@@ -76,6 +76,7 @@ iec61853_module_t::iec61853_module_t()
 
 	NcellSer = 0;
 	GlassAR = false;
+	UseLambertW = false;
 	for( int i=0;i<5;i++ )
 		AMA[i] = std::numeric_limits<double>::quiet_NaN();
 
@@ -448,7 +449,7 @@ double Rs_fit_eqn( double _x, double *par, void * )
 
 
 bool iec61853_module_t::calculate( util::matrix_t<double> &input, int nseries, int Type, 
-	util::matrix_t<double> &par, bool verbose )
+	util::matrix_t<double> &par, bool verbose, const iec61853_module_t *warm )
 {
 	if (input.ncols() != COL_MAX) {
 		PRINTF( "incorrect number of data columns in input.  %d required", COL_MAX );
@@ -606,16 +607,56 @@ bool iec61853_module_t::calculate( util::matrix_t<double> &input, int nseries, i
 		double Rsh = Rsh_ref0 * 1000.0/Irr;
 		double Io = ( Il - Voc/Rsh )/( exp(Voc/a) - 1 );
 		double Rs = Rs_ref0;		
+
+		// a warm start evaluates the other module's fitted model at this condition, scaled by the
+		// ratio of the STC currents and resistances. Io follows from the open circuit point as above.
+		bool ok = false;
+		if ( warm != 0 && std::isfinite( warm->Il ) && warm->Isc0 > 0 && warm->Voc0 > 0 )
+		{
+			double iscale = Isc0 / warm->Isc0;
+			double rscale = ( Voc0 / Isc0 ) / ( warm->Voc0 / warm->Isc0 );
+			double dT = TcK - 298.15;
+			double Il_w = iscale * Irr/1000*( warm->Il + warm->alphaIsc*dT );
+			double Rs_w = rscale * ( warm->D1 + warm->D2*dT + warm->D3*( 1-Irr/1000.0)*pow(1000.0/Irr,2.0) );
+			double Rsh_w = rscale * ( warm->C1 + warm->C2*( pow(1000.0/Irr,warm->C3)-1 ) );
+			double Io_w = ( Il_w - Voc/Rsh_w )/( exp(Voc/a) - 1 );
+
+			if ( Il_w > 0 && Io_w > 0 && Rs_w > 0 && Rsh_w > 0
+				&& std::isfinite( Io_w ) && std::isfinite( Rs_w ) && std::isfinite( Rsh_w ) )
+			{
+				if ( verbose )
+					PRINTF("solving condition %d, warm guesses a=%lg Il=%lg Io=%lg Rs=%lg Rsh=%lg ...", i, a, Il_w, Io_w, Rs_w, Rsh_w );
+
+				ok = solve( Voc, Isc, Vmp, Imp, a,
+					&Il_w, &Io_w, &Rs_w, &Rsh_w )
+					&& std::isfinite( Il_w )
+					&& std::isfinite( Io_w )
+					&& std::isfinite( Rs_w )
+					&& std::isfinite( Rsh_w );
+				if ( ok )
+				{
+					Il = Il_w;
+					Io = Io_w;
+					Rs = Rs_w;
+					Rsh = Rsh_w;
+				}
+			}
+		}
 		
-		if ( verbose )
-			PRINTF("solving condition %d, guesses a=%lg Il=%lg Io=%lg Rs=%lg Rsh=%lg ...", i, a, Il, Io, Rs, Rsh );
-
-		if ( solve( Voc, Isc, Vmp, Imp, a,
-			&Il, &Io, &Rs, &Rsh )
-			&& std::isfinite( Il )
-			&& std::isfinite( Io )
-			&& std::isfinite( Rs )
-			&& std::isfinite( Rsh ) )
+		if ( !ok )
+		{
+			if ( verbose )
+				PRINTF("solving condition %d, guesses a=%lg Il=%lg Io=%lg Rs=%lg Rsh=%lg ...", i, a, Il, Io, Rs, Rsh );
+
+			ok = solve( Voc, Isc, Vmp, Imp, a,
+				&Il, &Io, &Rs, &Rsh )
+				&& std::isfinite( Il )
+				&& std::isfinite( Io )
+				&& std::isfinite( Rs )
+				&& std::isfinite( Rsh );
+		}
+
+		if ( ok )
 		{
 			par(i,IL) = Il;
 			par(i,IO) = Io;
@@ -703,6 +744,8 @@ bool iec61853_module_t::calculate( util::matrix_t<double> &input, int nseries, i
 	// do a nonlinear least squares to fit the Io equation as a function of temperature
 	// free parameter is Egref. initial guess is 1.0
 	double Egref_fit[1] = { 1.0 };
+	if ( warm != 0 && std::isfinite( warm->Egref ) )
+		Egref_fit[0] = warm->Egref;
 	if ( !lsqfit( Io_fit_eqn, 0, Egref_fit, 1, 
 		&Io_temps[0], &Io_avgs[0], Io_temps.size(), 
 		1e-9, 200, 20000 ) )
@@ -766,6 +809,12 @@ bool iec61853_module_t::calculate( util::matrix_t<double> &input, int nseries, i
 
 #ifdef CPAR_3
 	double C[3] = { 1000, 100, 0.25 }; // initial guesses for lsqfit
+	if ( warm != 0 && std::isfinite( warm->C1 ) && std::isfinite( warm->C2 ) && std::isfinite( warm->C3 ) )
+	{
+		C[0] = warm->C1;
+		C[1] = warm->C2;
+		C[2] = warm->C3;
+	}
 	if ( !lsqfit( Rsh_fit_eqn, 0, C, 3, 
 			&Rsh_irrads[0], &Rsh_avgs[0], Rsh_irrads.size(), 
 			1.0e-9, 500, 50000 ) )
@@ -775,6 +824,11 @@ bool iec61853_module_t::calculate( util::matrix_t<double> &input, int nseries, i
 	}
 #else
 	double C[3] = { 100, 0.25, 0 };
+	if ( warm != 0 && std::isfinite( warm->C2 ) && std::isfinite( warm->C3 ) )
+	{
+		C[0] = warm->C2;
+		C[1] = warm->C3;
+	}
 	
 	if ( !lsqfit( Rsh_fit_eqn_2par, &Rsh_stc, C, 2, 
 			&Rsh_irrads[0], &Rsh_avgs[0], Rsh_irrads.size(), 
@@ -818,6 +872,11 @@ bool iec61853_module_t::calculate( util::matrix_t<double> &input, int nseries, i
 		if ( Ivec.size() >= 3 )
 		{
 			double Dpr[2] = { 5.0, 1.0 };
+			if ( warm != 0 && std::isfinite( warm->D1 ) && std::isfinite( warm->D3 ) )
+			{
+				Dpr[0] = warm->D1;
+				Dpr[1] = warm->D3;
+			}
 			if ( !lsqfit( Rs_fit_eqn, 0, Dpr, 2, 
 				&Ivec[0], &Rsvec[0], Ivec.size(), 
 				1.0e-9, 400, 40000 ) )
@@ -880,11 +939,8 @@ bool iec61853_module_t::calculate( util::matrix_t<double> &input, int nseries, i
 	return true;
 }
 
-bool iec61853_module_t::operator() ( pvinput_t &input, double TcellC, double opvoltage, pvoutput_t &out )
+bool iec61853_module_t::operating_conditions( const pvinput_t &input, double TcellC, oper_t &op )
 {
-	/* initialize output first */
-	out.Power = out.Voltage = out.Current = out.Efficiency = out.Voc_oper = out.Isc_oper = 0.0;
-	
 	double poa, tpoa, iamf;
 	iamf = 1;
 
@@ -913,55 +969,132 @@ bool iec61853_module_t::operator() ( pvinput_t &input, double TcellC, double opv
 	else { // Otherwise use decomposed POA
 		tpoa = poa = input.Ibeam + input.Idiff + input.Ignd;
 	}
-	
-	double Tc = input.Tdry + 273.15;
-	if ( tpoa >= 1.0 )
-	{
-		Tc = TcellC + 273.15;
-		double q = 1.6e-19;
-		double k = 1.38e-23;
-		double aop = NcellSer*n*k*Tc/q;
-		double Ilop = tpoa/1000*(Il + alphaIsc*(Tc-298.15));
-		double Egop = (1-0.0002677*(Tc-298.15))*Egref;
-		double Ioop = Io*pow(Tc/298.15,3.0)*exp( 11600 * (Egref/298.15 - Egop/Tc));
-		double Rsop = D1 + D2*(Tc-298.15) + D3*( 1-tpoa/1000.0)*pow(1000.0/poa,2.0);
-		double Rshop = C1 + C2*( pow(1000.0/tpoa,C3)-1 );
-					
 
-		// at some very low irradiances, these parameters can blow up due to
-		// equations and keep the model from solving
-		//if ( Rsop > 1000 ) Rsop = 10000;
-		//if ( Rshop > 25000 ) Rshop = 25000;
+	op.poa = poa;
+	op.tpoa = tpoa;
+	op.iamf = iamf;
+	if ( tpoa < 1.0 )
+		return false;
 
-		double V_oc = openvoltage_5par( Voc0, aop, Ilop, Ioop, Rshop );
-		double I_sc = Ilop/(1+Rsop/Rshop);
-		
+	double Tc = TcellC + 273.15;
+	double q = 1.6e-19;
+	double k = 1.38e-23;
+	op.Tc = Tc;
+	op.a = NcellSer*n*k*Tc/q;
+	op.Il = tpoa/1000*(Il + alphaIsc*(Tc-298.15));
+	double Egop = (1-0.0002677*(Tc-298.15))*Egref;
+	op.Io = Io*pow(Tc/298.15,3.0)*exp( 11600 * (Egref/298.15 - Egop/Tc));
+	op.Rs = D1 + D2*(Tc-298.15) + D3*( 1-tpoa/1000.0)*pow(1000.0/poa,2.0);
+	op.Rsh = C1 + C2*( pow(1000.0/tpoa,C3)-1 );
+				
+
+	// at some very low irradiances, these parameters can blow up due to
+	// equations and keep the model from solving
+	//if ( Rsop > 1000 ) Rsop = 10000;
+	//if ( Rshop > 25000 ) Rshop = 25000;
+
+	op.V_oc = UseLambertW ? openvoltage_5par_lambertw( op.a, op.Il, op.Io, op.Rsh )
+		: openvoltage_5par( Voc0, op.a, op.Il, op.Io, op.Rsh );
+	op.I_sc = op.Il/(1+op.Rs/op.Rsh);
+	return true;
+}
+
+double iec61853_module_t::maxpower( const oper_t &op, double *V, double *I )
+{
+	double P;
+	if ( UseLambertW )
+		P = maxpower_5par_lambertw( op.a, op.Il, op.Io, op.Rs, op.Rsh, V, I );
+	else
+		P = maxpower_5par( op.V_oc, op.a, op.Il, op.Io, op.Rs, op.Rsh, V, I );
+	if ( P < 0 ) P = 0;
+	return P;
+}
+
+double iec61853_module_t::power_at_voltage( const oper_t &op, double opvoltage, double *V, double *I )
+{
+	*V = opvoltage;
+	if (*V >= op.V_oc) *I = 0;
+	else if ( UseLambertW ) *I = current_5par_lambertw( *V, op.a, op.Il, op.Io, op.Rs, op.Rsh );
+	else *I = current_5par( *V, 0.9*op.Il, op.a, op.Il, op.Io, op.Rs, op.Rsh );
+
+	if ( *I < 0 ) { *I=0; *V=0; }
+	return (*V)*(*I);
+}
+
+void iec61853_module_t::set_output( const oper_t &op, double P, double V, double I, pvoutput_t &out )
+{
+	out.Power = P;
+	out.Voltage  = V;
+	out.Current = I;
+	out.Efficiency = P/(Area*op.poa);
+	out.Voc_oper = op.V_oc;
+	out.Isc_oper = op.I_sc;
+	out.CellTemp = op.Tc - 273.15;
+	out.AOIModifier = op.iamf;
+}
+
+bool iec61853_module_t::operator() ( pvinput_t &input, double TcellC, double opvoltage, pvoutput_t &out )
+{
+	/* initialize output first */
+	out.Power = out.Voltage = out.Current = out.Efficiency = out.Voc_oper = out.Isc_oper = 0.0;
+	
+	oper_t op;
+	if ( operating_conditions( input, TcellC, op ) )
+	{
 		double P, V, I;
-		
 		if ( opvoltage < 0 )
+			P = maxpower( op, &V, &I );
+		else
+			P = power_at_voltage( op, opvoltage, &V, &I );
+		set_output( op, P, V, I, out );
+	}
+
+	return out.Power >= 0;
+}
+
+bool iec61853_module_t::run_batch( const pvinput_soa &input, const double *TcellC, const double *opvoltage, pvoutput_soa &output )
+{
+/*
+	Consecutive records with the same inputs and cell temperature, as in a voltage sweep, share their
+	operating conditions and maximum power point. Results are identical to the scalar form.
+*/
+	bool ok = true;
+	oper_t op;
+	double P_mp = 0, V_mp = 0, I_mp = 0;
+	bool lit = false, have_mp = false;
+	pvinput_t in;
+	pvoutput_t out;
+	for( size_t i=0; i<input.size(); i++ )
+	{
+		if ( i == 0 || TcellC[i] != TcellC[i-1] || !input.equal( i, i-1 ) )
 		{
-			P = maxpower_5par( V_oc, aop, Ilop, Ioop, Rsop, Rshop, &V, &I );
-			if ( P < 0 ) P = 0;
+			input.get( i, in );
+			lit = operating_conditions( in, TcellC[i], op );
+			have_mp = false;
 		}
-		else
-		{ // calculate power at specified operating voltage
-			V = opvoltage;
-			if (V >= V_oc) I = 0;
-			else I = current_5par( V, 0.9*Ilop, aop, Ilop, Ioop, Rsop, Rshop );
 
-			if ( I < 0 ) { I=0; V=0; }
-			P = V*I;
+		output.get( i, out );
+		out.Power = out.Voltage = out.Current = out.Efficiency = out.Voc_oper = out.Isc_oper = 0.0;
+		if ( lit )
+		{
+			double P, V, I;
+			if ( !opvoltage || opvoltage[i] < 0 )
+			{
+				if ( !have_mp )
+				{
+					P_mp = maxpower( op, &V_mp, &I_mp );
+					have_mp = true;
+				}
+				P = P_mp;
+				V = V_mp;
+				I = I_mp;
+			}
+			else
+				P = power_at_voltage( op, opvoltage[i], &V, &I );
+			set_output( op, P, V, I, out );
 		}
-						
-		out.Power = P;
-		out.Voltage  = V;
-		out.Current = I;
-		out.Efficiency = P/(Area*poa);
-		out.Voc_oper = V_oc;
-		out.Isc_oper = I_sc;
-		out.CellTemp = Tc - 273.15;
-		out.AOIModifier = iamf;
+		output.set( i, out );
+		ok = ok && out.Power >= 0;
 	}
-
-	return out.Power >= 0;
+	return ok;
 }
@@ -94,6 +94,8 @@ public:
 	bool GlassAR;
 	double AMA[5];
 
+	bool UseLambertW; // solve the I-V curve with the explicit Lambert-W form rather than iteratively
+
 	Imessage_api *_imsg;
 
 
@@ -103,8 +105,11 @@ public:
 	enum { IL, IO, RS, RSH, A, PARMAX };
 	static const char *par_names[PARMAX];
 	
+	// 'warm', if given, is an already fitted module of the same technology whose model
+	// gives the initial guesses for the solution at each test condition and whose
+	// coefficients are the initial guesses for the least squares fits
 	bool calculate( util::matrix_t<double> &input, int nseries, int type, 
-		util::matrix_t<double> &par, bool verbose );
+		util::matrix_t<double> &par, bool verbose, const iec61853_module_t *warm = 0 );
 	
 	bool solve( double Voc, double Isc, double Vmp, double Imp, double a,
 			double *p_Il, double *p_Io, double *p_Rs, double *p_Rsh );
@@ -117,6 +122,24 @@ public:
 	virtual double VocRef() { return Voc0; }
 	virtual double IscRef() { return Isc0; }
 	virtual bool operator() ( pvinput_t &input, double TcellC, double opvoltage, pvoutput_t &output );
+	virtual bool run_batch( const pvinput_soa &input, const double *TcellC, const double *opvoltage, pvoutput_soa &output );
+
+protected:
+	// single diode parameters at operating conditions
+	struct oper_t
+	{
+		double poa, tpoa; // incident and transmitted irradiance, W/m2
+		double iamf; // incidence angle modifier
+		double Tc; // cell temperature, K
+		double a, Il, Io, Rs, Rsh;
+		double V_oc, I_sc;
+	};
+
+	// returns false if the transmitted irradiance is too low to solve
+	bool operating_conditions( const pvinput_t &input, double TcellC, oper_t &op );
+	double maxpower( const oper_t &op, double *V, double *I );
+	double power_at_voltage( const oper_t &op, double opvoltage, double *V, double *I );
+	void set_output( const oper_t &op, double P, double V, double I, pvoutput_t &out );
 };
 
 
@@ -47,6 +47,7 @@
 *  THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 *******************************************************************************************************/
 
+#include <deque>
 #include <iomanip>
 #include <iostream>
 #include <limits>
@@ -512,7 +513,52 @@ double Max( double v1, double v2){
 	else return v2;
 }
 
-double GTI_DIRINT( const double poa[3], const double inc[3], double zen, double tilt, double ext, double alb, int doy, double tDew, double elev, double& dnOut, double& dfOut, double& ghOut, double poaCompOut[3]){
+// Angle dependent terms of the DIRINT model for one time step. GTI_DIRINT evaluates the model up to 30
+// times for the same angles and neighbouring time steps share them, so they are evaluated once per step.
+struct dirintAngleTerms
+{
+	double z;				// angle used as the zenith angle (radians), -999 if missing
+	double cz;				// cos(z)
+	double czMin;			// cos(z), not less than 0.065
+	double zenith;			// z (degrees)
+	double am;				// air mass
+	double ktPrimeScale;	// kt prime = kt / ktPrimeScale
+	double knc;				// clear sky beam transmittance polynomial of the air mass
+};
+
+static void dirint_angle_terms( double z, double alt, dirintAngleTerms &t )
+{
+	t.z = z;
+	t.cz = cos(z);
+	t.czMin = Max(0.065, t.cz);
+	t.zenith = z * 57.295779513082316;
+	t.am = Min(15.25, 1.0 / (t.cz + 0.15 * (pow(93.9 - t.zenith, -1.253))));
+	double ktpam = t.am * exp(-0.0001184 * alt);
+	t.ktPrimeScale = 1.031 * exp(-1.4 / (0.9 + 9.4 / ktpam)) + 0.1;
+	t.knc = 0.866 - 0.122 * t.am + 0.0121 * pow(t.am, 2.0) - 0.000653 * pow(t.am, 3.0) + 0.000014 * pow(t.am, 4.0);
+}
+
+static double dirint_extraterrestrial( int doy )
+{
+	return 1367.0 * (1.0 + 0.033 * cos(0.0172142 * doy));    // Extraterrestrial dn
+}
+
+static int dirint_dew_point_bin( double td )
+{
+	if (td < -998.0)
+		return 4;
+
+	double wbin[3] = { 1.0, 2.0, 3.0 };
+	double w = exp(-0.075 + 0.07 * td);
+	int l = 0;
+	while (l < 3 && w >= wbin[l])
+		l++;
+	return l;
+}
+
+static double ModifiedDISC( const double g[3], const dirintAngleTerms *z[3], double io, int dewPointBin, double &dn );
+
+double GTI_DIRINT( const double poa[3], const dirintAngleTerms *inc[3], double zen, double tilt, double ext, double alb, double io, int dewPointBin, double& dnOut, double& dfOut, double& ghOut, double poaCompOut[3]){
 	
 	double diff = 1E6;
 	double bestDiff = 1E6;
@@ -531,6 +577,7 @@ double GTI_DIRINT( const double poa[3], const double inc[3], double zen, double
 	// Begin iterative solution for Kt
 //	double Io = 1367.0 * (1.0 + 0.033 * cos(0.0172142 * doy));    // Extraterrestrial dn (Taken from DIRINT Model)
 	double cz = cos(zen);
+	double czMin = Max(0.065, cz);
 	int i = 0;
 	
 	while (fabs(diff) > 1.0 && i++ < 30 ){
@@ -540,17 +587,17 @@ double GTI_DIRINT( const double poa[3], const double inc[3], double zen, double
 
 		//Calculate GNI using Kt and DIRINT Eq.s
 		double dn_tmp;
-		double Ktp_tmp = ModifiedDISC( GTI, inc, tDew, elev, doy, dn_tmp);
+		double Ktp_tmp = ModifiedDISC( GTI, inc, io, dewPointBin, dn_tmp);
 
 		//Calculate DHI using Eq. 3
-		double df_tmp = GTI[1] * Max( 0.065, cz) / Max(0.065, cos(inc[1])) - dn_tmp*cz;
+		double df_tmp = GTI[1] * czMin / inc[1]->czMin - dn_tmp*cz;
 
 		//Check for bad values
 		if( dn_tmp < 0 ) dn_tmp = 0;
 		if( df_tmp < 0 ) df_tmp = 0;
 
 		//Model POA using Perez model and find diff from GTI (Model - GTI)
-		perez( ext, dn_tmp, df_tmp, alb, inc[1], tilt, zen, poa_tmp, diffc_tmp );
+		perez( ext, dn_tmp, df_tmp, alb, inc[1]->z, tilt, zen, poa_tmp, diffc_tmp );
 
 		//Compare modeled POA to measured POA
 		diff = ( poa_tmp[0] + poa_tmp[1] + poa_tmp[2]) - poa[1];   
@@ -568,9 +615,12 @@ double GTI_DIRINT( const double poa[3], const double inc[3], double zen, double
 
 		// Adjust GTI using Eq. 4
 		// Apply the same change to previous/ subsequent GTI's as well (based on Bill's email)
-		GTI[0] = Max( 1.0, GTI[0] - Ci[i] * diff);
-		GTI[1] = Max( 1.0, GTI[1] - Ci[i] * diff);
-		GTI[2] = Max( 1.0, GTI[2] - Ci[i] * diff);
+		// The last iteration has no step size left in Ci and its adjustment would never be used
+		if (i < 30) {
+			GTI[0] = Max( 1.0, GTI[0] - Ci[i] * diff);
+			GTI[1] = Max( 1.0, GTI[1] - Ci[i] * diff);
+			GTI[2] = Max( 1.0, GTI[2] - Ci[i] * diff);
+		}
 
 	}
 
@@ -578,78 +628,151 @@ double GTI_DIRINT( const double poa[3], const double inc[3], double zen, double
 	poaCompOut[1] = poaBest[1];
 	poaCompOut[2] = poaBest[2];
 
-	ghOut = dnOut * cos(inc[1]) + dfOut;
+	ghOut = dnOut * inc[1]->cz + dfOut;
 
 	return Ktp;
 }
 
-void poaDecomp( double , double angle[], double sun[], double alb, poaDecompReq *pA, double &dn, double &df, double &gh, double poa[3], double diffc[3]){
+static size_t poa_steps_in_day( const poaDecompReq *pA )
+{
+	size_t stepsInDay = 24;
+	if( pA->stepScale == 'm'){
+		stepsInDay *= 60 / (unsigned int)pA->stepSize;
+	}
+	return stepsInDay;
+}
+
+// Inputs shared by the decomposition of every time step in one day. The DIRINT angle terms are evaluated
+// when first needed, and the average Kt prime for a morning or evening is kept for the following steps.
+class poaDecompDay
+{
+public:
+	poaDecompDay( const poaDecompReq *pA, size_t dayStart, int doy )
+		: pA(pA), dayStart(dayStart), doy(doy), stepsInDay(poa_steps_in_day(pA)), io(dirint_extraterrestrial(doy)),
+		ktpValid(false), ktpStart(0), ktpAlb(0), ktpDew(0), ktpAverage(0)
+	{
+		missing.z = -999.0;
+		terms.resize(stepsInDay + 2);
+		evaluated.assign(stepsInDay + 2, false);
+	}
+
+	// POA at time step j, -999 for steps outside of the POA arrays
+	double poa( size_t j ) const
+	{
+		if (pA->numberOfSteps > 0 && j >= pA->numberOfSteps) return -999.0;
+		return pA->POA[j];
+	}
+
+	// DIRINT angle terms for the incidence angle at time step j, missing for steps outside of the POA arrays
+	const dirintAngleTerms *angles( size_t j )
+	{
+		if (pA->numberOfSteps > 0 && j >= pA->numberOfSteps) return &missing;
+		size_t k = j + 1 - dayStart;
+		if (k >= terms.size()) {
+			extra.push_back(dirintAngleTerms());
+			dirint_angle_terms(pA->inc[j], pA->elev, extra.back());
+			return &extra.back();
+		}
+		if (!evaluated[k]) {
+			dirint_angle_terms(pA->inc[j], pA->elev, terms[k]);
+			evaluated[k] = true;
+		}
+		return &terms[k];
+	}
+
+	const poaDecompReq *pA;
+	size_t dayStart;
+	int doy;
+	size_t stepsInDay;
+	double io;
+
+	bool ktpValid;
+	size_t ktpStart;
+	double ktpAlb, ktpDew, ktpAverage;
+
+private:
+	std::vector<dirintAngleTerms> terms; // time steps dayStart-1 to dayStart+stepsInDay
+	std::vector<bool> evaluated;
+	std::deque<dirintAngleTerms> extra; // time steps outside of the day, only if i is not in the day
+	dirintAngleTerms missing;
+};
+
+static void poa_decomp_step( poaDecompDay &day, size_t i, double tDew, double inc, double tilt, double zen, double hextra, double alb, double &dn, double &df, double &gh, double poa[3], double diffc[3] ){
 	/* Decomposes POA into direct normal and diffuse irradiances */
 
+	const poaDecompReq *pA = day.pA;
 	double r90(M_PI/2), r80( 80.0/180*M_PI ), r65(65.0/180*M_PI);
+	int dewPointBin = dirint_dew_point_bin(tDew);
 
-	if ( angle[0] < r90 ){  // Check if incident angle if greater than 90 degrees
+	if ( inc < r90 ){  // Check if incident angle if greater than 90 degrees
 		
-		double gti[] = {pA->POA[ pA->i-1 ], pA->POA[ pA->i ], pA->POA[ pA->i+1 ]};
-		double inc[] = {pA->inc[ pA->i-1 ], pA->inc[ pA->i ], pA->inc[ pA->i+1 ]};
+		double gti[] = {day.poa( i-1 ), day.poa( i ), day.poa( i+1 )};
+		const dirintAngleTerms *incTerms[] = {day.angles( i-1 ), day.angles( i ), day.angles( i+1 )};
 
-		GTI_DIRINT( gti, inc, sun[1], angle[1], sun[8], alb, pA->doy, pA->tDew, pA->elev, dn, df, gh, poa );
+		GTI_DIRINT( gti, incTerms, zen, tilt, hextra, alb, day.io, dewPointBin, dn, df, gh, poa );
 
 	} else {
 
-		size_t stepsInDay = 24;
-		if( pA->stepScale == 'm'){
-			stepsInDay *= 60 / (unsigned int)pA->stepSize;
-		}
-		 
-		size_t noon = pA->dayStart + stepsInDay/2;
+		size_t noon = day.dayStart + day.stepsInDay/2;
 		size_t start, stop;
 		// Check for a morning value or evening, set looping bounds accordingly
-		if( pA->i < noon ){ // Calculate morning value
-			start = pA->dayStart;
+		if( i < noon ){ // Calculate morning value
+			start = day.dayStart;
 			stop = noon;
 		} else {
 			start = noon;
-			stop = pA->dayStart + stepsInDay;
+			stop = day.dayStart + day.stepsInDay;
 		}
+		if (pA->numberOfSteps > 0 && stop > pA->numberOfSteps)
+			stop = pA->numberOfSteps;
 
-
-		// Determine an average Kt prime value
-		int count = 0;
+		// Determine an average Kt prime value, the same for every step in the morning or evening with the same albedo and dew point
 		double avgKtp = 0;
+		if (day.ktpValid && day.ktpStart == start && day.ktpAlb == alb && day.ktpDew == tDew) {
+			avgKtp = day.ktpAverage;
+		}
+		else {
+			int count = 0;
 
-		for( size_t j = start; j < stop; j++ ){
+			for( size_t j = start; j < stop; j++ ){
 
 
-			if( (pA->inc[j] < r80) && (pA->inc[j] > r65) ){
-				count++;
-				double gti[] = {pA->POA[ j-1 ], pA->POA[ j ], pA->POA[ j+1 ]};
-				double inc[] = {pA->inc[ j-1 ], pA->inc[ j ], pA->inc[ j+1 ]};
+				if( (pA->inc[j] < r80) && (pA->inc[j] > r65) ){
+					count++;
+					double gti[] = {day.poa( j-1 ), day.poa( j ), day.poa( j+1 )};
+					const dirintAngleTerms *incTerms[] = {day.angles( j-1 ), day.angles( j ), day.angles( j+1 )};
 
-				double dnTmp, dfTmp, ghTmp, poaTmp[3];
-				avgKtp += GTI_DIRINT( gti, inc, pA->zen[j], pA->tilt[j], pA->exTer[j], alb, pA->doy, pA->tDew, pA->elev, dnTmp, dfTmp, ghTmp, poaTmp );
+					double dnTmp, dfTmp, ghTmp, poaTmp[3];
+					avgKtp += GTI_DIRINT( gti, incTerms, pA->zen[j], pA->tilt[j], pA->exTer[j], alb, day.io, dewPointBin, dnTmp, dfTmp, ghTmp, poaTmp );
+				}
 			}
-		}
 
-		avgKtp /= count;
+			avgKtp /= count;
+
+			day.ktpValid = true;
+			day.ktpStart = start;
+			day.ktpAlb = alb;
+			day.ktpDew = tDew;
+			day.ktpAverage = avgKtp;
+		}
 
 		//Calculate Kt
-		double am = Min(15.25, 1.0 / (cos(sun[1]) + 0.15 * (pow(93.9 - sun[1]*180/M_PI, -1.253)))); // air mass
+		double am = Min(15.25, 1.0 / (cos(zen) + 0.15 * (pow(93.9 - zen*180/M_PI, -1.253)))); // air mass
         double ktpam = am * exp(-0.0001184 * pA->elev);
 		double Kt = avgKtp *( 1.031 * exp( -1.4/ (0.9 + 9.4/ktpam) ) + 0.1);
 
 		//Calculate DNI using DIRINT
 		double Kt_[3]  = {-999, Kt,               -999 };
 		double Ktp_[3] = {-999, avgKtp,           -999 };
-		double gti[3]  = {-999, pA->POA[ pA->i ], -999 };
-		double zen[3]  = {-999, sun[1]          , -999 }; // Might need to be Zenith angle instead of inciden
+		double gti[3]  = {-999, pA->POA[ i ],     -999 };
+		double zen_[3] = {-999, zen             , -999 }; // Might need to be Zenith angle instead of inciden
 
-		ModifiedDISC( Kt_, Ktp_, gti, zen, pA->tDew, pA->elev, pA->doy, dn);
+		ModifiedDISC( Kt_, Ktp_, gti, zen_, tDew, pA->elev, day.doy, dn);
 		
 		// Calculate DHI and GHI
-		double ct = cos(angle[1]);
-		df = (2*pA->POA[pA->i] - dn*cos(sun[1])*alb*(1-ct)) / (1 + ct + alb*(1-ct)) ;
-		gh = dn * cos( angle[0] ) + df;
+		double ct = cos(tilt);
+		df = (2*pA->POA[i] - dn*cos(zen)*alb*(1-ct)) / (1 + ct + alb*(1-ct)) ;
+		gh = dn * cos( inc ) + df;
 
 		//Check for bad values
 		if(dn<0) dn = 0;
@@ -657,11 +780,58 @@ void poaDecomp( double , double angle[], double sun[], double alb, poaDecompReq
 		if(gh<0) gh = 0;
 
 		// Get component poa from Perez
-		perez( sun[8], dn, df, alb, angle[0], angle[1], sun[1], poa, diffc );
+		perez( hextra, dn, df, alb, inc, tilt, zen, poa, diffc );
 	
 	}
 }
 
+void poaDecomp( double , double angle[], double sun[], double alb, poaDecompReq *pA, double &dn, double &df, double &gh, double poa[3], double diffc[3]){
+	/* Decomposes POA into direct normal and diffuse irradiances */
+
+	// use the result from poaDecompDays if it was computed for the same inputs
+	if ( pA->i < pA->decomposed.size() ){
+		const poaDecompResult &r = pA->decomposed[pA->i];
+		if ( r.valid && r.doy == pA->doy && r.dayStart == pA->dayStart && r.alb == alb && r.tDew == pA->tDew
+			&& angle[0] == pA->inc[pA->i] && angle[1] == pA->tilt[pA->i] && sun[1] == pA->zen[pA->i] && sun[8] == pA->exTer[pA->i] ){
+			dn = r.dn;
+			df = r.df;
+			gh = r.gh;
+			for (int k = 0; k < 3; k++) {
+				poa[k] = r.poa[k];
+				if (diffc != 0) diffc[k] = r.diffc[k];
+			}
+			return;
+		}
+	}
+
+	poaDecompDay day( pA, pA->dayStart, pA->doy );
+	poa_decomp_step( day, pA->i, pA->tDew, angle[0], angle[1], sun[1], sun[8], alb, dn, df, gh, poa, diffc );
+}
+
+void poaDecompDays( poaDecompReq *pA, size_t firstDay, size_t lastDay ){
+
+	size_t stepsInDay = poa_steps_in_day(pA);
+	for ( size_t d = firstDay; d < lastDay; d++ ){
+		size_t dayStart = d * stepsInDay;
+		poaDecompDay day( pA, dayStart, (int)d );
+
+		for ( size_t i = dayStart; i < dayStart + stepsInDay && i < pA->numberOfSteps; i++ ){
+			poaDecompResult &r = pA->decomposed[i];
+			r = poaDecompResult();
+
+			// sun is down
+			if ( pA->inc[i] == -999 ) continue;
+
+			r.doy = (int)d;
+			r.dayStart = dayStart;
+			r.alb = pA->albedo[i];
+			r.tDew = pA->dewPoint[i];
+			poa_decomp_step( day, i, r.tDew, pA->inc[i], pA->tilt[i], pA->zen[i], pA->exTer[i], r.alb, r.dn, r.df, r.gh, r.poa, r.diffc );
+			r.valid = true;
+		}
+	}
+}
+
 void isotropic( double , double dn, double df, double alb, double inc, double tilt, double zen, double poa[3], double diffc[3] )
 {
 /* added aug2011 by aron dobos. Defines isotropic sky model for diffuse irradiance on a tilted surface
@@ -866,12 +1036,7 @@ irrad::irrad(Irradiance_IO * irradianceIO, Subarray_IO * subarrayIO)
 	weather_header hdr = irradiance->weatherHeader;
 
 	int month_idx = wf.month - 1;
-	if (irradiance->useWeatherFileAlbedo && std::isfinite(wf.alb) && wf.alb > 0 && wf.alb < 1) {
-		albedo = wf.alb;
-	}
-	else if (month_idx >= 0 && month_idx < 12) {
-		albedo = irradiance->userSpecifiedMonthlyAlbedo[month_idx];
-	}
+	albedo = get_albedo(wf, irradiance->useWeatherFileAlbedo, irradiance->userSpecifiedMonthlyAlbedo);
 	
 	set_time(wf.year, wf.month, wf.day, wf.hour, wf.minute,
 		irradiance->instantaneous ? IRRADPROC_NO_INTERPOLATE_SUNRISE_SUNSET : irradiance->dtHour);
@@ -896,6 +1061,16 @@ irrad::irrad(Irradiance_IO * irradianceIO, Subarray_IO * subarrayIO)
 		subarray->groundCoverageRatio);	
 }
 
+double irrad::get_albedo(const weather_record &wf, bool useWeatherFileAlbedo, const std::vector<double> &monthlyAlbedo)
+{
+	int month_idx = wf.month - 1;
+	if (useWeatherFileAlbedo && std::isfinite(wf.alb) && wf.alb > 0 && wf.alb < 1)
+		return wf.alb;
+	else if (month_idx >= 0 && month_idx < 12 && month_idx < (int)monthlyAlbedo.size())
+		return monthlyAlbedo[month_idx];
+	return -999;
+}
+
 int irrad::check()
 {
 	if (year < 0 || month < 0 || day < 0 || hour < 0 || minute < 0 || delt > 1) return -1;
@@ -1058,6 +1233,29 @@ int irrad::calc()
 	int code = check();
 	if ( code < 0 )
 		return -100+code;
+
+	calc_sun();
+	return calc_surface();
+}
+
+void irrad::get_sun_position(sunPosition &sun)
+{
+	for (size_t i = 0; i < 9; i++)
+		sun.angles[i] = sunAnglesRadians[i];
+	for (size_t i = 0; i < 3; i++)
+		sun.timeStep[i] = timeStepSunPosition[i];
+}
+
+void irrad::set_sun_position(const sunPosition &sun)
+{
+	for (size_t i = 0; i < 9; i++)
+		sunAnglesRadians[i] = sun.angles[i];
+	for (size_t i = 0; i < 3; i++)
+		timeStepSunPosition[i] = sun.timeStep[i];
+}
+
+void irrad::calc_sun()
+{
 /*
 	calculates effective sun position at current timestep, with delt specified in hours
 
@@ -1128,8 +1326,10 @@ int irrad::calc()
 		timeStepSunPosition[1] = 0;
 		timeStepSunPosition[2] = 0;
 	}
+}
 
-			
+int irrad::calc_surface()
+{
 	planeOfArrayIrradianceFront[0]=planeOfArrayIrradianceFront[1]=planeOfArrayIrradianceFront[2] = 0;
 	diffuseIrradianceFront[0]=diffuseIrradianceFront[1]=diffuseIrradianceFront[2] = 0;
 	surfaceAnglesRadians[0]=surfaceAnglesRadians[1]=surfaceAnglesRadians[2]=surfaceAnglesRadians[3]=surfaceAnglesRadians[4] = 0;
@@ -1197,7 +1397,30 @@ int irrad::calc()
 
 }
 
+// view factor of each one degree arc of the 180 degree field of view of a cell row, 0.5 * [cos(j) - cos(j+1)]
+struct arcViewFactorTable
+{
+	double factor[180];
+	arcViewFactorTable()
+	{
+		for (size_t j = 0; j != 180; j++)
+			factor[j] = 0.5 * (cos(j * DTOR) - cos((j + 1) * DTOR));
+	}
+};
+static const arcViewFactorTable arcViewFactors;
+
+rearSideWorkspace::rearSideWorkspace()
+	: skyFactorsValid(false), rowToRow(0), verticalHeight(0), clearanceGround(0), distanceBetweenRows(0), horizontalLength(0)
+{
+}
+
 int irrad::calc_rear_side(double transmissionFactor, double bifaciality, double groundClearanceHeight, double slopeLength)
+{
+	rearSideWorkspace workspace;
+	return calc_rear_side(transmissionFactor, bifaciality, groundClearanceHeight, slopeLength, workspace);
+}
+
+int irrad::calc_rear_side(double transmissionFactor, double bifaciality, double groundClearanceHeight, double slopeLength, rearSideWorkspace &workspace)
 {
 	// do irradiance calculations if sun is up
 	if (timeStepSunPosition[2] > 0)
@@ -1214,29 +1437,35 @@ int irrad::calc_rear_side(double transmissionFactor, double bifaciality, double
 		double verticalHeight = slopeLength * sin(tiltRadian);
 		double horizontalLength = slopeLength * cos(tiltRadian);
 
-		// Determine the factors for points on the ground from the leading edge of one row of PV panels to the edge of the next row of panels behind
-		std::vector<double> rearSkyConfigFactors, frontSkyConfigFactors;
-		this->getSkyConfigurationFactors(rowToRow, verticalHeight, clearanceGround, distanceBetweenRows, horizontalLength, rearSkyConfigFactors, frontSkyConfigFactors);
+		// Determine the factors for points on the ground from the leading edge of one row of PV panels to the edge of the next row of panels behind.
+		// These depend only on the geometry, so they are reused until the surface tilt changes
+		if (!workspace.skyFactorsValid || rowToRow != workspace.rowToRow || verticalHeight != workspace.verticalHeight || clearanceGround != workspace.clearanceGround
+			|| distanceBetweenRows != workspace.distanceBetweenRows || horizontalLength != workspace.horizontalLength)
+		{
+			this->getSkyConfigurationFactors(rowToRow, verticalHeight, clearanceGround, distanceBetweenRows, horizontalLength, workspace.rearSkyConfigFactors, workspace.frontSkyConfigFactors);
+			workspace.rowToRow = rowToRow;
+			workspace.verticalHeight = verticalHeight;
+			workspace.clearanceGround = clearanceGround;
+			workspace.distanceBetweenRows = distanceBetweenRows;
+			workspace.horizontalLength = horizontalLength;
+			workspace.skyFactorsValid = true;
+		}
 
 		// Determine if ground is shading from direct beam radio for points on the ground from leading edge of PV panels to leading edge of next row behind
 		double pvBackShadeFraction, pvFrontShadeFraction, maxShadow;
 		pvBackShadeFraction = pvFrontShadeFraction = maxShadow = 0;
-		std::vector<int> rearGroundShade, frontGroundShade;
-		this->getGroundShadeFactors(rowToRow, verticalHeight, clearanceGround, distanceBetweenRows, horizontalLength, sunAnglesRadians[0], sunAnglesRadians[2], rearGroundShade, frontGroundShade, maxShadow, pvBackShadeFraction, pvFrontShadeFraction);
+		this->getGroundShadeFactors(rowToRow, verticalHeight, clearanceGround, distanceBetweenRows, horizontalLength, sunAnglesRadians[0], sunAnglesRadians[2], workspace.rearGroundShade, workspace.frontGroundShade, maxShadow, pvBackShadeFraction, pvFrontShadeFraction);
 
 		// Get the rear ground GHI
-		std::vector<double> rearGroundGHI, frontGroundGHI;
-		this->getGroundGHI(transmissionFactor, rearSkyConfigFactors, frontSkyConfigFactors, rearGroundShade, frontGroundShade, rearGroundGHI, frontGroundGHI);
+		this->getGroundGHI(transmissionFactor, workspace.rearSkyConfigFactors, workspace.frontSkyConfigFactors, workspace.rearGroundShade, workspace.frontGroundShade, workspace.rearGroundGHI, workspace.frontGroundGHI);
 
 		// Calculate the irradiance on the front of the PV module (to get front reflected)
-		std::vector<double> frontIrradiancePerCellrow, frontReflected;
 		double frontAverageIrradiance = 0;
-		getFrontSurfaceIrradiances(pvFrontShadeFraction, rowToRow, verticalHeight, clearanceGround, distanceBetweenRows, horizontalLength, frontGroundGHI, frontIrradiancePerCellrow, frontAverageIrradiance, frontReflected);
+		getFrontSurfaceIrradiances(pvFrontShadeFraction, rowToRow, verticalHeight, clearanceGround, distanceBetweenRows, horizontalLength, workspace.frontGroundGHI, workspace.frontIrradiance, frontAverageIrradiance, workspace.frontReflected);
 
 		// Calculate the irradiance on the back of the PV module
-		std::vector<double> rearIrradiancePerCellrow;
 		double rearAverageIrradiance = 0;
-		getBackSurfaceIrradiances(pvBackShadeFraction, rowToRow, verticalHeight, clearanceGround, distanceBetweenRows, horizontalLength, rearGroundGHI, frontGroundGHI, frontReflected, rearIrradiancePerCellrow, rearAverageIrradiance);
+		getBackSurfaceIrradiances(pvBackShadeFraction, rowToRow, verticalHeight, clearanceGround, distanceBetweenRows, horizontalLength, workspace.rearGroundGHI, workspace.frontGroundGHI, workspace.frontReflected, workspace.rearIrradiance, rearAverageIrradiance);
 		planeOfArrayIrradianceRearAverage = rearAverageIrradiance * bifaciality;
 	}
 	return true;
@@ -1248,6 +1477,8 @@ void irrad::getSkyConfigurationFactors(double rowToRow, double verticalHeight, d
 	size_t intervals = 100;
 	double deltaInterval = static_cast<double>(rowToRow / intervals);
 	double x = -deltaInterval / 2.0;
+	rearSkyConfigFactors.resize(intervals);
+	frontSkyConfigFactors.resize(intervals);
 
 	for (size_t i = 0; i != intervals; i++)
 	{
@@ -1300,8 +1531,8 @@ void irrad::getSkyConfigurationFactors(double rowToRow, double verticalHeight, d
 		}
 		skyAll = sky1 + sky2 + sky3;
 
-		rearSkyConfigFactors.push_back(skyAll);
-		frontSkyConfigFactors.push_back(skyAll);
+		rearSkyConfigFactors[i] = skyAll;
+		frontSkyConfigFactors[i] = skyAll;
 	}
 }
 
@@ -1410,24 +1641,19 @@ void irrad::getGroundShadeFactors(double rowToRow, double verticalHeight, double
 
 	}
 	double x = -deltaInterval / 2.0;
+	rearGroundShade.resize(intervals);
+	frontGroundShade.resize(intervals);
 	for (size_t i = 0; i != intervals; i++)
 	{
 		x += deltaInterval;
-		if ((x >= shadingStart1 && x < shadingEnd1) || (x >= shadingStart2 && x < shadingEnd2))
-		{
-			rearGroundShade.push_back(1);
-			frontGroundShade.push_back(1);
-		}
-		else
-		{
-			rearGroundShade.push_back(0);
-			frontGroundShade.push_back(0);
-		}
+		int shaded = ((x >= shadingStart1 && x < shadingEnd1) || (x >= shadingStart2 && x < shadingEnd2)) ? 1 : 0;
+		rearGroundShade[i] = shaded;
+		frontGroundShade[i] = shaded;
 	}
 	maxShadow = fmax(shadingStart1, shadingEnd1);
 }
 
-void irrad::getGroundGHI(double transmissionFactor, std::vector<double> rearSkyConfigFactors, std::vector<double> frontSkyConfigFactors, std::vector<int> rearGroundShade, std::vector<int> frontGroundShade, std::vector<double> & rearGroundGHI, std::vector<double> & frontGroundGHI)
+void irrad::getGroundGHI(double transmissionFactor, const std::vector<double> & rearSkyConfigFactors, const std::vector<double> & frontSkyConfigFactors, const std::vector<int> & rearGroundShade, const std::vector<int> & frontGroundShade, std::vector<double> & rearGroundGHI, std::vector<double> & frontGroundGHI)
 {
 	// Calculate the diffuse components of irradiance
 	perez(0, calculatedDirectNormal, calculatedDiffuseHorizontal,albedo, sunAnglesRadians[1], 0.0, sunAnglesRadians[1], planeOfArrayIrradianceRear, diffuseIrradianceRear);
@@ -1436,11 +1662,13 @@ void irrad::getGroundGHI(double transmissionFactor, std::vector<double> rearSkyC
 	double circumsolarDiffuse = diffuseIrradianceRear[1];
 
 	// Sum the irradiance components for each of the ground segments to the front and rear of the front of the PV row
+	rearGroundGHI.resize(100);
+	frontGroundGHI.resize(100);
 	for (size_t i = 0; i != 100; i++)
 	{
 		// Add diffuse sky component viewed by ground
-		rearGroundGHI.push_back(rearSkyConfigFactors[i] * isotropicDiffuse);
-		frontGroundGHI.push_back(frontSkyConfigFactors[i] * isotropicDiffuse);
+		rearGroundGHI[i] = rearSkyConfigFactors[i] * isotropicDiffuse;
+		frontGroundGHI[i] = frontSkyConfigFactors[i] * isotropicDiffuse;
 
 		if (rearGroundShade[i] == 0)
 		{
@@ -1463,7 +1691,7 @@ void irrad::getGroundGHI(double transmissionFactor, std::vector<double> rearSkyC
 	}
 }
 
-void irrad::getFrontSurfaceIrradiances(double pvFrontShadeFraction, double rowToRow, double verticalHeight, double clearanceGround, double distanceBetweenRows, double horizontalLength, std::vector<double> frontGroundGHI, std::vector<double> & frontIrradiance, double & frontAverageIrradiance, std::vector<double> & frontReflected)
+void irrad::getFrontSurfaceIrradiances(double pvFrontShadeFraction, double rowToRow, double verticalHeight, double clearanceGround, double distanceBetweenRows, double horizontalLength, const std::vector<double> & frontGroundGHI, std::vector<double> & frontIrradiance, double & frontAverageIrradiance, std::vector<double> & frontReflected)
 {
 	// front surface assumed to be glass
 	double n2 = 1.526;
@@ -1499,8 +1727,14 @@ void irrad::getFrontSurfaceIrradiances(double pvFrontShadeFraction, double rowTo
 	double PtopX = -distanceBetweenRows;			 // x value for point on top edge of PV module/panel of row in front of (in PV panel slope lengths)
 	double PtopY = verticalHeight + clearanceGround; // y value for point on top edge of PV module/panel of row in front of (in PV panel slope lengths)
 
+	// Direct and circumsolar irradiance components, the same for every cell row
+	incidence(0, tiltRadians * RTOD, surfaceAzimuthRadians * RTOD, 45.0, solarZenithRadians, solarAzimuthRadians, this->enableBacktrack, this->groundCoverageRatio, surfaceAnglesRadians);
+	perez(0, calculatedDirectNormal, calculatedDiffuseHorizontal, albedo, surfaceAnglesRadians[0], surfaceAnglesRadians[1], solarZenithRadians, poa, diffc);
+
 	// Calculate diffuse and direct component irradiances for each cell row (assuming 6 rows)
 	size_t cellRows = 6;
+	frontIrradiance.resize(cellRows);
+	frontReflected.resize(cellRows);
 	for (size_t i = 0; i != cellRows; i++)
 	{
 		// Calculate diffuse irradiances and reflected amounts for each cell row over its field of view of 180 degrees, 
@@ -1513,20 +1747,20 @@ void irrad::getFrontSurfaceIrradiances(double pvFrontShadeFraction, double rowTo
 		size_t iHorBright = (size_t)round(fmax(0.0, 6.0 - elevationAngleUp / DTOR));	   			       // Number of whole degrees for which horizon brightening occurs
 		size_t iStartGrd = (size_t)round((M_PI - tiltRadians + elevationAngleDown) / DTOR);                          // First whole degree in arc range that sees ground, last is 180
 
-		frontIrradiance.push_back(0.);
-		frontReflected.push_back(0.);
+		frontIrradiance[i] = 0.;
+		frontReflected[i] = 0.;
 		double reflectanceNormalIncidence = pow((n2 - 1.0) / (n2 + 1.0), 2.0);
 
 		// Add sky diffuse component and horizon brightening if present
 		for (size_t j = 0; j != iStopIso; j++)
 		{
-			frontIrradiance[i] += 0.5 * (cos(j * DTOR) - cos((j + 1)*DTOR)) * MarionAOICorrectionFactorsGlass[j] * isotropicSkyDiffuse;
-			frontReflected[i] += 0.5 * (cos(j * DTOR) - cos((j + 1)*DTOR)) * isotropicSkyDiffuse * (1.0 - MarionAOICorrectionFactorsGlass[j] * (1.0 - reflectanceNormalIncidence));
+			frontIrradiance[i] += arcViewFactors.factor[j] * MarionAOICorrectionFactorsGlass[j] * isotropicSkyDiffuse;
+			frontReflected[i] += arcViewFactors.factor[j] * isotropicSkyDiffuse * (1.0 - MarionAOICorrectionFactorsGlass[j] * (1.0 - reflectanceNormalIncidence));
 
 			if ((iStopIso - j) <= iHorBright)
 			{
-				frontIrradiance[i] += 0.5 * (cos(j * DTOR) - cos((j + 1) * DTOR)) * MarionAOICorrectionFactorsGlass[j] * horizonDiffuse / 0.052246; // 0.052246 = 0.5 * [cos(84) - cos(90)]
-				frontReflected[i] += 0.5 * (cos(j * DTOR) - cos((j + 1) * DTOR)) * (horizonDiffuse / 0.052246) * (1.0 - MarionAOICorrectionFactorsGlass[j] * (1.0 - reflectanceNormalIncidence));
+				frontIrradiance[i] += arcViewFactors.factor[j] * MarionAOICorrectionFactorsGlass[j] * horizonDiffuse / 0.052246; // 0.052246 = 0.5 * [cos(84) - cos(90)]
+				frontReflected[i] += arcViewFactors.factor[j] * (horizonDiffuse / 0.052246) * (1.0 - MarionAOICorrectionFactorsGlass[j] * (1.0 - reflectanceNormalIncidence));
 			}
 		}
 
@@ -1596,13 +1830,10 @@ void irrad::getFrontSurfaceIrradiances(double pvFrontShadeFraction, double rowTo
 					actualGroundGHI /= projectedX2 - projectedX1;
 				}
 			}
-			frontIrradiance[i] += 0.5 * (cos(j * DTOR) - cos((j + 1) * DTOR)) * MarionAOICorrectionFactorsGlass[j] * actualGroundGHI * this->albedo;
-			frontReflected[i] += 0.5 * (cos(j * DTOR) - cos((j + 1) * DTOR)) * actualGroundGHI * this->albedo * (1.0 - MarionAOICorrectionFactorsGlass[j] * (1.0 - reflectanceNormalIncidence));
+			frontIrradiance[i] += arcViewFactors.factor[j] * MarionAOICorrectionFactorsGlass[j] * actualGroundGHI * this->albedo;
+			frontReflected[i] += arcViewFactors.factor[j] * actualGroundGHI * this->albedo * (1.0 - MarionAOICorrectionFactorsGlass[j] * (1.0 - reflectanceNormalIncidence));
 		}
-		// Calculate and add direct and circumsolar irradiance components
-		incidence(0, tiltRadians * RTOD, surfaceAzimuthRadians * RTOD, 45.0, solarZenithRadians, solarAzimuthRadians, this->enableBacktrack, this->groundCoverageRatio, surfaceAnglesRadians);
-		perez(0, calculatedDirectNormal, calculatedDiffuseHorizontal, albedo, surfaceAnglesRadians[0], surfaceAnglesRadians[1], solarZenithRadians, poa, diffc);
-
+		// Add direct and circumsolar irradiance components
 		double cellShade = pvFrontShadeFraction * cellRows - i;
 
 		// Fully shaded if >1, no shade if < 0, otherwise fractionally shaded
@@ -1623,7 +1854,7 @@ void irrad::getFrontSurfaceIrradiances(double pvFrontShadeFraction, double rowTo
 	}
 }
 
-void irrad::getBackSurfaceIrradiances(double pvBackShadeFraction, double rowToRow, double verticalHeight, double clearanceGround, double distanceBetweenRows, double horizontalLength, std::vector<double> rearGroundGHI, std::vector<double> frontGroundGHI, std::vector<double> frontReflected, std::vector<double> & rearIrradiance, double & rearAverageIrradiance)
+void irrad::getBackSurfaceIrradiances(double pvBackShadeFraction, double rowToRow, double verticalHeight, double clearanceGround, double distanceBetweenRows, double horizontalLength, const std::vector<double> & rearGroundGHI, const std::vector<double> & frontGroundGHI, const std::vector<double> & frontReflected, std::vector<double> & rearIrradiance, double & rearAverageIrradiance)
 {
 	// front surface assumed to be glass
 	double n2 = 1.526;
@@ -1657,8 +1888,13 @@ void irrad::getBackSurfaceIrradiances(double pvBackShadeFraction, double rowToRo
 	double PtopX = rowToRow + horizontalLength;      // x value for point on top edge of PV module/panel of row in back of (in PV panel slope lengths)
 	double PtopY = verticalHeight + clearanceGround; // y value for point on top edge of PV module/panel of row in back of (in PV panel slope lengths)
 
+	// Direct and circumsolar irradiance components, the same for every cell row
+	incidence(0, 180.0 - tiltRadians * RTOD, (surfaceAzimuthRadians * RTOD - 180.0), 45.0, solarZenithRadians, solarAzimuthRadians, this->enableBacktrack, this->groundCoverageRatio, surfaceAnglesRadians);
+	perez(0, calculatedDirectNormal, calculatedDiffuseHorizontal, albedo, surfaceAnglesRadians[0], surfaceAnglesRadians[1], solarZenithRadians, planeOfArrayIrradianceRear, diffuseIrradianceRear);
+
 	// Calculate diffuse and direct component irradiances for each cell row (assuming 6 rows)
 	size_t cellRows = 6;
+	rearIrradiance.resize(cellRows);
 	for (size_t i = 0; i != cellRows; i++)
 	{
 		// Calculate diffuse irradiances and reflected amounts for each cell row over its field of view of 180 degrees, 
@@ -1671,13 +1907,13 @@ void irrad::getBackSurfaceIrradiances(double pvBackShadeFraction, double rowToRo
 		size_t iHorBright = (size_t)round(fmax(0.0, 6.0 - elevationAngleUp / DTOR));	   			       // Number of whole degrees for which horizon brightening occurs
 		size_t iStartGrd = (size_t)round((tiltRadians + elevationAngleDown) / DTOR);                          // First whole degree in arc range that sees ground, last is 180
 
-		rearIrradiance.push_back(0);
+		rearIrradiance[i] = 0;
 		for (size_t j = 0; j != iStopIso; j++)
 		{
-			rearIrradiance[i] += 0.5 * (cos(j * DTOR) - cos((j + 1)*DTOR)) * MarionAOICorrectionFactorsGlass[j]* isotropicSkyDiffuse;
+			rearIrradiance[i] += arcViewFactors.factor[j] * MarionAOICorrectionFactorsGlass[j]* isotropicSkyDiffuse;
 			if ((iStopIso - j) <= iHorBright)
 			{
-				rearIrradiance[i] += 0.5 * (cos(j * DTOR) - cos((j + 1) * DTOR)) * MarionAOICorrectionFactorsGlass[j]* horizonDiffuse / 0.052264; // 0.052246 = 0.5 * [cos(84) - cos(90)]
+				rearIrradiance[i] += arcViewFactors.factor[j] * MarionAOICorrectionFactorsGlass[j]* horizonDiffuse / 0.052264; // 0.052246 = 0.5 * [cos(84) - cos(90)]
 			}
 		}
 
@@ -1721,7 +1957,7 @@ void irrad::getBackSurfaceIrradiances(double pvBackShadeFraction, double rowToRo
 				PVreflectedIrradiance += cellLengthSeen * frontReflected[k];
 			}
 			PVreflectedIrradiance /= projectedX2 - projectedX1;
-			rearIrradiance[i] += 0.5 * (cos(j * DTOR) - cos((j + 1) * DTOR)) * MarionAOICorrectionFactorsGlass[j] * PVreflectedIrradiance;
+			rearIrradiance[i] += arcViewFactors.factor[j] * MarionAOICorrectionFactorsGlass[j] * PVreflectedIrradiance;
 		}
 
 
@@ -1804,12 +2040,9 @@ void irrad::getBackSurfaceIrradiances(double pvBackShadeFraction, double rowToRo
 					actualGroundGHI /= projectedX2 - projectedX1;
 				}
 			}
-			rearIrradiance[i] += 0.5 * (cos(j * DTOR) - cos((j + 1) * DTOR)) * MarionAOICorrectionFactorsGlass[j] * actualGroundGHI * this->albedo;
+			rearIrradiance[i] += arcViewFactors.factor[j] * MarionAOICorrectionFactorsGlass[j] * actualGroundGHI * this->albedo;
 		}
-		// Calculate and add direct and circumsolar irradiance components
-		incidence(0, 180.0 - tiltRadians * RTOD, (surfaceAzimuthRadians * RTOD - 180.0), 45.0, solarZenithRadians, solarAzimuthRadians, this->enableBacktrack, this->groundCoverageRatio, surfaceAnglesRadians);
-		perez(0, calculatedDirectNormal, calculatedDiffuseHorizontal, albedo, surfaceAnglesRadians[0], surfaceAnglesRadians[1], solarZenithRadians, planeOfArrayIrradianceRear, diffuseIrradianceRear);
-
+		// Add direct and circumsolar irradiance components
 		double cellShade = pvBackShadeFraction * cellRows - i;
 		
 		// Fully shaded if >1, no shade if < 0, otherwise fractionally shaded
@@ -2461,42 +2694,44 @@ double ModifiedDISC(const double g[3], const double z[3], double td, double alt,
     //  Questionable use of x**-y changed to x**(-y)
     //  Made reference to intrinsic dmax1 agree with type
 
-	double cz[3], zenith[3], kt[3], am[3], ktpam[3], kt1[3];
+	dirintAngleTerms terms[3];
+	const dirintAngleTerms *t[3] = { &terms[0], &terms[1], &terms[2] };
+	for (int i = 0; i < 3; i++)
+		dirint_angle_terms(z[i], alt, terms[i]);
+
+	return ModifiedDISC(g, t, dirint_extraterrestrial(doy), dirint_dew_point_bin(td), dn);
+}   // End of ModifiedDISC
+
+static double ModifiedDISC(const double g[3], const dirintAngleTerms *z[3], double io, int dewPointBin, double &dn)
+{
+	double kt[3], kt1[3] = { 0, 0, 0 };
 
     double ktbin[5] = { 0.24, 0.4, 0.56, 0.7, 0.8 };
     double zbin[5] = { 25.0, 40.0, 55.0, 70.0, 80.0 };
     double dktbin[5] = { 0.015, 0.035, 0.07, 0.15, 0.3 };
-    double wbin[3] = { 1.0, 2.0, 3.0 };
-    double rtod = 57.295779513082316;
-    double a, b, c, w, knc, bmax, dkt1, io;
+    double a, b, c, bmax, dkt1;
 
-    //double dn = 0.0;
-    if (g[1] >= 1.0 && cos(z[1]) > 0.0)
+    if (g[1] >= 1.0 && z[1]->cz > 0.0)
     {   // Model only if present global >= 1 and present zenith < 90 deg
-        io = 1367.0 * (1.0 + 0.033 * cos(0.0172142 * doy));    // Extraterrestrial dn
-        int j = 0, k = 2, i = 0, l = 0;
-        if (g[0] < -998.0 || z[0] < -998.0)
+        int j = 0, k = 2, i = 0;
+        if (g[0] < -998.0 || z[0]->z < -998.0)
         {   // Prehour global and zenith were passed missing -999.0
             j = 1;
             kt1[0] = -999.0;
         }
-        if (g[2] < -998.0 || z[2] < -998.0)
+        if (g[2] < -998.0 || z[2]->z < -998.0)
         {   // Posthour global and zenith were passed missing -999.0
             k = 1;
             kt1[2] = -999.0;
         }
         for (i = j; i <= k; i++)
         {   // For each of the 3 hours that have data, find kt prime
-            cz[i] = cos(z[i]); // Cosine of zenith angle
-            if (cz[i] < 0.0)
+            if (z[i]->cz < 0.0)
                 kt1[i] = -999.0;
             else
             {
-                zenith[i] = z[i] * rtod;
-                kt[i] = g[i] / (io * Max(0.065, cz[i]));   // Kt
-                am[i] = Min(15.25, 1.0 / (cz[i] + 0.15 * (pow(93.9 - zenith[i], -1.253))));
-                ktpam[i] = am[i] * exp(-0.0001184 * alt);
-                kt1[i] = kt[i] / (1.031 * exp(-1.4 / (0.9 + 9.4 / ktpam[i])) + 0.1);   // Kt prime
+                kt[i] = g[i] / (io * z[i]->czMin);   // Kt
+                kt1[i] = kt[i] / z[i]->ktPrimeScale;   // Kt prime
             }
         }
         if (kt[1] <= 0.6)
@@ -2511,15 +2746,14 @@ double ModifiedDISC(const double g[3], const double z[3], double td, double alt,
             b = 41.40 - 118.5 * kt[1] + 66.05 * pow(kt[1], 2.0) + 31.9 * pow(kt[1], 3.0);
             c = -47.01 + 184.2 * kt[1] - 222.0 * pow(kt[1], 2.0) + 73.81 * pow(kt[1], 3.0);
         }
-        knc = 0.866 - 0.122 * am[1] + 0.0121 * pow(am[1], 2.0) - 0.000653 * pow(am[1], 3.0) + 0.000014 * pow(am[1], 4.0);
-        bmax = io * (knc - (a + b * exp(c * am[1])));
+        bmax = io * (z[1]->knc - (a + b * exp(c * z[1]->am)));
         if (kt1[0] < -998.0 && kt1[2] < -998.0)
             k = 6;
         else
         {
-            if (kt1[0] < -998.0 || zenith[0] >= 85.0)
+            if (kt1[0] < -998.0 || z[0]->zenith >= 85.0)
                 dkt1 = fabs(kt1[2] - kt1[1]);
-            else if (kt1[2] < -998.0 || zenith[2] >= 85.0)
+            else if (kt1[2] < -998.0 || z[2]->zenith >= 85.0)
                 dkt1 = fabs(kt1[1] - kt1[0]);
             else
                 dkt1 = 0.5 * (fabs(kt1[1] - kt1[0]) + fabs(kt1[2] - kt1[1]));
@@ -2535,23 +2769,16 @@ double ModifiedDISC(const double g[3], const double z[3], double td, double alt,
             i++;
         j = 0;
         //while (j < 4 && zenith[1] >= zbin[j]) 
-        while (j < 5 && zenith[1] >= zbin[j])       // Error fix 4/14/2015
+        while (j < 5 && z[1]->zenith >= zbin[j])    // Error fix 4/14/2015
             j++;
-        if (td < -998.0)
-            l = 4;  // l = letter "l'
-        else
-        {
-            w = exp(-0.075 + 0.07 * td);
-            l = 0;
-            while (l < 3 && w >= wbin[l])
-                l++;
-        }
-        dn = bmax * cm[i][j][k][l];
+        dn = bmax * cm[i][j][k][dewPointBin];
         dn = Max(0.0, dn);
     }   // End of if present global >= 1
+    else
+        dn = 0;
 
     return kt1[1];
-}   // End of ModifiedDISC
+}
 
 
 
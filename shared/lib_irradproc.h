@@ -202,6 +202,19 @@ void hdkr( double hextra, double dn, double df, double alb, double inc, double t
 */
 void poaDecomp( double wfPOA, double angle[], double sun[], double alb, poaDecompReq* pA, double &dn, double &df, double &gh, double poa[3], double diffc[3]);
 
+/**
+* poaDecompDays decomposes the input plane-of-array irradiance for whole days ahead of the time step loop.
+*  Each day is decomposed in one pass so the DIRINT angle terms and the morning and evening average kt prime
+*  are evaluated once per day. Results are stored in pA->decomposed, which poaDecomp uses when its inputs
+*  match. Days only read the shared input arrays and write their own results, so separate day ranges can
+*  be decomposed on separate threads.
+*
+* \param[in,out] pA structure with the POA, angle, albedo and dew point arrays for the year; pA->decomposed must have numberOfSteps entries
+* \param[in] firstDay index of the first day to decompose (0 = January 1)
+* \param[in] lastDay index after the last day to decompose
+*/
+void poaDecompDays( poaDecompReq *pA, size_t firstDay, size_t lastDay );
+
 /**
 * ModifiedDISC calculates direct normal (beam) radiation from global horizontal radiation.
 *  This function uses a disc beam model to calculate the beam irradiance returned. 
@@ -272,6 +285,37 @@ double shadeFraction1x(double solazi, double solzen, double tilt, double azimuth
 double backtrack(double solazi, double solzen, double tilt, double azimuth, double rotlim, double gcr, double rotation);
 
 
+/**
+* \struct rearSideWorkspace
+*
+*  Buffers reused by irrad::calc_rear_side() between time steps. The sky configuration factors depend only on the system geometry,
+*  so they are kept until the geometry changes (every time step for trackers, never for fixed tilt). Each time step is still
+*  calculated on its own, keep one workspace per surface (as pvsamv1 does per subarray) rather than batching time steps.
+*/
+struct rearSideWorkspace
+{
+	bool skyFactorsValid;				///< Whether the sky configuration factors match the stored geometry
+	double rowToRow, verticalHeight, clearanceGround, distanceBetweenRows, horizontalLength; ///< Geometry the sky configuration factors were calculated for
+
+	std::vector<double> rearSkyConfigFactors, frontSkyConfigFactors;
+	std::vector<int> rearGroundShade, frontGroundShade;
+	std::vector<double> rearGroundGHI, frontGroundGHI;
+	std::vector<double> frontIrradiance, frontReflected, rearIrradiance;
+
+	rearSideWorkspace();
+};
+
+/**
+* \struct sunPosition
+*
+*  Sun angles and time step flags calculated by irrad::calc_sun(), which are the same for every surface at one location and time
+*/
+struct sunPosition
+{
+	double angles[9];		///< Sun angles in radians as in irrad::sunAnglesRadians
+	int timeStep[3];		///< Effective hour, minute and sun up flag as in irrad::timeStepSunPosition
+};
+
 /**
 * \class irrad
 *
@@ -354,6 +398,9 @@ public:
 	/// Set the sky model for the irradiance processor, using \link Irradiance_IO::SKYMODEL 
 	void set_sky_model( int skymodel, double albedo );
 
+	/// Return the ground albedo for a weather record: the weather file value if it is used and valid (0-1), otherwise the monthly value. Returns -999, which check() rejects, if the month is invalid
+	static double get_albedo( const weather_record &wf, bool useWeatherFileAlbedo, const std::vector<double> &monthlyAlbedo );
+
 	/// Set the surface orientation for the irradiance processor
 	void set_surface( int tracking, double tilt_deg, double azimuth_deg, double rotlim_deg, bool en_backtrack, double gcr );
 
@@ -378,8 +425,23 @@ public:
 	/// Run the irradiance processor and calculate the plane-of-array irradiance and diffuse components of irradiance
 	int calc();
 
+	/// Calculate the sun position for the current time and location, the first part of calc()
+	void calc_sun();
+
+	/// Calculate the surface angles and plane-of-array irradiance for the current sun position, the second part of calc()
+	int calc_surface();
+
+	/// Return the sun position calculated by calc() or calc_sun()
+	void get_sun_position(sunPosition &sun);
+
+	/// Use a sun position calculated for the same location and time by another irrad object, before calc_surface()
+	void set_sun_position(const sunPosition &sun);
+
 	/// Run the irradiance processor for the rear-side of the surface to calculate rear-side plane-of-array irradiance
 	int calc_rear_side(double transmissionFactor, double bifaciality, double groundClearanceHeight, double slopeLength);
+
+	/// Run the rear-side irradiance calculation using buffers and view factors kept between calls in the workspace
+	int calc_rear_side(double transmissionFactor, double bifaciality, double groundClearanceHeight, double slopeLength, rearSideWorkspace &workspace);
 	
 	/// Return the calculated sun angles, some of which are converted to degrees
 	void get_sun( double *solazi,
@@ -426,13 +488,13 @@ public:
 	void getGroundShadeFactors(double rowToRow, double verticalHeight, double clearanceGround, double distanceBetweenRows, double horizontalLength, double solarAzimuthRadians, double solarElevationRadians, std::vector<int> & rearGroundFactors, std::vector<int> & frontGroundFactors, double & maxShadow, double & pvBackShadeFraction, double & pvFrontShadeFraction);
 
 	/// Return the ground global-horizonal irradiance, used by \link calc_rear_side()
-	void getGroundGHI(double transmissionFactor, std::vector<double> rearSkyConfigFactors, std::vector<double> frontSkyConfigFactors, std::vector<int> rearGroundShadeFactors, std::vector<int> frontGroundShadeFactors, std::vector<double> & rearGroundGHI, std::vector<double> & frontGroundGHI);
+	void getGroundGHI(double transmissionFactor, const std::vector<double> & rearSkyConfigFactors, const std::vector<double> & frontSkyConfigFactors, const std::vector<int> & rearGroundShadeFactors, const std::vector<int> & frontGroundShadeFactors, std::vector<double> & rearGroundGHI, std::vector<double> & frontGroundGHI);
 
 	/// Return the back surface irradiances, used by \link calc_rear_side()
-	void getBackSurfaceIrradiances(double pvBackShadeFraction, double rowToRow, double verticalHeight, double clearanceGround, double distanceBetweenRows, double horizontalLength, std::vector<double> rearGroundGHI, std::vector<double> frontGroundGHI, std::vector<double> frontReflected, std::vector<double> & rearIrradiance, double & rearAverageIrradiance);
+	void getBackSurfaceIrradiances(double pvBackShadeFraction, double rowToRow, double verticalHeight, double clearanceGround, double distanceBetweenRows, double horizontalLength, const std::vector<double> & rearGroundGHI, const std::vector<double> & frontGroundGHI, const std::vector<double> & frontReflected, std::vector<double> & rearIrradiance, double & rearAverageIrradiance);
 
 	/// Return the front surface irradiances, used by \link calc_rear_side()
-	void getFrontSurfaceIrradiances(double pvBackShadeFraction, double rowToRow, double verticalHeight, double clearanceGround, double distanceBetweenRows, double horizontalLength, std::vector<double> frontGroundGHI, std::vector<double> & frontIrradiance, double & frontAverageIrradiance, std::vector<double> & frontReflected);
+	void getFrontSurfaceIrradiances(double pvBackShadeFraction, double rowToRow, double verticalHeight, double clearanceGround, double distanceBetweenRows, double horizontalLength, const std::vector<double> & frontGroundGHI, std::vector<double> & frontIrradiance, double & frontAverageIrradiance, std::vector<double> & frontReflected);
 };
 
 #endif
@@ -581,6 +581,10 @@ Module_IO::Module_IO(compute_module* cm, std::string cmName, double dcLoss)
 	simpleEfficiencyForceNoPOA = false;
 	mountingSpecificCellTemperatureForceNoPOA = false;
 	selfShadingFillFactor = 0;
+
+	// single diode models use the explicit Lambert-W maximum power point solution
+	cecModel.UseLambertW = true;
+	elevenParamSingleDiodeModel.UseLambertW = true;
 	isConcentratingPV = false;
 	isBifacial = false;
 
@@ -297,9 +297,25 @@ struct PVSystem_IO
 };
 
 
+// result of decomposing the POA at one time step ahead of the time step loop, see poaDecompDays
+struct poaDecompResult {
+	poaDecompResult() : valid(false), doy(-1), dayStart(0), alb(0), tDew(0), dn(0), df(0), gh(0) {
+		poa[0] = poa[1] = poa[2] = 0;
+		diffc[0] = diffc[1] = diffc[2] = 0;
+	}
+	bool valid; // false if the sun is down or the step was not decomposed
+	int doy; // inputs the result was computed with, it is only used if the time step loop has the same
+	size_t dayStart;
+	double alb;
+	double tDew;
+	double dn, df, gh; // decomposed irradiance (W/m2)
+	double poa[3]; // plane-of-array beam, sky diffuse and ground diffuse (W/m2)
+	double diffc[3]; // diffuse components (W/m2)
+};
+
 // allow for the poa decomp model to take all daily POA measurements into consideration
 struct poaDecompReq {
-	poaDecompReq() : i(0), dayStart(0), stepSize(1), stepScale('h'), doy(-1) {}
+	poaDecompReq() : i(0), dayStart(0), stepSize(1), stepScale('h'), doy(-1), numberOfSteps(0) {}
 	size_t i; // Current time index
 	size_t dayStart; // time index corresponding to the start of the current day
 	double stepSize;
@@ -312,6 +328,10 @@ struct poaDecompReq {
 	double tDew;
 	int doy;
 	double elev;
+	size_t numberOfSteps; // Number of entries in the arrays above, 0 if not known
+	std::vector<double> albedo; // Albedo at each time step, required by poaDecompDays
+	std::vector<double> dewPoint; // Dew point at each time step, required by poaDecompDays
+	std::vector<poaDecompResult> decomposed; // Results from poaDecompDays, empty if each step is decomposed in the time step loop
 };
 
 /**
@@ -376,6 +396,7 @@ public:
 	int nStringsBottom;					/// Number of strings along bottom from self-shading
 	ssinputs selfShadingInputs;			/// Inputs and calculation methods for self-shading of the subarray
 	ssoutputs selfShadingOutputs;		/// Outputs for the self-shading of the subarray
+	ss_table selfShadingTable;			/// Precomputed self-shading geometry, used when set up
 	shading_factor_calculator shadeCalculator; /// The shading calculator model for self-shading
 	pvsnowmodel snowModel;				/// The underlying snow model for this subarray
 
@@ -90,6 +90,113 @@ pvinput_t::pvinput_t( double ib, double id, double ig, double irear, double ip,
 	usePOAFromWF = up;
 }
 
+void pvinput_soa::resize( size_t n )
+{
+	std::vector<double> *cols[] = { &Ibeam, &Idiff, &Ignd, &Irear, &poaIrr, &Tdry, &Tdew, &Wspd, &Wdir, &Patm,
+		&Zenith, &IncAng, &Elev, &Tilt, &Azimuth, &HourOfDay };
+	for( size_t k=0; k<sizeof(cols)/sizeof(cols[0]); k++ )
+		cols[k]->resize( n, 0.0 );
+	radmode.resize( n, 0 );
+	usePOAFromWF.resize( n, 0 );
+}
+
+void pvinput_soa::set( size_t i, const pvinput_t &in )
+{
+	Ibeam[i] = in.Ibeam;
+	Idiff[i] = in.Idiff;
+	Ignd[i] = in.Ignd;
+	Irear[i] = in.Irear;
+	poaIrr[i] = in.poaIrr;
+	Tdry[i] = in.Tdry;
+	Tdew[i] = in.Tdew;
+	Wspd[i] = in.Wspd;
+	Wdir[i] = in.Wdir;
+	Patm[i] = in.Patm;
+	Zenith[i] = in.Zenith;
+	IncAng[i] = in.IncAng;
+	Elev[i] = in.Elev;
+	Tilt[i] = in.Tilt;
+	Azimuth[i] = in.Azimuth;
+	HourOfDay[i] = in.HourOfDay;
+	radmode[i] = in.radmode;
+	usePOAFromWF[i] = in.usePOAFromWF ? 1 : 0;
+}
+
+void pvinput_soa::get( size_t i, pvinput_t &in ) const
+{
+	in.Ibeam = Ibeam[i];
+	in.Idiff = Idiff[i];
+	in.Ignd = Ignd[i];
+	in.Irear = Irear[i];
+	in.poaIrr = poaIrr[i];
+	in.Tdry = Tdry[i];
+	in.Tdew = Tdew[i];
+	in.Wspd = Wspd[i];
+	in.Wdir = Wdir[i];
+	in.Patm = Patm[i];
+	in.Zenith = Zenith[i];
+	in.IncAng = IncAng[i];
+	in.Elev = Elev[i];
+	in.Tilt = Tilt[i];
+	in.Azimuth = Azimuth[i];
+	in.HourOfDay = HourOfDay[i];
+	in.radmode = radmode[i];
+	in.usePOAFromWF = usePOAFromWF[i] != 0;
+}
+
+bool pvinput_soa::equal( size_t i, size_t j ) const
+{
+	const std::vector<double> *cols[] = { &Ibeam, &Idiff, &Ignd, &Irear, &poaIrr, &Tdry, &Tdew, &Wspd, &Wdir, &Patm,
+		&Zenith, &IncAng, &Elev, &Tilt, &Azimuth, &HourOfDay };
+	for( size_t k=0; k<sizeof(cols)/sizeof(cols[0]); k++ )
+		if ( (*cols[k])[i] != (*cols[k])[j] ) return false;
+	return radmode[i] == radmode[j] && usePOAFromWF[i] == usePOAFromWF[j];
+}
+
+void pvoutput_soa::resize( size_t n )
+{
+	std::vector<double> *cols[] = { &Power, &Voltage, &Current, &Efficiency, &Voc_oper, &Isc_oper, &CellTemp, &AOIModifier };
+	for( size_t k=0; k<sizeof(cols)/sizeof(cols[0]); k++ )
+		cols[k]->resize( n, 0.0 );
+}
+
+void pvoutput_soa::set( size_t i, const pvoutput_t &out )
+{
+	Power[i] = out.Power;
+	Voltage[i] = out.Voltage;
+	Current[i] = out.Current;
+	Efficiency[i] = out.Efficiency;
+	Voc_oper[i] = out.Voc_oper;
+	Isc_oper[i] = out.Isc_oper;
+	CellTemp[i] = out.CellTemp;
+	AOIModifier[i] = out.AOIModifier;
+}
+
+void pvoutput_soa::get( size_t i, pvoutput_t &out ) const
+{
+	out.Power = Power[i];
+	out.Voltage = Voltage[i];
+	out.Current = Current[i];
+	out.Efficiency = Efficiency[i];
+	out.Voc_oper = Voc_oper[i];
+	out.Isc_oper = Isc_oper[i];
+	out.CellTemp = CellTemp[i];
+	out.AOIModifier = AOIModifier[i];
+}
+
+bool pvcelltemp_t::run_batch( const pvinput_soa &input, pvmodule_t &module, const double *opvoltage, double *Tcell )
+{
+	bool ok = true;
+	pvinput_t in;
+	for( size_t i=0; i<input.size(); i++ )
+	{
+		input.get( i, in );
+		if ( !(*this)( in, module, opvoltage ? opvoltage[i] : -1.0, Tcell[i] ) )
+			ok = false;
+	}
+	return ok;
+}
+
 std::string pvcelltemp_t::error()
 {
 	return m_err;
@@ -117,6 +224,22 @@ pvoutput_t::pvoutput_t( double p, double v,
 }
 
 
+bool pvmodule_t::run_batch( const pvinput_soa &input, const double *TcellC, const double *opvoltage, pvoutput_soa &output )
+{
+	bool ok = true;
+	pvinput_t in;
+	pvoutput_t out;
+	for( size_t i=0; i<input.size(); i++ )
+	{
+		input.get( i, in );
+		output.get( i, out );
+		if ( !(*this)( in, TcellC[i], opvoltage ? opvoltage[i] : -1.0, out ) )
+			ok = false;
+		output.set( i, out );
+	}
+	return ok;
+}
+
 std::string pvmodule_t::error()
 {
 	return m_err;
@@ -392,4 +515,150 @@ double maxpower_5par( double Voc_ubound, double a, double Il, double Io, double
 	if ( __Vmp ) *__Vmp = V;
 	if ( __Imp ) *__Imp = I;
 	return P;
-}
\ No newline at end of file
+}
+/******** LAMBERT-W SINGLE DIODE SOLUTION *********/
+
+static double lambertw_exp( double lnx )
+{
+/*
+	Principal branch of the Lambert W function evaluated at x = exp(lnx), for any x > 0.
+	Working with log(x) avoids overflow of the diode exponential at high voltages.
+	Starts from the approximation of Winitzki (2003) and refines with the fourth order iteration of 
+	Fritsch, Shafer and Crowley (1973), which usually needs a single step.
+*/
+	double w;
+	if ( lnx > 3.0 )
+	{
+		double l2 = log(lnx);
+		w = lnx - l2 + l2/lnx; // asymptotic form for large x
+	}
+	else
+	{
+		double l1 = ( lnx < -30.0 ) ? exp(lnx) : log( 1.0 + exp(lnx) );
+		w = l1*( 1.0 - log(1.0+l1)/(2.0+l1) );
+	}
+
+	if ( w < 1e-300 ) return exp(lnx); // W(x) = x for tiny x
+
+	for( int i=0; i<6; i++ )
+	{
+		double z = lnx - w - log(w);
+		double q = 2.0*(1.0+w)*(1.0 + w + 2.0*z/3.0);
+		double e = z/(1.0+w) * (q-z)/(q-2.0*z);
+		w *= 1.0+e;
+		if ( fabs(e) < 1e-5 ) break; // error of the result is of order e^4
+	}
+	return w;
+}
+
+static void diode_lambertw( double V, double a, double IL, double IO, double RS, double RSH, 
+	double *I, double *dIdV, double *d2IdV2 )
+{
+/*
+	Explicit module current and its voltage derivatives from the single diode equation
+		I = IL - IO*(exp((V+I*RS)/a)-1) - (V+I*RS)/RSH
+	Jain and Kapoor (2004):
+		I = (RSH*(IL+IO) - V)/(RS+RSH) - (a/RS)*W(theta)
+		theta = RS*RSH*IO/(a*(RS+RSH)) * exp( RSH*(RS*(IL+IO)+V)/(a*(RS+RSH)) )
+*/
+	if ( RS <= 0.0 )
+	{
+		double ex = IO/a*exp(V/a);
+		*I = IL - IO*(exp(V/a)-1.0) - V/RSH;
+		if ( dIdV ) *dIdV = -ex - 1.0/RSH;
+		if ( d2IdV2 ) *d2IdV2 = -ex/a;
+		return;
+	}
+
+	double RT = RS + RSH;
+	double lntheta = log( RS*RSH*IO/(a*RT) ) + RSH*(RS*(IL+IO) + V)/(a*RT);
+	double W = lambertw_exp( lntheta );
+
+	*I = (RSH*(IL+IO) - V)/RT - a/RS*W;
+	if ( dIdV ) *dIdV = -( 1.0 + RSH/RS*W/(1.0+W) )/RT;
+	if ( d2IdV2 ) *d2IdV2 = -RSH*RSH*W/( a*RS*RT*RT*(1.0+W)*(1.0+W)*(1.0+W) );
+}
+
+double current_5par_lambertw( double V, double A, double IL, double IO, double RS, double RSH )
+{
+	double I;
+	diode_lambertw( V, A, IL, IO, RS, RSH, &I, 0, 0 );
+	return I;
+}
+
+double openvoltage_5par_lambertw( double a, double IL, double IO, double Rsh )
+{
+/*
+	At open circuit no current flows through the series resistance, so
+		Voc = RSH*(IL+IO) - a*W( IO*RSH/a * exp(RSH*(IL+IO)/a) )
+	followed by a Newton step to recover the precision lost in the subtraction.
+*/
+	if ( IL <= 0.0 ) return 0.0;
+
+	double Voc = Rsh*(IL+IO) - a*lambertw_exp( log(IO*Rsh/a) + Rsh*(IL+IO)/a );
+	double ex = IO*exp(Voc/a);
+	Voc += ( IL - (ex-IO) - Voc/Rsh ) / ( ex/a + 1.0/Rsh );
+	return Voc > 0.0 ? Voc : 0.0;
+}
+
+double maxpower_5par_lambertw( double a, double Il, double Io, double Rs, double Rsh, double *__Vmp, double *__Imp, double *__Voc )
+{
+/*
+	Maximum power point from Newton's method on dP/dV = I + V*dI/dV = 0, using the analytic 
+	derivatives of the explicit current. dP/dV decreases monotonically from Isc at V=0 to a negative 
+	value at Voc, so the iteration is kept inside that bracket with a bisection fallback.
+*/
+	double V = 0, I = 0, P = 0;
+	double Voc = openvoltage_5par_lambertw( a, Il, Io, Rsh );
+	if ( Voc > 0 )
+	{
+		// initial guess from the ideal diode approximation Vmp = Voc - a*ln(1 + Vmp/a), less the series resistance drop
+		double Vlo = 0, Vhi = Voc;
+		double Vd = Voc - a*log( 1.0 + Voc/a );
+		Vd = Voc - a*log( 1.0 + Vd/a );
+		V = Vd - Rs*( Il - Io*(exp(Vd/a)-1.0) - Vd/Rsh );
+		if ( !(V > 0 && V < Voc) ) V = 0.8*Voc;
+		for( int it=0; it<50; it++ )
+		{
+			double dI, d2I;
+			diode_lambertw( V, a, Il, Io, Rs, Rsh, &I, &dI, &d2I );
+			double dP = I + V*dI;
+			double d2P = 2.0*dI + V*d2I;
+
+			if ( dP > 0 ) Vlo = V;
+			else Vhi = V;
+
+			double Vnew = V - dP/d2P;
+			if ( !(Vnew > Vlo && Vnew < Vhi) )
+				Vnew = 0.5*(Vlo + Vhi);
+
+			// the power error is second order in the remaining step, so keep the evaluated point
+			if ( fabs(Vnew - V) < 1e-7*Voc ) break;
+			V = Vnew;
+		}
+		if ( I < 0 ) I = 0;
+		P = V*I;
+	}
+
+	if ( __Vmp ) *__Vmp = V;
+	if ( __Imp ) *__Imp = I;
+	if ( __Voc ) *__Voc = Voc;
+	return P;
+}
+
+void maxpower_5par_lambertw( size_t n, const double *a, const double *Il, const double *Io, const double *Rs, const double *Rsh,
+	double *Pmp, double *Vmp, double *Imp )
+{
+/*
+	Maximum power points for 'n' sets of operating parameters, e.g. all timesteps of a subarray.
+	Results are identical to the scalar form.
+*/
+	for( size_t i=0; i<n; i++ )
+	{
+		double V, I;
+		double P = maxpower_5par_lambertw( a[i], Il[i], Io[i], Rs[i], Rsh[i], &V, &I );
+		if ( Pmp ) Pmp[i] = P;
+		if ( Vmp ) Vmp[i] = V;
+		if ( Imp ) Imp[i] = I;
+	}
+}
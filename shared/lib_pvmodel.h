@@ -51,6 +51,7 @@
 #define __pvmodulemodel_h
 
 #include <string>
+#include <vector>
 
 class pvcelltemp_t;
 class pvpower_t;
@@ -103,6 +104,33 @@ public:
 	double AOIModifier; // angle-of-incidence modifier for total poa irradiance on front side of module (0-1)
 };
 
+// structure-of-arrays forms of pvinput_t and pvoutput_t for evaluating many records in one call
+class pvinput_soa
+{
+public:
+	void resize( size_t n );
+	size_t size() const { return Ibeam.size(); }
+	void set( size_t i, const pvinput_t &in );
+	void get( size_t i, pvinput_t &in ) const;
+	bool equal( size_t i, size_t j ) const; // records i and j have identical values
+
+	std::vector<double> Ibeam, Idiff, Ignd, Irear, poaIrr, Tdry, Tdew, Wspd, Wdir, Patm,
+		Zenith, IncAng, Elev, Tilt, Azimuth, HourOfDay;
+	std::vector<int> radmode;
+	std::vector<char> usePOAFromWF;
+};
+
+class pvoutput_soa
+{
+public:
+	void resize( size_t n );
+	size_t size() const { return Power.size(); }
+	void set( size_t i, const pvoutput_t &out );
+	void get( size_t i, pvoutput_t &out ) const;
+
+	std::vector<double> Power, Voltage, Current, Efficiency, Voc_oper, Isc_oper, CellTemp, AOIModifier;
+};
+
 class pvmodule_t; // forward decl
 
 class pvcelltemp_t
@@ -112,6 +140,10 @@ protected:
 public:
 	
 	virtual bool operator() ( pvinput_t &input, pvmodule_t &module, double opvoltage, double &Tcell ) = 0;
+
+	// evaluate every record of 'input'. opvoltage may be null to use the maximum power point throughout.
+	// as in the scalar form, Tcell holds the values to keep where the model does not calculate one.
+	virtual bool run_batch( const pvinput_soa &input, pvmodule_t &module, const double *opvoltage, double *Tcell );
 	std::string error();
 };
 
@@ -129,6 +161,10 @@ public:
 
 
 	virtual bool operator() ( pvinput_t &input, double TcellC, double opvoltage, pvoutput_t &output ) = 0;
+
+	// evaluate every record of 'input'. opvoltage may be null to use the maximum power point throughout.
+	// as in the scalar form, 'output' holds the values to keep where the model does not calculate them.
+	virtual bool run_batch( const pvinput_soa &input, const double *TcellC, const double *opvoltage, pvoutput_soa &output );
 	std::string error();
 };
 
@@ -162,6 +198,13 @@ public:
 double current_5par( double V, double IMR, double A, double IL, double IO, double RS, double RSH );
 double openvoltage_5par( double Voc0, double a, double IL, double IO, double Rsh );
 double maxpower_5par( double Voc_ubound, double a, double Il, double Io, double Rs, double Rsh, double *Vmp=0, double *Imp=0 );
+
+// explicit single diode solution using the Lambert W function
+double current_5par_lambertw( double V, double A, double IL, double IO, double RS, double RSH );
+double openvoltage_5par_lambertw( double a, double IL, double IO, double Rsh );
+double maxpower_5par_lambertw( double a, double Il, double Io, double Rs, double Rsh, double *Vmp=0, double *Imp=0, double *Voc=0 );
+void maxpower_5par_lambertw( size_t n, const double *a, const double *Il, const double *Io, const double *Rs, const double *Rsh,
+	double *Pmp, double *Vmp, double *Imp );
 double air_mass_modifier( double Zenith_deg, double Elev_m, double a[5] );
 
 
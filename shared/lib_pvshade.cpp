@@ -183,49 +183,56 @@ double qromb(double (*func)(double,double,double,double), double a, double b, do
 
 // SUPPORTING FUNCTION DEFINITIONS
 
-void diffuse_reduce(
-	// inputs (angles in degrees)
+// view factors that depend only on the surface tilt and mask angle (per unit albedo)
+static void diffuse_view_factors(double stilt, double gcr, double phi0, ss_view_factors &vf)
+{
+	double B = 1.0;
+	double R = B / gcr;
+
+	vf.cos_tilt = cosd(stilt);
+	vf.sky = 1 - pow(cosd(phi0 / 2), 2);
+	vf.F1 = pow(sind(stilt / 2.0), 2);
+	vf.F3 = 0.5 * (1.0 + R / B - sqrt(pow(R, 2) / pow(B, 2) - 2 * R / B * cosd(180 - stilt) + 1.0));
+}
+
+// ground view factor F2 (per unit albedo), depends on the sun elevation
+static double diffuse_view_f2(double solzen, double stilt, double gcr)
+{
+	double B = 1.0;
+	double R = B / gcr;
+
+	double solalt = 90 - solzen;
+	double Y1 = R - B * sind(180.0 - solalt - stilt) / sind(solalt);
+	Y1 = fmax(0.00001, Y1); // constraint per Chris 4/23/12
+	return 0.5 * (1.0 + Y1 / B - sqrt(pow(Y1, 2) / pow(B, 2) - 2 * Y1 / B * cosd(180 - stilt) + 1.0));
+}
+
+static void diffuse_reduce_vf(
+	const ss_view_factors &vf,
+	double F2u,
 	double solzen,
-	double stilt,
 	double Gb_nor,
 	double Gd_poa,
-	double gcr,
-	double phi0, // mask angle
 	double alb,
 	double nrows,
-
-	// outputs
 	double &reduced_skydiff,
-	double &Fskydiff,  // derate factor on sky diffuse
+	double &Fskydiff,
 	double &reduced_gnddiff,
-	double &Fgnddiff) // derate factor on ground diffuse
+	double &Fgnddiff)
 {
-	if (Gd_poa < 0.1)
-	{
-		Fskydiff = Fgnddiff = 1.0;
-		return;
-	}
-
 	// view factor calculations assume isotropic sky
 	double Gd = Gd_poa; // total plane-of-array diffuse
-	double Gdh = Gd * 2 / (1 + cosd(stilt)); // total
+	double Gdh = Gd * 2 / (1 + vf.cos_tilt); // total
 	double Gbh = Gb_nor * cosd(solzen); // beam irradiance on horizontal surface
 
 	// sky diffuse reduction
-	reduced_skydiff = Gd - Gdh*(1 - pow(cosd(phi0 / 2), 2))*(nrows - 1.0) / nrows;
+	reduced_skydiff = Gd - Gdh*vf.sky*(nrows - 1.0) / nrows;
 	Fskydiff = reduced_skydiff / Gd;
 
-	double B = 1.0;
-	double R = B / gcr;
-
-	double solalt = 90 - solzen;
-
 	// ground reflected reduction 
-	double F1 = alb * pow(sind(stilt / 2.0), 2);
-	double Y1 = R - B * sind(180.0 - solalt - stilt) / sind(solalt);
-	Y1 = fmax(0.00001, Y1); // constraint per Chris 4/23/12
-	double F2 = 0.5 * alb * (1.0 + Y1 / B - sqrt(pow(Y1, 2) / pow(B, 2) - 2 * Y1 / B * cosd(180 - stilt) + 1.0));
-	double F3 = 0.5 * alb * (1.0 + R / B - sqrt(pow(R, 2) / pow(B, 2) - 2 * R / B * cosd(180 - stilt) + 1.0));
+	double F1 = alb * vf.F1;
+	double F2 = alb * F2u;
+	double F3 = alb * vf.F3;
 
 	double Gr1 = F1 * (Gbh + Gdh);
 	reduced_gnddiff = ((F1 + (nrows - 1)*F2) / nrows) * Gbh
@@ -236,6 +243,35 @@ void diffuse_reduce(
 		Fgnddiff = reduced_gnddiff / Gr1;
 }
 
+void diffuse_reduce(
+	// inputs (angles in degrees)
+	double solzen,
+	double stilt,
+	double Gb_nor,
+	double Gd_poa,
+	double gcr,
+	double phi0, // mask angle
+	double alb,
+	double nrows,
+
+	// outputs
+	double &reduced_skydiff,
+	double &Fskydiff,  // derate factor on sky diffuse
+	double &reduced_gnddiff,
+	double &Fgnddiff) // derate factor on ground diffuse
+{
+	if (Gd_poa < 0.1)
+	{
+		Fskydiff = Fgnddiff = 1.0;
+		return;
+	}
+
+	ss_view_factors vf;
+	diffuse_view_factors(stilt, gcr, phi0, vf);
+	diffuse_reduce_vf(vf, diffuse_view_f2(solzen, stilt, gcr), solzen, Gb_nor, Gd_poa, alb, nrows,
+		reduced_skydiff, Fskydiff, reduced_gnddiff, Fgnddiff);
+}
+
 double selfshade_dc_derate(double X, double S, double FF0, double dbh_ratio, double m_d, double Vmp)
 {
 	double Xtemp = fmin(X, 0.65);  // X is limited to 0.65 for c2 calculation
@@ -330,54 +366,30 @@ R: inter-row spacing
 phi_bar: average masking angle
 
 */
-bool ss_exec(
-	
-	const ssinputs &inputs,
-
-	double tilt,		// module tilt (constant for fixed tilt, varies for one-axis)
-	double azimuth,		// module azimuth (constant for fixed tilt, varies for one-axis)
-	double solzen,		// solar zenith (deg)
-	double solazi,		// solar azimuth (deg)
-	double Gb_nor,		// beam normal irradiance (W/m2)
-	double Gb_poa,		// POA beam irradiance (W/m2)
-	double Gd_poa,		// POA diffuse, sky+gnd (W/m2)
-	double albedo,		// used to calculate reduced relected irradiance
-	bool trackmode,		// 0 for fixed tilt, 1 for one-axis tracking
-	bool linear,		// 0 for non-linear shading (C. Deline's full algorithm), 1 to stop at linear shading
-	double shade_frac_1x,	// geometric calculation of the fraction of one-axis row that is shaded (0-1), not used if fixed tilt 
-
-	ssoutputs &outputs)
+// row dimensions per Chris Deline's paper: B is the length of the side of a row
+static void ss_row_dims(const ssinputs &inputs, double &m_B, double &m_row_length, double &m_R)
 {
-
-	// ***********************************
-	// VARIABLE ASSIGNMENTS
-	// ***********************************
-
-	// translate inputs to variable names consistent with C. Deline's self-shading paper for clarity
-	double m_m = inputs.nmody;
-	double m_n = inputs.nmodx;
-	double m_d = inputs.ndiode;
-	double m_W = inputs.width;
-	double m_L = inputs.length;
-	double m_r = inputs.nrows;
-	double m_R = inputs.row_space;
+	m_R = inputs.row_space;
 
 	// check for divide by zero issues with Row spacing per email from Chris 5/2/12
 	if (m_R < M_EPS) m_R = M_EPS;
 
-	// calculate the mask angle
-	// NOTE THAT B HERE IS PER CHRIS DELINE'S PAPER: B IS THE LENGTH OF THE SIDE OF A ROW
-	double m_B;
-	if (inputs.mod_orient == 0) m_B = m_L * m_m;	// Portrait Mode
-	else m_B = m_W * m_m;	// Landscape Mode
+	if (inputs.mod_orient == 0) m_B = inputs.length * inputs.nmody;	// Portrait Mode
+	else m_B = inputs.width * inputs.nmody;	// Landscape Mode
 
 	// calculate the length of the row also
-	double m_row_length;
-	if (inputs.mod_orient == 0) m_row_length = m_n * m_W; //Portrait Mode
-	else m_row_length = m_n * m_L; //Landscape Mode
+	if (inputs.mod_orient == 0) m_row_length = inputs.nmodx * inputs.width; //Portrait Mode
+	else m_row_length = inputs.nmodx * inputs.length; //Landscape Mode
+}
+
+// mask angle (degrees) for a given tilt
+static double ss_mask_angle(const ssinputs &inputs, double tilt)
+{
+	double m_B, m_row_length, m_R;
+	ss_row_dims(inputs, m_B, m_row_length, m_R);
 
 	double a = 0.0, b = m_B;
-	
+
 	double mask_angle;
 	if (inputs.mask_angle_calc_method == 1)
 	{
@@ -391,28 +403,25 @@ bool ss_exec(
 		mask_angle = atan2( ( m_B * sind( tilt ) ), ( m_R - m_B * cosd( tilt ) ) );
 	}
 	mask_angle *= 180.0/M_PI; // change to degrees to pass into functions later
+	return mask_angle;
+}
 
+// shadow dimensions g and Hs before the constraints are applied
+static void ss_shadow(const ssinputs &inputs, double tilt, double az_eff, double solzen, double &g, double &Hs)
+{
 	// ***********************************
 	// SHADOW DIMENSION CALCULATIONS
 	// ***********************************
 	// Reference Appelbaum and Bany "Shadow effect of adjacent solar collectors in large scale systems" Solar Energy 1979 Vol 23. No. 6
 
+	double m_B, m_row_length, m_R;
+	ss_row_dims(inputs, m_B, m_row_length, m_R);
+
 	double m_A; //NOTE THAT THIS IS APPLEBAUM A, WHICH IS THE ROW SIDE WIDTH, NOT DELINE A, WHICH IS THE ROW LENGTH
 	// APPLEBAUM A IS EQUAL TO DELINE B
 	m_A = m_B;
 
 	double px, py;
-	double S,X;
-
-	// AppelBaum Appendix A
-	double g, Hs;
-
-	/* two assumptions in Applebaum paper:
-		1. Azimuth = 0 is facing toward sun (south in northern hemisphere)
-		2. Array azimuth is 0 degrees
-	   to reconcile these assumptions, use an effective azimuth (az_eff) that is the difference between array az and solar az
-	*/
-	double az_eff = solazi - azimuth;
 
 	// if no effective tilt, or sun is down, then no array self-shading
 	if ((solzen < 90.0) && (tilt != 0) && (fabs(az_eff) < 90.0) )
@@ -434,6 +443,30 @@ bool ss_exec(
 	else
 		g = m_R * px / py;
 
+	// Appelbaum equation A13  Hs = EF = A(1 - R/Py)
+	if (py == 0)
+		Hs = 0;
+	else
+		Hs = m_A * (1.0 - m_R / py);
+}
+
+// applies the shadow constraints and calculates X and S. returns false when linear shading is
+// requested, in which case only the fixed tilt shade fraction is calculated
+static bool ss_xs(const ssinputs &inputs, double g, double Hs, bool trackmode, bool linear, double shade_frac_1x,
+	double &X, double &S, ssoutputs &outputs)
+{
+	// translate inputs to variable names consistent with C. Deline's self-shading paper for clarity
+	double m_m = inputs.nmody;
+	double m_n = inputs.nmodx;
+	double m_d = inputs.ndiode;
+	double m_W = inputs.width;
+	double m_L = inputs.length;
+	double m_r = inputs.nrows;
+
+	double m_B, m_row_length, m_R;
+	ss_row_dims(inputs, m_B, m_row_length, m_R);
+	double m_A = m_B;
+
 	// Additional constraints from Chris 4/11/12
 	g = fmax(g, 0); //fabs(g);	//g must be positive
 	g = fmin(g, m_row_length);	//g can't be greater than the length of the row
@@ -445,12 +478,6 @@ bool ss_exec(
 		g = 0;
 	}
 
-	// Appelbaum equation A13  Hs = EF = A(1 - R/Py)
-	if (py == 0)
-		Hs = 0;
-	else
-		Hs = m_A * (1.0 - m_R / py);
-
 	//overwrite Hs using geometrically calculated shade fraction for one-axis trackers
 	if (trackmode == 1)
 	{
@@ -466,7 +493,7 @@ bool ss_exec(
 		//relative shaded area, Applebaum equation A15
 		double relative_shaded_area = Hs * (m_row_length - g) / (m_A * m_row_length); //numerator is shadow area, denom is row area
 		outputs.m_shade_frac_fixed = relative_shaded_area;
-		return true;
+		return false;
 	}
 
 	// X and S from Chris Deline 4/23/12
@@ -514,14 +541,13 @@ bool ss_exec(
 	{
 		S = 1;
 	}
-	
-	//Chris Deline's self-shading algorithm
 
-	// 1. determine reduction of diffuse incident on shaded sections due to self-shading (beam is not derated because that shading is taken into account in dc derate)
-	diffuse_reduce( solzen, tilt, Gb_nor, Gd_poa, m_B/m_R, mask_angle, albedo, m_r,
-		// outputs
-		outputs.m_reduced_diffuse, outputs.m_diffuse_derate, outputs.m_reduced_reflected, outputs.m_reflected_derate );
+	return true;
+}
 
+// dc derate from the reduced irradiance, steps 2 and 3 of Chris Deline's algorithm
+static void ss_dc_derate(const ssinputs &inputs, double X, double S, double Gb_poa, ssoutputs &outputs)
+{
 	// 2. Calculate the "Reduced Irradiance Fraction" (Ee in Chris' paper)
 	double inc_total =  ( Gb_poa + outputs.m_reduced_diffuse + outputs.m_reduced_reflected)/1000;
 	double inc_diff = (outputs.m_reduced_diffuse + outputs.m_reduced_reflected)/1000;
@@ -530,7 +556,176 @@ bool ss_exec(
 		diffuse_globhoriz = inc_diff / inc_total;
 
 	// 3. Calculate the dc power derate based on C.Deline et al., "A simplified model of uniform shading in large photovoltaic arrays" (Psys/Psys0 in the paper, which is equivalent to a derate)
-	outputs.m_dc_derate = selfshade_dc_derate( X, S, inputs.FF0, diffuse_globhoriz, m_d, inputs.Vmp );
+	outputs.m_dc_derate = selfshade_dc_derate( X, S, inputs.FF0, diffuse_globhoriz, inputs.ndiode, inputs.Vmp );
+}
+
+bool ss_exec(
+	
+	const ssinputs &inputs,
+
+	double tilt,		// module tilt (constant for fixed tilt, varies for one-axis)
+	double azimuth,		// module azimuth (constant for fixed tilt, varies for one-axis)
+	double solzen,		// solar zenith (deg)
+	double solazi,		// solar azimuth (deg)
+	double Gb_nor,		// beam normal irradiance (W/m2)
+	double Gb_poa,		// POA beam irradiance (W/m2)
+	double Gd_poa,		// POA diffuse, sky+gnd (W/m2)
+	double albedo,		// used to calculate reduced relected irradiance
+	bool trackmode,		// 0 for fixed tilt, 1 for one-axis tracking
+	bool linear,		// 0 for non-linear shading (C. Deline's full algorithm), 1 to stop at linear shading
+	double shade_frac_1x,	// geometric calculation of the fraction of one-axis row that is shaded (0-1), not used if fixed tilt 
+
+	ssoutputs &outputs)
+{
+	/* two assumptions in Applebaum paper:
+		1. Azimuth = 0 is facing toward sun (south in northern hemisphere)
+		2. Array azimuth is 0 degrees
+	   to reconcile these assumptions, use an effective azimuth (az_eff) that is the difference between array az and solar az
+	*/
+	double az_eff = solazi - azimuth;
+
+	// AppelBaum Appendix A
+	double g, Hs;
+	ss_shadow(inputs, tilt, az_eff, solzen, g, Hs);
+
+	double S, X;
+	if (!ss_xs(inputs, g, Hs, trackmode, linear, shade_frac_1x, X, S, outputs))
+		return true;
+
+	double m_B, m_row_length, m_R;
+	ss_row_dims(inputs, m_B, m_row_length, m_R);
+
+	//Chris Deline's self-shading algorithm
+
+	// 1. determine reduction of diffuse incident on shaded sections due to self-shading (beam is not derated because that shading is taken into account in dc derate)
+	diffuse_reduce( solzen, tilt, Gb_nor, Gd_poa, m_B/m_R, ss_mask_angle(inputs, tilt), albedo, inputs.nrows,
+		// outputs
+		outputs.m_reduced_diffuse, outputs.m_diffuse_derate, outputs.m_reduced_reflected, outputs.m_reflected_derate );
+
+	ss_dc_derate(inputs, X, S, Gb_poa, outputs);
+
+	return true;
+}
+
+ss_table::ss_table()
+	: m_setup(false), m_trackmode(false), m_check_enabled(false), m_tilt(0), m_step(0), m_gcr(0), m_ntilt(0)
+{
+}
+
+void ss_table::setup(const ssinputs &inputs, double tilt, bool trackmode, double step)
+{
+	m_setup = false;
+	m_trackmode = trackmode;
+	m_tilt = tilt;
+	m_step = step;
+	m_check = ss_table_check();
+
+	double m_B, m_row_length, m_R;
+	ss_row_dims(inputs, m_B, m_row_length, m_R);
+	m_gcr = m_B / m_R;
+
+	if (step <= 0 || inputs.nrows < 1)
+		return;
+
+	if (trackmode)
+	{
+		// one-axis trackers: mask angle over surface tilt [0,90]
+		m_ntilt = (int)floor(90.0 / step + M_EPS) + 1;
+		m_mask.resize(m_ntilt);
+		for (int k = 0; k < m_ntilt; k++)
+			m_mask[k] = ss_mask_angle(inputs, k * step);
+	}
+	else
+	{
+		// fixed tilt: the view factors don't change
+		diffuse_view_factors(tilt, m_gcr, ss_mask_angle(inputs, tilt), m_view);
+	}
+
+	m_setup = true;
+}
+
+bool ss_table::exec(
+	const ssinputs &inputs,
+	double tilt,
+	double azimuth,
+	double solzen,
+	double solazi,
+	double Gb_nor,
+	double Gb_poa,
+	double Gd_poa,
+	double albedo,
+	bool linear,
+	double shade_frac_1x,
+	ssoutputs &outputs)
+{
+	double g, Hs, F2u;
+	ss_view_factors vf;
+
+	if (!m_setup)
+		return ss_exec(inputs, tilt, azimuth, solzen, solazi, Gb_nor, Gb_poa, Gd_poa, albedo, m_trackmode, linear, shade_frac_1x, outputs);
+
+	if (m_trackmode)
+	{
+		double t = tilt / m_step;
+		if (t < 0 || t > m_ntilt - 1)
+			return ss_exec(inputs, tilt, azimuth, solzen, solazi, Gb_nor, Gb_poa, Gd_poa, albedo, m_trackmode, linear, shade_frac_1x, outputs);
+
+		int k = (int)t;
+		if (k > m_ntilt - 2) k = m_ntilt - 2;
+		double w = t - k;
+		diffuse_view_factors(tilt, m_gcr, m_mask[k] + w * (m_mask[k + 1] - m_mask[k]), vf);
+	}
+	else
+	{
+		if (tilt != m_tilt)
+			return ss_exec(inputs, tilt, azimuth, solzen, solazi, Gb_nor, Gb_poa, Gd_poa, albedo, m_trackmode, linear, shade_frac_1x, outputs);
+		vf = m_view;
+	}
+
+	// the shadow dimensions and F2 are cheap and are calculated directly. X and S round the shadow
+	// to whole modules and diodes, and F2 has a kink where the shadow reaches the next row, so
+	// interpolating either would misplace the steps
+	ss_shadow(inputs, tilt, solazi - azimuth, solzen, g, Hs);
+	F2u = diffuse_view_f2(solzen, tilt, m_gcr);
+
+	ssoutputs direct = outputs;
+
+	double S, X;
+	if (ss_xs(inputs, g, Hs, m_trackmode, linear, shade_frac_1x, X, S, outputs))
+	{
+		if (Gd_poa < 0.1)
+			outputs.m_diffuse_derate = outputs.m_reflected_derate = 1.0;
+		else
+			diffuse_reduce_vf(vf, F2u, solzen, Gb_nor, Gd_poa, albedo, inputs.nrows,
+				outputs.m_reduced_diffuse, outputs.m_diffuse_derate, outputs.m_reduced_reflected, outputs.m_reflected_derate);
+
+		ss_dc_derate(inputs, X, S, Gb_poa, outputs);
+	}
+
+	if (m_check_enabled)
+	{
+		ss_exec(inputs, tilt, azimuth, solzen, solazi, Gb_nor, Gb_poa, Gd_poa, albedo, m_trackmode, linear, shade_frac_1x, direct);
+
+		double diff = 0;
+		if (linear)
+		{
+			m_check.max_shade_frac = fmax(m_check.max_shade_frac, fabs(outputs.m_shade_frac_fixed - direct.m_shade_frac_fixed));
+			diff = fabs(outputs.m_shade_frac_fixed - direct.m_shade_frac_fixed);
+		}
+		else
+		{
+			double d_dc = fabs(outputs.m_dc_derate - direct.m_dc_derate);
+			double d_diff = fabs(outputs.m_diffuse_derate - direct.m_diffuse_derate);
+			double d_refl = fabs(outputs.m_reflected_derate - direct.m_reflected_derate);
+			m_check.max_dc_derate = fmax(m_check.max_dc_derate, d_dc);
+			m_check.max_diffuse_derate = fmax(m_check.max_diffuse_derate, d_diff);
+			m_check.max_reflected_derate = fmax(m_check.max_reflected_derate, d_refl);
+			diff = fmax(d_dc, fmax(d_diff, d_refl));
+		}
+		m_check.count++;
+		if (diff > m_check.tolerance)
+			m_check.nexceed++;
+	}
 
 	return true;
 }
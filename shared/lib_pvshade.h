@@ -51,6 +51,7 @@
 #define __pvshade_h
 
 #include <string>
+#include <vector>
 
 #include "lib_util.h"
 
@@ -165,4 +166,76 @@ bool ss_exec(
 	
 	ssoutputs &outputs);
 
+// view factors used by the diffuse reduction that depend only on surface tilt and mask angle.
+// F1 and F3 are per unit albedo
+struct ss_view_factors
+{
+	double cos_tilt;
+	double sky;		// 1 - cos^2(mask angle / 2)
+	double F1, F3;
+};
+
+// differences between ss_table and ss_exec accumulated when checking is enabled
+struct ss_table_check
+{
+	size_t count;				// number of table evaluations compared
+	size_t nexceed;				// number of evaluations where any output differs by more than tolerance
+	double tolerance;
+	double max_dc_derate;
+	double max_diffuse_derate;
+	double max_reflected_derate;
+	double max_shade_frac;
+
+	ss_table_check() : count(0), nexceed(0), tolerance(0.001), max_dc_derate(0), max_diffuse_derate(0), max_reflected_derate(0), max_shade_frac(0) {}
+};
+
+// precomputed self-shading geometry for one subarray, built once and reused at each time step.
+// fixed tilt arrays keep their sky and ground view factors, which need the mask angle. one-axis
+// trackers tabulate the mask angle over surface tilt, which is set by the rotation angle, and
+// interpolate it. the shadow dimensions, which the shaded fractions X and S round to whole modules
+// and diodes, the sun dependent ground view factor and the irradiance dependent part of the
+// calculation are always done directly, and conditions outside the table use ss_exec
+class ss_table
+{
+public:
+	ss_table();
+
+	// tilt is only used for fixed tilt arrays. step is the table resolution in degrees
+	void setup(const ssinputs &inputs, double tilt, bool trackmode, double step = 0.5);
+	bool is_setup() const { return m_setup; }
+
+	// compare each table evaluation against ss_exec, results are available from check()
+	void enable_check(bool b) { m_check_enabled = b; }
+	const ss_table_check &check() const { return m_check; }
+
+	// same arguments and outputs as ss_exec, with the tracking mode given to setup
+	bool exec(
+		const ssinputs &inputs,
+		double tilt,
+		double azimuth,
+		double solzen,
+		double solazi,
+		double Gb_nor,
+		double Gb_poa,
+		double Gd_poa,
+		double albedo,
+		bool linear,
+		double shade_frac_1x,
+		ssoutputs &outputs);
+
+private:
+	bool m_setup;
+	bool m_trackmode;
+	bool m_check_enabled;
+	double m_tilt;
+	double m_step;
+	double m_gcr;
+	int m_ntilt;
+
+	ss_view_factors m_view;					// fixed tilt view factors
+	std::vector<double> m_mask;				// tracker mask angle by surface tilt
+
+	ss_table_check m_check;
+};
+
 #endif
\ No newline at end of file
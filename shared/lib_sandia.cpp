@@ -293,19 +293,14 @@ sandia_module_t::sandia_module_t( )
 }
 
 
-bool sandia_module_t::operator() ( pvinput_t &in, double TcellC, double opvoltage, pvoutput_t &out )
+bool sandia_module_t::operating_conditions( const pvinput_t &in, double TcellC, oper_t &op )
 {
-	
-	out.Power = out.Voltage = out.Current = out.Efficiency = out.Voc_oper = out.Isc_oper = 0.0;
-	out.CellTemp = TcellC;
-	
-	double Gtotal;
 	if( in.radmode != 3 || !in.usePOAFromWF )
-		Gtotal = in.Ibeam + in.Idiff + in.Ignd;
+		op.Gtotal = in.Ibeam + in.Idiff + in.Ignd;
 	else
-		Gtotal = in.poaIrr;
+		op.Gtotal = in.poaIrr;
 
-	if ( Gtotal > 0.0 )
+	if ( op.Gtotal > 0.0 )
 	{
 		//C Calculate Air Mass
 		double AMa = sandia_absolute_air_mass(in.Zenith, in.Elev);
@@ -314,60 +309,104 @@ bool sandia_module_t::operator() ( pvinput_t &in, double TcellC, double opvoltag
 		double F1 = sandia_f1(AMa,A0,A1,A2,A3,A4);
 
 		//C Calculate F2 function:
-		double F2 = sandia_f2(in.IncAng,B0,B1,B2,B3,B4,B5);
+		op.F2 = sandia_f2(in.IncAng,B0,B1,B2,B3,B4,B5);
 
 		//C Calculate short-circuit current:
-		double Isc = sandia_isc(TcellC,Isc0,in.Ibeam, in.Idiff+in.Ignd,F1,F2,fd,aIsc, in.radmode, Gtotal);
+		op.Isc = sandia_isc(TcellC,Isc0,in.Ibeam, in.Idiff+in.Ignd,F1,op.F2,fd,aIsc, in.radmode, op.Gtotal);
 
 		//C Calculate effective irradiance:
-		double Ee = sandia_effective_irradiance(TcellC,Isc,Isc0,aIsc);
+		double Ee = sandia_effective_irradiance(TcellC,op.Isc,Isc0,aIsc);
 
 		//C Calculate Imp:
-		double Imp = sandia_imp(TcellC,Ee,Imp0,aImp,C0,C1);
+		op.Imp = sandia_imp(TcellC,Ee,Imp0,aImp,C0,C1);
 
 		//C Calculate Voc:
-		double Voc = sandia_voc(TcellC,Ee,Voc0,NcellSer,DiodeFactor,BVoc0,mBVoc);
+		op.Voc = sandia_voc(TcellC,Ee,Voc0,NcellSer,DiodeFactor,BVoc0,mBVoc);
 
 		//C Calculate Vmp:
-		double Vmp = sandia_vmp(TcellC,Ee,Vmp0,NcellSer,DiodeFactor,BVmp0,mBVmp,C2,C3);
+		op.Vmp = sandia_vmp(TcellC,Ee,Vmp0,NcellSer,DiodeFactor,BVmp0,mBVmp,C2,C3);
+		return true;
+	}
+	return false;
+}
 
-		double V, I;
-		if ( opvoltage < 0 )
-		{
-			V = Vmp;
-			I = Imp;
-		}
-		else
-		{		
-			//C Calculate Ix:
+void sandia_module_t::set_output( const oper_t &op, double TcellC, double opvoltage, pvoutput_t &out )
+{
+	double V, I;
+	if ( opvoltage < 0 )
+	{
+		V = op.Vmp;
+		I = op.Imp;
+	}
+	else
+	{		
+		//C Calculate Ix:
 //			double Ix = sandia_ix(TcellC,Ee,Ix0,aIsc,aImp,C4,C5);
 
-			//C Calculate Vx:
+		//C Calculate Vx:
 //			double Vx = Voc/2.0;
 
-			//C Calculate Ixx:
+		//C Calculate Ixx:
 //			double Ixx = sandia_ixx(TcellC,Ee,Ixx0,aImp,C6,C7);
 
-			//C Calculate Vxx:
+		//C Calculate Vxx:
 //			double Vxx = 0.5*(Voc + Vmp);
-			
-			// calculate current at operating voltage
-			V = opvoltage;
-			
-			// is this correct? (taken from SAM uicallback) (i.e. does not Ix, Ixx, etc)
-			I = sandia_current_at_voltage( opvoltage, Vmp, Imp, Voc, Isc );
-		}
-	
-		out.Power = V*I;
-		out.Voltage = V;
-		out.Current = I;
-		out.Efficiency = I*V/(Gtotal*Area);
-		out.AOIModifier = F2;
-		out.Voc_oper = Voc;
-		out.Isc_oper = Isc;
-		out.CellTemp = TcellC;
+		
+		// calculate current at operating voltage
+		V = opvoltage;
+		
+		// is this correct? (taken from SAM uicallback) (i.e. does not Ix, Ixx, etc)
+		I = sandia_current_at_voltage( opvoltage, op.Vmp, op.Imp, op.Voc, op.Isc );
 	}
 	
+	out.Power = V*I;
+	out.Voltage = V;
+	out.Current = I;
+	out.Efficiency = I*V/(op.Gtotal*Area);
+	out.AOIModifier = op.F2;
+	out.Voc_oper = op.Voc;
+	out.Isc_oper = op.Isc;
+	out.CellTemp = TcellC;
+}
+
+bool sandia_module_t::operator() ( pvinput_t &in, double TcellC, double opvoltage, pvoutput_t &out )
+{
+	
+	out.Power = out.Voltage = out.Current = out.Efficiency = out.Voc_oper = out.Isc_oper = 0.0;
+	out.CellTemp = TcellC;
+	
+	oper_t op;
+	if ( operating_conditions( in, TcellC, op ) )
+		set_output( op, TcellC, opvoltage, out );
+	
+	return true;
+}
+
+bool sandia_module_t::run_batch( const pvinput_soa &input, const double *TcellC, const double *opvoltage, pvoutput_soa &output )
+{
+/*
+	Consecutive records with the same inputs and cell temperature, as in a voltage sweep, share their 
+	operating conditions. Results are identical to the scalar form.
+*/
+	oper_t op;
+	bool lit = false;
+	pvinput_t in;
+	pvoutput_t out;
+	for( size_t i=0; i<input.size(); i++ )
+	{
+		if ( i == 0 || TcellC[i] != TcellC[i-1] || !input.equal( i, i-1 ) )
+		{
+			input.get( i, in );
+			lit = operating_conditions( in, TcellC[i], op );
+		}
+
+		output.get( i, out );
+		out.Power = out.Voltage = out.Current = out.Efficiency = out.Voc_oper = out.Isc_oper = 0.0;
+		out.CellTemp = TcellC[i];
+		if ( lit )
+			set_output( op, TcellC[i], opvoltage ? opvoltage[i] : -1.0, out );
+		output.set( i, out );
+	}
 	return true;
 }
 
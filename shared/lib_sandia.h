@@ -83,6 +83,20 @@ public:
 	virtual double VocRef() { return Voc0; }
 	virtual double IscRef() { return Isc0; }
 	virtual bool operator() ( pvinput_t &input, double TcellC, double opvoltage, pvoutput_t &output);
+	virtual bool run_batch( const pvinput_soa &input, const double *TcellC, const double *opvoltage, pvoutput_soa &output );
+
+protected:
+	// model values at operating conditions
+	struct oper_t
+	{
+		double Gtotal; // total incident irradiance, W/m2
+		double F2; // angle of incidence modifier
+		double Isc, Imp, Voc, Vmp;
+	};
+
+	// returns false if there is no incident irradiance
+	bool operating_conditions( const pvinput_t &in, double TcellC, oper_t &op );
+	void set_output( const oper_t &op, double TcellC, double opvoltage, pvoutput_t &out );
 };
 
 
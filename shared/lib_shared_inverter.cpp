@@ -1,6 +1,7 @@
 #include "lib_shared_inverter.h"
 #include "lib_util.h"
 #include <algorithm>
+#include <cmath>
 
 SharedInverter::SharedInverter(int inverterType, size_t numberOfInverters,
 	sandia_inverter_t * sandiaInverter, partload_inverter_t * partloadInverter)
@@ -10,6 +11,24 @@ SharedInverter::SharedInverter(int inverterType, size_t numberOfInverters,
 	m_sandiaInverter = sandiaInverter;
 	m_partloadInverter = partloadInverter;
 	m_tempEnabled = false;
+
+	powerDC_kW = powerAC_kW = efficiencyAC = 0.;
+	powerClipLoss_kW = powerConsumptionLoss_kW = powerNightLoss_kW = powerTempLoss_kW = 0.;
+
+	m_tableEnabled = false;
+	m_tablePowerMin = m_tablePowerStep = m_tableVoltageMin = m_tableVoltageStep = m_tableTempMin = m_tableTempStep = 0.;
+	m_tableNumPower = m_tableNumVoltage = m_tableNumTemp = 0;
+}
+
+void SharedInverterOutputs::resize(size_t n)
+{
+	powerDC_kW.resize(n);
+	powerAC_kW.resize(n);
+	efficiencyAC.resize(n);
+	powerClipLoss_kW.resize(n);
+	powerConsumptionLoss_kW.resize(n);
+	powerNightLoss_kW.resize(n);
+	powerTempLoss_kW.resize(n);
 }
 
 bool sortByVoltage(std::vector<double> i, std::vector<double> j)
@@ -59,6 +78,11 @@ void SharedInverter::calculateTempDerate(double V, double T, double& pAC, double
 {
 	if (eff == 0. || pAC == 0.) return;
 
+	applyTempDerate(calculateTempDerateChange(V, T), pAC, eff, loss);
+}
+
+double SharedInverter::calculateTempDerateChange(double V, double T)
+{
 	double slope = 0.0;
 	double startT = 0.0;
 	double Vdc = 0.0;
@@ -122,34 +146,56 @@ void SharedInverter::calculateTempDerate(double V, double T, double& pAC, double
 	deltaT = T - startTInterpolated;
 
 	// If less than start temp, no derating
-	if (deltaT <= 0) return;
+	if (deltaT <= 0) return 0.;
 
 	// If slope is positive, set to zero with no derating
-	if (slopeInterpolated >= 0) return;
+	if (slopeInterpolated >= 0) return 0.;
 	if (slopeInterpolated < -1) slopeInterpolated = -1;
 
+	return deltaT* slopeInterpolated;
+}
+
+void SharedInverter::applyTempDerate(double effChange, double& pAC, double& eff, double& loss)
+{
+	if (effChange == 0.) return;
+
 	// Power in units of W, eff as ratio
 	double pDC = pAC/eff;
-	eff += deltaT* slopeInterpolated;
+	eff += effChange;
 	if (eff < 0) eff = 0.;
 	loss = pAC - (pDC * eff);
 	pAC = pDC * eff;	
 }
 
-void SharedInverter::calculateACPower(const double powerDC_Watts, const double DCStringVoltage, double T)
-{
+void SharedInverter::calculateInverterPower(double powerDC_Watts, double DCStringVoltage)
+{
+	if (m_tableEnabled && lookupInverterPower(powerDC_Watts, DCStringVoltage))
+		return;
+
 	double P_par, P_lr;
-	bool negativePower = powerDC_Watts < 0 ? true : false;
 
 	// Power quantities go in and come out in units of W
 	if (m_inverterType == SANDIA_INVERTER || m_inverterType == DATASHEET_INVERTER || m_inverterType == COEFFICIENT_GENERATOR)
-		m_sandiaInverter->acpower(std::fabs(powerDC_Watts) / m_numInverters, DCStringVoltage, &powerAC_kW, &P_par, &P_lr, &efficiencyAC, &powerClipLoss_kW, &powerConsumptionLoss_kW, &powerNightLoss_kW);
-	else if (m_inverterType == PARTLOAD_INVERTER)
-		m_partloadInverter->acpower(std::fabs(powerDC_Watts) / m_numInverters, &powerAC_kW, &P_lr, &P_par, &efficiencyAC, &powerClipLoss_kW, &powerNightLoss_kW);
+		m_sandiaInverter->acpower(powerDC_Watts, DCStringVoltage, &powerAC_kW, &P_par, &P_lr, &efficiencyAC, &powerClipLoss_kW, &powerConsumptionLoss_kW, &powerNightLoss_kW);
+	else if (m_inverterType == PARTLOAD_INVERTER) {
+		m_partloadInverter->acpower(powerDC_Watts, &powerAC_kW, &P_lr, &P_par, &efficiencyAC, &powerClipLoss_kW, &powerNightLoss_kW);
+		powerConsumptionLoss_kW = 0.; // the partload curve includes operating consumption
+	}
+}
+
+void SharedInverter::calculateACPower(const double powerDC_Watts, const double DCStringVoltage, double T)
+{
+	bool negativePower = powerDC_Watts < 0 ? true : false;
+
+	calculateInverterPower(std::fabs(powerDC_Watts) / m_numInverters, DCStringVoltage);
 
 	double tempLoss = 0.0;
 	if (m_tempEnabled){
-		calculateTempDerate(DCStringVoltage, T, powerAC_kW, efficiencyAC, tempLoss);
+		double effChange;
+		if (m_tableEnabled && efficiencyAC != 0. && powerAC_kW != 0. && lookupTempDerateChange(T, effChange))
+			applyTempDerate(effChange, powerAC_kW, efficiencyAC, tempLoss);
+		else
+			calculateTempDerate(DCStringVoltage, T, powerAC_kW, efficiencyAC, tempLoss);
 	}
 
 	// Convert units to kW
@@ -167,6 +213,196 @@ void SharedInverter::calculateACPower(const double powerDC_Watts, const double D
 	}
 }
 
+void SharedInverter::calculateACPower(const std::vector<double> &powerDC_Watts, const std::vector<double> &DCStringVoltage, const std::vector<double> &T, SharedInverterOutputs &outputs)
+{
+	size_t n = powerDC_Watts.size();
+	outputs.resize(n);
+	for (size_t i = 0; i < n; i++) {
+		calculateACPower(powerDC_Watts[i], DCStringVoltage[i], T[i]);
+		outputs.powerDC_kW[i] = powerDC_kW;
+		outputs.powerAC_kW[i] = powerAC_kW;
+		outputs.efficiencyAC[i] = efficiencyAC;
+		outputs.powerClipLoss_kW[i] = powerClipLoss_kW;
+		outputs.powerConsumptionLoss_kW[i] = powerConsumptionLoss_kW;
+		outputs.powerNightLoss_kW[i] = powerNightLoss_kW;
+		outputs.powerTempLoss_kW[i] = powerTempLoss_kW;
+	}
+}
+
+// Index of the table interval containing x and the fraction of the way across it, false if x is outside of the table
+static bool tableInterval(double x, double x0, double step, size_t n, size_t &i, double &f)
+{
+	if (n < 2) {
+		i = 0;
+		f = 0.;
+		return true;
+	}
+	double u = (x - x0) / step;
+	if (!(u >= 0.) || u > (double)(n - 1)) return false;
+	i = (size_t)u;
+	if (i > n - 2) i = n - 2;
+	f = u - (double)i;
+	return true;
+}
+
+bool SharedInverter::lookupInverterPower(double powerDC_Watts, double DCStringVoltage)
+{
+	size_t iv, ip;
+	double fv, fp;
+	if (powerDC_Watts <= m_tablePowerMin
+		|| !tableInterval(DCStringVoltage, m_tableVoltageMin, m_tableVoltageStep, m_tableNumVoltage, iv, fv)
+		|| !tableInterval(powerDC_Watts, m_tablePowerMin, m_tablePowerStep, m_tableNumPower, ip, fp))
+		return false;
+
+	size_t k0 = iv * m_tableNumPower + ip;
+	size_t k1 = m_tableNumVoltage > 1 ? k0 + m_tableNumPower : k0;
+	double output = (1 - fv) * ((1 - fp) * m_tableOutput[k0] + fp * m_tableOutput[k0 + 1]) + fv * ((1 - fp) * m_tableOutput[k1] + fp * m_tableOutput[k1 + 1]);
+	double consumptionLoss = (1 - fv) * ((1 - fp) * m_tableConsumptionLoss[k0] + fp * m_tableConsumptionLoss[k0 + 1]) + fv * ((1 - fp) * m_tableConsumptionLoss[k1] + fp * m_tableConsumptionLoss[k1 + 1]);
+
+	double Paco, powerAC;
+	if (m_inverterType == PARTLOAD_INVERTER) {
+		// the partload model reports the efficiency before clipping
+		Paco = m_partloadInverter->Paco;
+		efficiencyAC = output;
+		powerAC = output * powerDC_Watts;
+	}
+	else {
+		Paco = m_sandiaInverter->Paco;
+		powerAC = output;
+	}
+
+	powerClipLoss_kW = 0.;
+	if (powerAC > Paco) {
+		powerClipLoss_kW = powerAC - Paco;
+		powerAC = Paco;
+	}
+	if (m_inverterType != PARTLOAD_INVERTER)
+		efficiencyAC = powerAC / powerDC_Watts;
+	if (efficiencyAC < 0.) efficiencyAC = 0.;
+
+	powerAC_kW = powerAC;
+	powerConsumptionLoss_kW = consumptionLoss;
+	powerNightLoss_kW = 0.;
+	return true;
+}
+
+bool SharedInverter::lookupTempDerateChange(double T, double &effChange)
+{
+	size_t it;
+	double ft;
+	if (m_tableTempDerate.empty()
+		|| !tableInterval(T, m_tableTempMin, m_tableTempStep, m_tableNumTemp, it, ft))
+		return false;
+
+	effChange = (1 - ft) * m_tableTempDerate[it] + ft * m_tableTempDerate[it + 1];
+	return true;
+}
+
+bool SharedInverter::setupEfficiencyTable(double voltageMin, double voltageMax, size_t numPower, size_t numVoltage, double tempMin, double tempMax, size_t numTemp)
+{
+	m_tableEnabled = false;
+	m_tableOutput.clear();
+	m_tableConsumptionLoss.clear();
+	m_tableTempDerate.clear();
+
+	double Pdco = 0., powerMin = 0.;
+	if (m_inverterType == SANDIA_INVERTER || m_inverterType == DATASHEET_INVERTER || m_inverterType == COEFFICIENT_GENERATOR) {
+		Pdco = m_sandiaInverter->Pdco;
+		powerMin = m_sandiaInverter->Pso;
+	}
+	else if (m_inverterType == PARTLOAD_INVERTER)
+		Pdco = m_partloadInverter->Pdco;
+
+	// a single derate curve depends only on temperature, interpolation between curves is left to the model
+	bool tabulateTemp = m_tempEnabled && m_thermalDerateCurves.size() == 1;
+
+	if (Pdco <= 0. || powerMin < 0. || 2. * Pdco <= powerMin || numPower < 2 || voltageMax < voltageMin
+		|| (tabulateTemp && (numTemp < 2 || tempMax <= tempMin)))
+		return false;
+	if (numVoltage < 2 || voltageMax == voltageMin || m_inverterType == PARTLOAD_INVERTER)
+		numVoltage = 1;
+
+	m_tablePowerMin = powerMin;
+	m_tablePowerStep = (2. * Pdco - powerMin) / (numPower - 1);
+
+	// when the partload curve points are evenly spaced from zero, put them on table points so the interpolation matches the model
+	if (m_inverterType == PARTLOAD_INVERTER) {
+		const std::vector<double> &partload = m_partloadInverter->Partload;
+		size_t n = partload.size();
+		bool evenlySpaced = n > 1 && partload[0] == 0. && partload[n - 1] > 0.;
+		double spacing = evenlySpaced ? partload[n - 1] / (n - 1) : 0.;
+		for (size_t i = 1; evenlySpaced && i < n; i++)
+			evenlySpaced = std::fabs(partload[i] - i * spacing) < 1e-6 * partload[n - 1];
+		if (evenlySpaced) {
+			double curveStep = spacing * 0.01 * Pdco;
+			m_tablePowerStep = curveStep / std::ceil(curveStep / m_tablePowerStep);
+			numPower = (size_t)std::ceil(2. * Pdco / m_tablePowerStep - 1e-9) + 1;
+		}
+	}
+	m_tableNumPower = numPower;
+	m_tableNumVoltage = numVoltage;
+	m_tableVoltageMin = voltageMin;
+	m_tableVoltageStep = numVoltage > 1 ? (voltageMax - voltageMin) / (numVoltage - 1) : 0.;
+
+	// the first power is just above the start-up (Sandia) or zero (partload) power, where the model turns on.
+	// Sandia AC power is close to quadratic in DC power and partload efficiency is piecewise linear, so those are tabulated
+	m_tableOutput.resize(numVoltage * numPower);
+	m_tableConsumptionLoss.resize(numVoltage * numPower);
+	for (size_t iv = 0; iv < numVoltage; iv++) {
+		double V = voltageMin + iv * m_tableVoltageStep;
+		for (size_t ip = 0; ip < numPower; ip++) {
+			double P = (ip == 0) ? std::nextafter(powerMin, 2. * Pdco) : powerMin + ip * m_tablePowerStep;
+			calculateInverterPower(P, V);
+			m_tableOutput[iv * numPower + ip] = (m_inverterType == PARTLOAD_INVERTER) ? efficiencyAC : powerAC_kW + powerClipLoss_kW;
+			m_tableConsumptionLoss[iv * numPower + ip] = powerConsumptionLoss_kW;
+		}
+	}
+
+	if (tabulateTemp) {
+		m_tableNumTemp = numTemp;
+		m_tableTempMin = tempMin;
+		m_tableTempStep = (tempMax - tempMin) / (numTemp - 1);
+		m_tableTempDerate.resize(numTemp);
+		for (size_t it = 0; it < numTemp; it++)
+			m_tableTempDerate[it] = calculateTempDerateChange(voltageMin, tempMin + it * m_tableTempStep);
+	}
+
+	m_tableEnabled = true;
+	return true;
+}
+
+bool SharedInverter::isEfficiencyTableSetup()
+{
+	return m_tableEnabled;
+}
+
+double SharedInverter::checkEfficiencyTable()
+{
+	if (!m_tableEnabled) return 0.;
+
+	double maxDiff = 0.;
+	size_t numVoltage = m_tableNumVoltage > 1 ? m_tableNumVoltage - 1 : 1;
+	for (size_t iv = 0; iv < numVoltage; iv++) {
+		double V = m_tableVoltageMin + (iv + 0.5) * m_tableVoltageStep;
+		for (size_t ip = 0; ip + 1 < m_tableNumPower; ip++) {
+			double P = m_tablePowerMin + (ip + 0.5) * m_tablePowerStep;
+			m_tableEnabled = false;
+			calculateInverterPower(P, V);
+			double effModel = efficiencyAC;
+			m_tableEnabled = true;
+			calculateInverterPower(P, V);
+			maxDiff = std::max(maxDiff, std::fabs(efficiencyAC - effModel) * 100.);
+		}
+	}
+	for (size_t it = 0; it + 1 < m_tableNumTemp && !m_tableTempDerate.empty(); it++) {
+		double T = m_tableTempMin + (it + 0.5) * m_tableTempStep;
+		double effChange = 0.;
+		lookupTempDerateChange(T, effChange);
+		maxDiff = std::max(maxDiff, std::fabs(effChange - calculateTempDerateChange(m_tableVoltageMin, T)) * 100.);
+	}
+	return maxDiff;
+}
+
 double SharedInverter::getInverterDCNominalVoltage()
 {
 	if (m_inverterType == SANDIA_INVERTER || m_inverterType == DATASHEET_INVERTER || m_inverterType == COEFFICIENT_GENERATOR)
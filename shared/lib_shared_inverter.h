@@ -5,6 +5,20 @@
 #include "lib_pvinv.h"
 #include <vector>
 
+/// Per time step outputs of SharedInverter::calculateACPower for a batch of time steps
+struct SharedInverterOutputs
+{
+	void resize(size_t n);
+
+	std::vector<double> powerDC_kW;
+	std::vector<double> powerAC_kW;
+	std::vector<double> efficiencyAC;
+	std::vector<double> powerClipLoss_kW;
+	std::vector<double> powerConsumptionLoss_kW;
+	std::vector<double> powerNightLoss_kW;
+	std::vector<double> powerTempLoss_kW;
+};
+
 /**
 *
 * \class SharedInverter
@@ -31,6 +45,33 @@ public:
 	/// Given the combined PV plus battery DC power (W), voltage and ambient T, compute the AC power (kW)
 	void calculateACPower(const double powerDC, const double DCStringVoltage, double ambientT);
 
+	/// Compute the AC power for arrays of time steps, leaving the current timestep values at those of the last step
+	void calculateACPower(const std::vector<double> &powerDC, const std::vector<double> &DCStringVoltage, const std::vector<double> &ambientT, SharedInverterOutputs &outputs);
+
+	/**
+	* Tabulate the inverter model over DC power and voltage, and a single temperature derate curve over ambient T,
+	* so calculateACPower interpolates instead of evaluating the model. Powers below the start-up (Sandia) or zero
+	* (partload) power, above twice the rated DC power per inverter, voltages or temperatures outside the given
+	* ranges, and derating between several voltage curves still use the model. Clipping and night time losses are
+	* applied to the interpolated power exactly.
+	*
+	* Largest efficiency differences from the models with the default table sizes, over the full table range:
+	*   Sandia/datasheet/coefficient generator: 0.0003 % points, highest just above the start-up power
+	*   Partload: round-off only when the curve points are evenly spaced from zero, as SAM generates them, otherwise
+	*   up to the change in curve slope x (DC power step / 4) next to each curve point
+	*   Temperature derate: up to |slope| x (temperature step / 4) next to the start temperature, zero elsewhere
+	* The Sandia model is only a few multiplications, so the table mainly pays off for partload curves.
+	*
+	* Returns false if there is no inverter model to tabulate
+	*/
+	bool setupEfficiencyTable(double voltageMin, double voltageMax, size_t numPower = 1001, size_t numVoltage = 41, double tempMin = -40., double tempMax = 60., size_t numTemp = 501);
+
+	/// Returns true if calculateACPower is using the efficiency table
+	bool isEfficiencyTableSetup();
+
+	/// Compare the table with the models halfway between table points, returns the largest efficiency difference (% points)
+	double checkEfficiencyTable();
+
 	/// Return the nominal DC voltage input
 	double getInverterDCNominalVoltage();
 
@@ -61,6 +102,29 @@ protected:
 	/// Given a temp, find which slope to apply
 	void findPointOnCurve(size_t idx, double T, double& startT, double& slope);
 
+	/// Efficiency change (ratio, <= 0) due to temperature derating at DC voltage V and ambient T
+	double calculateTempDerateChange(double V, double T);
+
+	/// Modifies pAc, eff, and loss by applying an efficiency change from calculateTempDerateChange
+	void applyTempDerate(double effChange, double& pAC, double& eff, double& loss);
+
+	/// Per inverter AC power (W) and losses from the inverter model or the table, before temperature derating
+	void calculateInverterPower(double powerDC_Watts, double DCStringVoltage);
+
+	/// Returns false if the table does not cover the inputs
+	bool lookupInverterPower(double powerDC_Watts, double DCStringVoltage);
+	bool lookupTempDerateChange(double T, double &effChange);
+
+	/// Efficiency table, see setupEfficiencyTable
+	bool m_tableEnabled;
+	double m_tablePowerMin, m_tablePowerStep;
+	double m_tableVoltageMin, m_tableVoltageStep;
+	double m_tableTempMin, m_tableTempStep;
+	size_t m_tableNumPower, m_tableNumVoltage, m_tableNumTemp;
+	std::vector<double> m_tableOutput;				/// AC power before clipping (W, Sandia) or efficiency (partload), by voltage then DC power
+	std::vector<double> m_tableConsumptionLoss;		/// Operating power consumption loss (W), by voltage then DC power
+	std::vector<double> m_tableTempDerate;			/// Efficiency change from calculateTempDerateChange by T, single derate curve only
+
 	// Memory managed elsewehre
 	sandia_inverter_t * m_sandiaInverter;
 	partload_inverter_t * m_partloadInverter;
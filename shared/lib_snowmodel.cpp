@@ -109,22 +109,57 @@ bool pvsnowmodel::setup(int nmody_in, float baseTilt_in){
 }
 
 
-bool pvsnowmodel::getLoss(float poa, float tilt, float , float tdry, float snowDepth, int sunup, float dt, float *returnLoss){
-
-	bool isGood = true;
+bool pvsnowmodel::checkDepth(float &snowDepth){
 
 	// Check if snow depth value is valid
 	// * 610 cm ~= 20 ft
 	if (snowDepth < 0 || snowDepth > 610 || std::isnan(snowDepth)){
-		isGood = false;
 		snowDepth = 0;
 		badValues++;
 		if (badValues == maxBadValues){
 			good = false;
 			msg = util::format("The weather file contains no snow depth data or the data is not valid. Found (%d) bad snow depth values.", maxBadValues);
-			return false;
-		} 
+		}
+		return false;
+	}
+	return true;
+}
+
+size_t pvsnowmodel::setupSnowEvents(const std::vector<float> &snowDepth){
+
+	// Whenever the snow depth is below depthThreshold (invalid values count as zero depth),
+	// Coverage Override #1 in getLoss sets the coverage to zero no matter what the previous
+	// coverage was, so only the steps marked here need the full state machine
+	snowEvents.assign(snowDepth.size(), false);
+	size_t nEvents = 0;
+	for (size_t i = 0; i < snowDepth.size(); i++){
+		float depth = snowDepth[i];
+		if (depth >= 0 && depth <= 610 && depth >= depthThreshold){
+			snowEvents[i] = true;
+			nEvents++;
+		}
 	}
+	return nEvents;
+}
+
+bool pvsnowmodel::getLossSnowFree(float snowDepth, float *returnLoss){
+
+	bool isGood = checkDepth(snowDepth);
+	if (!isGood && badValues == maxBadValues) return false;
+
+	coverage = 0;
+	*returnLoss = 0;
+
+	previousDepth = snowDepth;
+	pCvg = coverage;
+
+	return isGood;
+}
+
+bool pvsnowmodel::getLoss(float poa, float tilt, float , float tdry, float snowDepth, int sunup, float dt, float *returnLoss){
+
+	bool isGood = checkDepth(snowDepth);
+	if (!isGood && badValues == maxBadValues) return false;
 		
 	/////////////////////////////
 	// Step 1
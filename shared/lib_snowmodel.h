@@ -51,6 +51,7 @@
 #define __lib_snowmodel_h
 
 #include <string>
+#include <vector>
 
 class pvsnowmodel
 {
@@ -60,6 +61,13 @@ public:
 
 	bool getLoss(float poa, float tilt, float wspd, float tdry, float snowDepth, int sunup, float dt, float *returnLoss);
 
+	// Marks the time steps of a whole-year snow depth array that can carry snow coverage; returns the number of marked steps
+	size_t setupSnowEvents(const std::vector<float> &snowDepth);
+	// True if step idx is marked in the snow event index (or no index has been set up), idx may run over multiple years
+	bool isSnowEvent(size_t idx) const { return snowEvents.empty() || snowEvents[idx % snowEvents.size()]; }
+	// Equivalent to getLoss for a step that is not a snow event: only the snow depth history and bad value count are updated
+	bool getLossSnowFree(float snowDepth, float *returnLoss);
+
 	float	tilt,		// Surface tilt, degrees
 		baseTilt,		// The default tilt for 1-axis tracking systems
 		mSlope,			// This is a value given by fig. 4 in [1]
@@ -77,6 +85,11 @@ public:
 	std::string msg;		// This is a string used to return error messages
 	bool good;				// This an error flag that will be set to false
 							//  if an error has occured
+
+	std::vector<bool> snowEvents;	// Per step flag, true where the snow depth is valid and at or above depthThreshold
+
+private:
+	bool checkDepth(float &snowDepth);
 };
 
 #endif
\ No newline at end of file
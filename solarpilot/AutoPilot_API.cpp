@@ -994,7 +994,23 @@ bool AutoPilot::Optimize(int /*method*/, vector<double*> &optvars, vector<double
 	   // return OptimizeRSGS(optvars, upper_range, lower_range, is_range_constr);
     //    break;
     //case 1: //COBYLA with separate bound constraint
-        return OptimizeAuto( optvars, upper_range, lower_range, stepsize, names);        
+    //Designs evaluated by the optimizer are often repeated or differ only in a few variables, so reuse the 
+    //heliostat results of earlier evaluations where the inputs are unchanged. The field copies made for 
+    //multithreaded simulations share the stored results.
+    bool is_incremental = _SF->getIncrementalSimulation();
+    _SF->setIncrementalSimulation(true);
+    bool ok;
+    try
+    {
+        ok = OptimizeAuto( optvars, upper_range, lower_range, stepsize, names);
+    }
+    catch(...)
+    {
+        _SF->setIncrementalSimulation(is_incremental);
+        throw;
+    }
+    _SF->setIncrementalSimulation(is_incremental);
+    return ok;
     //default:
         //return OptimizeSemiAuto( optvars, upper_range, lower_range, is_range_constr, names);
     //}
@@ -2296,118 +2312,25 @@ bool AutoPilot_MT::CreateLayout(sp_layout &layout, bool do_post_process)
 			//If full simulation is required...
 			if(full_sim){
 
-				int nthreads = min(nsim_req, _n_threads);
-
 				//update progress
 				if(_has_detail_callback)
-					_detail_siminfo->addSimulationNotice("Preparing " + my_to_string(_n_threads) + " threads for simulation");
-				
+					_detail_siminfo->addSimulationNotice("Preparing " + my_to_string(min(nsim_req, _n_threads)) + " threads for simulation");
 				
-				//Duplicate SF objects in memory
-				SolarField **SFarr;
-				SFarr = new SolarField*[nthreads];
-				for(int i=0; i<nthreads; i++){
-					SFarr[i] = new SolarField(*_SF);
-				}
-			
 				//Create sufficient results arrays in memory
 				sim_results results;
 				results.resize(nsim_req);
-						
-				//Calculate the number of simulations per thread
-				int npert = (int)ceil((float)nsim_req/(float)nthreads);
-
-				//Create thread objects
-				_simthread = new LayoutSimThread[nthreads];
-				_n_threads_active = nthreads;	//Keep track of how many threads are active
-				_in_mt_simulation = true;
-			
-				int
-					sim_first = 0,
-					sim_last = npert;
-				for(int i=0; i<nthreads; i++){
-                    std::string istr = my_to_string(i+1);
-                    _simthread[i].Setup(istr, SFarr[i], &results, &wdata, sim_first, sim_last, false, false);
-					sim_first = sim_last;
-					sim_last = min(sim_last+npert, nsim_req);
-				}
 				
 				if(_has_detail_callback){
 					_detail_siminfo->setTotalSimulationCount(nsim_req);
 					_detail_siminfo->setCurrentSimulation(0);
 					_detail_siminfo->addSimulationNotice("Simulating layout design-point hours...");
 				}
+				_sim_total = nsim_req;
 				
 				//Run
-				for(int i=0; i<nthreads; i++)
-					thread( &LayoutSimThread::StartThread, std::ref( _simthread[i] ) ).detach();
-			
-
-				//Wait loop
-				while(true){
-					int nsim_done = 0, nsim_remain=0, nthread_done=0;
-					for(int i=0; i<nthreads; i++){
-						if( _simthread[i].IsFinished() )
-							nthread_done ++;
-					
-						int ns, nr;
-						_simthread[i].GetStatus(&ns, &nr);
-						nsim_done += ns;
-						nsim_remain += nr;
-					
-					
-					}
-					_sim_total = nsim_req;
-					_sim_complete = nsim_done;
-
-					if(_has_detail_callback){
-						if(! _detail_siminfo->setCurrentSimulation(nsim_done) )
-                            break;
-                    }
-					
-				
-					if(nthread_done == nthreads) break;
-					std::this_thread::sleep_for(std::chrono::milliseconds(75));
-
-				}
-
-				//Check to see whether the simulation was cancelled
-				bool cancelled = false;
-				for(int i=0; i<nthreads; i++){
-					cancelled = cancelled || _simthread[i].IsSimulationCancelled();
-				}
-			    //check to see whether simulation errored out
-                bool errored_out = false;
-                for(int i=0; i<_n_threads; i++){
-                    errored_out = errored_out || _simthread[i].IsFinishedWithErrors();
-                }
-                if( errored_out )
-                {
-                    CancelSimulation();
-                    //Get the error messages, if any
-                    string errmsgs;
-                    for(int i=0; i<_n_threads; i++){
-                        for(int j=0; j<(int)_simthread[i].GetSimMessages()->size(); j++)
-                            errmsgs.append( _simthread[i].GetSimMessages()->at(j) + "\n");
-                    }
-                    //Display error messages
-                    if(! errmsgs.empty() && _has_summary_callback)
-                        _summary_siminfo->addSimulationNotice( errmsgs.c_str() );
-            
-                }
-
-	            //Clean up dynamic memory
-	            for(int i=0; i<_n_threads; i++){
-		            delete SFarr[i];
-	            }
-	            delete [] SFarr;
-	            delete [] _simthread;
-	            _simthread = 0;
-
-	            //If the simulation was cancelled per the check above, exit out
-	            if(cancelled || errored_out){
-		            return false;
-	            }
+				sim_params P;
+				if(! SimulateThreaded(results, nsim_req, &wdata, 0, P, false, false, true, _has_detail_callback ? _detail_siminfo : 0) )
+					return false;
 			
 				//For the map-to-annual case, run a simulation here
 				if(_SF->getVarMap()->sf.des_sim_detail.mapval() == var_solarfield::DES_SIM_DETAIL::EFFICIENCY_MAP__ANNUAL)	
@@ -2450,6 +2373,103 @@ bool AutoPilot_MT::CreateLayout(sp_layout &layout, bool do_post_process)
 	return true;
 }
 
+bool AutoPilot_MT::SimulateThreaded(sim_results &results, int nsim, WeatherData *wdata, matrix_t<double> *sunpos, sim_params &P, 
+	bool is_shadow_detail, bool is_flux_detail, bool is_normalized, simulation_info *siminfo)
+{
+	/* 
+	Run simulations 0..nsim-1 on up to _n_threads threads, storing each in 'results'. Sun positions come 
+	from the weather steps in 'wdata' or, if wdata is null, from the az/zen rows of 'sunpos'.
+
+	The simulations are handed out one at a time from a shared queue, and progress is reported to 
+	'siminfo' (if provided) as each one finishes. Returns false if the run was cancelled or a thread 
+	reported an error.
+	*/
+
+	int nthreads = min(nsim, _n_threads);
+	if(nthreads < 1)
+		return true;
+
+	//Each thread needs its own copy of the field since the heliostat objects hold per-sun-position state
+	SolarField **SFarr;
+	SFarr = new SolarField*[nthreads];
+	for(int i=0; i<nthreads; i++){
+		SFarr[i] = new SolarField(*_SF);
+		SFarr[i]->setSimulationThreadCount(1);	//threads are already running one field copy each
+	}
+
+	LayoutSimQueue queue;
+	queue.Setup(0, nsim, nthreads);
+
+	//Create thread objects
+	_simthread = new LayoutSimThread[nthreads];
+	_n_threads_active = nthreads;	//Keep track of how many threads are active
+	_in_mt_simulation = true;
+
+	for(int i=0; i<nthreads; i++){
+        std::string istr = my_to_string(i+1);
+		if(wdata != 0)
+			_simthread[i].Setup(istr, SFarr[i], &results, wdata, 0, nsim, is_shadow_detail, is_flux_detail);
+		else
+			_simthread[i].Setup(istr, SFarr[i], &results, sunpos, P, 0, nsim, is_shadow_detail, is_flux_detail);
+		_simthread[i].IsFluxmapNormalized(is_normalized);
+		_simthread[i].SetQueue(&queue);
+	}
+
+	//Run
+	vector<thread> threads;
+	for(int i=0; i<nthreads; i++)
+		threads.push_back( thread( &LayoutSimThread::StartThread, std::ref( _simthread[i] ) ) );
+
+	//Report progress each time a simulation finishes
+	int nsim_done = 0;
+	while( queue.WaitForProgress(nsim_done) ){
+		_sim_complete = nsim_done;
+		if(siminfo != 0){
+			if( ! siminfo->setCurrentSimulation(nsim_done) )
+				CancelSimulation();
+		}
+	}
+	for(int i=0; i<nthreads; i++)
+		threads.at(i).join();
+
+	//Check to see whether the simulation was cancelled
+	bool cancelled = false;
+	for(int i=0; i<nthreads; i++){
+		cancelled = cancelled || _simthread[i].IsSimulationCancelled();
+	}
+    
+    //check to see whether simulation errored out
+    bool errored_out = false;
+    for(int i=0; i<nthreads; i++){
+        errored_out = errored_out || _simthread[i].IsFinishedWithErrors();
+    }
+    if( errored_out )
+    {
+        CancelSimulation();
+        //Get the error messages, if any
+        string errmsgs;
+        for(int i=0; i<nthreads; i++){
+            for(int j=0; j<(int)_simthread[i].GetSimMessages()->size(); j++)
+                errmsgs.append( _simthread[i].GetSimMessages()->at(j) + "\n");
+        }
+        //Display error messages
+        if(! errmsgs.empty() && _has_summary_callback)
+            _summary_siminfo->addSimulationNotice( errmsgs.c_str() );
+            
+    }
+
+	//Clean up dynamic memory
+	_in_mt_simulation = false;
+	for(int i=0; i<nthreads; i++){
+		delete SFarr[i];
+	}
+	delete [] SFarr;
+	delete [] _simthread;
+	_simthread = 0;
+
+	return !(cancelled || errored_out);
+}
+
 bool AutoPilot_MT::SetMaxThreadCount(int nt)
 {
 	//check to make sure the max number of threads is less
@@ -2524,98 +2544,12 @@ bool AutoPilot_MT::CalculateOpticalEfficiencyTable(sp_optical_table &opttab)
 
 	//------------do the multithreaded run----------------
 	
-	//Create copies of the solar field
-	SolarField **SFarr;
-	SFarr = new SolarField*[_n_threads];
-	for(int i=0; i<_n_threads; i++){
-		SFarr[i] = new SolarField(*_SF);
-	}
-
 	//Create sufficient results arrays in memory
 	sim_results results;
 	results.resize(_sim_total);
-						
-	//Calculate the number of simulations per thread
-	int npert = (int)ceil((float)_sim_total/(float)_n_threads);
 
-	//Create thread objects
-	_simthread = new LayoutSimThread[_n_threads];
-	_n_threads_active = _n_threads;	//Keep track of how many threads are active
-				
-	int
-		sim_first = 0,
-		sim_last = npert;
-	for(int i=0; i<_n_threads; i++){
-        std::string istr = my_to_string(i);
-		_simthread[i].Setup(istr, SFarr[i], &results, &sunpos, P, sim_first, sim_last, true, false);
-		sim_first = sim_last;
-		sim_last = min(sim_last+npert, _sim_total);
-	}
-	//Run
-	for(int i=0; i<_n_threads; i++)
-		thread( &LayoutSimThread::StartThread, std::ref( _simthread[i] ) ).detach();
-			
-
-	//Wait loop
-	while(true){
-		int nsim_done = 0, nsim_remain=0, nthread_done=0;
-		for(int i=0; i<_n_threads; i++){
-			if( _simthread[i].IsFinished() )
-				nthread_done ++;
-					
-			int ns, nr;
-			_simthread[i].GetStatus(&ns, &nr);
-			nsim_done += ns;
-			nsim_remain += nr;
-					
-					
-		}
-		if(_has_summary_callback){
-			if( ! _summary_siminfo->setCurrentSimulation(nsim_done) )
-				CancelSimulation();
-		}
-		if(nthread_done == _n_threads) break;
-		std::this_thread::sleep_for(std::chrono::milliseconds(75));
-	}
-
-	//Check to see whether the simulation was cancelled
-	bool cancelled = false;
-	for(int i=0; i<_n_threads; i++){
-		cancelled = cancelled || _simthread[i].IsSimulationCancelled();
-	}
-    
-    //check to see whether simulation errored out
-    bool errored_out = false;
-    for(int i=0; i<_n_threads; i++){
-        errored_out = errored_out || _simthread[i].IsFinishedWithErrors();
-    }
-    if( errored_out )
-    {
-        CancelSimulation();
-        //Get the error messages, if any
-        string errmsgs;
-        for(int i=0; i<_n_threads; i++){
-            for(int j=0; j<(int)_simthread[i].GetSimMessages()->size(); j++)
-                errmsgs.append( _simthread[i].GetSimMessages()->at(j) + "\n");
-        }
-        //Display error messages
-        if(! errmsgs.empty() && _has_summary_callback)
-            _summary_siminfo->addSimulationNotice( errmsgs.c_str() );
-            
-    }
-
-	//Clean up dynamic memory
-	for(int i=0; i<_n_threads; i++){
-		delete SFarr[i];
-	}
-	delete [] SFarr;
-	delete [] _simthread;
-	_simthread = 0;
-
-	//If the simulation was cancelled per the check above, exit out
-	if(cancelled || errored_out){
+	if(! SimulateThreaded(results, _sim_total, 0, &sunpos, P, true, false, true, _has_summary_callback ? _summary_siminfo : 0) )
 		return false;
-	}
 
 	//collect all of the results and process into the efficiency table data structure
 	opttab.eff_data.clear();
@@ -2694,98 +2628,12 @@ bool AutoPilot_MT::CalculateFluxMaps(sp_flux_table &fluxtab, int flux_res_x, int
 
 	//------------do the multithreaded run----------------
 	
-	//Create copies of the solar field
-	SolarField **SFarr;
-	SFarr = new SolarField*[_n_threads];
-	for(int i=0; i<_n_threads; i++){
-		SFarr[i] = new SolarField(*_SF);
-	}
-
 	//Create sufficient results arrays in memory
 	sim_results results;
 	results.resize(_sim_total);
 
-	//Calculate the number of simulations per thread
-	int npert = (int)ceil((float)_sim_total/(float)_n_threads);
-
-	//Create thread objects
-	_simthread = new LayoutSimThread[_n_threads];
-	_n_threads_active = _n_threads;	//Keep track of how many threads are active
-	
-	int
-		sim_first = 0,
-		sim_last = npert;
-	for(int i=0; i<_n_threads; i++){
-        std::string istr = my_to_string(i);
-        _simthread[i].Setup(istr, SFarr[i], &results, &sunpos, P, sim_first, sim_last, true, true);
-		_simthread[i].IsFluxmapNormalized(is_normalized);
-		sim_first = sim_last;
-		sim_last = min(sim_last+npert, _sim_total);
-	}
-	//Run
-	for(int i=0; i<_n_threads; i++)
-		thread( &LayoutSimThread::StartThread, std::ref( _simthread[i] ) ).detach();
-			
-
-	//Wait loop
-	while(true){
-		int nsim_done = 0, nsim_remain=0, nthread_done=0;
-		for(int i=0; i<_n_threads; i++){
-			if( _simthread[i].IsFinished() )
-				nthread_done ++;
-					
-			int ns, nr;
-			_simthread[i].GetStatus(&ns, &nr);
-			nsim_done += ns;
-			nsim_remain += nr;
-					
-					
-		}
-		if(_has_summary_callback){
-			if( ! _summary_siminfo->setCurrentSimulation(nsim_done) ) 
-				CancelSimulation();
-		}
-		if(nthread_done == _n_threads) break;
-		std::this_thread::sleep_for(std::chrono::milliseconds(75));
-	}
-
-	//Check to see whether the simulation was cancelled
-	bool cancelled = false;
-	for(int i=0; i<_n_threads; i++){
-		cancelled = cancelled || _simthread[i].IsSimulationCancelled();
-	}
-	//check to see whether simulation errored out
-    bool errored_out = false;
-    for(int i=0; i<_n_threads; i++){
-        errored_out = errored_out || _simthread[i].IsFinishedWithErrors();
-    }
-    if( errored_out )
-    {
-        CancelSimulation();
-        //Get the error messages, if any
-        string errmsgs;
-        for(int i=0; i<_n_threads; i++){
-            for(int j=0; j<(int)_simthread[i].GetSimMessages()->size(); j++)
-                errmsgs.append( _simthread[i].GetSimMessages()->at(j) + "\n");
-        }
-        //Display error messages
-        if(! errmsgs.empty() && _has_summary_callback)
-            _summary_siminfo->addSimulationNotice( errmsgs.c_str() );
-            
-    }
-
-	//Clean up dynamic memory
-	for(int i=0; i<_n_threads; i++){
-		delete SFarr[i];
-	}
-	delete [] SFarr;
-	delete [] _simthread;
-	_simthread = 0;
-
-	//If the simulation was cancelled per the check above, exit out
-	if(cancelled || errored_out){
+	if(! SimulateThreaded(results, _sim_total, 0, &sunpos, P, true, true, is_normalized, _has_summary_callback ? _summary_siminfo : 0) )
 		return false;
-	}
 
 	for(int i=0; i<_sim_total; i++){
 		PostProcessFlux(results.at(i), fluxtab, i);
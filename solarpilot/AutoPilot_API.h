@@ -64,6 +64,7 @@
 
 class simulation_info;
 class sim_result;
+struct sim_params;
 class SolarField;
 class LayoutSimThread;
 
@@ -165,11 +166,14 @@ public:
 
 class SPEXPORT AutoPilot_MT : public AutoPilot
 {
+protected:
 	int _n_threads;	//the maximum number of threads to simulate
 	int _n_threads_active;	//the number of threads currently used for simulation
 	LayoutSimThread *_simthread;
 	bool _in_mt_simulation;
 	void CancelMTSimulation();
+	bool SimulateThreaded(std::vector<sim_result> &results, int nsim, WeatherData *wdata, matrix_t<double> *sunpos, sim_params &P, 
+		bool is_shadow_detail, bool is_flux_detail, bool is_normalized, simulation_info *siminfo);
 
 public:
 	//constructor
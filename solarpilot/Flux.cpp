@@ -58,6 +58,8 @@
 //#include <vector>
 #include <iostream>
 #include <algorithm>
+#include <thread>
+#include <mutex>
 
 #include <iostream>
 #include <fstream>
@@ -131,6 +133,8 @@ Flux::Flux(){
 	_random = new Random();
 	_jmin = 0;
 	_jmax = 0;
+	_contrib_cache = 0;
+	_n_contrib_reused = 0;
 }; 
 
 Flux::~Flux(){ 
@@ -152,7 +156,9 @@ Flux::Flux(Flux &f) :
 	_n_order(f._n_order),
 	_n_terms(f._n_terms),
 	pi(f.pi),
-	Pi(f.Pi)
+	Pi(f.Pi),
+	_contrib_cache(f._contrib_cache),
+	_n_contrib_reused(0)
 {
 	//Create a new random object
 	//if(_random != (Random*)NULL) delete _random;
@@ -2163,7 +2169,7 @@ void Flux::hermiteIntegral(double G[5], double F[5], double X[2], double A[2], d
 #endif
 }
 
-void Flux::fluxDensity(simulation_info *siminfo, FluxSurface &flux_surface, Hvector &helios, bool clear_grid, bool norm_grid, bool show_progress){
+void Flux::fluxDensity(simulation_info *siminfo, FluxSurface &flux_surface, Hvector &helios, bool clear_grid, bool norm_grid, bool show_progress, int n_threads){
 	/* 
 	Take a set of points defining the flux plane within the flux_surface object, a solar field geometry, 
 	and calculate the flux intensity at each point. Fills and returns these values into the FluxSurface
@@ -2204,6 +2210,18 @@ void Flux::fluxDensity(simulation_info *siminfo, FluxSurface &flux_surface, Hvec
 
 	Here, (x,y) is normalized by the standard deviation of the image error in x and y respectively.
 
+	---------------
+
+	Each heliostat is evaluated over all flux points at once by hermiteFluxGrid(). The heliostats are 
+	divided into fixed blocks that accumulate into separate grids, and the block grids are summed in order.
+	The blocks are evaluated on 'n_threads' threads (0 = all available cores), and the result does not 
+	depend on the number of threads.
+
+	If a contribution cache is set (see setContributionCache()), the flux of a heliostat whose image and 
+	Hermite coefficients exactly match a stored contribution on the same flux points is taken from the cache. 
+	Every heliostat's flux is evaluated separately and then added to the block grid, so the result is the 
+	same whether or not the contributions were stored.
+
 	*/
 	
 	//get the flux grid
@@ -2221,89 +2239,187 @@ void Flux::fluxDensity(simulation_info *siminfo, FluxSurface &flux_surface, Hvec
 	//Get the flux surface offset
 	sp_point *offset = flux_surface.getSurfaceOffset();
 	
-	int nh = (int)helios.size();
-	if(show_progress){
-		siminfo->setTotalSimulationCount(nh);
+	//Flux point locations (without the receiver optical height) and normals, indexed by row*nfy + col
+	int np = nfx*nfy;
+	flux_grid_points pts;
+	pts.np = np;
+	pts.x.resize(np); pts.y.resize(np); pts.z.resize(np);
+	pts.nx.resize(np); pts.ny.resize(np); pts.nz.resize(np);
+	for(int j=0; j<nfx; j++){
+		for(int k=0; k<nfy; k++){
+			FluxPoint *pt = &grid->at(j).at(k);
+			int p = j*nfy + k;
+			pts.x[p] = pt->location.x + offset->x;
+			pts.y[p] = pt->location.y + offset->y;
+			pts.z[p] = pt->location.z;
+			pts.nx[p] = pt->normal.i;
+			pts.ny[p] = pt->normal.j;
+			pts.nz[p] = pt->normal.k;
+		}
 	}
-	//Loop through each heliostat
-	int update_every = max(nh/20,1);
 
-	for(int i=0; i<nh; i++){
-		if(show_progress && i % update_every == 0)
-			siminfo->setCurrentSimulation(i+1);
-		
-        if(! helios.at(i)->IsEnabled() )
+	//Pack the image geometry and Hermite coefficients of the enabled heliostats
+	int npak = 0;
+	for(int i=1; i<_n_terms+1; i++)
+		npak += (JMX(i-1) - JMN(i-1))/2 + 1;
+
+	vector<flux_helio_image> images;
+	vector<double> coefs;
+	images.reserve(helios.size());
+	coefs.reserve(helios.size()*npak);
+	for(int i=0; i<(int)helios.size(); i++){
+		Heliostat *H = helios.at(i);
+        if(! H->IsEnabled() )
             continue;
 
+		flux_helio_image img;
+		
 		//Get the image error std dev's
-		double sigx, sigy;	
-		helios.at(i)->getImageSize(sigx, sigy);	//Image size is normalized by the tower height
+		H->getImageSize(img.sigx, img.sigy);	//Image size is normalized by the tower height
 		
 		//Get the heliostat aim point
-		sp_point *aim = helios.at(i)->getAimPoint();
+		sp_point *aim = H->getAimPoint();
+		img.aim[0] = aim->x; 
+		img.aim[1] = aim->y; 
+		img.aim[2] = aim->z;
 		//Get the height of the receiver that the heliostat is aiming at
-		double tht = helios.at(i)->getWhichReceiver()->getVarMap()->optical_height.Val();
+		img.tht = H->getWhichReceiver()->getVarMap()->optical_height.Val();
 
 		//Calculate the normalizing constant. This is equal to the normalized power delivered by the heliostat to the
 		//reciever divided by the tower height squared. (the tht^2 term falls out of the normalizing procedure
 		//that we previously used in defining the Hermite moments). See DELSOL 7634.
-		double cnorm = helios.at(i)->getArea() * helios.at(i)->getEfficiencyTotal()/(tht*tht);
-		//Loop through each flux point
-		//Rows
-		for(int j=0; j<nfx; j++){
-			//Cols
-			for(int k=0; k<nfy; k++){
-				//Get the flux point
-				FluxPoint *pt = &grid->at(j).at(k);
-				//Calculate the dot product between the flux point normal and the helio->tower vector
-				Vect *tv = helios.at(i)->getTowerVector();
-				Vect tvr;
-				tvr.Set( -tv->i, -tv->j, -tv->k );	//Reverse
-
-				double f_dot_t = Toolbox::dotprod(pt->normal, tvr);	
-				//If the dot product is negative, the point is not in view of the heliostat, so continue.
-				if(f_dot_t < 0.) continue;
-				if(f_dot_t>1.){
-					continue;
-				}
-				//Translate the flux point location into global coordinates
-				sp_point pt_g;
-				pt_g.Set(pt->location.x + offset->x, pt->location.y + offset->y, pt->location.z + tht); //tht include z offset
-
-				//Project the current flux point into the image plane as defined by the 
-				//aim point and the heliostat-to-receiver vector.
-				sp_point pt_ip;
-				Toolbox::plane_intersect(*aim, tvr, pt_g, tvr, pt_ip); 
-				
-				//Now the point pt_ip indicates in global coordinates the projection of the flux point onto the image plane.
-				
-				//Translate the flux point into coordinates relative to the aim point
-				pt_ip.Subtract( *aim );
-				
-				//Express this point in image plane coordinates
-                double azpt = atan2(tvr.i, tvr.j);
-                double zenpt = acos(tvr.k);
+		img.cnorm = H->getArea() * H->getEfficiencyTotal()/(img.tht*img.tht);
 
-				Toolbox::rotation(pi-azpt, 2, pt_ip);
-				Toolbox::rotation(zenpt, 0, pt_ip);
+		//Reversed helio->tower vector
+		Vect *tv = H->getTowerVector();
+		img.tvr[0] = -tv->i; 
+		img.tvr[1] = -tv->j; 
+		img.tvr[2] = -tv->k;
+		
+		//Rotations that express a point in image plane coordinates
+		double azpt = atan2(img.tvr[0], img.tvr[1]);
+		double zenpt = acos(img.tvr[2]);
+		img.cos_az = cos(pi-azpt);
+		img.sin_az = sin(pi-azpt);
+		img.cos_zen = cos(zenpt);
+		img.sin_zen = sin(zenpt);
+
+		matrix_t<double> *hc = H->getHermiteCoefObject();
+		for(int k=0; k<npak; k++)
+			coefs.push_back( hc->at(k) );
+
+		images.push_back(img);
+	}
+	
+	//Evaluate the heliostats in blocks
+	const int block = 64;	//heliostats per block
+	int nimg = (int)images.size();
+	int nblock = max(1, (nimg + block - 1)/block);
+	
+	//The first block accumulates onto the existing grid values
+	vector<vector<double> > block_flux(nblock);
+	block_flux.front().resize(np);
+	for(int j=0; j<nfx; j++)
+		for(int k=0; k<nfy; k++)
+			block_flux.front()[j*nfy + k] = grid->at(j).at(k).flux;
 
-				//This rotation now expresses pt_ip in x,y coordinates of the image plane.
+	if(show_progress){
+		siminfo->setTotalSimulationCount(nimg);
+	}
+	std::thread::id caller = std::this_thread::get_id();
+	std::mutex progress_lock;
+	int nimg_done = 0;
+
+	flux_contribution_cache *C = _contrib_cache;
+	int isurf = -1;
+	unsigned int generation = 0;
+	if(C != 0){
+		std::lock_guard<std::mutex> lk(C->lock);
+		if(C->nvalues >= C->max_values || C->surfaces.size() > 100) 
+			C->clear();		//limit the memory held by the cache
+		isurf = C->findSurface(pts);
+		generation = C->generation;
+	}
 
-				//Normalize the x,y coordinates with respect to the image error size
-				double
-					xn = -pt_ip.x/tht / sigx,       //with delsol formulation, image is flipped in x direction. Not sure why.
-					yn = pt_ip.y/tht / sigy;
-				
-				//Calculate the flux
-                double hfe = hermiteFluxEval(helios.at(i), xn, yn) * exp( -0.5 *( xn*xn + yn*yn) );
-                //if( hfe != hfe )
-                //{
-                //    double xxxxx = 0.;
-                //}
-				pt->flux += f_dot_t * hfe * cnorm;
+	SolarField::RunParallelLoop(nblock, n_threads, [&](int b){
+		vector<double> &flux = block_flux[b];
+		flux.resize(np, 0.);
+
+		vector<double> work, contrib, image;
+		int nreused = 0;
+		int iend = min(nimg, (b+1)*block);
+		for(int i=b*block; i<iend; i++){
+			std::shared_ptr<const flux_contribution_cache::entry> e;
+			size_t key = 0;
+			if(C != 0){
+				flux_helio_image &img = images[i];
+				double vimg[] = {img.aim[0], img.aim[1], img.aim[2], img.tvr[0], img.tvr[1], img.tvr[2], 
+					img.cos_az, img.sin_az, img.cos_zen, img.sin_zen, img.sigx, img.sigy, img.tht, img.cnorm};
+				image.assign(vimg, vimg + 14);
+				image.insert(image.end(), coefs.begin() + i*npak, coefs.begin() + (i+1)*npak);
+				key = std::hash<int>()(isurf);
+				for(size_t k=0; k<image.size(); k++)
+					key ^= std::hash<double>()(image[k]) + 0x9e3779b9 + (key << 6) + (key >> 2);
+
+				std::lock_guard<std::mutex> lk(C->lock);
+				unordered_map<size_t, std::shared_ptr<const flux_contribution_cache::entry> >::iterator it = C->entries.find(key);
+				if(it != C->entries.end() && it->second->surface == isurf && it->second->image == image && C->generation == generation)
+					e = it->second;
+			}
+
+			if(e){
+				nreused++;
 			}
+			else{
+				contrib.assign(np, 0.);
+				hermiteFluxGrid(images[i], &coefs[i*npak], pts, contrib, work);
+				if(C != 0){
+					std::shared_ptr<flux_contribution_cache::entry> enew = std::make_shared<flux_contribution_cache::entry>();
+					enew->surface = isurf;
+					enew->image = image;
+					enew->flux = contrib;
+					e = enew;
+					std::lock_guard<std::mutex> lk(C->lock);
+					if(C->generation == generation && C->nvalues < C->max_values){
+						C->entries[key] = e;
+						C->nvalues += np;
+					}
+				}
+			}
+
+			const double *c = e ? &e->flux[0] : &contrib[0];
+			for(int p=0; p<np; p++)
+				flux[p] += c[p];
+		}
+
+		if(C != 0){
+			progress_lock.lock();
+			_n_contrib_reused += nreused;
+			progress_lock.unlock();
+		}
+
+		if(show_progress){
+			progress_lock.lock();
+			nimg_done += iend - b*block;
+			int ndone = nimg_done;
+			progress_lock.unlock();
+			//only the calling thread reports progress
+			if(std::this_thread::get_id() == caller)
+				siminfo->setCurrentSimulation(ndone);
+		}
+	}, 1);
+
+	//Sum the block grids
+	for(int j=0; j<nfx; j++){
+		for(int k=0; k<nfy; k++){
+			int p = j*nfy + k;
+			double f = block_flux.front()[p];
+			for(int b=1; b<nblock; b++)
+				f += block_flux[b][p];
+			grid->at(j).at(k).flux = f;
 		}
 	}
+
 	if(show_progress){
 		siminfo->Reset();
 		siminfo->setCurrentSimulation(0);
@@ -2327,6 +2443,146 @@ void Flux::fluxDensity(simulation_info *siminfo, FluxSurface &flux_surface, Hvec
 
 }
 
+void Flux::hermiteFluxGrid(flux_helio_image &img, const double *coefs, flux_grid_points &pts, vector<double> &flux, vector<double> &work)
+{
+	/*
+	Add the flux of one heliostat to all flux points. This is hermiteFluxEval() and the image plane 
+	projection in fluxDensity() evaluated as a batch: each step is a loop over the flux points so that 
+	the compiler can vectorize it. 
+
+	coefs	| Hermite coefficients of the heliostat image (see hermiteFluxEval)
+	flux	| Flux at each point, incremented by this heliostat
+	work	| Scratch space, resized as needed
+	*/
+	int np = pts.np;
+	int nh = _n_terms + 2;	//number of Hermite polynomial values per point
+	work.resize( (2*nh + 4)*np );
+	double 
+		*xn = &work[0],
+		*yn = xn + np,
+		*fdt = yn + np,
+		*fl = fdt + np,
+		*HX = fl + np,
+		*HY = HX + nh*np;
+
+	const double 
+		*px = &pts.x[0], *py = &pts.y[0], *pz = &pts.z[0],
+		*nx = &pts.nx[0], *ny = &pts.ny[0], *nz = &pts.nz[0];
+
+	double 
+		ti = img.tvr[0], tj = img.tvr[1], tk = img.tvr[2],
+		ax = img.aim[0], ay = img.aim[1], az = img.aim[2],
+		tht = img.tht,
+		c1 = img.cos_az, s1 = img.sin_az,
+		c2 = img.cos_zen, s2 = img.sin_zen,
+		sigx = img.sigx, sigy = img.sigy;
+	double LdN = ti*ti + tj*tj + tk*tk;
+
+	for(int p=0; p<np; p++){
+		//dot product between the flux point normal and the reversed helio->tower vector
+		fdt[p] = nx[p]*ti + ny[p]*tj + nz[p]*tk;
+
+		//Project the flux point onto the image plane as defined by the aim point and the heliostat-to-receiver vector,
+		//relative to the aim point
+		double 
+			gx = px[p], 
+			gy = py[p], 
+			gz = pz[p] + tht;	//tht include z offset
+		double PCdN = (ax - gx)*ti + (ay - gy)*tj + (az - gz)*tk;
+		double d = PCdN / LdN;
+		double 
+			ipx = gx + d*ti - ax,
+			ipy = gy + d*tj - ay,
+			ipz = gz + d*tk - az;
+
+		//Express this point in image plane coordinates
+		double 
+			rx = c1*ipx + s1*ipy,
+			ry = -s1*ipx + c1*ipy;
+		ry = c2*ry + s2*ipz;
+
+		//Normalize the x,y coordinates with respect to the image error size
+		xn[p] = -rx/tht / sigx;       //with delsol formulation, image is flipped in x direction.
+		yn[p] = ry/tht / sigy;
+	}
+
+	//Hermite polynomials at each point
+	for(int p=0; p<np; p++){
+		HX[p] = 1.;
+		HX[np + p] = 0.;
+		HY[p] = 1.;
+		HY[np + p] = 0.;
+		fl[p] = 0.;
+	}
+	double FX = -2.;
+	for(int i=1; i<_n_terms+1; i++){
+		FX ++;
+		double 
+			*hx0 = HX + (i-1)*np, *hx1 = HX + i*np, *hx2 = HX + (i+1)*np,
+			*hy0 = HY + (i-1)*np, *hy1 = HY + i*np, *hy2 = HY + (i+1)*np;
+		for(int p=0; p<np; p++){
+			hx2[p] = xn[p]*hx1[p] - FX*hx0[p];
+			hy2[p] = yn[p]*hy1[p] - FX*hy0[p];
+		}
+	}
+
+	//Hermite series
+	int ipak = 0;
+	for(int i=1; i<_n_terms+1; i++){
+		int
+			jmin = JMN(i-1),
+			jmax = JMX(i-1);
+		const double *hx = HX + (i+1)*np;
+		for(int j=jmin; j<jmax+1; j+=2){
+			double c = coefs[ipak];
+			const double *hy = HY + (j+1)*np;
+			for(int p=0; p<np; p++)
+				fl[p] += c*hx[p]*hy[p];
+			ipak++;
+		}
+	}
+
+	//Scale and accumulate at the points in view of the heliostat
+	double cnorm = img.cnorm;
+	double *f = &flux[0];
+	for(int p=0; p<np; p++){
+		//If the dot product is negative, the point is not in view of the heliostat
+		if(fdt[p] < 0. || fdt[p] > 1.) continue;
+		double hfe = (fl[p] < 0. ? 0. : fl[p]) * exp( -0.5 *( xn[p]*xn[p] + yn[p]*yn[p]) );
+		f[p] += fdt[p] * hfe * cnorm;
+	}
+}
+
+void Flux::setContributionCache(flux_contribution_cache *cache){ _contrib_cache = cache; }
+int Flux::getContributionsReused(){ return _n_contrib_reused; }
+void Flux::resetContributionsReused(){ _n_contrib_reused = 0; }
+
+flux_contribution_cache::flux_contribution_cache()
+{
+	generation = 0;
+	max_values = 50000000;	//roughly 400 MB
+	clear();
+}
+
+void flux_contribution_cache::clear()
+{
+	surfaces.clear();
+	entries.clear();
+	nvalues = 0;
+	generation++;
+}
+
+int flux_contribution_cache::findSurface(flux_grid_points &pts)
+{
+	for(int i=0; i<(int)surfaces.size(); i++){
+		flux_grid_points &s = surfaces[i];
+		if(s.np == pts.np && s.x == pts.x && s.y == pts.y && s.z == pts.z && s.nx == pts.nx && s.ny == pts.ny && s.nz == pts.nz)
+			return i;
+	}
+	surfaces.push_back(pts);
+	return (int)surfaces.size() - 1;
+}
+
 double Flux::hermiteFluxEval(Heliostat *H, double xs, double ys){
 	/* 
 	Evaluate the flux density at point (x,y) in the image plane for the give heliostat H
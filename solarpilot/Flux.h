@@ -55,6 +55,9 @@
 
 
 #include <random>
+#include <mutex>
+#include <memory>
+#include <unordered_map>
 #include "Toolbox.h"
 #include "definitions.h"
 
@@ -72,6 +75,59 @@ class Ambient;
 
 typedef std::vector<Heliostat*> Hvector;
 
+struct flux_grid_points
+{
+	/*
+	Flux point locations and normals of a flux surface, packed for Flux::hermiteFluxGrid()
+	*/
+	int np;		//Number of flux points
+	std::vector<double>
+		x, y, z,		//[m] location of each point including the surface offset, but not the receiver optical height
+		nx, ny, nz;		//[-] surface normal at each point
+};
+
+struct flux_helio_image
+{
+	/*
+	Image plane geometry of one heliostat used to evaluate its flux on a grid. See Flux::fluxDensity().
+	*/
+	double
+		aim[3],				//[m] aim point
+		tvr[3],				//[-] reversed heliostat-to-tower unit vector
+		cos_az, sin_az,		//[-] rotation about z into image plane coordinates
+		cos_zen, sin_zen,	//[-] rotation about x into image plane coordinates
+		sigx, sigy,			//[-] image size normalized by the tower height
+		tht,				//[m] receiver optical height
+		cnorm;				//[-] normalizing constant
+};
+
+struct flux_contribution_cache
+{
+	/*
+	Flux of individual heliostats at the points of a flux surface, stored by Flux::fluxDensity() so that 
+	heliostats whose image is unchanged are not evaluated again. A contribution is only reused if the flux 
+	points, the image geometry and the Hermite coefficients all match exactly. The cache may be shared by 
+	several Flux objects (see SolarField::setIncrementalSimulation()), so all access is guarded by 'lock'.
+	*/
+	struct entry
+	{
+		int surface;				//index of the flux points in 'surfaces'
+		std::vector<double> image;	//image geometry and Hermite coefficients
+		std::vector<double> flux;	//contribution at each flux point
+	};
+
+	std::mutex lock;
+	std::vector<flux_grid_points> surfaces;		//flux points of the surfaces evaluated so far
+	std::unordered_map<size_t, std::shared_ptr<const entry> > entries;	//contributions by hash of surface and image
+	unsigned int generation;	//incremented when the cache is cleared
+	size_t nvalues,		//number of stored flux values
+		max_values;		//stored values allowed before the cache is cleared
+
+	flux_contribution_cache();
+	void clear();
+	int findSurface(flux_grid_points &pts);	//index of the surface with identical points, added if needed. Call with 'lock' held.
+};
+
 class Random
 {
 	int rmax;
@@ -112,6 +168,9 @@ class Flux
 	double _ag[16];
 	double _xg[16];
 
+	flux_contribution_cache *_contrib_cache;	//stored heliostat flux contributions, not owned. Null if not used.
+	int _n_contrib_reused;	//contributions taken from the cache since the last reset
+
  public:
 
 
@@ -167,10 +226,18 @@ class Flux
 	void initHermiteCoefs(var_map &V);
 
 	//A method to calculate the flux density given a map of values and a solar field
-	void fluxDensity(simulation_info *siminfo, FluxSurface &flux_surface, Hvector &helios, bool clear_grid = true, bool norm_grid = true, bool show_progress=false);
+	void fluxDensity(simulation_info *siminfo, FluxSurface &flux_surface, Hvector &helios, bool clear_grid = true, bool norm_grid = true, bool show_progress=false, int n_threads=1);
 
 	double hermiteFluxEval(Heliostat *H, double xs, double ys);
 
+	//Add the flux of one heliostat to all points of a flux grid
+	void hermiteFluxGrid(flux_helio_image &img, const double *coefs, flux_grid_points &pts, std::vector<double> &flux, std::vector<double> &work);
+
+	//Reuse heliostat flux contributions stored in 'cache' (null to always evaluate)
+	void setContributionCache(flux_contribution_cache *cache);
+	int getContributionsReused();
+	void resetContributionsReused();
+
 	//-------------End DELSOL3 methods--------------------
 
 	void calcBestReceiverTarget(Heliostat *H, std::vector<Receiver*> *Recs, double tht, int &rec_index, Vect *rtoh=0);
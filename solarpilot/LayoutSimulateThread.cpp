@@ -53,6 +53,60 @@
 #ifdef SP_USE_THREADS
 
 using namespace std;
+
+LayoutSimQueue::LayoutSimQueue()
+{
+	Setup(0, 0, 0);
+}
+
+void LayoutSimQueue::Setup(int sim_first, int sim_last, int nthreads)
+{
+	_next = sim_first;
+	_last = sim_last;
+	_ncomplete = 0;
+	_nactive = nthreads;
+}
+
+int LayoutSimQueue::Next(int i_done)
+{
+	int i;
+	_lock.lock();
+	if(i_done > -1)
+		_ncomplete++;
+	i = _next < _last ? _next++ : -1;
+	_lock.unlock();
+
+	if(i_done > -1)
+		_changed.notify_all();
+	return i;
+}
+
+void LayoutSimQueue::Cancel()
+{
+	_lock.lock();
+	_next = _last;
+	_lock.unlock();
+}
+
+void LayoutSimQueue::ThreadDone()
+{
+	_lock.lock();
+	_nactive--;
+	_lock.unlock();
+	_changed.notify_all();
+}
+
+bool LayoutSimQueue::WaitForProgress(int &ncomplete)
+{
+	std::unique_lock<std::mutex> lk(_lock);
+	_changed.wait(lk, [&]{ return _ncomplete != ncomplete || _nactive < 1; });
+	
+	if(_ncomplete == ncomplete)
+		return false;	//all threads have returned
+	
+	ncomplete = _ncomplete;
+	return true;
+}
 	
 void LayoutSimThread::Setup(string &tname, SolarField *SF, sim_results *results, WeatherData *wdata, 
 	int sim_first, int sim_last, bool is_shadow_detail, bool is_flux_detail)
@@ -62,6 +116,7 @@ void LayoutSimThread::Setup(string &tname, SolarField *SF, sim_results *results,
 	*/
     _thread_id = tname;
 	_SF = SF;
+	_queue = 0;
 	_results = results;
 	_wdata = wdata;
 	_sol_azzen = 0;
@@ -99,6 +154,7 @@ void LayoutSimThread::Setup(string &tname, SolarField *SF, sim_results *results,
 	*/
     _thread_id = tname;
 	_SF = SF;
+	_queue = 0;
 	_results = results;
 	_wdata = 0;
 	_sol_azzen = sol_azzen;
@@ -120,6 +176,24 @@ void LayoutSimThread::IsFluxmapNormalized(bool is_normal)
 	_is_flux_normalized = is_normal;
 }
 
+void LayoutSimThread::SetQueue(LayoutSimQueue *queue)
+{
+	_queue = queue;
+}
+
+int LayoutSimThread::NextSimulation(int i_done)
+{
+	/* 
+	Return the index of the next simulation to run, or -1 if there are none left. 'i_done' is the index 
+	of the simulation that just finished (-1 on the first call).
+	*/
+	if(_queue != 0)
+		return _queue->Next(i_done);
+
+	int i = i_done < 0 ? _sim_first : i_done + 1;
+	return i < _sim_last ? i : -1;
+}
+
 void LayoutSimThread::CancelSimulation()
 {
 	CancelLock.lock();
@@ -176,6 +250,15 @@ vector<string> *LayoutSimThread::GetSimMessages()
 }
 
 void LayoutSimThread::StartThread() //Entry()
+{
+	RunSimulations();
+
+	//let the owner know this thread has returned
+	if(_queue != 0)
+		_queue->ThreadDone();
+}
+
+void LayoutSimThread::RunSimulations()
 {
 	/* 
 	This method duplicates the functionality of SolarField::LayoutSimulate(...)
@@ -219,7 +302,9 @@ void LayoutSimThread::StartThread() //Entry()
 	    if(_sim_last < 0) _sim_last = _wdata->size();
 
 	    int nsim = _sim_last - _sim_first + 1;
-	    for(int i=_sim_first; i<_sim_last; i++){
+	    int nsim_done = 0;
+	    int i = -1;
+	    while( (i = NextSimulation(i)) > -1 ){
 		    //_SF->getSimInfoObject()->setCurrentSimulation(i+1);
 		    //double args[5];
             sim_params P;
@@ -299,7 +384,7 @@ void LayoutSimThread::StartThread() //Entry()
 			    _results->at(i).process_flux(_SF, _is_flux_normalized);
 
 		    //Update progress
-		    UpdateStatus(i-_sim_first+1,nsim);
+		    UpdateStatus(++nsim_done,nsim);
 		    //Check for user cancel
 		    StatusLock.lock();
 		    is_cancel = this->CancelFlag; 
@@ -331,6 +416,9 @@ void LayoutSimThread::StartThread() //Entry()
         FinishedWithErrors = true;
         FinErrLock.unlock();
 
+        if(_queue != 0)
+            _queue->Cancel();   //the other threads finish their current simulation and return
+
         _sim_messages.push_back( "Thread " + this->_thread_id + ": " +  e.what() );
     }
     catch(...)
@@ -348,6 +436,9 @@ void LayoutSimThread::StartThread() //Entry()
         FinishedWithErrors = true;
         FinErrLock.unlock();        
         
+        if(_queue != 0)
+            _queue->Cancel();
+
         _sim_messages.push_back( "Thread " + this->_thread_id + ": " +  "Caught unspecified error in a simulation thread. Simulation was not successful." );
     }
 
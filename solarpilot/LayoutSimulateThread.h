@@ -56,6 +56,7 @@
 #ifdef SP_USE_THREADS
 #include <thread>
 #include <mutex>
+#include <condition_variable>
 
 
 class Heliostat;	//Forward declaration
@@ -64,6 +65,32 @@ class WeatherData;
 typedef std::vector<Heliostat*> Hvector;	//Needs declaring here
 
 
+class LayoutSimQueue
+{
+	/* 
+	Shared list of simulation indices for a group of LayoutSimThread objects. Each thread takes the next 
+	unclaimed index as soon as it finishes a simulation, so threads that run faster take on more of the 
+	work. The owner blocks in WaitForProgress() and is woken each time a simulation finishes or the last 
+	thread returns.
+	*/
+	std::mutex _lock;
+	std::condition_variable _changed;
+	int 
+		_next,			//next index to hand out
+		_last,			//one past the last index
+		_ncomplete,		//number of simulations finished
+		_nactive;		//number of threads still running
+
+public:
+	LayoutSimQueue();
+
+	void Setup(int sim_first, int sim_last, int nthreads);
+	int Next(int i_done);	//Mark 'i_done' complete (if >= 0) and return the next index, or -1 if none remain
+	void Cancel();			//Stop handing out new indices
+	void ThreadDone();		//Called once by each thread before returning
+	bool WaitForProgress(int &ncomplete);	//Block until the completed count differs from 'ncomplete'. Returns false once all threads have returned and the count is current
+};
+
 class LayoutSimThread 
 {
 	bool _is_user_sun_pos;		//Has the user specified sun positions? (opposed to day/time combos)
@@ -80,6 +107,7 @@ class LayoutSimThread
     std::string _thread_id;
 
 	SolarField *_SF;
+	LayoutSimQueue *_queue;		//Optional shared queue of simulation indices
 	int _sim_first, _sim_last, _sort_metric;
 	WeatherData *_wdata;
 	sim_results *_results;
@@ -104,6 +132,8 @@ public:
 
 	void IsFluxmapNormalized(bool is_normal);	//set whether the fluxmap should be normalized (default TRUE)
 
+	void SetQueue(LayoutSimQueue *queue);	//take simulation indices from a shared queue instead of the fixed [sim_first, sim_last) range
+
 	void CancelSimulation();
 
 	bool IsSimulationCancelled();
@@ -120,6 +150,10 @@ public:
 
 	void StartThread();
 
+private:
+	void RunSimulations();
+	int NextSimulation(int i_done);
+
 };
 
 
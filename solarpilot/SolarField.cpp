@@ -50,6 +50,9 @@
 #include <assert.h>
 #include <algorithm>
 #include <math.h>
+#include <thread>
+#include <mutex>
+#include <exception>
 
 #include "exceptions.hpp"
 #include "SolarField.h"
@@ -79,6 +82,170 @@ sim_params::sim_params()
     is_layout = false;
 }
 
+//Packed heliostat arrays
+helio_arrays::helio_arrays()
+{
+    clear();
+}
+
+void helio_arrays::clear()
+{
+    is_packed = false;
+    n = 0;
+    x.clear(); y.clear(); z.clear();
+    ti.clear(); tj.clear(); tk.clear();
+    wi.clear(); wj.clear(); wk.clear();
+    sin_zen.clear();
+    cos_az.clear(); sin_az.clear();
+    cos_zen.clear(); sin_zen_n.clear();
+    height.clear(); width.clear();
+    cx.clear(); cy.clear(); cz.clear();
+    eta_cos.clear(); eta_shadow.clear(); eta_block.clear();
+    is_enabled.clear(); is_rect.clear(); poly_ign.clear();
+    group.clear(); nb_start.clear(); nb_index.clear();
+    ncol = 0;
+    r_corner = 0.;
+}
+
+//Heliostat position k-d tree
+void helio_kdtree::clear()
+{
+    _index.clear();
+    _x.clear();
+    _y.clear();
+}
+
+void helio_kdtree::Build(const vector<double> &x, const vector<double> &y)
+{
+    _x = x;
+    _y = y;
+    int n = (int)_x.size();
+    _index.resize(n);
+    for(int i=0; i<n; i++)
+        _index[i] = i;
+    build(0, n, true);
+}
+
+void helio_kdtree::build(int lo, int hi, bool split_x)
+{
+    if(hi - lo < 2) return;
+
+    int mid = (lo + hi)/2;
+    const vector<double> &c = split_x ? _x : _y;
+    std::nth_element(_index.begin() + lo, _index.begin() + mid, _index.begin() + hi, 
+        [&c](int a, int b){ return c[a] < c[b]; });
+    
+    build(lo, mid, !split_x);
+    build(mid+1, hi, !split_x);
+}
+
+void helio_kdtree::QueryBox(double xmin, double xmax, double ymin, double ymax, vector<int> &result) const
+{
+    query(0, (int)_index.size(), true, xmin, xmax, ymin, ymax, result);
+}
+
+void helio_kdtree::query(int lo, int hi, bool split_x, double xmin, double xmax, double ymin, double ymax, vector<int> &result) const
+{
+    if(lo >= hi) return;
+
+    int mid = (lo + hi)/2;
+    int i = _index[mid];
+    double px = _x[i], py = _y[i];
+    if(px >= xmin && px <= xmax && py >= ymin && py <= ymax)
+        result.push_back(i);
+    
+    //descend into each side of the split that overlaps the box
+    double c = split_x ? px : py;
+    if( (split_x ? xmin : ymin) <= c )
+        query(lo, mid, !split_x, xmin, xmax, ymin, ymax, result);
+    if( (split_x ? xmax : ymax) >= c )
+        query(mid+1, hi, !split_x, xmin, xmax, ymin, ymax, result);
+}
+
+//Shadowing and blocking candidates
+helio_candidates::helio_candidates()
+{
+    clear();
+}
+
+void helio_candidates::clear()
+{
+    is_valid = false;
+    tree.clear();
+    x.clear(); y.clear(); z.clear(); height.clear();
+    r_corner = 0.;
+    interaction_limit = 0.;
+    z_max = 0.;
+    h_max = 0.;
+    shadow.clear();
+    shadow_current = 0;
+    block.clear(); block_d0.clear(); block_ok.clear();
+}
+
+//Cached simulation results
+helio_sim_record::helio_sim_record()
+{
+    is_set = in_use = is_ok = false;
+    eta_int = eta_shadow = eta_block = 0.;
+    sigx = sigy = 0.;
+}
+
+sim_result_store::sim_result_store()
+{
+    nrecord = nactive = 0;
+    max_records = 500000;	//roughly 250 MB with intercept data
+}
+
+sim_result_cache::sim_result_cache()
+{
+    is_enabled = false;
+    nint_reused = nsb_reused = 0;
+    store = std::make_shared<sim_result_store>();
+}
+
+static inline void hash_combine(size_t &seed, size_t v)
+{
+    seed ^= v + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+}
+
+static inline void hash_combine(size_t &seed, double v)
+{
+    hash_combine(seed, std::hash<double>()(v));
+}
+
+static inline void push_signature(vector<double> &inputs, size_t sig)
+{
+    //store a signature as two exactly representable values
+    unsigned long long v = (unsigned long long)sig;
+    inputs.push_back( (double)(v & 0xffffffffULL) );
+    inputs.push_back( (double)(v >> 32) );
+}
+
+static void StoreCachedIntercept(helio_sim_record *rec, Heliostat *H, double eta_int)
+{
+    /* 
+    Store the intercept and the image data used by the flux calculations 
+    */
+    rec->eta_int = eta_int;
+    H->getImageSize(rec->sigx, rec->sigy);
+    rec->hcoef = *H->getHermiteCoefObject();
+    rec->is_set = true;
+}
+
+static void LinkFluxCache(Flux *flux, sim_result_cache &C)
+{
+    //the flux object stores heliostat contributions in the same store as the heliostat results
+    if(flux != 0)
+        flux->setContributionCache(C.is_enabled ? &C.store->flux : 0);
+}
+
+static double RestoreCachedIntercept(helio_sim_record *rec, Heliostat *H)
+{
+    H->setImageSize(rec->sigx, rec->sigy);
+    *H->getHermiteCoefObject() = rec->hcoef;
+    return rec->eta_int;
+}
+
 //-------Access functions
 //"GETS"
 SolarField::clouds *SolarField::getCloudObject(){return &_clouds;}
@@ -102,6 +269,7 @@ double *SolarField::getHeliostatExtents(){return _helio_extents;}
 simulation_info *SolarField::getSimInfoObject(){return &_sim_info;}
 simulation_error *SolarField::getSimErrorObject(){return &_sim_error;}
 optical_hash_tree *SolarField::getOpticalHashTree(){return &_optical_mesh;}
+helio_arrays *SolarField::getHeliostatArrays(){return &_helio_arrays;}
 
 //-------"SETS"
 /*min/max field radius.. function sets the value in units of [m]. Can be used as follows:
@@ -116,6 +284,25 @@ void SolarField::setHeliostatExtents(double xmax, double xmin, double ymax, doub
 	_helio_extents[2] = ymax;
 	_helio_extents[3] = ymin;
 };
+void SolarField::setSimulationThreadCount(int nthreads){_n_sim_threads = nthreads < 0 ? 0 : nthreads;}
+int SolarField::getSimulationThreadCount(){return _n_sim_threads;}
+void SolarField::setIncrementalSimulation(bool enabled){
+	if(! enabled && _sim_cache.is_enabled) ClearSimulationCache();
+	_sim_cache.is_enabled = enabled;
+	LinkFluxCache(_flux, _sim_cache);
+}
+bool SolarField::getIncrementalSimulation(){return _sim_cache.is_enabled;}
+void SolarField::ClearSimulationCache(){
+	//Copies of the field may still use the shared store, so start a new one
+	ReleaseSimulationCache();
+	_sim_cache.store = std::make_shared<sim_result_store>();
+	LinkFluxCache(_flux, _sim_cache);
+}
+void SolarField::getSimulationCacheUse(int &n_intercept, int &n_shadow_block){
+	n_intercept = _sim_cache.nint_reused;
+	n_shadow_block = _sim_cache.nsb_reused;
+}
+int SolarField::getFluxCacheUse(){return _flux == 0 ? 0 : _flux->getContributionsReused();}
 	
 //Scripts
 bool SolarField::ErrCheck(){return _sim_error.checkForErrors();}
@@ -135,10 +322,12 @@ SolarField::SolarField(){
 	_flux = 0;
     _var_map = 0;
 	_is_created = false;	//The Create() method hasn't been called yet.
+	_n_sim_threads = 0;
 	_estimated_annual_power = 0.;
 };		
 
 SolarField::~SolarField(){ 
+	ReleaseSimulationCache();	//in case a simulation was interrupted
 	if(_flux != (Flux*)NULL) delete _flux; //If the flux object is allocated memory, delete
 	//Delete receivers
 	for(unsigned int i=0; i<_receivers.size(); i++){
@@ -156,6 +345,7 @@ SolarField::SolarField( const SolarField &sf )
 	_is_aimpoints_updated( sf._is_aimpoints_updated ),
 	_cancel_flag( sf._cancel_flag ),
 	_is_created( sf._is_created ),
+	_n_sim_threads( sf._n_sim_threads ),
 	_layout( sf._layout ),
 	_helio_objects( sf._helio_objects ),	//This contains the heliostat objects. The heliostat constructor will handle all internal pointer copy operations
 	_helio_template_objects( sf._helio_template_objects ),	//This contains the heliostat template objects.
@@ -278,6 +468,11 @@ SolarField::SolarField( const SolarField &sf )
 	//if(_flux != (Flux*)NULL ) delete _flux;
 	_flux = new Flux( *sf._flux );
 
+	//Share the stored simulation results
+	_sim_cache.is_enabled = sf._sim_cache.is_enabled;
+	if(_sim_cache.is_enabled) _sim_cache.store = sf._sim_cache.store;
+	LinkFluxCache(_flux, _sim_cache);
+
 }
 
 
@@ -306,6 +501,7 @@ void SolarField::Create(var_map &V){
 	if(_flux != 0 ){ delete _flux; }	//If the flux object already exists, delete and start over
 	_flux = new Flux();
 	_flux->Setup();
+	LinkFluxCache(_flux, _sim_cache);
 	
 	setAimpointStatus(false);	//the aimpoints have not yet been calculated
 	
@@ -462,6 +658,8 @@ void SolarField::Clean(){
 	_helio_by_id.clear();
 	_neighbors.clear();
 	_receivers.clear();
+	_helio_arrays.clear();
+	_helio_candidates.clear();
 	
 	_is_created = false;
 	_cancel_flag = false;	//initialize the flag for cancelling the simulation
@@ -529,6 +727,8 @@ bool SolarField::UpdateNeighborList(double lims[4], double zen){
 	3 : ymax
 	*/
 	
+	_helio_arrays.is_packed = false;	//neighbor lists are changing
+
 	double 
 		xmax = lims[0],
 		xmin = lims[1],
@@ -3030,6 +3230,8 @@ void SolarField::Simulate(double azimuth, double zenith, sim_params &P)
     //calculate sun vector
     Vect Sun = Ambient::calcSunVectorFromAzZen(azimuth, zenith);
 
+	_flux->resetContributionsReused();	//count the flux contributions reused by the aim point methods and later flux maps
+
 	for(int i=0; i<(int)_receivers.size(); i++)
     {
 	    //Update the estimated receiver thermal efficiency for each receiver
@@ -3060,6 +3262,9 @@ void SolarField::Simulate(double azimuth, double zenith, sim_params &P)
     
     //Update the heliostat neighbors to include possible shadowers
 	UpdateNeighborList(_helio_extents, P.is_layout ? 0. : zenith);		//don't include shadowing effects in layout (zenith = 0.)
+
+	//Find results from previous simulations that can be reused
+	PrepareSimulationCache(azimuth, zenith, P);
 	
     //For each heliostat, assess the losses
 	//for layout calculations, we can speed things up by only calculating the intercept factor for representative heliostats. (similar to DELSOL).
@@ -3068,17 +3273,25 @@ void SolarField::Simulate(double azimuth, double zenith, sim_params &P)
 		//The intercept factor is the most time consuming calculation. Simulate just a single heliostat in the 
 		//neighboring group and apply it to all the rest.
 		
-		for(int i=0; i<(int)_layout_groups.size(); i++){
+		RunHeliostatLoop((int)_layout_groups.size(), [&](int i){
 			
 			Hvector *hg = &_layout_groups.at(i);
 
 			int ngroup = (int)hg->size();
 
-			if(ngroup == 0) continue;
+			if(ngroup == 0) return;
 
 			Heliostat *helios = hg->front(); // just use the first one
-			double eta_int = _flux->imagePlaneIntercept(*_var_map, *helios, helios->getWhichReceiver(), &Sun);
-			if( eta_int > 1.) eta_int = 1.;
+			helio_sim_record *rec = _sim_cache.current_int.empty() ? 0 : _sim_cache.current_int.at( helios - &_helio_objects.front() );
+			double eta_int;
+			if(rec != 0 && rec->is_ok)
+				eta_int = RestoreCachedIntercept(rec, helios);
+			else
+			{
+				eta_int = _flux->imagePlaneIntercept(*_var_map, *helios, helios->getWhichReceiver(), &Sun);
+				if( eta_int > 1.) eta_int = 1.;
+				if(rec != 0) StoreCachedIntercept(rec, helios, eta_int);
+			}
 			helios->setEfficiencyIntercept( fmin(eta_int, 1.) );
 
 			for(int k=1; k<ngroup; k++){
@@ -3087,14 +3300,32 @@ void SolarField::Simulate(double azimuth, double zenith, sim_params &P)
 			}
 
 			
-		}
+		});
 	}
 	
-	//Simulate efficiency for all heliostats
-	for(int i=0; i<nh; i++)
+	//Copy the current geometry into the packed arrays used by the efficiency calculations
+	PackHeliostatArrays();
+	//Limit the shadowing and blocking calculations to neighbors that can interfere at this sun position
+	UpdateInteractionCandidates(Sun, !P.is_layout);
+	//Check whether the neighbors of heliostats with cached shadowing and blocking have changed
+	CheckCachedShadowBlock(!P.is_layout);
+
+	//Cosine loss for all positions
+	{
+		helio_arrays &A = _helio_arrays;
+		const double *ti = A.ti.data(), *tj = A.tj.data(), *tk = A.tk.data();
+		double *eta_cos = A.eta_cos.data();
+		for(int i=0; i<A.n; i++)
+			eta_cos[i] = Sun.i*ti[i] + Sun.j*tj[i] + Sun.k*tk[i];
+	}
+
+	//Simulate efficiency for all heliostats. Each heliostat only updates its own efficiency terms.
+	RunHeliostatLoop(nh, [&](int i){
 		SimulateHeliostatEfficiency(this, Sun, _heliostats.at(i), P); 
+	});
 	
-	
+	_helio_arrays.is_packed = false;
+	ReleaseSimulationCache();
 
 
 }
@@ -3120,8 +3351,21 @@ void SolarField::SimulateHeliostatEfficiency(SolarField *SF, Vect &Sun, Heliosta
         return;
     }
 
+	//Use the packed heliostat arrays when Simulate() has prepared them for this sun position
+	helio_arrays *A = &SF->_helio_arrays;
+	int h = -1;
+	if(A->is_packed && !SF->_helio_objects.empty())
+	{
+		h = (int)(helios - &SF->_helio_objects.front());
+		if(h < 0 || h >= A->n) h = -1;
+	}
+	//Cached results for this heliostat, if any
+	helio_sim_record 
+		*rec_int = (h < 0 || SF->_sim_cache.current_int.empty()) ? 0 : SF->_sim_cache.current_int[h],
+		*rec_sb = (h < 0 || SF->_sim_cache.current_sb.empty()) ? 0 : SF->_sim_cache.current_sb[h];
+
 	//Cosine loss
-	helios->setEfficiencyCosine( Toolbox::dotprod(Sun, *helios->getTrackVector()) );
+	helios->setEfficiencyCosine( h < 0 ? Toolbox::dotprod(Sun, *helios->getTrackVector()) : A->eta_cos[h] );
 	
     var_map *V = SF->getVarMap();
 
@@ -3134,10 +3378,17 @@ void SolarField::SimulateHeliostatEfficiency(SolarField *SF, Vect &Sun, Heliosta
 
 	//Intercept
 	if(! (P.is_layout && V->sf.is_opt_zoning.val) ){	//For layout simulations, the simulation method that calls this method handles image intercept
-		double eta_int = SF->getFluxObject()->imagePlaneIntercept(*V, *helios, Rec, &Sun);
-        if(eta_int != eta_int)
-            throw spexception("An error occurred when calculating heliostat intercept factor. Please contact support for help resolving this issue.");
-		if(eta_int>1.) eta_int = 1.;
+		double eta_int;
+		if(rec_int != 0 && rec_int->is_ok)
+			eta_int = RestoreCachedIntercept(rec_int, helios);
+		else
+		{
+			eta_int = SF->getFluxObject()->imagePlaneIntercept(*V, *helios, Rec, &Sun);
+			if(eta_int != eta_int)
+				throw spexception("An error occurred when calculating heliostat intercept factor. Please contact support for help resolving this issue.");
+			if(eta_int>1.) eta_int = 1.;
+			if(rec_int != 0) StoreCachedIntercept(rec_int, helios, eta_int);
+		}
 		helios->setEfficiencyIntercept(eta_int);
 	}
 
@@ -3147,14 +3398,52 @@ void SolarField::SimulateHeliostatEfficiency(SolarField *SF, Vect &Sun, Heliosta
 		block_tot = 1.;
 		
     double interaction_limit = V->sf.interaction_limit.val;
-	Hvector *neibs = helios->getNeighborList();
-	int nn = (int)neibs->size();
-	for(int j=0; j<nn; j++){
-		if(helios == neibs->at(j) ) continue;	//Don't calculate blocking or shading for the same heliostat
+	if(rec_sb != 0 && rec_sb->is_ok)
+	{
+		//the heliostat and its neighbors are unchanged since the values were stored
+		shad_tot = rec_sb->eta_shadow;
+		block_tot = rec_sb->eta_block;
+	}
+	else if(h < 0)
+	{
+		Hvector *neibs = helios->getNeighborList();
+		int nn = (int)neibs->size();
+		for(int j=0; j<nn; j++){
+			if(helios == neibs->at(j) ) continue;	//Don't calculate blocking or shading for the same heliostat
+		
+			if(!P.is_layout) shad_tot += -SF->calcShadowBlock(helios, neibs->at(j), 0, Sun, interaction_limit);	//Don't calculate shadowing for layout simulations. Cascaded shadowing effects can skew the layout.
+		
+			block_tot += -SF->calcShadowBlock(helios, neibs->at(j), 1, Sun, interaction_limit);
+		}
+	}
+	else if(SF->_helio_candidates.is_valid)
+	{
+		//same as above using only the candidate neighbors. Visit them in neighbor list order so the totals are unchanged.
+		std::vector<int> cands;
+		if(!P.is_layout)
+		{
+			SF->getInteractionCandidates(h, 0, cands);
+			for(int j=0; j<(int)cands.size(); j++)
+				shad_tot += -SF->calcShadowBlockPacked(h, cands[j], 0, Sun, interaction_limit);
+		}
+
+		SF->getInteractionCandidates(h, 1, cands);
+		for(int j=0; j<(int)cands.size(); j++)
+			block_tot += -SF->calcShadowBlockPacked(h, cands[j], 1, Sun, interaction_limit);
+	}
+	else
+	{
+		//same as above using the packed neighbor list
+		int g = A->group[h];
+		int jend = A->nb_start[g+1];
+		for(int j=A->nb_start[g]; j<jend; j++){
+			int hi = A->nb_index[j];
+			if(hi == h) continue;
 		
-        if(!P.is_layout) shad_tot += -SF->calcShadowBlock(helios, neibs->at(j), 0, Sun, interaction_limit);	//Don't calculate shadowing for layout simulations. Cascaded shadowing effects can skew the layout.
+			if(!P.is_layout) shad_tot += -SF->calcShadowBlockPacked(h, hi, 0, Sun, interaction_limit);
 		
-        block_tot += -SF->calcShadowBlock(helios, neibs->at(j), 1, Sun, interaction_limit);
+			block_tot += -SF->calcShadowBlockPacked(h, hi, 1, Sun, interaction_limit);
+		}
 	}
 		
 	if(shad_tot < 0.) shad_tot = 0.;
@@ -3164,6 +3453,19 @@ void SolarField::SimulateHeliostatEfficiency(SolarField *SF, Vect &Sun, Heliosta
 	if(block_tot < 0.) block_tot = 0.;
 	if(block_tot > 1.) block_tot = 1.;
 	helios->setEfficiencyBlocking(block_tot);
+
+	if(rec_sb != 0 && !rec_sb->is_ok)
+	{
+		rec_sb->eta_shadow = shad_tot;
+		rec_sb->eta_block = block_tot;
+		rec_sb->is_set = true;
+	}
+
+	if(h > -1)
+	{
+		A->eta_shadow[h] = shad_tot;
+		A->eta_block[h] = block_tot;
+	}
 	
 	//Soiling, reflectivity, and receiver absorptance factors are included in the total calculation
 	double eta_rec_abs = Rec->getVarMap()->absorptance.val; // * eta_rec_acc,
@@ -3385,6 +3687,709 @@ double SolarField::calcShadowBlock(Heliostat *H, Heliostat *HI, int mode, Vect &
 
 }
 
+void SolarField::PackHeliostatArrays()
+{
+	/*
+	Copy the tracking geometry and neighbor lists of all heliostat positions into the packed arrays. 
+	Call after the tracking vectors and neighbor lists have been updated for the current sun position.
+	*/
+	helio_arrays &A = _helio_arrays;
+	
+	int n = (int)_helio_objects.size();
+	A.is_packed = false;
+	A.n = n;
+	A.r_corner = 0.;
+	_helio_candidates.is_valid = false;
+
+	A.x.resize(n); A.y.resize(n); A.z.resize(n);
+	A.ti.resize(n); A.tj.resize(n); A.tk.resize(n);
+	A.wi.resize(n); A.wj.resize(n); A.wk.resize(n);
+	A.sin_zen.resize(n);
+	A.cos_az.resize(n); A.sin_az.resize(n);
+	A.cos_zen.resize(n); A.sin_zen_n.resize(n);
+	A.height.resize(n); A.width.resize(n);
+	A.cx.resize(4*n); A.cy.resize(4*n); A.cz.resize(4*n);
+	A.eta_cos.assign(n, 0.); A.eta_shadow.assign(n, 1.); A.eta_block.assign(n, 1.);
+	A.is_enabled.resize(n); A.is_rect.resize(n); A.poly_ign.resize(n);
+	A.group.resize(n);
+
+	if(n == 0) return;
+
+	int ncol = (int)_neighbors.ncols();
+	int ngroup = (int)(_neighbors.nrows() * _neighbors.ncols());
+	A.ncol = ncol;
+	
+	for(int i=0; i<n; i++)
+	{
+		Heliostat *H = &_helio_objects[i];
+		
+		sp_point *loc = H->getLocation();
+		A.x[i] = loc->x; A.y[i] = loc->y; A.z[i] = loc->z;
+		Vect *t = H->getTrackVector();
+		A.ti[i] = t->i; A.tj[i] = t->j; A.tk[i] = t->k;
+		Vect *w = H->getTowerVector();
+		A.wi[i] = w->i; A.wj[i] = w->j; A.wk[i] = w->k;
+		A.sin_zen[i] = sin(acos(t->k));
+		//rotation angles used to transform points into heliostat coordinates
+		A.cos_az[i] = cos(-H->getAzimuthTrack());
+		A.sin_az[i] = sin(-H->getAzimuthTrack());
+		A.cos_zen[i] = cos(-H->getZenithTrack());
+		A.sin_zen_n[i] = sin(-H->getZenithTrack());
+		A.height[i] = H->getVarMap()->height.val;
+		A.width[i] = H->getVarMap()->width.val;
+		A.is_enabled[i] = H->IsEnabled() ? 1 : 0;
+
+		vector<sp_point> *c = H->getCornerCoords();
+		A.is_rect[i] = c->size() == 4 ? 1 : 0;
+		A.poly_ign[i] = 1;
+		if(A.is_rect[i])
+		{
+			for(int k=0; k<4; k++)
+			{
+				A.cx[4*i+k] = c->at(k).x;
+				A.cy[4*i+k] = c->at(k).y;
+				A.cz[4*i+k] = c->at(k).z;
+				double 
+					dx = c->at(k).x - loc->x,
+					dy = c->at(k).y - loc->y,
+					dz = c->at(k).z - loc->z;
+				A.r_corner = fmax(A.r_corner, sqrt(dx*dx + dy*dy + dz*dz));
+			}
+			//dimension to ignore for the point-in-polygon test (see Toolbox::polywind)
+			Vect v1, v2;
+			v1.Set((c->at(0).x-c->at(1).x),(c->at(0).y - c->at(1).y),(c->at(0).z - c->at(1).z));
+			v2.Set((c->at(2).x-c->at(1).x),(c->at(2).y - c->at(1).y),(c->at(2).z - c->at(1).z));
+			Vect pn = Toolbox::crossprod( v1, v2 );
+			int which_ign = 1;
+			if(fabs(pn.j) > fabs(pn.i)) {which_ign=1;}
+			if(fabs(pn.k) > fabs(pn.j)) {which_ign=2;}
+			if(fabs(pn.i) > fabs(pn.k)) {which_ign=0;}
+			A.poly_ign[i] = (char)which_ign;
+		}
+
+		int *gid = H->getGroupId();
+		A.group[i] = gid[0]*ncol + gid[1];
+	}
+
+	//neighbor lists for each group, stored as heliostat indices
+	Heliostat *h0 = &_helio_objects.front();
+	A.nb_start.resize(ngroup+1);
+	A.nb_index.clear();
+	for(int g=0; g<ngroup; g++)
+	{
+		A.nb_start[g] = (int)A.nb_index.size();
+		Hvector *neibs = &_neighbors.at(g/ncol, g%ncol);
+		for(int j=0; j<(int)neibs->size(); j++)
+			A.nb_index.push_back( (int)(neibs->at(j) - h0) );
+	}
+	A.nb_start[ngroup] = (int)A.nb_index.size();
+
+	A.is_packed = true;
+}
+
+static bool packed_point_in_helio(const helio_arrays &A, int h, double px, double py, double pz)
+{
+	/* 
+	Winding number test of a point against the 4 corners of packed heliostat 'h'. Equivalent to 
+	Toolbox::pointInPolygon() on the heliostat corner coordinates.
+	*/
+	int ign = A.poly_ign[h];
+	const double *cx = &A.cx[4*h], *cy = &A.cy[4*h], *cz = &A.cz[4*h];
+	const double 
+		*c0 = ign == 0 ? cy : cx, 
+		*c1 = ign == 2 ? cy : cz;
+	double pt0 = ign == 0 ? py : px;
+	double pt1 = ign == 2 ? py : pz;
+
+	int wind = 0;
+	double p0 = c0[3], p1 = c1[3];
+	for(int i=0; i<4; i++)
+	{
+		double d0 = c0[i], d1 = c1[i];
+		if (p1 <= pt1) {
+			if (d1 > pt1 && (p0-pt0)*(d1-pt1)-(p1-pt1)*(d0-pt0) > 0) wind++;
+		}
+		else {
+			if (d1 <= pt1 && (p0-pt0)*(d1-pt1)-(p1-pt1)*(d0-pt0) < 0) wind--;
+		}
+		p0=d0;
+		p1=d1;
+	}
+	return wind == -1 || wind == 1;
+}
+
+double SolarField::calcShadowBlockPacked(int h, int hi, int mode, Vect &Sun, double interaction_limit)
+{
+	/*
+	Shadowing (mode = 0) or blocking (mode = 1) of packed heliostat 'h' by neighbor 'hi'. This is the 
+	same calculation as calcShadowBlock(), using the arrays prepared by PackHeliostatArrays().
+	*/
+	helio_arrays &A = _helio_arrays;
+
+	if(! (A.is_rect[h] && A.is_rect[hi]) )
+		return calcShadowBlock(&_helio_objects[h], &_helio_objects[hi], mode, Sun, interaction_limit);
+
+	//interference direction
+	double Ii, Ij, Ik;
+	if(mode == 0){
+		Ii = Sun.i; Ij = Sun.j; Ik = Sun.k;
+	}
+	else{
+		Ii = A.wi[h]; Ij = A.wj[h]; Ik = A.wk[h];
+	}
+	
+	//maximum possible interaction distance
+	double HIh = A.height[hi];
+	double tanpi2zen = Ik/sqrt(Ii*Ii + Ij*Ij);
+	double l_max = (A.z[hi] - A.z[h] + HIh*A.sin_zen[hi])/tanpi2zen + HIh*A.tk[hi];
+	l_max = fmin(l_max, interaction_limit*HIh);
+
+	//vector pointing from the heliostat to the interfering neighbor
+	double 
+		ni = A.x[hi] - A.x[h], 
+		nj = A.y[hi] - A.y[h], 
+		nk = A.z[hi] - A.z[h];
+	double hdist = sqrt(ni*ni + nj*nj + nk*nk);
+	if(hdist > l_max) return 0.;
+
+	double 
+		Hh = A.height[h],
+		Hw = A.width[h];
+	if( ni*Ii + nj*Ij + nk*Ik < 0.) return 0.;
+
+	//project the top corners of the interfering heliostat onto the plane of the heliostat
+	double Ni = A.ti[h], Nj = A.tj[h], Nk = A.tk[h];
+	double LdN = 0.;
+	LdN += Ii*Ni;
+	LdN += Ij*Nj;
+	LdN += Ik*Nk;
+
+	double ix[2], iy[2], iz[2];
+	bool hits[2] = {false, false};
+	for(int i=0; i<2; i++){
+		if(LdN == 0.) break;	//Line is parallel to the plane
+		double 
+			Cx = A.cx[4*hi+i],
+			Cy = A.cy[4*hi+i],
+			Cz = A.cz[4*hi+i];
+		double PCdN = 0.;
+		PCdN += (A.x[h] - Cx)*Ni;
+		PCdN += (A.y[h] - Cy)*Nj;
+		PCdN += (A.z[h] - Cz)*Nk;
+		double d = PCdN / LdN;
+		ix[i] = Cx + d*Ii;
+		iy[i] = Cy + d*Ij;
+		iz[i] = Cz + d*Ik;
+		hits[i] = packed_point_in_helio(A, h, ix[i], iy[i], iz[i]);
+	}
+	if(! (hits[0] || hits[1]) )
+		return 0.;
+
+	//transform the intersection points into heliostat coordinates
+	double tx[2], ty[2];
+	for(int i=0; i<2; i++){
+		double 
+			px = ix[i] - A.x[h],
+			py = iy[i] - A.y[h],
+			pz = iz[i] - A.z[h];
+		//azimuth rotation back to north
+		double rx = A.cos_az[h]*px + A.sin_az[h]*py;
+		double ry = -A.sin_az[h]*px + A.cos_az[h]*py;
+		//zenith rotation
+		tx[i] = rx;
+		ty[i] = A.cos_zen[h]*ry + A.sin_zen_n[h]*pz;
+	}
+
+	double dx_inter, dy_inter;
+	int which_is_off, which_is_on;
+	if(hits[0] && hits[1]) {
+		dy_inter = ( Hh - (ty[0] + ty[1]) ) / (2. * Hh);
+		dx_inter = fabs(tx[0] - tx[1] ) / Hw;
+		return dy_inter * dx_inter;
+	}
+	else if(hits[0]) { 
+		which_is_off = 1;
+		which_is_on = 0;
+	}
+	else {
+		which_is_off = 0;
+		which_is_on = 1;
+	}
+			
+	dy_inter = (Hh/2. - ty[which_is_on]) / Hh;
+	if( tx[which_is_off] > Hw/2. ){
+		dx_inter = .5 - tx[which_is_on] / Hw;
+	}
+	else {
+		dx_inter = tx[which_is_on] / Hw + .5;
+	}
+
+	return dy_inter * dx_inter;
+}
+
+void SolarField::UpdateInteractionCandidates(Vect &Sun, bool is_shadow)
+{
+	/*
+	Update the shadowing and blocking candidates of the packed heliostats (see helio_candidates). Call 
+	after PackHeliostatArrays(). The shadowing candidates are only updated if is_shadow is true.
+
+	Cached lists are kept while the field geometry is unchanged. The shadowing lists are binned by sun 
+	position in steps of about 1 degree. A blocking list is rebuilt when the heliostat's tower vector 
+	moves more than 2 degrees from the vector the list was built for.
+	*/
+	helio_arrays &A = _helio_arrays;
+	helio_candidates &C = _helio_candidates;
+
+	C.is_valid = false;
+	C.shadow_current = 0;
+	if(!A.is_packed || A.n == 0) return;
+	for(int i=0; i<A.n; i++)
+		if(! A.is_rect[i]) return;		//the search radius depends on the corner geometry
+	
+	int n = A.n;
+	double interaction_limit = _var_map->sf.interaction_limit.val;
+
+	//Rebuild the spatial index and discard the cached lists when the geometry has changed
+	if( C.x != A.x || C.y != A.y || C.z != A.z || C.height != A.height 
+		|| C.interaction_limit != interaction_limit || A.r_corner > C.r_corner )
+	{
+		C.clear();
+		C.x = A.x;
+		C.y = A.y;
+		C.z = A.z;
+		C.height = A.height;
+		C.interaction_limit = interaction_limit;
+		C.r_corner = A.r_corner*1.01 + 0.01;	//allow for small changes in the corner radius with tracking
+		C.z_max = *std::max_element(A.z.begin(), A.z.end());
+		C.h_max = *std::max_element(A.height.begin(), A.height.end());
+		C.tree.Build(C.x, C.y);
+		C.block.resize(n);
+		C.block_d0.resize(3*n);
+		C.block_ok.assign(n, 0);
+	}
+
+	//Blocking candidates along each heliostat's tower vector
+	double tol = 2.*D2R;
+	double cos_tol = cos(tol);
+	RunHeliostatLoop(n, [&](int h){
+		double d[] = {A.wi[h], A.wj[h], A.wk[h]};
+		double *d0 = &C.block_d0[3*h];
+		if(C.block_ok[h] && d[0]*d0[0] + d[1]*d0[1] + d[2]*d0[2] >= cos_tol) 
+			return;
+		findInteractionCandidates(h, d, tol, C.block[h]);
+		for(int k=0; k<3; k++)
+			d0[k] = d[k];
+		C.block_ok[h] = 1;
+	});
+
+	//Shadowing candidates along the sun vector
+	if(is_shadow)
+	{
+		//Find the sun position bin. The bins span 1 degree of zenith and no more than 1 degree of arc in azimuth, 
+		//so every sun vector in a bin is within 1 degree of the bin center.
+		int iz = (int)floor( acos( fmax(-1., fmin(1., Sun.k)) )*R2D );
+		iz = max(0, min(iz, 179));
+		double s_max = iz < 90 ? sin((iz+1)*D2R) : sin(iz*D2R);
+		int naz = max(1, (int)ceil(360.*s_max));
+		double az = atan2(Sun.i, Sun.j)*R2D;
+		if(az < 0.) az += 360.;
+		int ia = max(0, min((int)floor(az/360.*naz), naz-1));
+		int key = iz*1000 + ia;
+
+		tol = 1.25*D2R;
+		cos_tol = cos(tol);
+
+		std::map<int, helio_candidates::shadow_bin>::iterator bin = C.shadow.find(key);
+		if(bin != C.shadow.end())
+		{
+			double *d0 = bin->second.d0;
+			if(Sun.i*d0[0] + Sun.j*d0[1] + Sun.k*d0[2] < cos_tol)
+				bin = C.shadow.end();
+		}
+
+		if(bin == C.shadow.end())
+		{
+			if(C.shadow.size() > 500) C.shadow.clear();		//limit the memory held by the cache
+
+			helio_candidates::shadow_bin &B = C.shadow[key];
+			double 
+				zc = (iz + 0.5)*D2R,
+				ac = (ia + 0.5)*360./(double)naz*D2R;
+			B.d0[0] = sin(ac)*sin(zc);
+			B.d0[1] = cos(ac)*sin(zc);
+			B.d0[2] = cos(zc);
+			if(Sun.i*B.d0[0] + Sun.j*B.d0[1] + Sun.k*B.d0[2] < cos_tol)
+			{
+				B.d0[0] = Sun.i;
+				B.d0[1] = Sun.j;
+				B.d0[2] = Sun.k;
+			}
+
+			vector<vector<int> > lists(n);
+			RunHeliostatLoop(n, [&](int h){
+				findInteractionCandidates(h, B.d0, tol, lists[h]);
+			});
+
+			B.start.resize(n+1);
+			B.index.clear();
+			for(int h=0; h<n; h++)
+			{
+				B.start[h] = (int)B.index.size();
+				B.index.insert(B.index.end(), lists[h].begin(), lists[h].end());
+			}
+			B.start[n] = (int)B.index.size();
+
+			bin = C.shadow.find(key);
+		}
+
+		C.shadow_current = &bin->second;
+	}
+
+	C.is_valid = true;
+}
+
+void SolarField::findInteractionCandidates(int h, double *d, double tol, vector<int> &cands)
+{
+	/*
+	Find the heliostats that can interfere with packed heliostat 'h' along any direction within 'tol' [rad] 
+	of the unit vector 'd'. The candidates are returned in index order.
+	*/
+	helio_candidates &C = _helio_candidates;
+
+	//Maximum interaction length. This bounds the limit used in calcShadowBlock() for all neighbors.
+	double reach = C.interaction_limit * C.h_max;
+	double elev = asin( fmax(-1., fmin(1., d[2])) ) - tol;
+	if(elev > 0.)
+		reach = fmin(reach, (C.z_max - C.z[h] + C.h_max)/tan(elev) + C.h_max);
+	reach += 0.01;
+	
+	//Distance from the ray within which a neighbor's corners can project onto the heliostat
+	double rad = 2.*C.r_corner + reach*sin(tol) + 0.01;
+
+	//Query the bounding box of the swept ray
+	double 
+		x0 = C.x[h], 
+		y0 = C.y[h], 
+		z0 = C.z[h];
+	double
+		xa = x0 - rad*d[0], xb = x0 + reach*d[0],
+		ya = y0 - rad*d[1], yb = y0 + reach*d[1];
+	cands.clear();
+	C.tree.QueryBox(fmin(xa, xb) - rad, fmax(xa, xb) + rad, fmin(ya, yb) - rad, fmax(ya, yb) + rad, cands);
+
+	//Keep the neighbors inside the swept cylinder
+	int nc = 0;
+	for(int j=0; j<(int)cands.size(); j++)
+	{
+		int hi = cands[j];
+		if(hi == h) continue;
+
+		double 
+			vi = C.x[hi] - x0,
+			vj = C.y[hi] - y0,
+			vk = C.z[hi] - z0;
+		double t = vi*d[0] + vj*d[1] + vk*d[2];
+		double v2 = vi*vi + vj*vj + vk*vk;
+		if(t < -rad || v2 > reach*reach || v2 - t*t > rad*rad) continue;
+		
+		cands[nc++] = hi;
+	}
+	cands.resize(nc);
+	std::sort(cands.begin(), cands.end());
+}
+
+void SolarField::getInteractionCandidates(int h, int mode, vector<int> &cands)
+{
+	/*
+	Get the shadowing (mode = 0) or blocking (mode = 1) candidates of packed heliostat 'h' that are in its 
+	neighbor list, ordered as they appear in the neighbor list. Call after UpdateInteractionCandidates().
+	*/
+	helio_arrays &A = _helio_arrays;
+	helio_candidates &C = _helio_candidates;
+
+	const int *c0, *c1;
+	if(mode == 0)
+	{
+		helio_candidates::shadow_bin *B = C.shadow_current;
+		c0 = B->index.data() + B->start[h];
+		c1 = B->index.data() + B->start[h+1];
+	}
+	else
+	{
+		c0 = C.block[h].data();
+		c1 = c0 + C.block[h].size();
+	}
+
+	//The neighbor list covers the 9 groups around the heliostat's group and is ordered by group, then index
+	int g = A.group[h];
+	int row = g / A.ncol, col = g % A.ncol;
+	cands.clear();
+	for(const int *c = c0; c < c1; c++)
+	{
+		int gi = A.group[*c];
+		if(abs(gi / A.ncol - row) > 1 || abs(gi % A.ncol - col) > 1) continue;
+
+		int j = (int)cands.size();
+		cands.push_back(*c);
+		while(j > 0 && A.group[cands[j-1]] > gi)
+		{
+			cands[j] = cands[j-1];
+			j--;
+		}
+		cands[j] = *c;
+	}
+}
+
+static void calcInputSignatures(var_map &V, size_t &global_sig, map<int, size_t> &templ_sig, map<int, size_t> &rec_sig)
+{
+	/* 
+	Signatures of the variables that the heliostat results depend on: one for the variables of each heliostat 
+	template, one for the variables of each receiver and the tower height, and one for all other variables. 
+	Settings that only affect the layout selection or economics and the calculated outputs are excluded. 
+	Variables are combined in name order, so the signatures don't depend on the order of the variable map.
+	*/
+	static const string skip[] = {"financial.", "optimize.", "parametric.", "land.", "solarfield.0.layout_data"};
+	static const string 
+		helio_group = "heliostat.",
+		rec_group = "receiver.",
+		tht_name = "solarfield.0.tht";
+
+	vector<string> names;
+	names.reserve(V._varptrs.size());
+	for(unordered_map<string, spbase*>::iterator it = V._varptrs.begin(); it != V._varptrs.end(); it++)
+	{
+		bool is_skip = false;
+		for(int i=0; i<5; i++)
+			if(it->first.compare(0, skip[i].size(), skip[i]) == 0) is_skip = true;
+		if(! is_skip) names.push_back(it->first);
+	}
+	std::sort(names.begin(), names.end());
+
+	global_sig = 0;
+	templ_sig.clear();
+	rec_sig.clear();
+	size_t tht_sig = 0;
+	for(size_t n=0; n<names.size(); n++)
+	{
+		spbase *v = V._varptrs[names[n]];
+		SP_DATTYPE dt = v->get_data_type();
+		if(dt == SP_WEATHERDATA || dt == SP_VOIDPTR) continue;
+		if(dynamic_cast< spout<double>* >(v) != 0) continue;
+
+		//use the exact values of floating point variables. The string form is rounded.
+		size_t vsig = std::hash<string>()(names[n]);
+		if(spvar<double> *vd = dynamic_cast< spvar<double>* >(v))
+			hash_combine(vsig, vd->val);
+		else if(spvar<matrix_t<double> > *vm = dynamic_cast< spvar<matrix_t<double> >* >(v))
+		{
+			hash_combine(vsig, vm->val.nrows());
+			for(size_t i=0; i<vm->val.ncells(); i++)
+				hash_combine(vsig, vm->val.data()[i]);
+		}
+		else
+			hash_combine(vsig, std::hash<string>()(v->as_string()));
+
+		//variable groups are named "<group>.<id>.<variable>"
+		if(names[n].compare(0, helio_group.size(), helio_group) == 0)
+			hash_combine(templ_sig[ atoi(names[n].c_str() + helio_group.size()) ], vsig);
+		else if(names[n].compare(0, rec_group.size(), rec_group) == 0)
+			hash_combine(rec_sig[ atoi(names[n].c_str() + rec_group.size()) ], vsig);
+		else if(names[n] == tht_name)
+			tht_sig = vsig;
+		else
+			hash_combine(global_sig, vsig);
+	}
+	for(map<int, size_t>::iterator it = rec_sig.begin(); it != rec_sig.end(); it++)
+		hash_combine(it->second, tht_sig);
+}
+
+static helio_sim_record *ClaimCachedRecord(sim_result_store::helio_records &R, const vector<double> &inputs, bool can_add, int &nrecord)
+{
+	/* 
+	Find the record for 'inputs' and claim it for the current simulation. Returns null if the record is 
+	claimed by another heliostat or simulation, or if it doesn't exist and can't be added. Call with the 
+	store lock held.
+	*/
+	size_t key = 0;
+	for(size_t k=0; k<inputs.size(); k++)
+		hash_combine(key, inputs[k]);
+
+	sim_result_store::helio_records::iterator it = R.find(key);
+	if(it == R.end())
+	{
+		if(! can_add) return 0;
+		it = R.insert( make_pair(key, helio_sim_record()) ).first;
+		nrecord++;
+	}
+	helio_sim_record *r = &it->second;
+	if(r->in_use) return 0;
+	if(r->inputs != inputs)
+	{
+		//different inputs with the same hash
+		*r = helio_sim_record();
+		r->inputs = inputs;
+	}
+	r->in_use = true;
+	r->is_ok = false;
+	return r;
+}
+
+void SolarField::PrepareSimulationCache(double azimuth, double zenith, sim_params &P)
+{
+	/* 
+	Find the stored records of each heliostat for its current inputs and the sun position (see 
+	sim_result_cache), and mark the intercept results that can be reused. Records that don't exist yet are 
+	added. Call after the aim points are calculated.
+	*/
+	ReleaseSimulationCache();
+	sim_result_cache &C = _sim_cache;
+	C.nint_reused = C.nsb_reused = 0;
+	if(! C.is_enabled || _helio_objects.empty()) return;
+
+	size_t global_sig;
+	map<int, size_t> rec_sig;
+	calcInputSignatures(*_var_map, global_sig, C.templ_sig, rec_sig);
+	double interaction_limit = _var_map->sf.interaction_limit.val;
+
+	sim_result_store &S = *C.store;
+	std::lock_guard<std::mutex> lock(S.lock);
+	//Records can only be removed while no simulation holds them. Otherwise stop adding records.
+	if(S.nrecord > S.max_records && S.nactive == 0)
+	{
+		S.intercept.clear();
+		S.shadow_block.clear();
+		S.nrecord = 0;
+	}
+	bool can_add = S.nrecord <= S.max_records;
+	S.nactive++;
+
+	int n = (int)_helio_objects.size();
+	C.current_int.assign(n, (helio_sim_record*)0);
+	C.current_sb.assign(n, (helio_sim_record*)0);
+	vector<double> inputs;
+	for(int i=0; i<n; i++)
+	{
+		Heliostat *H = &_helio_objects.at(i);
+		sp_point *loc = H->getLocation(), *aim = H->getAimPoint();
+		Vect *cant = H->getCantVector();
+		Receiver *Rec = H->getWhichReceiver();
+		int templ = H->getVarMap()->id.val;
+		int irec = (int)(find(_receivers.begin(), _receivers.end(), Rec) - _receivers.begin());
+
+		//Shadowing and blocking. The neighbors are checked by CheckCachedShadowBlock().
+		double vsb[] = {loc->x, loc->y, loc->z, aim->x, aim->y, aim->z, azimuth, zenith, P.is_layout ? 1. : 0., interaction_limit};
+		inputs.assign(vsb, vsb + 10);
+		push_signature(inputs, C.templ_sig[templ]);
+		C.current_sb[i] = ClaimCachedRecord(S.shadow_block, inputs, can_add, S.nrecord);
+
+		//Intercept
+		double vint[] = {H->getFocalX(), H->getFocalY(), cant->i, cant->j, cant->k, (double)templ, (double)irec};
+		inputs.insert(inputs.end(), vint, vint + 7);
+		push_signature(inputs, global_sig);
+		push_signature(inputs, Rec == 0 ? 0 : rec_sig[Rec->getVarMap()->id.val]);
+		helio_sim_record *r = ClaimCachedRecord(S.intercept, inputs, can_add, S.nrecord);
+		if(r != 0) r->is_ok = r->is_set;
+		C.current_int[i] = r;
+	}
+}
+
+void SolarField::ReleaseSimulationCache()
+{
+	/* 
+	Count the results reused by the current simulation and release the records it holds so that other 
+	simulations sharing the store can use them.
+	*/
+	sim_result_cache &C = _sim_cache;
+	if(C.current_int.empty() && C.current_sb.empty()) return;
+
+	std::lock_guard<std::mutex> lock(C.store->lock);
+	for(size_t i=0; i<C.current_int.size(); i++)
+	{
+		helio_sim_record *r = C.current_int[i];
+		if(r == 0) continue;
+		if(r->is_ok) C.nint_reused++;
+		r->in_use = false;
+	}
+	for(size_t i=0; i<C.current_sb.size(); i++)
+	{
+		helio_sim_record *r = C.current_sb[i];
+		if(r == 0) continue;
+		if(r->is_ok) C.nsb_reused++;
+		r->in_use = false;
+	}
+	C.store->nactive--;
+	C.current_int.clear();
+	C.current_sb.clear();
+}
+
+void SolarField::CheckCachedShadowBlock(bool is_shadow)
+{
+	/* 
+	Compare the neighbors that can shadow or block each heliostat against the neighbors its stored results 
+	were calculated with. The neighbor indices and the geometry and template of the heliostat and its 
+	neighbors must match exactly. Call after PackHeliostatArrays() and UpdateInteractionCandidates().
+	*/
+	sim_result_cache &C = _sim_cache;
+	helio_arrays &A = _helio_arrays;
+	if(C.current_sb.empty() || (int)C.current_sb.size() != A.n) return;
+
+	//geometry of each heliostat as seen by its neighbors. Records calculated in this simulation share the copy.
+	const int ng = 12;
+	std::shared_ptr< vector<double> > pgeom = std::make_shared< vector<double> >();
+	vector<double> &geom = *pgeom;
+	geom.reserve(A.n * ng);
+	for(int i=0; i<A.n; i++)
+	{
+		Heliostat *H = &_helio_objects.at(i);
+		sp_point *aim = H->getAimPoint();
+		push_signature(geom, C.templ_sig[H->getVarMap()->id.val]);
+		double g[] = {(double)A.is_enabled[i], A.x[i], A.y[i], A.z[i], 
+			A.ti[i], A.tj[i], A.tk[i], aim->x, aim->y, aim->z};
+		geom.insert(geom.end(), g, g + ng - 2);
+	}
+	std::shared_ptr< const vector<double> > cgeom = pgeom;
+
+	RunHeliostatLoop(A.n, [&](int h){
+		helio_sim_record *rec = C.current_sb[h];
+		if(rec == 0) return;
+
+		//the neighbors are listed in the order they are evaluated, so a change in order also invalidates the results. 
+		//Negative entries mark where each list starts.
+		vector<int> nb(1, h);
+		if(_helio_candidates.is_valid)
+		{
+			vector<int> cands;
+			for(int mode = is_shadow ? 0 : 1; mode < 2; mode++)
+			{
+				getInteractionCandidates(h, mode, cands);
+				nb.push_back(-1 - mode);
+				nb.insert(nb.end(), cands.begin(), cands.end());
+			}
+		}
+		else
+		{
+			int g = A.group[h];
+			nb.push_back(-3);
+			nb.insert(nb.end(), A.nb_index.begin() + A.nb_start[g], A.nb_index.begin() + A.nb_start[g+1]);
+		}
+
+		//same indices, so the stored geometry of each one is at the same position in the stored copy
+		bool same = rec->is_set && rec->nb_index == nb;
+		for(int j=0; same && j<(int)nb.size(); j++)
+			if(nb[j] > -1)
+				same = (int)rec->nb_geom->size() >= (nb[j]+1)*ng 
+					&& std::equal(geom.begin() + nb[j]*ng, geom.begin() + (nb[j]+1)*ng, rec->nb_geom->begin() + nb[j]*ng);
+
+		rec->is_ok = same;
+		if(! rec->is_ok)
+		{
+			rec->nb_index.swap(nb);
+			rec->nb_geom = cgeom;
+			rec->is_set = false;
+		}
+	});
+}
+
 double *SolarField::getPlotBounds(bool /*use_land*/){
 	/* 
 	Returns the field bound extents for plotting based on the field layout 
@@ -3407,14 +4412,95 @@ double *SolarField::getPlotBounds(bool /*use_land*/){
 
 void SolarField::updateAllTrackVectors(Vect &Sun){
     //update all tracking vectors according to the current sun position
+    _helio_arrays.is_packed = false;
+
     if(_var_map->flux.aim_method.mapval() == var_fluxsim::AIM_METHOD::FREEZE_TRACKING)
         return;
     
     int npos = (int)_heliostats.size();
-	for(int i=0; i<npos; i++){
+	RunHeliostatLoop(npos, [&](int i){
 		_heliostats.at(i)->updateTrackVector(Sun);
+	});
+
+}
+
+void SolarField::RunHeliostatLoop(int n, const std::function<void(int)> &func)
+{
+	/* 
+	Call func(i) for i = 0..n-1 over the simulation threads. See RunParallelLoop().
+	*/
+	RunParallelLoop(n, _n_sim_threads, func);
+}
+
+void SolarField::RunParallelLoop(int n, int nthreads, const std::function<void(int)> &func, int block)
+{
+	/* 
+	Call func(i) for i = 0..n-1, dividing the indices into blocks of size 'block' that are handed out to 
+	'nthreads' threads in order (0 = use all available cores). func(i) must only modify data that belongs 
+	to item 'i' so that the results do not depend on the number of threads.
+
+	If any call throws, the remaining blocks are skipped and the exception for the lowest index is 
+	rethrown on the calling thread. This is the same exception the sequential loop would have thrown.
+	*/
+	block = max(block, 1);
+
+	nthreads = nthreads > 0 ? nthreads : (int)std::thread::hardware_concurrency();
+	nthreads = max(1, min(nthreads, (n + block - 1)/block));
+
+	if(nthreads == 1)
+	{
+		for(int i=0; i<n; i++)
+			func(i);
+		return;
 	}
 
+	std::mutex next_lock;
+	int i_next = 0;
+	int i_error = n;
+	std::exception_ptr error;
+
+	auto worker = [&]()
+	{
+		while(true)
+		{
+			next_lock.lock();
+			int i_start = i_error < n ? n : i_next;
+			i_next = min(n, i_start + block);
+			next_lock.unlock();
+
+			if(i_start >= n) return;
+
+			int i_end = min(n, i_start + block);
+			for(int i=i_start; i<i_end; i++)
+			{
+				try
+				{
+					func(i);
+				}
+				catch(...)
+				{
+					next_lock.lock();
+					if(i < i_error)
+					{
+						i_error = i;
+						error = std::current_exception();
+					}
+					next_lock.unlock();
+					break;
+				}
+			}
+		}
+	};
+
+	std::vector<std::thread> threads;
+	for(int t=1; t<nthreads; t++)
+		threads.push_back( std::thread(worker) );
+	worker();	//the calling thread also takes blocks
+	for(int t=0; t<(int)threads.size(); t++)
+		threads.at(t).join();
+
+	if(error)
+		std::rethrow_exception(error);
 }
 
 void SolarField::calcHeliostatShadows(Vect &Sun){
@@ -3586,80 +4672,96 @@ void SolarField::calcAllAimPoints(Vect &Sun, sim_params &P) //bool force_simple,
 	    _sim_info.Reset();
 	    _sim_info.setTotalSimulationCount(nh);
     }
-	int update_every = method == var_fluxsim::AIM_METHOD::IMAGE_SIZE_PRIORITY ? max(nh/20,1) : nh+1;
-	for(int i=0; i<nh; i++){
+	if( method == var_fluxsim::AIM_METHOD::SIMPLE_AIM_POINTS )
+	{
+		//Simple aim points are independent for each heliostat, so evaluate them over the simulation threads
+		if( P.is_layout || nh == 0 || _sim_info.setCurrentSimulation(1) )
+		{
+			RunHeliostatLoop(nh, [&](int i){
+				if( _heliostats.at(i)->IsEnabled() )
+					_flux->simpleAimPoint(*_heliostats.at(i), *this);
+				else
+					_flux->zenithAimPoint(*_heliostats.at(i), Sun);	//disabled heliostats point to zenith
+			});
+		}
+	}
+	else
+	{
+		int update_every = method == var_fluxsim::AIM_METHOD::IMAGE_SIZE_PRIORITY ? max(nh/20,1) : nh+1;
+		for(int i=0; i<nh; i++){
 		
-        int usemethod = method;
+            int usemethod = method;
 
-        //hande image size priority separately from the main switch structure
-        if( method == var_fluxsim::AIM_METHOD::IMAGE_SIZE_PRIORITY )
-        {
-			try{
-                if( hsort.at(nh-i-1)->IsEnabled() )     //is it enabled?
-                {
-				    args[2] = i == 0 ? 1. : 0.;
-				    _flux->imageSizeAimPoint(*hsort.at(nh-i-1), *this, args, i==imsize_last_enabled);	//Send in descending order
-                }
-                else
+            //hande image size priority separately from the main switch structure
+            if( method == var_fluxsim::AIM_METHOD::IMAGE_SIZE_PRIORITY )
+            {
+				try{
+                    if( hsort.at(nh-i-1)->IsEnabled() )     //is it enabled?
+                    {
+					    args[2] = i == 0 ? 1. : 0.;
+					    _flux->imageSizeAimPoint(*hsort.at(nh-i-1), *this, args, i==imsize_last_enabled);	//Send in descending order
+                    }
+                    else
+                    {
+                        _flux->zenithAimPoint(*hsort.at(nh-i-1), Sun);
+                        usemethod = -1;
+                    }
+
+				}
+				catch(...){
+					return;
+				}
+            }
+            else
+            {
+                //handle all other methods' disabled status here
+                if( ! _heliostats.at(i)->IsEnabled() ) 
                 {
-                    _flux->zenithAimPoint(*hsort.at(nh-i-1), Sun);
+                    //this heliostat is disabled. The aimpoint should point the heliostat to zenith
+                    _flux->zenithAimPoint(*_heliostats.at(i), Sun);
                     usemethod = -1;
                 }
-
-			}
-			catch(...){
-				return;
-			}
-        }
-        else
-        {
-            //handle all other methods' disabled status here
-            if( ! _heliostats.at(i)->IsEnabled() ) 
-            {
-                //this heliostat is disabled. The aimpoint should point the heliostat to zenith
-                _flux->zenithAimPoint(*_heliostats.at(i), Sun);
-                usemethod = -1;
             }
-        }
 
 
-		switch(usemethod)
-		{
-        case var_fluxsim::AIM_METHOD::SIMPLE_AIM_POINTS:
-			//Determine the simple aim point - doesn't account for flux limitations
-			_flux->simpleAimPoint(*_heliostats.at(i), *this);
-			break;
-        case var_fluxsim::AIM_METHOD::SIGMA_AIMING:
-			args[1] = -args[1];
-			_flux->sigmaAimPoint(*_heliostats.at(i), *this, args);
-			break;
-        case var_fluxsim::AIM_METHOD::PROBABILITY_SHIFT:
-			_flux->probabilityShiftAimPoint(*_heliostats.at(i), *this, args);
-			break;
-        case var_fluxsim::AIM_METHOD::KEEP_EXISTING:
-			//Keep existing aim point, but we still need to update the image plane flux point (geometry may have changed)
-        {
-            _flux->keepExistingAimPoint(*_heliostats.at(i), *this, 0);
-			break;
-        }
-        case var_fluxsim::AIM_METHOD::FREEZE_TRACKING:
-            //update the aim point based on the movement of the sun and the resulting shift in the reflected image
-            _flux->frozenAimPoint(*_heliostats.at(i), _var_map->sf.tht.val, args);
-            break;
-        case -1:
-        default:
-            //nothing
-            break;
-		}
+			switch(usemethod)
+			{
+            case var_fluxsim::AIM_METHOD::SIMPLE_AIM_POINTS:
+				//Determine the simple aim point - doesn't account for flux limitations
+				_flux->simpleAimPoint(*_heliostats.at(i), *this);
+				break;
+            case var_fluxsim::AIM_METHOD::SIGMA_AIMING:
+				args[1] = -args[1];
+				_flux->sigmaAimPoint(*_heliostats.at(i), *this, args);
+				break;
+            case var_fluxsim::AIM_METHOD::PROBABILITY_SHIFT:
+				_flux->probabilityShiftAimPoint(*_heliostats.at(i), *this, args);
+				break;
+            case var_fluxsim::AIM_METHOD::KEEP_EXISTING:
+				//Keep existing aim point, but we still need to update the image plane flux point (geometry may have changed)
+            {
+                _flux->keepExistingAimPoint(*_heliostats.at(i), *this, 0);
+				break;
+            }
+            case var_fluxsim::AIM_METHOD::FREEZE_TRACKING:
+                //update the aim point based on the movement of the sun and the resulting shift in the reflected image
+                _flux->frozenAimPoint(*_heliostats.at(i), _var_map->sf.tht.val, args);
+                break;
+            case -1:
+            default:
+                //nothing
+                break;
+			}
 
 
-		//Update the progress bar
-        if(! P.is_layout )
-        {
-		    if(i%update_every==0) {
-                if(! _sim_info.setCurrentSimulation(i+1) ) break;
+			//Update the progress bar
+            if(! P.is_layout )
+            {
+			    if(i%update_every==0) {
+                    if(! _sim_info.setCurrentSimulation(i+1) ) break;
+                }
             }
-        }
+		}
 	}
     if(! P.is_layout)
     {
@@ -3875,7 +4977,7 @@ void SolarField::AnalyticalFluxSimulation(Hvector &helios)
 		if(! _receivers.at(n)->isReceiverEnabled() ) continue;
 		FluxSurfaces *surfaces = _receivers.at(n)->getFluxSurfaces();
 		for(unsigned int i=0; i<surfaces->size(); i++){
-			_flux->fluxDensity(&_sim_info, surfaces->at(i), helios, true, true, true);		
+			_flux->fluxDensity(&_sim_info, surfaces->at(i), helios, true, true, true, _n_sim_threads);		
 		}
 	}
 
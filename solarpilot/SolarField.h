@@ -52,6 +52,9 @@
 
 #include <vector>
 #include <string>
+#include <functional>
+#include <memory>
+#include <mutex>
 
 #include "string_util.h"
 #include "interop.h"
@@ -117,6 +120,177 @@ struct sim_params
     sim_params();
 };
 
+struct helio_arrays
+{
+	/*
+	Packed (structure-of-arrays) copy of the heliostat field geometry used by the SolarField::Simulate 
+	efficiency loop. Entries are indexed by position in the SolarField heliostat object array so that 
+	neighbor interactions can be evaluated with contiguous access rather than by walking Heliostat objects.
+	The Heliostat objects remain the authoritative data; the arrays are rebuilt from them for each sun 
+	position and the calculated efficiencies are written back to the objects.
+	*/
+
+	bool is_packed;		//Do the arrays reflect the current tracking and neighbor state?
+	int n;				//Number of heliostat positions
+	std::vector<double>
+		x, y, z,			//[m] heliostat location
+		ti, tj, tk,			//[-] tracking (normal) unit vector
+		wi, wj, wk,			//[-] heliostat-to-tower unit vector
+		sin_zen,			//[-] sine of the tracking zenith angle
+		cos_az, sin_az,		//[-] cosine and sine of the negative tracking azimuth angle
+		cos_zen, sin_zen_n,	//[-] cosine and sine of the negative tracking zenith angle
+		height, width,		//[m] heliostat dimensions
+		cx, cy, cz,			//[m] corner coordinates, 4 per heliostat
+		eta_cos,			//[-] cosine efficiency
+		eta_shadow,			//[-] shadowing efficiency
+		eta_block;			//[-] blocking efficiency
+	std::vector<char>
+		is_enabled,			//Heliostat is enabled
+		is_rect,			//Corner geometry is available
+		poly_ign;			//Dimension ignored when testing points against the heliostat outline
+	std::vector<int>
+		group,				//Neighbor group of each heliostat
+		nb_start,			//Start of each group's entries in nb_index (size = ngroups + 1)
+		nb_index;			//Neighbor heliostat indices for all groups
+	int ncol;				//Number of columns in the neighbor group mesh (group = row*ncol + col)
+	double r_corner;		//[m] Largest distance from any heliostat location to one of its corners
+
+	helio_arrays();
+	void clear();
+};
+
+class helio_kdtree
+{
+	/*
+	Two-dimensional k-d tree over the horizontal heliostat positions. The tree is stored implicitly in 
+	_index: each node is the median entry of its range and the two subtrees occupy the entries to either 
+	side. Levels alternate between splitting on x and on y.
+	*/
+	std::vector<int> _index;
+	std::vector<double> _x, _y;
+
+	void build(int lo, int hi, bool split_x);
+	void query(int lo, int hi, bool split_x, double xmin, double xmax, double ymin, double ymax, std::vector<int> &result) const;
+public:
+	void Build(const std::vector<double> &x, const std::vector<double> &y);
+	void QueryBox(double xmin, double xmax, double ymin, double ymax, std::vector<int> &result) const;	//Append the indices of all points within the box
+	void clear();
+};
+
+struct helio_candidates
+{
+	/*
+	Lists of the neighbors that can possibly shadow (mode 0) or block (mode 1) each packed heliostat. 
+	A neighbor only interferes if the line through one of its corners along the interference direction 
+	crosses the heliostat, so it must lie within 2 x r_corner of the ray from the heliostat toward the sun 
+	(shadowing) or tower (blocking), and no farther along it than the maximum interaction length. Each list 
+	is found with a swept-box query on the k-d tree for a reference direction, with the search radius 
+	widened to cover all directions within a tolerance of it. Shadowing lists are cached by sun position 
+	bin and blocking lists are cached per heliostat, and both are reused until the field geometry changes.
+	*/
+	struct shadow_bin
+	{
+		double d0[3];				//[-] Reference sun vector
+		std::vector<int> start,		//Start of each heliostat's entries in index (size = n + 1)
+			index;					//Candidate heliostat indices
+	};
+
+	bool is_valid;		//Are the lists current? If not, the full neighbor lists are used
+	helio_kdtree tree;
+	std::vector<double> x, y, z, height;	//[m] Geometry the lists were built for
+	double r_corner,			//[m] Corner radius the lists were built for
+		interaction_limit,		//[-] Interaction limit the lists were built for
+		z_max,					//[m] Highest heliostat location
+		h_max;					//[m] Tallest heliostat
+	std::map<int, shadow_bin> shadow;	//Shadowing candidates by sun position bin
+	shadow_bin *shadow_current;			//Bin for the current sun position
+	std::vector<std::vector<int> > block;	//Blocking candidates for each heliostat
+	std::vector<double> block_d0;		//[-] Reference tower vector of each blocking list, 3 per heliostat
+	std::vector<char> block_ok;			//Has the blocking list been built?
+
+	helio_candidates();
+	void clear();
+};
+
+struct helio_sim_record
+{
+	/*
+	Stored result for one heliostat position, found by a hash of the inputs it depends on. The record is only 
+	reused if the stored inputs match exactly. See sim_result_cache.
+	*/
+	std::vector<double> inputs;	//inputs the result was calculated from
+	bool is_set,			//Is the result set?
+		in_use,				//Is the record used by a simulation in progress?
+		is_ok;				//Can the result be reused in the current simulation?
+	//Intercept records
+	double eta_int,			//[-] intercept efficiency
+		sigx, sigy;			//[-] image size normalized by the tower height
+	matrix_t<double> hcoef;	//Hermite coefficients of the image
+	//Shadowing and blocking records
+	std::vector<int> nb_index;	//the heliostat and the neighbors that can shadow or block it, in evaluation order
+	std::shared_ptr<const std::vector<double> > nb_geom;	//geometry of all heliostats when the result was calculated
+	double eta_shadow,		//[-] shadowing efficiency
+		eta_block;			//[-] blocking efficiency
+
+	helio_sim_record();
+};
+
+struct sim_result_store
+{
+	/*
+	Stored heliostat results and flux contributions. A SolarField and its copies share one store (see 
+	sim_result_cache), so records are claimed by the simulation that uses them and all access to the 
+	record maps is guarded by 'lock'.
+	*/
+	typedef std::unordered_map<size_t, helio_sim_record> helio_records;
+
+	std::mutex lock;
+	helio_records intercept,	//intercept records by hash of their inputs
+		shadow_block;			//shadowing and blocking records by hash of their inputs
+	int nrecord,			//Number of stored records
+		max_records,		//Stored records allowed before the store is cleared
+		nactive;			//Simulations holding records
+	flux_contribution_cache flux;	//Heliostat flux contributions, see Flux::fluxDensity()
+
+	sim_result_store();
+};
+
+struct sim_result_cache
+{
+	/*
+	Results from earlier SolarField::Simulate() calls. When enabled, a heliostat's intercept, shadowing and 
+	blocking are reused whenever the inputs they depend on are unchanged, so that repeated evaluations of a 
+	design with small edits (e.g. in design optimization) only recompute the heliostats affected by the edit.
+
+	Each record is found by a hash of the inputs that the heliostat result depends on, and the inputs are 
+	stored with the result and compared exactly:
+	- intercept: heliostat location, aim point, receiver, focal length and canting, sun position, the 
+	  variables of the heliostat's template and receiver (including the tower height), and all other 
+	  variables except the heliostat, receiver, financial, optimization, parametric and land settings
+	- shadowing and blocking: heliostat location, aim point, template variables, sun position and the 
+	  interaction limit. The indices, location, tracking vector, aim point and template of the neighbors 
+	  that can shadow or block the heliostat must also match the stored neighbors exactly.
+	Cosine and attenuation efficiency are cheap and always recalculated. Records for other inputs are kept, 
+	so returning to an earlier design (e.g. a tower height the optimizer already evaluated) reuses its 
+	results, and edits to one receiver or template don't discard the results of the others. The flux 
+	contributions of each heliostat are stored the same way by the Flux object (see Flux::fluxDensity()).
+
+	The store is kept when the field is recreated by SolarField::Create() so that results carry over to the 
+	next layout, and it is shared with copies of the field made by the copy constructor, so the field copies 
+	of a multithreaded simulation (see AutoPilot_MT) reuse each other's results.
+	*/
+	bool is_enabled;		//Are results cached and reused?
+	int nint_reused,		//Heliostats whose intercept was reused in the last simulation
+		nsb_reused;			//Heliostats whose shadowing and blocking were reused in the last simulation
+	std::shared_ptr<sim_result_store> store;	//Records, shared with copies of the field
+	std::map<int, size_t> templ_sig;	//Signature of the variables of each heliostat template in the current simulation
+	std::vector<helio_sim_record*> 
+		current_int,		//Intercept records used in the current simulation, by heliostat object index
+		current_sb;			//Shadowing and blocking records used in the current simulation
+
+	sim_result_cache();
+};
+
 typedef std::vector<layout_obj> layout_shell;
 typedef std::map<int, Heliostat*> htemp_map;
 
@@ -138,6 +312,8 @@ protected:
 		_cancel_flag,	//Flag indicating the current simulation should be cancelled
 		_is_created;	//Has the solar field Create() method been called?
 
+	int _n_sim_threads;	//Number of threads used for the heliostat loops in Simulate(). 0 = use all available cores
+
 
 	double _helio_extents[4];	//Extents of the heliostat field [xmax, xmin, ymax, ymin]
 	layout_shell _layout;	//All of the layouts associated with this solar field
@@ -166,6 +342,10 @@ protected:
 
 	optical_hash_tree _optical_mesh;
 
+	helio_arrays _helio_arrays;	//Packed copy of the field geometry used during simulation
+	helio_candidates _helio_candidates;	//Shadowing and blocking candidates for the packed heliostats
+	sim_result_cache _sim_cache;	//Results reused between simulations. Not reset by Clean()
+
     var_map *_var_map;
 
 	class clouds : public mod_base
@@ -218,6 +398,7 @@ public:
 	simulation_info *getSimInfoObject();
 	simulation_error *getSimErrorObject();
 	optical_hash_tree *getOpticalHashTree();
+	helio_arrays *getHeliostatArrays();
 
 	//-------"SETS"
 	/*min/max field radius.. function sets the value in units of [m]. Can be used as follows:
@@ -227,6 +408,13 @@ public:
 	void setAimpointStatus(bool state);
 	void setSimulatedPowerToReceiver(double val);
 	void setHeliostatExtents(double xmax, double xmin, double ymax, double ymin);
+	void setSimulationThreadCount(int nthreads);
+	int getSimulationThreadCount();
+	void setIncrementalSimulation(bool enabled);	//Reuse heliostat results between simulations when their inputs have not changed
+	bool getIncrementalSimulation();
+	void ClearSimulationCache();
+	void getSimulationCacheUse(int &n_intercept, int &n_shadow_block);	//Heliostats whose stored results were reused in the last simulation
+	int getFluxCacheUse();	//Heliostat flux contributions reused since the start of the last simulation
 	
 	//Scripts
 	void Create(var_map &V);
@@ -259,7 +447,17 @@ public:
 	
     static void SimulateHeliostatEfficiency(SolarField *SF, Vect &Sun, Heliostat *helio, sim_params &P);
 	double calcShadowBlock(Heliostat *H, Heliostat *HS, int mode, Vect &Sun, double interaction_limit = 100.);	//Calculate the shadowing or blocking between two heliostats
+	double calcShadowBlockPacked(int h, int hi, int mode, Vect &Sun, double interaction_limit = 100.);	//calcShadowBlock() using the packed heliostat arrays
+	void PackHeliostatArrays();	//Copy the current heliostat geometry and neighbor lists into the packed arrays
+	void UpdateInteractionCandidates(Vect &Sun, bool is_shadow);	//Update the shadowing and blocking candidates of the packed heliostats
+	void getInteractionCandidates(int h, int mode, std::vector<int> &cands);	//Candidates of packed heliostat 'h' in neighbor list order
+	void findInteractionCandidates(int h, double *d, double tol, std::vector<int> &cands);	//Query the k-d tree for the candidates along direction 'd'
+	void PrepareSimulationCache(double azimuth, double zenith, sim_params &P);	//Find the cached results for each heliostat
+	void CheckCachedShadowBlock(bool is_shadow);	//Mark the cached shadowing and blocking results whose neighbors have not changed
+	void ReleaseSimulationCache();	//Count the reused results and release the records held by the current simulation
 	void updateAllTrackVectors(Vect &Sun);	//Macro for calculating corner positions
+	void RunHeliostatLoop(int n, const std::function<void(int)> &func);	//Evaluate func(0..n-1) over the simulation threads
+	static void RunParallelLoop(int n, int nthreads, const std::function<void(int)> &func, int block = 32);	//Evaluate func(0..n-1) over 'nthreads' threads
 	void calcHeliostatShadows(Vect &Sun);	//Macro for calculating heliostat shadows
 	void calcAllAimPoints(Vect &Sun, sim_params &P); //bool force_simple=false, bool quiet=true); 
 	int getActiveReceiverCount();
@@ -0,0 +1,489 @@
+/*******************************************************************************************************
+*  Copyright 2017 Alliance for Sustainable Energy, LLC
+*
+*  NOTICE: This software was developed at least in part by Alliance for Sustainable Energy, LLC
+*  (Alliance) under Contract No. DE-AC36-08GO28308 with the U.S. Department of Energy and the U.S.
+*  The Government retains for itself and others acting on its behalf a nonexclusive, paid-up,
+*  irrevocable worldwide license in the software to reproduce, prepare derivative works, distribute
+*  copies to the public, perform publicly and display publicly, and to permit others to do so.
+*
+*  Redistribution and use in source and binary forms, with or without modification, are permitted
+*  provided that the following conditions are met:
+*
+*  1. Redistributions of source code must retain the above copyright notice, the above government
+*  rights notice, this list of conditions and the following disclaimer.
+*
+*  2. Redistributions in binary form must reproduce the above copyright notice, the above government
+*  rights notice, this list of conditions and the following disclaimer in the documentation and/or
+*  other materials provided with the distribution.
+*
+*  3. The entire corresponding source code of any redistribution, with or without modification, by a
+*  research entity, including but not limited to any contracting manager/operator of a United States
+*  National Laboratory, any institution of higher learning, and any non-profit organization, must be
+*  made publicly available under this license for as long as the redistribution is made available by
+*  the research entity.
+*
+*  4. Redistribution of this software, without modification, must refer to the software by the same
+*  designation. Redistribution of a modified version of this software (i) may not refer to the modified
+*  version by the same designation, or by any confusingly similar designation, and (ii) must refer to
+*  the underlying software originally provided by Alliance as System Advisor Model or SAM. Except
+*  to comply with the foregoing, the terms System Advisor Model, SAM, or any confusingly similar
+*  designation may not be used to refer to any modified version of this software or any modified
+*  version of the underlying software originally provided by Alliance without the prior written consent
+*  of Alliance.
+*
+*  5. The name of the copyright holder, contributors, the United States Government, the United States
+*  Department of Energy, or any of their employees may not be used to endorse or promote products
+*  derived from this software without specific prior written permission.
+*
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR
+*  IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+*  FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER,
+*  CONTRIBUTORS, UNITED STATES GOVERNMENT OR UNITED STATES DEPARTMENT OF ENERGY, NOR ANY OF THEIR
+*  EMPLOYEES, BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+*  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+*  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+*  IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+*  THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************************************/
+
+#include "core.h"
+#include "common.h"
+
+#include <limits>
+#include <cmath>
+#include <algorithm>
+
+#include "6par_jacobian.h"
+#include "6par_lu.h"
+#include "6par_search.h"
+#include "6par_newton.h"
+#include "6par_gamma.h"
+#include "6par_solve.h"
+#include "lib_iec61853.h"
+
+static var_info _cm_vtab_module_par_batch[] = {
+/*   VARTYPE           DATATYPE         NAME                           LABEL                                UNITS     META                      GROUP                      REQUIRED_IF                 CONSTRAINTS                      UI_HINTS*/
+	{ SSC_INPUT,         SSC_MATRIX,      "cec_input",              "CEC module datasheet table",     "various", "[TYPE,VMP,IMP,VOC,ISC,ALPHA_ISC,BETA_VOC,GAMMA_PMP,NSER,TREF], TYPE 0..5 monoSi,multiSi/polySi,cdte,cis,cigs,amorphous, TREF optional", "Module Parameter Batch", "?", "", "" },
+	{ SSC_INPUT,         SSC_MATRIX,      "iec_input",              "IEC-61853 test data for all modules", "various", "[MODULE,IRR,TC,PMP,VMP,VOC,ISC], MODULE is the 0-based index into iec_nser and iec_type", "Module Parameter Batch", "?", "", "" },
+	{ SSC_INPUT,         SSC_ARRAY,       "iec_nser",               "IEC-61853 cells in series per module", "", "",                     "Module Parameter Batch",  "?",                       "",      "" },
+	{ SSC_INPUT,         SSC_ARRAY,       "iec_type",               "IEC-61853 cell technology type per module", "0..5", "monoSi,multiSi/polySi,cdte,cis,cigs,amorphous", "Module Parameter Batch", "?", "", "" },
+	{ SSC_INPUT,         SSC_NUMBER,      "nthreads",               "Number of threads",              "",        "0=all available cores", "Module Parameter Batch",  "?=0",                     "INTEGER,MIN=0", "" },
+	{ SSC_INPUT,         SSC_NUMBER,      "warm_start",             "Start fits from the nearest solved module of the same technology", "0/1", "", "Module Parameter Batch", "?=1", "BOOLEAN", "" },
+
+// outputs
+	{ SSC_OUTPUT,        SSC_ARRAY,       "cec_a",                  "Modified nonideality factor",    "1/V",    "",                      "Module Parameter Batch",  "",                        "",                      "" },
+	{ SSC_OUTPUT,        SSC_ARRAY,       "cec_Il",                 "Light current",                  "A",      "",                      "Module Parameter Batch",  "",                        "",                      "" },
+	{ SSC_OUTPUT,        SSC_ARRAY,       "cec_Io",                 "Saturation current",             "A",      "",                      "Module Parameter Batch",  "",                        "",                      "" },
+	{ SSC_OUTPUT,        SSC_ARRAY,       "cec_Rs",                 "Series resistance",              "ohm",    "",                      "Module Parameter Batch",  "",                        "",                      "" },
+	{ SSC_OUTPUT,        SSC_ARRAY,       "cec_Rsh",                "Shunt resistance",               "ohm",    "",                      "Module Parameter Batch",  "",                        "",                      "" },
+	{ SSC_OUTPUT,        SSC_ARRAY,       "cec_Adj",                "OC SC temp coeff adjustment",    "%",      "",                      "Module Parameter Batch",  "",                        "",                      "" },
+	{ SSC_OUTPUT,        SSC_ARRAY,       "cec_status",             "Solver status",                  "",       "0=ok, <0 solver or sanity check error, -100 invalid inputs", "Module Parameter Batch", "", "", "" },
+	{ SSC_OUTPUT,        SSC_ARRAY,       "cec_iterations",         "Newton iterations over all attempts", "",  "",                      "Module Parameter Batch",  "",                        "",                      "" },
+	{ SSC_OUTPUT,        SSC_ARRAY,       "cec_warm_source",        "Module the solution was warm-started from", "", "-1=heuristic initial guess", "Module Parameter Batch", "", "",             "" },
+	{ SSC_OUTPUT,        SSC_ARRAY,       "cec_pmp_error",          "Relative error in Pmp at the solution", "", "",                     "Module Parameter Batch",  "",                        "",                      "" },
+
+	{ SSC_OUTPUT,        SSC_ARRAY,       "iec_alphaIsc",           "SC temp coefficient @ STC",      "A/C",    "",                      "Module Parameter Batch",  "",                        "",                      "" },
+	{ SSC_OUTPUT,        SSC_ARRAY,       "iec_betaVoc",            "OC temp coefficient @ STC",      "V/C",    "",                      "Module Parameter Batch",  "",                        "",                      "" },
+	{ SSC_OUTPUT,        SSC_ARRAY,       "iec_gammaPmp",           "MP temp coefficient @ STC",      "%/C",    "",                      "Module Parameter Batch",  "",                        "",                      "" },
+	{ SSC_OUTPUT,        SSC_ARRAY,       "iec_n",                  "Diode factor",                   "",       "",                      "Module Parameter Batch",  "",                        "",                      "" },
+	{ SSC_OUTPUT,        SSC_ARRAY,       "iec_Il",                 "Light current",                  "A",      "",                      "Module Parameter Batch",  "",                        "",                      "" },
+	{ SSC_OUTPUT,        SSC_ARRAY,       "iec_Io",                 "Saturation current",             "A",      "",                      "Module Parameter Batch",  "",                        "",                      "" },
+	{ SSC_OUTPUT,        SSC_ARRAY,       "iec_C1",                 "Rsh fitting C1",                 "",       "",                      "Module Parameter Batch",  "",                        "",                      "" },
+	{ SSC_OUTPUT,        SSC_ARRAY,       "iec_C2",                 "Rsh fitting C2",                 "",       "",                      "Module Parameter Batch",  "",                        "",                      "" },
+	{ SSC_OUTPUT,        SSC_ARRAY,       "iec_C3",                 "Rsh fitting C3",                 "",       "",                      "Module Parameter Batch",  "",                        "",                      "" },
+	{ SSC_OUTPUT,        SSC_ARRAY,       "iec_D1",                 "Rs fitting D1",                  "",       "",                      "Module Parameter Batch",  "",                        "",                      "" },
+	{ SSC_OUTPUT,        SSC_ARRAY,       "iec_D2",                 "Rs fitting D2",                  "",       "",                      "Module Parameter Batch",  "",                        "",                      "" },
+	{ SSC_OUTPUT,        SSC_ARRAY,       "iec_D3",                 "Rs fitting D3",                  "",       "",                      "Module Parameter Batch",  "",                        "",                      "" },
+	{ SSC_OUTPUT,        SSC_ARRAY,       "iec_Egref",              "Bandgap voltage",                "eV",     "",                      "Module Parameter Batch",  "",                        "",                      "" },
+	{ SSC_OUTPUT,        SSC_ARRAY,       "iec_status",             "Fit status",                     "",       "1=ok, 0=failed",        "Module Parameter Batch",  "",                        "",                      "" },
+	{ SSC_OUTPUT,        SSC_ARRAY,       "iec_warm_source",        "Module the fit was warm-started from", "", "-1=default initial guesses", "Module Parameter Batch", "", "",                 "" },
+	{ SSC_OUTPUT,        SSC_ARRAY,       "iec_nsolved",            "Test conditions with a single diode solution", "", "",              "Module Parameter Batch",  "",                        "",                      "" },
+
+var_info_invalid };
+
+enum { CEC_TYPE, CEC_VMP, CEC_IMP, CEC_VOC, CEC_ISC, CEC_ALPHA_ISC, CEC_BETA_VOC, CEC_GAMMA_PMP, CEC_NSER, CEC_TREF, CEC_COLS };
+enum { IEC_MODULE, IEC_IRR, IEC_TC, IEC_PMP, IEC_VMP, IEC_VOC, IEC_ISC, IEC_COLS };
+
+// Modules are fitted in chunks of similar modules of one technology. Within a chunk each fit is
+// warm-started from the nearest module already solved in that chunk, so the results do not
+// depend on the number of threads.
+static const size_t FIT_CHUNK = 32;
+
+// datasheet quantities used to sort modules and to find the nearest solved module
+struct module_features
+{
+	int type;
+	double nser;
+	double f[4]; // Voc per cell, Isc, Vmp/Voc, Imp/Isc
+
+	bool operator<( const module_features &b ) const
+	{
+		if ( type != b.type ) return type < b.type;
+		if ( nser != b.nser ) return nser < b.nser;
+		if ( f[0] != b.f[0] ) return f[0] < b.f[0];
+		return f[1] < b.f[1];
+	}
+
+	double distance( const module_features &b ) const
+	{
+		double d = ( nser - b.nser ) / std::max( nser, 1.0 );
+		d *= d;
+		for( int i=0;i<4;i++ )
+		{
+			double r = ( f[i] - b.f[i] ) / std::max( fabs(f[i]), 1e-6 );
+			d += r*r;
+		}
+		return d;
+	}
+};
+
+static module_features make_features( int type, double nser, double Vmp, double Imp, double Voc, double Isc )
+{
+	module_features mf;
+	mf.type = type;
+	mf.nser = nser;
+	mf.f[0] = Voc / std::max( nser, 1.0 );
+	mf.f[1] = Isc;
+	mf.f[2] = Vmp / Voc;
+	mf.f[3] = Imp / Isc;
+
+	// keep the ordering well defined for incomplete records (they fail to fit anyway)
+	if ( !std::isfinite( mf.nser ) ) mf.nser = 0;
+	for( int i=0;i<4;i++ )
+		if ( !std::isfinite( mf.f[i] ) ) mf.f[i] = 0;
+	return mf;
+}
+
+// split modules into runs of at most FIT_CHUNK similar modules that share a technology
+static void make_fit_chunks( const std::vector<module_features> &features, std::vector< std::vector<size_t> > &chunks )
+{
+	std::vector<size_t> order( features.size() );
+	for( size_t i=0;i<order.size();i++ )
+		order[i] = i;
+
+	std::stable_sort( order.begin(), order.end(),
+		[&features]( size_t a, size_t b ) { return features[a] < features[b]; } );
+
+	chunks.clear();
+	for( size_t i=0;i<order.size();i++ )
+	{
+		if ( chunks.empty() || chunks.back().size() >= FIT_CHUNK
+			|| features[ chunks.back().back() ].type != features[ order[i] ].type )
+			chunks.push_back( std::vector<size_t>() );
+
+		chunks.back().push_back( order[i] );
+	}
+}
+
+// index into 'solved' of the module nearest to 'mf', or -1 if none
+static int nearest_solved( const std::vector<module_features> &features, const std::vector<size_t> &solved, const module_features &mf )
+{
+	int inearest = -1;
+	double dmin = std::numeric_limits<double>::max();
+	for( size_t i=0;i<solved.size();i++ )
+	{
+		double d = mf.distance( features[ solved[i] ] );
+		if ( d < dmin )
+		{
+			dmin = d;
+			inearest = (int)i;
+		}
+	}
+	return inearest;
+}
+
+class newton_iteration_counter : public notification_interface
+{
+public:
+	int count;
+	newton_iteration_counter() : count(0) { }
+	virtual bool notify( int, double *, double *, const int ) { count++; return true; }
+};
+
+// keeps the last solver message so it can be logged for failed fits after the threads finish
+class fit_message_collector : public Imessage_api
+{
+public:
+	std::string last;
+	virtual void Printf( const char *fmt, ... ) {
+		char buf[1024];
+		va_list ap;
+		va_start(ap, fmt);
+#ifdef _MSC_VER
+		_vsnprintf(buf, 1024, fmt, ap);
+#else
+		vsnprintf(buf,1024,fmt,ap);
+#endif
+		va_end(ap);
+		last = buf;
+	}
+	virtual void Outln( const char *msg ) {
+		last = msg;
+	}
+};
+
+class cm_module_par_batch : public compute_module
+{
+public:
+
+	cm_module_par_batch()
+	{
+		add_var_info( _cm_vtab_module_par_batch );
+	}
+
+	void fit_cec()
+	{
+		util::matrix_t<double> input = as_matrix("cec_input");
+		if ( input.ncols() != CEC_COLS && input.ncols() != CEC_COLS-1 )
+			throw exec_error( "module_par_batch", util::format("cec_input requires %d or %d columns: TYPE,VMP,IMP,VOC,ISC,ALPHA_ISC,BETA_VOC,GAMMA_PMP,NSER[,TREF]", CEC_COLS-1, CEC_COLS) );
+
+		size_t nmod = input.nrows();
+		bool warm_start = as_boolean("warm_start");
+
+		std::vector<module_features> features( nmod );
+		for( size_t i=0;i<nmod;i++ )
+			features[i] = make_features( (int)input(i,CEC_TYPE), input(i,CEC_NSER),
+				input(i,CEC_VMP), input(i,CEC_IMP), input(i,CEC_VOC), input(i,CEC_ISC) );
+
+		std::vector< std::vector<size_t> > chunks;
+		make_fit_chunks( features, chunks );
+
+		const double nan = std::numeric_limits<double>::quiet_NaN();
+		std::vector<double> a( nmod, nan ), Il( nmod, nan ), Io( nmod, nan ), Rs( nmod, nan ), Rsh( nmod, nan ), Adj( nmod, nan ), pmp_err( nmod, nan );
+		std::vector<int> status( nmod, -100 ), iterations( nmod, 0 ), warm_source( nmod, -1 );
+
+		run_chunks( chunks.size(), chunk_thread_count( as_integer("nthreads"), chunks.size() ), [&]( size_t k )
+		{
+			std::vector<size_t> solved;
+			std::vector<module6par> solved_mods;
+			for( size_t n=0;n<chunks[k].size();n++ )
+			{
+				size_t i = chunks[k][n];
+				int type = (int)input(i,CEC_TYPE);
+				double Vmp = input(i,CEC_VMP);
+				double Imp = input(i,CEC_IMP);
+				double Voc = input(i,CEC_VOC);
+				double Isc = input(i,CEC_ISC);
+				int nser = (int)input(i,CEC_NSER);
+				double Tref = input.ncols() > CEC_TREF ? input(i,CEC_TREF) : 25.0;
+
+				if ( type < module6par::monoSi || type > module6par::Amorphous || nser < 1
+					|| !(Vmp > 0) || !(Imp > 0) || !(Voc > Vmp) || !(Isc > Imp) )
+					continue; // status remains 'invalid inputs'
+
+				module6par m( type, Vmp, Imp, Voc, Isc,
+					input(i,CEC_BETA_VOC), input(i,CEC_ALPHA_ISC), input(i,CEC_GAMMA_PMP), nser, Tref+273.15 );
+				newton_iteration_counter nif;
+				int err = -1;
+
+				int inear = warm_start ? nearest_solved( features, solved, features[i] ) : -1;
+				if ( inear >= 0 )
+				{
+					m.guess_from( solved_mods[inear] );
+					err = m.solve<double>( 300, 1e-7, &nif );
+					if ( err == 0 )
+						warm_source[i] = (int)solved[inear];
+				}
+
+				if ( err < 0 )
+					err = m.solve_with_sanity_and_heuristics<double>( 300, 1e-7, &nif );
+
+				status[i] = err;
+				iterations[i] = nif.count;
+				if ( err < 0 )
+					continue;
+
+				a[i] = m.a;
+				Il[i] = m.Il;
+				Io[i] = m.Io;
+				Rs[i] = m.Rs;
+				Rsh[i] = m.Rsh;
+				Adj[i] = m.Adj;
+				pmp_err[i] = ( Vmp * module6par::current( Vmp, m.Il, m.Io, m.Rs, m.a, m.Rsh, Imp ) - Vmp*Imp ) / ( Vmp*Imp );
+
+				solved.push_back( i );
+				solved_mods.push_back( m );
+			}
+		});
+
+		ssc_number_t *p_a = allocate( "cec_a", nmod );
+		ssc_number_t *p_Il = allocate( "cec_Il", nmod );
+		ssc_number_t *p_Io = allocate( "cec_Io", nmod );
+		ssc_number_t *p_Rs = allocate( "cec_Rs", nmod );
+		ssc_number_t *p_Rsh = allocate( "cec_Rsh", nmod );
+		ssc_number_t *p_Adj = allocate( "cec_Adj", nmod );
+		ssc_number_t *p_status = allocate( "cec_status", nmod );
+		ssc_number_t *p_iter = allocate( "cec_iterations", nmod );
+		ssc_number_t *p_warm = allocate( "cec_warm_source", nmod );
+		ssc_number_t *p_err = allocate( "cec_pmp_error", nmod );
+		int nfail = 0;
+		for( size_t i=0;i<nmod;i++ )
+		{
+			p_a[i] = (ssc_number_t)a[i];
+			p_Il[i] = (ssc_number_t)Il[i];
+			p_Io[i] = (ssc_number_t)Io[i];
+			p_Rs[i] = (ssc_number_t)Rs[i];
+			p_Rsh[i] = (ssc_number_t)Rsh[i];
+			p_Adj[i] = (ssc_number_t)Adj[i];
+			p_status[i] = (ssc_number_t)status[i];
+			p_iter[i] = (ssc_number_t)iterations[i];
+			p_warm[i] = (ssc_number_t)warm_source[i];
+			p_err[i] = (ssc_number_t)pmp_err[i];
+			if ( status[i] < 0 ) nfail++;
+		}
+
+		if ( nfail > 0 )
+			log( util::format("%d of %d CEC modules could not be solved, see cec_status", nfail, (int)nmod), SSC_WARNING );
+	}
+
+	void fit_iec()
+	{
+		util::matrix_t<double> input = as_matrix("iec_input");
+		if ( input.ncols() != IEC_COLS )
+			throw exec_error( "module_par_batch", "seven data columns required for iec_input matrix: MODULE,IRR,TC,PMP,VMP,VOC,ISC");
+
+		size_t nser_len = 0, type_len = 0;
+		ssc_number_t *p_nser = as_array( "iec_nser", &nser_len );
+		ssc_number_t *p_type = as_array( "iec_type", &type_len );
+		if ( nser_len != type_len )
+			throw exec_error( "module_par_batch", "iec_nser and iec_type must have one entry per module");
+
+		size_t nmod = nser_len;
+		bool warm_start = as_boolean("warm_start");
+
+		// split the stacked test data by module
+		std::vector< std::vector<size_t> > rows( nmod );
+		for( size_t r=0;r<input.nrows();r++ )
+		{
+			int imod = (int)input(r,IEC_MODULE);
+			if ( imod < 0 || imod >= (int)nmod )
+				throw exec_error( "module_par_batch", util::format("iec_input row %d refers to module %d, but only %d modules are defined", (int)r, imod, (int)nmod) );
+			rows[imod].push_back( r );
+		}
+
+		std::vector< util::matrix_t<double> > data( nmod );
+		std::vector<module_features> features( nmod );
+		for( size_t i=0;i<nmod;i++ )
+		{
+			data[i].resize( rows[i].size(), iec61853_module_t::COL_MAX );
+			double Vmp0 = 0, Imp0 = 0, Voc0 = 0, Isc0 = 0;
+			for( size_t j=0;j<rows[i].size();j++ )
+			{
+				for( size_t c=0;c<iec61853_module_t::COL_MAX;c++ )
+					data[i](j,c) = input( rows[i][j], IEC_IRR+c );
+
+				if ( data[i](j,iec61853_module_t::COL_IRR) == 1000.0 && data[i](j,iec61853_module_t::COL_TC) == 25.0 )
+				{
+					Vmp0 = data[i](j,iec61853_module_t::COL_VMP);
+					Imp0 = data[i](j,iec61853_module_t::COL_PMP) / Vmp0;
+					Voc0 = data[i](j,iec61853_module_t::COL_VOC);
+					Isc0 = data[i](j,iec61853_module_t::COL_ISC);
+				}
+			}
+			features[i] = make_features( (int)p_type[i], p_nser[i], Vmp0, Imp0, Voc0, Isc0 );
+		}
+
+		std::vector< std::vector<size_t> > chunks;
+		make_fit_chunks( features, chunks );
+
+		std::vector<iec61853_module_t> result( nmod );
+		std::vector<int> status( nmod, 0 ), warm_source( nmod, -1 ), nsolved( nmod, 0 );
+		std::vector<std::string> messages( nmod );
+
+		run_chunks( chunks.size(), chunk_thread_count( as_integer("nthreads"), chunks.size() ), [&]( size_t k )
+		{
+			std::vector<size_t> solved;
+			for( size_t n=0;n<chunks[k].size();n++ )
+			{
+				size_t i = chunks[k][n];
+				fit_message_collector msgs;
+				util::matrix_t<double> par;
+
+				int inear = warm_start ? nearest_solved( features, solved, features[i] ) : -1;
+				bool ok = false;
+				if ( inear >= 0 )
+				{
+					result[i]._imsg = &msgs;
+					ok = result[i].calculate( data[i], (int)p_nser[i], (int)p_type[i], par, false, &result[ solved[inear] ] );
+					if ( ok )
+						warm_source[i] = (int)solved[inear];
+				}
+
+				if ( !ok )
+				{
+					result[i] = iec61853_module_t();
+					result[i]._imsg = &msgs;
+					ok = result[i].calculate( data[i], (int)p_nser[i], (int)p_type[i], par, false );
+				}
+
+				result[i]._imsg = 0;
+				status[i] = ok ? 1 : 0;
+				for( size_t j=0;j<par.nrows();j++ )
+					if ( std::isfinite( par(j,iec61853_module_t::IL) ) )
+						nsolved[i]++;
+
+				if ( ok )
+					solved.push_back( i );
+				else
+					messages[i] = msgs.last;
+			}
+		});
+
+		ssc_number_t *p_alpha = allocate( "iec_alphaIsc", nmod );
+		ssc_number_t *p_beta = allocate( "iec_betaVoc", nmod );
+		ssc_number_t *p_gamma = allocate( "iec_gammaPmp", nmod );
+		ssc_number_t *p_n = allocate( "iec_n", nmod );
+		ssc_number_t *p_Il = allocate( "iec_Il", nmod );
+		ssc_number_t *p_Io = allocate( "iec_Io", nmod );
+		ssc_number_t *p_C1 = allocate( "iec_C1", nmod );
+		ssc_number_t *p_C2 = allocate( "iec_C2", nmod );
+		ssc_number_t *p_C3 = allocate( "iec_C3", nmod );
+		ssc_number_t *p_D1 = allocate( "iec_D1", nmod );
+		ssc_number_t *p_D2 = allocate( "iec_D2", nmod );
+		ssc_number_t *p_D3 = allocate( "iec_D3", nmod );
+		ssc_number_t *p_Egref = allocate( "iec_Egref", nmod );
+		ssc_number_t *p_status = allocate( "iec_status", nmod );
+		ssc_number_t *p_warm = allocate( "iec_warm_source", nmod );
+		ssc_number_t *p_nsolved = allocate( "iec_nsolved", nmod );
+		for( size_t i=0;i<nmod;i++ )
+		{
+			const iec61853_module_t &m = result[i];
+			bool ok = status[i] != 0;
+			const double nan = std::numeric_limits<double>::quiet_NaN();
+			p_alpha[i] = (ssc_number_t)( ok ? m.alphaIsc : nan );
+			p_beta[i] = (ssc_number_t)( ok ? m.betaVoc : nan );
+			p_gamma[i] = (ssc_number_t)( ok ? m.gammaPmp : nan );
+			p_n[i] = (ssc_number_t)( ok ? m.n : nan );
+			p_Il[i] = (ssc_number_t)( ok ? m.Il : nan );
+			p_Io[i] = (ssc_number_t)( ok ? m.Io : nan );
+			p_C1[i] = (ssc_number_t)( ok ? m.C1 : nan );
+			p_C2[i] = (ssc_number_t)( ok ? m.C2 : nan );
+			p_C3[i] = (ssc_number_t)( ok ? m.C3 : nan );
+			p_D1[i] = (ssc_number_t)( ok ? m.D1 : nan );
+			p_D2[i] = (ssc_number_t)( ok ? m.D2 : nan );
+			p_D3[i] = (ssc_number_t)( ok ? m.D3 : nan );
+			p_Egref[i] = (ssc_number_t)( ok ? m.Egref : nan );
+			p_status[i] = (ssc_number_t)status[i];
+			p_warm[i] = (ssc_number_t)warm_source[i];
+			p_nsolved[i] = (ssc_number_t)nsolved[i];
+
+			if ( !ok )
+				log( util::format("IEC-61853 module %d could not be fitted: %s", (int)i, messages[i].c_str()), SSC_WARNING );
+		}
+	}
+
+	void exec( ) throw( general_error )
+	{
+		if ( !is_assigned("cec_input") && !is_assigned("iec_input") )
+			throw exec_error( "module_par_batch", "no module data given, assign cec_input and/or iec_input");
+
+		if ( is_assigned("cec_input") )
+			fit_cec();
+
+		if ( is_assigned("iec_input") )
+			fit_iec();
+	}
+};
+
+DEFINE_MODULE_ENTRY( module_par_batch, "Parallel CEC 6 parameter and IEC-61853 coefficient fitting for a table of modules", 1 )
@@ -47,6 +47,8 @@
 *  THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 *******************************************************************************************************/
 
+#include <thread>
+
 #include "cmod_pvsamv1.h"
 #include "lib_pv_io_manager.h"
 
@@ -76,6 +78,9 @@ static var_info _cm_vtab_pvsamv1[] = {
 
 	//SEV: Activating the snow model
 	{ SSC_INPUT,        SSC_NUMBER,      "en_snow_model",                               "Toggle snow loss estimation",                          "0/1",      "",                              "snowmodel",            "?=0",                       "BOOLEAN",                      "" },
+	{ SSC_INPUT,        SSC_NUMBER,      "selfshade_table",                             "Self-shading geometry calculation",                    "0/1/2",    "0=direct,1=precomputed table,2=table checked against direct", "pvsamv1", "?=0",            "INTEGER,MIN=0,MAX=2",          "" },
+	{ SSC_INPUT,        SSC_NUMBER,      "inv_eff_table",                               "Inverter efficiency calculation",                      "0/1/2",    "0=inverter model,1=lookup table,2=lookup table checked against model", "pvsamv1", "?=0",   "INTEGER,MIN=0,MAX=2",          "" },
+	{ SSC_INPUT,        SSC_NUMBER,      "poa_decomp_nthreads",                         "Threads for POA input decomposition",                  "",         "0=all available cores",         "pvsamv1",              "?=1",                       "INTEGER,MIN=0",                "" },
 	{ SSC_INPUT,        SSC_NUMBER,      "system_capacity",                             "Nameplate capacity",                                   "kW",       "",                              "pvsamv1",              "*",                         "",                             "" },
 
 	{ SSC_INPUT,        SSC_NUMBER,      "use_wf_albedo",                               "Use albedo in weather file if provided",               "0/1",      "",                              "pvsamv1",              "?=1",                      "BOOLEAN",                       "" },
@@ -877,6 +882,23 @@ void cm_pvsamv1::exec( ) throw (compute_module::general_error)
 	int modules_per_string = PVSystem->modulesPerString;
 	SharedInverter * sharedInverter = PVSystem->m_sharedInverter.get();
 
+	// optional inverter efficiency lookup table over the MPPT voltage window, or 50-150% of the nominal DC voltage without one
+	int inv_eff_table = as_integer("inv_eff_table");
+	if (inv_eff_table > 0)
+	{
+		double vdc_min = as_double("mppt_low_inverter");
+		double vdc_max = as_double("mppt_hi_inverter");
+		if (vdc_min <= 0 || vdc_max <= vdc_min)
+		{
+			vdc_min = 0.5 * sharedInverter->getInverterDCNominalVoltage();
+			vdc_max = 1.5 * sharedInverter->getInverterDCNominalVoltage();
+		}
+		if (!sharedInverter->setupEfficiencyTable(vdc_min, vdc_max))
+			log("Inverter efficiency table could not be set up for this inverter model, the model is used directly.", SSC_WARNING);
+		else if (inv_eff_table == 2)
+			log(util::format("Inverter efficiency table check: maximum difference from the inverter model %lg %% points", sharedInverter->checkEfficiencyTable()), SSC_NOTICE);
+	}
+
 	double annual_snow_loss = 0;
 	
 	// SELF-SHADING MODULE INFORMATION
@@ -895,6 +917,27 @@ void cm_pvsamv1::exec( ) throw (compute_module::general_error)
 		Subarrays[nn]->selfShadingInputs.row_space = b / Subarrays[nn]->groundCoverageRatio;
 	}
 
+	// precomputed self-shading geometry for fixed tilt and non-backtracking one-axis subarrays.
+	// timeseries tilt varies independently of the sun, so it always uses the direct calculation
+	int selfshade_table = as_integer("selfshade_table");
+
+	// rear-side irradiance buffers and view factors for bifacial modules, kept between time steps
+	std::vector<rearSideWorkspace> rearSideWorkspaces(num_subarrays);
+	if (selfshade_table > 0)
+	{
+		for (size_t nn = 0; nn < num_subarrays; nn++)
+		{
+			if (!Subarrays[nn]->enable || (Subarrays[nn]->shadeMode != 1 && Subarrays[nn]->shadeMode != 2))
+				continue;
+			if (Subarrays[nn]->trackMode == 0
+				|| (Subarrays[nn]->trackMode == 1 && Subarrays[nn]->backtrackingEnabled == 0 && Subarrays[nn]->shadeMode == 1))
+			{
+				Subarrays[nn]->selfShadingTable.setup(Subarrays[nn]->selfShadingInputs, Subarrays[nn]->tiltDegrees, Subarrays[nn]->trackMode == 1);
+				Subarrays[nn]->selfShadingTable.enable_check(selfshade_table == 2);
+			}
+		}
+	}
+
 	double nameplate_kw = modules_per_string *  PVSystem->stringsInParallel * module_watts_stc * util::watt_to_kilowatt;
 
 	// Warning workaround
@@ -978,6 +1021,10 @@ void cm_pvsamv1::exec( ) throw (compute_module::general_error)
 			Subarrays[nn]->poa.poaAll.tilt = new double[ 8760*step_per_hour ];
 			Subarrays[nn]->poa.poaAll.zen = new double[ 8760*step_per_hour ];
 			Subarrays[nn]->poa.poaAll.exTer = new double[ 8760*step_per_hour ];
+			Subarrays[nn]->poa.poaAll.numberOfSteps = 8760*step_per_hour;
+			Subarrays[nn]->poa.poaAll.albedo.resize( 8760*step_per_hour );
+			Subarrays[nn]->poa.poaAll.dewPoint.resize( 8760*step_per_hour );
+			Subarrays[nn]->poa.poaAll.decomposed.resize( 8760*step_per_hour );
 					
 			for (size_t h=0; h<8760; h++){
 				for	(size_t m=0; m < step_per_hour; m++){
@@ -997,6 +1044,10 @@ void cm_pvsamv1::exec( ) throw (compute_module::general_error)
 						Subarrays[nn]->poa.poaAll.POA[ii] = wf.poa;
 					else
 						Subarrays[nn]->poa.poaAll.POA[ii] = -999;
+
+					// albedo and dew point as irrad will use them in the time step loop
+					Subarrays[nn]->poa.poaAll.albedo[ii] = irrad::get_albedo(wf, Irradiance->useWeatherFileAlbedo, Irradiance->userSpecifiedMonthlyAlbedo);
+					Subarrays[nn]->poa.poaAll.dewPoint[ii] = wf.tdew;
 						
 					// Calculate incident angle
 					double t_cur = wf.hour + wf.minute/60;
@@ -1079,6 +1130,38 @@ void cm_pvsamv1::exec( ) throw (compute_module::general_error)
 			}
 			wdprov->rewind();
 		}
+
+		// decompose the POA data a day at a time, splitting the days between threads
+		int poa_nthreads = chunk_thread_count(as_integer("poa_decomp_nthreads"), 365);
+
+		for (size_t nn = 0; nn < num_subarrays; nn++){
+			if (!Subarrays[nn]->enable) continue;
+
+			poaDecompReq *poaAll = &Subarrays[nn]->poa.poaAll;
+			std::vector<std::thread> threads;
+			for (int k = 1; k < poa_nthreads; k++)
+				threads.push_back(std::thread(poaDecompDays, poaAll, (size_t)(365 * k / poa_nthreads), (size_t)(365 * (k + 1) / poa_nthreads)));
+			poaDecompDays(poaAll, 0, (size_t)(365 / poa_nthreads));
+			for (size_t k = 0; k < threads.size(); k++)
+				threads[k].join();
+		}
+	}
+
+	// index the snow events in the weather file so that the snow model state machine only runs where there is snow on the ground
+	if (Subarrays[0]->enableShowModel)
+	{
+		std::vector<float> snowDepth(nrec);
+		for (size_t i = 0; i < nrec; i++)
+		{
+			if (!wdprov->read(&Irradiance->weatherRecord))
+				throw exec_error("pvsamv1", "could not read data line " + util::to_string((int)(i + 1)) + " in weather file");
+			snowDepth[i] = (float)Irradiance->weatherRecord.snow;
+		}
+		wdprov->rewind();
+
+		for (size_t nn = 0; nn < num_subarrays; nn++)
+			if (Subarrays[nn]->enable)
+				Subarrays[nn]->snowModel.setupSnowEvents(snowDepth);
 	}
 
 	/* *********************************************************************************************
@@ -1417,7 +1500,9 @@ void cm_pvsamv1::exec( ) throw (compute_module::general_error)
 							}
 						}
 
-						else if (ss_exec(Subarrays[nn]->selfShadingInputs, stilt, sazi, solzen, solazi, beam_to_use, ibeam, (iskydiff + ignddiff), alb, trackbool, linear, shad1xf, Subarrays[nn]->selfShadingOutputs))
+						else if (Subarrays[nn]->selfShadingTable.is_setup() ?
+							Subarrays[nn]->selfShadingTable.exec(Subarrays[nn]->selfShadingInputs, stilt, sazi, solzen, solazi, beam_to_use, ibeam, (iskydiff + ignddiff), alb, linear, shad1xf, Subarrays[nn]->selfShadingOutputs)
+							: ss_exec(Subarrays[nn]->selfShadingInputs, stilt, sazi, solzen, solazi, beam_to_use, ibeam, (iskydiff + ignddiff), alb, trackbool, linear, shad1xf, Subarrays[nn]->selfShadingOutputs))
 						{
 							if (linear) //fixed tilt linear
 							{
@@ -1485,7 +1570,7 @@ void cm_pvsamv1::exec( ) throw (compute_module::general_error)
 						if (Subarrays[nn]->selfShadingInputs.mod_orient == 1) {
 							slopeLength = Subarrays[nn]->selfShadingInputs.width * Subarrays[nn]->selfShadingInputs.nmody;
 						}
-						irr.calc_rear_side(Subarrays[0]->Module->bifacialTransmissionFactor, Subarrays[0]->Module->bifaciality, Subarrays[0]->Module->groundClearanceHeight, slopeLength);
+						irr.calc_rear_side(Subarrays[0]->Module->bifacialTransmissionFactor, Subarrays[0]->Module->bifaciality, Subarrays[0]->Module->groundClearanceHeight, slopeLength, rearSideWorkspaces[nn]);
 						ipoa_rear = irr.get_poa_rear();
 						ipoa_rear_after_losses = ipoa_rear * (1 - Subarrays[nn]->rearIrradianceLossPercent);
 					}
@@ -1534,35 +1619,45 @@ void cm_pvsamv1::exec( ) throw (compute_module::general_error)
 					double vmax = Subarrays[0]->Module->moduleModel->VocRef()*1.3; // maximum voltage
 					double vmin = 0.4 * vmax; // minimum voltage
 					const int NP = 100;
-					double V[NP], I[NP], P[NP];
+					double V[NP], I[NP], P[NP], Tc[NP];
 					double Pmax = 0;
-					// sweep voltage, calculating current for each subarray module, and adding
 					for (int i = 0; i < NP; i++)
 					{
 						V[i] = vmin + (vmax - vmin)*i / ((double)NP);
 						I[i] = 0;
-						for (int nn = 0; nn < 4; nn++)
+					}
+					// sweep voltage, calculating current for each subarray module over the whole sweep at once, and adding
+					pvinput_soa sweep_in;
+					pvoutput_soa sweep_out;
+					sweep_in.resize(NP);
+					for (int nn = 0; nn < 4; nn++)
+					{
+						if (!Subarrays[nn]->enable || Subarrays[nn]->nStrings < 1) continue; // skip disabled subarrays
+						if (!Subarrays[nn]->poa.sunUp) continue; // no current contribution
+
+						pvinput_t in(Subarrays[nn]->poa.poaBeamFront, Subarrays[nn]->poa.poaDiffuseFront, Subarrays[nn]->poa.poaGroundFront, Subarrays[nn]->poa.poaRear, Subarrays[nn]->poa.poaTotal,
+							wf.tdry, wf.tdew, wf.wspd, wf.wdir, wf.pres,
+							solzen, Subarrays[nn]->poa.angleOfIncidenceDegrees, hdr.elev,
+							Subarrays[nn]->poa.surfaceTiltDegrees, Subarrays[nn]->poa.surfaceAzimuthDegrees,
+							((double)wf.hour) + wf.minute / 60.0,
+							radmode, Subarrays[nn]->poa.usePOAFromWF);
+						sweep_out.resize(0);
+						sweep_out.resize(NP);
+						for (int i = 0; i < NP; i++)
 						{
-							if (!Subarrays[nn]->enable || Subarrays[nn]->nStrings < 1) continue; // skip disabled subarrays
-
-							pvinput_t in(Subarrays[nn]->poa.poaBeamFront, Subarrays[nn]->poa.poaDiffuseFront, Subarrays[nn]->poa.poaGroundFront, Subarrays[nn]->poa.poaRear, Subarrays[nn]->poa.poaTotal,
-								wf.tdry, wf.tdew, wf.wspd, wf.wdir, wf.pres,
-								solzen, Subarrays[nn]->poa.angleOfIncidenceDegrees, hdr.elev,
-								Subarrays[nn]->poa.surfaceTiltDegrees, Subarrays[nn]->poa.surfaceAzimuthDegrees,
-								((double)wf.hour) + wf.minute / 60.0,
-								radmode, Subarrays[nn]->poa.usePOAFromWF);
-							pvoutput_t out(0, 0, 0, 0, 0, 0, 0, 0);
-							if (Subarrays[nn]->poa.sunUp)
-							{
-								double tcell = wf.tdry;
-								// calculate cell temperature using selected temperature model
-								(*Subarrays[nn]->Module->cellTempModel)(in, *Subarrays[nn]->Module->moduleModel, V[i], tcell);
-								// calculate module power output using conversion model previously specified
-								(*Subarrays[nn]->Module->moduleModel)(in, tcell, V[i], out);
-							}
-							I[i] += out.Current;
+							sweep_in.set(i, in);
+							Tc[i] = wf.tdry;
 						}
+						// calculate cell temperature using selected temperature model
+						Subarrays[nn]->Module->cellTempModel->run_batch(sweep_in, *Subarrays[nn]->Module->moduleModel, V, Tc);
+						// calculate module power output using conversion model previously specified
+						Subarrays[nn]->Module->moduleModel->run_batch(sweep_in, Tc, V, sweep_out);
+						for (int i = 0; i < NP; i++)
+							I[i] += sweep_out.Current[i];
+					}
 
+					for (int i = 0; i < NP; i++)
+					{
 						P[i] = V[i] * I[i];
 						if (P[i] > Pmax)
 						{
@@ -1698,13 +1793,16 @@ void cm_pvsamv1::exec( ) throw (compute_module::general_error)
 					if (Subarrays[0]->enableShowModel)
 					{
 						float smLoss = 0.0f;
+						bool snowGood = true;
 
-						if (Subarrays[nn]->snowModel.getLoss((float)(Subarrays[nn]->poa.poaBeamFront + Subarrays[nn]->poa.poaDiffuseFront + Subarrays[nn]->poa.poaGroundFront),
-							(float)Subarrays[nn]->poa.surfaceTiltDegrees, (float)wf.wspd, (float)wf.tdry, (float)wf.snow, sunup, 1.0f / step_per_hour, &smLoss))
-						{
-							if (!Subarrays[nn]->snowModel.good)
-								throw exec_error("pvsamv1", Subarrays[nn]->snowModel.msg);
-						}
+						if (Subarrays[nn]->snowModel.isSnowEvent(idx))
+							snowGood = Subarrays[nn]->snowModel.getLoss((float)(Subarrays[nn]->poa.poaBeamFront + Subarrays[nn]->poa.poaDiffuseFront + Subarrays[nn]->poa.poaGroundFront),
+								(float)Subarrays[nn]->poa.surfaceTiltDegrees, (float)wf.wspd, (float)wf.tdry, (float)wf.snow, sunup, 1.0f / step_per_hour, &smLoss);
+						else
+							snowGood = Subarrays[nn]->snowModel.getLossSnowFree((float)wf.snow, &smLoss);
+
+						if (snowGood && !Subarrays[nn]->snowModel.good)
+							throw exec_error("pvsamv1", Subarrays[nn]->snowModel.msg);
 
 						if (iyear == 0)
 						{
@@ -1817,6 +1915,17 @@ void cm_pvsamv1::exec( ) throw (compute_module::general_error)
 		wdprov->rewind();
 	}
 
+	if (selfshade_table == 2)
+	{
+		for (size_t nn = 0; nn < num_subarrays; nn++)
+		{
+			if (!Subarrays[nn]->selfShadingTable.is_setup()) continue;
+			const ss_table_check &chk = Subarrays[nn]->selfShadingTable.check();
+			log(util::format("Self-shading table check for subarray %d: %d evaluations, %d differ by more than %lg. Maximum difference in dc derate %lg, diffuse derate %lg, reflected derate %lg, linear shade fraction %lg",
+				(int)(nn + 1), (int)chk.count, (int)chk.nexceed, chk.tolerance, chk.max_dc_derate, chk.max_diffuse_derate, chk.max_reflected_derate, chk.max_shade_frac), SSC_NOTICE);
+		}
+	}
+
 	// Initialize DC battery predictive controller
 	if (en_batt && (batt_topology == ChargeController::DC_CONNECTED))
 		batt.initialize_automated_dispatch(util::array_to_vector<ssc_number_t>(PVSystem->p_systemDCPower, nlifetime), p_load_full, p_invcliploss_full);
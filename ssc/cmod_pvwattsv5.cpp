@@ -179,19 +179,29 @@ public:
 
 	void setup_system_inputs()
 	{
-		dc_nameplate = as_double("system_capacity")*1000;
-		dc_ac_ratio = as_double("dc_ac_ratio");
+		setup_system( as_double("system_capacity"), as_double("dc_ac_ratio"), as_double("inv_eff"),
+			as_double("losses"), as_double("tilt"), as_double("azimuth"),
+			as_integer("module_type"), as_integer("array_type"),
+			is_assigned("gcr") ? as_double("gcr") : std::numeric_limits<double>::quiet_NaN() );
+	}
+
+	// gcr is only used for 1 axis trackers, NaN for the default
+	void setup_system( double system_capacity, double dc_ac, double inv_eff, double losses,
+		double tilt_deg, double azimuth_deg, int mod_type, int arr_type, double gcr_in )
+	{
+		dc_nameplate = system_capacity*1000;
+		dc_ac_ratio = dc_ac;
 		ac_nameplate = dc_nameplate / dc_ac_ratio;
-		inv_eff_percent = as_double("inv_eff");
+		inv_eff_percent = inv_eff;
 		
-		loss_percent = as_double("losses");        
-		tilt = as_double("tilt");
-		azimuth = as_double("azimuth");
+		loss_percent = losses;        
+		tilt = tilt_deg;
+		azimuth = azimuth_deg;
 
 		gamma = 0;
 		use_ar_glass = false;
 
-		module_type = as_integer("module_type");
+		module_type = mod_type;
 		switch( module_type )
 		{
 		case 0: // standard module
@@ -206,7 +216,7 @@ public:
 		inoct = 45;
 		shade_mode_1x = 0; // self shaded
 		
-		array_type = as_integer("array_type"); // 0, 1, 2, 3, 4		
+		array_type = arr_type; // 0, 1, 2, 3, 4		
 		switch( array_type )
 		{
 		case 0: // fixed open rack
@@ -225,11 +235,12 @@ public:
 
 		
 		gcr = 0.4;
-		if ( track_mode == 1 && is_assigned("gcr") ) gcr = as_double("gcr");
+		if ( track_mode == 1 && std::isfinite( gcr_in ) ) gcr = gcr_in;
 	}
 
 	void initialize_cell_temp( double ts_hour, double last_tcell = -9999, double last_poa = -9999 )
 	{
+		if ( tccalc ) delete tccalc;
 		tccalc = new pvwatts_celltemp ( inoct+273.15, PVWATTS_HEIGHT, ts_hour );
 		if ( last_tcell > -99 && last_poa >= 0 )
 			tccalc->set_last_values( last_tcell, last_poa );
@@ -258,6 +269,26 @@ public:
 		return code;
 	}
 
+	// same as above for a sun position already calculated at this location and time
+	int process_irradiance( const sunPosition &sun, double dn, double df, double alb )
+	{
+		irrad irr;
+		irr.set_sky_model(2, alb );
+		irr.set_beam_diffuse(dn, df);
+		irr.set_surface( track_mode, tilt, azimuth, 45.0, 
+			shade_mode_1x == 1, // backtracking mode
+			gcr );
+		irr.set_sun_position( sun );
+
+		int code = irr.calc_surface();
+
+		irr.get_sun( &solazi, &solzen, &solalt, 0, 0, 0, &sunup, 0, 0, 0 );		
+		irr.get_angles( &aoi, &stilt, &sazi, &rot, &btd );
+		irr.get_poa( &ibeam, &iskydiff, &ignddiff, 0, 0, 0);	
+
+		return code;
+	}
+
 	void powerout(double time, double &shad_beam, double shad_diff, double dni, double alb, double wspd, double tdry)
 	{
 		
@@ -601,17 +632,21 @@ static var_info _cm_vtab_pvwattsv5_1ts_weather[] = {
 	{ SSC_INPUT,        SSC_NUMBER,      "day",                      "Day",                                         "dy",     "1-days in month",         "PVWatts",      "*",                       "",                          "" },
 	{ SSC_INPUT,        SSC_NUMBER,      "hour",                     "Hour",                                        "hr",     "0-23",                    "PVWatts",      "*",                       "",                          "" },
 	{ SSC_INPUT,        SSC_NUMBER,      "minute",                   "Minute",                                      "min",    "0-59",                    "PVWatts",      "*",                       "",                          "" },
-	{ SSC_INPUT,        SSC_NUMBER,      "lat",                      "Latitude",                                    "deg",    "",                        "PVWatts",      "*",                        "",                      "" },
-	{ SSC_INPUT,        SSC_NUMBER,      "lon",                      "Longitude",                                   "deg",    "",                        "PVWatts",      "*",                        "",                      "" },
-	{ SSC_INPUT,        SSC_NUMBER,      "tz",                       "Time zone",                                   "hr",     "",                        "PVWatts",      "*",                        "",                      "" },
 	{ SSC_INPUT,        SSC_NUMBER,      "beam",                     "Beam normal irradiance",                      "W/m2",   "",                        "PVWatts",      "*",                       "",                          "" },
 	{ SSC_INPUT,        SSC_NUMBER,      "diffuse",                  "Diffuse irradiance",                          "W/m2",   "",                        "PVWatts",      "*",                       "",                          "" },
 	{ SSC_INPUT,        SSC_NUMBER,      "tamb",                     "Ambient temperature",                         "C",      "",                        "PVWatts",      "*",                       "",                          "" },
 	{ SSC_INPUT,        SSC_NUMBER,      "wspd",                     "Wind speed",                                  "m/s",    "",                        "PVWatts",      "*",                       "",                          "" },
 	{ SSC_INPUT,        SSC_NUMBER,      "alb",                      "Albedo",                                      "frac",     "",                      "PVWatts",      "?=0.2",                     "",                          "" },
-	{ SSC_INPUT,        SSC_NUMBER,      "time_step",                "Time step of input data",                     "hr",    "",                         "PVWatts",      "?=1",                     "POSITIVE",                  "" },
 	
 	var_info_invalid };
+
+static var_info _cm_vtab_pvwattsv5_1ts_location[] = {
+	{ SSC_INPUT,        SSC_NUMBER,      "lat",                      "Latitude",                                    "deg",    "",                        "PVWatts",      "*",                        "",                      "" },
+	{ SSC_INPUT,        SSC_NUMBER,      "lon",                      "Longitude",                                   "deg",    "",                        "PVWatts",      "*",                        "",                      "" },
+	{ SSC_INPUT,        SSC_NUMBER,      "tz",                       "Time zone",                                   "hr",     "",                        "PVWatts",      "*",                        "",                      "" },
+	{ SSC_INPUT,        SSC_NUMBER,      "time_step",                "Time step of input data",                     "hr",    "",                         "PVWatts",      "?=1",                     "POSITIVE",                  "" },
+
+	var_info_invalid };
 	
 static var_info _cm_vtab_pvwattsv5_1ts_outputs[] = {
 	/* input/output variable: tcell & poa from previous time must be given */
@@ -626,37 +661,56 @@ static var_info _cm_vtab_pvwattsv5_1ts_outputs[] = {
 
 class cm_pvwattsv5_1ts : public cm_pvwattsv5_base
 {
+	double lat, lon, tz;
+
 public:
 	
 	cm_pvwattsv5_1ts()
 	{
 		add_var_info( _cm_vtab_pvwattsv5_1ts_weather );
+		add_var_info( _cm_vtab_pvwattsv5_1ts_location );
 		add_var_info( _cm_vtab_pvwattsv5_common );
 		add_var_info( _cm_vtab_pvwattsv5_1ts_outputs );
+
+		// in a stepping session only the time and weather change, the cell
+		// temperature model keeps its own state between steps
+		add_step_var_info( _cm_vtab_pvwattsv5_1ts_weather );
+
+		lat = lon = tz = std::numeric_limits<double>::quiet_NaN();
 	}
 
 	void exec( ) throw( general_error )
+	{
+		session_setup();
+		session_exec();
+	}
+
+	void session_setup( ) throw( general_error )
+	{
+		lat = as_double("lat");
+		lon = as_double("lon");
+		tz = as_double("tz");
+		double time_step = as_double("time_step");
+
+		double last_tcell = as_double("tcell");
+		double last_poa = as_double("poa");
+
+		setup_system_inputs();
+		initialize_cell_temp( time_step, last_tcell, last_poa );
+	}
+
+	void session_exec( ) throw( general_error )
 	{	
 		int year = as_integer("year");
 		int month = as_integer("month");
 		int day = as_integer("day");
 		int hour = as_integer("hour");
 		double minute = as_double("minute");
-		double lat = as_double("lat");
-		double lon = as_double("lon");
-		double tz = as_double("tz");
 		double beam = as_double("beam");
 		double diff = as_double("diffuse");
 		double tamb = as_double("tamb");
 		double wspd = as_double("wspd");
 		double alb = as_double("alb");
-		double time_step = as_double("time_step");
-			
-		double last_tcell = as_double("tcell");
-		double last_poa = as_double("poa");
-
-		setup_system_inputs();
-		initialize_cell_temp( time_step, last_tcell, last_poa );
 		
 		int code = process_irradiance(year, month, day, hour, minute, 
 			IRRADPROC_NO_INTERPOLATE_SUNRISE_SUNSET,
@@ -676,3 +730,354 @@ public:
 };
 
 DEFINE_MODULE_ENTRY( pvwattsv5_1ts, "pvwattsv5_1ts- single timestep calculation of PV system performance.", 1 )
+
+
+
+/* *****************************************************************************
+			FLEET VERSION
+ ***************************************************************************** */
+
+
+static var_info _cm_vtab_pvwattsv5_fleet[] = {
+/*   VARTYPE           DATATYPE          NAME                         LABEL                                               UNITS        META                      GROUP          REQUIRED_IF                 CONSTRAINTS                      UI_HINTS*/
+	{ SSC_INPUT,        SSC_MATRIX,      "systems",                        "System configurations",                       "various",   "[SYSTEM_CAPACITY,MODULE_TYPE,DC_AC_RATIO,INV_EFF,LOSSES,ARRAY_TYPE,TILT,AZIMUTH,GCR], one row per system at the weather file location with the units and ranges of the pvwattsv5 inputs, GCR optional", "PVWatts Fleet", "*", "", "" },
+	{ SSC_INPUT,        SSC_NUMBER,      "aggregate_timeseries",           "Calculate the fleet total time series",       "0/1",       "",                           "PVWatts Fleet", "?=0",                       "BOOLEAN",                       "" },
+	{ SSC_INPUT,        SSC_NUMBER,      "nthreads",                       "Number of threads",                           "",          "0=all available cores",      "PVWatts Fleet", "?=0",                       "INTEGER,MIN=0",                 "" },
+
+	/* outputs */
+	{ SSC_OUTPUT,       SSC_ARRAY,       "annual_energy",                  "Annual energy",                               "kWh",       "one per system",             "Annual",        "*",                         "",                              "" },
+	{ SSC_OUTPUT,       SSC_MATRIX,      "monthly_energy",                 "Monthly energy",                              "kWh",       "one row of 12 months per system", "Monthly",   "*",                         "",                              "" },
+	{ SSC_OUTPUT,       SSC_ARRAY,       "capacity_factor",                "Capacity factor",                             "%",         "one per system",             "Annual",        "*",                         "",                              "" },
+	{ SSC_OUTPUT,       SSC_ARRAY,       "kwh_per_kw",                     "First year kWh/kW",                           "",          "one per system",             "Annual",        "*",                         "",                              "" },
+	{ SSC_OUTPUT,       SSC_NUMBER,      "fleet_annual_energy",            "Fleet annual energy",                         "kWh",       "",                           "Annual",        "*",                         "",                              "" },
+	{ SSC_OUTPUT,       SSC_ARRAY,       "gen",                            "Fleet power generated",                       "kW",        "",                           "Time Series",   "aggregate_timeseries=1",    "",                              "" },
+
+	{ SSC_OUTPUT,       SSC_STRING,      "location",                       "Location ID",                                 "",    "",                        "Location",      "*",                       "",                          "" },
+	{ SSC_OUTPUT,       SSC_STRING,      "city",                           "City",                                        "",    "",                        "Location",      "*",                       "",                          "" },
+	{ SSC_OUTPUT,       SSC_STRING,      "state",                          "State",                                       "",    "",                        "Location",      "*",                       "",                          "" },
+	{ SSC_OUTPUT,       SSC_NUMBER,      "lat",                            "Latitude",                                    "deg", "",                        "Location",      "*",                       "",                          "" },
+	{ SSC_OUTPUT,       SSC_NUMBER,      "lon",                            "Longitude",                                   "deg", "",                        "Location",      "*",                       "",                          "" },
+	{ SSC_OUTPUT,       SSC_NUMBER,      "tz",                             "Time zone",                                   "hr",  "",                        "Location",      "*",                       "",                          "" },
+	{ SSC_OUTPUT,       SSC_NUMBER,      "elev",                           "Site elevation",                              "m",   "",                        "Location",      "*",                       "",                          "" },
+	{ SSC_OUTPUT,       SSC_NUMBER,      "ts_shift_hours",                 "Time offset for interpreting time series outputs",  "hours", "",                 "Miscellaneous", "*",                       "",                          "" },
+
+	var_info_invalid };
+
+enum { FLEET_SYSTEM_CAPACITY, FLEET_MODULE_TYPE, FLEET_DC_AC_RATIO, FLEET_INV_EFF, FLEET_LOSSES, FLEET_ARRAY_TYPE, FLEET_TILT, FLEET_AZIMUTH, FLEET_GCR, FLEET_COLS };
+
+// Systems are simulated in chunks on a pool of threads. Fleet totals are summed within each chunk
+// and then over the chunks in order, so the results do not depend on the number of threads.
+static const size_t FLEET_CHUNK = 16;
+
+// weather data read once for the whole fleet
+struct fleet_weather_step
+{
+	int year, month, day, hour;
+	double minute, dn, df, tdry, wspd, alb;
+};
+
+// one system of the fleet, simulated with the pvwattsv5 model on the shared weather and sun position
+class pvwattsv5_fleet_system : public cm_pvwattsv5_base
+{
+public:
+	void exec( ) throw( general_error ) { }
+
+	// gen (kW) for each time step, as pvwattsv5 calculates it without shading. returns 0, or the
+	// irradiance processor code of the first time step that failed, with its index in 'ifail'
+	int simulate( const std::vector<fleet_weather_step> &weather, const std::vector<sunPosition> &sun,
+		const std::vector<float> &adjust, size_t step_per_hour, double ts_hour, std::vector<ssc_number_t> &gen, size_t &ifail )
+	{
+		initialize_cell_temp( ts_hour );
+
+		for( size_t idx=0;idx<weather.size();idx++ )
+		{
+			const fleet_weather_step &w = weather[idx];
+			gen[idx] = 0;
+
+			// beam irradiance above the extraterrestrial value was reported with the sun positions
+			int code = process_irradiance( sun[idx], w.dn, w.df, w.alb );
+			if ( code != 0 && code != -1 )
+			{
+				ifail = idx;
+				return code;
+			}
+
+			if ( sunup > 0 )
+			{
+				double shad_beam = 1.0;
+				powerout( (double)idx, shad_beam, 1.0, w.dn, w.alb, w.wspd, w.tdry );
+				gen[idx] = (ssc_number_t)(ac * adjust[idx/step_per_hour] * 0.001f); // W to kW
+			}
+		}
+		return 0;
+	}
+};
+
+class cm_pvwattsv5_fleet : public compute_module
+{
+public:
+
+	cm_pvwattsv5_fleet()
+	{
+		add_var_info( _cm_vtab_pvwattsv5_part1 );
+		add_var_info( _cm_vtab_pvwattsv5_fleet );
+		add_var_info( vtab_adjustment_factors );
+	}
+
+	void check_system( size_t r, const char *name, double value, double min, double max, bool integer = false )
+	{
+		if ( !(value >= min && value <= max) || (integer && value != (int)value) )
+			throw exec_error( "pvwattsv5_fleet", util::format("systems row %d: %s %lg must be %sbetween %lg and %lg",
+				(int)r, name, value, integer ? "an integer " : "", min, max) );
+	}
+
+	void exec( ) throw( general_error )
+	{
+		size_t nsys = 0, ncols = 0;
+		ssc_number_t *systems = as_matrix( "systems", &nsys, &ncols );
+		if ( ncols < FLEET_GCR || ncols > FLEET_COLS )
+			throw exec_error( "pvwattsv5_fleet", util::format("systems requires %d or %d columns: SYSTEM_CAPACITY,MODULE_TYPE,DC_AC_RATIO,INV_EFF,LOSSES,ARRAY_TYPE,TILT,AZIMUTH[,GCR]", FLEET_GCR, FLEET_COLS) );
+
+		std::unique_ptr<weather_data_provider> wdprov;
+
+		if ( is_assigned( "solar_resource_file" ) )
+		{
+			const char *file = as_string("solar_resource_file");
+			wdprov = std::unique_ptr<weather_data_provider>( new weatherfile( file ) );
+
+			weatherfile *wfile = dynamic_cast<weatherfile*>(wdprov.get());
+			if (!wfile->ok()) throw exec_error("pvwattsv5_fleet", wfile->message());
+			if( wfile->has_message() ) log( wfile->message(), SSC_WARNING);
+		}
+		else if ( is_assigned( "solar_resource_data" ) )
+		{
+			wdprov = std::unique_ptr<weather_data_provider>( new weatherdata( lookup("solar_resource_data") ) );
+		}
+		else
+			throw exec_error("pvwattsv5_fleet", "no weather data supplied");
+
+		weather_header hdr;
+		wdprov->header( &hdr );
+
+		// every system is at the weather file location, so they all share its irradiance and sun position
+		for( size_t r=0;r<nsys;r++ )
+		{
+			ssc_number_t *row = systems + r*ncols;
+			check_system( r, "SYSTEM_CAPACITY", row[FLEET_SYSTEM_CAPACITY], 1e-9, 1e12 );
+			check_system( r, "MODULE_TYPE", row[FLEET_MODULE_TYPE], 0, 2, true );
+			check_system( r, "DC_AC_RATIO", row[FLEET_DC_AC_RATIO], 1e-9, 1e12 );
+			check_system( r, "INV_EFF", row[FLEET_INV_EFF], 90, 99.5 );
+			check_system( r, "LOSSES", row[FLEET_LOSSES], -5, 99 );
+			check_system( r, "ARRAY_TYPE", row[FLEET_ARRAY_TYPE], 0, 4, true );
+			check_system( r, "TILT", row[FLEET_TILT], 0, 90 );
+			check_system( r, "AZIMUTH", row[FLEET_AZIMUTH], 0, 360 );
+			if ( row[FLEET_AZIMUTH] == 360 )
+				throw exec_error( "pvwattsv5_fleet", util::format("systems row %d: AZIMUTH must be less than 360, use 0 for north", (int)r) );
+			if ( ncols > FLEET_GCR )
+				check_system( r, "GCR", row[FLEET_GCR], 0, 3 );
+		}
+
+		// assumes instantaneous values, unless hourly file with no minute column specified
+		double ts_shift_hours = 0.0;
+		bool instantaneous = true;
+		if ( wdprov->has_data_column( weather_data_provider::MINUTE ) )
+		{
+			weather_record rec;
+			if ( wdprov->read( &rec ) )
+				ts_shift_hours = rec.minute/60.0;
+
+			wdprov->rewind();
+		}
+		else if ( wdprov->nrecords() == 8760 )
+		{
+			instantaneous = false;
+			ts_shift_hours = 0.5;
+		}
+		else
+			throw exec_error("pvwattsv5_fleet", "subhourly weather files must specify the minute for each record" );
+
+		assign( "ts_shift_hours", var_data( (ssc_number_t)ts_shift_hours ) );
+
+		size_t nrec = wdprov->nrecords();
+		size_t step_per_hour = nrec/8760;
+		if ( step_per_hour < 1 || step_per_hour > 60 || step_per_hour*8760 != nrec )
+			throw exec_error( "pvwattsv5_fleet", util::format("invalid number of data records (%d): must be an integer multiple of 8760", (int)nrec ) );
+
+		double ts_hour = 1.0/step_per_hour;
+
+		std::vector<fleet_weather_step> weather( nrec );
+		weather_record wf;
+		for( size_t idx=0;idx<nrec;idx++ )
+		{
+			if (!wdprov->read( &wf ))
+				throw exec_error("pvwattsv5_fleet", util::format("could not read data line %d of %d in weather file", (int)(idx+1), (int)nrec ));
+
+			fleet_weather_step &w = weather[idx];
+			w.year = wf.year;
+			w.month = wf.month;
+			w.day = wf.day;
+			w.hour = wf.hour;
+			w.minute = wf.minute;
+			w.dn = wf.dn;
+			w.df = wf.df;
+			w.tdry = wf.tdry;
+			w.wspd = wf.wspd;
+
+			w.alb = 0.2; // do not increase albedo if snow exists in TMY2
+			if ( std::isfinite( wf.alb ) && wf.alb > 0 && wf.alb < 1 )
+				w.alb = wf.alb;
+		}
+
+		adjustment_factors haf( this, "adjust" );
+		if ( !haf.setup() )
+			throw exec_error("pvwattsv5_fleet", "failed to setup adjustment factors: " + haf.error() );
+
+		std::vector<float> adjust( 8760 );
+		for( size_t h=0;h<8760;h++ )
+			adjust[h] = haf( h );
+
+		if ( !update( "calculating sun position", 0.0f ) )
+			throw exec_error("pvwattsv5_fleet", "simulation canceled");
+
+		// sun position a day at a time, checking the weather data as pvwattsv5 does
+		size_t step_per_day = 24*step_per_hour;
+		std::vector<sunPosition> sun( nrec );
+		std::vector<int> sun_code( nrec );
+
+		run_chunks( 365, chunk_thread_count( as_integer("nthreads"), 365 ), [&]( size_t k )
+		{
+			for( size_t idx=k*step_per_day;idx<(k+1)*step_per_day;idx++ )
+			{
+				const fleet_weather_step &w = weather[idx];
+				irrad irr;
+				irr.set_time( w.year, w.month, w.day, w.hour, w.minute,
+					instantaneous ? IRRADPROC_NO_INTERPOLATE_SUNRISE_SUNSET : ts_hour );
+				irr.set_location( hdr.lat, hdr.lon, hdr.tz );
+				irr.set_sky_model( 2, w.alb );
+				irr.set_beam_diffuse( w.dn, w.df );
+				irr.set_surface( 0, 0, 180, 45.0, false, 0.4 );
+				sun_code[idx] = irr.calc();
+				irr.get_sun_position( sun[idx] );
+			}
+		} );
+
+		for( size_t idx=0;idx<nrec;idx++ )
+		{
+			const fleet_weather_step &w = weather[idx];
+			if ( -1 == sun_code[idx] )
+			{
+				log(  util::format("beam irradiance exceeded extraterrestrial value at record [y:%d m:%d d:%d h:%d]", 
+						 w.year, w.month, w.day, w.hour) );
+			}
+			else if ( 0 != sun_code[idx] )
+				throw exec_error( "pvwattsv5_fleet", 
+					util::format("failed to process irradiation (code: %d) [y:%d m:%d d:%d h:%d]", 
+						sun_code[idx], w.year, w.month, w.day, w.hour));
+		}
+
+		if ( !update( "simulating systems", 10.0f ) )
+			throw exec_error("pvwattsv5_fleet", "simulation canceled");
+
+		ssc_number_t *p_annual = allocate( "annual_energy", nsys );
+		ssc_number_t *p_monthly = allocate( "monthly_energy", nsys, 12 );
+		ssc_number_t *p_cf = allocate( "capacity_factor", nsys );
+		ssc_number_t *p_kwhperkw = allocate( "kwh_per_kw", nsys );
+
+		bool aggregate = as_boolean( "aggregate_timeseries" );
+		size_t nchunks = (nsys + FLEET_CHUNK - 1)/FLEET_CHUNK;
+		std::vector< std::vector<double> > chunk_gen( aggregate ? nchunks : 0 );
+		std::vector< std::vector<compute_module::log_item> > messages( nsys );
+		std::vector<int> fail_code( nsys, 0 );
+		std::vector<size_t> fail_idx( nsys, 0 );
+
+		run_chunks( nchunks, chunk_thread_count( as_integer("nthreads"), nchunks ), [&]( size_t k )
+		{
+			std::vector<ssc_number_t> gen( nrec );
+			if ( aggregate )
+				chunk_gen[k].assign( nrec, 0.0 );
+
+			for( size_t i=k*FLEET_CHUNK;i<nsys && i<(k+1)*FLEET_CHUNK;i++ )
+			{
+				ssc_number_t *row = systems + i*ncols;
+				pvwattsv5_fleet_system pv;
+				pv.setup_system( row[FLEET_SYSTEM_CAPACITY], row[FLEET_DC_AC_RATIO], row[FLEET_INV_EFF],
+					row[FLEET_LOSSES], row[FLEET_TILT], row[FLEET_AZIMUTH],
+					(int)row[FLEET_MODULE_TYPE], (int)row[FLEET_ARRAY_TYPE],
+					ncols > FLEET_GCR ? row[FLEET_GCR] : std::numeric_limits<double>::quiet_NaN() );
+
+				// errors are thrown after the threads finish, for the first system that failed
+				fail_code[i] = pv.simulate( weather, sun, adjust, step_per_hour, ts_hour, gen, fail_idx[i] );
+				if ( fail_code[i] != 0 )
+					continue;
+
+				// annual and monthly totals summed as accumulate_annual and accumulate_monthly do for pvwattsv5
+				double annual_kwh = 0;
+				for( size_t idx=0;idx<nrec;idx++ )
+					annual_kwh += gen[idx];
+				p_annual[i] = (ssc_number_t)(annual_kwh*ts_hour);
+
+				size_t c = 0;
+				for( int m=0;m<12;m++ )
+				{
+					ssc_number_t monthly = 0;
+					for( size_t d=0;d<util::nday[m];d++ )
+						for( size_t j=0;j<24*step_per_hour;j++ )
+							monthly += gen[c++];
+					p_monthly[i*12+m] = monthly * (ssc_number_t)ts_hour;
+				}
+
+				double kWhperkW = 1000.0*annual_kwh / (row[FLEET_SYSTEM_CAPACITY]*1000);
+				kWhperkW *= ts_hour;
+				p_cf[i] = (ssc_number_t)(kWhperkW / 87.6);
+				p_kwhperkw[i] = (ssc_number_t)kWhperkW;
+
+				if ( aggregate )
+					for( size_t idx=0;idx<nrec;idx++ )
+						chunk_gen[k][idx] += gen[idx];
+
+				for( int j=0;pv.log(j) != 0;j++ )
+					messages[i].push_back( *pv.log(j) );
+			}
+		} );
+
+		for( size_t i=0;i<nsys;i++ )
+			for( size_t j=0;j<messages[i].size();j++ )
+				log( util::format("system %d: %s", (int)i, messages[i][j].text.c_str()), messages[i][j].type, messages[i][j].time );
+
+		for( size_t i=0;i<nsys;i++ )
+		{
+			if ( fail_code[i] == 0 ) continue;
+			const fleet_weather_step &w = weather[ fail_idx[i] ];
+			throw exec_error( "pvwattsv5_fleet", 
+				util::format("system %d: failed to process irradiation on surface (code: %d) [y:%d m:%d d:%d h:%d]", 
+					(int)i, fail_code[i], w.year, w.month, w.day, w.hour));
+		}
+
+		double fleet_kwh = 0;
+		for( size_t i=0;i<nsys;i++ )
+			fleet_kwh += p_annual[i];
+		assign( "fleet_annual_energy", var_data( (ssc_number_t)fleet_kwh ) );
+
+		if ( aggregate )
+		{
+			ssc_number_t *p_gen = allocate( "gen", nrec );
+			for( size_t idx=0;idx<nrec;idx++ )
+			{
+				double total = 0;
+				for( size_t k=0;k<nchunks;k++ )
+					total += chunk_gen[k][idx];
+				p_gen[idx] = (ssc_number_t)total;
+			}
+		}
+
+		assign( "location", var_data( hdr.location ) );
+		assign( "city", var_data( hdr.city ) );
+		assign( "state", var_data( hdr.state ) );
+		assign( "lat", var_data( (ssc_number_t)hdr.lat ) );
+		assign( "lon", var_data( (ssc_number_t)hdr.lon ) );
+		assign( "tz", var_data( (ssc_number_t)hdr.tz ) );
+		assign( "elev", var_data( (ssc_number_t)hdr.elev ) );
+	}
+};
+
+DEFINE_MODULE_ENTRY( pvwattsv5_fleet, "PVWatts V5 - fleet of PV systems sharing one weather file and sun position calculation, simulated in parallel.", 1 )
@@ -142,10 +142,16 @@ public:
 			}	
 		}
 
+		// only run the full state machine where there is snow on the ground
+		std::vector<float> snowDepth(sDep, sDep + 8760);
+		snowModule.setupSnowEvents(snowDepth);
+
 		float loss; 
 
 		for (int i = 0; i < 8760; i++){
-			if (!snowModule.getLoss(poa[i], tilt[i], wSpd[i], tAmb[i], sDep[i], (int)sunup[i], 1.0, &loss)){
+			bool isGood = snowModule.isSnowEvent(i) ? snowModule.getLoss(poa[i], tilt[i], wSpd[i], tAmb[i], sDep[i], (int)sunup[i], 1.0, &loss)
+				: snowModule.getLossSnowFree(sDep[i], &loss);
+			if (!isGood){
 				if (snowModule.good) log(snowModule.msg, SSC_WARNING);
 				else{
 					log(snowModule.msg, SSC_ERROR);
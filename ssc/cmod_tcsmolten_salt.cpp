@@ -250,6 +250,9 @@ static var_info _cm_vtab_tcsmolten_salt[] = {
 	{ SSC_INPUT,        SSC_NUMBER,      "fan_power_perc_net",   "% of net cycle output used for fan power at design",			      "%",	          "",            "sco2_pc",     "pc_config=2",                "",                      "" },	
 	{ SSC_INPUT,        SSC_NUMBER,      "sco2_T_amb_des",       "Ambient temperature at design point",                                      "C",     "",            "sco2_pc",     "pc_config=2",                "",                      "" },
 	{ SSC_INPUT,        SSC_NUMBER,      "sco2_T_approach",      "Temperature difference between main compressor CO2 inlet and ambient air", "C",     "",            "sco2_pc",     "pc_config=2",                "",                      "" },
+	{ SSC_INPUT,        SSC_NUMBER,      "is_sco2_od_surface",   "Interpolate sCO2 off-design from a cached surface of cycle solutions? 1 = yes", "-", "",            "sco2_pc",     "?=0",                        "INTEGER",               "" },
+	{ SSC_INPUT,        SSC_NUMBER,      "sco2_od_surface_tol",  "Max normalized interpolation error on sCO2 off-design surface",     "-",            "",            "sco2_pc",     "?=0.002",                    "POSITIVE",              "" },
+	{ SSC_INPUT,        SSC_STRING,      "sco2_od_surface_file", "File to save and reuse sCO2 off-design surface solutions",          "-",            "",            "sco2_pc",     "?",                          "",                      "" },
 		// sCO2 Powerblock pre-process
 	{ SSC_INPUT,        SSC_NUMBER,      "is_sco2_preprocess",       "Is sco2 off-design performance preprocessed? 1= yes",			                   "-",	                 "", "sco2_pc_pre",     "?=0",                        "",      "" },
 	{ SSC_INPUT,        SSC_NUMBER,      "sco2ud_T_htf_cold_calc",   "HTF cold temperature from sCO2 cycle des, may be different than T_htf_cold_des", "C",                  "", "sco2_pc_pre",     "is_sco2_preprocess=1",       "",      "" },
@@ -279,6 +282,10 @@ static var_info _cm_vtab_tcsmolten_salt[] = {
     { SSC_INPUT,        SSC_NUMBER,      "time_stop",            "Simulation stop time",                                              "s",            "",            "sys_ctrl",          "?=31536000",              "",                      "" },
     { SSC_INPUT,        SSC_NUMBER,      "time_steps_per_hour",  "Number of simulation time steps per hour",                          "-",            "",            "sys_ctrl",          "?=-1",                     "",                      "" },
     { SSC_INPUT,        SSC_NUMBER,      "vacuum_arrays",        "Allocate arrays for only the required number of steps",             "-",            "",            "sys_ctrl",          "?=0",                     "",                      "" },
+    { SSC_INPUT,        SSC_NUMBER,      "is_solver_warm_start", "Warm-start operating mode solvers from previous solutions",        "-",            "",            "sys_ctrl",          "?=0",                     "",                      "" },
+    { SSC_INPUT,        SSC_NUMBER,      "is_op_mode_profile",   "Record per-operating-mode solver profile outputs",                  "-",            "",            "sys_ctrl",          "?=0",                     "",                      "" },
+    { SSC_INPUT,        SSC_STRING,      "csp_output_subset",    "Comma separated ssc outputs to store in memory, empty = all",       "-",            "",            "sys_ctrl",          "?",                       "",                      "" },
+    { SSC_INPUT,        SSC_STRING,      "csp_output_csv_file",  "CSV file that all reported outputs are streamed to",                "-",            "",            "sys_ctrl",          "?",                       "",                      "" },
     { SSC_INPUT,        SSC_NUMBER,      "pb_fixed_par",         "Fixed parasitic load - runs at all times",                          "MWe/MWcap",    "",            "sys_ctrl",          "*",                       "",                      "" },
     { SSC_INPUT,        SSC_NUMBER,      "aux_par",              "Aux heater, boiler parasitic",                                      "MWe/MWcap",    "",            "sys_ctrl",          "*",                       "",                      "" },
     { SSC_INPUT,        SSC_NUMBER,      "aux_par_f",            "Aux heater, boiler parasitic - multiplying fraction",               "none",         "",            "sys_ctrl",          "*",                       "",                      "" },
@@ -487,6 +494,11 @@ static var_info _cm_vtab_tcsmolten_salt[] = {
 	{ SSC_OUTPUT,       SSC_ARRAY,       "op_mode_3",            "3rd op. mode, if applicable",                                  "",             "",            "Solver",        "*",                       "",           "" },
 	{ SSC_OUTPUT,       SSC_ARRAY,       "m_dot_balance",        "Relative mass flow balance error",                             "",             "",            "Controller",     "*",                       "",           "" },
 	{ SSC_OUTPUT,       SSC_ARRAY,       "q_balance",            "Relative energy balance error",                                "",             "",            "Controller",     "*",                       "",           "" },
+	{ SSC_OUTPUT,       SSC_ARRAY,       "op_mode_prof_n_calls", "Operating mode profile: number of times each mode was tried",  "",             "",            "Solver",         "",                        "",           "" },
+	{ SSC_OUTPUT,       SSC_ARRAY,       "op_mode_prof_n_rejected", "Operating mode profile: number of tries that did not converge", "",         "",            "Solver",         "",                        "",           "" },
+	{ SSC_OUTPUT,       SSC_ARRAY,       "op_mode_prof_n_iter",  "Operating mode profile: monotonic solver iterations",          "",             "",            "Solver",         "",                        "",           "" },
+	{ SSC_OUTPUT,       SSC_ARRAY,       "op_mode_prof_n_eq_calls", "Operating mode profile: monotonic equation calls",          "",             "",            "Solver",         "",                        "",           "" },
+	{ SSC_OUTPUT,       SSC_ARRAY,       "op_mode_prof_time",    "Operating mode profile: cumulative wall clock time",           "s",            "",            "Solver",         "",                        "",           "" },
 
     { SSC_OUTPUT,       SSC_ARRAY,       "disp_solve_state",     "Dispatch solver state",                                        "",             "",            "tou",            "*"                       "",            "" }, 
     { SSC_OUTPUT,       SSC_ARRAY,       "disp_solve_iter",      "Dispatch iterations count",                                    "",             "",            "tou",            "*"                       "",            "" }, 
@@ -1164,7 +1176,8 @@ public:
 
 				sco2_pc.ms_params.ms_mc_sco2_recomp_params = sco2_rc_csp_par;
 
-				bool is_preprocess_udpc = true;		// "is_preprocess_udpc"
+				// The cached off-design surface runs the sCO2 cycle model during the simulation instead of preprocessing UDPC tables
+				bool is_preprocess_udpc = as_integer("is_sco2_od_surface") != 1;		// "is_preprocess_udpc"
 
 				if (is_preprocess_udpc)
 				{
@@ -1358,6 +1371,11 @@ public:
 					sco2_pc.ms_params.m_startup_frac = as_double("startup_frac");				//[-]
 					sco2_pc.ms_params.m_htf_pump_coef = as_double("pb_pump_coef");				//[kW/kg/s]
 
+					sco2_pc.ms_params.m_is_od_surface = true;
+					sco2_pc.ms_params.m_od_surface_tol = as_double("sco2_od_surface_tol");		//[-]
+					if (is_assigned("sco2_od_surface_file"))
+						sco2_pc.ms_params.m_od_surface_file = as_string("sco2_od_surface_file");
+
 					p_csp_power_cycle = &sco2_pc;
 				}
 			}
@@ -1369,16 +1387,6 @@ public:
 			return;
 		}
 
-		// Set power cycle outputs common to all power cycle technologies
-		p_csp_power_cycle->assign(C_pc_Rankine_indirect_224::E_ETA_THERMAL, allocate("eta", n_steps_fixed), n_steps_fixed);
-		p_csp_power_cycle->assign(C_pc_Rankine_indirect_224::E_Q_DOT_HTF, allocate("q_pb", n_steps_fixed), n_steps_fixed);
-		p_csp_power_cycle->assign(C_pc_Rankine_indirect_224::E_M_DOT_HTF, allocate("m_dot_pc", n_steps_fixed), n_steps_fixed);
-		p_csp_power_cycle->assign(C_pc_Rankine_indirect_224::E_Q_DOT_STARTUP, allocate("q_dot_pc_startup", n_steps_fixed), n_steps_fixed);
-		p_csp_power_cycle->assign(C_pc_Rankine_indirect_224::E_W_DOT, allocate("P_cycle", n_steps_fixed), n_steps_fixed);
-		p_csp_power_cycle->assign(C_pc_Rankine_indirect_224::E_T_HTF_IN, allocate("T_pc_in", n_steps_fixed), n_steps_fixed);
-		p_csp_power_cycle->assign(C_pc_Rankine_indirect_224::E_T_HTF_OUT, allocate("T_pc_out", n_steps_fixed), n_steps_fixed);
-		p_csp_power_cycle->assign(C_pc_Rankine_indirect_224::E_M_DOT_WATER, allocate("m_dot_water_pc", n_steps_fixed), n_steps_fixed);
-
 
 
 
@@ -1505,23 +1513,54 @@ public:
 		// Then try init() call here, which should call inits from both classes
 		//collector_receiver.init();
 
+		// *******************************************************
+		// *******************************************************
+		// Optional subset of stored outputs and file that reported outputs are streamed to
+		csp_output_selector reported_outputs(this, n_steps_fixed);
+
+		// Outputs used in post-processing below are always stored
+		reported_outputs.keep("time_hr");
+		reported_outputs.keep("P_out_net");
+		reported_outputs.keep("m_dot_rec");
+		reported_outputs.keep("m_dot_tes_dc");
+		reported_outputs.keep("m_dot_tes_ch");
+		reported_outputs.keep("disp_objective");
+		reported_outputs.keep("disp_solve_iter");
+		reported_outputs.keep("disp_presolve_nconstr");
+		reported_outputs.keep("disp_presolve_nvar");
+		reported_outputs.keep("disp_solve_time");
+		reported_outputs.keep("P_cycle");
+		reported_outputs.keep("m_dot_pc");
+		reported_outputs.keep("q_dot_pc_startup");
+		reported_outputs.keep("m_dot_water_pc");
+
+		// Set power cycle outputs common to all power cycle technologies
+		reported_outputs.assign(*p_csp_power_cycle, C_pc_Rankine_indirect_224::E_ETA_THERMAL, "eta");
+		reported_outputs.assign(*p_csp_power_cycle, C_pc_Rankine_indirect_224::E_Q_DOT_HTF, "q_pb");
+		reported_outputs.assign(*p_csp_power_cycle, C_pc_Rankine_indirect_224::E_M_DOT_HTF, "m_dot_pc");
+		reported_outputs.assign(*p_csp_power_cycle, C_pc_Rankine_indirect_224::E_Q_DOT_STARTUP, "q_dot_pc_startup");
+		reported_outputs.assign(*p_csp_power_cycle, C_pc_Rankine_indirect_224::E_W_DOT, "P_cycle");
+		reported_outputs.assign(*p_csp_power_cycle, C_pc_Rankine_indirect_224::E_T_HTF_IN, "T_pc_in");
+		reported_outputs.assign(*p_csp_power_cycle, C_pc_Rankine_indirect_224::E_T_HTF_OUT, "T_pc_out");
+		reported_outputs.assign(*p_csp_power_cycle, C_pc_Rankine_indirect_224::E_M_DOT_WATER, "m_dot_water_pc");
+
 		// *******************************************************
 		// *******************************************************
 		// Set receiver outputs
 		//float *p_q_thermal_copy = allocate("Q_thermal_123", n_steps_fixed);
-		collector_receiver.mc_reported_outputs.assign(C_csp_mspt_collector_receiver::E_FIELD_Q_DOT_INC, allocate("q_sf_inc", n_steps_fixed), n_steps_fixed);
-		collector_receiver.mc_reported_outputs.assign(C_csp_mspt_collector_receiver::E_FIELD_ETA_OPT, allocate("eta_field", n_steps_fixed), n_steps_fixed);
-		collector_receiver.mc_reported_outputs.assign(C_csp_mspt_collector_receiver::E_FIELD_ADJUST, allocate("sf_adjust_out", n_steps_fixed), n_steps_fixed);
+		reported_outputs.assign(collector_receiver.mc_reported_outputs, C_csp_mspt_collector_receiver::E_FIELD_Q_DOT_INC, "q_sf_inc");
+		reported_outputs.assign(collector_receiver.mc_reported_outputs, C_csp_mspt_collector_receiver::E_FIELD_ETA_OPT, "eta_field");
+		reported_outputs.assign(collector_receiver.mc_reported_outputs, C_csp_mspt_collector_receiver::E_FIELD_ADJUST, "sf_adjust_out");
 
-		collector_receiver.mc_reported_outputs.assign(C_csp_mspt_collector_receiver::E_Q_DOT_INC, allocate("q_dot_rec_inc", n_steps_fixed), n_steps_fixed);
-		collector_receiver.mc_reported_outputs.assign(C_csp_mspt_collector_receiver::E_ETA_THERMAL, allocate("eta_therm", n_steps_fixed), n_steps_fixed);
-		collector_receiver.mc_reported_outputs.assign(C_csp_mspt_collector_receiver::E_Q_DOT_THERMAL, allocate("Q_thermal", n_steps_fixed), n_steps_fixed);
-		collector_receiver.mc_reported_outputs.assign(C_csp_mspt_collector_receiver::E_M_DOT_HTF, allocate("m_dot_rec", n_steps_fixed), n_steps_fixed);
-		collector_receiver.mc_reported_outputs.assign(C_csp_mspt_collector_receiver::E_Q_DOT_STARTUP, allocate("q_startup", n_steps_fixed), n_steps_fixed);
-		collector_receiver.mc_reported_outputs.assign(C_csp_mspt_collector_receiver::E_T_HTF_IN, allocate("T_rec_in", n_steps_fixed), n_steps_fixed);
-		collector_receiver.mc_reported_outputs.assign(C_csp_mspt_collector_receiver::E_T_HTF_OUT, allocate("T_rec_out", n_steps_fixed), n_steps_fixed);
-		collector_receiver.mc_reported_outputs.assign(C_csp_mspt_collector_receiver::E_Q_DOT_PIPE_LOSS, allocate("q_piping_losses", n_steps_fixed), n_steps_fixed);
-		collector_receiver.mc_reported_outputs.assign(C_csp_mspt_collector_receiver::E_Q_DOT_LOSS, allocate("q_thermal_loss", n_steps_fixed), n_steps_fixed);
+		reported_outputs.assign(collector_receiver.mc_reported_outputs, C_csp_mspt_collector_receiver::E_Q_DOT_INC, "q_dot_rec_inc");
+		reported_outputs.assign(collector_receiver.mc_reported_outputs, C_csp_mspt_collector_receiver::E_ETA_THERMAL, "eta_therm");
+		reported_outputs.assign(collector_receiver.mc_reported_outputs, C_csp_mspt_collector_receiver::E_Q_DOT_THERMAL, "Q_thermal");
+		reported_outputs.assign(collector_receiver.mc_reported_outputs, C_csp_mspt_collector_receiver::E_M_DOT_HTF, "m_dot_rec");
+		reported_outputs.assign(collector_receiver.mc_reported_outputs, C_csp_mspt_collector_receiver::E_Q_DOT_STARTUP, "q_startup");
+		reported_outputs.assign(collector_receiver.mc_reported_outputs, C_csp_mspt_collector_receiver::E_T_HTF_IN, "T_rec_in");
+		reported_outputs.assign(collector_receiver.mc_reported_outputs, C_csp_mspt_collector_receiver::E_T_HTF_OUT, "T_rec_out");
+		reported_outputs.assign(collector_receiver.mc_reported_outputs, C_csp_mspt_collector_receiver::E_Q_DOT_PIPE_LOSS, "q_piping_losses");
+		reported_outputs.assign(collector_receiver.mc_reported_outputs, C_csp_mspt_collector_receiver::E_Q_DOT_LOSS, "q_thermal_loss");
 
 
 		// Thermal energy storage 
@@ -1652,80 +1691,88 @@ public:
 						ssc_cmod_update,
 						(void*)(this));
 
+		if (as_boolean("is_solver_warm_start"))
+			csp_solver.mc_mono_eq_cache.enable(true);
+
+		if (as_boolean("is_op_mode_profile"))
+			csp_solver.enable_op_mode_profile();
+
+		csp_solver.set_output_sink(reported_outputs.get_sink());
+
 
 		// Set solver reporting outputs
-		csp_solver.mc_reported_outputs.assign(C_csp_solver::C_solver_outputs::TIME_FINAL, allocate("time_hr", n_steps_fixed), n_steps_fixed);
-		csp_solver.mc_reported_outputs.assign(C_csp_solver::C_solver_outputs::ERR_M_DOT, allocate("m_dot_balance", n_steps_fixed), n_steps_fixed);
-		csp_solver.mc_reported_outputs.assign(C_csp_solver::C_solver_outputs::ERR_Q_DOT, allocate("q_balance", n_steps_fixed), n_steps_fixed);
-		csp_solver.mc_reported_outputs.assign(C_csp_solver::C_solver_outputs::N_OP_MODES, allocate("n_op_modes", n_steps_fixed), n_steps_fixed);
-		csp_solver.mc_reported_outputs.assign(C_csp_solver::C_solver_outputs::OP_MODE_1, allocate("op_mode_1", n_steps_fixed), n_steps_fixed);
-		csp_solver.mc_reported_outputs.assign(C_csp_solver::C_solver_outputs::OP_MODE_2, allocate("op_mode_2", n_steps_fixed), n_steps_fixed);
-		csp_solver.mc_reported_outputs.assign(C_csp_solver::C_solver_outputs::OP_MODE_3, allocate("op_mode_3", n_steps_fixed), n_steps_fixed);
-
-
-		csp_solver.mc_reported_outputs.assign(C_csp_solver::C_solver_outputs::TOU_PERIOD, allocate("tou_value", n_steps_fixed), n_steps_fixed);            
-		csp_solver.mc_reported_outputs.assign(C_csp_solver::C_solver_outputs::PRICING_MULT, allocate("pricing_mult", n_steps_fixed), n_steps_fixed);
-		csp_solver.mc_reported_outputs.assign(C_csp_solver::C_solver_outputs::PC_Q_DOT_SB, allocate("q_dot_pc_sb", n_steps_fixed), n_steps_fixed);
-		csp_solver.mc_reported_outputs.assign(C_csp_solver::C_solver_outputs::PC_Q_DOT_MIN, allocate("q_dot_pc_min", n_steps_fixed), n_steps_fixed);
-		csp_solver.mc_reported_outputs.assign(C_csp_solver::C_solver_outputs::PC_Q_DOT_TARGET, allocate("q_dot_pc_target", n_steps_fixed), n_steps_fixed);
-		csp_solver.mc_reported_outputs.assign(C_csp_solver::C_solver_outputs::PC_Q_DOT_MAX, allocate("q_dot_pc_max", n_steps_fixed), n_steps_fixed);
+		reported_outputs.assign(csp_solver.mc_reported_outputs, C_csp_solver::C_solver_outputs::TIME_FINAL, "time_hr");
+		reported_outputs.assign(csp_solver.mc_reported_outputs, C_csp_solver::C_solver_outputs::ERR_M_DOT, "m_dot_balance");
+		reported_outputs.assign(csp_solver.mc_reported_outputs, C_csp_solver::C_solver_outputs::ERR_Q_DOT, "q_balance");
+		reported_outputs.assign(csp_solver.mc_reported_outputs, C_csp_solver::C_solver_outputs::N_OP_MODES, "n_op_modes");
+		reported_outputs.assign(csp_solver.mc_reported_outputs, C_csp_solver::C_solver_outputs::OP_MODE_1, "op_mode_1");
+		reported_outputs.assign(csp_solver.mc_reported_outputs, C_csp_solver::C_solver_outputs::OP_MODE_2, "op_mode_2");
+		reported_outputs.assign(csp_solver.mc_reported_outputs, C_csp_solver::C_solver_outputs::OP_MODE_3, "op_mode_3");
+
+
+		reported_outputs.assign(csp_solver.mc_reported_outputs, C_csp_solver::C_solver_outputs::TOU_PERIOD, "tou_value");            
+		reported_outputs.assign(csp_solver.mc_reported_outputs, C_csp_solver::C_solver_outputs::PRICING_MULT, "pricing_mult");
+		reported_outputs.assign(csp_solver.mc_reported_outputs, C_csp_solver::C_solver_outputs::PC_Q_DOT_SB, "q_dot_pc_sb");
+		reported_outputs.assign(csp_solver.mc_reported_outputs, C_csp_solver::C_solver_outputs::PC_Q_DOT_MIN, "q_dot_pc_min");
+		reported_outputs.assign(csp_solver.mc_reported_outputs, C_csp_solver::C_solver_outputs::PC_Q_DOT_TARGET, "q_dot_pc_target");
+		reported_outputs.assign(csp_solver.mc_reported_outputs, C_csp_solver::C_solver_outputs::PC_Q_DOT_MAX, "q_dot_pc_max");
 		
-		csp_solver.mc_reported_outputs.assign(C_csp_solver::C_solver_outputs::CTRL_IS_REC_SU, allocate("is_rec_su_allowed", n_steps_fixed), n_steps_fixed);
-		csp_solver.mc_reported_outputs.assign(C_csp_solver::C_solver_outputs::CTRL_IS_PC_SU, allocate("is_pc_su_allowed", n_steps_fixed), n_steps_fixed);
-		csp_solver.mc_reported_outputs.assign(C_csp_solver::C_solver_outputs::CTRL_IS_PC_SB, allocate("is_pc_sb_allowed", n_steps_fixed), n_steps_fixed);
-		csp_solver.mc_reported_outputs.assign(C_csp_solver::C_solver_outputs::EST_Q_DOT_CR_SU, allocate("q_dot_est_cr_su", n_steps_fixed), n_steps_fixed);
-		csp_solver.mc_reported_outputs.assign(C_csp_solver::C_solver_outputs::EST_Q_DOT_CR_ON, allocate("q_dot_est_cr_on", n_steps_fixed), n_steps_fixed);
-		csp_solver.mc_reported_outputs.assign(C_csp_solver::C_solver_outputs::EST_Q_DOT_DC, allocate("q_dot_est_tes_dc", n_steps_fixed), n_steps_fixed);
-		csp_solver.mc_reported_outputs.assign(C_csp_solver::C_solver_outputs::EST_Q_DOT_CH, allocate("q_dot_est_tes_ch", n_steps_fixed), n_steps_fixed);
+		reported_outputs.assign(csp_solver.mc_reported_outputs, C_csp_solver::C_solver_outputs::CTRL_IS_REC_SU, "is_rec_su_allowed");
+		reported_outputs.assign(csp_solver.mc_reported_outputs, C_csp_solver::C_solver_outputs::CTRL_IS_PC_SU, "is_pc_su_allowed");
+		reported_outputs.assign(csp_solver.mc_reported_outputs, C_csp_solver::C_solver_outputs::CTRL_IS_PC_SB, "is_pc_sb_allowed");
+		reported_outputs.assign(csp_solver.mc_reported_outputs, C_csp_solver::C_solver_outputs::EST_Q_DOT_CR_SU, "q_dot_est_cr_su");
+		reported_outputs.assign(csp_solver.mc_reported_outputs, C_csp_solver::C_solver_outputs::EST_Q_DOT_CR_ON, "q_dot_est_cr_on");
+		reported_outputs.assign(csp_solver.mc_reported_outputs, C_csp_solver::C_solver_outputs::EST_Q_DOT_DC, "q_dot_est_tes_dc");
+		reported_outputs.assign(csp_solver.mc_reported_outputs, C_csp_solver::C_solver_outputs::EST_Q_DOT_CH, "q_dot_est_tes_ch");
 		
-		csp_solver.mc_reported_outputs.assign(C_csp_solver::C_solver_outputs::CTRL_OP_MODE_SEQ_A, allocate("operating_modes_a", n_steps_fixed), n_steps_fixed);
-		csp_solver.mc_reported_outputs.assign(C_csp_solver::C_solver_outputs::CTRL_OP_MODE_SEQ_B, allocate("operating_modes_b", n_steps_fixed), n_steps_fixed);
-		csp_solver.mc_reported_outputs.assign(C_csp_solver::C_solver_outputs::CTRL_OP_MODE_SEQ_C, allocate("operating_modes_c", n_steps_fixed), n_steps_fixed);
+		reported_outputs.assign(csp_solver.mc_reported_outputs, C_csp_solver::C_solver_outputs::CTRL_OP_MODE_SEQ_A, "operating_modes_a");
+		reported_outputs.assign(csp_solver.mc_reported_outputs, C_csp_solver::C_solver_outputs::CTRL_OP_MODE_SEQ_B, "operating_modes_b");
+		reported_outputs.assign(csp_solver.mc_reported_outputs, C_csp_solver::C_solver_outputs::CTRL_OP_MODE_SEQ_C, "operating_modes_c");
 		
-		csp_solver.mc_reported_outputs.assign(C_csp_solver::C_solver_outputs::DISPATCH_SOLVE_STATE, allocate("disp_solve_state", n_steps_fixed), n_steps_fixed);
-		csp_solver.mc_reported_outputs.assign(C_csp_solver::C_solver_outputs::DISPATCH_SOLVE_ITER, allocate("disp_solve_iter", n_steps_fixed), n_steps_fixed);
-		csp_solver.mc_reported_outputs.assign(C_csp_solver::C_solver_outputs::DISPATCH_SOLVE_OBJ, allocate("disp_objective", n_steps_fixed), n_steps_fixed);
-		csp_solver.mc_reported_outputs.assign(C_csp_solver::C_solver_outputs::DISPATCH_SOLVE_OBJ_RELAX, allocate("disp_obj_relax", n_steps_fixed), n_steps_fixed);
-		csp_solver.mc_reported_outputs.assign(C_csp_solver::C_solver_outputs::DISPATCH_QSF_EXPECT, allocate("disp_qsf_expected", n_steps_fixed), n_steps_fixed);
-		csp_solver.mc_reported_outputs.assign(C_csp_solver::C_solver_outputs::DISPATCH_QSFPROD_EXPECT, allocate("disp_qsfprod_expected", n_steps_fixed), n_steps_fixed);
-		csp_solver.mc_reported_outputs.assign(C_csp_solver::C_solver_outputs::DISPATCH_QSFSU_EXPECT, allocate("disp_qsfsu_expected", n_steps_fixed), n_steps_fixed);
-		csp_solver.mc_reported_outputs.assign(C_csp_solver::C_solver_outputs::DISPATCH_TES_EXPECT, allocate("disp_tes_expected", n_steps_fixed), n_steps_fixed);
-		csp_solver.mc_reported_outputs.assign(C_csp_solver::C_solver_outputs::DISPATCH_PCEFF_EXPECT, allocate("disp_pceff_expected", n_steps_fixed), n_steps_fixed);
-		csp_solver.mc_reported_outputs.assign(C_csp_solver::C_solver_outputs::DISPATCH_SFEFF_EXPECT, allocate("disp_thermeff_expected", n_steps_fixed), n_steps_fixed);
-		csp_solver.mc_reported_outputs.assign(C_csp_solver::C_solver_outputs::DISPATCH_QPBSU_EXPECT, allocate("disp_qpbsu_expected", n_steps_fixed), n_steps_fixed);
-		csp_solver.mc_reported_outputs.assign(C_csp_solver::C_solver_outputs::DISPATCH_WPB_EXPECT, allocate("disp_wpb_expected", n_steps_fixed), n_steps_fixed);
-		csp_solver.mc_reported_outputs.assign(C_csp_solver::C_solver_outputs::DISPATCH_REV_EXPECT, allocate("disp_rev_expected", n_steps_fixed), n_steps_fixed);
-		csp_solver.mc_reported_outputs.assign(C_csp_solver::C_solver_outputs::DISPATCH_PRES_NCONSTR, allocate("disp_presolve_nconstr", n_steps_fixed), n_steps_fixed);
-		csp_solver.mc_reported_outputs.assign(C_csp_solver::C_solver_outputs::DISPATCH_PRES_NVAR, allocate("disp_presolve_nvar", n_steps_fixed), n_steps_fixed);
-		csp_solver.mc_reported_outputs.assign(C_csp_solver::C_solver_outputs::DISPATCH_SOLVE_TIME, allocate("disp_solve_time", n_steps_fixed), n_steps_fixed);
-
-		csp_solver.mc_reported_outputs.assign(C_csp_solver::C_solver_outputs::SOLZEN, allocate("solzen", n_steps_fixed), n_steps_fixed);
-		csp_solver.mc_reported_outputs.assign(C_csp_solver::C_solver_outputs::SOLAZ, allocate("solaz", n_steps_fixed), n_steps_fixed);
-		csp_solver.mc_reported_outputs.assign(C_csp_solver::C_solver_outputs::BEAM, allocate("beam", n_steps_fixed), n_steps_fixed);
-		csp_solver.mc_reported_outputs.assign(C_csp_solver::C_solver_outputs::TDRY, allocate("tdry", n_steps_fixed), n_steps_fixed);
-		csp_solver.mc_reported_outputs.assign(C_csp_solver::C_solver_outputs::TWET, allocate("twet", n_steps_fixed), n_steps_fixed);
-		csp_solver.mc_reported_outputs.assign(C_csp_solver::C_solver_outputs::RH, allocate("RH", n_steps_fixed), n_steps_fixed);
-		csp_solver.mc_reported_outputs.assign(C_csp_solver::C_solver_outputs::WSPD, allocate("wspd", n_steps_fixed), n_steps_fixed);
-		csp_solver.mc_reported_outputs.assign(C_csp_solver::C_solver_outputs::CR_DEFOCUS, allocate("defocus", n_steps_fixed), n_steps_fixed);
-
-		csp_solver.mc_reported_outputs.assign(C_csp_solver::C_solver_outputs::TES_Q_DOT_LOSS, allocate("tank_losses", n_steps_fixed), n_steps_fixed);
-		csp_solver.mc_reported_outputs.assign(C_csp_solver::C_solver_outputs::TES_W_DOT_HEATER, allocate("q_heater", n_steps_fixed), n_steps_fixed);
-		csp_solver.mc_reported_outputs.assign(C_csp_solver::C_solver_outputs::TES_T_HOT, allocate("T_tes_hot", n_steps_fixed), n_steps_fixed);
-		csp_solver.mc_reported_outputs.assign(C_csp_solver::C_solver_outputs::TES_T_COLD, allocate("T_tes_cold", n_steps_fixed), n_steps_fixed);
-		csp_solver.mc_reported_outputs.assign(C_csp_solver::C_solver_outputs::TES_Q_DOT_DC, allocate("q_dc_tes", n_steps_fixed), n_steps_fixed);
-		csp_solver.mc_reported_outputs.assign(C_csp_solver::C_solver_outputs::TES_Q_DOT_CH, allocate("q_ch_tes", n_steps_fixed), n_steps_fixed);
-		csp_solver.mc_reported_outputs.assign(C_csp_solver::C_solver_outputs::TES_E_CH_STATE, allocate("e_ch_tes", n_steps_fixed), n_steps_fixed);
-		csp_solver.mc_reported_outputs.assign(C_csp_solver::C_solver_outputs::TES_M_DOT_DC, allocate("m_dot_tes_dc", n_steps_fixed), n_steps_fixed);
-		csp_solver.mc_reported_outputs.assign(C_csp_solver::C_solver_outputs::TES_M_DOT_CH, allocate("m_dot_tes_ch", n_steps_fixed), n_steps_fixed);
-
-		csp_solver.mc_reported_outputs.assign(C_csp_solver::C_solver_outputs::COL_W_DOT_TRACK, allocate("pparasi", n_steps_fixed), n_steps_fixed);
-		csp_solver.mc_reported_outputs.assign(C_csp_solver::C_solver_outputs::CR_W_DOT_PUMP, allocate("P_tower_pump", n_steps_fixed), n_steps_fixed);
-		csp_solver.mc_reported_outputs.assign(C_csp_solver::C_solver_outputs::SYS_W_DOT_PUMP, allocate("htf_pump_power", n_steps_fixed), n_steps_fixed);
-		csp_solver.mc_reported_outputs.assign(C_csp_solver::C_solver_outputs::PC_W_DOT_COOLING, allocate("P_cooling_tower_tot", n_steps_fixed), n_steps_fixed);
-		csp_solver.mc_reported_outputs.assign(C_csp_solver::C_solver_outputs::SYS_W_DOT_FIXED, allocate("P_fixed", n_steps_fixed), n_steps_fixed);
-		csp_solver.mc_reported_outputs.assign(C_csp_solver::C_solver_outputs::SYS_W_DOT_BOP, allocate("P_plant_balance_tot", n_steps_fixed), n_steps_fixed);
-
-		csp_solver.mc_reported_outputs.assign(C_csp_solver::C_solver_outputs::W_DOT_NET, allocate("P_out_net", n_steps_fixed), n_steps_fixed);
+		reported_outputs.assign(csp_solver.mc_reported_outputs, C_csp_solver::C_solver_outputs::DISPATCH_SOLVE_STATE, "disp_solve_state");
+		reported_outputs.assign(csp_solver.mc_reported_outputs, C_csp_solver::C_solver_outputs::DISPATCH_SOLVE_ITER, "disp_solve_iter");
+		reported_outputs.assign(csp_solver.mc_reported_outputs, C_csp_solver::C_solver_outputs::DISPATCH_SOLVE_OBJ, "disp_objective");
+		reported_outputs.assign(csp_solver.mc_reported_outputs, C_csp_solver::C_solver_outputs::DISPATCH_SOLVE_OBJ_RELAX, "disp_obj_relax");
+		reported_outputs.assign(csp_solver.mc_reported_outputs, C_csp_solver::C_solver_outputs::DISPATCH_QSF_EXPECT, "disp_qsf_expected");
+		reported_outputs.assign(csp_solver.mc_reported_outputs, C_csp_solver::C_solver_outputs::DISPATCH_QSFPROD_EXPECT, "disp_qsfprod_expected");
+		reported_outputs.assign(csp_solver.mc_reported_outputs, C_csp_solver::C_solver_outputs::DISPATCH_QSFSU_EXPECT, "disp_qsfsu_expected");
+		reported_outputs.assign(csp_solver.mc_reported_outputs, C_csp_solver::C_solver_outputs::DISPATCH_TES_EXPECT, "disp_tes_expected");
+		reported_outputs.assign(csp_solver.mc_reported_outputs, C_csp_solver::C_solver_outputs::DISPATCH_PCEFF_EXPECT, "disp_pceff_expected");
+		reported_outputs.assign(csp_solver.mc_reported_outputs, C_csp_solver::C_solver_outputs::DISPATCH_SFEFF_EXPECT, "disp_thermeff_expected");
+		reported_outputs.assign(csp_solver.mc_reported_outputs, C_csp_solver::C_solver_outputs::DISPATCH_QPBSU_EXPECT, "disp_qpbsu_expected");
+		reported_outputs.assign(csp_solver.mc_reported_outputs, C_csp_solver::C_solver_outputs::DISPATCH_WPB_EXPECT, "disp_wpb_expected");
+		reported_outputs.assign(csp_solver.mc_reported_outputs, C_csp_solver::C_solver_outputs::DISPATCH_REV_EXPECT, "disp_rev_expected");
+		reported_outputs.assign(csp_solver.mc_reported_outputs, C_csp_solver::C_solver_outputs::DISPATCH_PRES_NCONSTR, "disp_presolve_nconstr");
+		reported_outputs.assign(csp_solver.mc_reported_outputs, C_csp_solver::C_solver_outputs::DISPATCH_PRES_NVAR, "disp_presolve_nvar");
+		reported_outputs.assign(csp_solver.mc_reported_outputs, C_csp_solver::C_solver_outputs::DISPATCH_SOLVE_TIME, "disp_solve_time");
+
+		reported_outputs.assign(csp_solver.mc_reported_outputs, C_csp_solver::C_solver_outputs::SOLZEN, "solzen");
+		reported_outputs.assign(csp_solver.mc_reported_outputs, C_csp_solver::C_solver_outputs::SOLAZ, "solaz");
+		reported_outputs.assign(csp_solver.mc_reported_outputs, C_csp_solver::C_solver_outputs::BEAM, "beam");
+		reported_outputs.assign(csp_solver.mc_reported_outputs, C_csp_solver::C_solver_outputs::TDRY, "tdry");
+		reported_outputs.assign(csp_solver.mc_reported_outputs, C_csp_solver::C_solver_outputs::TWET, "twet");
+		reported_outputs.assign(csp_solver.mc_reported_outputs, C_csp_solver::C_solver_outputs::RH, "RH");
+		reported_outputs.assign(csp_solver.mc_reported_outputs, C_csp_solver::C_solver_outputs::WSPD, "wspd");
+		reported_outputs.assign(csp_solver.mc_reported_outputs, C_csp_solver::C_solver_outputs::CR_DEFOCUS, "defocus");
+
+		reported_outputs.assign(csp_solver.mc_reported_outputs, C_csp_solver::C_solver_outputs::TES_Q_DOT_LOSS, "tank_losses");
+		reported_outputs.assign(csp_solver.mc_reported_outputs, C_csp_solver::C_solver_outputs::TES_W_DOT_HEATER, "q_heater");
+		reported_outputs.assign(csp_solver.mc_reported_outputs, C_csp_solver::C_solver_outputs::TES_T_HOT, "T_tes_hot");
+		reported_outputs.assign(csp_solver.mc_reported_outputs, C_csp_solver::C_solver_outputs::TES_T_COLD, "T_tes_cold");
+		reported_outputs.assign(csp_solver.mc_reported_outputs, C_csp_solver::C_solver_outputs::TES_Q_DOT_DC, "q_dc_tes");
+		reported_outputs.assign(csp_solver.mc_reported_outputs, C_csp_solver::C_solver_outputs::TES_Q_DOT_CH, "q_ch_tes");
+		reported_outputs.assign(csp_solver.mc_reported_outputs, C_csp_solver::C_solver_outputs::TES_E_CH_STATE, "e_ch_tes");
+		reported_outputs.assign(csp_solver.mc_reported_outputs, C_csp_solver::C_solver_outputs::TES_M_DOT_DC, "m_dot_tes_dc");
+		reported_outputs.assign(csp_solver.mc_reported_outputs, C_csp_solver::C_solver_outputs::TES_M_DOT_CH, "m_dot_tes_ch");
+
+		reported_outputs.assign(csp_solver.mc_reported_outputs, C_csp_solver::C_solver_outputs::COL_W_DOT_TRACK, "pparasi");
+		reported_outputs.assign(csp_solver.mc_reported_outputs, C_csp_solver::C_solver_outputs::CR_W_DOT_PUMP, "P_tower_pump");
+		reported_outputs.assign(csp_solver.mc_reported_outputs, C_csp_solver::C_solver_outputs::SYS_W_DOT_PUMP, "htf_pump_power");
+		reported_outputs.assign(csp_solver.mc_reported_outputs, C_csp_solver::C_solver_outputs::PC_W_DOT_COOLING, "P_cooling_tower_tot");
+		reported_outputs.assign(csp_solver.mc_reported_outputs, C_csp_solver::C_solver_outputs::SYS_W_DOT_FIXED, "P_fixed");
+		reported_outputs.assign(csp_solver.mc_reported_outputs, C_csp_solver::C_solver_outputs::SYS_W_DOT_BOP, "P_plant_balance_tot");
+
+		reported_outputs.assign(csp_solver.mc_reported_outputs, C_csp_solver::C_solver_outputs::W_DOT_NET, "P_out_net");
 
 
 
@@ -1802,6 +1849,9 @@ public:
 			log(out_msg, out_type);
 		}
 
+		// Per-operating-mode solver profile, if requested
+		csp_op_mode_profile_outputs(this, csp_solver);
+
 		// ******* Re-calculate system costs here ************
 		C_mspt_system_costs sys_costs;
 
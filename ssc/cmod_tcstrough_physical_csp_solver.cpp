@@ -60,6 +60,7 @@
 #include "csp_solver_two_tank_tes.h"
 #include "csp_solver_tou_block_schedules.h"
 #include "csp_solver_core.h"
+#include "csp_output_selector.h"
 
 static var_info _cm_vtab_trough_physical_csp_solver[] = {
 //   weather reader inputs
@@ -107,6 +108,7 @@ static var_info _cm_vtab_trough_physical_csp_solver[] = {
 	{ SSC_INPUT,        SSC_NUMBER,      "washing_frequency",         "Mirror washing frequency",                                                         "none",         "",               "solar_field",    "*",                       "",                      "" },
 	{ SSC_INPUT,        SSC_NUMBER,      "accept_mode",               "Acceptance testing mode?",                                                         "0/1",          "no/yes",         "solar_field",    "*",                       "",                      "" },
     { SSC_INPUT,        SSC_NUMBER,      "accept_init",               "In acceptance testing mode - require steady-state startup",                        "none",         "",               "solar_field",    "*",                       "",                      "" },
+    { SSC_INPUT,        SSC_NUMBER,      "use_hce_heat_loss_table",   "Interpolate HCE heat loss from tables generated at initialization",              "none",         "0=full receiver energy balance, 1=tables with fallback to energy balance", "solar_field", "?=0", "INTEGER,MIN=0,MAX=1", "" },
     { SSC_INPUT,        SSC_NUMBER,      "accept_loc",                "In acceptance testing mode - temperature sensor location",                         "1/2",          "hx/loop",        "solar_field",    "*",                       "",                      "" },
     { SSC_INPUT,        SSC_NUMBER,      "solar_mult",                "Solar multiple",                                                                   "none",         "",               "solar_field",    "*",                       "",                      "" },
     { SSC_INPUT,        SSC_NUMBER,      "mc_bal_hot",                "Heat capacity of the balance of plant on the hot side",                            "kWht/K-MWt",   "none",           "solar_field",    "*",                       "",                      "" },
@@ -208,6 +210,10 @@ static var_info _cm_vtab_trough_physical_csp_solver[] = {
     { SSC_INPUT,        SSC_ARRAY,       "tslogic_b",                 "Dispatch logic with solar",                                      "-",            "",             "controller",     "*",                       "",                      "" },
     { SSC_INPUT,        SSC_ARRAY,       "tslogic_c",                 "Dispatch logic for turbine load fraction",                       "-",            "",             "controller",     "*",                       "",                      "" },
     { SSC_INPUT,        SSC_ARRAY,       "ffrac",                     "Fossil dispatch logic",                                          "-",            "",             "controller",     "*",                       "",                      "" },
+    { SSC_INPUT,        SSC_NUMBER,      "is_solver_warm_start",     "Warm-start operating mode solvers from previous solutions",      "-",            "",             "controller",     "?=0",                     "",                      "" },
+    { SSC_INPUT,        SSC_NUMBER,      "is_op_mode_profile",        "Record per-operating-mode solver profile outputs",               "-",            "",             "controller",     "?=0",                     "",                      "" },
+    { SSC_INPUT,        SSC_STRING,      "csp_output_subset",         "Comma separated ssc outputs to store in memory, empty = all",    "-",            "",             "controller",     "?",                       "",                      "" },
+    { SSC_INPUT,        SSC_STRING,      "csp_output_csv_file",       "CSV file that all reported outputs are streamed to",             "-",            "",             "controller",     "?",                       "",                      "" },
     { SSC_INPUT,        SSC_NUMBER,      "tc_fill",                   "Thermocline fill material",                                      "-",            "",             "controller",     "*",                       "",                      "" },
     { SSC_INPUT,        SSC_NUMBER,      "tc_void",                   "Thermocline void fraction",                                      "-",            "",             "controller",     "*",                       "",                      "" },
     { SSC_INPUT,        SSC_NUMBER,      "t_dis_out_min",             "Min allowable hot side outlet temp during discharge",            "C",            "",             "controller",     "*",                       "",                      "" },
@@ -334,6 +340,11 @@ static var_info _cm_vtab_trough_physical_csp_solver[] = {
 	{ SSC_OUTPUT,       SSC_ARRAY,       "op_mode_3",            "3rd op. mode, if applicable",                                  "",             "",            "Solver",        "",                       "",           "" },
 	{ SSC_OUTPUT,       SSC_ARRAY,       "m_dot_balance",        "Relative mass flow balance error",                             "",             "",            "Controller",    "",                       "",           "" },
 	{ SSC_OUTPUT,       SSC_ARRAY,       "q_balance",            "Relative energy balance error",                                "",             "",            "Controller",    "",                       "",           "" },
+	{ SSC_OUTPUT,       SSC_ARRAY,       "op_mode_prof_n_calls", "Operating mode profile: number of times each mode was tried",  "",             "",            "Solver",        "",                       "",           "" },
+	{ SSC_OUTPUT,       SSC_ARRAY,       "op_mode_prof_n_rejected", "Operating mode profile: number of tries that did not converge", "",         "",            "Solver",        "",                       "",           "" },
+	{ SSC_OUTPUT,       SSC_ARRAY,       "op_mode_prof_n_iter",  "Operating mode profile: monotonic solver iterations",          "",             "",            "Solver",        "",                       "",           "" },
+	{ SSC_OUTPUT,       SSC_ARRAY,       "op_mode_prof_n_eq_calls", "Operating mode profile: monotonic equation calls",          "",             "",            "Solver",        "",                       "",           "" },
+	{ SSC_OUTPUT,       SSC_ARRAY,       "op_mode_prof_time",    "Operating mode profile: cumulative wall clock time",           "s",            "",            "Solver",        "",                       "",           "" },
 
     { SSC_OUTPUT,       SSC_ARRAY,       "disp_solve_state",     "Dispatch solver state",                                        "",             "",            "tou",            ""                       "",            "" }, 
     { SSC_OUTPUT,       SSC_ARRAY,       "disp_solve_iter",      "Dispatch iterations count",                                    "",             "",            "tou",            ""                       "",            "" }, 
@@ -467,6 +478,7 @@ public:
 		c_trough.m_ColAz = as_double("azimuth"); 					//[deg] Collector azimuth angle
 		c_trough.m_accept_mode = as_integer("accept_mode");			//[-] Acceptance testing mode? (1=yes, 0=no)
 		c_trough.m_accept_init = as_boolean("accept_init");			//[-] In acceptance testing mode - require steady-state startup
+		c_trough.m_use_hce_heat_loss_table = as_boolean("use_hce_heat_loss_table");	//[-] Interpolate HCE heat loss from tables generated at initialization
 		c_trough.m_solar_mult = as_double("solar_mult");			//[-] Solar Multiple
 		c_trough.m_mc_bal_hot_per_MW = as_double("mc_bal_hot");     //[kWht/K-MWt] The heat capacity of the balance of plant on the hot side
 		c_trough.m_mc_bal_cold_per_MW = as_double("mc_bal_cold");	//[kWht/K-MWt] The heat capacity of the balance of plant on the cold side
@@ -892,77 +904,93 @@ public:
 		// Instantiate Solver
 		C_csp_solver csp_solver(weather_reader, c_trough, power_cycle, storage, tou, system);
 
+		if (as_boolean("is_solver_warm_start"))
+			csp_solver.mc_mono_eq_cache.enable(true);
+
+		if (as_boolean("is_op_mode_profile"))
+			csp_solver.enable_op_mode_profile();
+
+		// Optional subset of stored outputs and file that reported outputs are streamed to
+		csp_output_selector reported_outputs(this, n_steps_fixed);
+
+		csp_solver.set_output_sink(reported_outputs.get_sink());
+
+		// Set power cycle outputs
+		reported_outputs.assign(power_cycle, C_pc_Rankine_indirect_224::E_Q_DOT_HTF, "q_pb");
+		reported_outputs.assign(power_cycle, C_pc_Rankine_indirect_224::E_M_DOT_HTF, "m_dot_pc");
+		reported_outputs.assign(power_cycle, C_pc_Rankine_indirect_224::E_Q_DOT_STARTUP, "q_dot_pc_startup");
+
 		// Set solver reporting outputs
-		csp_solver.mc_reported_outputs.assign(C_csp_solver::C_solver_outputs::TIME_FINAL, allocate("time_hr", n_steps_fixed), n_steps_fixed);
-		csp_solver.mc_reported_outputs.assign(C_csp_solver::C_solver_outputs::ERR_M_DOT, allocate("m_dot_balance", n_steps_fixed), n_steps_fixed);
-		csp_solver.mc_reported_outputs.assign(C_csp_solver::C_solver_outputs::ERR_Q_DOT, allocate("q_balance", n_steps_fixed), n_steps_fixed);
-		csp_solver.mc_reported_outputs.assign(C_csp_solver::C_solver_outputs::N_OP_MODES, allocate("n_op_modes", n_steps_fixed), n_steps_fixed);
-		csp_solver.mc_reported_outputs.assign(C_csp_solver::C_solver_outputs::OP_MODE_1, allocate("op_mode_1", n_steps_fixed), n_steps_fixed);
-		csp_solver.mc_reported_outputs.assign(C_csp_solver::C_solver_outputs::OP_MODE_2, allocate("op_mode_2", n_steps_fixed), n_steps_fixed);
-		csp_solver.mc_reported_outputs.assign(C_csp_solver::C_solver_outputs::OP_MODE_3, allocate("op_mode_3", n_steps_fixed), n_steps_fixed);
-
-		csp_solver.mc_reported_outputs.assign(C_csp_solver::C_solver_outputs::TOU_PERIOD, allocate("tou_value", n_steps_fixed), n_steps_fixed);
-		csp_solver.mc_reported_outputs.assign(C_csp_solver::C_solver_outputs::PRICING_MULT, allocate("pricing_mult", n_steps_fixed), n_steps_fixed);
-		csp_solver.mc_reported_outputs.assign(C_csp_solver::C_solver_outputs::PC_Q_DOT_SB, allocate("q_dot_pc_sb", n_steps_fixed), n_steps_fixed);
-		csp_solver.mc_reported_outputs.assign(C_csp_solver::C_solver_outputs::PC_Q_DOT_MIN, allocate("q_dot_pc_min", n_steps_fixed), n_steps_fixed);
-		csp_solver.mc_reported_outputs.assign(C_csp_solver::C_solver_outputs::PC_Q_DOT_TARGET, allocate("q_dot_pc_max", n_steps_fixed), n_steps_fixed);
-		csp_solver.mc_reported_outputs.assign(C_csp_solver::C_solver_outputs::PC_Q_DOT_MAX, allocate("q_dot_pc_target", n_steps_fixed), n_steps_fixed);
-
-		csp_solver.mc_reported_outputs.assign(C_csp_solver::C_solver_outputs::CTRL_IS_REC_SU, allocate("is_rec_su_allowed", n_steps_fixed), n_steps_fixed);
-		csp_solver.mc_reported_outputs.assign(C_csp_solver::C_solver_outputs::CTRL_IS_PC_SU, allocate("is_pc_su_allowed", n_steps_fixed), n_steps_fixed);
-		csp_solver.mc_reported_outputs.assign(C_csp_solver::C_solver_outputs::CTRL_IS_PC_SB, allocate("is_pc_sb_allowed", n_steps_fixed), n_steps_fixed);
-		csp_solver.mc_reported_outputs.assign(C_csp_solver::C_solver_outputs::EST_Q_DOT_CR_SU, allocate("q_dot_est_cr_su", n_steps_fixed), n_steps_fixed);
-		csp_solver.mc_reported_outputs.assign(C_csp_solver::C_solver_outputs::EST_Q_DOT_CR_ON, allocate("q_dot_est_cr_on", n_steps_fixed), n_steps_fixed);
-		csp_solver.mc_reported_outputs.assign(C_csp_solver::C_solver_outputs::EST_Q_DOT_DC, allocate("q_dot_est_tes_dc", n_steps_fixed), n_steps_fixed);
-		csp_solver.mc_reported_outputs.assign(C_csp_solver::C_solver_outputs::EST_Q_DOT_CH, allocate("q_dot_est_tes_ch", n_steps_fixed), n_steps_fixed);
-
-		csp_solver.mc_reported_outputs.assign(C_csp_solver::C_solver_outputs::CTRL_OP_MODE_SEQ_A, allocate("operating_modes_a", n_steps_fixed), n_steps_fixed);
-		csp_solver.mc_reported_outputs.assign(C_csp_solver::C_solver_outputs::CTRL_OP_MODE_SEQ_B, allocate("operating_modes_b", n_steps_fixed), n_steps_fixed);
-		csp_solver.mc_reported_outputs.assign(C_csp_solver::C_solver_outputs::CTRL_OP_MODE_SEQ_C, allocate("operating_modes_c", n_steps_fixed), n_steps_fixed);
-
-		csp_solver.mc_reported_outputs.assign(C_csp_solver::C_solver_outputs::DISPATCH_SOLVE_STATE, allocate("disp_solve_state", n_steps_fixed), n_steps_fixed);
-		csp_solver.mc_reported_outputs.assign(C_csp_solver::C_solver_outputs::DISPATCH_SOLVE_ITER, allocate("disp_solve_iter", n_steps_fixed), n_steps_fixed);
-		csp_solver.mc_reported_outputs.assign(C_csp_solver::C_solver_outputs::DISPATCH_SOLVE_OBJ, allocate("disp_objective", n_steps_fixed), n_steps_fixed);
-		csp_solver.mc_reported_outputs.assign(C_csp_solver::C_solver_outputs::DISPATCH_SOLVE_OBJ_RELAX, allocate("disp_obj_relax", n_steps_fixed), n_steps_fixed);
-		csp_solver.mc_reported_outputs.assign(C_csp_solver::C_solver_outputs::DISPATCH_QSF_EXPECT, allocate("disp_qsf_expected", n_steps_fixed), n_steps_fixed);
-		csp_solver.mc_reported_outputs.assign(C_csp_solver::C_solver_outputs::DISPATCH_QSFPROD_EXPECT, allocate("disp_qsfprod_expected", n_steps_fixed), n_steps_fixed);
-		csp_solver.mc_reported_outputs.assign(C_csp_solver::C_solver_outputs::DISPATCH_QSFSU_EXPECT, allocate("disp_qsfsu_expected", n_steps_fixed), n_steps_fixed);
-		csp_solver.mc_reported_outputs.assign(C_csp_solver::C_solver_outputs::DISPATCH_TES_EXPECT, allocate("disp_tes_expected", n_steps_fixed), n_steps_fixed);
-		csp_solver.mc_reported_outputs.assign(C_csp_solver::C_solver_outputs::DISPATCH_PCEFF_EXPECT, allocate("disp_pceff_expected", n_steps_fixed), n_steps_fixed);
-		csp_solver.mc_reported_outputs.assign(C_csp_solver::C_solver_outputs::DISPATCH_SFEFF_EXPECT, allocate("disp_thermeff_expected", n_steps_fixed), n_steps_fixed);
-		csp_solver.mc_reported_outputs.assign(C_csp_solver::C_solver_outputs::DISPATCH_QPBSU_EXPECT, allocate("disp_qpbsu_expected", n_steps_fixed), n_steps_fixed);
-		csp_solver.mc_reported_outputs.assign(C_csp_solver::C_solver_outputs::DISPATCH_WPB_EXPECT, allocate("disp_wpb_expected", n_steps_fixed), n_steps_fixed);
-		csp_solver.mc_reported_outputs.assign(C_csp_solver::C_solver_outputs::DISPATCH_REV_EXPECT, allocate("disp_rev_expected", n_steps_fixed), n_steps_fixed);
-		csp_solver.mc_reported_outputs.assign(C_csp_solver::C_solver_outputs::DISPATCH_PRES_NCONSTR, allocate("disp_presolve_nconstr", n_steps_fixed), n_steps_fixed);
-		csp_solver.mc_reported_outputs.assign(C_csp_solver::C_solver_outputs::DISPATCH_PRES_NVAR, allocate("disp_presolve_nvar", n_steps_fixed), n_steps_fixed);
-		csp_solver.mc_reported_outputs.assign(C_csp_solver::C_solver_outputs::DISPATCH_SOLVE_TIME, allocate("disp_solve_time", n_steps_fixed), n_steps_fixed);
-
-		csp_solver.mc_reported_outputs.assign(C_csp_solver::C_solver_outputs::SOLZEN, allocate("solzen", n_steps_fixed), n_steps_fixed);
-		csp_solver.mc_reported_outputs.assign(C_csp_solver::C_solver_outputs::SOLAZ, allocate("solaz", n_steps_fixed), n_steps_fixed);
-		csp_solver.mc_reported_outputs.assign(C_csp_solver::C_solver_outputs::BEAM, allocate("beam", n_steps_fixed), n_steps_fixed);
-		csp_solver.mc_reported_outputs.assign(C_csp_solver::C_solver_outputs::TDRY, allocate("tdry", n_steps_fixed), n_steps_fixed);
-		csp_solver.mc_reported_outputs.assign(C_csp_solver::C_solver_outputs::TWET, allocate("twet", n_steps_fixed), n_steps_fixed);
-		csp_solver.mc_reported_outputs.assign(C_csp_solver::C_solver_outputs::RH, allocate("RH", n_steps_fixed), n_steps_fixed);
-		csp_solver.mc_reported_outputs.assign(C_csp_solver::C_solver_outputs::CR_DEFOCUS, allocate("defocus", n_steps_fixed), n_steps_fixed);
-
-		csp_solver.mc_reported_outputs.assign(C_csp_solver::C_solver_outputs::TES_Q_DOT_LOSS, allocate("tank_losses", n_steps_fixed), n_steps_fixed);
-		csp_solver.mc_reported_outputs.assign(C_csp_solver::C_solver_outputs::TES_W_DOT_HEATER, allocate("q_heater", n_steps_fixed), n_steps_fixed);
-		csp_solver.mc_reported_outputs.assign(C_csp_solver::C_solver_outputs::TES_T_HOT, allocate("T_tes_hot", n_steps_fixed), n_steps_fixed);
-		csp_solver.mc_reported_outputs.assign(C_csp_solver::C_solver_outputs::TES_T_COLD, allocate("T_tes_cold", n_steps_fixed), n_steps_fixed);
-		csp_solver.mc_reported_outputs.assign(C_csp_solver::C_solver_outputs::TES_Q_DOT_DC, allocate("q_dc_tes", n_steps_fixed), n_steps_fixed);
-		csp_solver.mc_reported_outputs.assign(C_csp_solver::C_solver_outputs::TES_Q_DOT_CH, allocate("q_ch_tes", n_steps_fixed), n_steps_fixed);
-		csp_solver.mc_reported_outputs.assign(C_csp_solver::C_solver_outputs::TES_E_CH_STATE, allocate("e_ch_tes", n_steps_fixed), n_steps_fixed);
-		csp_solver.mc_reported_outputs.assign(C_csp_solver::C_solver_outputs::TES_M_DOT_DC, allocate("m_dot_tes_dc", n_steps_fixed), n_steps_fixed);
-		csp_solver.mc_reported_outputs.assign(C_csp_solver::C_solver_outputs::TES_M_DOT_CH, allocate("m_dot_tes_ch", n_steps_fixed), n_steps_fixed);
-
-		csp_solver.mc_reported_outputs.assign(C_csp_solver::C_solver_outputs::COL_W_DOT_TRACK, allocate("pparasi", n_steps_fixed), n_steps_fixed);
-		csp_solver.mc_reported_outputs.assign(C_csp_solver::C_solver_outputs::CR_W_DOT_PUMP, allocate("P_tower_pump", n_steps_fixed), n_steps_fixed);
-		csp_solver.mc_reported_outputs.assign(C_csp_solver::C_solver_outputs::SYS_W_DOT_PUMP, allocate("htf_pump_power", n_steps_fixed), n_steps_fixed);
-		csp_solver.mc_reported_outputs.assign(C_csp_solver::C_solver_outputs::PC_W_DOT_COOLING, allocate("P_cooling_tower_tot", n_steps_fixed), n_steps_fixed);
-		csp_solver.mc_reported_outputs.assign(C_csp_solver::C_solver_outputs::SYS_W_DOT_FIXED, allocate("P_fixed", n_steps_fixed), n_steps_fixed);
-		csp_solver.mc_reported_outputs.assign(C_csp_solver::C_solver_outputs::SYS_W_DOT_BOP, allocate("P_plant_balance_tot", n_steps_fixed), n_steps_fixed);
-
-		csp_solver.mc_reported_outputs.assign(C_csp_solver::C_solver_outputs::W_DOT_NET, allocate("P_out_net", n_steps_fixed), n_steps_fixed);
+		reported_outputs.assign(csp_solver.mc_reported_outputs, C_csp_solver::C_solver_outputs::TIME_FINAL, "time_hr");
+		reported_outputs.assign(csp_solver.mc_reported_outputs, C_csp_solver::C_solver_outputs::ERR_M_DOT, "m_dot_balance");
+		reported_outputs.assign(csp_solver.mc_reported_outputs, C_csp_solver::C_solver_outputs::ERR_Q_DOT, "q_balance");
+		reported_outputs.assign(csp_solver.mc_reported_outputs, C_csp_solver::C_solver_outputs::N_OP_MODES, "n_op_modes");
+		reported_outputs.assign(csp_solver.mc_reported_outputs, C_csp_solver::C_solver_outputs::OP_MODE_1, "op_mode_1");
+		reported_outputs.assign(csp_solver.mc_reported_outputs, C_csp_solver::C_solver_outputs::OP_MODE_2, "op_mode_2");
+		reported_outputs.assign(csp_solver.mc_reported_outputs, C_csp_solver::C_solver_outputs::OP_MODE_3, "op_mode_3");
+
+		reported_outputs.assign(csp_solver.mc_reported_outputs, C_csp_solver::C_solver_outputs::TOU_PERIOD, "tou_value");
+		reported_outputs.assign(csp_solver.mc_reported_outputs, C_csp_solver::C_solver_outputs::PRICING_MULT, "pricing_mult");
+		reported_outputs.assign(csp_solver.mc_reported_outputs, C_csp_solver::C_solver_outputs::PC_Q_DOT_SB, "q_dot_pc_sb");
+		reported_outputs.assign(csp_solver.mc_reported_outputs, C_csp_solver::C_solver_outputs::PC_Q_DOT_MIN, "q_dot_pc_min");
+		reported_outputs.assign(csp_solver.mc_reported_outputs, C_csp_solver::C_solver_outputs::PC_Q_DOT_TARGET, "q_dot_pc_max");
+		reported_outputs.assign(csp_solver.mc_reported_outputs, C_csp_solver::C_solver_outputs::PC_Q_DOT_MAX, "q_dot_pc_target");
+
+		reported_outputs.assign(csp_solver.mc_reported_outputs, C_csp_solver::C_solver_outputs::CTRL_IS_REC_SU, "is_rec_su_allowed");
+		reported_outputs.assign(csp_solver.mc_reported_outputs, C_csp_solver::C_solver_outputs::CTRL_IS_PC_SU, "is_pc_su_allowed");
+		reported_outputs.assign(csp_solver.mc_reported_outputs, C_csp_solver::C_solver_outputs::CTRL_IS_PC_SB, "is_pc_sb_allowed");
+		reported_outputs.assign(csp_solver.mc_reported_outputs, C_csp_solver::C_solver_outputs::EST_Q_DOT_CR_SU, "q_dot_est_cr_su");
+		reported_outputs.assign(csp_solver.mc_reported_outputs, C_csp_solver::C_solver_outputs::EST_Q_DOT_CR_ON, "q_dot_est_cr_on");
+		reported_outputs.assign(csp_solver.mc_reported_outputs, C_csp_solver::C_solver_outputs::EST_Q_DOT_DC, "q_dot_est_tes_dc");
+		reported_outputs.assign(csp_solver.mc_reported_outputs, C_csp_solver::C_solver_outputs::EST_Q_DOT_CH, "q_dot_est_tes_ch");
+
+		reported_outputs.assign(csp_solver.mc_reported_outputs, C_csp_solver::C_solver_outputs::CTRL_OP_MODE_SEQ_A, "operating_modes_a");
+		reported_outputs.assign(csp_solver.mc_reported_outputs, C_csp_solver::C_solver_outputs::CTRL_OP_MODE_SEQ_B, "operating_modes_b");
+		reported_outputs.assign(csp_solver.mc_reported_outputs, C_csp_solver::C_solver_outputs::CTRL_OP_MODE_SEQ_C, "operating_modes_c");
+
+		reported_outputs.assign(csp_solver.mc_reported_outputs, C_csp_solver::C_solver_outputs::DISPATCH_SOLVE_STATE, "disp_solve_state");
+		reported_outputs.assign(csp_solver.mc_reported_outputs, C_csp_solver::C_solver_outputs::DISPATCH_SOLVE_ITER, "disp_solve_iter");
+		reported_outputs.assign(csp_solver.mc_reported_outputs, C_csp_solver::C_solver_outputs::DISPATCH_SOLVE_OBJ, "disp_objective");
+		reported_outputs.assign(csp_solver.mc_reported_outputs, C_csp_solver::C_solver_outputs::DISPATCH_SOLVE_OBJ_RELAX, "disp_obj_relax");
+		reported_outputs.assign(csp_solver.mc_reported_outputs, C_csp_solver::C_solver_outputs::DISPATCH_QSF_EXPECT, "disp_qsf_expected");
+		reported_outputs.assign(csp_solver.mc_reported_outputs, C_csp_solver::C_solver_outputs::DISPATCH_QSFPROD_EXPECT, "disp_qsfprod_expected");
+		reported_outputs.assign(csp_solver.mc_reported_outputs, C_csp_solver::C_solver_outputs::DISPATCH_QSFSU_EXPECT, "disp_qsfsu_expected");
+		reported_outputs.assign(csp_solver.mc_reported_outputs, C_csp_solver::C_solver_outputs::DISPATCH_TES_EXPECT, "disp_tes_expected");
+		reported_outputs.assign(csp_solver.mc_reported_outputs, C_csp_solver::C_solver_outputs::DISPATCH_PCEFF_EXPECT, "disp_pceff_expected");
+		reported_outputs.assign(csp_solver.mc_reported_outputs, C_csp_solver::C_solver_outputs::DISPATCH_SFEFF_EXPECT, "disp_thermeff_expected");
+		reported_outputs.assign(csp_solver.mc_reported_outputs, C_csp_solver::C_solver_outputs::DISPATCH_QPBSU_EXPECT, "disp_qpbsu_expected");
+		reported_outputs.assign(csp_solver.mc_reported_outputs, C_csp_solver::C_solver_outputs::DISPATCH_WPB_EXPECT, "disp_wpb_expected");
+		reported_outputs.assign(csp_solver.mc_reported_outputs, C_csp_solver::C_solver_outputs::DISPATCH_REV_EXPECT, "disp_rev_expected");
+		reported_outputs.assign(csp_solver.mc_reported_outputs, C_csp_solver::C_solver_outputs::DISPATCH_PRES_NCONSTR, "disp_presolve_nconstr");
+		reported_outputs.assign(csp_solver.mc_reported_outputs, C_csp_solver::C_solver_outputs::DISPATCH_PRES_NVAR, "disp_presolve_nvar");
+		reported_outputs.assign(csp_solver.mc_reported_outputs, C_csp_solver::C_solver_outputs::DISPATCH_SOLVE_TIME, "disp_solve_time");
+
+		reported_outputs.assign(csp_solver.mc_reported_outputs, C_csp_solver::C_solver_outputs::SOLZEN, "solzen");
+		reported_outputs.assign(csp_solver.mc_reported_outputs, C_csp_solver::C_solver_outputs::SOLAZ, "solaz");
+		reported_outputs.assign(csp_solver.mc_reported_outputs, C_csp_solver::C_solver_outputs::BEAM, "beam");
+		reported_outputs.assign(csp_solver.mc_reported_outputs, C_csp_solver::C_solver_outputs::TDRY, "tdry");
+		reported_outputs.assign(csp_solver.mc_reported_outputs, C_csp_solver::C_solver_outputs::TWET, "twet");
+		reported_outputs.assign(csp_solver.mc_reported_outputs, C_csp_solver::C_solver_outputs::RH, "RH");
+		reported_outputs.assign(csp_solver.mc_reported_outputs, C_csp_solver::C_solver_outputs::CR_DEFOCUS, "defocus");
+
+		reported_outputs.assign(csp_solver.mc_reported_outputs, C_csp_solver::C_solver_outputs::TES_Q_DOT_LOSS, "tank_losses");
+		reported_outputs.assign(csp_solver.mc_reported_outputs, C_csp_solver::C_solver_outputs::TES_W_DOT_HEATER, "q_heater");
+		reported_outputs.assign(csp_solver.mc_reported_outputs, C_csp_solver::C_solver_outputs::TES_T_HOT, "T_tes_hot");
+		reported_outputs.assign(csp_solver.mc_reported_outputs, C_csp_solver::C_solver_outputs::TES_T_COLD, "T_tes_cold");
+		reported_outputs.assign(csp_solver.mc_reported_outputs, C_csp_solver::C_solver_outputs::TES_Q_DOT_DC, "q_dc_tes");
+		reported_outputs.assign(csp_solver.mc_reported_outputs, C_csp_solver::C_solver_outputs::TES_Q_DOT_CH, "q_ch_tes");
+		reported_outputs.assign(csp_solver.mc_reported_outputs, C_csp_solver::C_solver_outputs::TES_E_CH_STATE, "e_ch_tes");
+		reported_outputs.assign(csp_solver.mc_reported_outputs, C_csp_solver::C_solver_outputs::TES_M_DOT_DC, "m_dot_tes_dc");
+		reported_outputs.assign(csp_solver.mc_reported_outputs, C_csp_solver::C_solver_outputs::TES_M_DOT_CH, "m_dot_tes_ch");
+
+		reported_outputs.assign(csp_solver.mc_reported_outputs, C_csp_solver::C_solver_outputs::COL_W_DOT_TRACK, "pparasi");
+		reported_outputs.assign(csp_solver.mc_reported_outputs, C_csp_solver::C_solver_outputs::CR_W_DOT_PUMP, "P_tower_pump");
+		reported_outputs.assign(csp_solver.mc_reported_outputs, C_csp_solver::C_solver_outputs::SYS_W_DOT_PUMP, "htf_pump_power");
+		reported_outputs.assign(csp_solver.mc_reported_outputs, C_csp_solver::C_solver_outputs::PC_W_DOT_COOLING, "P_cooling_tower_tot");
+		reported_outputs.assign(csp_solver.mc_reported_outputs, C_csp_solver::C_solver_outputs::SYS_W_DOT_FIXED, "P_fixed");
+		reported_outputs.assign(csp_solver.mc_reported_outputs, C_csp_solver::C_solver_outputs::SYS_W_DOT_BOP, "P_plant_balance_tot");
+
+		reported_outputs.assign(csp_solver.mc_reported_outputs, C_csp_solver::C_solver_outputs::W_DOT_NET, "P_out_net");
 
 
 		int out_type = -1;
@@ -1003,6 +1031,15 @@ public:
 			return;
 		}
 
+		// If no exception, then report messages
+		while( csp_solver.mc_csp_messages.get_message(&out_type, &out_msg) )
+		{
+			log(out_msg, out_type);
+		}
+
+		// Per-operating-mode solver profile, if requested
+		csp_op_mode_profile_outputs(this, csp_solver);
+
 	}
 
 };
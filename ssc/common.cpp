@@ -48,6 +48,7 @@
 *******************************************************************************************************/
 
 #include <string>
+#include <algorithm>
 #include "common.h"
 #include "lib_weatherfile.h"
 
@@ -985,3 +986,13 @@ bool ssc_cmod_update(std::string &log_msg, std::string &progress_msg, void *data
 	
 	return cm->update(progress_msg, (float)progress);
 }
+
+int chunk_thread_count(int requested, size_t nchunks)
+{
+	int nthreads = requested;
+	if (nthreads <= 0)
+		nthreads = (int)std::thread::hardware_concurrency();
+	if (nthreads > (int)nchunks)
+		nthreads = (int)nchunks;
+	return std::max(nthreads, 1);
+}
@@ -52,6 +52,8 @@
 
 #include <memory>
 #include <vector>
+#include <thread>
+#include <mutex>
 #include "core.h"
 
 #include "../shared/lib_util.h"
@@ -167,5 +169,42 @@ public:
 
 bool ssc_cmod_update(std::string &log_msg, std::string &progress_msg, void *data, double progress, int out_type);
 
+/* Number of threads to run nchunks independent chunks on: 'requested', or one per processor if 'requested' is
+zero or negative, limited to one per chunk and at least one */
+int chunk_thread_count(int requested, size_t nchunks);
+
+/* Run chunks on a pool of nthreads threads, including the calling thread, each taking the next chunk
+until none are left. run_chunk(k) must only write results for chunk k */
+template< typename F >
+void run_chunks(size_t nchunks, int nthreads, F run_chunk)
+{
+	size_t inext = 0;
+	std::mutex mtx;
+
+	auto worker = [&]()
+	{
+		while (true)
+		{
+			size_t k;
+			{
+				std::lock_guard<std::mutex> lock(mtx);
+				if (inext >= nchunks)
+					return;
+				k = inext++;
+			}
+			run_chunk(k);
+		}
+	};
+
+	std::vector<std::thread> threads;
+	for (int i = 1; i < nthreads; i++)
+		threads.push_back(std::thread(worker));
+
+	worker();
+
+	for (size_t i = 0; i < threads.size(); i++)
+		threads[i].join();
+}
+
 #endif
 
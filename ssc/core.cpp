@@ -57,7 +57,7 @@
 const var_info var_info_invalid = {	0, 0, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL };
 
 compute_module::compute_module( )
-	:  m_infomap(NULL), m_handler(NULL), m_vartab(NULL)
+	:  m_session_ready(false), m_infomap(NULL), m_handler(NULL), m_vartab(NULL)
 {
 	/* nothing to do */
 }
@@ -67,7 +67,7 @@ compute_module::~compute_module()
 	if (m_infomap) delete m_infomap;
 }
 
-bool compute_module::compute( handler_interface *handler, var_table *data )
+bool compute_module::begin_call( handler_interface *handler, var_table *data )
 {
 	m_handler = NULL;
 	m_vartab = NULL;
@@ -91,6 +91,14 @@ bool compute_module::compute( handler_interface *handler, var_table *data )
 		log("no variables defined for computation engine", SSC_ERROR);
 		return false;
 	}
+
+	return true;
+}
+
+bool compute_module::compute( handler_interface *handler, var_table *data )
+{
+	if (!begin_call( handler, data ))
+		return false;
 	
 	try { // catch any 'general_error' that can be thrown during precheck, exec, and postcheck
 
@@ -106,12 +114,77 @@ bool compute_module::compute( handler_interface *handler, var_table *data )
 	return true;
 }
 
-bool compute_module::verify(const std::string &phase, int check_var_type) throw( general_error )
+bool compute_module::session_begin( handler_interface *handler, var_table *config )
+{
+	m_session_ready = false;
+	if (!begin_call( handler, config ))
+		return false;
+
+	if (!supports_session())
+	{
+		log("computation engine does not support stepping sessions", SSC_ERROR);
+		return false;
+	}
+
+	bool ok = false;
+	try {
+		if (verify("precheck session configuration", SSC_INPUT, VERIFY_CONFIG))
+		{
+			session_setup();
+			ok = true;
+		}
+	} catch ( general_error &e ) {
+		log( e.err_text, SSC_ERROR, e.time );
+	}
+
+	// the configuration table is not kept, session_setup() must copy what it needs
+	m_handler = NULL;
+	m_vartab = NULL;
+	m_session_ready = ok;
+	return ok;
+}
+
+bool compute_module::session_step( handler_interface *handler, var_table *step )
+{
+	// keep the messages of a failed session_begin for the caller
+	if (!m_session_ready)
+		return false;
+
+	// the log only holds the messages of the current step, so it doesn't grow over a long session
+	clear_log();
+
+	if (!begin_call( handler, step ))
+		return false;
+
+	bool ok = false;
+	try {
+		if (verify("precheck step input", SSC_INPUT, VERIFY_STEP))
+		{
+			session_exec();
+			ok = verify("postcheck step output", SSC_OUTPUT, VERIFY_STEP);
+		}
+	} catch ( general_error &e ) {
+		log( e.err_text, SSC_ERROR, e.time );
+	}
+
+	m_handler = NULL;
+	m_vartab = NULL;
+	return ok;
+}
+
+bool compute_module::verify(const std::string &phase, int check_var_type, int var_set) throw( general_error )
 {
 	std::vector< var_info* >::iterator it;
 	for (it=m_varlist.begin();it!=m_varlist.end();++it)
 	{
 		var_info *vi = *it;
+		if ( var_set != VERIFY_ALL && check_var_type != SSC_OUTPUT )
+		{
+			bool is_step = std::find( m_steplist.begin(), m_steplist.end(), vi ) != m_steplist.end();
+			if ( is_step != (var_set == VERIFY_STEP) )
+				continue;
+		}
+
 		if ( vi->var_type == check_var_type
 			|| vi->var_type == SSC_INOUT )
 		{
@@ -156,6 +229,17 @@ void compute_module::add_var_info( var_info vi[] )
 	}
 }
 
+void compute_module::add_step_var_info( var_info vi[] )
+{
+	int i=0;
+	while ( vi[i].data_type != SSC_INVALID
+		&& vi[i].name != NULL )
+	{
+		m_steplist.push_back( &vi[i] );
+		i++;
+	}
+}
+
 void compute_module::remove_var_info(var_info vi[])
 {
 	int i = 0;
@@ -220,6 +220,16 @@ public:
 	var_info *info(int index);
 		
 	bool compute( handler_interface *handler, var_table *data );
+
+	/* stepping sessions (see ssc_session_* in sscapi.h): 'session_begin' verifies the
+	   configuration once and calls session_setup(), after which each 'session_step'
+	   only verifies the per-step variables and calls session_exec(). model state
+	   kept in the module carries over from one step to the next. each step clears
+	   the log first, so it only holds the messages of the most recent call. if
+	   session_begin failed, steps fail and keep its messages in the log */
+	bool session_begin( handler_interface *handler, var_table *config );
+	bool session_step( handler_interface *handler, var_table *step );
+	bool supports_session() { return m_steplist.size() > 0; }
 		
 
 	/* on_extproc_output: this function will be called by the
@@ -241,6 +251,12 @@ protected:
 	   note: can throw exceptions of type 'compute_module::error' */
 	virtual void exec( ) throw( general_error ) = 0;
 
+	/* implemented by modules that support stepping sessions, along with
+	   add_step_var_info() to mark the variables that change every step */
+	virtual void session_setup( ) throw( general_error ) {  }
+	virtual void session_exec( ) throw( general_error ) {  }
+	void add_step_var_info( var_info vi[] );
+
 	
 	/* can be called in constructors to build up the variable table references */
 	void add_var_info( var_info vi[] );
@@ -291,8 +307,12 @@ public:
 	ssc_number_t *accumulate_monthly_for_year(const std::string &hourly_var, const std::string &annual_var, double scale, size_t step_per_hour, size_t year = 1) throw(exec_error);
 
 private:
-	// called by 'compute' as necessary for precheck and postcheck
-	bool verify(const std::string &phase, int var_types) throw( general_error );
+	// called by 'compute' as necessary for precheck and postcheck.  'var_set' limits
+	// the check of inputs to the session step variables or to everything else. a
+	// session step produces all outputs, so outputs are always checked
+	enum { VERIFY_ALL, VERIFY_STEP, VERIFY_CONFIG };
+	bool verify(const std::string &phase, int var_types, int var_set = VERIFY_ALL) throw( general_error );
+	bool begin_call( handler_interface *handler, var_table *data );
 	
 	bool check_required( const std::string &name ) throw( general_error );
 	bool check_constraints( const std::string &name, std::string &fail_text ) throw( general_error );
@@ -303,7 +323,9 @@ private:
 	var_data m_null_value;
 	
 	std::vector< var_info* > m_varlist;
+	std::vector< var_info* > m_steplist;
 	std::vector< log_item > m_loglist;
+	bool m_session_ready; // session_begin succeeded, session_step may be called
 	
 	unordered_map< std::string, var_info* > *m_infomap;
 
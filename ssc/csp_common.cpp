@@ -49,6 +49,7 @@
 
 #include "csp_common.h"
 #include "core.h"
+#include "csp_solver_core.h"
 #include "lib_weatherfile.h"
 #include "lib_util.h"
 #include <sstream>
@@ -568,3 +569,99 @@ static bool optimize_callback( simulation_info *siminfo, void *data )
     
     return true;
 }
+
+void csp_op_mode_profile_outputs(compute_module *cm, C_csp_solver &csp_solver)
+{
+    const std::vector<C_csp_solver::S_op_mode_profile> & v_op_mode_profile = csp_solver.get_op_mode_profile();
+    int n_op_modes_profile = (int)v_op_mode_profile.size();
+    if (n_op_modes_profile == 0)
+        return;
+
+    ssc_number_t *p_prof_n_calls = cm->allocate("op_mode_prof_n_calls", n_op_modes_profile);
+    ssc_number_t *p_prof_n_rejected = cm->allocate("op_mode_prof_n_rejected", n_op_modes_profile);
+    ssc_number_t *p_prof_n_iter = cm->allocate("op_mode_prof_n_iter", n_op_modes_profile);
+    ssc_number_t *p_prof_n_eq_calls = cm->allocate("op_mode_prof_n_eq_calls", n_op_modes_profile);
+    ssc_number_t *p_prof_time = cm->allocate("op_mode_prof_time", n_op_modes_profile);
+
+    for (int i = 0; i < n_op_modes_profile; i++)
+    {
+        p_prof_n_calls[i] = (ssc_number_t)v_op_mode_profile[i].m_n_calls;
+        p_prof_n_rejected[i] = (ssc_number_t)v_op_mode_profile[i].m_n_rejected;
+        p_prof_n_iter[i] = (ssc_number_t)v_op_mode_profile[i].m_n_iter;
+        p_prof_n_eq_calls[i] = (ssc_number_t)v_op_mode_profile[i].m_n_eq_calls;
+        p_prof_time[i] = (ssc_number_t)v_op_mode_profile[i].m_time;		//[s]
+    }
+}
+
+csp_output_selector::csp_output_selector(compute_module *cm, int n_steps)
+{
+    m_cmod = cm;
+    m_n_steps = n_steps;
+    mp_sink = 0;
+
+    if (cm->is_assigned("csp_output_csv_file") && std::string(cm->as_string("csp_output_csv_file")) != "")
+    {
+        if (!mc_output_csv.open(cm->as_string("csp_output_csv_file")))
+            throw compute_module::exec_error("csp_output_selector", util::format("Could not open output file %s", cm->as_string("csp_output_csv_file")));
+        mp_sink = &mc_output_csv;
+    }
+
+    std::string subset = cm->is_assigned("csp_output_subset") ? cm->as_string("csp_output_subset") : "";
+    std::vector<std::string> names = util::split(subset, ", \t");
+    for (size_t i = 0; i < names.size(); i++)
+    {
+        if (!names[i].empty())
+            m_keep.insert(names[i]);
+    }
+
+    m_is_subset = !m_keep.empty();
+}
+
+C_csp_output_sink *csp_output_selector::get_sink()
+{
+    return mp_sink;
+}
+
+void csp_output_selector::keep(const std::string &name)
+{
+    m_keep.insert(name);
+}
+
+bool csp_output_selector::is_kept(const std::string &name)
+{
+    return !m_is_subset || m_keep.count(name) > 0;
+}
+
+void csp_output_selector::assign(C_csp_reported_outputs &reported_outputs, int index, const std::string &name)
+{
+    if (is_kept(name))
+    {
+        reported_outputs.assign(index, m_cmod->allocate(name, m_n_steps), m_n_steps);
+    }
+    else if (std::string(m_cmod->info(name).required_if) == "*")
+    {
+        m_cmod->allocate(name, 1);
+    }
+
+    if (mp_sink != 0)
+    {
+        reported_outputs.stream(index, mp_sink, name);
+    }
+}
+
+void csp_output_selector::assign(C_csp_power_cycle &power_cycle, int index, const std::string &name)
+{
+    if (is_kept(name))
+    {
+        power_cycle.assign(index, m_cmod->allocate(name, m_n_steps), m_n_steps);
+    }
+    else if (std::string(m_cmod->info(name).required_if) == "*")
+    {
+        m_cmod->allocate(name, 1);
+    }
+
+    if (mp_sink != 0)
+    {
+        power_cycle.stream(index, mp_sink, name);
+    }
+}
@@ -54,6 +54,7 @@
 #include "core.h"
 #include "AutoPilot_API.h"
 #include "lib_weatherfile.h"
+#include "csp_output_selector.h"
 
 class solarpilot_invoke : public var_map
 {
@@ -76,6 +76,7 @@ extern module_entry_info
 	cm_entry_iec61853par,
 	cm_entry_iec61853interp,
 	cm_entry_6parsolve,
+	cm_entry_module_par_batch,
 	cm_entry_pvsamv1,
 	cm_entry_pvwattsv0,
 	cm_entry_pvwattsv1,
@@ -83,6 +84,7 @@ extern module_entry_info
 	cm_entry_pvwattsv1_poa,
 	cm_entry_pvwattsv5,
 	cm_entry_pvwattsv5_1ts,
+	cm_entry_pvwattsv5_fleet,
 	cm_entry_pv6parmod,
 	cm_entry_pvsandiainv,
 	cm_entry_wfreader,
@@ -158,6 +160,7 @@ static module_entry_info *module_table[] = {
 	&cm_entry_iec61853par,
 	&cm_entry_iec61853interp,
 	&cm_entry_6parsolve,
+	&cm_entry_module_par_batch,
 	&cm_entry_pv6parmod,
 	&cm_entry_pvsamv1,
 	//&cm_entry_pvwattsv0,
@@ -166,6 +169,7 @@ static module_entry_info *module_table[] = {
 	&cm_entry_pvwattsv1_poa,
 	&cm_entry_pvwattsv5,
 	&cm_entry_pvwattsv5_1ts,
+	&cm_entry_pvwattsv5_fleet,
 	&cm_entry_pvsandiainv,
 	&cm_entry_wfreader,
 	&cm_entry_irradproc,
@@ -662,6 +666,45 @@ SSCEXPORT ssc_bool_t ssc_module_exec_with_handler(
 }
 
 
+/*************************** stepping sessions ***************************/
+
+SSCEXPORT ssc_session_t ssc_session_create( const char *name, ssc_data_t p_data )
+{
+	compute_module *cm = static_cast<compute_module*>( ssc_module_create( name ) );
+	if (!cm) return 0;
+
+	var_table *vt = static_cast<var_table*>(p_data);
+	default_exec_handler h( cm, sg_defaultPrint ? default_internal_handler : default_internal_handler_no_print, 0 );
+	if ( !vt )
+		cm->log("invalid data object provided", SSC_ERROR);
+	else
+		cm->session_begin( &h, vt );
+
+	// returned even if the setup failed, so the caller can read why from the log
+	return static_cast<ssc_session_t>(cm);
+}
+
+SSCEXPORT ssc_bool_t ssc_session_step( ssc_session_t p_session, ssc_data_t p_inputs )
+{
+	compute_module *cm = static_cast<compute_module*>(p_session);
+	if (!cm) return 0;
+
+	var_table *vt = static_cast<var_table*>(p_inputs);
+	if (!vt)
+	{
+		cm->log("invalid data object provided", SSC_ERROR);
+		return 0;
+	}
+
+	default_exec_handler h( cm, sg_defaultPrint ? default_internal_handler : default_internal_handler_no_print, 0 );
+	return cm->session_step( &h, vt ) ? 1 : 0;
+}
+
+SSCEXPORT void ssc_session_free( ssc_session_t p_session )
+{
+	ssc_module_free( p_session );
+}
+
 SSCEXPORT void ssc_module_extproc_output( ssc_handler_t p_handler, const char *output_line )
 {
 	handler_interface *hi = static_cast<handler_interface*>( p_handler );
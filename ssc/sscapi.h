@@ -324,6 +324,18 @@ SSCEXPORT ssc_bool_t ssc_module_exec_with_handler(
 /** Retrive notices, warnings, and error messages from the simulation. Returns a NULL-terminated ASCII C string with the message text, or NULL if the index passed in was invalid. */
 SSCEXPORT const char *ssc_module_log( ssc_module_t p_mod, int index, int *item_type, float *time );
 
+/** An opaque reference to a stepping session. A session keeps one compute module initialized between calls so it can be advanced one time step at a time, for example by a real-time controller. The session is a compute module, so ssc_module_log can be used to retrieve its messages. */
+typedef void* ssc_session_t;
+
+/** Creates a stepping session for the compute module with the given name. The configuration in p_data (system design, location, initial model state) is verified and set up once. Returns 0 (NULL) only if the module does not exist. If the module does not support sessions (currently: pvwattsv5_1ts) or the configuration is invalid, the session is still returned so that ssc_module_log can retrieve the errors, and every ssc_session_step on it fails and keeps those errors in the log. The session must be released with ssc_session_free either way. */
+SSCEXPORT ssc_session_t ssc_session_create( const char *name, ssc_data_t p_data );
+
+/** Advances a session by one time step. p_inputs needs only the variables that change every step (time and weather); the step outputs are assigned into p_inputs. Model state such as the cell temperature carries over to the next call. Each step clears the session log first, so ssc_module_log returns only the messages of the most recent step. Returns Boolean: 1 or 0. */
+SSCEXPORT ssc_bool_t ssc_session_step( ssc_session_t p_session, ssc_data_t p_inputs );
+
+/** Releases a session created with ssc_session_create */
+SSCEXPORT void ssc_session_free( ssc_session_t p_session );
+
 /** DO NOT CALL THIS FUNCTION: immediately causes a segmentation fault within the library. This is only useful for testing crash handling from an external application that is dynamically linked to the SSC library */
 SSCEXPORT void __ssc_segfault();
 
@@ -131,6 +131,31 @@ int CO2_TQ( double T, double Q, CO2_state * state );
 double CO2_visc( double D, double T);	//(uPa-s)
 double CO2_cond( double D, double T);	//(W/m-K)
 
+// Batched property functions: evaluate the n states (P[i], H[i]) or (T[i], P[i]) into states[i].
+// Return 0 if every state solved, otherwise the error code of the first state that failed. If
+// 'error_codes' is not null it receives the return value for each state. CO2_PH_batch shares the
+// saturation calculations between consecutive subcritical states at the same pressure.
+int CO2_PH_batch( int n, const double * P, const double * H, CO2_state * states, int * error_codes );
+int CO2_TP_batch( int n, const double * T, const double * P, CO2_state * states, int * error_codes );
+
+// Memoized property functions: same results as CO2_TP and CO2_PH, but states that exactly match one
+// of the most recently memoized states on the calling thread are copied instead of re-solved.
+int CO2_TP_memo( double T, double P, CO2_state * state );
+int CO2_PH_memo( double P, double H, CO2_state * state );
+
+typedef struct CO2_memo_stats
+    {
+    long long n_memo_calls;   // calls to CO2_TP_memo and CO2_PH_memo
+    long long n_memo_hits;    // memo calls answered without solving the state
+    long long n_batch_calls;  // calls to CO2_PH_batch and CO2_TP_batch
+    long long n_batch_states; // states evaluated by the batch functions
+    }
+    CO2_memo_stats;
+
+// Memo and batch counters for the calling thread.
+void get_CO2_memo_stats( CO2_memo_stats * stats );
+void reset_CO2_memo_stats();
+
 namespace N_co2_props
 {
 	const double T_crit = 304.1282;
@@ -181,6 +206,9 @@ namespace N_co2_props
 
 	void find_element(const double T, const double D, Element * __restrict e);
 
+	// Returns the fit element containing (T, D); avoids copying the coefficients
+	const Element * find_element(const double T, const double D);
+
 	void get_prop_derivatives(
 		const double T,
 		const double D,
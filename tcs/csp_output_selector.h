@@ -0,0 +1,101 @@
+/*******************************************************************************************************
+*  Copyright 2017 Alliance for Sustainable Energy, LLC
+*
+*  NOTICE: This software was developed at least in part by Alliance for Sustainable Energy, LLC
+*  (Alliance) under Contract No. DE-AC36-08GO28308 with the U.S. Department of Energy and the U.S.
+*  The Government retains for itself and others acting on its behalf a nonexclusive, paid-up,
+*  irrevocable worldwide license in the software to reproduce, prepare derivative works, distribute
+*  copies to the public, perform publicly and display publicly, and to permit others to do so.
+*
+*  Redistribution and use in source and binary forms, with or without modification, are permitted
+*  provided that the following conditions are met:
+*
+*  1. Redistributions of source code must retain the above copyright notice, the above government
+*  rights notice, this list of conditions and the following disclaimer.
+*
+*  2. Redistributions in binary form must reproduce the above copyright notice, the above government
+*  rights notice, this list of conditions and the following disclaimer in the documentation and/or
+*  other materials provided with the distribution.
+*
+*  3. The entire corresponding source code of any redistribution, with or without modification, by a
+*  research entity, including but not limited to any contracting manager/operator of a United States
+*  National Laboratory, any institution of higher learning, and any non-profit organization, must be
+*  made publicly available under this license for as long as the redistribution is made available by
+*  the research entity.
+*
+*  4. Redistribution of this software, without modification, must refer to the software by the same
+*  designation. Redistribution of a modified version of this software (i) may not refer to the modified
+*  version by the same designation, or by any confusingly similar designation, and (ii) must refer to
+*  the underlying software originally provided by Alliance as System Advisor Model or SAM. Except
+*  to comply with the foregoing, the terms System Advisor Model, SAM, or any confusingly similar
+*  designation may not be used to refer to any modified version of this software or any modified
+*  version of the underlying software originally provided by Alliance without the prior written consent
+*  of Alliance.
+*
+*  5. The name of the copyright holder, contributors, the United States Government, the United States
+*  Department of Energy, or any of their employees may not be used to endorse or promote products
+*  derived from this software without specific prior written permission.
+*
+*  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR
+*  IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+*  FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER,
+*  CONTRIBUTORS, UNITED STATES GOVERNMENT OR UNITED STATES DEPARTMENT OF ENERGY, NOR ANY OF THEIR
+*  EMPLOYEES, BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+*  DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+*  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+*  IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+*  THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************************************/
+
+#ifndef __csp_output_selector_
+#define __csp_output_selector_
+
+#include <set>
+#include <string>
+
+#include "csp_solver_util.h"
+
+// Connects csp solver outputs to compute module outputs. Implemented in ssc/csp_common.cpp;
+//    this header only needs declarations, so compute modules can use it without csp_common.h
+class compute_module;
+class C_csp_solver;
+class C_csp_power_cycle;
+
+// Allocates the op_mode_prof_* outputs from the solver's per-operating-mode profile
+// Does nothing if the profile was not enabled
+void csp_op_mode_profile_outputs(compute_module *cm, C_csp_solver &csp_solver);
+
+// Connects csp solver reported outputs to ssc output arrays
+// Reads the optional compute module inputs:
+//   'csp_output_subset': comma or space separated list of ssc output names to store; empty stores all outputs
+//   'csp_output_csv_file': CSV file that every output connected through the selector is streamed to
+// Outputs outside the subset are only sent to the sink (if any). Required outputs outside the subset
+//   are returned as single-element placeholders; optional ones are not assigned
+class csp_output_selector
+{
+    compute_module *m_cmod;
+    int m_n_steps;
+    C_csp_output_sink_csv mc_output_csv;
+    C_csp_output_sink *mp_sink;
+
+    bool m_is_subset;
+    std::set<std::string> m_keep;
+
+public:
+
+    csp_output_selector(compute_module *cm, int n_steps);
+
+    // Sink for the solver to complete rows on (C_csp_solver::set_output_sink), NULL if no file was requested
+    C_csp_output_sink *get_sink();
+
+    // Always store 'name', e.g. outputs read by the compute module after simulation
+    void keep(const std::string &name);
+
+    bool is_kept(const std::string &name);
+
+    void assign(C_csp_reported_outputs &reported_outputs, int index, const std::string &name);
+
+    void assign(C_csp_power_cycle &power_cycle, int index, const std::string &name);
+};
+
+#endif
@@ -154,6 +154,55 @@ void C_csp_solver::C_csp_solver_kernel::baseline_step_forward()
 	mc_ts_sim_baseline.step_forward();
 }
 
+void C_csp_solver::C_csp_solver_kernel::init_op_mode_profile(int n_op_modes)
+{
+	mv_op_mode_profile.assign(n_op_modes, S_op_mode_profile());
+	m_op_mode_profiled = -1;
+	m_n_iter_profile_start = m_n_eq_calls_profile_start = 0;
+}
+
+bool C_csp_solver::C_csp_solver_kernel::is_op_mode_profile()
+{
+	return mv_op_mode_profile.size() > 0;
+}
+
+void C_csp_solver::C_csp_solver_kernel::op_mode_profile_start(int op_mode)
+{
+	if( op_mode < 0 || op_mode >= (int)mv_op_mode_profile.size() )
+	{
+		m_op_mode_profiled = -1;
+		return;
+	}
+
+	m_op_mode_profiled = op_mode;
+	// Solves run on this thread, so the thread totals include the component models' solves
+	m_n_iter_profile_start = C_monotonic_eq_solver::get_n_iter_thread_total();
+	m_n_eq_calls_profile_start = C_monotonic_eq_solver::get_n_eq_calls_thread_total();
+	m_time_profile_start = std::chrono::steady_clock::now();
+}
+
+void C_csp_solver::C_csp_solver_kernel::op_mode_profile_end(bool is_converged)
+{
+	if( m_op_mode_profiled < 0 )
+		return;
+
+	S_op_mode_profile &s_prof = mv_op_mode_profile[m_op_mode_profiled];
+
+	s_prof.m_n_calls++;
+	if( !is_converged )
+		s_prof.m_n_rejected++;
+	s_prof.m_n_iter += C_monotonic_eq_solver::get_n_iter_thread_total() - m_n_iter_profile_start;
+	s_prof.m_n_eq_calls += C_monotonic_eq_solver::get_n_eq_calls_thread_total() - m_n_eq_calls_profile_start;
+	s_prof.m_time += std::chrono::duration<double>(std::chrono::steady_clock::now() - m_time_profile_start).count();	//[s]
+
+	m_op_mode_profiled = -1;
+}
+
+const std::vector<C_csp_solver::S_op_mode_profile> & C_csp_solver::C_csp_solver_kernel::get_op_mode_profile()
+{
+	return mv_op_mode_profile;
+}
+
 static C_csp_reported_outputs::S_output_info S_solver_output_info[] =
 {
 	// Ouputs that are NOT reported as weighted averages
@@ -283,6 +332,8 @@ C_csp_solver::C_csp_solver(C_csp_weatherreader &weather,
 	mpf_callback = pf_callback;
 	mp_cmod_active = p_cmod_active;
 
+	mp_output_sink = 0;
+
 	// Solved Controller Variables
 	m_defocus = std::numeric_limits<double>::quiet_NaN();
 }
@@ -499,6 +550,21 @@ void C_csp_solver::init()
 	}
 }
 
+void C_csp_solver::enable_op_mode_profile()
+{
+	mc_kernel.init_op_mode_profile(CR_DF__PC_SU__TES_OFF__AUX_OFF + 1);
+}
+
+const std::vector<C_csp_solver::S_op_mode_profile> & C_csp_solver::get_op_mode_profile()
+{
+	return mc_kernel.get_op_mode_profile();
+}
+
+void C_csp_solver::set_output_sink(C_csp_output_sink *p_output_sink)
+{
+	mp_output_sink = p_output_sink;
+}
+
 int C_csp_solver::steps_per_hour()
 {
 	// Get number of records in weather file
@@ -1633,6 +1699,14 @@ void C_csp_solver::Ssimulate(C_csp_solver::S_sim_setup & sim_setup)
 			m_op_mode_tracking.push_back(operating_mode);
 
 
+			mc_mono_eq_cache.set_key(operating_mode);
+
+			bool is_op_mode_profile = mc_kernel.is_op_mode_profile();
+			if( is_op_mode_profile )
+			{
+				mc_kernel.op_mode_profile_start(operating_mode);
+			}
+
 			switch( operating_mode )
 			{
 			case CR_DF__PC_SU__TES_OFF__AUX_OFF:
@@ -1805,7 +1879,7 @@ void C_csp_solver::Ssimulate(C_csp_solver::S_sim_setup & sim_setup)
 					int solver_code = 0;
 					try
 					{
-						solver_code = c_solver.solve(defocus_guess_low, defocus_guess_high, q_pc_max, defocus_solved, tol_solved, iter_solved);
+						solver_code = mc_mono_eq_cache.solve("C_MEQ_cr_on__pc_q_dot_max__tes_off__defocus", c_solver, defocus_guess_low, defocus_guess_high, q_pc_max, defocus_solved, tol_solved, iter_solved);
 					}
 					catch (C_csp_exception)
 					{
@@ -1907,7 +1981,7 @@ void C_csp_solver::Ssimulate(C_csp_solver::S_sim_setup & sim_setup)
 						int solver_code = 0;
 						try
 						{
-							solver_code = c_solver.solve(T_htf_cold_guess_colder, T_htf_cold_guess_warmer, 0.0, T_htf_cold_solved, tol_solved, iter_solved);
+							solver_code = mc_mono_eq_cache.solve("C_mono_eq_cr_to_pc_to_cr", c_solver, T_htf_cold_guess_colder, T_htf_cold_guess_warmer, 0.0, T_htf_cold_solved, tol_solved, iter_solved);
 						}
 						catch (C_csp_exception)
 						{
@@ -2536,7 +2610,7 @@ void C_csp_solver::Ssimulate(C_csp_solver::S_sim_setup & sim_setup)
 				int solver_code = 0;
 				try
 				{
-					solver_code = c_solver.solve(T_htf_cold_guess_colder, T_htf_cold_guess_warmer, 0.0, T_htf_cold_solved, tol_solved, iter_solved);
+					solver_code = mc_mono_eq_cache.solve("C_MEQ_cr_on__pc_off__tes_ch__T_htf_cold", c_solver, T_htf_cold_guess_colder, T_htf_cold_guess_warmer, 0.0, T_htf_cold_solved, tol_solved, iter_solved);
 				}
 				catch (C_csp_exception)
 				{
@@ -2631,7 +2705,7 @@ void C_csp_solver::Ssimulate(C_csp_solver::S_sim_setup & sim_setup)
 				int T_cold_code = 0;
 				try
 				{
-					T_cold_code = c_solver.solve(T_cold_guess_low, T_cold_guess_high, 0.0, T_cold_solved, tol_solved, iter_solved);
+					T_cold_code = mc_mono_eq_cache.solve("C_mono_eq_cr_on_pc_target_tes_ch__T_cold", c_solver, T_cold_guess_low, T_cold_guess_high, 0.0, T_cold_solved, tol_solved, iter_solved);
 				}
 				catch (C_csp_exception)
 				{
@@ -2745,7 +2819,7 @@ void C_csp_solver::Ssimulate(C_csp_solver::S_sim_setup & sim_setup)
 				int T_cold_code = 0;
 				try
 				{
-					T_cold_code = c_solver.solve(T_cold_guess_low, T_cold_guess_high, 0.0, T_cold_solved, tol_solved, iter_solved);
+					T_cold_code = mc_mono_eq_cache.solve("C_mono_eq_cr_on_pc_target_tes_dc", c_solver, T_cold_guess_low, T_cold_guess_high, 0.0, T_cold_solved, tol_solved, iter_solved);
 				}
 				catch (C_csp_exception)
 				{
@@ -2861,7 +2935,7 @@ void C_csp_solver::Ssimulate(C_csp_solver::S_sim_setup & sim_setup)
 				int solver_code = 0;
 				try
 				{
-					solver_code = c_solver.solve(T_htf_cold_guess_colder, T_htf_cold_guess_warmer, 0.0, T_htf_cold_solved, tol_solved, iter_solved);
+					solver_code = mc_mono_eq_cache.solve("C_mono_eq_cr_on_pc_match_tes_empty", c_solver, T_htf_cold_guess_colder, T_htf_cold_guess_warmer, 0.0, T_htf_cold_solved, tol_solved, iter_solved);
 				}
 				catch (C_csp_exception)
 				{
@@ -3004,7 +3078,7 @@ void C_csp_solver::Ssimulate(C_csp_solver::S_sim_setup & sim_setup)
 					int defocus_code = 0;
 					try
 					{
-						defocus_code = c_solver.solve(defocus_guess, defocus_guess_2, -1.E-3, defocus_solved, tol_solved, iter_solved);
+						defocus_code = mc_mono_eq_cache.solve("C_MEQ_cr_df__pc_off__tes_full__defocus", c_solver, defocus_guess, defocus_guess_2, -1.E-3, defocus_solved, tol_solved, iter_solved);
 					}
 					catch (C_csp_exception)
 					{
@@ -3057,7 +3131,7 @@ void C_csp_solver::Ssimulate(C_csp_solver::S_sim_setup & sim_setup)
 					int solver_code = 0;
 					try
 					{
-						solver_code = c_solver.solve(T_htf_cold_guess_colder, T_htf_cold_guess_warmer, 0.0, T_htf_cold_solved, tol_solved, iter_solved);
+						solver_code = mc_mono_eq_cache.solve("C_MEQ_cr_on__pc_off__tes_ch__T_htf_cold", c_solver, T_htf_cold_guess_colder, T_htf_cold_guess_warmer, 0.0, T_htf_cold_solved, tol_solved, iter_solved);
 					}
 					catch (C_csp_exception)
 					{
@@ -3271,7 +3345,7 @@ void C_csp_solver::Ssimulate(C_csp_solver::S_sim_setup & sim_setup)
 				int solver_code = 0;
 				try
 				{
-					solver_code = c_solver.solve(T_htf_cold_guess_colder, T_htf_cold_guess_hotter,
+					solver_code = mc_mono_eq_cache.solve("C_mono_eq_pc_match_tes_empty", c_solver, T_htf_cold_guess_colder, T_htf_cold_guess_hotter,
 						0.0, T_htf_cold_solved, tol_solved, iter_solved);
 				}
 				catch (C_csp_exception)
@@ -3448,7 +3522,7 @@ void C_csp_solver::Ssimulate(C_csp_solver::S_sim_setup & sim_setup)
 				int T_cold_code = 0;
 				try
 				{
-					T_cold_code = c_solver.solve(T_cold_guess_low, T_cold_guess_high, 0.0, T_cold_solved, tol_solved, iter_solved);
+					T_cold_code = mc_mono_eq_cache.solve("C_mono_eq_pc_target_tes_empty__T_cold", c_solver, T_cold_guess_low, T_cold_guess_high, 0.0, T_cold_solved, tol_solved, iter_solved);
 				}
 				catch (C_csp_exception)
 				{
@@ -3608,7 +3682,7 @@ void C_csp_solver::Ssimulate(C_csp_solver::S_sim_setup & sim_setup)
 				int T_cold_code = 0;
 				try
 				{
-					T_cold_code = c_solver.solve(T_cold_guess_low, T_cold_guess_high, 0.0, T_cold_solved, tol_solved, iter_solved);
+					T_cold_code = mc_mono_eq_cache.solve("C_mono_eq_cr_on_pc_target_tes_dc", c_solver, T_cold_guess_low, T_cold_guess_high, 0.0, T_cold_solved, tol_solved, iter_solved);
 				}
 				catch (C_csp_exception)
 				{
@@ -3807,7 +3881,7 @@ void C_csp_solver::Ssimulate(C_csp_solver::S_sim_setup & sim_setup)
 				int T_cold_code = 0;
 				try
 				{
-					T_cold_code = c_solver.solve(T_cold_guess_low, T_cold_guess_high, 0.0, T_cold_solved, tol_solved, iter_solved);
+					T_cold_code = mc_mono_eq_cache.solve("C_mono_eq_pc_target_tes_dc__T_cold", c_solver, T_cold_guess_low, T_cold_guess_high, 0.0, T_cold_solved, tol_solved, iter_solved);
 				}
 				catch (C_csp_exception)
 				{
@@ -3930,7 +4004,7 @@ void C_csp_solver::Ssimulate(C_csp_solver::S_sim_setup & sim_setup)
 				int solver_code = 0;
 				try
 				{
-					solver_code = c_solver.solve(T_cold_guess_low, T_cold_guess_high, 0.0, T_cold_solved, tol_solved, iter_solved);
+					solver_code = mc_mono_eq_cache.solve("C_mono_eq_cr_on__pc_match_m_dot_ceil__tes_full", c_solver, T_cold_guess_low, T_cold_guess_high, 0.0, T_cold_solved, tol_solved, iter_solved);
 				}
 				catch (C_csp_exception)
 				{
@@ -4016,7 +4090,7 @@ void C_csp_solver::Ssimulate(C_csp_solver::S_sim_setup & sim_setup)
 
 				try
 				{
-					solver_code = c_solver.solve(T_htf_cold_guess_colder, T_htf_cold_guess_warmer, 0.0, T_htf_cold_solved, tol_solved, iter_solved);
+					solver_code = mc_mono_eq_cache.solve("C_MEQ_cr_on__pc_target__tes_empty__T_htf_cold", c_solver, T_htf_cold_guess_colder, T_htf_cold_guess_warmer, 0.0, T_htf_cold_solved, tol_solved, iter_solved);
 				}
 				catch (C_csp_exception)
 				{
@@ -4296,7 +4370,7 @@ void C_csp_solver::Ssimulate(C_csp_solver::S_sim_setup & sim_setup)
 					int solver_code = 0;
 					try
 					{
-						solver_code = c_solver.solve(defocus_guess_low, defocus_guess_high, q_pc_max, defocus_solved, tol_solved, iter_solved);
+						solver_code = mc_mono_eq_cache.solve("C_mono_eq_cr_on__pc_target__tes_full__defocus", c_solver, defocus_guess_low, defocus_guess_high, q_pc_max, defocus_solved, tol_solved, iter_solved);
 					}
 					catch (C_csp_exception)
 					{
@@ -4426,7 +4500,7 @@ void C_csp_solver::Ssimulate(C_csp_solver::S_sim_setup & sim_setup)
 						int solver_code = 0;
 						try
 						{
-							solver_code = c_solver.solve(T_cold_guess_low, T_cold_guess_high, 0.0, T_cold_solved, tol_solved, iter_solved);
+							solver_code = mc_mono_eq_cache.solve("C_mono_eq_cr_on__pc_match_m_dot_ceil__tes_full", c_solver, T_cold_guess_low, T_cold_guess_high, 0.0, T_cold_solved, tol_solved, iter_solved);
 						}
 						catch (C_csp_exception)
 						{
@@ -4504,7 +4578,7 @@ void C_csp_solver::Ssimulate(C_csp_solver::S_sim_setup & sim_setup)
 				int solver_code = 0;
 				try
 				{
-					solver_code = c_solver.solve(T_cold_guess_low, T_cold_guess_high, 0.0, T_cold_solved, tol_solved, iter_solved);
+					solver_code = mc_mono_eq_cache.solve("C_mono_eq_cr_on__pc_match_m_dot_ceil__tes_full", c_solver, T_cold_guess_low, T_cold_guess_high, 0.0, T_cold_solved, tol_solved, iter_solved);
 				}
 				catch (C_csp_exception)
 				{
@@ -4756,6 +4830,11 @@ void C_csp_solver::Ssimulate(C_csp_solver::S_sim_setup & sim_setup)
 				throw(C_csp_exception("Operation mode not recognized",""));
 
 			}	// End switch() on receiver operating modes
+
+			if( is_op_mode_profile )
+			{
+				mc_kernel.op_mode_profile_end(are_models_converged);
+			}
 		
 		}	
         
@@ -4988,6 +5067,11 @@ void C_csp_solver::Ssimulate(C_csp_solver::S_sim_setup & sim_setup)
 				mc_reported_outputs.overwrite_most_recent_timestep(C_solver_outputs::TIME_FINAL, m_report_time_end / 3600.0);	//[hr]
 				mc_reported_outputs.send_to_reporting_ts_array(m_report_time_start, mv_time_local, m_report_time_end);
 
+				if( mp_output_sink != 0 )
+				{
+					mp_output_sink->end_reporting_timestep(m_report_time_end);
+				}
+
 				// Check if the most recent csp solver timestep aligns with the end of the reporting timestep
 				bool delete_last_step = false;
 				int pop_back_start = 1;
@@ -5068,6 +5152,19 @@ void C_csp_solver::Ssimulate(C_csp_solver::S_sim_setup & sim_setup)
 		
 	}	// End timestep loop
 
+	if( mc_mono_eq_cache.is_enabled() )
+	{
+		std::vector<C_monotonic_eq_solver_cache::S_eq_class_stats> v_stats;
+		mc_mono_eq_cache.get_stats(v_stats);
+
+		for( int i = 0; i < (int)v_stats.size(); i++ )
+		{
+			mc_csp_messages.add_message(C_csp_messages::NOTICE, util::format("Operating mode %d, equation %s: %d solves, %d warm starts (%d converged), %d iterations, %d equation calls",
+				v_stats[i].m_key, v_stats[i].m_eq_name.c_str(), v_stats[i].m_n_solves, v_stats[i].m_n_warm_starts,
+				v_stats[i].m_n_warm_converged, v_stats[i].m_n_iter, v_stats[i].m_n_eq_calls));
+		}
+	}
+
 }	// End simulate() method
 
 
@@ -5098,7 +5195,7 @@ void C_csp_solver::solver_pc_su_controlled__tes_dc(double step_tol /*s*/,
 	int solver_code = 0;
 	try
 	{
-		solver_code = c_solver.solve(T_htf_hot_guess_colder, T_htf_hot_guess_hotter,
+		solver_code = mc_mono_eq_cache.solve("C_mono_eq_pc_su_cont_tes_dc", c_solver, T_htf_hot_guess_colder, T_htf_hot_guess_hotter,
 								0.0, T_htf_hot_solved, tol_solved, iter_solved);
 	}
 	catch (C_csp_exception)
@@ -5201,7 +5298,7 @@ int C_csp_solver::solver_cr_on__pc_match__tes_full(int pc_mode, double defocus_i
 	int T_cold_code = 0;
 	try
 	{
-		T_cold_code = c_solver.solve(T_cold_guess_low, T_cold_guess_high, 0.0, T_cold_solved, tol_solved, iter_solved);
+		T_cold_code = mc_mono_eq_cache.solve("C_mono_eq_cr_on__pc_match__tes_full", c_solver, T_cold_guess_low, T_cold_guess_high, 0.0, T_cold_solved, tol_solved, iter_solved);
 	}
 	catch (C_csp_exception)
 	{
@@ -5254,7 +5351,7 @@ int C_csp_solver::solver_pc_fixed__tes_empty(double q_dot_pc_fixed /*MWt*/,
 	int T_cold_code = 0;
 	try
 	{
-		T_cold_code = c_solver.solve(T_cold_guess_low, T_cold_guess_high, 0.0, T_cold_solved, tol_solved, iter_solved);
+		T_cold_code = mc_mono_eq_cache.solve("C_mono_eq_pc_target_tes_empty__T_cold", c_solver, T_cold_guess_low, T_cold_guess_high, 0.0, T_cold_solved, tol_solved, iter_solved);
 	}
 	catch (C_csp_exception)
 	{
@@ -5310,7 +5407,7 @@ void C_csp_solver::solver_cr_to_pc_to_cr(int pc_mode, double field_control_in, d
 	int solver_code = 0;
 	try
 	{
-		solver_code = c_solver.solve(T_htf_cold_guess_colder, T_htf_cold_guess_warmer, 0.0, T_htf_cold_solved, tol_solved, iter_solved);
+		solver_code = mc_mono_eq_cache.solve("C_mono_eq_cr_to_pc_to_cr", c_solver, T_htf_cold_guess_colder, T_htf_cold_guess_warmer, 0.0, T_htf_cold_solved, tol_solved, iter_solved);
 	}
 	catch (C_csp_exception)
 	{
@@ -53,6 +53,7 @@
 #include <numeric>
 #include <limits>
 #include <memory>
+#include <chrono>
 
 #include "lib_weatherfile.h"
 #include "csp_solver_util.h"
@@ -673,6 +674,9 @@ public:
 
 	virtual void assign(int index, float *p_reporting_ts_array, int n_reporting_ts_array) = 0;
 
+	// Sends reported output 'index' to a sink column (see C_csp_reported_outputs::stream)
+	virtual void stream(int index, C_csp_output_sink *p_sink, const std::string & name) = 0;
+
 };
 
 class C_csp_tes
@@ -844,6 +848,21 @@ public:
 		}
 	};
 
+	struct S_op_mode_profile
+	{
+		int m_n_calls;			//[-] Number of times the operating mode was tried
+		int m_n_rejected;		//[-] Number of tries that didn't converge, so the controller moved to another mode
+		int m_n_iter;			//[-] Monotonic solver iterations, including solves inside the component models
+		int m_n_eq_calls;		//[-] Monotonic equation calls, including solves inside the component models
+		double m_time;			//[s] Cumulative wall clock time
+
+		S_op_mode_profile()
+		{
+			m_n_calls = m_n_rejected = m_n_iter = m_n_eq_calls = 0;
+			m_time = 0.0;
+		}
+	};
+
 	class C_csp_solver_kernel
 	{
 	private:
@@ -853,6 +872,13 @@ public:
 
 		C_timestep_fixed mc_ts_sim_baseline;
 
+		// Per-operating-mode profiling. Off when the vector is empty
+		std::vector<S_op_mode_profile> mv_op_mode_profile;
+		int m_op_mode_profiled;				//[-] Operating mode being timed
+		int m_n_iter_profile_start;			//[-] Solver iteration count at start of operating mode
+		int m_n_eq_calls_profile_start;		//[-] Equation call count at start of operating mode
+		std::chrono::steady_clock::time_point m_time_profile_start;
+
 	public:
 			
 		C_csp_solver_sim_info mc_sim_info;
@@ -872,6 +898,16 @@ public:
 
 		const S_sim_setup * get_sim_setup();
 
+		void init_op_mode_profile(int n_op_modes);
+
+		bool is_op_mode_profile();
+
+		void op_mode_profile_start(int op_mode);
+
+		void op_mode_profile_end(bool is_converged);
+
+		const std::vector<S_op_mode_profile> & get_op_mode_profile();
+
 	};
 	
 	struct S_csp_system_params
@@ -1037,6 +1073,8 @@ private:
 	bool(*mpf_callback)(std::string &log_msg, std::string &progress_msg, void *data, double progress, int log_type);
 	void *mp_cmod_active;
 
+	C_csp_output_sink *mp_output_sink;
+
 	void send_callback(double percent);
 
 public:
@@ -1044,6 +1082,9 @@ public:
 	// Class to save messages for up stream classes
 	C_csp_messages mc_csp_messages;
 
+	// Opt-in solver state cache for operating mode solves. Call mc_mono_eq_cache.enable() before Ssimulate()
+	C_monotonic_eq_solver_cache mc_mono_eq_cache;
+
 	// Vector to track operating modes
 	std::vector<int> m_op_mode_tracking;
 
@@ -1126,6 +1167,16 @@ public:
 
 	double get_cr_aperture_area();
 
+	// Optional per-operating-mode call counts, solver iterations, and time. Call before Ssimulate()
+	void enable_op_mode_profile();
+
+	// Indexed by tech_operating_modes
+	const std::vector<S_op_mode_profile> & get_op_mode_profile();
+
+	// Optional sink shared by the solver and component reported outputs (see C_csp_reported_outputs::stream)
+	// The solver completes a sink row after all components report each reporting timestep
+	void set_output_sink(C_csp_output_sink *p_output_sink);
+
 	// Output vectors
 	// Need to be sure these are always up-to-date as multiple operating modes are tested during one timestep
 	std::vector< std::vector< double > > mvv_outputs_temp;
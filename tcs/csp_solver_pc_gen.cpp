@@ -338,6 +338,11 @@ void C_pc_gen::write_output_intervals(double report_time_start,
 		v_temp_ts_time_end, report_time_end);
 }
 
+void C_pc_gen::stream(int index, C_csp_output_sink *p_sink, const std::string & name)
+{
+	mc_reported_outputs.stream(index, p_sink, name);
+}
+
 void C_pc_gen::assign(int index, float *p_reporting_ts_array, int n_reporting_ts_array)
 {
 	mc_reported_outputs.assign(index, p_reporting_ts_array, n_reporting_ts_array);
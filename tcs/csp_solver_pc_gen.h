@@ -158,6 +158,8 @@ public:
 
 	virtual void assign(int index, float *p_reporting_ts_array, int n_reporting_ts_array);
 
+	virtual void stream(int index, C_csp_output_sink *p_sink, const std::string & name);
+
 };
 
 
@@ -143,6 +143,8 @@ public:
 		const std::vector<double> & v_temp_ts_time_end, double report_time_end);
 
 	virtual void assign(int index, float *p_reporting_ts_array, int n_reporting_ts_array);
+
+	virtual void stream(int index, C_csp_output_sink *p_sink, const std::string & name);
 };
 
 
@@ -52,6 +52,9 @@
 
 #include "htf_props.h"
 
+#include <cmath>
+#include <sstream>
+
 static C_csp_reported_outputs::S_output_info S_output_info[] =
 {
 	{C_pc_sco2::E_ETA_THERMAL, C_csp_reported_outputs::TS_WEIGHTED_AVE},
@@ -66,7 +69,293 @@ static C_csp_reported_outputs::S_output_info S_output_info[] =
 	csp_info_invalid
 };
 
-C_pc_sco2::C_pc_sco2()
+C_sco2_od_surface::C_sco2_od_surface()
+{
+	mpf_od = 0;
+
+	m_n_queries = m_n_solved = m_n_loaded = 0;
+}
+
+void C_sco2_od_surface::init(C_od_function *pf_od, const S_params & params, const std::string & file_name)
+{
+	mpf_od = pf_od;
+	ms_params = params;
+
+	if( ms_params.m_n_levels < 0 || ms_params.m_n_levels > 7 )
+	{
+		throw(C_csp_exception("The number of sCO2 off-design surface levels must be between 0 and 7", "sCO2 off-design surface"));
+	}
+
+	m_nodes.clear();
+	m_cells.clear();
+	m_n_queries = m_n_solved = m_n_loaded = 0;
+
+	if( m_file.is_open() )
+		m_file.close();
+	m_file_name = file_name;
+
+	if( m_file_name != "" )
+	{
+		// Solutions from a file only apply to the same design and lattice, otherwise start over
+		load_nodes();
+
+		if( m_n_loaded > 0 )
+		{
+			m_file.open(m_file_name.c_str(), std::ios::out | std::ios::app);
+		}
+		else
+		{
+			m_file.open(m_file_name.c_str(), std::ios::out | std::ios::trunc);
+			if( m_file.is_open() )
+				m_file << file_header() << "\n";
+		}
+
+		if( !m_file.is_open() )
+		{
+			throw(C_csp_exception("Could not open sCO2 off-design surface file " + m_file_name, "sCO2 off-design surface"));
+		}
+		m_file.precision(17);
+	}
+}
+
+bool C_sco2_od_surface::is_initialized()
+{
+	return mpf_od != 0;
+}
+
+std::string C_sco2_od_surface::file_header()
+{
+	std::ostringstream header;
+	header.precision(17);
+	header << "sco2_od_surface 2 " << ms_params.m_T_htf_hot_des << " " << ms_params.m_T_htf_cold_des << " "
+		<< ms_params.m_T_amb_des << " " << ms_params.m_W_dot_net_des << " " << ms_params.m_eta_des << " "
+		<< ms_params.m_d_T_htf_hot << " " << ms_params.m_d_m_dot_htf_ND << " " << ms_params.m_d_T_amb << " "
+		<< ms_params.m_n_levels << " " << ms_params.m_design_id;
+
+	return header.str();
+}
+
+void C_sco2_od_surface::load_nodes()
+{
+	std::ifstream file_in(m_file_name.c_str());
+	if( !file_in.is_open() )
+		return;
+
+	std::string header;
+	std::getline(file_in, header);
+	if( header != file_header() )
+		return;
+
+	int i, j, k;
+	S_od_point od_point;
+	while( file_in >> i >> j >> k >> od_point.m_od_code >> od_point.m_W_dot_net >> od_point.m_eta_thermal >> od_point.m_T_htf_cold )
+	{
+		if( od_point.m_od_code != 0 )
+			od_point.m_W_dot_net = od_point.m_eta_thermal = od_point.m_T_htf_cold = std::numeric_limits<double>::quiet_NaN();
+
+		m_nodes[node_key(i, j, k)] = od_point;
+		m_n_loaded++;
+	}
+}
+
+long long C_sco2_od_surface::node_key(int i, int j, int k)
+{
+	// 20 bits per index, leaving the top bits for the cell level
+	const long long bias = 1LL << 19;
+	return ((i + bias) << 40) | ((j + bias) << 20) | (k + bias);
+}
+
+const C_sco2_od_surface::S_od_point & C_sco2_od_surface::node(int i, int j, int k)
+{
+	long long key = node_key(i, j, k);
+	std::map<long long, S_od_point>::iterator it = m_nodes.find(key);
+	if( it != m_nodes.end() )
+		return it->second;
+
+	// Nodes are on a lattice twice as fine as the smallest cell, so every cell center is a node
+	double f_node = (double)(1 << (ms_params.m_n_levels + 1));		//[-]
+	double T_htf_hot = ms_params.m_T_htf_hot_des + ms_params.m_d_T_htf_hot*i / f_node;	//[K]
+	double m_dot_htf_ND = 1.0 + ms_params.m_d_m_dot_htf_ND*j / f_node;					//[-]
+	double T_amb = ms_params.m_T_amb_des + ms_params.m_d_T_amb*k / f_node;				//[K]
+
+	S_od_point od_point;
+	try
+	{
+		od_point.m_od_code = (*mpf_od)(T_htf_hot, m_dot_htf_ND, T_amb, od_point);
+	}
+	catch( C_csp_exception & )
+	{
+		// Node is outside the range the cycle can solve: store it as failed so queries near it
+		//    are solved directly, and an exception only reaches the caller from its own point
+		od_point = S_od_point();
+		od_point.m_od_code = E_OD_EXCEPTION;
+	}
+	m_n_solved++;
+
+	if( m_file.is_open() )
+	{
+		// Failed solutions don't have results, and NaN can't be read back
+		if( od_point.m_od_code == 0 )
+			m_file << i << " " << j << " " << k << " 0 " << od_point.m_W_dot_net << " "
+				<< od_point.m_eta_thermal << " " << od_point.m_T_htf_cold << "\n";
+		else
+			m_file << i << " " << j << " " << k << " " << od_point.m_od_code << " 0 0 0\n";
+		m_file.flush();
+	}
+
+	return m_nodes[key] = od_point;
+}
+
+int C_sco2_od_surface::cell_state(int level, int i, int j, int k)
+{
+	long long key = ((long long)level << 60) | node_key(i, j, k);
+	std::map<long long, int>::iterator it = m_cells.find(key);
+	if( it != m_cells.end() )
+		return it->second;
+
+	// Cell size in node lattice units
+	int s = 1 << (ms_params.m_n_levels - level + 1);
+
+	int n_failed = 0;
+	double W_dot_interp = 0.0;
+	double eta_interp = 0.0;
+	double T_htf_cold_interp = 0.0;
+	for( int c = 0; c < 8; c++ )
+	{
+		const S_od_point & corner = node(s*(i + (c & 1)), s*(j + ((c >> 1) & 1)), s*(k + ((c >> 2) & 1)));
+		if( corner.m_od_code != 0 )
+		{
+			n_failed++;
+			continue;
+		}
+		W_dot_interp += corner.m_W_dot_net / 8.0;
+		eta_interp += corner.m_eta_thermal / 8.0;
+		T_htf_cold_interp += corner.m_T_htf_cold / 8.0;
+	}
+
+	const S_od_point & center = node(s*i + s / 2, s*j + s / 2, s*k + s / 2);
+	if( center.m_od_code != 0 )
+		n_failed++;
+
+	int state = E_CELL_DIRECT;
+	if( n_failed == 0 )
+	{
+		double err_W_dot = fabs(W_dot_interp - center.m_W_dot_net) / ms_params.m_W_dot_net_des;		//[-]
+		double err_eta = fabs(eta_interp - center.m_eta_thermal) / ms_params.m_eta_des;				//[-]
+		double err_T_htf_cold = fabs(T_htf_cold_interp - center.m_T_htf_cold) /
+			(ms_params.m_T_htf_hot_des - ms_params.m_T_htf_cold_des);								//[-]
+
+		if( std::max(err_W_dot, std::max(err_eta, err_T_htf_cold)) <= ms_params.m_tol )
+			state = E_CELL_ACCEPTED;
+		else if( level < ms_params.m_n_levels )
+			state = E_CELL_SPLIT;
+	}
+	else if( n_failed < 9 && level < ms_params.m_n_levels )
+	{
+		// Cell crosses the edge of the operating range: split to narrow it down.
+		//    If nothing in the cell solves, don't spend solutions on splitting it
+		state = E_CELL_SPLIT;
+	}
+
+	m_cells[key] = state;
+
+	return state;
+}
+
+int C_sco2_od_surface::get_od_point(double T_htf_hot /*K*/, double m_dot_htf_ND /*-*/, double T_amb /*K*/, S_od_point & od_point)
+{
+	if( mpf_od == 0 )
+	{
+		throw(C_csp_exception("C_sco2_od_surface::get_od_point(...) requires that init(...) is called first", "sCO2 off-design surface"));
+	}
+
+	m_n_queries++;
+
+	// Position in units of the coarsest cells. Scaling by powers of 2 is exact, so child cells
+	//    found at each level are always inside their parent
+	double x_T_htf_hot = (T_htf_hot - ms_params.m_T_htf_hot_des) / ms_params.m_d_T_htf_hot;	//[-]
+	double x_m_dot_htf = (m_dot_htf_ND - 1.0) / ms_params.m_d_m_dot_htf_ND;					//[-]
+	double x_T_amb = (T_amb - ms_params.m_T_amb_des) / ms_params.m_d_T_amb;					//[-]
+
+	for( int level = 0; level <= ms_params.m_n_levels; level++ )
+	{
+		double f = (double)(1 << level);
+		double y_T_htf_hot = x_T_htf_hot*f;
+		double y_m_dot_htf = x_m_dot_htf*f;
+		double y_T_amb = x_T_amb*f;
+		int i = (int)floor(y_T_htf_hot);
+		int j = (int)floor(y_m_dot_htf);
+		int k = (int)floor(y_T_amb);
+
+		int state = cell_state(level, i, j, k);
+
+		if( state == E_CELL_SPLIT )
+			continue;
+
+		if( state == E_CELL_DIRECT )
+			break;
+
+		// Trilinear interpolation between the cell corners
+		int s = 1 << (ms_params.m_n_levels - level + 1);
+		double t[3] = {y_T_htf_hot - i, y_m_dot_htf - j, y_T_amb - k};
+
+		od_point.m_od_code = 0;
+		od_point.m_W_dot_net = od_point.m_eta_thermal = od_point.m_T_htf_cold = 0.0;
+		for( int c = 0; c < 8; c++ )
+		{
+			int c_i = c & 1;
+			int c_j = (c >> 1) & 1;
+			int c_k = (c >> 2) & 1;
+			double w = (c_i ? t[0] : 1.0 - t[0])*(c_j ? t[1] : 1.0 - t[1])*(c_k ? t[2] : 1.0 - t[2]);
+
+			const S_od_point & corner = node(s*(i + c_i), s*(j + c_j), s*(k + c_k));
+			od_point.m_W_dot_net += w*corner.m_W_dot_net;
+			od_point.m_eta_thermal += w*corner.m_eta_thermal;
+			od_point.m_T_htf_cold += w*corner.m_T_htf_cold;
+		}
+
+		return 0;
+	}
+
+	m_n_solved++;
+	return (*mpf_od)(T_htf_hot, m_dot_htf_ND, T_amb, od_point);
+}
+
+long long C_sco2_od_surface::get_n_queries()
+{
+	return m_n_queries;
+}
+
+long long C_sco2_od_surface::get_n_solved()
+{
+	return m_n_solved;
+}
+
+long long C_sco2_od_surface::get_n_loaded()
+{
+	return m_n_loaded;
+}
+
+int C_pc_sco2::C_sco2_od_solve::operator()(double T_htf_hot /*K*/, double m_dot_htf_ND /*-*/, double T_amb /*K*/, C_sco2_od_surface::S_od_point & od_point)
+{
+	C_sco2_rc_csp_template::S_od_par sco2_rc_od_par;
+	sco2_rc_od_par.m_T_htf_hot = T_htf_hot;									//[K]
+	sco2_rc_od_par.m_m_dot_htf = m_dot_htf_ND*mpc_pc->m_m_dot_htf_des / 3600.0;	//[kg/s]
+	sco2_rc_od_par.m_T_amb = T_amb;											//[K]
+
+	od_point.m_od_code = mpc_pc->mpc_sco2_recomp->off_design_nested_opt(sco2_rc_od_par, C_sco2_rc_csp_template::E_TARGET_POWER_ETA_MAX);
+
+	if( od_point.m_od_code == 0 )
+	{
+		od_point.m_W_dot_net = mpc_pc->mpc_sco2_recomp->get_od_solved()->ms_rc_cycle_od_solved.m_W_dot_net;	//[kWe]
+		od_point.m_eta_thermal = mpc_pc->mpc_sco2_recomp->get_od_solved()->ms_rc_cycle_od_solved.m_eta_thermal;	//[-]
+		od_point.m_T_htf_cold = mpc_pc->mpc_sco2_recomp->get_od_solved()->ms_phx_od_solved.m_T_h_out;			//[K]
+	}
+
+	return od_point.m_od_code;
+}
+
+C_pc_sco2::C_pc_sco2() : mc_od_solve(this)
 {
 	m_q_dot_design = m_q_dot_standby = m_q_dot_max = m_q_dot_min = m_startup_energy_required = 
 		m_W_dot_des = m_T_htf_cold_des = m_m_dot_htf_des =
@@ -78,6 +367,42 @@ C_pc_sco2::C_pc_sco2()
 	mc_reported_outputs.construct(S_output_info);
 }
 
+std::string C_pc_sco2::od_surface_design_id()
+{
+	const C_sco2_rc_csp_template::S_des_par & des_par = ms_params.ms_mc_sco2_recomp_params;
+
+	std::ostringstream id;
+	id.precision(17);
+	id << (mpc_sco2_recomp == &mc_sco2_recomp_csp_scale ? "scale" : "direct")
+		<< " od " << C_sco2_rc_csp_template::E_TARGET_POWER_ETA_MAX
+		<< " m_dot_htf " << m_m_dot_htf_des
+		<< " fl " << des_par.m_hot_fl_code;
+	if( des_par.m_hot_fl_code == HTFProperties::User_defined )
+	{
+		for( size_t i = 0; i < des_par.mc_hot_fl_props.nrows(); i++ )
+			for( size_t j = 0; j < des_par.mc_hot_fl_props.ncols(); j++ )
+				id << " " << des_par.mc_hot_fl_props(i, j);
+	}
+	id << " T_htf " << des_par.m_T_htf_hot_in << " " << des_par.m_phx_dt_hot_approach << " " << des_par.m_phx_dt_cold_approach
+		<< " T_amb " << des_par.m_T_amb_des << " " << des_par.m_dt_mc_approach << " " << des_par.m_elevation
+		<< " W " << des_par.m_W_dot_net << " method " << des_par.m_design_method << " " << des_par.m_eta_thermal << " " << des_par.m_UA_recup_tot_des;
+
+	const std::vector<double> * v_DP[4] = {&des_par.m_DP_LT, &des_par.m_DP_HT, &des_par.m_DP_PC, &des_par.m_DP_PHX};
+	id << " DP";
+	for( int k = 0; k < 4; k++ )
+		for( size_t i = 0; i < v_DP[k]->size(); i++ )
+			id << " " << (*v_DP[k])[i];
+
+	id << " eff " << des_par.m_LT_eff_max << " " << des_par.m_HT_eff_max
+		<< " eta " << des_par.m_eta_mc << " " << des_par.m_eta_rc << " " << des_par.m_eta_t
+		<< " N_sub " << des_par.m_N_sub_hxrs << " P_high " << des_par.m_P_high_limit
+		<< " tol " << des_par.m_tol << " " << des_par.m_opt_tol << " N_t " << des_par.m_N_turbine
+		<< " recomp " << des_par.m_is_recomp_ok << " PR " << des_par.m_PR_mc_guess << " " << des_par.m_fixed_PR_mc
+		<< " cooler " << des_par.m_frac_fan_power << " " << des_par.m_deltaP_cooler_frac;
+
+	return id.str();
+}
+
 void C_pc_sco2::init(C_csp_power_cycle::S_solved_params &solved_params)
 {
 	if (false)
@@ -156,6 +481,20 @@ void C_pc_sco2::init(C_csp_power_cycle::S_solved_params &solved_params)
 	m_startup_energy_remain_prev = m_startup_energy_required;		//[kWt-hr]
 	m_startup_time_remain_prev = ms_params.m_startup_time;			//[hr]
 
+	// Cached off-design surface, anchored at the design point
+	if( ms_params.m_is_od_surface )
+	{
+		C_sco2_od_surface::S_params surface_params;
+		surface_params.m_T_htf_hot_des = ms_params.ms_mc_sco2_recomp_params.m_T_htf_hot_in;	//[K]
+		surface_params.m_T_htf_cold_des = m_T_htf_cold_des;									//[K]
+		surface_params.m_T_amb_des = ms_params.ms_mc_sco2_recomp_params.m_T_amb_des;		//[K]
+		surface_params.m_W_dot_net_des = m_W_dot_des*1.E3;									//[kWe]
+		surface_params.m_eta_des = solved_params.m_eta_des;									//[-]
+		surface_params.m_tol = ms_params.m_od_surface_tol;									//[-]
+		surface_params.m_design_id = od_surface_design_id();
+
+		mc_od_surface.init(&mc_od_solve, surface_params, ms_params.m_od_surface_file);
+	}
 }
 
 int C_pc_sco2::get_operating_state()
@@ -344,9 +683,25 @@ void C_pc_sco2::call(const C_csp_weatherreader::S_outputs &weather,
 			int od_strategy = C_sco2_rc_csp_template::E_TARGET_POWER_ETA_MAX;
 
 			int off_design_code = 0;
+			C_sco2_od_surface::S_od_point od_point;
 			try
 			{
-				off_design_code = mpc_sco2_recomp->off_design_nested_opt(sco2_rc_od_par, od_strategy);
+				if( ms_params.m_is_od_surface )
+				{
+					off_design_code = mc_od_surface.get_od_point(sco2_rc_od_par.m_T_htf_hot, m_dot_htf / m_m_dot_htf_des,
+										sco2_rc_od_par.m_T_amb, od_point);
+				}
+				else
+				{
+					off_design_code = mpc_sco2_recomp->off_design_nested_opt(sco2_rc_od_par, od_strategy);
+
+					if( off_design_code == 0 )
+					{
+						od_point.m_W_dot_net = mpc_sco2_recomp->get_od_solved()->ms_rc_cycle_od_solved.m_W_dot_net;	//[kWe]
+						od_point.m_eta_thermal = mpc_sco2_recomp->get_od_solved()->ms_rc_cycle_od_solved.m_eta_thermal;	//[-]
+						od_point.m_T_htf_cold = mpc_sco2_recomp->get_od_solved()->ms_phx_od_solved.m_T_h_out;			//[K]
+					}
+				}
 			}
 			catch( C_csp_exception &csp_exception )
 			{
@@ -356,9 +711,9 @@ void C_pc_sco2::call(const C_csp_weatherreader::S_outputs &weather,
 			// Was power cycle simulations successful?
 			if(off_design_code == 0)
 			{
-				P_cycle = mpc_sco2_recomp->get_od_solved()->ms_rc_cycle_od_solved.m_W_dot_net;	//[kWe]
-				eta = mpc_sco2_recomp->get_od_solved()->ms_rc_cycle_od_solved.m_eta_thermal;		//[-]
-				T_htf_cold = mpc_sco2_recomp->get_od_solved()->ms_phx_od_solved.m_T_h_out;		//[K]
+				P_cycle = od_point.m_W_dot_net;		//[kWe]
+				eta = od_point.m_eta_thermal;		//[-]
+				T_htf_cold = od_point.m_T_htf_cold;	//[K]
 				q_dot_htf = P_cycle/eta/1.E3;		//[MWt]
 			
 				W_cool_par = 0.0;
@@ -538,6 +893,11 @@ void C_pc_sco2::write_output_intervals(double report_time_start,
 		v_temp_ts_time_end, report_time_end);
 }
 
+void C_pc_sco2::stream(int index, C_csp_output_sink *p_sink, const std::string & name)
+{
+	mc_reported_outputs.stream(index, p_sink, name);
+}
+
 void C_pc_sco2::assign(int index, float *p_reporting_ts_array, int n_reporting_ts_array)
 {
 	mc_reported_outputs.assign(index, p_reporting_ts_array, n_reporting_ts_array);
@@ -55,6 +55,125 @@
 
 #include "sco2_pc_csp_int.h"
 
+#include <map>
+#include <string>
+#include <fstream>
+
+// Lazily built surface of off-design cycle solutions over (T_htf_hot, m_dot_htf_ND, T_amb).
+// Space is split into cells on a lattice anchored at the design point. A cell is accepted when
+//    trilinear interpolation of its 8 corner solutions matches the solution at its center
+//    within the tolerance; otherwise it's split in half along each axis, up to a maximum level.
+//    Queries in cells that still fail at the maximum level are solved directly.
+//    A node whose solve throws is stored as a failed node, so cells around it are solved directly.
+// Solutions can be saved to a file and reused by later runs with the same design
+class C_sco2_od_surface
+{
+public:
+
+	enum
+	{
+		E_OD_EXCEPTION = -2		//[-] Off-design solution code for a node whose solve threw an exception
+	};
+
+	struct S_od_point
+	{
+		int m_od_code;			//[-] Off-design solution code, 0 = success
+		double m_W_dot_net;		//[kWe] Net cycle power
+		double m_eta_thermal;	//[-] Cycle thermal efficiency
+		double m_T_htf_cold;	//[K] HTF outlet temperature
+
+		S_od_point()
+		{
+			m_od_code = -1;
+			m_W_dot_net = m_eta_thermal = m_T_htf_cold = std::numeric_limits<double>::quiet_NaN();
+		}
+	};
+
+	class C_od_function
+	{
+	public:
+		virtual int operator()(double T_htf_hot /*K*/, double m_dot_htf_ND /*-*/, double T_amb /*K*/, S_od_point & od_point) = 0;
+	};
+
+	struct S_params
+	{
+		double m_T_htf_hot_des;		//[K] Design HTF inlet temperature
+		double m_T_htf_cold_des;	//[K] Design HTF outlet temperature
+		double m_T_amb_des;			//[K] Design ambient temperature
+		double m_W_dot_net_des;		//[kWe] Design net cycle power
+		double m_eta_des;			//[-] Design thermal efficiency
+
+		double m_d_T_htf_hot;		//[K] Coarsest cell size
+		double m_d_m_dot_htf_ND;	//[-] Coarsest cell size
+		double m_d_T_amb;			//[K] Coarsest cell size
+		int m_n_levels;				//[-] Number of times a cell can be split
+
+		double m_tol;				//[-] Max interpolation error, normalized by design power, efficiency, and HTF temperature difference
+
+		std::string m_design_id;	//[-] Every cycle design and off-design input the node solutions depend on. Files with a different id aren't reused
+
+		S_params()
+		{
+			m_T_htf_hot_des = m_T_htf_cold_des = m_T_amb_des = m_W_dot_net_des = m_eta_des = std::numeric_limits<double>::quiet_NaN();
+
+			m_d_T_htf_hot = 10.0;		//[K]
+			m_d_m_dot_htf_ND = 0.1;		//[-]
+			m_d_T_amb = 5.0;			//[K]
+			m_n_levels = 3;				//[-]
+
+			m_tol = 0.002;				//[-]
+		}
+	};
+
+private:
+
+	enum
+	{
+		E_CELL_ACCEPTED,
+		E_CELL_SPLIT,
+		E_CELL_DIRECT
+	};
+
+	C_od_function *mpf_od;
+
+	S_params ms_params;
+
+	std::map<long long, S_od_point> m_nodes;	// Solutions at lattice nodes, keyed by finest-level indices
+	std::map<long long, int> m_cells;			// Cell states, keyed by level and cell indices
+
+	std::string m_file_name;
+	std::ofstream m_file;
+
+	long long m_n_queries;		//[-] Calls to 'get_od_point'
+	long long m_n_solved;		//[-] Off-design solutions, both nodes and direct queries
+	long long m_n_loaded;		//[-] Node solutions read from file
+
+	std::string file_header();
+
+	void load_nodes();
+
+	long long node_key(int i, int j, int k);
+
+	const S_od_point & node(int i, int j, int k);
+
+	int cell_state(int level, int i, int j, int k);
+
+public:
+
+	C_sco2_od_surface();
+
+	void init(C_od_function *pf_od, const S_params & params, const std::string & file_name);
+
+	bool is_initialized();
+
+	// Returns off-design solution code, 0 = success
+	int get_od_point(double T_htf_hot /*K*/, double m_dot_htf_ND /*-*/, double T_amb /*K*/, S_od_point & od_point);
+
+	long long get_n_queries();
+	long long get_n_solved();
+	long long get_n_loaded();
+};
+
 class C_pc_sco2 : public C_csp_power_cycle
 {
 
@@ -62,6 +181,24 @@ private:
 
 	C_sco2_rc_csp_template *mpc_sco2_recomp;
 
+	// Off-design solves used by the cached surface
+	class C_sco2_od_solve : public C_sco2_od_surface::C_od_function
+	{
+	private:
+		C_pc_sco2 *mpc_pc;
+
+	public:
+		C_sco2_od_solve(C_pc_sco2 *pc_pc)
+		{
+			mpc_pc = pc_pc;
+		}
+
+		virtual int operator()(double T_htf_hot /*K*/, double m_dot_htf_ND /*-*/, double T_amb /*K*/, C_sco2_od_surface::S_od_point & od_point);
+	};
+
+	C_sco2_od_solve mc_od_solve;
+	C_sco2_od_surface mc_od_surface;
+
 	C_sco2_recomp_csp mc_sco2_recomp_csp_direct;
 	C_sco2_recomp_csp_10MWe_scale mc_sco2_recomp_csp_scale;
 
@@ -85,6 +222,9 @@ private:
 	double m_startup_time_remain_calc;		//[hr]
 	double m_startup_energy_remain_calc;	//[kW-hr]
 
+	// Identifies the cycle design inputs, HTF, and off-design settings for the off-design surface file
+	std::string od_surface_design_id();
+
 public:
 
 	enum
@@ -115,9 +255,17 @@ public:
 		double m_startup_frac;		//[-] fraction of design thermal power needed for startup
 		double m_htf_pump_coef;		//[kW/kg/s] Pumping power to move 1 kg/s of HTF through power cycle
 
+		bool m_is_od_surface;			//[-] True: interpolate off-design performance from a cached surface of solutions
+		double m_od_surface_tol;		//[-] Max normalized interpolation error on the surface
+		std::string m_od_surface_file;	//[-] File to save and reuse surface solutions, empty = don't save
+
 		S_des_par()
 		{
 			m_cycle_max_frac = m_cycle_cutoff_frac = m_q_sby_frac = m_startup_time = m_startup_frac = m_htf_pump_coef = std::numeric_limits<double>::quiet_NaN();
+
+			m_is_od_surface = false;
+			m_od_surface_tol = 0.002;		//[-]
+			m_od_surface_file = "";
 		}
 	};
 
@@ -161,6 +309,13 @@ public:
 		const std::vector<double> & v_temp_ts_time_end, double report_time_end);
 
 	virtual void assign(int index, float *p_reporting_ts_array, int n_reporting_ts_array);
+
+	virtual void stream(int index, C_csp_output_sink *p_sink, const std::string & name);
+
+	C_sco2_od_surface * get_od_surface()
+	{
+		return &mc_od_surface;
+	}
 };
 
 
@@ -51,6 +51,8 @@
 
 #include "tcstype.h"
 
+#include <thread>
+
 using namespace std;
 
 static C_csp_reported_outputs::S_output_info S_output_info[] =
@@ -145,6 +147,7 @@ C_csp_trough_collector_receiver::C_csp_trough_collector_receiver()
 	m_accept_init = false;
 	m_accept_loc = -1;
 	m_is_using_input_gen = false;
+	m_use_hce_heat_loss_table = false;
 
 	m_solar_mult = std::numeric_limits<double>::quiet_NaN();
 	m_mc_bal_hot = std::numeric_limits<double>::quiet_NaN();
@@ -423,6 +426,9 @@ void C_csp_trough_collector_receiver::init(const C_csp_collector_receiver::S_csp
 	init_fieldgeom();
 	// for test end
 
+	if (m_use_hce_heat_loss_table)
+		init_hce_heat_loss_table();
+
 	// Calculate tracking parasitics for when trough is on sun
 	m_W_dot_sca_tracking_nom = m_SCA_drives_elec*(double)(m_nSCA*m_nLoops)/1.E6;	//[MWe]
 
@@ -3801,6 +3807,158 @@ void C_csp_trough_collector_receiver::EvacReceiver(double T_1_in, double m_dot,
 	//outputs
 	double &q_heatloss, double &q_12conv, double &q_34tot, double &c_1ave, double &rho_1ave)
 {
+	if (m_use_hce_heat_loss_table && EvacReceiver_table(T_1_in, m_dot, T_amb, m_T_sky, v_6, P_6, m_q_i, hn, hv, ct, sca_num, single_point,
+		q_heatloss, q_12conv, q_34tot, c_1ave, rho_1ave))
+	{
+		return;
+	}
+
+	double colopteff_tot = m_ColOptEff(ct, sca_num)*m_Dirt_HCE(hn, hv)*m_Shadowing(hn, hv);	//The total optical efficiency
+
+	evac_receiver_energy_balance(m_htfProps, m_T_save, mv_reguess_args,
+		T_1_in, m_dot, T_amb, m_T_sky, v_6, P_6, m_q_i, colopteff_tot, hn, hv, ct, single_point, ncall, time,
+		q_heatloss, q_12conv, q_34tot, c_1ave, rho_1ave);
+}
+
+bool C_csp_trough_collector_receiver::EvacReceiver_table(double T_1_in, double m_dot, double T_amb, double m_T_sky, double v_6, double P_6, double m_q_i,
+	int hn, int hv, int ct, int sca_num, bool single_point,
+	//outputs
+	double &q_heatloss, double &q_12conv, double &q_34tot, double &c_1ave, double &rho_1ave)
+{
+	double x[C_hce_heat_loss_table::E_N_AXES];
+	x[C_hce_heat_loss_table::E_T_HTF] = T_1_in;							//[K]
+	x[C_hce_heat_loss_table::E_Q_INC] = m_q_i*m_ColOptEff(ct, sca_num);	//[W/m]
+	x[C_hce_heat_loss_table::E_T_AMB] = T_amb;							//[K]
+	x[C_hce_heat_loss_table::E_V_WIND] = v_6;							//[m/s]
+	x[C_hce_heat_loss_table::E_DT_SKY] = T_amb - m_T_sky;				//[K]
+	x[C_hce_heat_loss_table::E_P_AMB] = P_6;							//[Pa]
+
+	double y[C_hce_heat_loss_table::E_N_OUTPUTS];
+	if (!mc_hce_heat_loss_table.evaluate(hn, hv, x, y))
+		return false;
+
+	double colopteff_tot = m_ColOptEff(ct, sca_num)*m_Dirt_HCE(hn, hv)*m_Shadowing(hn, hv);	//The total optical efficiency
+	double q_3SolAbs = m_q_i * colopteff_tot * m_alpha_abs(hn, hv);		//[W/m]
+	if (m_GlazingIntact(hn, hv))
+		q_3SolAbs *= m_Tau_envelope(hn, hv);
+
+	double T_1_ave = T_1_in;		//[K]
+	double cp_1 = m_htfProps.Cp(T_1_ave)*1000.;		//[J/kg-K]
+
+	if (!single_point)
+	{
+		// Same outlet temperature estimate as the full energy balance, then look up the loss again at the average HTF temperature
+		for (int i = 0; i < 2; i++)
+		{
+			double q_in_W = (q_3SolAbs - y[C_hce_heat_loss_table::E_Q_HEATLOSS]) * m_L_actSCA[ct];	//[W]
+			double T_1_out = max(m_T_sky, q_in_W / (m_dot*cp_1) + T_1_in);		//[K]
+			T_1_ave = (T_1_out + T_1_in) / 2.0;
+			cp_1 = m_htfProps.Cp(T_1_ave)*1000.;
+
+			x[C_hce_heat_loss_table::E_T_HTF] = T_1_ave;
+			if (!mc_hce_heat_loss_table.evaluate(hn, hv, x, y))
+				return false;
+		}
+	}
+
+	q_heatloss = y[C_hce_heat_loss_table::E_Q_HEATLOSS];	//[W/m]
+	q_34tot = y[C_hce_heat_loss_table::E_Q_34TOT];			//[W/m]
+	q_12conv = q_3SolAbs - q_heatloss;						//[W/m]
+	c_1ave = cp_1 / 1000.;									//[kJ/kg-K]
+	rho_1ave = m_htfProps.dens(T_1_ave, 0.0);				//[kg/m^3]
+
+	return true;
+}
+
+int C_csp_trough_collector_receiver::C_hce_heat_loss_point::operator()(int hn, int hv, const double *x, double *y)
+{
+	double q_12conv, c_1ave, rho_1ave;
+
+	// Single point solve at the table HTF temperature and design loop mass flow rate
+	return mpc_trough->evac_receiver_energy_balance(mc_htfProps, m_T_save, mv_reguess_args,
+		x[C_hce_heat_loss_table::E_T_HTF], mpc_trough->m_m_dot_loop_des, x[C_hce_heat_loss_table::E_T_AMB],
+		x[C_hce_heat_loss_table::E_T_AMB] - x[C_hce_heat_loss_table::E_DT_SKY], x[C_hce_heat_loss_table::E_V_WIND],
+		x[C_hce_heat_loss_table::E_P_AMB], x[C_hce_heat_loss_table::E_Q_INC],
+		mpc_trough->m_Dirt_HCE(hn, hv)*mpc_trough->m_Shadowing(hn, hv), hn, hv, 0, true, 0, 0.0,
+		y[C_hce_heat_loss_table::E_Q_HEATLOSS], q_12conv, y[C_hce_heat_loss_table::E_Q_34TOT], c_1ave, rho_1ave);
+}
+
+void C_csp_trough_collector_receiver::init_hce_heat_loss_table()
+{
+	// Table ranges cover the expected operating envelope of the field. Points outside use the full energy balance.
+	//    The node counts are a coarse starting grid that is refined where the check points need it
+	double q_inc_max = 0.0;		//[W/m]
+	for (int i = 0; i < m_nColt; i++)
+		q_inc_max = max(q_inc_max, 1.15*max(m_I_bn_des, 1000.0)*m_A_aperture[i] / m_L_SCA[i]);
+
+	C_hce_heat_loss_table::S_axis *axes = mc_hce_heat_loss_table.ms_axes;
+	axes[C_hce_heat_loss_table::E_T_HTF].m_min = min(m_T_fp, m_T_loop_in_des) - 50.0;	//[K]
+	axes[C_hce_heat_loss_table::E_T_HTF].m_max = m_T_loop_out_des + 75.0;				//[K]
+	axes[C_hce_heat_loss_table::E_T_HTF].m_n = 6;
+	axes[C_hce_heat_loss_table::E_Q_INC].m_min = 0.0;			//[W/m]
+	axes[C_hce_heat_loss_table::E_Q_INC].m_max = q_inc_max;		//[W/m]
+	axes[C_hce_heat_loss_table::E_Q_INC].m_n = 3;
+	axes[C_hce_heat_loss_table::E_T_AMB].m_min = 273.15 - 30.0;	//[K]
+	axes[C_hce_heat_loss_table::E_T_AMB].m_max = 273.15 + 50.0;	//[K]
+	axes[C_hce_heat_loss_table::E_T_AMB].m_n = 3;
+	// The outer glass surface switches to natural convection at and below 0.1 m/s; those steps use the full energy balance
+	axes[C_hce_heat_loss_table::E_V_WIND].m_min = 0.11;			//[m/s]
+	axes[C_hce_heat_loss_table::E_V_WIND].m_max = 25.0;			//[m/s]
+	axes[C_hce_heat_loss_table::E_V_WIND].m_n = 3;
+	axes[C_hce_heat_loss_table::E_DT_SKY].m_min = -5.0;			//[K]
+	axes[C_hce_heat_loss_table::E_DT_SKY].m_max = 50.0;			//[K]
+	axes[C_hce_heat_loss_table::E_DT_SKY].m_n = 2;
+	axes[C_hce_heat_loss_table::E_P_AMB].m_min = 60000.0;		//[Pa]
+	axes[C_hce_heat_loss_table::E_P_AMB].m_max = 105000.0;		//[Pa]
+	axes[C_hce_heat_loss_table::E_P_AMB].m_n = 2;
+
+	// Only generate tables for receivers that are actually in the field
+	util::matrix_t<bool> is_used(m_nHCEt, m_nHCEVar, false);
+	for (int i = 0; i < m_nSCA; i++)
+	{
+		int HT = (int)m_SCAInfoArray(i, 0) - 1;
+		for (int j = 0; j < m_nHCEVar; j++)
+		{
+			if (m_HCE_FieldFrac(HT, j) > 0.0)
+				is_used(HT, j) = true;
+		}
+	}
+
+	int n_threads = max(1, (int)std::thread::hardware_concurrency());
+	std::vector<C_hce_heat_loss_point> v_points(n_threads, C_hce_heat_loss_point(this));
+	std::vector<C_hce_heat_loss_table::C_point_solver*> v_solvers(n_threads);
+	for (int i = 0; i < n_threads; i++)
+		v_solvers[i] = &v_points[i];
+
+	mc_hce_heat_loss_table.generate(is_used, v_solvers);
+
+	for (int i = 0; i < m_nHCEt; i++)
+	{
+		for (int j = 0; j < m_nHCEVar; j++)
+		{
+			if (!is_used(i, j))
+				continue;
+
+			if (mc_hce_heat_loss_table.is_valid(i, j))
+			{
+				mc_csp_messages.add_message(C_csp_messages::NOTICE, util::format("HCE type %d variant %d heat loss table: %d nodes, max check error %lg W/m",
+					i + 1, j + 1, mc_hce_heat_loss_table.get_n_nodes(i, j), mc_hce_heat_loss_table.get_max_error(i, j)));
+			}
+			else
+			{
+				mc_csp_messages.add_message(C_csp_messages::WARNING, util::format("HCE type %d variant %d heat loss table failed the error check (max error %lg W/m); "
+					"the full receiver energy balance will be used for this receiver", i + 1, j + 1, mc_hce_heat_loss_table.get_max_error(i, j)));
+			}
+		}
+	}
+}
+
+int C_csp_trough_collector_receiver::evac_receiver_energy_balance(HTFProperties &htfProps, double *T_save, std::vector<double> &reguess_args,
+	double T_1_in, double m_dot, double T_amb, double m_T_sky, double v_6, double P_6, double m_q_i, double colopteff_tot,
+	int hn, int hv, int ct, bool single_point, int ncall, double time,
+	//outputs
+	double &q_heatloss, double &q_12conv, double &q_34tot, double &c_1ave, double &rho_1ave)
+{
 
 	//cc -- note that collector/hce geometry is part of the parent class. Only the indices specifying the
 	//		number of the HCE and collector need to be passed here.
@@ -3816,7 +3974,12 @@ void C_csp_trough_collector_receiver::EvacReceiver(double T_1_in, double m_dot,
 	bool UPFLAG, LOWFLAG, T3upflag, T3lowflag, is_e_table;
 	int m_qq, q5_iter, T1_iter, q_conv_iter;
 
-	double T_save_tot, colopteff_tot;
+	// Iteration counts and errors of the last T_3 iteration, for the convergence status
+	q5_iter = T1_iter = q_conv_iter = 0;
+	diff_q5 = diff_T1 = diff_T2 = 0.0;
+	q5_tol_1 = 0.0;
+
+	double T_save_tot;
 	
 	//cc--> note that xx and yy have size 'nea'
 
@@ -3827,16 +3990,16 @@ void C_csp_trough_collector_receiver::EvacReceiver(double T_1_in, double m_dot,
 	//---Re-guess criteria:---
 	if (time <= 2) goto lab_reguess;
 	
-	if (((int)mv_reguess_args[0] == 1) != m_GlazingIntact(hn, hv)) goto lab_reguess;	//glazingintact state has changed
+	if (((int)reguess_args[0] == 1) != m_GlazingIntact(hn, hv)) goto lab_reguess;	//glazingintact state has changed
 
-	if (m_P_a(hn, hv) != mv_reguess_args[1]) goto lab_reguess;                   //Reguess for different annulus pressure
+	if (m_P_a(hn, hv) != reguess_args[1]) goto lab_reguess;                   //Reguess for different annulus pressure
 
-	if (fabs(mv_reguess_args[2] - T_1_in) > 50.) goto lab_reguess;
+	if (fabs(reguess_args[2] - T_1_in) > 50.) goto lab_reguess;
 
-	for (int i = 0; i<5; i++){ if (m_T_save[i] < m_T_sky - 1.) goto lab_reguess; }
+	for (int i = 0; i<5; i++){ if (T_save[i] < m_T_sky - 1.) goto lab_reguess; }
 
 	T_save_tot = 0.;
-	for (int i = 0; i<5; i++){ T_save_tot += m_T_save[i]; }
+	for (int i = 0; i<5; i++){ T_save_tot += T_save[i]; }
 	if (T_save_tot != T_save_tot) goto lab_reguess;	//NaN check.. a value is only not equal to itself if it is NaN
 
 	reguess = false;
@@ -3850,42 +4013,42 @@ lab_keep_guess:
 
 	if (reguess) {
 		if (m_GlazingIntact(hn, hv)) {
-			m_T_save[0] = T_1_in;
-			m_T_save[1] = T_1_in + 2.;
-			m_T_save[2] = m_T_save[1] + 5.;
+			T_save[0] = T_1_in;
+			T_save[1] = T_1_in + 2.;
+			T_save[2] = T_save[1] + 5.;
 			if (m_P_a(hn, hv) > 1.0){          //Set guess values for different annulus pressures
-				m_T_save[3] = m_T_save[2] - 0.5*(m_T_save[2] - T_amb);       //If higher pressure, guess higher T4   
-				T_upper_max = m_T_save[2] - 0.2*(m_T_save[2] - T_amb);     //Also, high upper limit for T4
+				T_save[3] = T_save[2] - 0.5*(T_save[2] - T_amb);       //If higher pressure, guess higher T4   
+				T_upper_max = T_save[2] - 0.2*(T_save[2] - T_amb);     //Also, high upper limit for T4
 			}
 			else{
-				m_T_save[3] = m_T_save[2] - 0.9*(m_T_save[2] - T_amb);       //If lower pressure, guess lower T4
-				T_upper_max = m_T_save[2] - 0.5*(m_T_save[2] - T_amb);     //Also, low upper limit for T4
+				T_save[3] = T_save[2] - 0.9*(T_save[2] - T_amb);       //If lower pressure, guess lower T4
+				T_upper_max = T_save[2] - 0.5*(T_save[2] - T_amb);     //Also, low upper limit for T4
 			}
-			m_T_save[4] = m_T_save[3] - 2.;
+			T_save[4] = T_save[3] - 2.;
 
-			mv_reguess_args[1] = m_P_a(hn, hv);               //Reset previous pressure
-			mv_reguess_args[0] = m_GlazingIntact(hn, hv) ? 1. : 0.;   //Reset previous glazing logic
-			mv_reguess_args[2] = T_1_in;            //Reset previous T_1_in
+			reguess_args[1] = m_P_a(hn, hv);               //Reset previous pressure
+			reguess_args[0] = m_GlazingIntact(hn, hv) ? 1. : 0.;   //Reset previous glazing logic
+			reguess_args[2] = T_1_in;            //Reset previous T_1_in
 
 		}
 		else{
-			m_T_save[0] = T_1_in;
-			m_T_save[1] = T_1_in + 2.;
-			m_T_save[2] = m_T_save[1] + 5.;
-			m_T_save[3] = T_amb;
-			m_T_save[4] = T_amb;
+			T_save[0] = T_1_in;
+			T_save[1] = T_1_in + 2.;
+			T_save[2] = T_save[1] + 5.;
+			T_save[3] = T_amb;
+			T_save[4] = T_amb;
 
-			mv_reguess_args[0] = m_GlazingIntact(hn, hv) ? 1. : 0.;   //Reset previous glazing logic
-			mv_reguess_args[1] = T_1_in;            //Reset previous T_1_in
+			reguess_args[0] = m_GlazingIntact(hn, hv) ? 1. : 0.;   //Reset previous glazing logic
+			reguess_args[1] = T_1_in;            //Reset previous T_1_in
 
 		}
 	}
 
 	//Set intial guess values
-	T_2 = m_T_save[1];
-	T_3 = m_T_save[2];
-	T_4 = m_T_save[3];
-	T_5 = m_T_save[4];
+	T_2 = T_save[1];
+	T_3 = T_save[2];
+	T_4 = T_save[3];
+	T_5 = T_save[4];
 	//Set constant temps
 	T_6 = T_amb;
 	T_7 = m_T_sky;
@@ -3915,8 +4078,6 @@ lab_keep_guess:
 	k_45 = 1.04;                             //[W/m-K]  Conductivity of glass
 	R_45cond = log(m_D_5(hn, hv) / m_D_4(hn, hv)) / (2.*CSP::pi*k_45);    //[K-m/W]Equation of thermal resistance for conduction through a cylinder
 
-	colopteff_tot = m_ColOptEff(ct, sca_num)*m_Dirt_HCE(hn, hv)*m_Shadowing(hn, hv);	//The total optical efficiency
-
 	if (m_GlazingIntact(hn, hv)){   //These calculations (q_3SolAbs,q_5solAbs) are not dependent on temperature, so only need to be computed once per call to subroutine
 
 		q_3SolAbs = m_q_i * colopteff_tot * m_Tau_envelope.at(hn, hv) * m_alpha_abs.at(hn, hv);  //[W/m]  
@@ -4174,7 +4335,7 @@ lab_keep_guess:
 
 				T1_iter++;                   //Increase iteration counter
 				T_1_ave = (T_1_out + T_1_in) / 2.0;     //Average fluid temperature
-				cp_1 = m_htfProps.Cp(T_1_ave)*1000.;
+				cp_1 = htfProps.Cp(T_1_ave)*1000.;
 				T_1_out1 = max(m_T_sky, q_in_W / (m_dot*cp_1) + T_1_in);  //Estimate outlet temperature with previous cp 
 				diff_T1 = (T_1_out - T_1_out1) / T_1_out;  //Difference between T_1_out used to calc T_ave, and T_1_out calculated with new cp
 				T_1_out = T_1_out1;                      //Calculate new T_1_out
@@ -4187,7 +4348,7 @@ lab_keep_guess:
 			T_1_ave = T_1_in;
 		}
 
-		rho_1ave = m_htfProps.dens(T_1_ave, 0.0);       //[kg/m^3] Density
+		rho_1ave = htfProps.dens(T_1_ave, 0.0);       //[kg/m^3] Density
 		m_v_1 = m_dot / (rho_1ave*m_A_cs(hn, hv));             //HTF bulk velocity
 
 		q_conv_iter = 0;                 //Set iteration counter
@@ -4207,7 +4368,7 @@ lab_keep_guess:
 
 			q_conv_iter++;       //Increase iteration counter
 
-			T_2 = max(10.0, fT_2(q_12conv, T_1_ave, T_2g, m_v_1, hn, hv));	//Calculate T_2 (with previous T_2 as input)
+			T_2 = max(10.0, fT_2(htfProps, q_12conv, T_1_ave, T_2g, m_v_1, hn, hv));	//Calculate T_2 (with previous T_2 as input)
 			diff_T2 = (T_2 - T_2g) / T_2;          //T_2 difference
 
 			if (diff_T2 > 0.0)			// Calculated > Guessed, set lower limit and increase guessed
@@ -4278,11 +4439,22 @@ lab_keep_guess:
 	q_heatloss = q_34tot + q_cond_bracket;		//[W/m]
 
 	//Save temperatures
-	m_T_save[1] = T_2;
-	m_T_save[2] = T_3;
-	m_T_save[3] = T_4;
-	m_T_save[4] = T_5;
+	T_save[1] = T_2;
+	T_save[2] = T_3;
+	T_save[3] = T_4;
+	T_save[4] = T_5;
+
+	// Same order as the convergence errors above
+	if (m_qq > 99 && fabs(Diff_T3) > T3_tol)
+		return 1;
+	if (T1_iter > 99 && fabs(diff_T1) > T1_tol)
+		return 2;
+	if (q_conv_iter > 99 && fabs(diff_T2) > T2_tol)
+		return 3;
+	if (q5_iter > 99 && fabs(diff_q5) > q5_tol_1)
+		return 4;
 
+	return 0;
 };
 
 
@@ -4372,7 +4544,7 @@ D_ao = outer annulus diameter [m]
 (Sources: Incropera, F., DeWitt, D., Fundamentals of Heat and Mass Transfer, Third Edition; John Wiley and Sons, New York, 1981, pp. 489-491, 502-503. Gnielinski, V., "New Equations for Heat and Mass Transfer in Turbulent Pipe and Channel Flow," International Chemical Engineering, Vol. 16, No. 2, April 1976.)
 */
 
-double C_csp_trough_collector_receiver::fT_2(double q_12conv, double T_1, double T_2g, double m_v_1, int hn, int hv){
+double C_csp_trough_collector_receiver::fT_2(HTFProperties &htfProps, double q_12conv, double T_1, double T_2g, double m_v_1, int hn, int hv){
 	//		convection 1->2,  HTF temp, guess T2,  fluid velocity, HCE #, HCE variant
 	//     Input units (  K   ,  K ,  real,  m/s, - , -)
 
@@ -4382,13 +4554,13 @@ double C_csp_trough_collector_receiver::fT_2(double q_12conv, double T_1, double
 	T_2g = max(T_2g, m_T_htf_prop_min);		//[K]
 
 	// Thermophysical properties for HTF 
-	mu_1 = m_htfProps.visc(T_1);  //[kg/m-s]
-	mu_2 = m_htfProps.visc(T_2g);  //[kg/m-s]
-	Cp_1 = m_htfProps.Cp(T_1)*1000.;  //[J/kg-K]
-	Cp_2 = m_htfProps.Cp(T_2g)*1000.;  //[J/kg-K]
-	k_1 = max(m_htfProps.cond(T_1), 1.e-4);  //[W/m-K]
-	k_2 = max(m_htfProps.cond(T_2g), 1.e-4);  //[W/m-K]
-	rho_1 = m_htfProps.dens(T_1, 0.0);  //[kg/m^3]
+	mu_1 = htfProps.visc(T_1);  //[kg/m-s]
+	mu_2 = htfProps.visc(T_2g);  //[kg/m-s]
+	Cp_1 = htfProps.Cp(T_1)*1000.;  //[J/kg-K]
+	Cp_2 = htfProps.Cp(T_2g)*1000.;  //[J/kg-K]
+	k_1 = max(htfProps.cond(T_1), 1.e-4);  //[W/m-K]
+	k_2 = max(htfProps.cond(T_2g), 1.e-4);  //[W/m-K]
+	rho_1 = htfProps.dens(T_1, 0.0);  //[kg/m^3]
 
 	Pr_2 = (Cp_2 * mu_2) / k_2;
 	Pr_1 = (Cp_1 * mu_1) / k_1;
@@ -308,6 +308,9 @@ private:
 	// Member variables that are used to store information for the EvacReceiver method
 	double m_T_save[5];			//[K] Saved temperatures from previous call to EvacReceiver single SCA energy balance model
 	std::vector<double> mv_reguess_args;	//[-] Logic to determine whether to use previous guess values or start iteration fresh
+
+	// Heat loss surrogate used by EvacReceiver when m_use_hce_heat_loss_table = true
+	C_hce_heat_loss_table mc_hce_heat_loss_table;
 	
 	// member string for exception messages
 	std::string m_error_msg;
@@ -365,6 +368,7 @@ public:
 	bool m_accept_init;		//[-] In acceptance testing mode - require steady-state startup
 	int m_accept_loc;		//[-] In acceptance testing mode - temperature sensor location (1=hx,2=loop)
 	bool m_is_using_input_gen;
+	bool m_use_hce_heat_loss_table;	//[-] True: interpolate HCE heat loss from tables generated in init(), full energy balance outside of tables
 
 	double m_solar_mult;		//[-] Solar multiple 
 	double m_mc_bal_hot_per_MW;		//[kWht/K-MWt] The heat capacity per MWt design of the balance of plant on the hot side
@@ -617,11 +621,45 @@ public:
 	//	double T_htf_cold_in /*K*/, double m_dot_htf_loop /*kg/s*/,
 	//	const C_csp_solver_sim_info &sim_info);
 
+	class C_hce_heat_loss_point : public C_hce_heat_loss_table::C_point_solver
+	{	// Solves the full receiver energy balance at one table node. Each table generation thread
+		//    gets its own instance, so HTF properties and previous guesses are not shared between threads
+	private:
+		C_csp_trough_collector_receiver *mpc_trough;
+		HTFProperties mc_htfProps;
+		double m_T_save[5];
+		std::vector<double> mv_reguess_args;
+
+	public:
+		C_hce_heat_loss_point(C_csp_trough_collector_receiver *pc_trough)
+		{
+			mpc_trough = pc_trough;
+			mc_htfProps = pc_trough->m_htfProps;
+			for( int i = 0; i < 5; i++ )
+				m_T_save[i] = std::numeric_limits<double>::quiet_NaN();
+			mv_reguess_args.resize(3, std::numeric_limits<double>::quiet_NaN());
+		}
+
+		virtual int operator()(int hn, int hv, const double *x, double *y);
+	};
+
+	void init_hce_heat_loss_table();
+
 	void EvacReceiver(double T_1_in, double m_dot, double T_amb, double m_T_sky, double v_6, double P_6, double m_q_i,
 		int hn /*HCE number [0..3] */, int hv /* HCE variant [0..3] */, int ct /*Collector type*/, int sca_num, bool single_point, int ncall, double time,
 		//outputs
 		double &q_heatloss, double &q_12conv, double &q_34tot, double &c_1ave, double &rho_1ave);
-	double fT_2(double q_12conv, double T_1, double T_2g, double m_v_1, int hn, int hv);
+	bool EvacReceiver_table(double T_1_in, double m_dot, double T_amb, double m_T_sky, double v_6, double P_6, double m_q_i,
+		int hn, int hv, int ct, int sca_num, bool single_point,
+		//outputs
+		double &q_heatloss, double &q_12conv, double &q_34tot, double &c_1ave, double &rho_1ave);
+	// Returns 0 when converged, otherwise the number of the first convergence error (1: T_3, 2: T_1, 3: T_2, 4: T_4)
+	int evac_receiver_energy_balance(HTFProperties &htfProps, double *T_save, std::vector<double> &reguess_args,
+		double T_1_in, double m_dot, double T_amb, double m_T_sky, double v_6, double P_6, double m_q_i, double colopteff_tot,
+		int hn, int hv, int ct, bool single_point, int ncall, double time,
+		//outputs
+		double &q_heatloss, double &q_12conv, double &q_34tot, double &c_1ave, double &rho_1ave);
+	double fT_2(HTFProperties &htfProps, double q_12conv, double T_1, double T_2g, double m_v_1, int hn, int hv);
 	void FQ_34CONV(double T_3, double T_4, double P_6, double v_6, double T_6, int hn, int hv, double &q_34conv, double &h_34);
 	void FQ_56CONV(double T_5, double T_6, double P_6, double v_6, int hn, int hv, double &q_56conv, double &h_6);
 	double FQ_COND_BRACKET(double T_3, double T_6, double P_6, double v_6, int hn, int hv);
@@ -49,15 +49,137 @@
 
 #include "csp_solver_util.h"
 #include <math.h>
+#include <limits>
 
 const C_csp_reported_outputs::S_output_info csp_info_invalid = {-1, -1};
 
+C_csp_output_sink::C_csp_output_sink()
+{
+	m_n_rows = 0;
+}
+
+int C_csp_output_sink::add_column(const std::string & name)
+{
+	if( m_n_rows > 0 )
+	{
+		throw(C_csp_exception("Columns must be added before the first reporting timestep is written", "C_csp_output_sink::add_column"));
+	}
+
+	mv_column_names.push_back(name);
+	mv_row.push_back(std::numeric_limits<double>::quiet_NaN());
+
+	return (int)mv_column_names.size() - 1;
+}
+
+int C_csp_output_sink::get_n_columns()
+{
+	return (int)mv_column_names.size();
+}
+
+const std::vector<std::string> & C_csp_output_sink::get_column_names()
+{
+	return mv_column_names;
+}
+
+int C_csp_output_sink::get_n_rows()
+{
+	return m_n_rows;
+}
+
+void C_csp_output_sink::value(int column, double value)
+{
+	mv_row[column] = value;
+}
+
+void C_csp_output_sink::end_reporting_timestep(double time_end /*s*/)
+{
+	write_reporting_timestep(time_end, mv_row);
+
+	m_n_rows++;
+}
+
+C_csp_output_sink_csv::C_csp_output_sink_csv()
+{
+	m_is_header_written = false;
+}
+
+C_csp_output_sink_csv::~C_csp_output_sink_csv()
+{
+	close();
+}
+
+bool C_csp_output_sink_csv::open(const std::string & file_path)
+{
+	close();
+
+	m_file.open(file_path.c_str(), std::ios::out | std::ios::trunc);
+	m_is_header_written = false;
+
+	return m_file.is_open();
+}
+
+void C_csp_output_sink_csv::close()
+{
+	if( m_file.is_open() )
+	{
+		m_file.close();
+	}
+}
+
+void C_csp_output_sink_csv::write_reporting_timestep(double time_end /*s*/, const std::vector<double> & v_row)
+{
+	if( !m_file.is_open() )
+	{
+		throw(C_csp_exception("Output file is not open", "C_csp_output_sink_csv::write_reporting_timestep"));
+	}
+
+	if( !m_is_header_written )
+	{
+		const std::vector<std::string> & v_names = get_column_names();
+
+		m_file << "time_hr";
+		for( size_t i = 0; i < v_names.size(); i++ )
+		{
+			m_file << "," << v_names[i];
+		}
+		m_file << "\n";
+
+		m_is_header_written = true;
+	}
+
+	m_file.precision(8);
+	m_file << time_end / 3600.0;		//[hr]
+	for( size_t i = 0; i < v_row.size(); i++ )
+	{
+		m_file << "," << (float)v_row[i];
+	}
+	m_file << "\n";
+}
+
+C_csp_output_sink_callback::C_csp_output_sink_callback(bool(*pf_callback)(double time_end, const std::vector<std::string> & v_names, const std::vector<double> & v_row, void *data),
+	void *p_data)
+{
+	mpf_callback = pf_callback;
+	mp_data = p_data;
+}
+
+void C_csp_output_sink_callback::write_reporting_timestep(double time_end /*s*/, const std::vector<double> & v_row)
+{
+	if( mpf_callback != 0 && !mpf_callback(time_end, get_column_names(), v_row, mp_data) )
+	{
+		throw(C_csp_exception("Simulation stopped by output sink callback", "C_csp_output_sink_callback::write_reporting_timestep"));
+	}
+}
+
 C_csp_reported_outputs::C_output::C_output()
 {
 	mp_reporting_ts_array = 0;		// Initialize pointer to NULL
 
 	m_is_allocated = false;
 
+	mp_sink = 0;
+	m_sink_column = -1;
+
 	m_subts_weight_type = -1;
 
 	m_counter_reporting_ts_array = 0;
@@ -75,6 +197,18 @@ void C_csp_reported_outputs::C_output::assign(float *p_reporting_ts_array, int n
 	m_n_reporting_ts_array = n_reporting_ts_array;
 }
 
+void C_csp_reported_outputs::C_output::stream(C_csp_output_sink *p_sink, int sink_column)
+{
+	mp_sink = p_sink;
+	m_sink_column = sink_column;
+	mv_temp_outputs.reserve(10);
+}
+
+bool C_csp_reported_outputs::C_output::is_active()
+{
+	return m_is_allocated || mp_sink != 0;
+}
+
 void C_csp_reported_outputs::C_output::set_m_is_ts_weighted(int subts_weight_type)
 {
 	m_subts_weight_type = subts_weight_type;
@@ -94,7 +228,7 @@ int C_csp_reported_outputs::C_output::get_vector_size()
 
 void C_csp_reported_outputs::C_output::set_timestep_output(double output_value)
 {
-	if( m_is_allocated )
+	if( is_active() )
 	{	
 		mv_temp_outputs.push_back(output_value);
 	}
@@ -103,20 +237,22 @@ void C_csp_reported_outputs::C_output::set_timestep_output(double output_value)
 void C_csp_reported_outputs::C_output::send_to_reporting_ts_array(double report_time_start, int n_report, 
 		const std::vector<double> & v_temp_ts_time_end, double report_time_end, bool is_save_last_step, int n_pop_back )
 {
-	if( m_is_allocated )
+	if( is_active() )
 	{	
 		if( mv_temp_outputs.size() != n_report )
 		{
 			throw(C_csp_exception("Time and data arrays are not the same size", "C_csp_reported_outputs::send_to_reporting_ts_array"));
 		}
 
-		if( m_counter_reporting_ts_array + 1 > m_n_reporting_ts_array )
+		if( m_is_allocated && m_counter_reporting_ts_array + 1 > m_n_reporting_ts_array )
 		{
 			throw(C_csp_exception("Attempting store more points in Reporting Timestep Array than it was allocated for"));
 		}
 	
 		double m_report_step = report_time_end - report_time_start;
 
+		float report_value = 0.0;
+
 		if( m_subts_weight_type == TS_WEIGHTED_AVE )
 		{	// ***********************************************************
 			//      Set outputs that are reported as weighted averages if 
@@ -127,30 +263,40 @@ void C_csp_reported_outputs::C_output::send_to_reporting_ts_array(double report_
 			double time_prev = report_time_start;		//[s]
 			for( int i = 0; i < n_report; i++ )
 			{
-				mp_reporting_ts_array[m_counter_reporting_ts_array] += (float)((fmin(v_temp_ts_time_end[i], report_time_end) - time_prev)*mv_temp_outputs[i]);	//[units]*[s]
+				report_value += (float)((fmin(v_temp_ts_time_end[i], report_time_end) - time_prev)*mv_temp_outputs[i]);	//[units]*[s]
 				time_prev = fmin(v_temp_ts_time_end[i], report_time_end);
 			}
-			mp_reporting_ts_array[m_counter_reporting_ts_array] /= (float)m_report_step;
+			report_value /= (float)m_report_step;
 		}
 		else if (m_subts_weight_type == TS_1ST)
 		{	// ************************************************************
 			// Set instantaneous outputs that are reported as the first value
 			//   if multiple csp-timesteps for one reporting timestep
 			// ************************************************************
-			mp_reporting_ts_array[m_counter_reporting_ts_array] = (float)mv_temp_outputs[0];
+			report_value = (float)mv_temp_outputs[0];
 		}
 		else if (m_subts_weight_type == TS_LAST)
 		{	// ************************************************************
 			// Set instantaneous outputs that are reported as the first value
 			//   if multiple csp-timesteps for one reporting timestep
 			// ************************************************************
-			mp_reporting_ts_array[m_counter_reporting_ts_array] = (float)mv_temp_outputs[n_report - 1];
+			report_value = (float)mv_temp_outputs[n_report - 1];
 		}
 		else
 		{
 			throw(C_csp_exception("C_csp_reported_outputs::C_output::send_to_reporting_ts_array did not recognize subtimestep weighting type"));
 		}
 
+		if( m_is_allocated )
+		{
+			mp_reporting_ts_array[m_counter_reporting_ts_array] = report_value;
+		}
+
+		if( mp_sink != 0 )
+		{
+			mp_sink->value(m_sink_column, report_value);
+		}
+
 		if( is_save_last_step )
 		{
 			mv_temp_outputs[0] = mv_temp_outputs[n_report - 1];
@@ -183,9 +329,10 @@ void C_csp_reported_outputs::send_to_reporting_ts_array(double report_time_start
 		n_pop_back = n_report;
 	}
 
-	for( int i = 0; i < m_n_outputs; i++ )
+	int n_active = (int)mv_active_outputs.size();
+	for( int i = 0; i < n_active; i++ )
 	{
-		mvc_outputs[i].send_to_reporting_ts_array(report_time_start, n_report, v_temp_ts_time_end,
+		mvc_outputs[mv_active_outputs[i]].send_to_reporting_ts_array(report_time_start, n_report, v_temp_ts_time_end,
 			report_time_end, is_save_last_step, n_pop_back);
 	}
 }
@@ -215,6 +362,8 @@ void C_csp_reported_outputs::construct(const S_output_info *output_info)
 
 	mv_latest_calculated_outputs.resize(n_outputs);
 
+	mv_active_outputs.resize(0);
+
 	// Loop through the output info and set m_is_ts_weighted for each output
 	for( int i = 0; i < n_outputs; i++ )
 	{
@@ -239,15 +388,32 @@ bool C_csp_reported_outputs::assign(int index, float *p_reporting_ts_array, int
 			return false;
 	}
 
+	if( !mvc_outputs[index].is_active() )
+		mv_active_outputs.push_back(index);
+
 	mvc_outputs[index].assign(p_reporting_ts_array, n_reporting_ts_array);
 
 	return true;
 }
 
+bool C_csp_reported_outputs::stream(int index, C_csp_output_sink *p_sink, const std::string & name)
+{
+	if(index < 0 || index >= m_n_outputs || p_sink == 0)
+		return false;
+
+	if( !mvc_outputs[index].is_active() )
+		mv_active_outputs.push_back(index);
+
+	mvc_outputs[index].stream(p_sink, p_sink->add_column(name));
+
+	return true;
+}
+
 void C_csp_reported_outputs::set_timestep_outputs()
 {
-	for(int i = 0; i < m_n_outputs; i++)
-		mvc_outputs[i].set_timestep_output(mv_latest_calculated_outputs[i]);
+	int n_active = (int)mv_active_outputs.size();
+	for(int i = 0; i < n_active; i++)
+		mvc_outputs[mv_active_outputs[i]].set_timestep_output(mv_latest_calculated_outputs[mv_active_outputs[i]]);
 }
 
 void C_csp_reported_outputs::C_output::overwrite_vector_to_constant(double value)
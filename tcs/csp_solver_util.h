@@ -52,9 +52,87 @@
 
 #include <string>
 #include <vector>
+#include <fstream>
 
 #include <exception>
 
+class C_csp_output_sink
+{
+	// Receives completed reporting timesteps from one or more C_csp_reported_outputs
+	// Columns are registered before simulation; the owner of the reported outputs (e.g. C_csp_solver)
+	//   calls end_reporting_timestep() after every object has sent its values for the timestep
+
+private:
+	std::vector<std::string> mv_column_names;
+	std::vector<double> mv_row;
+
+	int m_n_rows;		//[-] Number of reporting timesteps written
+
+protected:
+
+	virtual void write_reporting_timestep(double time_end /*s*/, const std::vector<double> & v_row) = 0;
+
+public:
+
+	C_csp_output_sink();
+
+	virtual ~C_csp_output_sink(){};
+
+	int add_column(const std::string & name);
+
+	int get_n_columns();
+
+	const std::vector<std::string> & get_column_names();
+
+	int get_n_rows();
+
+	void value(int column, double value);
+
+	void end_reporting_timestep(double time_end /*s*/);
+};
+
+class C_csp_output_sink_csv : public C_csp_output_sink
+{
+	// Writes one row per reporting timestep: end time [hr] followed by each registered column
+
+private:
+	std::ofstream m_file;
+
+	bool m_is_header_written;
+
+protected:
+
+	virtual void write_reporting_timestep(double time_end /*s*/, const std::vector<double> & v_row);
+
+public:
+
+	C_csp_output_sink_csv();
+
+	~C_csp_output_sink_csv();
+
+	bool open(const std::string & file_path);
+
+	void close();
+};
+
+class C_csp_output_sink_callback : public C_csp_output_sink
+{
+	// Passes each reporting timestep to a user function. Return false from the function to stop the simulation
+
+private:
+	bool(*mpf_callback)(double time_end /*s*/, const std::vector<std::string> & v_names, const std::vector<double> & v_row, void *data);
+	void *mp_data;
+
+protected:
+
+	virtual void write_reporting_timestep(double time_end /*s*/, const std::vector<double> & v_row);
+
+public:
+
+	C_csp_output_sink_callback(bool(*pf_callback)(double time_end, const std::vector<std::string> & v_names, const std::vector<double> & v_row, void *data),
+		void *p_data);
+};
+
 class C_csp_reported_outputs
 {
 
@@ -75,6 +153,9 @@ public:
 		std::vector<double> mv_temp_outputs;
 
 		bool m_is_allocated;		// True = memory allocated for array. False = no memory allocated, won't write outputs
+
+		C_csp_output_sink *mp_sink;	// Not NULL = reporting timestep values are also sent to sink column m_sink_column
+		int m_sink_column;
 		
 		int m_subts_weight_type;	// 0: timestep-weighted average, 1: Take first piont in mv_temp_outputs, 2: Take final point in mv_temp_outupts
 		//bool m_is_ts_weighted;		// True = timestep-weighted average of mv_temp_outputs, False = take first point in mv_temp_outputs
@@ -90,6 +171,11 @@ public:
 
 		void assign(float *p_reporting_ts_array, int n_reporting_ts_array);
 
+		void stream(C_csp_output_sink *p_sink, int sink_column);
+
+		// True if the output is stored or streamed. Inactive outputs skip all timestep work
+		bool is_active();
+
 		void set_timestep_output(double output_value);
 
 		void overwrite_most_recent_timestep(double value);
@@ -115,6 +201,8 @@ private:
 
 	std::vector<C_output> mvc_outputs;	//[-] vector of Output Classes
 	int m_n_outputs;					//[-] number of Output Classes in vector
+
+	std::vector<int> mv_active_outputs;	//[-] indices of outputs that are assigned and/or streamed
 	
 	int m_n_reporting_ts_array;			//[-] Length of allocated array
 
@@ -128,6 +216,9 @@ public:
 
 	bool assign(int index, float *p_reporting_ts_array, int n_reporting_ts_array);
 
+	// Send reporting timestep values of output 'index' to a new column 'name' of the sink. Can be combined with assign()
+	bool stream(int index, C_csp_output_sink *p_sink, const std::string & name);
+
 	void send_to_reporting_ts_array(double report_time_start,
 		const std::vector<double> & v_temp_ts_time_end, double report_time_end);
 
@@ -65,7 +65,7 @@ double NS_HX_counterflow_eqs::calc_max_q_dot_enth(int hot_fl_code /*-*/, HTFProp
 	if (hot_fl_code == NS_HX_counterflow_eqs::CO2)
 	{
 		CO2_state ms_co2_props;
-		prop_error_code = CO2_PH(P_h_in, h_h_in, &ms_co2_props);
+		prop_error_code = CO2_PH_memo(P_h_in, h_h_in, &ms_co2_props);
 		if (prop_error_code != 0)
 		{
 			throw(C_csp_exception("C_HX_counterflow::design",
@@ -93,7 +93,7 @@ double NS_HX_counterflow_eqs::calc_max_q_dot_enth(int hot_fl_code /*-*/, HTFProp
 	if (cold_fl_code == NS_HX_counterflow_eqs::CO2)
 	{
 		CO2_state ms_co2_props;
-		prop_error_code = CO2_PH(P_c_in, h_c_in, &ms_co2_props);
+		prop_error_code = CO2_PH_memo(P_c_in, h_c_in, &ms_co2_props);
 		if (prop_error_code != 0)
 		{
 			throw(C_csp_exception("C_HX_counterflow::design",
@@ -123,7 +123,7 @@ double NS_HX_counterflow_eqs::calc_max_q_dot_enth(int hot_fl_code /*-*/, HTFProp
 	if (cold_fl_code == NS_HX_counterflow_eqs::CO2)
 	{
 		CO2_state ms_co2_props;
-		prop_error_code = CO2_TP(T_h_in, P_c_out, &ms_co2_props);
+		prop_error_code = CO2_TP_memo(T_h_in, P_c_out, &ms_co2_props);
 		if (prop_error_code == 205)
 		{
 			prop_error_code = CO2_TQ(T_h_in, 0.0, &ms_co2_props);
@@ -163,7 +163,7 @@ double NS_HX_counterflow_eqs::calc_max_q_dot_enth(int hot_fl_code /*-*/, HTFProp
 	if (hot_fl_code == NS_HX_counterflow_eqs::CO2)
 	{
 		CO2_state ms_co2_props;
-		prop_error_code = CO2_TP(T_c_in, P_h_out, &ms_co2_props);
+		prop_error_code = CO2_TP_memo(T_c_in, P_h_out, &ms_co2_props);
 		if (prop_error_code == 205)
 		{
 			prop_error_code = CO2_TQ(T_c_in, 1.0, &ms_co2_props);
@@ -213,7 +213,7 @@ double NS_HX_counterflow_eqs::calc_max_q_dot(int hot_fl_code /*-*/, HTFPropertie
 	if (cold_fl_code == NS_HX_counterflow_eqs::CO2)
 	{
 		CO2_state ms_co2_props;
-		prop_error_code = CO2_TP(T_c_in, P_c_in, &ms_co2_props);
+		prop_error_code = CO2_TP_memo(T_c_in, P_c_in, &ms_co2_props);
 		if (prop_error_code != 0)
 		{
 			throw(C_csp_exception("C_HX_counterflow::calc_max_q_dot",
@@ -241,7 +241,7 @@ double NS_HX_counterflow_eqs::calc_max_q_dot(int hot_fl_code /*-*/, HTFPropertie
 	if (hot_fl_code == NS_HX_counterflow_eqs::CO2)
 	{
 		CO2_state ms_co2_props;
-		prop_error_code = CO2_TP(T_h_in, P_h_in, &ms_co2_props);
+		prop_error_code = CO2_TP_memo(T_h_in, P_h_in, &ms_co2_props);
 		if (prop_error_code != 0)
 		{
 			throw(C_csp_exception("C_HX_counterflow::calc_max_q_dot",
@@ -331,7 +331,7 @@ void NS_HX_counterflow_eqs::calc_req_UA(int hot_fl_code /*-*/, HTFProperties & h
 	if (cold_fl_code == NS_HX_counterflow_eqs::CO2)
 	{
 		CO2_state ms_co2_props;
-		prop_error_code = CO2_TP(T_c_in, P_c_in, &ms_co2_props);
+		prop_error_code = CO2_TP_memo(T_c_in, P_c_in, &ms_co2_props);
 		if (prop_error_code != 0)
 		{
 			throw(C_csp_exception("C_HX_counterflow::design",
@@ -358,7 +358,7 @@ void NS_HX_counterflow_eqs::calc_req_UA(int hot_fl_code /*-*/, HTFProperties & h
 	if (hot_fl_code == NS_HX_counterflow_eqs::CO2)
 	{
 		CO2_state ms_co2_props;
-		prop_error_code = CO2_TP(T_h_in, P_h_in, &ms_co2_props);
+		prop_error_code = CO2_TP_memo(T_h_in, P_h_in, &ms_co2_props);
 		if (prop_error_code != 0)
 		{
 			throw(C_csp_exception("C_HX_counterflow::design",
@@ -432,7 +432,6 @@ void NS_HX_counterflow_eqs::calc_req_UA_enth(int hot_fl_code /*-*/, HTFPropertie
 	}
 
 	// Calculate outlet stream states
-	CO2_state ms_co2_props;
 	water_state ms_water_props;
 	int prop_error_code = 0;
 
@@ -447,31 +446,59 @@ void NS_HX_counterflow_eqs::calc_req_UA_enth(int hot_fl_code /*-*/, HTFPropertie
 	double T_c_in = std::numeric_limits<double>::quiet_NaN();	//[K]
 	double T_h_in = std::numeric_limits<double>::quiet_NaN();	//[K]
 
+	// Assume pressure varies linearly through heat exchanger
+	std::vector<double> v_P_h(N_nodes), v_h_h(N_nodes), v_P_c(N_nodes), v_h_c(N_nodes);
+	for (int i = 0; i < N_nodes; i++)
+	{
+		v_P_c[i] = P_c_out + i*(P_c_in - P_c_out) / (double)(N_nodes - 1);
+		v_P_h[i] = P_h_in - i*(P_h_in - P_h_out) / (double)(N_nodes - 1);
+
+		// Calculate the entahlpy at the node
+		v_h_c[i] = h_c_out + i*(h_c_in - h_c_out) / (double)(N_nodes - 1);
+		v_h_h[i] = h_h_in - i*(h_h_in - h_h_out) / (double)(N_nodes - 1);
+	}
+
+	// Solve the CO2 node states up front. The inlet states are repeated by every q_dot iteration on this
+	// heat exchanger, so they use the memoized property call; the rest of the nodes are solved in one batch
+	std::vector<CO2_state> v_co2_h, v_co2_c;
+	std::vector<int> v_co2_err_h, v_co2_err_c;
+	if (hot_fl_code == NS_HX_counterflow_eqs::CO2)
+	{
+		v_co2_h.resize(N_nodes);
+		v_co2_err_h.resize(N_nodes);
+		v_co2_err_h[0] = CO2_PH_memo(v_P_h[0], v_h_h[0], &v_co2_h[0]);
+		CO2_PH_batch(N_nodes - 1, &v_P_h[1], &v_h_h[1], &v_co2_h[1], &v_co2_err_h[1]);
+	}
+	if (cold_fl_code == NS_HX_counterflow_eqs::CO2)
+	{
+		v_co2_c.resize(N_nodes);
+		v_co2_err_c.resize(N_nodes);
+		CO2_PH_batch(N_nodes - 1, &v_P_c[0], &v_h_c[0], &v_co2_c[0], &v_co2_err_c[0]);
+		v_co2_err_c[N_nodes - 1] = CO2_PH_memo(v_P_c[N_nodes - 1], v_h_c[N_nodes - 1], &v_co2_c[N_nodes - 1]);
+	}
+
 	// Loop through the sub-heat exchangers
 	UA = 0.0;
 	min_DT = T_h_in;
 	for (int i = 0; i < N_nodes; i++)
 	{
-		// Assume pressure varies linearly through heat exchanger
-		double P_c = P_c_out + i*(P_c_in - P_c_out) / (double)(N_nodes - 1);
-		double P_h = P_h_in - i*(P_h_in - P_h_out) / (double)(N_nodes - 1);
+		double P_c = v_P_c[i];
+		double P_h = v_P_h[i];
 
-		// Calculate the entahlpy at the node
-		double h_c = h_c_out + i*(h_c_in - h_c_out) / (double)(N_nodes - 1);
-		double h_h = h_h_in - i*(h_h_in - h_h_out) / (double)(N_nodes - 1);
+		double h_c = v_h_c[i];
+		double h_h = v_h_h[i];
 
 		// ****************************************************
 		// Calculate the hot and cold temperatures at the node
 		double T_h = std::numeric_limits<double>::quiet_NaN();
 		if (hot_fl_code == NS_HX_counterflow_eqs::CO2)
 		{
-			prop_error_code = CO2_PH(P_h, h_h, &ms_co2_props);
-			if (prop_error_code != 0)
+			if (v_co2_err_h[i] != 0)
 			{
 				throw(C_csp_exception("C_HX_counterflow::design",
 					"Cold side inlet enthalpy calculations failed", 12));
 			}
-			T_h = ms_co2_props.temp;		//[K]
+			T_h = v_co2_h[i].temp;		//[K]
 		}
 		else if (hot_fl_code == NS_HX_counterflow_eqs::WATER)
 		{
@@ -491,13 +518,12 @@ void NS_HX_counterflow_eqs::calc_req_UA_enth(int hot_fl_code /*-*/, HTFPropertie
 		double T_c = std::numeric_limits<double>::quiet_NaN();
 		if (cold_fl_code == NS_HX_counterflow_eqs::CO2)
 		{
-			prop_error_code = CO2_PH(P_c, h_c, &ms_co2_props);
-			if (prop_error_code != 0)
+			if (v_co2_err_c[i] != 0)
 			{
 				throw(C_csp_exception("C_HX_counterflow::design",
 					"Cold side inlet enthalpy calculations failed", 13));
 			}
-			T_c = ms_co2_props.temp;		//[K]
+			T_c = v_co2_c[i].temp;		//[K]
 		}
 		else if (cold_fl_code == NS_HX_counterflow_eqs::WATER)
 		{
@@ -814,7 +840,7 @@ void NS_HX_counterflow_eqs::solve_q_dot_for_fixed_UA(int hot_fl_code /*-*/, HTFP
 	if (cold_fl_code == NS_HX_counterflow_eqs::CO2)
 	{
 		CO2_state ms_co2_props;
-		prop_error_code = CO2_TP(T_c_in, P_c_in, &ms_co2_props);
+		prop_error_code = CO2_TP_memo(T_c_in, P_c_in, &ms_co2_props);
 		if (prop_error_code != 0)
 		{
 			throw(C_csp_exception("C_HX_counterflow::design",
@@ -841,7 +867,7 @@ void NS_HX_counterflow_eqs::solve_q_dot_for_fixed_UA(int hot_fl_code /*-*/, HTFP
 	if (hot_fl_code == NS_HX_counterflow_eqs::CO2)
 	{
 		CO2_state ms_co2_props;
-		prop_error_code = CO2_TP(T_h_in, P_h_in, &ms_co2_props);
+		prop_error_code = CO2_TP_memo(T_h_in, P_h_in, &ms_co2_props);
 		if (prop_error_code != 0)
 		{
 			throw(C_csp_exception("C_HX_counterflow::design",
@@ -63,6 +63,20 @@ int C_import_mono_eq::operator()(double x, double *y)
 	return mf_monotonic_function(x, y);
 }
 
+// Running totals over all solvers on a thread, so profiling can count solves inside component models
+static thread_local int s_n_iter_thread_total = 0;
+static thread_local int s_n_eq_calls_thread_total = 0;
+
+int C_monotonic_eq_solver::get_n_iter_thread_total()
+{
+	return s_n_iter_thread_total;
+}
+
+int C_monotonic_eq_solver::get_n_eq_calls_thread_total()
+{
+	return s_n_eq_calls_thread_total;
+}
+
 C_monotonic_eq_solver::C_monotonic_eq_solver(C_monotonic_equation & f): mf_mono_eq(f)
 {
 	m_x_guess = m_x_neg_err = m_x_pos_err = m_y_err_pos = m_y_err_neg =
@@ -76,6 +90,13 @@ C_monotonic_eq_solver::C_monotonic_eq_solver(C_monotonic_equation & f): mf_mono_
 
 	m_iter = -1;
 
+#ifdef _DEBUG
+	m_is_track_all_calls = true;
+#else
+	m_is_track_all_calls = false;
+#endif
+	m_n_eq_calls = 0;
+
 	// Set default settings:
 	m_tol = 0.001;
 	m_is_err_rel = true;
@@ -123,7 +144,9 @@ int C_monotonic_eq_solver::solve(double x_guess_1, double x_guess_2, double y_ta
 {
 	// Set / reset vector that tracks calls to equation
 	ms_eq_call_tracker.resize(0);
-	ms_eq_call_tracker.reserve(m_iter_max);
+	if( m_is_track_all_calls )
+		ms_eq_call_tracker.reserve(m_iter_max);
+	m_n_eq_calls = 0;
 
 	// Check that x guesses fall with bounds (set during initialization)
 	x_guess_1 = check_against_limits(x_guess_1);
@@ -148,7 +171,10 @@ int C_monotonic_eq_solver::solve(double x_guess_1, double x_guess_2, double y_ta
 		y2 = std::numeric_limits<double>::quiet_NaN();
 	}
 	
-	return solver_core(x_guess_1, y1, x_guess_2, y2, y_target, x_solved, tol_solved, iter_solved);
+	int solver_code = solver_core(x_guess_1, y1, x_guess_2, y2, y_target, x_solved, tol_solved, iter_solved);
+	s_n_iter_thread_total += std::max(0, iter_solved);
+
+	return solver_code;
 }
 
 int C_monotonic_eq_solver::solve(S_xy_pair solved_pair_1, S_xy_pair solved_pair_2, double y_target,
@@ -160,7 +186,9 @@ int C_monotonic_eq_solver::solve(S_xy_pair solved_pair_1, S_xy_pair solved_pair_
 
 	// Set / reset vector that tracks calls to equation
 	ms_eq_call_tracker.resize(0);
-	ms_eq_call_tracker.reserve(m_iter_max);
+	if( m_is_track_all_calls )
+		ms_eq_call_tracker.reserve(m_iter_max);
+	m_n_eq_calls = 0;
 
 	// Get x & y values from solved_pairs
 	double x_guess_1 = solved_pair_1.x;
@@ -181,7 +209,10 @@ int C_monotonic_eq_solver::solve(S_xy_pair solved_pair_1, S_xy_pair solved_pair_
 	double y1 = solved_pair_1.y;
 	double y2 = solved_pair_2.y;
 
-	return solver_core(x_guess_1, y1, x_guess_2, y2, y_target, x_solved, tol_solved, iter_solved);
+	int solver_code = solver_core(x_guess_1, y1, x_guess_2, y2, y_target, x_solved, tol_solved, iter_solved);
+	s_n_iter_thread_total += std::max(0, iter_solved);
+
+	return solver_code;
 }
 
 int C_monotonic_eq_solver::solver_core(double x_guess_1, double y1, double x_guess_2, double y2, double y_target,
@@ -799,8 +830,14 @@ int C_monotonic_eq_solver::call_mono_eq(double x, double *y)
 
 	ms_eq_tracker_temp.x = x;
 	ms_eq_tracker_temp.y = *y;
+
+	m_n_eq_calls++;
+	s_n_eq_calls_thread_total++;
 	
-	ms_eq_call_tracker.push_back(ms_eq_tracker_temp);
+	if( m_is_track_all_calls || ms_eq_call_tracker.size() == 0 )
+		ms_eq_call_tracker.push_back(ms_eq_tracker_temp);
+	else
+		ms_eq_call_tracker.back() = ms_eq_tracker_temp;
 
 	return ms_eq_tracker_temp.err_code;
 }
@@ -851,3 +888,95 @@ bool C_monotonic_eq_solver::did_solver_find_positive_error(int solver_exit_mode)
 
 	return true;
 }
+
+C_monotonic_eq_solver_cache::C_monotonic_eq_solver_cache()
+{
+	m_is_enabled = false;
+	m_is_warm_start = false;
+	m_key = -1;
+}
+
+void C_monotonic_eq_solver_cache::enable(bool is_warm_start)
+{
+	m_is_enabled = true;
+	m_is_warm_start = is_warm_start;
+}
+
+void C_monotonic_eq_solver_cache::reset()
+{
+	m_entries.clear();
+}
+
+int C_monotonic_eq_solver_cache::solve(const char *eq_name, C_monotonic_eq_solver &solver, double x_guess_1, double x_guess_2, double y_target,
+	double &x_solved, double &tol_solved, int &iter_solved)
+{
+	if( !m_is_enabled )
+	{
+		return solver.solve(x_guess_1, x_guess_2, y_target, x_solved, tol_solved, iter_solved);
+	}
+
+	S_cache_entry &s_entry = m_entries[std::make_pair(std::string(eq_name), m_key)];
+	S_eq_class_stats &s_stats = s_entry.ms_stats;
+	if( s_stats.m_n_solves == 0 )
+	{
+		s_stats.m_eq_name = eq_name;
+		s_stats.m_key = m_key;
+	}
+	s_stats.m_n_solves++;
+
+	int solver_code = C_monotonic_eq_solver::NO_SOLUTION;
+
+	// Try guesses around the previous converged value first
+	//    Step is a fraction of the caller's guess spacing
+	double dx_guess = 0.1*(x_guess_2 - x_guess_1);
+	if( m_is_warm_start && s_entry.m_is_x_prev && std::isfinite(dx_guess) && dx_guess != 0.0 )
+	{
+		s_stats.m_n_warm_starts++;
+
+		try
+		{
+			solver_code = solver.solve(s_entry.m_x_prev, s_entry.m_x_prev + dx_guess, y_target, x_solved, tol_solved, iter_solved);
+		}
+		catch( const C_csp_exception & )
+		{
+			solver_code = C_monotonic_eq_solver::NO_SOLUTION;
+		}
+
+		s_stats.m_n_iter += std::max(0, iter_solved);
+		s_stats.m_n_eq_calls += solver.get_n_eq_calls();
+
+		if( solver_code == C_monotonic_eq_solver::CONVERGED )
+		{
+			s_stats.m_n_warm_converged++;
+			s_entry.m_x_prev = x_solved;
+			return solver_code;
+		}
+	}
+
+	// Cold solve with the caller's guesses
+	//    If this throws, the caller sees the same exception as without the cache
+	solver_code = solver.solve(x_guess_1, x_guess_2, y_target, x_solved, tol_solved, iter_solved);
+
+	s_stats.m_n_iter += std::max(0, iter_solved);
+	s_stats.m_n_eq_calls += solver.get_n_eq_calls();
+
+	if( solver_code == C_monotonic_eq_solver::CONVERGED )
+	{
+		s_entry.m_is_x_prev = true;
+		s_entry.m_x_prev = x_solved;
+	}
+
+	return solver_code;
+}
+
+void C_monotonic_eq_solver_cache::get_stats(std::vector<S_eq_class_stats> &v_stats)
+{
+	v_stats.resize(0);
+	v_stats.reserve(m_entries.size());
+
+	std::map<std::pair<std::string, int>, S_cache_entry>::iterator it;
+	for( it = m_entries.begin(); it != m_entries.end(); it++ )
+	{
+		v_stats.push_back(it->second.ms_stats);
+	}
+}
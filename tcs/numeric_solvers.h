@@ -52,6 +52,8 @@
 
 #include <vector>
 #include <limits>
+#include <string>
+#include <map>
 
 class C_monotonic_equation
 {
@@ -144,10 +146,14 @@ private:
 		double &x_solved, double &tol_solved, int &iter_solved);
 
 	// Save x, y, and int_return of for each mono_eq call
+	//   When call tracking is off, only the most recent call is kept
 	std::vector<S_eq_chars> ms_eq_call_tracker;
 
 	S_eq_chars ms_eq_tracker_temp;
 
+	bool m_is_track_all_calls;	//[-] True: save every mono_eq call. Default is true only in debug builds
+	int m_n_eq_calls;			//[-] Number of mono_eq calls during most recent solve
+
 protected:
 	double m_func_x_lower;		// Lower limit of independent variable
 	double m_func_x_upper;		// Upper limit of independent variable
@@ -211,9 +217,98 @@ public:
 		return &ms_eq_call_tracker;
 	}
 
+	void set_call_tracking(bool is_track_all_calls)
+	{
+		m_is_track_all_calls = is_track_all_calls;
+	}
+
+	int get_n_eq_calls()
+	{
+		return m_n_eq_calls;
+	}
+
+	// Iterations and equation calls of every solve on the calling thread, including solves nested inside equations
+	static int get_n_iter_thread_total();
+
+	static int get_n_eq_calls_thread_total();
+
 	int test_member_function(double x, double *y);
 };
 
+class C_monotonic_eq_solver_cache
+{
+	// Opt-in solver state shared across timesteps
+	// Keyed by equation class and a caller-defined key (e.g. operating mode)
+	// When warm start is enabled, a solve first tries guesses around the previous converged x
+	//    and falls back to the caller's guesses if that doesn't converge
+public:
+	struct S_eq_class_stats
+	{
+		std::string m_eq_name;	//[-] Equation class name
+		int m_key;				//[-] Caller-defined key
+
+		int m_n_solves;			//[-] Number of solves
+		int m_n_warm_starts;	//[-] Number of solves started from the previous converged x
+		int m_n_warm_converged;	//[-] Number of warm starts that converged without falling back
+		int m_n_iter;			//[-] Total solver iterations
+		int m_n_eq_calls;		//[-] Total equation calls
+
+		S_eq_class_stats()
+		{
+			m_key = -1;
+			m_n_solves = m_n_warm_starts = m_n_warm_converged = m_n_iter = m_n_eq_calls = 0;
+		}
+	};
+
+private:
+	struct S_cache_entry
+	{
+		bool m_is_x_prev;		//[-] True: m_x_prev is from a converged solve
+		double m_x_prev;		//[...] Most recent converged independent variable
+
+		S_eq_class_stats ms_stats;
+
+		S_cache_entry()
+		{
+			m_is_x_prev = false;
+			m_x_prev = std::numeric_limits<double>::quiet_NaN();
+		}
+	};
+
+	std::map<std::pair<std::string, int>, S_cache_entry> m_entries;
+
+	bool m_is_enabled;		//[-] True: track stats (and warm start, if enabled)
+	bool m_is_warm_start;	//[-] True: seed guesses from previous converged x
+	int m_key;				//[-] Key applied to subsequent solves
+
+public:
+
+	C_monotonic_eq_solver_cache();
+
+	~C_monotonic_eq_solver_cache(){}
+
+	void enable(bool is_warm_start);
+
+	bool is_enabled()
+	{
+		return m_is_enabled;
+	}
+
+	void set_key(int key)
+	{
+		m_key = key;
+	}
+
+	void reset();
+
+	// Same interface as C_monotonic_eq_solver::solve, plus the equation name that keys the cache and is reported in the stats
+	//    Passes straight through when the cache is not enabled
+	int solve(const char *eq_name, C_monotonic_eq_solver &solver, double x_guess_1, double x_guess_2, double y_target,
+		double &x_solved, double &tol_solved, int &iter_solved);
+
+	void get_stats(std::vector<S_eq_class_stats> &v_stats);
+};
+
 
 //class monotonic_solver
 //{
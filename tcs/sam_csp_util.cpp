@@ -48,6 +48,9 @@
 *******************************************************************************************************/
 
 #include <algorithm>
+#include <thread>
+#include <atomic>
+#include <functional>
 
 #include "sam_csp_util.h"
 //#include "waterprop.h"
@@ -2660,3 +2663,357 @@ void Evacuated_Receiver::EvacReceiver(double T_1_in, double m_dot, double T_amb,
 	m_T_save.at(4,0) = T_5;
 
 }
+
+
+C_hce_heat_loss_table::C_hce_heat_loss_table()
+{
+	m_tol_rel = 0.01;		//[-]
+	m_tol_abs = 0.5;		//[W/m]
+	m_n_check = 200;		//[-]
+	m_n_check_axis = 20;	//[-]
+	m_n_nodes_max = 50000;	//[-]
+
+	m_n_hce_types = m_n_hce_vars = 0;
+}
+
+void C_hce_heat_loss_table::S_table::set_nodes(const int *n)
+{
+	m_n_nodes = 1;
+	for( int i = 0; i < E_N_AXES; i++ )
+	{
+		m_n[i] = n[i];
+		m_stride[i] = m_n_nodes;
+		m_n_nodes *= n[i];
+	}
+}
+
+void C_hce_heat_loss_table::node_x(const S_table & table, int i_node, double *x) const
+{
+	for( int i = E_N_AXES - 1; i >= 0; i-- )
+	{
+		int i_axis = i_node / table.m_stride[i];
+		i_node -= i_axis*table.m_stride[i];
+		x[i] = ms_axes[i].m_min + (ms_axes[i].m_max - ms_axes[i].m_min)*i_axis / (double)(table.m_n[i] - 1);
+	}
+}
+
+void C_hce_heat_loss_table::generate(const util::matrix_t<bool> & is_used, std::vector<C_point_solver*> & solvers)
+{
+	m_n_hce_types = (int)is_used.nrows();
+	m_n_hce_vars = (int)is_used.ncols();
+
+	int n_init[E_N_AXES];
+	for( int i = 0; i < E_N_AXES; i++ )
+	{
+		if( ms_axes[i].m_n < 2 || !(ms_axes[i].m_max > ms_axes[i].m_min) )
+			throw(C_csp_exception("Each heat loss table axis requires at least 2 nodes and an increasing range", "HCE heat loss table"));
+
+		n_init[i] = ms_axes[i].m_n;
+	}
+
+	int n_tables = m_n_hce_types*m_n_hce_vars;
+	mv_tables.assign(n_tables, S_table());
+
+	// Tables that still need their nodes filled and checked
+	std::vector<int> v_pending;
+	for( int i = 0; i < n_tables; i++ )
+	{
+		if( !is_used(i / m_n_hce_vars, i % m_n_hce_vars) )
+			continue;
+
+		mv_tables[i].set_nodes(n_init);
+		mv_tables[i].m_is_valid = 1;
+		v_pending.push_back(i);
+	}
+
+	// Previous refinement of each table and the axis that was refined, so its nodes aren't solved again
+	std::vector<S_table> v_prev(n_tables);
+	std::vector<int> v_refined_axis(n_tables, -1);
+
+	int n_threads = (int)solvers.size();
+	auto run_threads = [&](const std::function<void(C_point_solver*)> & work)
+	{
+		std::vector<std::thread> threads;
+		for( int i = 1; i < n_threads; i++ )
+			threads.push_back(std::thread(work, solvers[i]));
+		work(solvers[0]);
+		for( size_t i = 0; i < threads.size(); i++ )
+			threads[i].join();
+	};
+
+	while( !v_pending.empty() )
+	{
+		// Work is split into slabs of constant HTF temperature so the threads stay busy even with a single HCE
+		std::vector<int> v_job_table, v_job_slab;
+		for( size_t k = 0; k < v_pending.size(); k++ )
+		{
+			S_table & table = mv_tables[v_pending[k]];
+			table.mv_y.resize(table.m_n_nodes*E_N_OUTPUTS);
+			for( int i_T = 0; i_T < table.m_n[E_T_HTF]; i_T++ )
+			{
+				v_job_table.push_back(v_pending[k]);
+				v_job_slab.push_back(i_T);
+			}
+		}
+		int n_jobs = (int)v_job_table.size();
+		std::vector<int> v_fail(n_jobs, 0);
+
+		// Each table gets m_n_check cell center points followed by m_n_check_axis points for each axis
+		int n_check_table = m_n_check + E_N_AXES*m_n_check_axis;
+		int n_check_jobs = (int)v_pending.size()*n_check_table;
+		std::vector<double> v_check_error(n_check_jobs, 0.0);	//[W/m] Largest error of either output
+		std::vector<double> v_check_ratio(n_check_jobs, 0.0);	//[-] Largest error of either output relative to its tolerance
+
+		std::atomic<int> i_next_job(0);
+
+		// Fill nodes. E_T_HTF is the fastest varying axis, so slab 'i_T' holds every n_T-th node
+		auto fill_nodes = [&](C_point_solver *p_solver)
+		{
+			double x[E_N_AXES];
+			for( int i_job = i_next_job++; i_job < n_jobs; i_job = i_next_job++ )
+			{
+				int i_table = v_job_table[i_job];
+				S_table & table = mv_tables[i_table];
+				const S_table & prev = v_prev[i_table];
+				int i_refined = v_refined_axis[i_table];
+				int hn = i_table / m_n_hce_vars;
+				int hv = i_table % m_n_hce_vars;
+
+				for( int i_node = v_job_slab[i_job]; i_node < table.m_n_nodes; i_node += table.m_n[E_T_HTF] )
+				{
+					double *y = &table.mv_y[i_node*E_N_OUTPUTS];
+
+					// Nodes of the previous refinement are every other node along the refined axis
+					if( i_refined >= 0 )
+					{
+						int i_prev = 0;
+						int i_rem = i_node;
+						for( int i = E_N_AXES - 1; i >= 0 && i_prev >= 0; i-- )
+						{
+							int i_axis = i_rem / table.m_stride[i];
+							i_rem -= i_axis*table.m_stride[i];
+							if( i == i_refined && i_axis % 2 != 0 )
+								i_prev = -1;
+							else
+								i_prev += (i == i_refined ? i_axis / 2 : i_axis)*prev.m_stride[i];
+						}
+
+						if( i_prev >= 0 )
+						{
+							for( int j = 0; j < E_N_OUTPUTS; j++ )
+								y[j] = prev.mv_y[i_prev*E_N_OUTPUTS + j];
+							continue;
+						}
+					}
+
+					node_x(table, i_node, x);
+					if( (*p_solver)(hn, hv, x, y) != 0 || y[E_Q_HEATLOSS] != y[E_Q_HEATLOSS] || y[E_Q_34TOT] != y[E_Q_34TOT] )
+					{
+						v_fail[i_job] = 1;
+						break;
+					}
+				}
+			}
+		};
+
+		// Compare both interpolated outputs to the full solve
+		auto check_cells = [&](C_point_solver *p_solver)
+		{
+			double x[E_N_AXES];
+			double y_full[E_N_OUTPUTS];
+			double y_table[E_N_OUTPUTS];
+			for( int i_job = i_next_job++; i_job < n_check_jobs; i_job = i_next_job++ )
+			{
+				int i_table = v_pending[i_job / n_check_table];
+				const S_table & table = mv_tables[i_table];
+				int k = i_job % n_check_table;
+				int hn = i_table / m_n_hce_vars;
+				int hv = i_table % m_n_hce_vars;
+
+				if( !table.m_is_valid )
+					continue;
+
+				// Cell centers, or points midway between nodes along one axis only, where only that axis contributes
+				//    interpolation error. Deterministic scatter of cells: a different prime step along each axis
+				static const int primes[E_N_AXES] = {1, 7, 11, 13, 17, 19};
+				int i_axis_mid = k < m_n_check ? -1 : (k - m_n_check) / m_n_check_axis;
+				for( int i = 0; i < E_N_AXES; i++ )
+				{
+					int n_cells = table.m_n[i] - 1;
+					int i_cell = (k*primes[i] + i) % n_cells;
+					double f_cell = (i_axis_mid < 0 || i == i_axis_mid) ? 0.5 : 0.0;
+					x[i] = ms_axes[i].m_min + (ms_axes[i].m_max - ms_axes[i].m_min)*(i_cell + f_cell) / (double)n_cells;
+				}
+
+				if( (*p_solver)(hn, hv, x, y_full) != 0 || y_full[E_Q_HEATLOSS] != y_full[E_Q_HEATLOSS] || y_full[E_Q_34TOT] != y_full[E_Q_34TOT] )
+				{
+					// Full model can't solve this point either, so the table has nothing to reproduce
+					continue;
+				}
+
+				interpolate(table, x, y_table);
+
+				for( int j = 0; j < E_N_OUTPUTS; j++ )
+				{
+					double err = fabs(y_table[j] - y_full[j]);
+					v_check_error[i_job] = std::max(v_check_error[i_job], err);
+					v_check_ratio[i_job] = std::max(v_check_ratio[i_job], err / (m_tol_abs + m_tol_rel*fabs(y_full[j])));
+				}
+			}
+		};
+
+		i_next_job = 0;
+		run_threads(fill_nodes);
+
+		for( int i_job = 0; i_job < n_jobs; i_job++ )
+		{
+			if( v_fail[i_job] )
+				mv_tables[v_job_table[i_job]].m_is_valid = 0;
+		}
+
+		i_next_job = 0;
+		run_threads(check_cells);
+
+		std::vector<int> v_refine;
+		for( size_t k = 0; k < v_pending.size(); k++ )
+		{
+			int i_table = v_pending[k];
+			S_table & table = mv_tables[i_table];
+			v_prev[i_table] = S_table();
+
+			if( !table.m_is_valid )
+			{
+				table.mv_y.clear();
+				continue;
+			}
+
+			double max_ratio = 0.0;
+			double max_ratio_axis[E_N_AXES];
+			for( int i = 0; i < E_N_AXES; i++ )
+				max_ratio_axis[i] = 0.0;
+
+			table.m_max_error = 0.0;
+			for( int kk = 0; kk < n_check_table; kk++ )
+			{
+				int i_job = (int)k*n_check_table + kk;
+				table.m_max_error = std::max(table.m_max_error, v_check_error[i_job]);
+				max_ratio = std::max(max_ratio, v_check_ratio[i_job]);
+				if( kk >= m_n_check )
+				{
+					int i_axis = (kk - m_n_check) / m_n_check_axis;
+					max_ratio_axis[i_axis] = std::max(max_ratio_axis[i_axis], v_check_ratio[i_job]);
+				}
+			}
+
+			if( max_ratio <= 1.0 )
+				continue;
+
+			// Double the number of cells along the axis with the largest interpolation error
+			int i_refine = 0;
+			for( int i = 1; i < E_N_AXES; i++ )
+			{
+				if( max_ratio_axis[i] > max_ratio_axis[i_refine] )
+					i_refine = i;
+			}
+
+			int n_next[E_N_AXES];
+			for( int i = 0; i < E_N_AXES; i++ )
+				n_next[i] = table.m_n[i];
+			n_next[i_refine] = 2 * table.m_n[i_refine] - 1;
+
+			if( (double)table.m_n_nodes / table.m_n[i_refine] * n_next[i_refine] > m_n_nodes_max )
+			{
+				// Can't be made accurate enough within the node limit
+				table.m_is_valid = 0;
+				table.mv_y.clear();
+				continue;
+			}
+
+			v_prev[i_table] = table;
+			v_refined_axis[i_table] = i_refine;
+			table.set_nodes(n_next);
+			v_refine.push_back(i_table);
+		}
+
+		v_pending = v_refine;
+	}
+}
+
+void C_hce_heat_loss_table::interpolate(const S_table & table, const double *x, double *y) const
+{
+	int i_base = 0;
+	double w[E_N_AXES];
+	for( int i = 0; i < E_N_AXES; i++ )
+	{
+		double f = (x[i] - ms_axes[i].m_min) / (ms_axes[i].m_max - ms_axes[i].m_min)*(table.m_n[i] - 1);
+		int i_lo = std::max(0, std::min((int)f, table.m_n[i] - 2));
+		w[i] = f - i_lo;
+		i_base += i_lo*table.m_stride[i];
+	}
+
+	for( int j = 0; j < E_N_OUTPUTS; j++ )
+		y[j] = 0.0;
+
+	for( int corner = 0; corner < (1 << E_N_AXES); corner++ )
+	{
+		double w_corner = 1.0;
+		int i_node = i_base;
+		for( int i = 0; i < E_N_AXES; i++ )
+		{
+			if( corner & (1 << i) )
+			{
+				w_corner *= w[i];
+				i_node += table.m_stride[i];
+			}
+			else
+				w_corner *= 1.0 - w[i];
+		}
+
+		if( w_corner == 0.0 )
+			continue;
+
+		for( int j = 0; j < E_N_OUTPUTS; j++ )
+			y[j] += w_corner*table.mv_y[i_node*E_N_OUTPUTS + j];
+	}
+}
+
+bool C_hce_heat_loss_table::evaluate(int hn, int hv, const double *x, double *y) const
+{
+	if( hn < 0 || hn >= m_n_hce_types || hv < 0 || hv >= m_n_hce_vars || !mv_tables[hn*m_n_hce_vars + hv].m_is_valid )
+		return false;
+
+	for( int i = 0; i < E_N_AXES; i++ )
+	{
+		double f = (x[i] - ms_axes[i].m_min) / (ms_axes[i].m_max - ms_axes[i].m_min);
+		if( !(f >= 0.0 && f <= 1.0) )
+			return false;	// outside of table (or NaN)
+	}
+
+	interpolate(mv_tables[hn*m_n_hce_vars + hv], x, y);
+
+	return true;
+}
+
+bool C_hce_heat_loss_table::is_valid(int hn, int hv) const
+{
+	if( hn < 0 || hn >= m_n_hce_types || hv < 0 || hv >= m_n_hce_vars )
+		return false;
+
+	return mv_tables[hn*m_n_hce_vars + hv].m_is_valid == 1;
+}
+
+double C_hce_heat_loss_table::get_max_error(int hn, int hv) const
+{
+	if( hn < 0 || hn >= m_n_hce_types || hv < 0 || hv >= m_n_hce_vars )
+		return std::numeric_limits<double>::quiet_NaN();
+
+	return mv_tables[hn*m_n_hce_vars + hv].m_max_error;
+}
+
+int C_hce_heat_loss_table::get_n_nodes(int hn, int hv) const
+{
+	if( hn < 0 || hn >= m_n_hce_types || hv < 0 || hv >= m_n_hce_vars )
+		return 0;
+
+	return mv_tables[hn*m_n_hce_vars + hv].m_n_nodes;
+}
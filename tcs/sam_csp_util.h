@@ -461,6 +461,115 @@ public:
 
 };
 
+// Multilinear surrogate of the evacuated receiver heat loss for each HCE type and variant.
+// The table is generated once (in parallel) from the full receiver energy balance and then checked
+// against it at cell centers. Tables start from the nodes given in ms_axes and the axis with the largest
+// interpolation error is refined until the check passes or the table would exceed m_n_nodes_max.
+// evaluate() returns false when the caller should fall back to the full solve: either the point is
+// outside the table or the table for that HCE failed the error check
+class C_hce_heat_loss_table
+{
+public:
+
+	enum
+	{
+		E_T_HTF,		//[K] Average HTF temperature
+		E_Q_INC,		//[W/m] Radiation incident on the receiver after collector optical losses
+		E_T_AMB,		//[K] Ambient dry bulb temperature
+		E_V_WIND,		//[m/s] Wind speed
+		E_DT_SKY,		//[K] Ambient temperature less effective sky temperature
+		E_P_AMB,		//[Pa] Ambient pressure
+
+		E_N_AXES
+	};
+
+	enum
+	{
+		E_Q_HEATLOSS,	//[W/m] Total receiver heat loss
+		E_Q_34TOT,		//[W/m] Heat transfer from absorber to envelope
+
+		E_N_OUTPUTS
+	};
+
+	struct S_axis
+	{
+		double m_min;		//[varies] Lower bound
+		double m_max;		//[varies] Upper bound
+		int m_n;			//[-] Initial number of uniformly spaced nodes, >= 2
+
+		S_axis()
+		{
+			m_min = m_max = std::numeric_limits<double>::quiet_NaN();
+			m_n = 0;
+		}
+	};
+
+	// Full energy balance called by the table generator. Each thread gets its own instance,
+	// so implementations must not share mutable state (previous guesses, property lookup indices, ...)
+	class C_point_solver
+	{
+	public:
+		virtual ~C_point_solver(){};
+
+		// Returns 0 when the energy balance converged
+		virtual int operator()(int hn /*HCE type*/, int hv /*HCE variant*/, const double *x /*E_N_AXES*/, double *y /*E_N_OUTPUTS*/) = 0;
+	};
+
+	S_axis ms_axes[E_N_AXES];
+
+	double m_tol_rel;		//[-] Relative error allowed at check points, for each output
+	double m_tol_abs;		//[W/m] Absolute error allowed at check points, for each output
+	int m_n_check;			//[-] Number of cell center check points per HCE type and variant and refinement
+	int m_n_check_axis;		//[-] Number of check points per axis used to choose the axis to refine
+	int m_n_nodes_max;		//[-] Largest number of nodes in one table
+
+	C_hce_heat_loss_table();
+
+	~C_hce_heat_loss_table(){};
+
+	// Fill the tables for the HCE type/variant combinations flagged in 'is_used' using one thread per solver
+	void generate(const util::matrix_t<bool> & is_used, std::vector<C_point_solver*> & solvers);
+
+	bool evaluate(int hn, int hv, const double *x /*E_N_AXES*/, double *y /*E_N_OUTPUTS*/) const;
+
+	bool is_valid(int hn, int hv) const;
+
+	double get_max_error(int hn, int hv) const;		//[W/m] Largest error of either output found at the check points of the final table
+
+	int get_n_nodes(int hn, int hv) const;			//[-] Number of nodes in the final table
+
+private:
+
+	struct S_table
+	{
+		int m_n[E_N_AXES];				//[-] Number of nodes along each axis
+		int m_stride[E_N_AXES];			//[-] Node index stride for each axis
+		int m_n_nodes;					//[-]
+		std::vector<double> mv_y;		//[W/m] Node values
+		int m_is_valid;					//[-] 1: table passed error check
+		double m_max_error;				//[W/m]
+
+		S_table()
+		{
+			for( int i = 0; i < E_N_AXES; i++ )
+				m_n[i] = m_stride[i] = 0;
+			m_n_nodes = 0;
+			m_is_valid = 0;
+			m_max_error = std::numeric_limits<double>::quiet_NaN();
+		}
+
+		void set_nodes(const int *n);
+	};
+
+	int m_n_hce_types;
+	int m_n_hce_vars;
+
+	std::vector<S_table> mv_tables;		// One table for each HCE type/variant
+
+	void node_x(const S_table & table, int i_node, double *x) const;
+	void interpolate(const S_table & table, const double *x, double *y) const;
+};
+
 class Evacuated_Receiver
 {
 private:
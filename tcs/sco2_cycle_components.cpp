@@ -30,7 +30,7 @@ void calculate_turbomachinery_outlet_1(double T_in /*K*/, double P_in /*kPa*/, d
 
 	error_code = 0;
 
-	int prop_error_code = CO2_TP(T_in, P_in, &co2_props);		// properties at the inlet conditions
+	int prop_error_code = CO2_TP_memo(T_in, P_in, &co2_props);		// properties at the inlet conditions
 	if (prop_error_code != 0)
 	{
 		error_code = prop_error_code;
@@ -100,7 +100,7 @@ void isen_eta_from_poly_eta(double T_in /*K*/, double P_in /*kPa*/, double P_out
 	CO2_state co2_props;
 
 	// Properties at the inlet conditions
-	int prop_error_code = CO2_TP(T_in, P_in, &co2_props);
+	int prop_error_code = CO2_TP_memo(T_in, P_in, &co2_props);
 	if (prop_error_code != 0)
 	{
 		error_code = prop_error_code;
@@ -57,6 +57,9 @@
 #include "CO2_properties.h"
 #include <cmath>
 #include <string>
+#include <algorithm>
+#include <memory>
+#include <thread>
 
 #include "nlopt.hpp"
 
@@ -2486,6 +2489,59 @@ int C_sco2_recomp_csp::generate_ud_pc_tables(double T_htf_low /*C*/, double T_ht
 	c_sco2_ud_pc.mf_callback = mf_callback_update;
 	c_sco2_ud_pc.mp_mf_active = mp_mf_update;
 
+	// Additional threads each get their own copy of the cycle designed with the same parameters.
+	//    The cycles share this cycle's thread budget, so each copy designs with an equal share of it.
+	//    The table generator gives each cycle a fixed block of points, and a point's solution only
+	//    depends on the design, so the tables are the same for any number of copies
+	int n_threads = mc_rc_cycle.get_n_threads();
+	int n_points = 3*(std::max(3, n_T_htf) + std::max(3, n_T_amb) + std::max(3, n_m_dot_htf_ND));
+	int n_cycles_udpc = std::max(1, std::min(n_threads, n_points));
+	int n_copies = n_cycles_udpc - 1;
+
+	std::vector<std::unique_ptr<C_sco2_recomp_csp>> v_sco2_copies;
+	std::vector<std::unique_ptr<C_sco2_csp_od>> v_sco2_od_copies;
+	std::vector<C_od_pc_function*> v_pc_eq_parallel;
+	if( n_copies > 0 )
+	{
+		std::vector<int> v_is_designed(n_copies, 0);
+		for(int i = 0; i < n_copies; i++)
+		{
+			v_sco2_copies.push_back(std::unique_ptr<C_sco2_recomp_csp>(new C_sco2_recomp_csp()));
+			v_sco2_copies[i]->m_off_design_turbo_operation = m_off_design_turbo_operation;
+			v_sco2_copies[i]->set_n_threads(std::max(1, n_threads / n_cycles_udpc));
+		}
+
+		auto design_copy = [&](int i)
+		{
+			try
+			{
+				v_sco2_copies[i]->design(ms_des_par);
+				v_is_designed[i] = 1;
+			}
+			catch( ... )
+			{
+				v_is_designed[i] = 0;
+			}
+		};
+
+		std::vector<std::thread> v_threads;
+		for(int i = 0; i < n_copies; i++)
+			v_threads.push_back(std::thread(design_copy, i));
+		for(int i = 0; i < n_copies; i++)
+			v_threads[i].join();
+
+		// A copy that fails to design just isn't used; this cycle already has a design
+		for(int i = 0; i < n_copies; i++)
+		{
+			if( v_is_designed[i] == 1 )
+			{
+				v_sco2_od_copies.push_back(std::unique_ptr<C_sco2_csp_od>(new C_sco2_csp_od(v_sco2_copies[i].get())));
+				v_pc_eq_parallel.push_back(v_sco2_od_copies.back().get());
+			}
+		}
+	}
+	c_sco2_ud_pc.set_parallel_functions(v_pc_eq_parallel);
+
 	double T_htf_ref = ms_des_par.m_T_htf_hot_in - 273.15;	//[C] convert from K
 	double T_amb_ref = ms_des_par.m_T_amb_des - 273.15;		//[C] convert from K
 	double m_dot_htf_ND_ref = 1.0;							//[-]
@@ -342,6 +342,12 @@ public:
 
 	virtual void design(C_sco2_rc_csp_template::S_des_par des_par);
 
+	// Sets the number of threads the cycle design and the off-design tables may use, including the calling thread
+	void set_n_threads(int n_threads)
+	{
+		mc_rc_cycle.set_n_threads(n_threads);
+	}
+
 	//void off_design_P_mc_in_parameteric(double P_mc_in_min /*kPa*/, double P_mc_in_max /*kPa*/, double P_mc_in_inc /*kPa*/);
 
 	//void off_design_fix_P_mc_in_parametric_f_recomp(double P_mc_in /*kPa*/, double f_recomp_min /*-*/, double f_recomp_max /*-*/, double f_recomp_inc /*-*/);
@@ -55,6 +55,9 @@
 #include "CO2_properties.h"
 #include <limits>
 #include <algorithm>
+#include <memory>
+#include <thread>
+#include <exception>
 
 #include "nlopt.hpp"
 #include "nlopt_callbacks.h"
@@ -2060,7 +2063,7 @@ void C_RecompCycle::design_core_standard(int & error_code)
 
 	// State 5 can now be fully defined
 	m_enth_last[HTR_HP_OUT] = m_enth_last[MIXER_OUT] + Q_dot_HT / m_dot_t;						// Energy balance on cold stream of high-temp recuperator
-	int prop_error_code = CO2_PH(m_pres_last[HTR_HP_OUT], m_enth_last[HTR_HP_OUT], &co2_props);
+	int prop_error_code = CO2_PH_memo(m_pres_last[HTR_HP_OUT], m_enth_last[HTR_HP_OUT], &co2_props);
 	if( prop_error_code != 0 )
 	{
 		error_code = prop_error_code;
@@ -2145,7 +2148,7 @@ int C_RecompCycle::C_mono_eq_LTR_des::operator()(double T_LTR_LP_out /*K*/, doub
 	else
 	{
 		m_w_rc = 0.0;		// no recompressor
-		int prop_error_code = CO2_TP(mpc_rc_cycle->m_temp_last[LTR_LP_OUT], mpc_rc_cycle->m_pres_last[LTR_LP_OUT], &mpc_rc_cycle->mc_co2_props);
+		int prop_error_code = CO2_TP_memo(mpc_rc_cycle->m_temp_last[LTR_LP_OUT], mpc_rc_cycle->m_pres_last[LTR_LP_OUT], &mpc_rc_cycle->mc_co2_props);
 		if( prop_error_code != 0 )
 		{
 			*diff_T_LTR_LP_out = std::numeric_limits<double>::quiet_NaN();
@@ -2197,7 +2200,7 @@ int C_RecompCycle::C_mono_eq_HTR_des::operator()(double T_HTR_LP_out /*K*/, doub
 
 	mpc_rc_cycle->m_temp_last[HTR_LP_OUT] = T_HTR_LP_out;		//[K]	
 
-	int prop_error_code = CO2_TP(mpc_rc_cycle->m_temp_last[HTR_LP_OUT], mpc_rc_cycle->m_pres_last[HTR_LP_OUT], &mpc_rc_cycle->mc_co2_props);
+	int prop_error_code = CO2_TP_memo(mpc_rc_cycle->m_temp_last[HTR_LP_OUT], mpc_rc_cycle->m_pres_last[HTR_LP_OUT], &mpc_rc_cycle->mc_co2_props);
 	if( prop_error_code != 0 )
 	{
 		*diff_T_HTR_LP_out = std::numeric_limits<double>::quiet_NaN();
@@ -2244,7 +2247,7 @@ int C_RecompCycle::C_mono_eq_HTR_des::operator()(double T_HTR_LP_out /*K*/, doub
 	// Know LTR performance so we can calculate the HP outlet
 		// Energy balance on LTR HP stream
 	mpc_rc_cycle->m_enth_last[LTR_HP_OUT] = mpc_rc_cycle->m_enth_last[MC_OUT] + m_Q_dot_LT/ m_m_dot_mc;		//[kJ/kg]
-	prop_error_code = CO2_PH(mpc_rc_cycle->m_pres_last[LTR_HP_OUT], mpc_rc_cycle->m_enth_last[LTR_HP_OUT], &mpc_rc_cycle->mc_co2_props);
+	prop_error_code = CO2_PH_memo(mpc_rc_cycle->m_pres_last[LTR_HP_OUT], mpc_rc_cycle->m_enth_last[LTR_HP_OUT], &mpc_rc_cycle->mc_co2_props);
 	if( prop_error_code != 0 )
 	{
 		*diff_T_HTR_LP_out = std::numeric_limits<double>::quiet_NaN();
@@ -2258,7 +2261,7 @@ int C_RecompCycle::C_mono_eq_HTR_des::operator()(double T_HTR_LP_out /*K*/, doub
 	if( mpc_rc_cycle->ms_des_par.m_recomp_frac >= 1.E-12 )
 	{
 		mpc_rc_cycle->m_enth_last[MIXER_OUT] = (1.0 - mpc_rc_cycle->ms_des_par.m_recomp_frac)*mpc_rc_cycle->m_enth_last[LTR_HP_OUT] + mpc_rc_cycle->ms_des_par.m_recomp_frac*mpc_rc_cycle->m_enth_last[RC_OUT];	//[kJ/kg]
-		prop_error_code = CO2_PH(mpc_rc_cycle->m_pres_last[MIXER_OUT], mpc_rc_cycle->m_enth_last[MIXER_OUT], &mpc_rc_cycle->mc_co2_props);
+		prop_error_code = CO2_PH_memo(mpc_rc_cycle->m_pres_last[MIXER_OUT], mpc_rc_cycle->m_enth_last[MIXER_OUT], &mpc_rc_cycle->mc_co2_props);
 		if( prop_error_code != 0 )
 		{
 			*diff_T_HTR_LP_out = std::numeric_limits<double>::quiet_NaN();
@@ -2617,83 +2620,102 @@ void C_RecompCycle::auto_opt_design_core(int & error_code)
 
 	// Outer optimization loop
 	m_objective_metric_auto_opt = 0.0;
+	m_is_refine_guess = false;
 
 	double P_low_limit = std::min(ms_auto_opt_des_par.m_P_high_limit, std::max(10.E3, ms_auto_opt_des_par.m_P_high_limit*0.2));		//[kPa]
-	double best_P_high = fminbr(
-		P_low_limit, ms_auto_opt_des_par.m_P_high_limit, &fmin_cb_opt_des_fixed_P_high, this, 1.0);
 
-	// These should be set:
-	// ms_des_par_optimal;
-	// m_eta_thermal_opt;
-
-	// Check model with P_mc_out set at P_high_limit for a recompression and simple cycle and use the better configuration
-	double PR_mc_guess = ms_des_par_auto_opt.m_P_mc_out / ms_des_par_auto_opt.m_P_mc_in;
-
-	if( ms_auto_opt_des_par.m_is_recomp_ok )
+	// Solve a coarse grid of high-side pressures in parallel, then refine around the best grid point.
+	//    The grid size doesn't depend on the number of threads, so the result doesn't either
+	const int n_P_high_grid = 7;
+	std::vector<double> v_P_high_grid(1, P_low_limit);
+	if( ms_auto_opt_des_par.m_P_high_limit - P_low_limit > 1.0 )
 	{
-		// Complete 'ms_opt_des_par' for recompression cycle
-		ms_opt_des_par.m_P_mc_out_guess = ms_auto_opt_des_par.m_P_high_limit;
-		ms_opt_des_par.m_fixed_P_mc_out = true;
-		
-		//ms_opt_des_par.m_PR_mc_guess = PR_mc_guess;
-		//ms_opt_des_par.m_fixed_PR_mc = false;
-		ms_opt_des_par.m_fixed_PR_mc = ms_auto_opt_des_par.m_fixed_PR_mc;	//[-]
-		if (ms_opt_des_par.m_fixed_PR_mc)
-		{
-			ms_opt_des_par.m_PR_mc_guess = ms_auto_opt_des_par.m_PR_mc_guess;	//[-]
-		}
-		else
-		{
-			ms_opt_des_par.m_PR_mc_guess = PR_mc_guess;		//[-]
-		}
-
-		ms_opt_des_par.m_recomp_frac_guess = 0.3;
-		ms_opt_des_par.m_fixed_recomp_frac = false;
-		ms_opt_des_par.m_LT_frac_guess = 0.5;
-		ms_opt_des_par.m_fixed_LT_frac = false;
+		v_P_high_grid.resize(n_P_high_grid);
+		for( int i = 0; i < n_P_high_grid; i++ )
+			v_P_high_grid[i] = P_low_limit + (ms_auto_opt_des_par.m_P_high_limit - P_low_limit)*i / (double)(n_P_high_grid - 1);	//[kPa]
+	}
+	int n_grid = (int)v_P_high_grid.size();
+
+	std::vector<S_opt_des_fixed_P_high> v_opt_cases;
+	for( int i = 0; i < n_grid; i++ )
+		add_opt_des_fixed_P_high(v_P_high_grid[i], PR_mc_guess_fixed_P_high(v_P_high_grid[i], ms_opt_des_par.m_T_mc_in), 0.3, 0.5, v_opt_cases);
+
+	// Create the cycles for the fixed high-side pressure optimizations once, and reuse them for every
+	//    pressure the search tries. The grid has the most cases, so it sets how many threads are useful
+	int n_rc_opt_cycles = std::max(1, std::min(m_n_threads, (int)v_opt_cases.size()));
+	std::vector<std::unique_ptr<C_RecompCycle>> v_rc_copies;
+	mv_rc_opt_cycles.assign(1, this);
+	for( int i = 1; i < n_rc_opt_cycles; i++ )
+	{
+		v_rc_copies.push_back(std::unique_ptr<C_RecompCycle>(new C_RecompCycle()));
+		v_rc_copies.back()->ms_des_limits = ms_des_limits;
+		v_rc_copies.back()->ms_des_par = ms_des_par;
+		v_rc_copies.back()->ms_opt_des_par = ms_opt_des_par;
+		v_rc_copies.back()->ms_auto_opt_des_par = ms_auto_opt_des_par;
+		v_rc_copies.back()->set_n_threads(1);
+		mv_rc_opt_cycles.push_back(v_rc_copies.back().get());
+	}
 
-		int rc_error_code = 0;
+	opt_des_fixed_P_high_parallel(v_opt_cases);
 
-		opt_design_core(rc_error_code);
+	int n_cases_per_P = (int)v_opt_cases.size() / n_grid;
+	std::vector<double> v_eta_grid(n_grid, 0.0);
+	int i_best = 0;
+	for( int i = 0; i < n_grid; i++ )
+	{
+		for( int j = 0; j < n_cases_per_P; j++ )
+			v_eta_grid[i] = max(v_eta_grid[i], v_opt_cases[i*n_cases_per_P + j].m_objective_metric);
 
-		if( rc_error_code == 0 && m_objective_metric_opt > m_objective_metric_auto_opt )
-		{
-			ms_des_par_auto_opt = ms_des_par_optimal;
-			m_objective_metric_auto_opt = m_objective_metric_opt;
-		}
+		if( v_eta_grid[i] > v_eta_grid[i_best] )
+			i_best = i;
 	}
 
-	// Complete 'ms_opt_des_par' for simple cycle
-	ms_opt_des_par.m_P_mc_out_guess = ms_auto_opt_des_par.m_P_high_limit;
-	ms_opt_des_par.m_fixed_P_mc_out = true;
-	
-	//ms_opt_des_par.m_PR_mc_guess = PR_mc_guess;
-	//ms_opt_des_par.m_fixed_PR_mc = false;
-	ms_opt_des_par.m_fixed_PR_mc = ms_auto_opt_des_par.m_fixed_PR_mc;	//[-]
-	if (ms_opt_des_par.m_fixed_PR_mc)
+	// The refinement starts every recompression optimization from the best grid design
+	if( m_objective_metric_auto_opt > 0.0 && ms_des_par_auto_opt.m_recomp_frac > 0.0 )
 	{
-		ms_opt_des_par.m_PR_mc_guess = ms_auto_opt_des_par.m_PR_mc_guess;	//[-]
+		m_is_refine_guess = true;
+		m_PR_mc_refine_guess = ms_des_par_auto_opt.m_P_mc_out / ms_des_par_auto_opt.m_P_mc_in;
+		m_recomp_frac_refine_guess = ms_des_par_auto_opt.m_recomp_frac;
+		m_LT_frac_refine_guess = ms_des_par_auto_opt.m_UA_LT / (ms_des_par_auto_opt.m_UA_LT + ms_des_par_auto_opt.m_UA_HT);
 	}
-	else
+
+	if( n_grid > 1 )
 	{
-		ms_opt_des_par.m_PR_mc_guess = PR_mc_guess;		//[-]
-	}
+		// Refine between the neighbors of the best grid point. If no grid point solved, search the full range
+		double P_bracket_low = P_low_limit;							//[kPa]
+		double P_bracket_high = ms_auto_opt_des_par.m_P_high_limit;	//[kPa]
+		if( v_eta_grid[i_best] > 0.0 )
+		{
+			P_bracket_low = v_P_high_grid[std::max(0, i_best - 1)];
+			P_bracket_high = v_P_high_grid[std::min(n_grid - 1, i_best + 1)];
+		}
 
-	ms_opt_des_par.m_recomp_frac_guess = 0.0;
-	ms_opt_des_par.m_fixed_recomp_frac = true;
-	ms_opt_des_par.m_LT_frac_guess = 1.0;
-	ms_opt_des_par.m_fixed_LT_frac = true;
+		fminbr(P_bracket_low, P_bracket_high, &fmin_cb_opt_des_fixed_P_high, this, 1.0);
+	}
 
-	int s_error_code = 0;
+	m_is_refine_guess = false;
 
-	opt_design_core(s_error_code);
+	// These should be set:
+	// ms_des_par_optimal;
+	// m_eta_thermal_opt;
 
-	if( s_error_code == 0 && m_objective_metric_opt > m_objective_metric_auto_opt )
+	// Check model with P_mc_out set at P_high_limit for a recompression and simple cycle and use the better configuration
+	double PR_mc_guess = ms_des_par_auto_opt.m_P_mc_out / ms_des_par_auto_opt.m_P_mc_in;
+	double recomp_frac_guess = 0.3;		//[-]
+	double LT_frac_guess = 0.5;			//[-]
+	if( ms_des_par_auto_opt.m_recomp_frac > 0.0 )
 	{
-		ms_des_par_auto_opt = ms_des_par_optimal;
-		m_objective_metric_auto_opt = m_objective_metric_opt;
+		recomp_frac_guess = ms_des_par_auto_opt.m_recomp_frac;
+		LT_frac_guess = ms_des_par_auto_opt.m_UA_LT / (ms_des_par_auto_opt.m_UA_LT + ms_des_par_auto_opt.m_UA_HT);
 	}
 
+	v_opt_cases.clear();
+	add_opt_des_fixed_P_high(ms_auto_opt_des_par.m_P_high_limit, PR_mc_guess, recomp_frac_guess, LT_frac_guess, v_opt_cases);
+
+	opt_des_fixed_P_high_parallel(v_opt_cases);
+
+	mv_rc_opt_cycles.clear();
+
 	ms_des_par = ms_des_par_auto_opt;
 
 	int optimal_design_error_code = 0;
@@ -2944,8 +2966,70 @@ void C_RecompCycle::auto_opt_design_hit_eta(S_auto_opt_design_hit_eta_parameters
 	int solver_code = 0;
 	try
 	{
-		solver_code = c_solver.solve(UA_recups_guess, 1.1*UA_recups_guess, auto_opt_des_hit_eta_in.m_eta_thermal,
-			UA_recup_total_solved, tol_solved, iter_solved);
+		if( m_n_threads > 1 )
+		{
+			// The first two guesses are independent, so a copy of this cycle solves the second guess while
+			//    this cycle solves the first, and each gets half of the threads. The copy finds the same design
+			//    this cycle would, and the guesses are logged in order
+			C_monotonic_eq_solver::S_xy_pair xy_pair_1, xy_pair_2;
+			xy_pair_1.x = UA_recups_guess;			//[kW/K]
+			xy_pair_2.x = 1.1*UA_recups_guess;		//[kW/K]
+
+			C_RecompCycle c_rc_copy;
+			c_rc_copy.ms_des_limits = ms_des_limits;
+			c_rc_copy.ms_des_par = ms_des_par;
+			c_rc_copy.ms_opt_des_par = ms_opt_des_par;
+			c_rc_copy.ms_auto_opt_des_par = ms_auto_opt_des_par;
+			c_rc_copy.set_n_threads(m_n_threads / 2);
+			C_MEQ_sco2_design_hit_eta__UA_total c_eq_copy(&c_rc_copy);
+
+			int n_threads = m_n_threads;
+			m_n_threads = n_threads - n_threads / 2;
+
+			int copy_code = -1;
+			std::exception_ptr p_copy_exception;
+			std::thread copy_thread([&]()
+			{
+				try
+				{
+					copy_code = c_eq_copy.design_UA_total(xy_pair_2.x, &xy_pair_2.y);
+				}
+				catch( ... )
+				{
+					p_copy_exception = std::current_exception();
+				}
+			});
+
+			int this_code = -1;
+			try
+			{
+				this_code = c_eq.design_UA_total(xy_pair_1.x, &xy_pair_1.y);
+			}
+			catch( ... )
+			{
+				copy_thread.join();
+				m_n_threads = n_threads;
+				throw;
+			}
+			copy_thread.join();
+			m_n_threads = n_threads;
+
+			if( p_copy_exception )
+				std::rethrow_exception(p_copy_exception);
+
+			if( this_code == 0 )
+				c_eq.log_UA_total(xy_pair_1.x, xy_pair_1.y);
+			if( copy_code == 0 )
+				c_eq.log_UA_total(xy_pair_2.x, xy_pair_2.y);
+
+			solver_code = c_solver.solve(xy_pair_1, xy_pair_2, auto_opt_des_hit_eta_in.m_eta_thermal,
+				UA_recup_total_solved, tol_solved, iter_solved);
+		}
+		else
+		{
+			solver_code = c_solver.solve(UA_recups_guess, 1.1*UA_recups_guess, auto_opt_des_hit_eta_in.m_eta_thermal,
+				UA_recup_total_solved, tol_solved, iter_solved);
+		}
 	}
 	catch (C_csp_exception &csp_except)
 	{
@@ -2990,6 +3074,16 @@ void C_RecompCycle::auto_opt_design_hit_eta(S_auto_opt_design_hit_eta_parameters
 }
 
 int C_RecompCycle::C_MEQ_sco2_design_hit_eta__UA_total::operator()(double UA_recup_total /*kW/K*/, double *eta /*-*/)
+{
+	if( design_UA_total(UA_recup_total, eta) != 0 )
+		return -1;
+
+	log_UA_total(UA_recup_total, *eta);
+
+	return 0;
+}
+
+int C_RecompCycle::C_MEQ_sco2_design_hit_eta__UA_total::design_UA_total(double UA_recup_total /*kW/K*/, double *eta /*-*/)
 {
 	mpc_rc_cycle->ms_auto_opt_des_par.m_UA_rec_total = UA_recup_total;	//[kW/K]
 
@@ -3003,10 +3097,15 @@ int C_RecompCycle::C_MEQ_sco2_design_hit_eta__UA_total::operator()(double UA_rec
 
 	*eta = mpc_rc_cycle->get_design_solved()->m_eta_thermal;	//[-]
 
+	return 0;
+}
+
+void C_RecompCycle::C_MEQ_sco2_design_hit_eta__UA_total::log_UA_total(double UA_recup_total /*kW/K*/, double eta /*-*/)
+{
 	if (mpc_rc_cycle->ms_auto_opt_des_par.mf_callback_log && mpc_rc_cycle->ms_auto_opt_des_par.mp_mf_active)
 	{
 		msg_log = util::format(" Total recuperator conductance = %lg [kW/K per MWe]. Optimized cycle efficiency = %lg [-].  ",
-			UA_recup_total / (mpc_rc_cycle->ms_auto_opt_des_par.m_W_dot_net * 1.E-3), *eta);
+			UA_recup_total / (mpc_rc_cycle->ms_auto_opt_des_par.m_W_dot_net * 1.E-3), eta);
 		if (!mpc_rc_cycle->ms_auto_opt_des_par.mf_callback_log(msg_log, msg_progress, mpc_rc_cycle->ms_auto_opt_des_par.mp_mf_active, 0.0, 2))
 		{
 			std::string error_msg = "User terminated simulation...";
@@ -3014,60 +3113,61 @@ int C_RecompCycle::C_MEQ_sco2_design_hit_eta__UA_total::operator()(double UA_rec
 			throw(C_csp_exception(error_msg, loc_msg, 1));
 		}
 	}
-
-	return 0;
 }
 
 
 double C_RecompCycle::opt_eta_fixed_P_high(double P_high_opt)
 {
-	double PR_mc_guess = 1.1;
-	if(P_high_opt > P_pseudocritical_1(ms_opt_des_par.m_T_mc_in))
-		PR_mc_guess = P_high_opt / P_pseudocritical_1(ms_opt_des_par.m_T_mc_in);
-		
-	double local_eta_rc = 0.0;
-	if( ms_auto_opt_des_par.m_is_recomp_ok )
-	{		 
-		// Complete 'ms_opt_des_par' for recompression cycle
-		ms_opt_des_par.m_P_mc_out_guess = P_high_opt;
-		ms_opt_des_par.m_fixed_P_mc_out = true;
-		
-		//ms_opt_des_par.m_PR_mc_guess = PR_mc_guess;
-		//ms_opt_des_par.m_fixed_PR_mc = false;
-		ms_opt_des_par.m_fixed_PR_mc = ms_auto_opt_des_par.m_fixed_PR_mc;	//[-]
-		if (ms_opt_des_par.m_fixed_PR_mc)
-		{
-			ms_opt_des_par.m_PR_mc_guess = ms_auto_opt_des_par.m_PR_mc_guess;	//[-]
-		}
-		else
-		{
-			ms_opt_des_par.m_PR_mc_guess = PR_mc_guess;		//[-]
-		}
+	// Start from the best recompression grid point, if any. It's usually close to the optimum
+	//    at a nearby pressure, which saves most of the inner optimization iterations
+	double PR_mc_guess = PR_mc_guess_fixed_P_high(P_high_opt, ms_opt_des_par.m_T_mc_in);	//[-]
+	double recomp_frac_guess = 0.3;		//[-]
+	double LT_frac_guess = 0.5;			//[-]
+	if( m_is_refine_guess )
+	{
+		PR_mc_guess = m_PR_mc_refine_guess;
+		recomp_frac_guess = m_recomp_frac_refine_guess;
+		LT_frac_guess = m_LT_frac_refine_guess;
+	}
 
-		ms_opt_des_par.m_recomp_frac_guess = 0.3;
-		ms_opt_des_par.m_fixed_recomp_frac = false;
-		ms_opt_des_par.m_LT_frac_guess = 0.5;
-		ms_opt_des_par.m_fixed_LT_frac = false;
+	// Recompression and simple cycle optimizations are independent, so they run in parallel
+	std::vector<S_opt_des_fixed_P_high> v_opt_cases;
+	add_opt_des_fixed_P_high(P_high_opt, PR_mc_guess, recomp_frac_guess, LT_frac_guess, v_opt_cases);
 
-		int rc_error_code = 0;
-		opt_design_core(rc_error_code);
-	
-		if( rc_error_code == 0 )
-			local_eta_rc = m_objective_metric_opt;
-	
-		if(rc_error_code == 0 && m_objective_metric_opt > m_objective_metric_auto_opt)
-		{
-			ms_des_par_auto_opt = ms_des_par_optimal;
-			m_objective_metric_auto_opt = m_objective_metric_opt;
-		}
+	opt_des_fixed_P_high_parallel(v_opt_cases);
+
+	double local_eta_max = 0.0;
+	for( size_t i = 0; i < v_opt_cases.size(); i++ )
+		local_eta_max = max(local_eta_max, v_opt_cases[i].m_objective_metric);
+
+	return -local_eta_max;
+}
+
+void C_RecompCycle::add_opt_des_fixed_P_high(double P_high, double PR_mc_guess, double recomp_frac_guess, double LT_frac_guess,
+					std::vector<S_opt_des_fixed_P_high> & v_opt_cases)
+{
+	S_opt_des_fixed_P_high opt_case;
+	opt_case.m_P_mc_out = P_high;						//[kPa]
+	opt_case.m_PR_mc_guess = PR_mc_guess;				//[-]
+	opt_case.m_recomp_frac_guess = recomp_frac_guess;	//[-]
+	opt_case.m_LT_frac_guess = LT_frac_guess;			//[-]
+
+	if( ms_auto_opt_des_par.m_is_recomp_ok )
+	{
+		opt_case.m_is_recomp = true;
+		v_opt_cases.push_back(opt_case);
 	}
 
-	// Complete 'ms_opt_des_par' for simple cycle
-	ms_opt_des_par.m_P_mc_out_guess = P_high_opt;
+	opt_case.m_is_recomp = false;
+	v_opt_cases.push_back(opt_case);
+}
+
+void C_RecompCycle::opt_des_fixed_P_high_core(S_opt_des_fixed_P_high & opt_case)
+{
+	// Complete 'ms_opt_des_par' for recompression or simple cycle
+	ms_opt_des_par.m_P_mc_out_guess = opt_case.m_P_mc_out;
 	ms_opt_des_par.m_fixed_P_mc_out = true;
-	
-	//ms_opt_des_par.m_PR_mc_guess = PR_mc_guess;
-	//ms_opt_des_par.m_fixed_PR_mc = false;
+
 	ms_opt_des_par.m_fixed_PR_mc = ms_auto_opt_des_par.m_fixed_PR_mc;	//[-]
 	if (ms_opt_des_par.m_fixed_PR_mc)
 	{
@@ -3075,29 +3175,94 @@ double C_RecompCycle::opt_eta_fixed_P_high(double P_high_opt)
 	}
 	else
 	{
-		ms_opt_des_par.m_PR_mc_guess = PR_mc_guess;		//[-]
+		ms_opt_des_par.m_PR_mc_guess = opt_case.m_PR_mc_guess;		//[-]
 	}
 
-	ms_opt_des_par.m_recomp_frac_guess = 0.0;
-	ms_opt_des_par.m_fixed_recomp_frac = true;
-	ms_opt_des_par.m_LT_frac_guess = 1.0;
-	ms_opt_des_par.m_fixed_LT_frac = true;
-
-	int s_error_code = 0;
-	opt_design_core(s_error_code);
+	if( opt_case.m_is_recomp )
+	{
+		ms_opt_des_par.m_recomp_frac_guess = opt_case.m_recomp_frac_guess;
+		ms_opt_des_par.m_fixed_recomp_frac = false;
+		ms_opt_des_par.m_LT_frac_guess = opt_case.m_LT_frac_guess;
+		ms_opt_des_par.m_fixed_LT_frac = false;
+	}
+	else
+	{
+		ms_opt_des_par.m_recomp_frac_guess = 0.0;
+		ms_opt_des_par.m_fixed_recomp_frac = true;
+		ms_opt_des_par.m_LT_frac_guess = 1.0;
+		ms_opt_des_par.m_fixed_LT_frac = true;
+	}
 
-	double local_eta_s = 0.0;
-	if( s_error_code == 0 )
-		local_eta_s = m_objective_metric_opt;
+	opt_case.m_error_code = 0;
+	opt_design_core(opt_case.m_error_code);
 
-	if(s_error_code == 0 && m_objective_metric_opt > m_objective_metric_auto_opt)
+	opt_case.m_objective_metric = 0.0;
+	if( opt_case.m_error_code == 0 )
 	{
-		ms_des_par_auto_opt = ms_des_par_optimal;
-		m_objective_metric_auto_opt = m_objective_metric_opt;
+		opt_case.m_objective_metric = m_objective_metric_opt;
+		opt_case.ms_des_par_optimal = ms_des_par_optimal;
 	}
+}
 
-	return -max(local_eta_rc, local_eta_s);
+void C_RecompCycle::opt_des_fixed_P_high_parallel(std::vector<S_opt_des_fixed_P_high> & v_opt_cases)
+{
+	int n_cases = (int)v_opt_cases.size();
+
+	// Outside 'auto_opt_design_core' there are no cycle copies, so this cycle solves every case
+	std::vector<C_RecompCycle*> v_rc_cycles = mv_rc_opt_cycles;
+	if( v_rc_cycles.empty() )
+		v_rc_cycles.push_back(this);
+	int n_threads = std::max(1, std::min((int)v_rc_cycles.size(), n_cases));
+
+	// Case i is solved on cycle i % n_threads. Each case starts from its own guesses, so the result
+	//    doesn't depend on which cycle solves it. This cycle solves its cases on the calling thread
+	auto worker = [&](int i_thread)
+	{
+		C_RecompCycle *p_rc_cycle = v_rc_cycles[i_thread];
+		for( int i = i_thread; i < n_cases; i += n_threads )
+		{
+			S_opt_des_fixed_P_high & opt_case = v_opt_cases[i];
+			try
+			{
+				p_rc_cycle->opt_des_fixed_P_high_core(opt_case);
+			}
+			catch( C_csp_exception &csp_exception )
+			{
+				opt_case.m_is_exception = true;
+				opt_case.m_exception_msg = csp_exception.m_error_message;
+			}
+			catch( ... )
+			{
+				opt_case.m_is_exception = true;
+				opt_case.m_exception_msg = "Unknown exception";
+			}
+		}
+	};
+
+	std::vector<std::thread> v_threads;
+	for( int i = 1; i < n_threads; i++ )
+		v_threads.push_back(std::thread(worker, i));
+
+	worker(0);
+
+	for( int i = 0; i < n_threads - 1; i++ )
+		v_threads[i].join();
+
+	// Merge in case order so ties resolve the same way as a serial search
+	for( int i = 0; i < n_cases; i++ )
+	{
+		const S_opt_des_fixed_P_high & opt_case = v_opt_cases[i];
+		if( opt_case.m_is_exception )
+		{
+			throw(C_csp_exception(opt_case.m_exception_msg, "C_RecompCycle::auto_opt_design_core"));
+		}
 
+		if( opt_case.m_error_code == 0 && opt_case.m_objective_metric > m_objective_metric_auto_opt )
+		{
+			ms_des_par_auto_opt = opt_case.ms_des_par_optimal;
+			m_objective_metric_auto_opt = opt_case.m_objective_metric;
+		}
+	}
 }
 
 void C_RecompCycle::finalize_design(int & error_code)
@@ -3604,7 +3769,7 @@ int C_RecompCycle::C_mono_eq_LTR_od::operator()(double T_LTR_LP_out_guess /*K*/,
 
 	mpc_rc_cycle->m_temp_od[LTR_LP_OUT] = T_LTR_LP_out_guess;		//[K]
 
-	int prop_error_code = CO2_TP(mpc_rc_cycle->m_temp_od[LTR_LP_OUT], mpc_rc_cycle->m_pres_od[LTR_LP_OUT], &mpc_rc_cycle->mc_co2_props);
+	int prop_error_code = CO2_TP_memo(mpc_rc_cycle->m_temp_od[LTR_LP_OUT], mpc_rc_cycle->m_pres_od[LTR_LP_OUT], &mpc_rc_cycle->mc_co2_props);
 	if( prop_error_code != 0 )
 	{
 		*diff_T_LTR_LP_out = std::numeric_limits<double>::quiet_NaN();
@@ -3627,7 +3792,7 @@ int C_RecompCycle::C_mono_eq_LTR_od::operator()(double T_LTR_LP_out_guess /*K*/,
 		}
 
 		// Fully define state 10
-		prop_error_code = CO2_TP(mpc_rc_cycle->m_temp_od[RC_OUT], mpc_rc_cycle->m_pres_od[RC_OUT], &mpc_rc_cycle->mc_co2_props);
+		prop_error_code = CO2_TP_memo(mpc_rc_cycle->m_temp_od[RC_OUT], mpc_rc_cycle->m_pres_od[RC_OUT], &mpc_rc_cycle->mc_co2_props);
 		if( prop_error_code != 0 )
 		{
 			*diff_T_LTR_LP_out = std::numeric_limits<double>::quiet_NaN();
@@ -3672,7 +3837,7 @@ int C_RecompCycle::C_mono_eq_HTR_od::operator()(double T_HTR_LP_out_guess /*K*/,
 
 	mpc_rc_cycle->m_temp_od[HTR_LP_OUT] = T_HTR_LP_out_guess;	//[K]
 
-	int prop_error_code = CO2_TP(mpc_rc_cycle->m_temp_od[HTR_LP_OUT],mpc_rc_cycle->m_pres_od[HTR_LP_OUT], &mpc_rc_cycle->mc_co2_props);
+	int prop_error_code = CO2_TP_memo(mpc_rc_cycle->m_temp_od[HTR_LP_OUT],mpc_rc_cycle->m_pres_od[HTR_LP_OUT], &mpc_rc_cycle->mc_co2_props);
 	if( prop_error_code != 0 )
 	{
 		*diff_T_HTR_LP_out = std::numeric_limits<double>::quiet_NaN();
@@ -3720,7 +3885,7 @@ int C_RecompCycle::C_mono_eq_HTR_od::operator()(double T_HTR_LP_out_guess /*K*/,
 
 	// Now, calculate State 3
 	mpc_rc_cycle->m_enth_od[LTR_HP_OUT] = mpc_rc_cycle->m_enth_od[MC_OUT] + m_Q_dot_LTR / m_m_dot_mc;		//[kJ/kg] Energy balance on HP stream of LTR
-	prop_error_code = CO2_PH(mpc_rc_cycle->m_pres_od[LTR_HP_OUT], mpc_rc_cycle->m_enth_od[LTR_HP_OUT], &mpc_rc_cycle->mc_co2_props);
+	prop_error_code = CO2_PH_memo(mpc_rc_cycle->m_pres_od[LTR_HP_OUT], mpc_rc_cycle->m_enth_od[LTR_HP_OUT], &mpc_rc_cycle->mc_co2_props);
 	if( prop_error_code != 0 )
 	{
 		*diff_T_HTR_LP_out = std::numeric_limits<double>::quiet_NaN();
@@ -3736,7 +3901,7 @@ int C_RecompCycle::C_mono_eq_HTR_od::operator()(double T_HTR_LP_out_guess /*K*/,
 		// Conservation of energy
 		mpc_rc_cycle->m_enth_od[MIXER_OUT] = (1.0 - mpc_rc_cycle->ms_od_phi_par.m_recomp_frac)*mpc_rc_cycle->m_enth_od[LTR_HP_OUT] +
 												mpc_rc_cycle->ms_od_phi_par.m_recomp_frac*mpc_rc_cycle->m_enth_od[RC_OUT];
-		prop_error_code = CO2_PH(mpc_rc_cycle->m_pres_od[MIXER_OUT], mpc_rc_cycle->m_enth_od[MIXER_OUT], &mpc_rc_cycle->mc_co2_props);
+		prop_error_code = CO2_PH_memo(mpc_rc_cycle->m_pres_od[MIXER_OUT], mpc_rc_cycle->m_enth_od[MIXER_OUT], &mpc_rc_cycle->mc_co2_props);
 		if( prop_error_code != 0 )
 		{
 			*diff_T_HTR_LP_out = std::numeric_limits<double>::quiet_NaN();
@@ -3887,7 +4052,7 @@ int C_RecompCycle::C_mono_eq_turbo_N_fixed_m_dot::operator()(double m_dot_t_in /
 	mpc_rc_cycle->m_temp_od[C_RecompCycle::MC_OUT] = T_mc_out;	//[K]
 
 	// Calculate main compressor power
-	int prop_err_code = CO2_TP(T_mc_out, P_mc_out, &mc_co2_props);
+	int prop_err_code = CO2_TP_memo(T_mc_out, P_mc_out, &mc_co2_props);
 
 	// Calculate scaled pressure drops through heat exchangers
 		// LTR
@@ -4008,42 +4173,27 @@ int C_RecompCycle::C_mono_eq_x_f_recomp_y_N_rc::operator()(double f_recomp /*-*/
 	m_m_dot_rc = m_m_dot_t*f_recomp;	//[kg/s]
 	m_m_dot_mc = m_m_dot_t - m_m_dot_rc;
 
-	// Fully define known states
-	int prop_error_code = CO2_TP(mpc_rc_cycle->m_temp_od[MC_IN], mpc_rc_cycle->m_pres_od[MC_IN], &mc_co2_props);
-	if( prop_error_code != 0 )
+	// Fully define known states in one batch. It returns the error of the first state that failed
+	const int n_known = 4;
+	int i_known[n_known] = {MC_IN, MC_OUT, TURB_IN, TURB_OUT};
+	double T_known[n_known], P_known[n_known];
+	CO2_state co2_known[n_known];
+	for( int i = 0; i < n_known; i++ )
 	{
-		return prop_error_code;
+		T_known[i] = mpc_rc_cycle->m_temp_od[i_known[i]];	//[K]
+		P_known[i] = mpc_rc_cycle->m_pres_od[i_known[i]];	//[kPa]
 	}
-	mpc_rc_cycle->m_enth_od[MC_IN] = mc_co2_props.enth;
-	mpc_rc_cycle->m_entr_od[MC_IN] = mc_co2_props.entr;
-	mpc_rc_cycle->m_dens_od[MC_IN] = mc_co2_props.dens;
-
-	prop_error_code = CO2_TP(mpc_rc_cycle->m_temp_od[MC_OUT], mpc_rc_cycle->m_pres_od[MC_OUT], &mc_co2_props);
+	int prop_error_code = CO2_TP_batch(n_known, T_known, P_known, co2_known, 0);
 	if( prop_error_code != 0 )
 	{
 		return prop_error_code;
 	}
-	mpc_rc_cycle->m_enth_od[MC_OUT] = mc_co2_props.enth;
-	mpc_rc_cycle->m_entr_od[MC_OUT] = mc_co2_props.entr;
-	mpc_rc_cycle->m_dens_od[MC_OUT] = mc_co2_props.dens;
-
-	prop_error_code = CO2_TP(mpc_rc_cycle->m_temp_od[TURB_IN], mpc_rc_cycle->m_pres_od[TURB_IN], &mc_co2_props);
-	if( prop_error_code != 0 )
+	for( int i = 0; i < n_known; i++ )
 	{
-		return prop_error_code;
+		mpc_rc_cycle->m_enth_od[i_known[i]] = co2_known[i].enth;
+		mpc_rc_cycle->m_entr_od[i_known[i]] = co2_known[i].entr;
+		mpc_rc_cycle->m_dens_od[i_known[i]] = co2_known[i].dens;
 	}
-	mpc_rc_cycle->m_enth_od[TURB_IN] = mc_co2_props.enth;
-	mpc_rc_cycle->m_entr_od[TURB_IN] = mc_co2_props.entr;
-	mpc_rc_cycle->m_dens_od[TURB_IN] = mc_co2_props.dens;
-
-	prop_error_code = CO2_TP(mpc_rc_cycle->m_temp_od[TURB_OUT], mpc_rc_cycle->m_pres_od[TURB_OUT], &mc_co2_props);
-	if( prop_error_code != 0 )
-	{
-		return prop_error_code;
-	}
-	mpc_rc_cycle->m_enth_od[TURB_OUT] = mc_co2_props.enth;
-	mpc_rc_cycle->m_entr_od[TURB_OUT] = mc_co2_props.entr;
-	mpc_rc_cycle->m_dens_od[TURB_OUT] = mc_co2_props.dens;
 
 	// Solve recuperators here...
 	double T_HTR_LP_out_lower = mpc_rc_cycle->m_temp_od[MC_OUT];		//[K] Coldest possible temperature
@@ -4081,7 +4231,7 @@ int C_RecompCycle::C_mono_eq_x_f_recomp_y_N_rc::operator()(double f_recomp /*-*/
 
 	// State 5 can now be fully defined
 	mpc_rc_cycle->m_enth_od[HTR_HP_OUT] = mpc_rc_cycle->m_enth_od[MIXER_OUT] + Q_dot_HTR / m_m_dot_t;		//[kJ/kg] Energy balance on cold stream of high-temp recuperator
-	prop_error_code = CO2_PH(mpc_rc_cycle->m_pres_od[HTR_HP_OUT], mpc_rc_cycle->m_enth_od[HTR_HP_OUT], &mc_co2_props);
+	prop_error_code = CO2_PH_memo(mpc_rc_cycle->m_pres_od[HTR_HP_OUT], mpc_rc_cycle->m_enth_od[HTR_HP_OUT], &mc_co2_props);
 	if( prop_error_code != 0 )
 	{
 		return prop_error_code;
@@ -6239,6 +6389,16 @@ void C_RecompCycle::off_design_fix_shaft_speeds_core(int & error_code)
 //	return eta_return;
 //}
 
+double PR_mc_guess_fixed_P_high(double P_high /*kPa*/, double T_mc_in /*K*/)
+{
+	// Guess a main compressor inlet at the pseudocritical pressure, if possible
+	double PR_mc_guess = 1.1;
+	if( P_high > P_pseudocritical_1(T_mc_in) )
+		PR_mc_guess = P_high / P_pseudocritical_1(T_mc_in);
+
+	return PR_mc_guess;
+}
+
 double fmin_cb_opt_des_fixed_P_high(double P_high /*kPa*/, void *data)
 {
 	C_RecompCycle *frame = static_cast<C_RecompCycle*>(data);
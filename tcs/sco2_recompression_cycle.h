@@ -57,6 +57,7 @@
 #include <algorithm>
 #include <string>
 #include <math.h>
+#include <thread>
 #include "CO2_properties.h"
 
 #include "heat_exchangers.h"
@@ -637,6 +638,48 @@ private:
 	double m_objective_metric_auto_opt;	
 	S_design_parameters ms_des_par_auto_opt;
 
+		// One recompression or simple cycle optimization at a fixed high-side pressure
+	struct S_opt_des_fixed_P_high
+	{
+		double m_P_mc_out;			//[kPa] Fixed main compressor outlet pressure
+		double m_PR_mc_guess;		//[-] Main compressor pressure ratio guess
+		double m_recomp_frac_guess;	//[-] Recompression fraction guess, recompression cycle only
+		double m_LT_frac_guess;		//[-] LT recuperator fraction of total UA guess, recompression cycle only
+		bool m_is_recomp;			//[-] True: optimize recompression cycle, False: simple cycle
+
+		int m_error_code;			//[-] Error code from 'opt_design_core'
+		double m_objective_metric;	//[-] Optimized objective metric, 0 if error
+		S_design_parameters ms_des_par_optimal;
+
+		bool m_is_exception;
+		std::string m_exception_msg;
+
+		S_opt_des_fixed_P_high()
+		{
+			m_P_mc_out = m_PR_mc_guess = m_recomp_frac_guess = m_LT_frac_guess = std::numeric_limits<double>::quiet_NaN();
+			m_is_recomp = false;
+
+			m_error_code = -1;
+			m_objective_metric = 0.0;
+
+			m_is_exception = false;
+		}
+	};
+
+		// Cycles that solve the fixed high-side pressure optimizations, [0] is this cycle.
+		//    Only set while 'auto_opt_design_core' runs; the copies are owned there
+	std::vector<C_RecompCycle*> mv_rc_opt_cycles;
+
+		// Number of threads the design optimizations may use, including the calling thread
+	int m_n_threads;
+
+		// Recompression guesses for the high-side pressure refinement, from the best grid point.
+		//    Fixed before the refinement starts so each pressure's result doesn't depend on the search history
+	bool m_is_refine_guess;
+	double m_PR_mc_refine_guess;		//[-]
+	double m_recomp_frac_refine_guess;	//[-]
+	double m_LT_frac_refine_guess;		//[-]
+
 		// Results from last off-design solution
 	std::vector<double> m_temp_od, m_pres_od, m_enth_od, m_entr_od, m_dens_od;					// thermodynamic states (K, kPa, kJ/kg, kJ/kg-K, kg/m3)
 	double m_eta_thermal_od;
@@ -672,6 +715,13 @@ private:
 
 	void auto_opt_design_core(int & error_code);
 
+	void add_opt_des_fixed_P_high(double P_high, double PR_mc_guess, double recomp_frac_guess, double LT_frac_guess,
+					std::vector<S_opt_des_fixed_P_high> & v_opt_cases);
+
+	void opt_des_fixed_P_high_core(S_opt_des_fixed_P_high & opt_case);
+
+	void opt_des_fixed_P_high_parallel(std::vector<S_opt_des_fixed_P_high> & v_opt_cases);
+
 	void finalize_design(int & error_code);	
 
 	//void off_design_core(int & error_code);
@@ -704,6 +754,11 @@ public:
 		m_objective_metric_opt = std::numeric_limits<double>::quiet_NaN();
 		m_objective_metric_auto_opt = std::numeric_limits<double>::quiet_NaN();
 
+		m_n_threads = std::max(1, (int)std::thread::hardware_concurrency());
+
+		m_is_refine_guess = false;
+		m_PR_mc_refine_guess = m_recomp_frac_refine_guess = m_LT_frac_refine_guess = std::numeric_limits<double>::quiet_NaN();
+
 		m_temp_od = m_pres_od = m_enth_od = m_entr_od = m_dens_od = m_temp_last;
 
 		m_eta_thermal_od = m_W_dot_net_od = m_Q_dot_PHX_od = std::numeric_limits<double>::quiet_NaN();
@@ -746,6 +801,18 @@ public:
 
 	void auto_opt_design_hit_eta(S_auto_opt_design_hit_eta_parameters & auto_opt_des_hit_eta_in, int & error_code, string & error_msg);
 
+	// Sets the number of threads 'auto_opt_design' and 'auto_opt_design_hit_eta' may use, including the calling thread.
+	//    The default is the number of hardware threads. The design doesn't depend on it
+	void set_n_threads(int n_threads)
+	{
+		m_n_threads = std::max(1, n_threads);
+	}
+
+	int get_n_threads()
+	{
+		return m_n_threads;
+	}
+
 	//void off_design(S_od_parameters & od_par_in, int & error_code);
 
 	//void off_design_phi(S_od_phi_par & od_phi_par_in, int & error_code);
@@ -1015,6 +1082,11 @@ public:
 		}
 
 		virtual int operator()(double UA_recup_total /*kW/K*/, double *eta /*-*/);
+
+		// Optimizes the cycle at the conductance without sending a log message
+		int design_UA_total(double UA_recup_total /*kW/K*/, double *eta /*-*/);
+
+		void log_UA_total(double UA_recup_total /*kW/K*/, double eta /*-*/);
 	};
 
 	// Called by 'nlopt_callback_opt_des_1', so needs to be public
@@ -1045,6 +1117,8 @@ double fmin_cb_opt_des_fixed_P_high(double P_high /*kPa*/, void *data);
 
 double P_pseudocritical_1(double T_K);
 
+double PR_mc_guess_fixed_P_high(double P_high /*kPa*/, double T_mc_in /*K*/);
+
 
 //double nlopt_callback_tub_bal_opt(const std::vector<double> &x, std::vector<double> &grad, void *data);
 
@@ -50,6 +50,10 @@
 #include "ud_power_cycle.h"
 #include "csp_solver_util.h"
 
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
 void C_ud_power_cycle::init(const util::matrix_t<double> & T_htf_ind, double T_htf_ref /*C*/, double T_htf_low /*C*/, double T_htf_high /*C*/,
 	const util::matrix_t<double> & T_amb_ind, double T_amb_ref /*C*/, double T_amb_low /*C*/, double T_amb_high /*C*/,
 	const util::matrix_t<double> & m_dot_htf_ind, double m_dot_htf_ref /*-*/, double m_dot_htf_low /*-*/, double m_dot_htf_high /*-*/)
@@ -451,11 +455,8 @@ int C_ud_pc_table_generator::generate_tables(double T_htf_ref /*C*/, double T_ht
 		throw(C_csp_exception(msg, "User defined power cycle, generate tables"));
 	}
 
-	C_od_pc_function::S_f_inputs pc_inputs;
-	C_od_pc_function::S_f_outputs pc_outputs;
-
 	// ******************************************
-	// Setup T_HTF parameteric runs
+	// Check number of levels for each independent variable
 	if(n_T_htf < 3)
 	{
 		std::string msg = util::format("The input argument for number of indepedent HTF temperatures is %d."
@@ -463,165 +464,259 @@ int C_ud_pc_table_generator::generate_tables(double T_htf_ref /*C*/, double T_ht
 		mc_messages.add_notice(msg);
 		n_T_htf = 3;
 	}
+	if(n_T_amb < 3)
+	{
+		std::string msg = util::format("The input argument for number of independent ambient temperatures"
+						" is %d. It was reset to the minimum value of 3.", n_T_amb);
+		mc_messages.add_notice(msg);
+		n_T_amb = 3;
+	}
+	if(n_m_dot_htf_ND < 3)
+	{
+		std::string msg = util::format("The input argument for number of independent normalized HTF mass flow rates"
+						" is %d. It was reset to the minimum value of 3.", n_m_dot_htf_ND);
+		mc_messages.add_notice(msg);
+		n_m_dot_htf_ND = 3;
+	}
+	// ******************************************
+
+	// ******************************************
+	// Set up all table points. Each point is independent, so they're solved together and saved below in the same order as the tables
+	std::vector<S_table_point> v_points;
+	v_points.reserve(3*(n_T_htf + n_T_amb + n_m_dot_htf_ND));
 
+	S_table_point s_point;
+	s_point.m_off_design_code = 0;
+	s_point.m_is_exception = false;
+
+	// 1st table: T_htf parametric runs at ambient design temperature and low, ref, and high ND mass flow rate levels
 	T_htf_ind.clear();
 	T_htf_ind.resize(n_T_htf, 13);		// Set matrix size
 	double delta_T_htf = (T_htf_high - T_htf_low)/double(n_T_htf-1);
 
-	double n_runs_total = 3.0*(n_T_htf + n_T_amb + n_m_dot_htf_ND);
+	std::vector<double> m_dot_htf_ND_levels(3);
+	m_dot_htf_ND_levels[0] = m_dot_htf_ND_low;
+	m_dot_htf_ND_levels[1] = m_dot_htf_ND_ref;
+	m_dot_htf_ND_levels[2] = m_dot_htf_ND_high;
 
-	// Set ambient temperature because it is constant for the HTF temperature parametrics
-	pc_inputs.m_T_amb = T_amb_ref;	//[C]
+	s_point.m_table = 0;
+	s_point.ms_inputs.m_T_amb = T_amb_ref;	//[C]
 	for(int i = 0; i < n_T_htf; i++)
 	{
 		T_htf_ind(i,0) = T_htf_low + delta_T_htf*i;	//[C]
-		pc_inputs.m_T_htf_hot = T_htf_ind(i,0);
+		s_point.ms_inputs.m_T_htf_hot = T_htf_ind(i,0);
 
-		// Call at low, ref, and high ND mass flow rate levels
-		std::vector<double> m_dot_htf_ND_levels(3);
-		m_dot_htf_ND_levels[0] = m_dot_htf_ND_low;
-		m_dot_htf_ND_levels[1] = m_dot_htf_ND_ref;
-		m_dot_htf_ND_levels[2] = m_dot_htf_ND_high;
 		for(int j = 0; j < 3; j++)
 		{
-			pc_inputs.m_m_dot_htf_ND = m_dot_htf_ND_levels[j];
-			int off_design_code = mf_pc_eq(pc_inputs,pc_outputs);
-
-			if( off_design_code == 0 )
-			{
-				// Save outputs
-				T_htf_ind(i,1+j) = pc_outputs.m_W_dot_gross_ND;		//[-]
-				T_htf_ind(i,4+j) = pc_outputs.m_Q_dot_in_ND;		//[-]
-				T_htf_ind(i,7+j) = pc_outputs.m_W_dot_cooling_ND;	//[-]
-				T_htf_ind(i,10+j) = pc_outputs.m_m_dot_water_ND;	//[-]
-			}
-			else
-			{
-				std::string err_msg = util::format("The 1st UDPC table (primary: T_htf, interaction: m_dot_htf_ND) generation failed at T_htf = %lg [C] and m_dot_htf = %lg [-]", pc_inputs.m_T_htf_hot, pc_inputs.m_m_dot_htf_ND);
-				throw(C_csp_exception(err_msg, "UDPC"));
-			}
-
-			double run_number = i*3 + j;
-
-			send_callback((int)run_number + 1, (int)n_runs_total,
-				pc_inputs.m_T_htf_hot, pc_inputs.m_m_dot_htf_ND, pc_inputs.m_T_amb,
-				pc_outputs.m_W_dot_gross_ND, pc_outputs.m_Q_dot_in_ND,
-				pc_outputs.m_W_dot_cooling_ND, pc_outputs.m_m_dot_water_ND);
-
+			s_point.m_i = i;
+			s_point.m_j = j;
+			s_point.ms_inputs.m_m_dot_htf_ND = m_dot_htf_ND_levels[j];
+			v_points.push_back(s_point);
 		}
-
-	}
-	// ******************************************
-
-	// ******************************************
-	// Setup T_amb parametric runs
-	if(n_T_amb < 3)
-	{
-		std::string msg = util::format("The input argument for number of independent ambient temperatures"
-						" is %d. It was reset to the minimum value of 3.", n_T_amb);
-		mc_messages.add_notice(msg);
-		n_T_amb = 3;
 	}
 
+	// 2nd table: T_amb parametric runs at design ND mass flow rate and low, ref, and high HTF temperature levels
 	T_amb_ind.clear();
 	T_amb_ind.resize(n_T_amb, 13);		// Set matrix size
 	double delta_T_amb = (T_amb_high - T_amb_low)/double(n_T_amb-1);
 
-	// Set ND htf mass flow rate because it is constant for the ambient temperature parametrics
-	pc_inputs.m_m_dot_htf_ND = m_dot_htf_ND_ref;
+	std::vector<double> T_htf_levels(3);
+	T_htf_levels[0] = T_htf_low;   //[C]
+	T_htf_levels[1] = T_htf_ref;   //[C]
+	T_htf_levels[2] = T_htf_high;  //[C]
+
+	s_point.m_table = 1;
+	s_point.ms_inputs.m_m_dot_htf_ND = m_dot_htf_ND_ref;
 	for(int i = 0; i < n_T_amb; i++)
 	{
 		T_amb_ind(i,0) = T_amb_low + delta_T_amb*i;		//[C]
-		pc_inputs.m_T_amb = T_amb_ind(i,0);				//[C]
+		s_point.ms_inputs.m_T_amb = T_amb_ind(i,0);		//[C]
 
-		// Call at low, ref, and high HTF temperature levels
-		std::vector<double> T_htf_levels(3);
-		T_htf_levels[0] = T_htf_low;   //[C]
-		T_htf_levels[1] = T_htf_ref;   //[C]
-		T_htf_levels[2] = T_htf_high;  //[C]
 		for(int j = 0; j < 3; j++)
 		{
-			pc_inputs.m_T_htf_hot = T_htf_levels[j];
-			int off_design_code = mf_pc_eq(pc_inputs,pc_outputs);
+			s_point.m_i = i;
+			s_point.m_j = j;
+			s_point.ms_inputs.m_T_htf_hot = T_htf_levels[j];
+			v_points.push_back(s_point);
+		}
+	}
 
-			if( off_design_code == 0 )
-			{
-				// Save outputs
-				T_amb_ind(i,1+j) = pc_outputs.m_W_dot_gross_ND;		//[-]
-				T_amb_ind(i,4+j) = pc_outputs.m_Q_dot_in_ND;		//[-]
-				T_amb_ind(i,7+j) = pc_outputs.m_W_dot_cooling_ND;	//[-]
-				T_amb_ind(i,10+j) = pc_outputs.m_m_dot_water_ND;	//[-]
-			}
-			else
-			{
-				std::string err_msg = util::format("The 2nd UDPC table (primary: T_amb, interaction: T_htf) generation failed at T_amb = %lg [C] and T_htf = %lg [C]", pc_inputs.m_T_amb, pc_inputs.m_T_htf_hot);
-				throw(C_csp_exception(err_msg, "UDPC"));
-			}
+	// 3rd table: ND m_dot parametric runs at design HTF temperature and low, ref, and high ambient temperatures
+	m_dot_htf_ind.clear();
+	m_dot_htf_ind.resize(n_m_dot_htf_ND,13);		// Set matrix size
+	double delta_m_dot = (m_dot_htf_ND_high-m_dot_htf_ND_low)/double(n_m_dot_htf_ND-1);
+
+	std::vector<double> T_amb_levels(3);
+	T_amb_levels[0] = T_amb_low;    //[C]
+	T_amb_levels[1] = T_amb_ref;	//[C]
+	T_amb_levels[2] = T_amb_high;	//[C]
 
-			double run_number = 3.0*n_T_htf + i*3 + j;
+	s_point.m_table = 2;
+	s_point.ms_inputs.m_T_htf_hot = T_htf_ref;
+	for(int i = 0; i < n_m_dot_htf_ND; i++)
+	{
+		m_dot_htf_ind(i,0) = m_dot_htf_ND_low + delta_m_dot*i;		//[-]
+		s_point.ms_inputs.m_m_dot_htf_ND = m_dot_htf_ind(i,0);		//[-]
 
-			send_callback((int)run_number + 1, (int)n_runs_total,
-				pc_inputs.m_T_htf_hot, pc_inputs.m_m_dot_htf_ND, pc_inputs.m_T_amb,
-				pc_outputs.m_W_dot_gross_ND, pc_outputs.m_Q_dot_in_ND,
-				pc_outputs.m_W_dot_cooling_ND, pc_outputs.m_m_dot_water_ND);
+		for(int j = 0; j < 3; j++)
+		{
+			s_point.m_i = i;
+			s_point.m_j = j;
+			s_point.ms_inputs.m_T_amb = T_amb_levels[j];
+			v_points.push_back(s_point);
 		}
 	}
 	// ******************************************
 
+	// Solve points. Throws at the first failed point, in table order
+	run_table_points(v_points);
+
 	// ******************************************
-	// Setup ND m_dot parametric runs
-	if(n_m_dot_htf_ND < 3)
+	// Save outputs
+	util::matrix_t<double> *p_tables[3] = {&T_htf_ind, &T_amb_ind, &m_dot_htf_ind};
+	for(size_t k = 0; k < v_points.size(); k++)
 	{
-		std::string msg = util::format("The input argument for number of independent normalized HTF mass flow rates"
-						" is %d. It was reset to the minimum value of 3.", n_m_dot_htf_ND);
-		mc_messages.add_notice(msg);
-		n_m_dot_htf_ND = 3;
+		util::matrix_t<double> & table = *p_tables[v_points[k].m_table];
+		int i = v_points[k].m_i;
+		int j = v_points[k].m_j;
+
+		table(i,1+j) = v_points[k].ms_outputs.m_W_dot_gross_ND;		//[-]
+		table(i,4+j) = v_points[k].ms_outputs.m_Q_dot_in_ND;		//[-]
+		table(i,7+j) = v_points[k].ms_outputs.m_W_dot_cooling_ND;	//[-]
+		table(i,10+j) = v_points[k].ms_outputs.m_m_dot_water_ND;	//[-]
 	}
+	// ******************************************
+	
+	return 0;
+}
 
-	m_dot_htf_ind.clear();
-	m_dot_htf_ind.resize(n_m_dot_htf_ND,13);		// Set matrix size
-	double delta_m_dot = (m_dot_htf_ND_high-m_dot_htf_ND_low)/double(n_m_dot_htf_ND-1);
+void C_ud_pc_table_generator::set_parallel_functions(const std::vector<C_od_pc_function*> & v_pc_eq_parallel)
+{
+	mv_pc_eq_parallel = v_pc_eq_parallel;
+}
 
-	// Set HTF temperature because it is constant for the ambient temperature parametrics
-	pc_inputs.m_T_htf_hot = T_htf_ref;
-	for(int i = 0; i < n_m_dot_htf_ND; i++)
+void C_ud_pc_table_generator::run_table_points(std::vector<S_table_point> & v_points)
+{
+	int n_points = (int)v_points.size();
+
+	std::vector<C_od_pc_function*> v_pc_eq;
+	v_pc_eq.push_back(&mf_pc_eq);
+	for(size_t k = 0; k < mv_pc_eq_parallel.size() && (int)v_pc_eq.size() < n_points; k++)
 	{
-		m_dot_htf_ind(i,0) = m_dot_htf_ND_low + delta_m_dot*i;		//[-]
-		pc_inputs.m_m_dot_htf_ND = m_dot_htf_ind(i,0);				//[-]
+		if( mv_pc_eq_parallel[k] != 0 )
+			v_pc_eq.push_back(mv_pc_eq_parallel[k]);
+	}
+	int n_threads = (int)v_pc_eq.size();
 
-		// Call at low, ref, and high ambient temperatures
-		std::vector<double> T_amb_levels(3);
-		T_amb_levels[0] = T_amb_low;    //[C]
-		T_amb_levels[1] = T_amb_ref;	//[C]
-		T_amb_levels[2] = T_amb_high;	//[C]
-		for(int j = 0; j < 3; j++)
+	// Each function solves a fixed, contiguous block of points in table order, because off-design functions
+	//    may warm start from their previous solution. The calling thread sends callbacks in point order as points finish
+	std::vector<bool> v_is_done(n_points, false);
+	bool is_stop = false;
+	int k_failed_first = n_points;	//[-] Lowest failed point so far; points after it aren't needed
+	std::mutex mtx;
+	std::condition_variable cv_done;
+
+	auto worker = [&](int i_thread)
+	{
+		C_od_pc_function *pf_pc_eq = v_pc_eq[i_thread];
+		int k_start = (int)((long long)n_points*i_thread / n_threads);
+		int k_end = (int)((long long)n_points*(i_thread + 1) / n_threads);
+
+		for(int k = k_start; k < k_end; k++)
 		{
-			pc_inputs.m_T_amb = T_amb_levels[j];
-			int off_design_code = mf_pc_eq(pc_inputs, pc_outputs);
-		
-			if( off_design_code == 0 )
 			{
-				// Save outputs
-				m_dot_htf_ind(i,1+j) = pc_outputs.m_W_dot_gross_ND;		//[-]
-				m_dot_htf_ind(i,4+j) = pc_outputs.m_Q_dot_in_ND;		//[-]
-				m_dot_htf_ind(i,7+j) = pc_outputs.m_W_dot_cooling_ND;	//[-]
-				m_dot_htf_ind(i,10+j) = pc_outputs.m_m_dot_water_ND;	//[-]
+				std::lock_guard<std::mutex> lock(mtx);
+				if( is_stop || k > k_failed_first )
+					return;
+			}
+
+			S_table_point & s_pt = v_points[k];
+			try
+			{
+				s_pt.m_off_design_code = (*pf_pc_eq)(s_pt.ms_inputs, s_pt.ms_outputs);
+			}
+			catch( C_csp_exception &csp_exception )
+			{
+				s_pt.m_is_exception = true;
+				s_pt.m_exception_msg = csp_exception.m_error_message;
 			}
-			else
+			catch( ... )
 			{
-				std::string err_msg = util::format("The 3rd UDPC table (primary: m_dot_htf_ND, interaction: T_amb) generation failed at T_amb = %lg [C] and m_dot_htf = %lg [-]", pc_inputs.m_T_amb, pc_inputs.m_m_dot_htf_ND);
-				throw(C_csp_exception(err_msg, "UDPC"));
+				s_pt.m_is_exception = true;
+				s_pt.m_exception_msg = "Unknown exception";
 			}
 
-			double run_number = 3.0*n_T_htf + 3.0*n_T_amb  + i*3 + j;
+			{
+				std::lock_guard<std::mutex> lock(mtx);
+				v_is_done[k] = true;
+				// Later points aren't needed after a failure, but earlier ones in other blocks still are
+				if( s_pt.m_is_exception || s_pt.m_off_design_code != 0 )
+					k_failed_first = std::min(k_failed_first, k);
+			}
+			cv_done.notify_one();
+		}
+	};
+
+	std::vector<std::thread> v_threads;
+	for(int i = 0; i < n_threads; i++)
+		v_threads.push_back(std::thread(worker, i));
+
+	int k_failed = -1;
+	std::string callback_error_msg;
+	for(int k = 0; k < n_points && callback_error_msg.empty(); k++)
+	{
+		{
+			std::unique_lock<std::mutex> lock(mtx);
+			while( !v_is_done[k] )
+				cv_done.wait(lock);
+		}
+
+		const S_table_point & s_pt = v_points[k];
+		if( s_pt.m_is_exception || s_pt.m_off_design_code != 0 )
+		{
+			k_failed = k;
+			break;
+		}
+
+		try
+		{
+			send_callback(k + 1, n_points,
+				s_pt.ms_inputs.m_T_htf_hot, s_pt.ms_inputs.m_m_dot_htf_ND, s_pt.ms_inputs.m_T_amb,
+				s_pt.ms_outputs.m_W_dot_gross_ND, s_pt.ms_outputs.m_Q_dot_in_ND,
+				s_pt.ms_outputs.m_W_dot_cooling_ND, s_pt.ms_outputs.m_m_dot_water_ND);
+		}
+		catch( C_csp_exception &csp_exception )
+		{
+			// User terminated: let running points finish, then re-throw
+			callback_error_msg = csp_exception.m_error_message;
+			std::lock_guard<std::mutex> lock(mtx);
+			is_stop = true;
+		}
+	}
+
+	for(int i = 0; i < n_threads; i++)
+		v_threads[i].join();
+
+	if( !callback_error_msg.empty() )
+	{
+		throw(C_csp_exception(callback_error_msg, "C_ud_pc_table_generator", 1));
+	}
 
-			send_callback((int)run_number + 1, (int)n_runs_total,
-				pc_inputs.m_T_htf_hot, pc_inputs.m_m_dot_htf_ND, pc_inputs.m_T_amb,
-				pc_outputs.m_W_dot_gross_ND, pc_outputs.m_Q_dot_in_ND,
-				pc_outputs.m_W_dot_cooling_ND, pc_outputs.m_m_dot_water_ND);
+	if( k_failed >= 0 )
+	{
+		const S_table_point & s_pt = v_points[k_failed];
+		if( s_pt.m_is_exception )
+		{
+			throw(C_csp_exception(s_pt.m_exception_msg, "UDPC"));
 		}
+
+		std::string err_msg;
+		if( s_pt.m_table == 0 )
+			err_msg = util::format("The 1st UDPC table (primary: T_htf, interaction: m_dot_htf_ND) generation failed at T_htf = %lg [C] and m_dot_htf = %lg [-]", s_pt.ms_inputs.m_T_htf_hot, s_pt.ms_inputs.m_m_dot_htf_ND);
+		else if( s_pt.m_table == 1 )
+			err_msg = util::format("The 2nd UDPC table (primary: T_amb, interaction: T_htf) generation failed at T_amb = %lg [C] and T_htf = %lg [C]", s_pt.ms_inputs.m_T_amb, s_pt.ms_inputs.m_T_htf_hot);
+		else
+			err_msg = util::format("The 3rd UDPC table (primary: m_dot_htf_ND, interaction: T_amb) generation failed at T_amb = %lg [C] and m_dot_htf = %lg [-]", s_pt.ms_inputs.m_T_amb, s_pt.ms_inputs.m_m_dot_htf_ND);
+		throw(C_csp_exception(err_msg, "UDPC"));
 	}
-	// ******************************************
-	
-	return 0;
 }
\ No newline at end of file
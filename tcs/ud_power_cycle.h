@@ -51,6 +51,7 @@
 #define __UD_POWER_CYCLE_
 
 #include <limits>
+#include <vector>
 #include "interpolation_routines.h"
 #include "csp_solver_util.h"
 
@@ -190,6 +191,27 @@ private:
 	std::string m_log_msg;
 	std::string m_progress_msg;	
 
+	// Additional off-design functions, each with its own cycle, that run table points in parallel with mf_pc_eq
+	//    The points are split into one contiguous block per function, in table order, so each function
+	//    always sees the same sequence of points and the tables don't depend on thread timing
+	std::vector<C_od_pc_function*> mv_pc_eq_parallel;
+
+	struct S_table_point
+	{
+		int m_table;		//[-] 0: T_htf, 1: T_amb, 2: m_dot_htf_ND
+		int m_i;			//[-] Row in table
+		int m_j;			//[-] Interaction level (low, ref, high)
+
+		C_od_pc_function::S_f_inputs ms_inputs;
+		C_od_pc_function::S_f_outputs ms_outputs;
+
+		int m_off_design_code;		//[-] Off-design function return value
+		bool m_is_exception;		//[-] True: off-design function threw
+		std::string m_exception_msg;
+	};
+
+	void run_table_points(std::vector<S_table_point> & v_points);
+
 	void send_callback(int run_number, int n_runs_total,
 		double T_htf_hot, double m_dot_htf_ND, double T_amb,
 		double W_dot_gross_ND, double Q_dot_in_ND,
@@ -203,6 +225,9 @@ public:
 
 	~C_ud_pc_table_generator(){}
 
+	// Optional: off-design functions that are independent of mf_pc_eq (i.e. use a cycle copy) and may be called concurrently
+	void set_parallel_functions(const std::vector<C_od_pc_function*> & v_pc_eq_parallel);
+
 	int generate_tables(double T_htf_ref /*C*/, double T_htf_low /*C*/, double T_htf_high /*C*/, int n_T_htf /*-*/,
 		double T_amb_ref /*C*/, double T_amb_low /*C*/, double T_amb_high /*C*/, int n_T_amb /*-*/,
 		double m_dot_htf_ND_ref /*-*/, double m_dot_htf_ND_low /*-*/, double m_dot_htf_ND_high /*-*/, int n_m_dot_htf_ND,
@@ -575,4 +575,194 @@ TEST_F(BifacialIrradTest, TestRearSurfaceIrradiance)
 			ASSERT_NEAR(rearIrradiance[i], expectedRearIrradiance[i], e) << "Failed at t = " << t << " i = " << i;
 		}
 	}
-}
\ No newline at end of file
+}
+
+/**
+*   Test that reusing a workspace between time steps, which keeps the sky configuration factors while the
+*   geometry is unchanged, gives the same rear-side irradiance as calculating every time step from scratch
+*/
+TEST_F(DayCaseIrradProc, RearSideWorkspaceMatchesUncached_lib_irradproc)
+{
+	// Fixed tilt keeps the same geometry all day, a backtracking tracker changes it every time step
+	for (int track = 0; track < 2; track++)
+	{
+		rearSideWorkspace workspace;
+		int nsunup = 0;
+		for (int step = 0; step < 96; step++)
+		{
+			// calc_rear_side() overwrites the surface angles, so each calculation gets its own irrad
+			irrad irr[2];
+			for (int k = 0; k < 2; k++)
+			{
+				irr[k].set_time(year, month, day, step / 4, 15 * (step % 4) + 7, 0.25);
+				irr[k].set_location(lat, lon, tz);
+				irr[k].set_sky_model(skymodel, alb);
+				irr[k].set_beam_diffuse(700 * (step % 7 + 1) / 7., 120);
+				if (track == 0)
+					irr[k].set_surface(0, tilt, azim, rotlim, false, 0.4);
+				else
+					irr[k].set_surface(1, 0, 180, 45, true, 0.4);
+				ASSERT_EQ(irr[k].calc(), 0) << "track " << track << " step " << step;
+			}
+
+			irr[0].calc_rear_side(0.013, 0.65, 1.0, 2.0);
+			double uncached = irr[0].get_poa_rear();
+			irr[1].calc_rear_side(0.013, 0.65, 1.0, 2.0, workspace);
+			EXPECT_EQ(irr[1].get_poa_rear(), uncached) << "track " << track << " step " << step;
+			if (uncached > 0)
+				nsunup++;
+		}
+		EXPECT_TRUE(workspace.skyFactorsValid);
+		EXPECT_GT(nsunup, 40) << "track " << track;
+	}
+}
+
+/**
+*   Test that decomposing the POA a day at a time ahead of the time step loop, split into day ranges as
+*   pvsamv1 does for its threads, gives exactly the results of decomposing each time step on its own
+*/
+TEST_F(IrradTest, PoaDecompDaysMatchesPoaDecomp_lib_irradproc)
+{
+	// A year of hourly POA data on a steep fixed tilt surface, which has the sun behind it on summer mornings
+	// and evenings, with changing albedo and dew point
+	size_t nsteps = 8760;
+	vector<double> poaData(nsteps), inc(nsteps), tiltData(nsteps), zen(nsteps), exTer(nsteps);
+	poaDecompReq uncached, cached;
+	poaDecompReq *reqs[] = { &uncached, &cached };
+	for (int k = 0; k < 2; k++)
+	{
+		reqs[k]->POA = &poaData[0];
+		reqs[k]->inc = &inc[0];
+		reqs[k]->tilt = &tiltData[0];
+		reqs[k]->zen = &zen[0];
+		reqs[k]->exTer = &exTer[0];
+		reqs[k]->elev = 200;
+		reqs[k]->numberOfSteps = nsteps;
+		reqs[k]->albedo.resize(nsteps);
+		reqs[k]->dewPoint.resize(nsteps);
+	}
+
+	size_t idx = 0;
+	for (int m = 0; m < 12; m++)
+	{
+		for (size_t d = 1; d <= util::nday[m]; d++)
+		{
+			for (int h = 0; h < 24; h++, idx++)
+			{
+				double sun[9], angle[5];
+				solarpos(year, m + 1, (int)d, h, 30, lat, lon, tz, sun);
+				if (sun[2] > 0)
+				{
+					incidence(0, 60, 180, 0, sun[1], sun[0], false, 0, angle);
+					double clearness = 0.4 + 0.5 * ((idx * 7) % 11) / 10.;
+					poaData[idx] = fmax(clearness * 1000 * cos(angle[0]) + 80, 0);
+					inc[idx] = angle[0];
+					tiltData[idx] = angle[1];
+					zen[idx] = sun[1];
+				}
+				else
+				{
+					poaData[idx] = -999;
+					inc[idx] = tiltData[idx] = zen[idx] = -999;
+				}
+				exTer[idx] = sun[8];
+				for (int k = 0; k < 2; k++)
+				{
+					reqs[k]->albedo[idx] = 0.15 + 0.05 * (m % 4);
+					reqs[k]->dewPoint[idx] = (h % 3 == 0) ? 18 : -5 + 12 * sin(M_PI * m / 11.);
+				}
+			}
+		}
+	}
+	ASSERT_EQ(idx, nsteps);
+
+	cached.decomposed.resize(nsteps);
+	poaDecompDays(&cached, 0, 100);
+	poaDecompDays(&cached, 100, 243);
+	poaDecompDays(&cached, 243, 365);
+
+	size_t nsunup = 0;
+	for (size_t i = 0; i < nsteps; i++)
+	{
+		// Indices as the pvsamv1 time step loop updates them
+		for (int k = 0; k < 2; k++)
+		{
+			reqs[k]->i = i;
+			reqs[k]->tDew = reqs[k]->dewPoint[i];
+			if (i % 24 == 0)
+			{
+				reqs[k]->dayStart = i;
+				reqs[k]->doy += 1;
+			}
+		}
+		const poaDecompResult &r = cached.decomposed[i];
+		if (inc[i] == -999)
+		{
+			EXPECT_FALSE(r.valid) << "step " << i;
+			continue;
+		}
+		nsunup++;
+
+		double angle[5] = { inc[i], tiltData[i], 0, 0, 0 };
+		double sun[9] = { 0, zen[i], 0, 0, 0, 0, 0, 0, exTer[i] };
+		// As in irrad::calc(), the diffuse components are only set at 90 degrees incidence or more
+		double dn, df, gh, poa[3], diffc[3] = { 0, 0, 0 };
+		poaDecomp(poaData[i], angle, sun, uncached.albedo[i], &uncached, dn, df, gh, poa, diffc);
+
+		ASSERT_TRUE(r.valid) << "step " << i;
+		EXPECT_EQ(r.dn, dn) << "step " << i;
+		EXPECT_EQ(r.df, df) << "step " << i;
+		EXPECT_EQ(r.gh, gh) << "step " << i;
+		for (int j = 0; j < 3; j++)
+		{
+			EXPECT_EQ(r.poa[j], poa[j]) << "step " << i << " j " << j;
+			EXPECT_EQ(r.diffc[j], diffc[j]) << "step " << i << " j " << j;
+		}
+
+		// The time step loop picks up the stored result
+		double dnc, dfc, ghc, poac[3], diffcc[3];
+		poaDecomp(poaData[i], angle, sun, cached.albedo[i], &cached, dnc, dfc, ghc, poac, diffcc);
+		EXPECT_EQ(dnc, dn) << "step " << i;
+		EXPECT_EQ(ghc, gh) << "step " << i;
+		EXPECT_EQ(poac[1], poa[1]) << "step " << i;
+	}
+	EXPECT_GT(nsunup, 4000u);
+}
+
+/**
+*   Test the ground albedo selection shared by irrad and the pvsamv1 POA decomposition
+*/
+TEST_F(DayCaseIrradProc, GetAlbedo_lib_irradproc)
+{
+	std::vector<double> monthlyAlbedo;
+	for (int m = 0; m < 12; m++)
+		monthlyAlbedo.push_back(0.1 + 0.05 * m);
+
+	weather_record wf;
+	wf.year = year;
+	wf.month = month;
+	wf.day = day;
+	wf.alb = 0.35;
+
+	// The weather file albedo is used when selected and valid
+	EXPECT_EQ(irrad::get_albedo(wf, true, monthlyAlbedo), 0.35);
+	EXPECT_EQ(irrad::get_albedo(wf, false, monthlyAlbedo), monthlyAlbedo[month - 1]);
+
+	// Otherwise the value for the month is used
+	double invalid[] = { std::numeric_limits<double>::quiet_NaN(), 0, 1, 1.2, -999 };
+	for (int i = 0; i < 5; i++)
+	{
+		wf.alb = invalid[i];
+		EXPECT_EQ(irrad::get_albedo(wf, true, monthlyAlbedo), monthlyAlbedo[month - 1]) << "weather file albedo " << invalid[i];
+	}
+	wf.month = 12;
+	EXPECT_EQ(irrad::get_albedo(wf, true, monthlyAlbedo), monthlyAlbedo[11]);
+
+	// An invalid month gives an albedo that the irradiance processor rejects
+	EXPECT_EQ(irr_hourly_day.check(), 0);
+	wf.month = 0;
+	irr_hourly_day.set_sky_model(skymodel, irrad::get_albedo(wf, true, monthlyAlbedo));
+	EXPECT_EQ(irr_hourly_day.check(), -7);
+	wf.month = 13;
+	EXPECT_EQ(irrad::get_albedo(wf, false, monthlyAlbedo), -999);
+}
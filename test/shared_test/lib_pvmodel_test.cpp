@@ -0,0 +1,452 @@
+#include <cmath>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "lib_pvmodel.h"
+#include "lib_cec6par.h"
+#include "lib_sandia.h"
+#include "lib_iec61853.h"
+
+/**
+* Tests for the explicit Lambert-W single diode solution against the iterative Newton, bisection and
+* golden section solvers, over irradiance and cell temperatures a CEC module sees in operation
+*/
+
+class SingleDiodeLambertW : public ::testing::Test
+{
+protected:
+	struct S_oper
+	{
+		double a, Il, Io, Rs, Rsh;
+	};
+
+	std::vector<S_oper> v_oper;
+	double Voc_ref;
+
+	// Operating parameters from the DeSoto relations used by cec6par_module_t
+	void SetUp()
+	{
+		double a_ref = 2.4201, Il_ref = 6.237, Io_ref = 3.98e-12, Rs = 0.499, Rsh_ref = 457.12, alpha_isc = 0.002492;
+		Voc_ref = 67.9;
+		const double KB = 8.618e-5, Tc_ref = 298.15, eg0 = 1.12;
+
+		double G[] = { 20., 100., 300., 600., 1000., 1200. };
+		double Tc[] = { -10., 25., 45., 70. };
+		for (int i = 0; i < 6; i++)
+		{
+			for (int j = 0; j < 4; j++)
+			{
+				double T = Tc[j] + 273.15;
+				double EG = eg0 * (1 - 0.0002677*(T - Tc_ref));
+				S_oper op;
+				op.a = a_ref * T / Tc_ref;
+				op.Il = G[i] / 1000. * (Il_ref + alpha_isc * (T - Tc_ref));
+				op.Io = Io_ref * pow(T / Tc_ref, 3) * exp(1 / KB * (eg0 / Tc_ref - EG / T));
+				op.Rs = Rs;
+				op.Rsh = Rsh_ref * 1000. / G[i];
+				v_oper.push_back(op);
+			}
+		}
+	}
+
+	static double residual(const S_oper &op, double V, double I)
+	{
+		return op.Il - I - op.Io*(exp((V + I * op.Rs) / op.a) - 1.0) - (V + I * op.Rs) / op.Rsh;
+	}
+};
+
+TEST_F(SingleDiodeLambertW, CurrentMatchesNewton_lib_pvmodel)
+{
+	for (size_t k = 0; k < v_oper.size(); k++)
+	{
+		const S_oper &op = v_oper[k];
+		double Voc = openvoltage_5par_lambertw(op.a, op.Il, op.Io, op.Rsh);
+		for (int i = 0; i < 20; i++)
+		{
+			double V = Voc * i / 20.;
+			double I_w = current_5par_lambertw(V, op.a, op.Il, op.Io, op.Rs, op.Rsh);
+			double I_n = current_5par(V, 0.9*op.Il, op.a, op.Il, op.Io, op.Rs, op.Rsh);
+			EXPECT_NEAR(I_w, I_n, 1e-4) << "case " << k << ", V = " << V;
+			EXPECT_NEAR(residual(op, V, I_w), 0.0, 1e-9 * op.Il) << "case " << k << ", V = " << V;
+		}
+	}
+
+	// No series resistance
+	S_oper op = v_oper[16];
+	op.Rs = 0.0;
+	EXPECT_NEAR(current_5par_lambertw(50., op.a, op.Il, op.Io, op.Rs, op.Rsh),
+		current_5par(50., 0.9*op.Il, op.a, op.Il, op.Io, op.Rs, op.Rsh), 1e-4);
+}
+
+TEST_F(SingleDiodeLambertW, OpenVoltageMatchesBisection_lib_pvmodel)
+{
+	for (size_t k = 0; k < v_oper.size(); k++)
+	{
+		const S_oper &op = v_oper[k];
+		double Voc_w = openvoltage_5par_lambertw(op.a, op.Il, op.Io, op.Rsh);
+		double Voc_b = openvoltage_5par(Voc_ref, op.a, op.Il, op.Io, op.Rsh);
+		EXPECT_NEAR(Voc_w, Voc_b, 1e-3) << "case " << k;
+		EXPECT_NEAR(residual(op, Voc_w, 0.0), 0.0, 1e-9 * op.Il) << "case " << k;
+	}
+
+	EXPECT_EQ(openvoltage_5par_lambertw(2.4, 0.0, 1e-11, 500.), 0.0);
+}
+
+TEST_F(SingleDiodeLambertW, MaxPowerMatchesGoldenSection_lib_pvmodel)
+{
+	for (size_t k = 0; k < v_oper.size(); k++)
+	{
+		const S_oper &op = v_oper[k];
+		double V_w, I_w, Voc_w;
+		double P_w = maxpower_5par_lambertw(op.a, op.Il, op.Io, op.Rs, op.Rsh, &V_w, &I_w, &Voc_w);
+
+		double Voc_b = openvoltage_5par(Voc_ref, op.a, op.Il, op.Io, op.Rsh);
+		double V_g, I_g;
+		double P_g = maxpower_5par(Voc_b, op.a, op.Il, op.Io, op.Rs, op.Rsh, &V_g, &I_g);
+
+		EXPECT_NEAR(P_w, P_g, 1e-6 * P_g) << "case " << k;
+		EXPECT_NEAR(V_w, V_g, 2e-3 * V_g) << "case " << k;
+		EXPECT_DOUBLE_EQ(P_w, V_w * I_w) << "case " << k;
+		EXPECT_NEAR(residual(op, V_w, I_w), 0.0, 1e-9 * op.Il) << "case " << k;
+
+		// The golden section search can only come close to the maximum from below
+		EXPECT_GE(P_w, P_g * (1.0 - 1e-12)) << "case " << k;
+	}
+}
+
+TEST_F(SingleDiodeLambertW, BatchMatchesScalar_lib_pvmodel)
+{
+	size_t n = v_oper.size();
+	std::vector<double> a(n), Il(n), Io(n), Rs(n), Rsh(n), Pmp(n), Vmp(n), Imp(n);
+	for (size_t k = 0; k < n; k++)
+	{
+		a[k] = v_oper[k].a;
+		Il[k] = v_oper[k].Il;
+		Io[k] = v_oper[k].Io;
+		Rs[k] = v_oper[k].Rs;
+		Rsh[k] = v_oper[k].Rsh;
+	}
+	maxpower_5par_lambertw(n, &a[0], &Il[0], &Io[0], &Rs[0], &Rsh[0], &Pmp[0], &Vmp[0], &Imp[0]);
+
+	for (size_t k = 0; k < n; k++)
+	{
+		double V, I;
+		EXPECT_EQ(Pmp[k], maxpower_5par_lambertw(a[k], Il[k], Io[k], Rs[k], Rsh[k], &V, &I)) << "case " << k;
+		EXPECT_EQ(Vmp[k], V) << "case " << k;
+		EXPECT_EQ(Imp[k], I) << "case " << k;
+	}
+}
+
+TEST_F(SingleDiodeLambertW, CECModuleMatchesIterativeSolvers_lib_pvmodel)
+{
+	cec6par_module_t mod;
+	mod.Area = 1.631;
+	mod.Vmp = 57.3;
+	mod.Imp = 5.85;
+	mod.Voc = Voc_ref;
+	mod.Isc = 6.23;
+	mod.alpha_isc = 0.002492;
+	mod.beta_voc = -0.16975;
+	mod.a = 2.4201;
+	mod.Il = 6.237;
+	mod.Io = 3.98e-12;
+	mod.Rs = 0.499;
+	mod.Rsh = 457.12;
+	mod.Adj = 5.01;
+
+	double G[] = { 50., 400., 900. };
+	double Tc[] = { 0., 30., 60. };
+	for (int i = 0; i < 3; i++)
+	{
+		for (int j = 0; j < 3; j++)
+		{
+			pvinput_t in(G[i] * 0.8, G[i] * 0.2, 0., 0., G[i], 20., 10., 2., 180., 1013., 30., 20., 100., 30., 180., 12., 0, false);
+
+			for (int k = 0; k < 2; k++)
+			{
+				double opvoltage = (k == 0) ? -1.0 : 50.0;
+				pvoutput_t out_w, out_i;
+				mod.UseLambertW = true;
+				ASSERT_TRUE(mod(in, Tc[j], opvoltage, out_w));
+				mod.UseLambertW = false;
+				ASSERT_TRUE(mod(in, Tc[j], opvoltage, out_i));
+
+				EXPECT_NEAR(out_w.Power, out_i.Power, 1e-6 * out_i.Power + 1e-9) << "G = " << G[i] << ", Tc = " << Tc[j] << ", V = " << opvoltage;
+				EXPECT_NEAR(out_w.Voc_oper, out_i.Voc_oper, 1e-3) << "G = " << G[i] << ", Tc = " << Tc[j];
+				EXPECT_EQ(out_w.Isc_oper, out_i.Isc_oper);
+			}
+		}
+	}
+}
+
+/**
+* Tests for cec6par_module_t::run_batch: with the Lambert-W solution, records are evaluated together, and
+* every output must be bit-identical to the scalar operator(), including voltage sweeps and dark records
+*/
+
+class CECModuleBatch : public ::testing::Test
+{
+protected:
+	cec6par_module_t mod;
+	pvinput_soa input;
+	std::vector<double> Tc, opvoltage;
+
+	void SetUp()
+	{
+		mod.Area = 1.631;
+		mod.Vmp = 57.3;
+		mod.Imp = 5.85;
+		mod.Voc = 67.9;
+		mod.Isc = 6.23;
+		mod.alpha_isc = 0.002492;
+		mod.beta_voc = -0.16975;
+		mod.a = 2.4201;
+		mod.Il = 6.237;
+		mod.Io = 3.98e-12;
+		mod.Rs = 0.499;
+		mod.Rsh = 457.12;
+		mod.Adj = 5.01;
+		mod.UseLambertW = true;
+
+		// A day of maximum power point records, including night and dawn
+		for (int h = 0; h < 24; h++)
+		{
+			double G = (h >= 6 && h <= 18) ? 950.*sin(M_PI*(h - 5.5) / 13.) : 0.;
+			add(pvinput_t(0.7*G, 0.25*G, 0.05*G, 0.02*G, G, 20., 10., 2., 180., 1013., 30. + 3.*fabs(h - 12.), 20. + 2.*fabs(h - 12.), 100., 30., 180., h, 0, false),
+				20. + 0.03*G, -1.0);
+		}
+
+		// A voltage sweep at one condition, as in the subarray mismatch calculation
+		pvinput_t in_sweep(600., 150., 20., 0., 770., 25., 10., 2., 180., 1013., 35., 25., 100., 30., 180., 11., 0, false);
+		for (int i = 0; i < 100; i++)
+			add(in_sweep, 45., 27. + 0.5*i);
+
+		// POA reference cell records
+		add(pvinput_t(500., 100., 20., 0., 650., 25., 10., 2., 180., 1013., 35., 25., 100., 30., 180., 11., 3, true), 40., -1.0);
+		add(pvinput_t(500., 100., 20., 0., 650., 25., 10., 2., 180., 1013., 35., 25., 100., 30., 180., 11., 3, false), 40., 50.0);
+	}
+
+	void add(const pvinput_t &in, double Tcell, double V)
+	{
+		size_t n = input.size();
+		input.resize(n + 1);
+		input.set(n, in);
+		Tc.push_back(Tcell);
+		opvoltage.push_back(V);
+	}
+
+	static bool is_identical(const pvoutput_t &a, const pvoutput_t &b)
+	{
+		double va[] = { a.Power, a.Voltage, a.Current, a.Efficiency, a.Voc_oper, a.Isc_oper, a.CellTemp, a.AOIModifier };
+		double vb[] = { b.Power, b.Voltage, b.Current, b.Efficiency, b.Voc_oper, b.Isc_oper, b.CellTemp, b.AOIModifier };
+		for (int k = 0; k < 8; k++)
+			if (!(va[k] == vb[k]) && !(va[k] != va[k] && vb[k] != vb[k]))
+				return false;
+		return true;
+	}
+};
+
+TEST_F(CECModuleBatch, BatchMatchesScalar_lib_pvmodel)
+{
+	size_t n = input.size();
+	pvoutput_soa output;
+	output.resize(n);
+	for (size_t i = 0; i < n; i++)
+		output.CellTemp[i] = -99.;	// kept where the module is dark
+	ASSERT_TRUE(mod.run_batch(input, &Tc[0], &opvoltage[0], output));
+
+	int n_dark = 0;
+	for (size_t i = 0; i < n; i++)
+	{
+		pvinput_t in;
+		input.get(i, in);
+		pvoutput_t out, out_batch;
+		out.CellTemp = -99.;
+		ASSERT_TRUE(mod(in, Tc[i], opvoltage[i], out));
+		output.get(i, out_batch);
+		EXPECT_TRUE(is_identical(out_batch, out)) << "record " << i << ": P = " << out_batch.Power << " vs " << out.Power;
+		if (out.CellTemp == -99.)
+			n_dark++;
+	}
+	EXPECT_GT(n_dark, 10);
+}
+
+TEST_F(CECModuleBatch, MaxPowerWithoutVoltages_lib_pvmodel)
+{
+	size_t n = input.size();
+	pvoutput_soa output;
+	output.resize(n);
+	ASSERT_TRUE(mod.run_batch(input, &Tc[0], 0, output));
+
+	for (size_t i = 0; i < n; i++)
+	{
+		pvinput_t in;
+		input.get(i, in);
+		pvoutput_t out, out_batch;
+		out.CellTemp = 0.0;
+		ASSERT_TRUE(mod(in, Tc[i], -1.0, out));
+		output.get(i, out_batch);
+		EXPECT_TRUE(is_identical(out_batch, out)) << "record " << i;
+	}
+}
+
+TEST_F(CECModuleBatch, IterativeSolversUseScalarLoop_lib_pvmodel)
+{
+	mod.UseLambertW = false;
+	size_t n = input.size();
+	pvoutput_soa output;
+	output.resize(n);
+	ASSERT_TRUE(mod.run_batch(input, &Tc[0], &opvoltage[0], output));
+
+	for (size_t i = 0; i < n; i += 7)
+	{
+		pvinput_t in;
+		input.get(i, in);
+		pvoutput_t out, out_batch;
+		out.CellTemp = 0.0;
+		ASSERT_TRUE(mod(in, Tc[i], opvoltage[i], out));
+		output.get(i, out_batch);
+		EXPECT_TRUE(is_identical(out_batch, out)) << "record " << i;
+	}
+}
+
+/**
+* Tests for the Sandia, IEC 61853, NOCT and MCSP batch paths: records with the same inputs share their
+* operating conditions or cell temperature, and every output must be bit-identical to the scalar form
+*/
+
+class ModelBatch : public CECModuleBatch
+{
+protected:
+	sandia_module_t snl;
+	iec61853_module_t iec;
+	noct_celltemp_t noct;
+	mcsp_celltemp_t mcsp;
+
+	void SetUp()
+	{
+		CECModuleBatch::SetUp();
+
+		snl.A0 = 0.9404; snl.A1 = 0.05264; snl.A2 = -0.009390; snl.A3 = 0.0007262; snl.A4 = -1.994e-05;
+		snl.B0 = 1; snl.B1 = -0.002438; snl.B2 = 0.0003103; snl.B3 = -1.246e-05; snl.B4 = 2.11e-07; snl.B5 = -1.36e-09;
+		snl.C0 = 1.0039; snl.C1 = -0.0039; snl.C2 = 0.2911; snl.C3 = -4.7355;
+		snl.C4 = 0.9942; snl.C5 = 0.0058; snl.C6 = 1.0723; snl.C7 = -0.0723;
+		snl.Isc0 = 5.75; snl.aIsc = 0.00061;
+		snl.Imp0 = 5.25; snl.aImp = -0.00038;
+		snl.Voc0 = 47.7; snl.BVoc0 = -0.136; snl.mBVoc = 0;
+		snl.Vmp0 = 40; snl.BVmp0 = -0.139; snl.mBVmp = 0;
+		snl.Ix0 = 5.65; snl.Ixx0 = 3.85;
+		snl.fd = 1; snl.DiodeFactor = 1.221; snl.NcellSer = 72;
+		snl.Area = 1.244;
+
+		iec.set_fs267_from_matlab();
+		iec.Vmp0 = 64.6; iec.Imp0 = 1.05; iec.Voc0 = 87; iec.Isc0 = 1.18;
+		iec.NcellSer = 116;
+		iec.Area = 0.72;
+		iec.GlassAR = false;
+		double ama[] = { 0.9417, 0.06516, -0.02022, 0.00219, -9.1e-05 };
+		for (int i = 0; i < 5; i++)
+			iec.AMA[i] = ama[i];
+
+		noct.Tnoct = 46.4;
+		noct.standoff_tnoct_adj = 2;
+		noct.ffv_wind = 0.51;
+
+		mcsp.DcDerate = 0.95;
+		mcsp.MC = 1;
+		mcsp.HTD = 1;
+		mcsp.MSO = 1;
+		mcsp.Nrows = 1;
+		mcsp.Ncols = 10;
+		mcsp.Length = 1.631;
+		mcsp.Width = 1;
+		mcsp.Wgap = 0.05;
+		mcsp.TbackInteg = 20;
+	}
+
+	// Returns the number of records the module left dark
+	int compare_module(pvmodule_t &m, const double *V)
+	{
+		size_t n = input.size();
+		pvoutput_soa output;
+		output.resize(n);
+		for (size_t i = 0; i < n; i++)
+			output.CellTemp[i] = output.AOIModifier[i] = -99.;
+		bool ok = m.run_batch(input, &Tc[0], V, output);
+
+		bool ok_scalar = true;
+		int n_dark = 0;
+		for (size_t i = 0; i < n; i++)
+		{
+			pvinput_t in;
+			input.get(i, in);
+			pvoutput_t out, out_batch;
+			out.CellTemp = out.AOIModifier = -99.;
+			if (!m(in, Tc[i], V ? V[i] : -1.0, out))
+				ok_scalar = false;
+			output.get(i, out_batch);
+			EXPECT_TRUE(is_identical(out_batch, out)) << "record " << i << ": P = " << out_batch.Power << " vs " << out.Power;
+			if (out.Power == 0)
+				n_dark++;
+		}
+		EXPECT_EQ(ok, ok_scalar);
+		return n_dark;
+	}
+
+	// Returns the number of records the model left at their initial cell temperature
+	int compare_celltemp(pvcelltemp_t &tc, const double *V)
+	{
+		size_t n = input.size();
+		std::vector<double> T(n, -99.);
+		bool ok = tc.run_batch(input, mod, V, &T[0]);
+
+		bool ok_scalar = true;
+		int n_unset = 0;
+		for (size_t i = 0; i < n; i++)
+		{
+			pvinput_t in;
+			input.get(i, in);
+			double T_scalar = -99.;
+			if (!tc(in, mod, V ? V[i] : -1.0, T_scalar))
+				ok_scalar = false;
+			EXPECT_EQ(T[i], T_scalar) << "record " << i;
+			if (T_scalar == -99.)
+				n_unset++;
+		}
+		EXPECT_EQ(ok, ok_scalar);
+		return n_unset;
+	}
+};
+
+TEST_F(ModelBatch, SandiaMatchesScalar_lib_pvmodel)
+{
+	EXPECT_GT(compare_module(snl, &opvoltage[0]), 10);
+	EXPECT_GT(compare_module(snl, 0), 10);
+}
+
+TEST_F(ModelBatch, IEC61853MatchesScalar_lib_pvmodel)
+{
+	for (int k = 0; k < 2; k++)
+	{
+		iec.UseLambertW = (k == 0);
+		EXPECT_GT(compare_module(iec, &opvoltage[0]), 10);
+		EXPECT_GT(compare_module(iec, 0), 10);
+	}
+}
+
+TEST_F(ModelBatch, NOCTMatchesScalar_lib_pvmodel)
+{
+	EXPECT_GT(compare_celltemp(noct, &opvoltage[0]), 10);
+	EXPECT_GT(compare_celltemp(noct, 0), 10);
+}
+
+TEST_F(ModelBatch, MCSPMatchesScalar_lib_pvmodel)
+{
+	for (int mc = 1; mc <= 4; mc++)
+	{
+		mcsp.MC = mc;
+		compare_celltemp(mcsp, &opvoltage[0]);
+		compare_celltemp(mcsp, 0);
+	}
+}
@@ -0,0 +1,129 @@
+#include <cmath>
+
+#include <gtest/gtest.h>
+
+#include "../shared/lib_pvshade.h"
+
+/**
+* Tests for the precomputed self-shading tables: table evaluations must match ss_exec for fixed tilt
+* arrays and one-axis trackers with either mask angle method, and conditions outside the table must
+* give exactly the ss_exec results
+*/
+
+class SelfShadeTableTest : public ::testing::Test
+{
+protected:
+	ssinputs inputs;
+	double tolerance;
+
+	void SetUp()
+	{
+		// 10 rows of 2 x 10 modules in landscape, gcr 0.4
+		inputs.nrows = 10;
+		inputs.nmodx = 10;
+		inputs.nmody = 2;
+		inputs.nstrx = 1;
+		inputs.length = 1.6;
+		inputs.width = 1.0;
+		inputs.mod_orient = 0;
+		inputs.str_orient = 1;
+		inputs.row_space = inputs.nmody * inputs.length / 0.4;
+		inputs.ndiode = 3;
+		inputs.Vmp = 30;
+		inputs.FF0 = 0.75;
+		tolerance = 0.001;
+	}
+
+	// Compare table and direct results over the sky, up to 85 degrees zenith. Shadows near the horizon
+	// change too quickly for the table resolution.
+	void compare(bool trackmode, bool linear)
+	{
+		ss_table table;
+		table.setup(inputs, 25, trackmode);
+		ASSERT_TRUE(table.is_setup());
+		table.enable_check(true);
+
+		int nshaded = 0;
+		for( double solzen = 0.3; solzen < 85; solzen += 0.41 )
+		{
+			for( double solazi = 0; solazi < 360; solazi += 1.3 )
+			{
+				// Trackers follow the sun from east to west, their shading fraction is calculated by the caller
+				double tilt = trackmode ? fmin(60, 0.8*solzen) : 25;
+				double azimuth = trackmode ? (solazi < 180 ? 90 : 270) : 180;
+				double shade_frac_1x = trackmode ? solzen / 90 : 0;
+
+				ssoutputs tab = ssoutputs(), direct = ssoutputs();
+				bool ok_tab = table.exec(inputs, tilt, azimuth, solzen, solazi, 800, 500, 150, 0.2, linear, shade_frac_1x, tab);
+				bool ok_direct = ss_exec(inputs, tilt, azimuth, solzen, solazi, 800, 500, 150, 0.2, trackmode, linear, shade_frac_1x, direct);
+				ASSERT_EQ(ok_tab, ok_direct) << "zenith " << solzen << " azimuth " << solazi;
+				if( direct.m_dc_derate < 1 || direct.m_shade_frac_fixed > 0 )
+					nshaded++;
+
+				if( linear )
+					EXPECT_NEAR(tab.m_shade_frac_fixed, direct.m_shade_frac_fixed, tolerance) << "zenith " << solzen << " azimuth " << solazi;
+				else
+				{
+					EXPECT_NEAR(tab.m_dc_derate, direct.m_dc_derate, tolerance) << "zenith " << solzen << " azimuth " << solazi;
+					EXPECT_NEAR(tab.m_diffuse_derate, direct.m_diffuse_derate, tolerance) << "zenith " << solzen << " azimuth " << solazi;
+					EXPECT_NEAR(tab.m_reflected_derate, direct.m_reflected_derate, tolerance) << "zenith " << solzen << " azimuth " << solazi;
+				}
+			}
+		}
+		EXPECT_GT(nshaded, 50);
+
+		// The built in check compared the evaluations that used the table
+		EXPECT_GT(table.check().count, 1000u);
+		EXPECT_EQ(table.check().nexceed, 0u);
+	}
+};
+
+TEST_F(SelfShadeTableTest, FixedTiltMatchesDirect_lib_pvshade)
+{
+	for( int method = 0; method < 2; method++ )
+	{
+		inputs.mask_angle_calc_method = method;
+		compare(false, false);
+		compare(false, true);
+	}
+}
+
+TEST_F(SelfShadeTableTest, TrackerMatchesDirect_lib_pvshade)
+{
+	for( int method = 0; method < 2; method++ )
+	{
+		inputs.mask_angle_calc_method = method;
+		compare(true, false);
+		compare(true, true);
+	}
+}
+
+TEST_F(SelfShadeTableTest, OutsideTableUsesDirect_lib_pvshade)
+{
+	ss_table table;
+	table.setup(inputs, 25, false);
+	ASSERT_TRUE(table.is_setup());
+
+	// A different tilt than the table uses ss_exec, and a sun near the horizon gives the same results
+	double tilt[] = { 30, 25 };
+	double solzen[] = { 60, 89.8 };
+	for( int k = 0; k < 2; k++ )
+	{
+		ssoutputs tab = ssoutputs(), direct = ssoutputs();
+		bool ok_tab = table.exec(inputs, tilt[k], 180, solzen[k], 150, 800, 500, 150, 0.2, false, 0, tab);
+		bool ok_direct = ss_exec(inputs, tilt[k], 180, solzen[k], 150, 800, 500, 150, 0.2, false, false, 0, direct);
+		EXPECT_EQ(ok_tab, ok_direct) << "case " << k;
+		EXPECT_EQ(tab.m_dc_derate, direct.m_dc_derate) << "case " << k;
+		EXPECT_EQ(tab.m_diffuse_derate, direct.m_diffuse_derate) << "case " << k;
+		EXPECT_EQ(tab.m_reflected_derate, direct.m_reflected_derate) << "case " << k;
+	}
+
+	// Tables that weren't set up always calculate directly
+	ss_table empty;
+	EXPECT_FALSE(empty.is_setup());
+	ssoutputs tab = ssoutputs(), direct = ssoutputs();
+	empty.exec(inputs, 25, 180, 60, 150, 800, 500, 150, 0.2, false, 0, tab);
+	ss_exec(inputs, 25, 180, 60, 150, 800, 500, 150, 0.2, false, false, 0, direct);
+	EXPECT_EQ(tab.m_dc_derate, direct.m_dc_derate);
+	EXPECT_EQ(tab.m_diffuse_derate, direct.m_diffuse_derate);
+}
@@ -185,3 +185,88 @@ TEST_F(sharedInverterTest, tempDerateTest_lib_shared_inverter) {
 	EXPECT_NEAR(pAC, 60, e) << "case 9";
 
 }
+
+TEST_F(sharedInverterTest, efficiencyTableTest_lib_shared_inverter) {
+	sinv.Paco = 3800.;
+	sinv.Pdco = 3928.11;
+	sinv.Vdco = 398.5;
+	sinv.Pso = 19.45;
+	sinv.Pntare = 0.99;
+	sinv.C0 = -3.18e-6;
+	sinv.C1 = -5.12e-5;
+	sinv.C2 = 9.84e-4;
+	sinv.C3 = -1.51e-3;
+	std::vector<std::vector<double>> curves = { { 400., 30., -0.02 } };
+	inv->setTempDerateCurves(curves);
+
+	std::vector<double> P, V, T;
+	for (size_t i = 0; i < 100; i++) {
+		P.push_back(-50. + 80. * i);
+		V.push_back(250. + 2.3 * i);
+		T.push_back(-10. + 0.55 * i);
+	}
+	SharedInverterOutputs model, table;
+	inv->calculateACPower(P, V, T, model);
+	EXPECT_FALSE(inv->isEfficiencyTableSetup());
+
+	EXPECT_TRUE(inv->setupEfficiencyTable(250., 480.)) << "set up efficiency table";
+	EXPECT_TRUE(inv->isEfficiencyTableSetup());
+	EXPECT_LT(inv->checkEfficiencyTable(), 0.001) << "table check";
+
+	inv->calculateACPower(P, V, T, table);
+	ASSERT_EQ(table.powerAC_kW.size(), P.size());
+	for (size_t i = 0; i < P.size(); i++) {
+		EXPECT_NEAR(table.powerAC_kW[i], model.powerAC_kW[i], 1e-5) << "step " << i;
+		EXPECT_NEAR(table.efficiencyAC[i], model.efficiencyAC[i], 1e-3) << "step " << i;
+		EXPECT_NEAR(table.powerClipLoss_kW[i], model.powerClipLoss_kW[i], 1e-5) << "step " << i;
+		EXPECT_NEAR(table.powerTempLoss_kW[i], model.powerTempLoss_kW[i], 1e-5) << "step " << i;
+	}
+}
+
+TEST_F(sharedInverterTest, partloadEfficiencyTableTest_lib_shared_inverter) {
+	plinv.Paco = 3800.;
+	plinv.Pdco = 3950.;
+	plinv.Vdco = 400.;
+	plinv.Pntare = 0.99;
+	std::vector<std::vector<double>> curves = { { 400., 30., -0.02 } };
+
+	std::vector<double> P, V, T;
+	for (size_t i = 0; i < 200; i++) {
+		P.push_back(-50. + 43.7 * i);
+		V.push_back(250. + 1.1 * i);
+		T.push_back(-10. + 0.27 * i);
+	}
+
+	// Curve points evenly spaced from zero, as SAM generates them, and unevenly spaced points
+	std::vector<std::vector<double>> partloads = {
+		{ 0., 5., 10., 15., 20., 25., 30., 35., 40., 45., 50., 55., 60., 65., 70., 75., 80., 85., 90., 95., 100. },
+		{ 0., 3., 10., 20., 35., 50., 75., 100. } };
+	std::vector<std::vector<double>> efficiencies = {
+		{ 0., 88.1, 93.2, 95.0, 95.8, 96.2, 96.5, 96.7, 96.8, 96.9, 96.9, 96.9, 96.8, 96.8, 96.7, 96.6, 96.5, 96.4, 96.3, 96.2, 96.1 },
+		{ 0., 84.5, 93.2, 95.8, 96.6, 96.9, 96.6, 96.1 } };
+	double tolerance[] = { 1e-9, 0.05 };
+
+	for (size_t c = 0; c < partloads.size(); c++) {
+		plinv.Partload = partloads[c];
+		plinv.Efficiency = efficiencies[c];
+		SharedInverter plInv(SharedInverter::PARTLOAD_INVERTER, 1, &sinv, &plinv);
+		plInv.setTempDerateCurves(curves);
+
+		SharedInverterOutputs model, table;
+		plInv.calculateACPower(P, V, T, model);
+
+		EXPECT_TRUE(plInv.setupEfficiencyTable(250., 480.)) << "set up efficiency table, curve " << c;
+		EXPECT_TRUE(plInv.isEfficiencyTableSetup());
+		EXPECT_LT(plInv.checkEfficiencyTable(), (c == 0) ? 1e-9 : 0.5) << "table check, curve " << c;
+
+		plInv.calculateACPower(P, V, T, table);
+		ASSERT_EQ(table.powerAC_kW.size(), P.size());
+		for (size_t i = 0; i < P.size(); i++) {
+			EXPECT_NEAR(table.powerAC_kW[i], model.powerAC_kW[i], tolerance[c] * 4) << "curve " << c << " step " << i;
+			EXPECT_NEAR(table.efficiencyAC[i], model.efficiencyAC[i], tolerance[c]) << "curve " << c << " step " << i;
+			EXPECT_NEAR(table.powerClipLoss_kW[i], model.powerClipLoss_kW[i], tolerance[c] * 4) << "curve " << c << " step " << i;
+			EXPECT_NEAR(table.powerNightLoss_kW[i], model.powerNightLoss_kW[i], 1e-12) << "curve " << c << " step " << i;
+			EXPECT_NEAR(table.powerTempLoss_kW[i], model.powerTempLoss_kW[i], tolerance[c] * 4) << "curve " << c << " step " << i;
+		}
+	}
+}
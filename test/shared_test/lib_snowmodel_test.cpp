@@ -0,0 +1,112 @@
+#include <vector>
+#include <cmath>
+#include <limits>
+
+#include <gtest/gtest.h>
+
+#include "../shared/lib_snowmodel.h"
+
+/**
+* Tests for the snow event index: a snow model that only runs getLoss on indexed snow events and
+* getLossSnowFree elsewhere must give the same losses, coverage and errors as one that runs getLoss
+* on every time step
+*/
+
+class SnowEventIndexTest : public ::testing::Test
+{
+protected:
+	std::vector<float> depth, poa, tilt, tdry;
+	std::vector<int> sunup;
+
+	void SetUp()
+	{
+		// A year of hourly data with storms every ten days in winter, each building up snow that melts over a few days
+		for( int i = 0; i < 8760; i++ )
+		{
+			int day = i / 24, hour = i % 24;
+			bool winter = day < 80 || day > 320;
+			int storm_day = day % 10;
+			float d = 0;
+			if( winter && storm_day < 4 )
+				d = (storm_day == 0) ? 0.5f * hour : 12.f - 3.f * storm_day - 0.1f * hour;
+			depth.push_back(d > 0 ? d : 0);
+
+			bool up = hour >= 7 && hour <= 17;
+			sunup.push_back(up ? 1 : 0);
+			poa.push_back(up ? 600.f * (float)sin(3.14159 * (hour - 6.5) / 11.) : 0.f);
+			tilt.push_back(20.f + (float)(hour % 5));
+			tdry.push_back(winter ? -8.f + 0.8f * hour : 15.f + 0.5f * hour);
+		}
+	}
+
+	// Runs two models over nyears of data, one on every step and one with the event index, and
+	// compares every step. Returns the number of steps that were run before either model failed.
+	size_t compare(int nyears)
+	{
+		pvsnowmodel all, indexed;
+		all.setup(2, 25);
+		indexed.setup(2, 25);
+		size_t nevents = indexed.setupSnowEvents(depth);
+		EXPECT_GT(nevents, 100u);
+		EXPECT_LT(nevents, depth.size() / 2);
+
+		size_t nrec = depth.size();
+		for( size_t idx = 0; idx < nyears*nrec; idx++ )
+		{
+			size_t i = idx % nrec;
+			float loss_all = -1, loss_indexed = -1;
+			bool ok_all = all.getLoss(poa[i], tilt[i], 1.0f, tdry[i], depth[i], sunup[i], 1.0f, &loss_all);
+			bool ok_indexed = indexed.isSnowEvent(idx) ?
+				indexed.getLoss(poa[i], tilt[i], 1.0f, tdry[i], depth[i], sunup[i], 1.0f, &loss_indexed)
+				: indexed.getLossSnowFree(depth[i], &loss_indexed);
+
+			EXPECT_EQ(ok_indexed, ok_all) << "step " << idx;
+			EXPECT_EQ(indexed.good, all.good) << "step " << idx;
+			EXPECT_EQ(indexed.badValues, all.badValues) << "step " << idx;
+			EXPECT_EQ(indexed.msg, all.msg) << "step " << idx;
+			if( !all.good )
+				return idx;
+
+			EXPECT_EQ(loss_indexed, loss_all) << "step " << idx;
+			EXPECT_EQ(indexed.coverage, all.coverage) << "step " << idx;
+			EXPECT_EQ(indexed.previousDepth, all.previousDepth) << "step " << idx;
+		}
+		return nyears*nrec;
+	}
+};
+
+TEST_F(SnowEventIndexTest, IndexedMatchesEveryStep_lib_snowmodel)
+{
+	EXPECT_EQ(compare(1), depth.size());
+
+	// Some steps have losses
+	pvsnowmodel model;
+	model.setup(2, 25);
+	float loss, total = 0;
+	for( size_t i = 0; i < depth.size(); i++ )
+	{
+		model.getLoss(poa[i], tilt[i], 1.0f, tdry[i], depth[i], sunup[i], 1.0f, &loss);
+		total += loss;
+	}
+	EXPECT_GT(total, 10.f);
+}
+
+TEST_F(SnowEventIndexTest, IndexWrapsOverYears_lib_snowmodel)
+{
+	EXPECT_EQ(compare(3), 3 * depth.size());
+}
+
+TEST_F(SnowEventIndexTest, InvalidDepthsMatchEveryStep_lib_snowmodel)
+{
+	// Invalid values inside and outside of snow events are counted the same way
+	for( size_t i = 100; i < depth.size(); i += 97 )
+		depth[i] = (i % 3 == 0) ? -999.f : (i % 3 == 1) ? 700.f : std::numeric_limits<float>::quiet_NaN();
+	EXPECT_EQ(compare(1), depth.size());
+}
+
+TEST_F(SnowEventIndexTest, TooManyInvalidDepthsFailAtSameStep_lib_snowmodel)
+{
+	for( size_t i = 1000; i < 1600; i++ )
+		depth[i] = -999.f;
+	EXPECT_EQ(compare(1), 1499u);
+}
@@ -0,0 +1,740 @@
+#include <string>
+#include <vector>
+#include <cstdio>
+#include <cmath>
+#include <thread>
+#include <algorithm>
+
+#include <gtest/gtest.h>
+
+#include "../solarpilot/AutoPilot_API.h"
+#include "../solarpilot/SolarField.h"
+#include "../solarpilot/Flux.h"
+#include "../solarpilot/LayoutSimulateThread.h"
+
+/**
+* Tests for the field simulation: the packed heliostat arrays and the k-d tree shadowing and blocking
+* candidates must give the same efficiencies as the Heliostat objects and full neighbor lists, and the
+* results must not depend on the number of simulation threads or on how the AutoPilot_MT simulation
+* queue divides the sun positions between field copies. Flux maps evaluated in heliostat blocks must
+* match the point by point Hermite series evaluation. The heliostat result cache used by incremental
+* field simulations may only reuse results when the heliostat and every neighbor that can shadow or
+* block it are exactly unchanged, and a simulation that reuses results must match one that doesn't.
+* Returning to an earlier tower height reuses its records and heliostat flux contributions, and copies
+* of the field share the stored results.
+*/
+
+// Small field at Daggett with a clear sky year that has the same profile every day
+static void small_field_inputs(var_map &V, std::vector<std::string> &wf)
+{
+	V.amb.latitude.val = 34.87;
+	V.amb.longitude.val = -116.78;
+	V.amb.time_zone.val = -8;
+	V.sf.q_des.val = 50.;		//[MWt]
+	V.sf.temp_which.combo_clear();
+	std::string name = "Template 1", val = "0";
+	V.sf.temp_which.combo_add_choice(name, val);
+	V.sf.temp_which.combo_select_by_choice_index(0);
+
+	wf.clear();
+	char buf[200];
+	int dim[] = { 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+	for( int m = 1; m <= 12; m++ )
+		for( int d = 1; d <= dim[m - 1]; d++ )
+			for( int h = 0; h < 24; h++ )
+			{
+				double dni = (h >= 6 && h <= 18) ? 950.*sin(3.14159*(h - 5.5) / 13.) : 0.;
+				sprintf(buf, "%d,%d,%d,%.2lf,%.1lf,%.1lf,%.1lf", d, h, m, dni, 25., 1.0, 3.);
+				wf.push_back(buf);
+			}
+}
+
+class SolarFieldTest : public ::testing::Test
+{
+protected:
+	var_map V;
+	AutoPilot_S api;
+	SolarField *SF;		//deleted by 'api'
+	double azimuth, zenith;		//[rad]
+
+	struct helio_results
+	{
+		std::vector<double> eta_cos, eta_int, eta_shadow, eta_block;
+	};
+
+	void SetUp()
+	{
+		std::vector<std::string> wf;
+		small_field_inputs(V, wf);
+
+		SF = new SolarField();
+		api.SetExternalSFObject(SF);
+		api.GenerateDesignPointSimulations(V, wf);
+		api.Setup(V);
+		sp_layout layout;
+		api.CreateLayout(layout);
+
+		azimuth = 200. * D2R;
+		zenith = 50. * D2R;
+	}
+
+	void simulate(helio_results &res)
+	{
+		sim_params P;
+		P.dni = 900.;
+		P.is_layout = false;
+		SF->Simulate(azimuth, zenith, P);
+		collect(res);
+	}
+
+	void collect(helio_results &res, SolarField *field = 0)
+	{
+		Hvector *helios = (field == 0 ? SF : field)->getHeliostats();
+		res.eta_cos.clear();
+		res.eta_int.clear();
+		res.eta_shadow.clear();
+		res.eta_block.clear();
+		for( size_t i = 0; i < helios->size(); i++ )
+		{
+			res.eta_cos.push_back(helios->at(i)->getEfficiencyCosine());
+			res.eta_int.push_back(helios->at(i)->getEfficiencyIntercept());
+			res.eta_shadow.push_back(helios->at(i)->getEfficiencyShading());
+			res.eta_block.push_back(helios->at(i)->getEfficiencyBlock());
+		}
+	}
+
+	static void expect_identical(const helio_results &a, const helio_results &b)
+	{
+		ASSERT_EQ(a.eta_int.size(), b.eta_int.size());
+		for( size_t i = 0; i < a.eta_int.size(); i++ )
+		{
+			EXPECT_EQ(a.eta_cos[i], b.eta_cos[i]) << "heliostat " << i;
+			EXPECT_EQ(a.eta_int[i], b.eta_int[i]) << "heliostat " << i;
+			EXPECT_EQ(a.eta_shadow[i], b.eta_shadow[i]) << "heliostat " << i;
+			EXPECT_EQ(a.eta_block[i], b.eta_block[i]) << "heliostat " << i;
+		}
+	}
+};
+
+TEST_F(SolarFieldTest, UnchangedFieldReusesResults_SolarField)
+{
+	int n = (int)SF->getHeliostats()->size();
+	ASSERT_GT(n, 100);
+
+	helio_results res_ref, res_first, res_cached;
+	simulate(res_ref);
+
+	SF->setIncrementalSimulation(true);
+	simulate(res_first);
+	int n_int = -1, n_sb = -1;
+	SF->getSimulationCacheUse(n_int, n_sb);
+	EXPECT_EQ(n_int, 0);
+	EXPECT_EQ(n_sb, 0);
+
+	simulate(res_cached);
+	SF->getSimulationCacheUse(n_int, n_sb);
+	EXPECT_GT(n_int, n * 9 / 10);
+	EXPECT_GT(n_sb, n * 9 / 10);
+
+	expect_identical(res_first, res_ref);
+	expect_identical(res_cached, res_ref);
+}
+
+TEST_F(SolarFieldTest, MovedHeliostatInvalidatesNeighbors_SolarField)
+{
+	SF->setIncrementalSimulation(true);
+	helio_results res;
+	simulate(res);
+	simulate(res);
+	int n_int_all = -1, n_sb_all = -1;
+	SF->getSimulationCacheUse(n_int_all, n_sb_all);
+
+	// Move a heliostat in the middle of the field by a few centimeters
+	Hvector *helios = SF->getHeliostats();
+	Heliostat *H = helios->at(helios->size() / 2);
+	sp_point loc = *H->getLocation();
+	H->setLocation(loc.x + 0.05, loc.y, loc.z);
+
+	helio_results res_cached;
+	simulate(res_cached);
+	int n_int = -1, n_sb = -1;
+	SF->getSimulationCacheUse(n_int, n_sb);
+
+	// Only the moved heliostat's intercept is recalculated. Its neighbors recalculate shadowing and blocking.
+	EXPECT_EQ(n_int, n_int_all - 1);
+	EXPECT_LT(n_sb, n_sb_all - 1);
+	EXPECT_GT(n_sb, n_sb_all / 2);
+
+	// Same results as a simulation without stored results
+	SF->setIncrementalSimulation(false);
+	helio_results res_ref;
+	simulate(res_ref);
+	expect_identical(res_cached, res_ref);
+}
+
+TEST_F(SolarFieldTest, TowerHeightChangeInvalidatesAll_SolarField)
+{
+	SF->setIncrementalSimulation(true);
+	helio_results res;
+	simulate(res);
+
+	// Every intercept depends on the tower height through the receiver signature, and shadowing and
+	// blocking depend on it through the aim points
+	SF->getVarMap()->sf.tht.val += 1.;
+	SF->updateAllCalculatedParameters(*SF->getVarMap());
+	helio_results res_cached;
+	simulate(res_cached);
+	int n_int = -1, n_sb = -1;
+	SF->getSimulationCacheUse(n_int, n_sb);
+	EXPECT_EQ(n_int, 0);
+	EXPECT_EQ(n_sb, 0);
+
+	SF->setIncrementalSimulation(false);
+	helio_results res_ref;
+	simulate(res_ref);
+	expect_identical(res_cached, res_ref);
+}
+
+TEST_F(SolarFieldTest, TowerHeightSweepReusesRecords_SolarField)
+{
+	// An optimizer stepping the tower height back and forth on a fixed layout
+	SF->getReceivers()->at(0)->DefineReceiverGeometry(12, 10);
+	var_map *vm = SF->getVarMap();
+	double tht0 = vm->sf.tht.val;
+	double dtht[] = { 0., 10., -10. };
+	int sweep[] = { 0, 1, 0, 1, 2, 0 };
+	int n = (int)SF->getHeliostats()->size();
+
+	auto simulate_flux = [&](int k, helio_results &res, std::vector<double> &flux) {
+		vm->sf.tht.val = tht0 + dtht[k];
+		SF->updateAllCalculatedParameters(*vm);
+		simulate(res);
+		SF->HermiteFluxSimulation(*SF->getHeliostats());
+		FluxGrid *grid = SF->getReceivers()->at(0)->getFluxSurfaces()->at(0).getFluxMap();
+		flux.clear();
+		for( size_t j = 0; j < grid->size(); j++ )
+			for( size_t i = 0; i < grid->at(j).size(); i++ )
+				flux.push_back(grid->at(j).at(i).flux);
+	};
+
+	helio_results res_ref[3];
+	std::vector<double> flux_ref[3];
+	for( int k = 0; k < 3; k++ )
+		simulate_flux(k, res_ref[k], flux_ref[k]);
+
+	SF->setIncrementalSimulation(true);
+	bool visited[] = { false, false, false };
+	for( int s = 0; s < 6; s++ )
+	{
+		SCOPED_TRACE(s);
+		int k = sweep[s];
+		helio_results res;
+		std::vector<double> flux;
+		simulate_flux(k, res, flux);
+
+		// Tower heights evaluated before reuse every record, including the flux of each heliostat. The image 
+		// size priority aim point method evaluates some heliostats more than once during the first visit.
+		int n_int = -1, n_sb = -1;
+		SF->getSimulationCacheUse(n_int, n_sb);
+		EXPECT_EQ(n_int, visited[k] ? n : 0);
+		EXPECT_EQ(n_sb, visited[k] ? n : 0);
+		if( visited[k] )
+			EXPECT_GE(SF->getFluxCacheUse(), n);
+		else
+			EXPECT_LT(SF->getFluxCacheUse(), n);
+		visited[k] = true;
+
+		expect_identical(res, res_ref[k]);
+		EXPECT_EQ(flux, flux_ref[k]);
+	}
+}
+
+TEST_F(SolarFieldTest, FieldCopiesShareResults_SolarField)
+{
+	// Copies of the field simulate sun positions on separate threads, as AutoPilot_MT does. Two copies
+	// simulate the same sun position at the same time.
+	double sunpos[][2] = { {200., 50.}, {120., 70.}, {240., 30.}, {200., 50.} };
+	helio_results res_ref[3];
+	for( int i = 0; i < 3; i++ )
+	{
+		azimuth = sunpos[i][0] * D2R;
+		zenith = sunpos[i][1] * D2R;
+		simulate(res_ref[i]);
+	}
+
+	SF->setIncrementalSimulation(true);
+	std::vector<SolarField*> copies;
+	std::vector<std::thread> threads;
+	for( int i = 0; i < 4; i++ )
+	{
+		copies.push_back(new SolarField(*SF));
+		copies.back()->setSimulationThreadCount(1);
+	}
+	for( int i = 0; i < 4; i++ )
+		threads.push_back(std::thread([&, i]() {
+			sim_params P;
+			P.dni = 900.;
+			P.is_layout = false;
+			copies[i]->Simulate(sunpos[i][0] * D2R, sunpos[i][1] * D2R, P);
+		}));
+	for( int i = 0; i < 4; i++ )
+		threads[i].join();
+
+	std::vector<helio_results> res_copy(4);
+	for( int i = 0; i < 4; i++ )
+	{
+		collect(res_copy[i], copies[i]);
+		delete copies[i];
+	}
+	expect_identical(res_copy[3], res_copy[0]);
+
+	// The original field reuses the results of its copies
+	int n = (int)SF->getHeliostats()->size();
+	for( int i = 0; i < 3; i++ )
+	{
+		SCOPED_TRACE(i);
+		azimuth = sunpos[i][0] * D2R;
+		zenith = sunpos[i][1] * D2R;
+		helio_results res_cached;
+		simulate(res_cached);
+		int n_int = -1, n_sb = -1;
+		SF->getSimulationCacheUse(n_int, n_sb);
+		EXPECT_EQ(n_int, n);
+		EXPECT_EQ(n_sb, n);
+
+		expect_identical(res_copy[i], res_ref[i]);
+		expect_identical(res_cached, res_ref[i]);
+	}
+}
+
+TEST_F(SolarFieldTest, PackedArraysMatchHeliostatObjects_SolarField)
+{
+	helio_results res_sim, res_objects, res_packed;
+	simulate(res_sim);
+
+	// Simulate() releases the packed arrays, so evaluating each heliostat afterwards uses the Heliostat objects
+	sim_params P;
+	P.dni = 900.;
+	P.is_layout = false;
+	Vect Sun = Ambient::calcSunVectorFromAzZen(azimuth, zenith);
+	Hvector *helios = SF->getHeliostats();
+	ASSERT_FALSE(SF->getHeliostatArrays()->is_packed);
+	for( size_t i = 0; i < helios->size(); i++ )
+		SolarField::SimulateHeliostatEfficiency(SF, Sun, helios->at(i), P);
+	collect(res_objects);
+
+	// The packed arrays with every neighbor in the list. The cosine loss is filled in the same way as Simulate().
+	SF->PackHeliostatArrays();
+	helio_arrays *A = SF->getHeliostatArrays();
+	ASSERT_TRUE(A->is_packed);
+	for( int i = 0; i < A->n; i++ )
+		A->eta_cos[i] = Sun.i*A->ti[i] + Sun.j*A->tj[i] + Sun.k*A->tk[i];
+	for( size_t i = 0; i < helios->size(); i++ )
+		SolarField::SimulateHeliostatEfficiency(SF, Sun, helios->at(i), P);
+	collect(res_packed);
+
+	expect_identical(res_objects, res_sim);
+	expect_identical(res_packed, res_sim);
+
+	// Every pair of neighbors gives the same interference either way
+	std::vector<Heliostat> *objects = SF->getHeliostatObjects();
+	int ninterfere = 0;
+	for( size_t h = 0; h < objects->size(); h++ )
+	{
+		Heliostat *H = &objects->at(h);
+		Hvector *neibs = H->getNeighborList();
+		for( size_t j = 0; j < neibs->size(); j++ )
+		{
+			int hi = (int)(neibs->at(j) - &objects->front());
+			if( hi == (int)h ) continue;
+			for( int mode = 0; mode < 2; mode++ )
+			{
+				double f_obj = SF->calcShadowBlock(H, neibs->at(j), mode, Sun, V.sf.interaction_limit.val);
+				double f_packed = SF->calcShadowBlockPacked((int)h, hi, mode, Sun, V.sf.interaction_limit.val);
+				EXPECT_EQ(f_packed, f_obj) << "heliostat " << h << " neighbor " << hi << " mode " << mode;
+				if( f_obj > 0. )
+					ninterfere++;
+			}
+		}
+	}
+	EXPECT_GT(ninterfere, 100);
+}
+
+TEST_F(SolarFieldTest, ThreadCountDoesNotChangeResults_SolarField)
+{
+	SF->setSimulationThreadCount(1);
+	helio_results res_ref;
+	simulate(res_ref);
+
+	int nthreads[] = { 2, 3, 8, 0 };
+	for( int t = 0; t < 4; t++ )
+	{
+		SF->setSimulationThreadCount(nthreads[t]);
+		helio_results res;
+		simulate(res);
+		SCOPED_TRACE(nthreads[t]);
+		expect_identical(res, res_ref);
+	}
+}
+
+TEST_F(SolarFieldTest, CandidatesMatchAllNeighbors_SolarField)
+{
+	// Nearby sun positions reuse the cached lists, the others rebuild them
+	double sunpos[][2] = { {200., 50.}, {200.4, 50.3}, {199.5, 49.6}, {120., 70.}, {240., 30.}, {180., 80.}, {90., 85.}, {200., 50.} };
+	sim_params P;
+	P.dni = 900.;
+	P.is_layout = false;
+	Hvector *helios = SF->getHeliostats();
+	helio_arrays *A = SF->getHeliostatArrays();
+
+	for( int s = 0; s < 8; s++ )
+	{
+		SCOPED_TRACE(s);
+		azimuth = sunpos[s][0] * D2R;
+		zenith = sunpos[s][1] * D2R;
+		Vect Sun = Ambient::calcSunVectorFromAzZen(azimuth, zenith);
+
+		helio_results res_cand, res_all;
+		simulate(res_cand);
+
+		// Every neighbor that interferes must be a candidate
+		SF->PackHeliostatArrays();
+		for( int i = 0; i < A->n; i++ )
+			A->eta_cos[i] = Sun.i*A->ti[i] + Sun.j*A->tj[i] + Sun.k*A->tk[i];
+		SF->UpdateInteractionCandidates(Sun, true);
+		size_t npairs = 0, ncand = 0;
+		int ninterfere = 0;
+		std::vector<int> cands;
+		for( int h = 0; h < A->n; h++ )
+		{
+			if( !A->is_enabled[h] ) continue;
+			int g = A->group[h];
+			for( int mode = 0; mode < 2; mode++ )
+			{
+				SF->getInteractionCandidates(h, mode, cands);
+				ncand += cands.size();
+				for( int j = A->nb_start[g]; j < A->nb_start[g + 1]; j++ )
+				{
+					int hi = A->nb_index[j];
+					if( hi == h ) continue;
+					npairs++;
+					if( SF->calcShadowBlockPacked(h, hi, mode, Sun, V.sf.interaction_limit.val) == 0. ) continue;
+					ninterfere++;
+					EXPECT_NE(std::find(cands.begin(), cands.end(), hi), cands.end()) << "heliostat " << h << " neighbor " << hi << " mode " << mode;
+				}
+			}
+		}
+		EXPECT_GT(ninterfere, 0);
+		EXPECT_LT(ncand, npairs / 4);
+
+		// The full neighbor lists give the same efficiencies
+		SF->PackHeliostatArrays();
+		for( int i = 0; i < A->n; i++ )
+			A->eta_cos[i] = Sun.i*A->ti[i] + Sun.j*A->tj[i] + Sun.k*A->tk[i];
+		for( size_t i = 0; i < helios->size(); i++ )
+			SolarField::SimulateHeliostatEfficiency(SF, Sun, helios->at(i), P);
+		collect(res_all);
+		expect_identical(res_cand, res_all);
+	}
+}
+
+TEST(HelioKdTreeTest, QueryBoxMatchesAllPoints_SolarField)
+{
+	// Scattered points plus a grid with repeated coordinates
+	std::vector<double> x, y;
+	unsigned int seed = 12345;
+	for( int i = 0; i < 500; i++ )
+	{
+		seed = seed * 1103515245u + 12345u;
+		x.push_back((double)(seed % 20000) / 10. - 1000.);
+		seed = seed * 1103515245u + 12345u;
+		y.push_back((double)(seed % 20000) / 10. - 1000.);
+	}
+	for( int i = 0; i < 20; i++ )
+		for( int j = 0; j < 20; j++ )
+		{
+			x.push_back(-500. + 50.*i);
+			y.push_back(-500. + 50.*j);
+		}
+
+	helio_kdtree tree;
+	tree.Build(x, y);
+	for( int q = 0; q < 200; q++ )
+	{
+		seed = seed * 1103515245u + 12345u;
+		double xmin = (double)(seed % 2400) - 1200.;
+		seed = seed * 1103515245u + 12345u;
+		double ymin = (double)(seed % 2400) - 1200.;
+		double dx = (double)(q % 7) * 50., dy = (double)(q % 5) * 50.;	//includes boxes of zero width on the grid lines
+
+		std::vector<int> found, expected;
+		tree.QueryBox(xmin, xmin + dx, ymin, ymin + dy, found);
+		for( int i = 0; i < (int)x.size(); i++ )
+			if( x[i] >= xmin && x[i] <= xmin + dx && y[i] >= ymin && y[i] <= ymin + dy )
+				expected.push_back(i);
+		std::sort(found.begin(), found.end());
+		EXPECT_EQ(found, expected) << "query " << q;
+	}
+
+	// A box on a grid point
+	std::vector<int> found;
+	tree.QueryBox(0., 0., 0., 0., found);
+	EXPECT_EQ(found.size(), 1u);
+}
+
+// Flux density from each heliostat at each flux point in turn, as fluxDensity() calculated it before the
+// heliostats were evaluated in blocks
+static void scalar_flux_density(SolarField *SF, FluxSurface &fs, Hvector &helios, std::vector<double> &flux)
+{
+	FluxGrid *grid = fs.getFluxMap();
+	int nfx = (int)grid->size(), nfy = (int)grid->at(0).size();
+	sp_point *offset = fs.getSurfaceOffset();
+	flux.assign(nfx*nfy, 0.);
+	for( size_t i = 0; i < helios.size(); i++ )
+	{
+		Heliostat *H = helios.at(i);
+		if( !H->IsEnabled() ) continue;
+		double sigx, sigy;
+		H->getImageSize(sigx, sigy);
+		sp_point *aim = H->getAimPoint();
+		double tht = H->getWhichReceiver()->getVarMap()->optical_height.Val();
+		double cnorm = H->getArea() * H->getEfficiencyTotal() / (tht*tht);
+		Vect *tv = H->getTowerVector();
+		Vect tvr;
+		tvr.Set(-tv->i, -tv->j, -tv->k);
+		for( int j = 0; j < nfx; j++ )
+			for( int k = 0; k < nfy; k++ )
+			{
+				FluxPoint *pt = &grid->at(j).at(k);
+				double f_dot_t = Toolbox::dotprod(pt->normal, tvr);
+				if( f_dot_t < 0. || f_dot_t > 1. ) continue;
+				sp_point pt_g, pt_ip;
+				pt_g.Set(pt->location.x + offset->x, pt->location.y + offset->y, pt->location.z + tht);
+				Toolbox::plane_intersect(*aim, tvr, pt_g, tvr, pt_ip);
+				pt_ip.Subtract(*aim);
+				Toolbox::rotation(PI - atan2(tvr.i, tvr.j), 2, pt_ip);
+				Toolbox::rotation(acos(tvr.k), 0, pt_ip);
+				double xn = -pt_ip.x / tht / sigx, yn = pt_ip.y / tht / sigy;
+				double hfe = SF->getFluxObject()->hermiteFluxEval(H, xn, yn) * exp(-0.5*(xn*xn + yn*yn));
+				flux[j*nfy + k] += f_dot_t * hfe * cnorm;
+			}
+	}
+}
+
+TEST_F(SolarFieldTest, BlockedFluxMatchesScalar_SolarField)
+{
+	// A 12 x 10 flux map
+	SF->getReceivers()->at(0)->DefineReceiverGeometry(12, 10);
+	helio_results res;
+	simulate(res);
+	Hvector *helios = SF->getHeliostats();
+	SF->HermiteFluxSimulation(*helios);
+
+	FluxSurface &fs = SF->getReceivers()->at(0)->getFluxSurfaces()->at(0);
+	FluxGrid *grid = fs.getFluxMap();
+	int nfx = (int)grid->size(), nfy = (int)grid->at(0).size();
+	ASSERT_GT(helios->size(), 200u);		//more than a few blocks
+	ASSERT_GT(nfx*nfy, 10);
+
+	std::vector<double> ref;
+	scalar_flux_density(SF, fs, *helios, ref);
+	double fmax = *std::max_element(ref.begin(), ref.end());
+	ASSERT_GT(fmax, 0.);
+
+	// The blocks sum in a different order than the heliostat loop, so the values match to round off
+	int nthreads[] = { 1, 3 };
+	for( int t = 0; t < 2; t++ )
+	{
+		SF->getFluxObject()->fluxDensity(SF->getSimInfoObject(), fs, *helios, true, false, false, nthreads[t]);
+		for( int j = 0; j < nfx; j++ )
+			for( int k = 0; k < nfy; k++ )
+				EXPECT_NEAR(grid->at(j).at(k).flux, ref[j*nfy + k], 1.e-12*fmax) << "threads " << nthreads[t] << " point " << j << "," << k;
+	}
+
+	// A single heliostat added to the existing grid, as image size priority aiming does
+	std::vector<double> before(nfx*nfy), one;
+	for( int j = 0; j < nfx; j++ )
+		for( int k = 0; k < nfy; k++ )
+			before[j*nfy + k] = grid->at(j).at(k).flux;
+	Hvector single(1, helios->at(helios->size() / 2));
+	scalar_flux_density(SF, fs, single, one);
+	SF->getFluxObject()->fluxDensity(SF->getSimInfoObject(), fs, single, false, false, false, 1);
+	int nchanged = 0;
+	for( int j = 0; j < nfx; j++ )
+		for( int k = 0; k < nfy; k++ )
+		{
+			int p = j*nfy + k;
+			EXPECT_NEAR(grid->at(j).at(k).flux, before[p] + one[p], 1.e-12*fmax) << "point " << j << "," << k;
+			if( one[p] > 0. ) nchanged++;
+		}
+	EXPECT_GT(nchanged, 0);
+}
+
+TEST(RunParallelLoopTest, VisitsEveryIndexOnce_SolarField)
+{
+	int n[] = { 0, 1, 31, 32, 33, 1000 };
+	int nthreads[] = { 1, 2, 3, 8, 0 };
+	int block[] = { 1, 7, 32 };
+	for( int i = 0; i < 6; i++ )
+		for( int t = 0; t < 5; t++ )
+			for( int b = 0; b < 3; b++ )
+			{
+				// Each call only writes its own entry
+				std::vector<int> count(n[i], 0);
+				SolarField::RunParallelLoop(n[i], nthreads[t], [&](int k){ count[k]++; }, block[b]);
+				for( int k = 0; k < n[i]; k++ )
+					EXPECT_EQ(count[k], 1) << "n " << n[i] << " threads " << nthreads[t] << " block " << block[b] << " index " << k;
+			}
+}
+
+TEST(RunParallelLoopTest, RethrowsFirstError_SolarField)
+{
+	// The same error as the sequential loop, whichever thread reaches its index first
+	int nthreads[] = { 1, 2, 4, 16 };
+	for( int t = 0; t < 4; t++ )
+	{
+		for( int rep = 0; rep < 20; rep++ )
+		{
+			std::string msg;
+			try
+			{
+				SolarField::RunParallelLoop(1000, nthreads[t], [&](int k){
+					if( k == 301 || k == 302 || k == 700 || k == 999 )
+						throw spexception("index " + std::to_string(k));
+				}, 4);
+			}
+			catch( spexception &e )
+			{
+				msg = e.what();
+			}
+			EXPECT_EQ(msg, "index 301") << "threads " << nthreads[t];
+		}
+	}
+}
+
+#ifdef SP_USE_THREADS
+
+TEST(LayoutSimQueueTest, HandsOutEachIndexOnce_SolarField)
+{
+	int nthreads = 4, nsim = 200;
+	LayoutSimQueue queue;
+	queue.Setup(0, nsim, nthreads);
+
+	std::vector<std::vector<int> > taken(nthreads);
+	std::vector<std::thread> threads;
+	for( int t = 0; t < nthreads; t++ )
+		threads.push_back(std::thread([&queue, &taken, t](){
+			int i = queue.Next(-1);
+			while( i > -1 )
+			{
+				taken[t].push_back(i);
+				i = queue.Next(i);
+			}
+			queue.ThreadDone();
+		}));
+
+	// The owner sees every completion and returns once all threads are done
+	int ndone = 0, nwake = 0;
+	while( queue.WaitForProgress(ndone) )
+		nwake++;
+	for( int t = 0; t < nthreads; t++ )
+		threads[t].join();
+	EXPECT_EQ(ndone, nsim);
+	EXPECT_GT(nwake, 0);
+
+	std::vector<int> count(nsim, 0);
+	for( int t = 0; t < nthreads; t++ )
+		for( size_t j = 0; j < taken[t].size(); j++ )
+			count[taken[t][j]]++;
+	for( int i = 0; i < nsim; i++ )
+		EXPECT_EQ(count[i], 1) << "simulation " << i;
+
+	// Nothing is handed out after a cancellation
+	queue.Setup(0, nsim, 1);
+	EXPECT_EQ(queue.Next(-1), 0);
+	queue.Cancel();
+	EXPECT_EQ(queue.Next(0), -1);
+	queue.ThreadDone();
+	ndone = 0;
+	EXPECT_TRUE(queue.WaitForProgress(ndone));
+	EXPECT_EQ(ndone, 1);
+	EXPECT_FALSE(queue.WaitForProgress(ndone));
+}
+
+// AutoPilot_MT limits the thread count to the number of cores. Set it directly so that the shared
+// simulation queue is used on any machine.
+class AutoPilot_MT_threads : public AutoPilot_MT
+{
+public:
+	AutoPilot_MT_threads(int nthreads)
+	{
+		_n_threads = nthreads;
+	}
+};
+
+struct autopilot_results
+{
+	sp_layout layout;
+	sp_optical_table opttab;
+	sp_flux_table fluxtab;
+};
+
+template <class T> static void run_autopilot(T &api, autopilot_results &res)
+{
+	var_map V;
+	std::vector<std::string> wf;
+	small_field_inputs(V, wf);
+
+	api.SetExternalSFObject(new SolarField());
+	api.GenerateDesignPointSimulations(V, wf);
+	api.Setup(V);
+	ASSERT_TRUE(api.CreateLayout(res.layout));
+	res.opttab.is_user_positions = true;
+	res.opttab.azimuths = { 90., 150., 210., 270. };
+	res.opttab.zeniths = { 15., 45., 75. };
+	ASSERT_TRUE(api.CalculateOpticalEfficiencyTable(res.opttab));
+	// Image size priority aiming, which is used for maps with more than one row, starts from the aim points
+	// of the previous simulation on the same field copy. Single row maps use simple aim points, which don't
+	// depend on the order the simulations run in.
+	res.fluxtab.is_user_spacing = true;
+	res.fluxtab.n_flux_days = 2;
+	res.fluxtab.delta_flux_hrs = 2;
+	ASSERT_TRUE(api.CalculateFluxMaps(res.fluxtab, 12, 1, true));
+}
+
+TEST(AutoPilotThreadsTest, QueueMatchesSerial_SolarField)
+{
+	// With one thread the layout runs FieldLayout() directly and the optical and flux simulations are
+	// taken from the queue in order by a single field copy, the same as a serial loop. (AutoPilot_S
+	// can't be used for reference since it passes its optical table sun positions in degrees.)
+	autopilot_results res_serial;
+	AutoPilot_MT_threads api_serial(1);
+	run_autopilot(api_serial, res_serial);
+	ASSERT_GT(res_serial.layout.heliostat_positions.size(), 100u);
+
+	// Three threads share the queue
+	autopilot_results res;
+	AutoPilot_MT_threads api(3);
+	run_autopilot(api, res);
+
+	ASSERT_EQ(res.layout.heliostat_positions.size(), res_serial.layout.heliostat_positions.size());
+	for( size_t i = 0; i < res.layout.heliostat_positions.size(); i++ )
+	{
+		EXPECT_EQ(res.layout.heliostat_positions[i].location.x, res_serial.layout.heliostat_positions[i].location.x) << "heliostat " << i;
+		EXPECT_EQ(res.layout.heliostat_positions[i].location.y, res_serial.layout.heliostat_positions[i].location.y) << "heliostat " << i;
+	}
+
+	EXPECT_EQ(res.opttab.eff_data, res_serial.opttab.eff_data);
+
+	ASSERT_EQ(res.fluxtab.flux_surfaces.size(), res_serial.fluxtab.flux_surfaces.size());
+	block_t<double> &f = res.fluxtab.flux_surfaces[0].flux_data, &f_serial = res_serial.fluxtab.flux_surfaces[0].flux_data;
+	size_t nr, nc, nl, nr_s, nc_s, nl_s;
+	f.size(nr, nc, nl);
+	f_serial.size(nr_s, nc_s, nl_s);
+	ASSERT_EQ(nr*nc*nl, nr_s*nc_s*nl_s);
+	ASSERT_GT(nl, 1u);
+	for( size_t i = 0; i < nr*nc*nl; i++ )
+		EXPECT_EQ(f.data()[i], f_serial.data()[i]) << "flux value " << i;
+}
+
+#endif // SP_USE_THREADS
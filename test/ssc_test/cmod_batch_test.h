@@ -0,0 +1,60 @@
+#ifndef _CMOD_BATCH_TEST_H_
+#define _CMOD_BATCH_TEST_H_
+
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "../ssc/sscapi.h"
+
+/**
+* CMBatchTest is the base of the tests for compute modules that run many systems or modules at once, and
+* compare them with separate runs. SetUp() creates 'data', which the helpers use unless given other data.
+*/
+class CMBatchTest : public ::testing::Test
+{
+protected:
+	ssc_data_t data;
+
+	void SetUp()
+	{
+		ssc_module_exec_set_print(0);
+		data = ssc_data_create();
+	}
+
+	void TearDown()
+	{
+		ssc_data_free(data);
+	}
+
+	/// Runs compute module 'name' on d, returns true if successful
+	static bool run(const char *name, ssc_data_t d)
+	{
+		ssc_module_t module = ssc_module_create(name);
+		if( NULL == module )
+			return false;
+		bool ok = ssc_module_exec(module, d) != 0;
+		ssc_module_free(module);
+		return ok;
+	}
+
+	bool run(const char *name)
+	{
+		return run(name, data);
+	}
+
+	/// Returns array output 'name' of d, empty if it was not assigned
+	static std::vector<double> output(ssc_data_t d, const char *name)
+	{
+		int len = 0;
+		ssc_number_t *p = ssc_data_get_array(d, name, &len);
+		return p ? std::vector<double>(p, p + len) : std::vector<double>();
+	}
+
+	std::vector<double> output(const char *name)
+	{
+		return output(data, name);
+	}
+};
+
+#endif
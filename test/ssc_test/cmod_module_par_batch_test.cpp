@@ -0,0 +1,296 @@
+#include <vector>
+#include <cmath>
+
+#include <gtest/gtest.h>
+
+#include "cmod_batch_test.h"
+#include "../shared/lib_pvmodel.h"
+#include "../shared/lib_iec61853.h"
+
+/**
+* Tests for the module_par_batch compute module: cold-started CEC fits must match the single module
+* solver, warm starts must reach equivalent solutions, results must not depend on the thread count,
+* and invalid modules must be reported per module instead of failing the batch
+*/
+
+class CMModuleParBatch : public CMBatchTest
+{
+protected:
+	std::vector<ssc_number_t> cec_input;	// row major, ncols columns
+	size_t nmod;
+
+	static const int ncols = 10;
+
+	void SetUp()
+	{
+		CMBatchTest::SetUp();
+
+		// Families of similar mono- and multicrystalline modules, enough for several fitting chunks
+		nmod = 0;
+		for( int type = 0; type < 2; type++ )
+			for( int nser = 60; nser <= 72; nser += 12 )
+				for( int k = 0; k < 20; k++ )
+				{
+					double s = 1.0 + 0.01*k;
+					double Voc = 0.64*nser*(1.0 + 0.003*k) - 0.01*type*nser;
+					double Isc = 9.0*s;
+					double row[ncols] = { (double)type, 0.815*Voc, 0.94*Isc, Voc, Isc,
+						0.0005*Isc, -0.0030*Voc, -0.40 - 0.02*type, (double)nser, 25.0 };
+					cec_input.insert(cec_input.end(), row, row + ncols);
+					nmod++;
+				}
+	}
+
+	bool run_batch(int nthreads, bool warm_start)
+	{
+		ssc_data_set_matrix(data, "cec_input", &cec_input[0], (int)nmod, ncols);
+		ssc_data_set_number(data, "nthreads", (ssc_number_t)nthreads);
+		ssc_data_set_number(data, "warm_start", warm_start ? 1 : 0);
+		return run("module_par_batch");
+	}
+
+	// IEC-61853 test data for a family of thin film modules, from the model of a fitted module scaled
+	// in current. Returns the number of modules.
+	size_t make_iec_input(std::vector<ssc_number_t> &iec_input, std::vector<ssc_number_t> &nser, std::vector<ssc_number_t> &type)
+	{
+		double irr[] = { 100, 200, 400, 600, 800, 1000, 1100 };
+		double tc[] = { 15, 25, 50, 75 };
+		size_t n = 8;
+		for( size_t m = 0; m < n; m++ )
+		{
+			double s = 1.0 + 0.04*m;
+			iec61853_module_t mod;
+			mod.set_fs267_from_matlab();
+			mod.Il *= s;
+			mod.Io *= s;
+			mod.alphaIsc *= s;
+			mod.C1 /= s;
+			mod.C2 /= s;
+			mod.D1 /= s;
+			mod.D3 /= s;
+			mod.NcellSer = 116;
+			mod.Voc0 = 87;
+			mod.Area = 0.72;
+			mod.UseLambertW = true;
+
+			for( size_t i = 0; i < sizeof(irr) / sizeof(irr[0]); i++ )
+				for( size_t j = 0; j < sizeof(tc) / sizeof(tc[0]); j++ )
+				{
+					pvinput_t in(0, 0, 0, 0, irr[i], 25, 25, 1, 180, 1013, 30, 0, 0, 30, 180, 12, 3, true);
+					pvoutput_t out;
+					mod(in, tc[j], -1, out);
+					ssc_number_t row[] = { (ssc_number_t)m, (ssc_number_t)irr[i], (ssc_number_t)tc[j], (ssc_number_t)out.Power,
+						(ssc_number_t)out.Voltage, (ssc_number_t)out.Voc_oper, (ssc_number_t)out.Isc_oper };
+					iec_input.insert(iec_input.end(), row, row + 7);
+				}
+			nser.push_back(116);
+			type.push_back(iec61853_module_t::CdTe);
+		}
+		return n;
+	}
+};
+
+TEST_F(CMModuleParBatch, ColdStartMatchesSingleModuleSolver_cmod_module_par_batch)
+{
+	ASSERT_TRUE(run_batch(2, false));
+	std::vector<double> a = output("cec_a"), Il = output("cec_Il"), Io = output("cec_Io"),
+		Rs = output("cec_Rs"), Rsh = output("cec_Rsh"), Adj = output("cec_Adj"),
+		status = output("cec_status"), warm = output("cec_warm_source");
+	ASSERT_EQ(a.size(), nmod);
+
+	const char *celltype[] = { "monoSi", "multiSi" };
+	for( size_t i = 0; i < nmod; i++ )
+	{
+		const ssc_number_t *row = &cec_input[i*ncols];
+		ssc_data_t d = ssc_data_create();
+		ssc_data_set_string(d, "celltype", celltype[(int)row[0]]);
+		ssc_data_set_number(d, "Vmp", row[1]);
+		ssc_data_set_number(d, "Imp", row[2]);
+		ssc_data_set_number(d, "Voc", row[3]);
+		ssc_data_set_number(d, "Isc", row[4]);
+		ssc_data_set_number(d, "alpha_isc", row[5]);
+		ssc_data_set_number(d, "beta_voc", row[6]);
+		ssc_data_set_number(d, "gamma_pmp", row[7]);
+		ssc_data_set_number(d, "Nser", row[8]);
+		ssc_data_set_number(d, "Tref", row[9]);
+
+		ssc_module_t module = ssc_module_create("6parsolve");
+		ASSERT_TRUE(module != NULL);
+		bool solved = ssc_module_exec(module, d) != 0;
+		ssc_module_free(module);
+
+		EXPECT_EQ(status[i] == 0, solved) << "module " << i;
+		EXPECT_EQ(warm[i], -1) << "module " << i;
+		if( solved )
+		{
+			ssc_number_t v;
+			ssc_data_get_number(d, "a", &v);		EXPECT_EQ(a[i], v) << "module " << i;
+			ssc_data_get_number(d, "Il", &v);		EXPECT_EQ(Il[i], v) << "module " << i;
+			ssc_data_get_number(d, "Io", &v);		EXPECT_EQ(Io[i], v) << "module " << i;
+			ssc_data_get_number(d, "Rs", &v);		EXPECT_EQ(Rs[i], v) << "module " << i;
+			ssc_data_get_number(d, "Rsh", &v);	EXPECT_EQ(Rsh[i], v) << "module " << i;
+			ssc_data_get_number(d, "Adj", &v);	EXPECT_EQ(Adj[i], v) << "module " << i;
+		}
+		ssc_data_free(d);
+	}
+}
+
+TEST_F(CMModuleParBatch, WarmStartsReachEquivalentSolutions_cmod_module_par_batch)
+{
+	ASSERT_TRUE(run_batch(2, false));
+	std::vector<double> status_cold = output("cec_status");
+	std::vector<double> iter_cold = output("cec_iterations");
+
+	ASSERT_TRUE(run_batch(2, true));
+	std::vector<double> a = output("cec_a"), Il = output("cec_Il"), Io = output("cec_Io"),
+		Rs = output("cec_Rs"), Rsh = output("cec_Rsh"), status = output("cec_status"),
+		warm = output("cec_warm_source"), pmp_err = output("cec_pmp_error"), iter = output("cec_iterations");
+
+	int n_warm = 0;
+	double iter_total = 0, iter_total_cold = 0;
+	for( size_t i = 0; i < nmod; i++ )
+	{
+		ASSERT_EQ(status_cold[i], 0) << "module " << i;
+		ASSERT_EQ(status[i], 0) << "module " << i;
+		iter_total += iter[i];
+		iter_total_cold += iter_cold[i];
+		if( warm[i] < 0 )
+			continue;
+		n_warm++;
+
+		// Warm starts only come from the same technology
+		EXPECT_EQ(cec_input[(size_t)warm[i]*ncols], cec_input[i*ncols]) << "module " << i;
+		EXPECT_LT(std::fabs(pmp_err[i]), 1.e-4) << "module " << i;
+
+		// The fitted module reproduces the datasheet maximum power point
+		const ssc_number_t *row = &cec_input[i*ncols];
+		double Vmp = row[1], Imp = row[2];
+		double I = current_5par(Vmp, Imp, a[i], Il[i], Io[i], Rs[i], Rsh[i]);
+		EXPECT_NEAR(I, Imp, 1.e-3*Imp) << "module " << i;
+		double Pmp = maxpower_5par(row[3], a[i], Il[i], Io[i], Rs[i], Rsh[i]);
+		EXPECT_NEAR(Pmp, Vmp*Imp, 2.e-3*Vmp*Imp) << "module " << i;
+	}
+	EXPECT_GT(n_warm, (int)nmod / 2);
+	EXPECT_LT(iter_total, iter_total_cold);
+}
+
+TEST_F(CMModuleParBatch, ResultsDoNotDependOnThreadCount_cmod_module_par_batch)
+{
+	const char *names[] = { "cec_a", "cec_Il", "cec_Io", "cec_Rs", "cec_Rsh", "cec_Adj",
+		"cec_status", "cec_iterations", "cec_warm_source", "cec_pmp_error" };
+
+	ASSERT_TRUE(run_batch(1, true));
+	std::vector< std::vector<double> > ref;
+	for( size_t k = 0; k < sizeof(names) / sizeof(names[0]); k++ )
+		ref.push_back(output(names[k]));
+
+	for( int nthreads = 2; nthreads <= 4; nthreads += 2 )
+	{
+		ASSERT_TRUE(run_batch(nthreads, true));
+		for( size_t k = 0; k < ref.size(); k++ )
+		{
+			std::vector<double> v = output(names[k]);
+			ASSERT_EQ(v.size(), nmod);
+			for( size_t i = 0; i < nmod; i++ )
+				EXPECT_EQ(v[i], ref[k][i]) << names[k] << "[" << i << "] with " << nthreads << " threads";
+		}
+	}
+}
+
+TEST_F(CMModuleParBatch, InvalidModulesAreReported_cmod_module_par_batch)
+{
+	cec_input[3*ncols + 3] = cec_input[3*ncols + 1] * 0.9;	// Voc below Vmp
+	cec_input[7*ncols + 8] = 0;								// no cells in series
+
+	ASSERT_TRUE(run_batch(2, true));
+	std::vector<double> a = output("cec_a"), status = output("cec_status"), warm = output("cec_warm_source");
+	for( size_t i = 0; i < nmod; i++ )
+	{
+		if( i == 3 || i == 7 )
+		{
+			EXPECT_EQ(status[i], -100) << "module " << i;
+			EXPECT_TRUE(std::isnan(a[i])) << "module " << i;
+			EXPECT_EQ(warm[i], -1) << "module " << i;
+		}
+		else
+		{
+			EXPECT_EQ(status[i], 0) << "module " << i;
+			// Nothing is warm-started from an invalid module
+			EXPECT_NE(warm[i], 3) << "module " << i;
+			EXPECT_NE(warm[i], 7) << "module " << i;
+		}
+	}
+}
+
+TEST_F(CMModuleParBatch, IecWarmStartsReachEquivalentFits_cmod_module_par_batch)
+{
+	std::vector<ssc_number_t> iec_input, nser, type;
+	size_t n = make_iec_input(iec_input, nser, type);
+	ssc_data_set_matrix(data, "iec_input", &iec_input[0], (int)(iec_input.size() / 7), 7);
+	ssc_data_set_array(data, "iec_nser", &nser[0], (int)n);
+	ssc_data_set_array(data, "iec_type", &type[0], (int)n);
+	cec_input.resize(ncols);
+	nmod = 1;
+
+	const char *names[] = { "iec_n", "iec_Il", "iec_Io", "iec_Egref", "iec_C1", "iec_C2", "iec_C3", "iec_D1", "iec_D2", "iec_D3" };
+	const size_t npar = sizeof(names) / sizeof(names[0]);
+	std::vector< std::vector<double> > par[2];
+	ASSERT_TRUE(run_batch(1, false));
+	for( size_t k = 0; k < npar; k++ )
+		par[0].push_back(output(names[k]));
+	std::vector<double> status_cold = output("iec_status"), nsolved_cold = output("iec_nsolved");
+
+	ASSERT_TRUE(run_batch(1, true));
+	for( size_t k = 0; k < npar; k++ )
+		par[1].push_back(output(names[k]));
+	std::vector<double> status = output("iec_status"), nsolved = output("iec_nsolved"), warm = output("iec_warm_source"),
+		alpha = output("iec_alphaIsc");
+	ASSERT_EQ(status.size(), n);
+
+	int n_warm = 0;
+	for( size_t i = 0; i < n; i++ )
+	{
+		ASSERT_EQ(status_cold[i], 1) << "module " << i;
+		ASSERT_EQ(status[i], 1) << "module " << i;
+		EXPECT_EQ(nsolved[i], nsolved_cold[i]) << "module " << i;
+		if( warm[i] < 0 )
+			continue;
+		n_warm++;
+
+		// Both fits give the same module performance over the test conditions
+		iec61853_module_t m[2];
+		for( int w = 0; w < 2; w++ )
+		{
+			const std::vector< std::vector<double> > &p = par[w];
+			m[w].n = p[0][i]; m[w].Il = p[1][i]; m[w].Io = p[2][i]; m[w].Egref = p[3][i];
+			m[w].C1 = p[4][i]; m[w].C2 = p[5][i]; m[w].C3 = p[6][i];
+			m[w].D1 = p[7][i]; m[w].D2 = p[8][i]; m[w].D3 = p[9][i];
+			m[w].alphaIsc = alpha[i];
+			m[w].NcellSer = 116;
+			m[w].Area = 0.72;
+			m[w].UseLambertW = true;
+		}
+		for( size_t r = 0; r < iec_input.size(); r += 7 )
+		{
+			if( iec_input[r] != (ssc_number_t)i )
+				continue;
+			pvinput_t in(0, 0, 0, 0, iec_input[r + 1], 25, 25, 1, 180, 1013, 30, 0, 0, 30, 180, 12, 3, true);
+			pvoutput_t out_cold, out_warm;
+			m[0](in, iec_input[r + 2], -1, out_cold);
+			m[1](in, iec_input[r + 2], -1, out_warm);
+			EXPECT_NEAR(out_warm.Power, out_cold.Power, 0.01*iec_input[r + 3]) << "module " << i << " row " << r / 7;
+		}
+	}
+	EXPECT_EQ(n_warm, (int)n - 1);
+}
+
+TEST_F(CMModuleParBatch, IecModuleIndexOutOfRangeFails_cmod_module_par_batch)
+{
+	ssc_number_t iec_input[] = { 0, 1000, 25, 300, 31, 38, 9.8,
+								 1, 1000, 25, 300, 31, 38, 9.8 };
+	ssc_number_t nser[] = { 60 }, type[] = { 0 };
+	ssc_data_set_matrix(data, "iec_input", iec_input, 2, 7);
+	ssc_data_set_array(data, "iec_nser", nser, 1);
+	ssc_data_set_array(data, "iec_type", type, 1);
+	EXPECT_FALSE(run("module_par_batch"));
+}
@@ -0,0 +1,187 @@
+#include <vector>
+#include <cmath>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "../ssc/sscapi.h"
+
+/**
+* Tests for stepping sessions of pvwattsv5_1ts: a session must give the same results as chained single
+* time step calls, each step must only need the time and weather, and the session log must only hold
+* the messages of the most recent step
+*/
+
+class CMPvwattsV5Session : public ::testing::Test
+{
+protected:
+	ssc_data_t config;
+
+	void SetUp()
+	{
+		config = ssc_data_create();
+		ssc_data_set_number(config, "lat", 33.45);
+		ssc_data_set_number(config, "lon", -111.98);
+		ssc_data_set_number(config, "tz", -7);
+		ssc_data_set_number(config, "time_step", 1);
+		ssc_data_set_number(config, "system_capacity", 4);
+		ssc_data_set_number(config, "module_type", 0);
+		ssc_data_set_number(config, "dc_ac_ratio", 1.2);
+		ssc_data_set_number(config, "inv_eff", 96);
+		ssc_data_set_number(config, "losses", 14);
+		ssc_data_set_number(config, "array_type", 0);
+		ssc_data_set_number(config, "tilt", 20);
+		ssc_data_set_number(config, "azimuth", 180);
+		ssc_data_set_number(config, "gcr", 0.4);
+		ssc_data_set_number(config, "tcell", 15);
+		ssc_data_set_number(config, "poa", 0);
+	}
+
+	void TearDown()
+	{
+		ssc_data_free(config);
+	}
+
+	// Synthetic clear day
+	static void set_weather(ssc_data_t data, int hour)
+	{
+		double sun = (hour >= 6 && hour <= 18) ? sin(3.14159*(hour - 5.5) / 13.) : 0.;
+		ssc_data_set_number(data, "year", 2017);
+		ssc_data_set_number(data, "month", 6);
+		ssc_data_set_number(data, "day", 21);
+		ssc_data_set_number(data, "hour", hour);
+		ssc_data_set_number(data, "minute", 30);
+		ssc_data_set_number(data, "beam", 900.*sun);
+		ssc_data_set_number(data, "diffuse", 100.*sun);
+		ssc_data_set_number(data, "tamb", 25. + 10.*sun);
+		ssc_data_set_number(data, "wspd", 1. + 0.2*(hour % 5));
+	}
+
+	static int log_count(ssc_module_t module)
+	{
+		int n = 0, type;
+		float time;
+		while( ssc_module_log(module, n, &type, &time) )
+			n++;
+		return n;
+	}
+};
+
+TEST_F(CMPvwattsV5Session, SessionMatchesChainedCalls_cmod_pvwattsv5_1ts)
+{
+	ssc_session_t session = ssc_session_create("pvwattsv5_1ts", config);
+	ASSERT_TRUE(session != NULL);
+
+	// Single calls pass the cell temperature and irradiance back in through the same table
+	ssc_module_t module = ssc_module_create("pvwattsv5_1ts");
+	ASSERT_TRUE(module != NULL);
+
+	double ac_total = 0;
+	for( int hour = 0; hour < 24; hour++ )
+	{
+		set_weather(config, hour);
+		ASSERT_TRUE(ssc_module_exec(module, config) != 0) << "hour " << hour;
+
+		ssc_data_t step = ssc_data_create();
+		set_weather(step, hour);
+		ASSERT_TRUE(ssc_session_step(session, step) != 0) << "hour " << hour;
+
+		const char *names[] = { "poa", "tcell", "dc", "ac" };
+		for( int k = 0; k < 4; k++ )
+		{
+			ssc_number_t v_single = -999, v_session = -999;
+			ASSERT_TRUE(ssc_data_get_number(config, names[k], &v_single));
+			ASSERT_TRUE(ssc_data_get_number(step, names[k], &v_session));
+			EXPECT_EQ(v_session, v_single) << names[k] << " at hour " << hour;
+		}
+		ssc_number_t ac;
+		ssc_data_get_number(step, "ac", &ac);
+		ac_total += ac;
+		ssc_data_free(step);
+	}
+	EXPECT_GT(ac_total, 10000.);
+
+	ssc_module_free(module);
+	ssc_session_free(session);
+}
+
+TEST_F(CMPvwattsV5Session, StepLogHoldsOnlyTheLatestStep_cmod_pvwattsv5_1ts)
+{
+	ssc_session_t session = ssc_session_create("pvwattsv5_1ts", config);
+	ASSERT_TRUE(session != NULL);
+
+	for( int i = 0; i < 50; i++ )
+	{
+		// Every other step is missing its beam irradiance and fails with one message
+		ssc_data_t step = ssc_data_create();
+		set_weather(step, 12);
+		bool valid = (i % 2 == 0);
+		if( !valid )
+			ssc_data_unassign(step, "beam");
+
+		EXPECT_EQ(ssc_session_step(session, step) != 0, valid) << "step " << i;
+		if( valid )
+			EXPECT_EQ(log_count(session), 0) << "step " << i;
+		else
+		{
+			ASSERT_EQ(log_count(session), 1) << "step " << i;
+			int type;
+			float time;
+			std::string msg = ssc_module_log(session, 0, &type, &time);
+			EXPECT_NE(msg.find("beam"), std::string::npos) << msg;
+		}
+		ssc_data_free(step);
+	}
+
+	ssc_session_free(session);
+}
+
+TEST_F(CMPvwattsV5Session, StepsDoNotRevalidateConfiguration_cmod_pvwattsv5_1ts)
+{
+	ssc_session_t session = ssc_session_create("pvwattsv5_1ts", config);
+	ASSERT_TRUE(session != NULL);
+
+	// A step table with only time and weather is enough, the configuration was kept by the session
+	ssc_data_t step = ssc_data_create();
+	set_weather(step, 12);
+	EXPECT_TRUE(ssc_session_step(session, step) != 0);
+	ssc_number_t ac = 0;
+	EXPECT_TRUE(ssc_data_get_number(step, "ac", &ac));
+	EXPECT_GT(ac, 0.);
+	ssc_data_free(step);
+
+	ssc_session_free(session);
+}
+
+TEST_F(CMPvwattsV5Session, InvalidSessionsAreRejected_cmod_pvwattsv5_1ts)
+{
+	EXPECT_TRUE(ssc_session_create("no_such_module", config) == NULL);
+
+	// Modules without session support, and a missing configuration, give a session that reports why
+	// it failed and can't be stepped
+	const char *modules[] = { "pvwattsv5", "pvwattsv5_1ts" };
+	const char *reason[] = { "does not support stepping sessions", "lat" };
+	ssc_data_unassign(config, "lat");
+	for( int k = 0; k < 2; k++ )
+	{
+		ssc_session_t session = ssc_session_create(modules[k], config);
+		ASSERT_TRUE(session != NULL) << modules[k];
+		ASSERT_EQ(log_count(session), 1) << modules[k];
+		int type;
+		float time;
+		std::string msg = ssc_module_log(session, 0, &type, &time);
+		EXPECT_NE(msg.find(reason[k]), std::string::npos) << msg;
+
+		// Steps fail and keep the setup message
+		ssc_data_t step = ssc_data_create();
+		set_weather(step, 12);
+		EXPECT_FALSE(ssc_session_step(session, step) != 0) << modules[k];
+		ssc_number_t ac;
+		EXPECT_FALSE(ssc_data_get_number(step, "ac", &ac)) << modules[k];
+		EXPECT_EQ(log_count(session), 1) << modules[k];
+		EXPECT_EQ(std::string(ssc_module_log(session, 0, &type, &time)), msg);
+		ssc_data_free(step);
+
+		ssc_session_free(session);
+	}
+}
@@ -0,0 +1,135 @@
+#include <vector>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+
+#include <gtest/gtest.h>
+
+#include "cmod_batch_test.h"
+
+/**
+* Tests for the pvwattsv5_fleet compute module: every system of a fleet must give the same results as a
+* separate pvwattsv5 run at the weather file location, the fleet time series must be the sum of the
+* separate runs, and results must not depend on the thread count
+*/
+
+class CMPvwattsV5Fleet : public CMBatchTest
+{
+protected:
+	char weather_file[256];
+	std::vector<ssc_number_t> systems;	// row major, ncols columns
+	size_t nsys;
+
+	static const int ncols = 9;
+
+	void SetUp()
+	{
+		CMBatchTest::SetUp();
+		sprintf(weather_file, "%s/test/input_cases/pvsamv1_data/USA AZ Phoenix (TMY2).csv", std::getenv("SSCDIR"));
+
+		// Every array type and module type, with a spread of orientations and ground coverage ratios
+		nsys = 15;
+		for( size_t i = 0; i < nsys; i++ )
+		{
+			int array_type = (int)(i % 5), module_type = (int)((i / 5) % 3);
+			double tilt = (array_type == 4) ? 0 : 5 + (i * 7) % 40;
+			double row[ncols] = { 2.0 + 0.5*(i % 7), (double)module_type, 1.1 + 0.01*(i % 3), 96, 14.0 + (i % 5),
+				(double)array_type, tilt, 90. + (i * 37) % 180, 0.3 + 0.05*(i % 4) };
+			systems.insert(systems.end(), row, row + ncols);
+		}
+	}
+
+	bool run_fleet(int nthreads)
+	{
+		ssc_data_set_string(data, "solar_resource_file", weather_file);
+		ssc_data_set_matrix(data, "systems", &systems[0], (int)nsys, ncols);
+		ssc_data_set_number(data, "aggregate_timeseries", 1);
+		ssc_data_set_number(data, "nthreads", (ssc_number_t)nthreads);
+		ssc_data_set_number(data, "adjust:constant", 0);
+		return run("pvwattsv5_fleet");
+	}
+};
+
+TEST_F(CMPvwattsV5Fleet, FleetMatchesSeparateRuns_cmod_pvwattsv5_fleet)
+{
+	ASSERT_TRUE(run_fleet(2));
+	std::vector<double> annual = output(data, "annual_energy"), kwh_per_kw = output(data, "kwh_per_kw"),
+		capacity_factor = output(data, "capacity_factor"), gen = output(data, "gen");
+	int nrows = 0, nmonths = 0;
+	ssc_number_t *monthly = ssc_data_get_matrix(data, "monthly_energy", &nrows, &nmonths);
+	ASSERT_EQ(annual.size(), nsys);
+	ASSERT_EQ(nrows, (int)nsys);
+	ASSERT_EQ(nmonths, 12);
+	ASSERT_EQ(gen.size(), 8760);
+
+	const char *names[] = { "system_capacity", "module_type", "dc_ac_ratio", "inv_eff", "losses",
+		"array_type", "tilt", "azimuth", "gcr" };
+	std::vector<double> gen_total(gen.size(), 0.);
+	double fleet_annual = 0;
+	for( size_t i = 0; i < nsys; i++ )
+	{
+		ssc_data_t d = ssc_data_create();
+		ssc_data_set_string(d, "solar_resource_file", weather_file);
+		for( int k = 0; k < ncols; k++ )
+			ssc_data_set_number(d, names[k], systems[i*ncols + k]);
+		ssc_data_set_number(d, "adjust:constant", 0);
+		ASSERT_TRUE(run("pvwattsv5", d)) << "system " << i;
+
+		ssc_number_t v;
+		ssc_data_get_number(d, "annual_energy", &v);	EXPECT_EQ(annual[i], v) << "system " << i;
+		ssc_data_get_number(d, "kwh_per_kw", &v);		EXPECT_EQ(kwh_per_kw[i], v) << "system " << i;
+		ssc_data_get_number(d, "capacity_factor", &v);	EXPECT_EQ(capacity_factor[i], v) << "system " << i;
+		fleet_annual += annual[i];
+
+		std::vector<double> m = output(d, "monthly_energy"), g = output(d, "gen");
+		ASSERT_EQ(m.size(), 12);
+		for( int j = 0; j < 12; j++ )
+			EXPECT_EQ(monthly[i*12 + j], m[j]) << "system " << i << " month " << j;
+		ASSERT_EQ(g.size(), gen.size());
+		for( size_t j = 0; j < g.size(); j++ )
+			gen_total[j] += g[j];
+		ssc_data_free(d);
+	}
+
+	// The fleet totals are summed in a different order than here
+	for( size_t j = 0; j < gen.size(); j++ )
+		EXPECT_NEAR(gen[j], gen_total[j], 1.e-4*(1.0 + gen_total[j])) << "time step " << j;
+	ssc_number_t v;
+	ASSERT_TRUE(ssc_data_get_number(data, "fleet_annual_energy", &v));
+	EXPECT_NEAR(v, fleet_annual, 1.e-6*fleet_annual);
+}
+
+TEST_F(CMPvwattsV5Fleet, ResultsDoNotDependOnThreadCount_cmod_pvwattsv5_fleet)
+{
+	ASSERT_TRUE(run_fleet(1));
+	std::vector<double> annual_ref = output(data, "annual_energy"), gen_ref = output(data, "gen");
+
+	for( int nthreads = 2; nthreads <= 4; nthreads += 2 )
+	{
+		ASSERT_TRUE(run_fleet(nthreads));
+		std::vector<double> annual = output(data, "annual_energy"), gen = output(data, "gen");
+		ASSERT_EQ(annual.size(), annual_ref.size());
+		ASSERT_EQ(gen.size(), gen_ref.size());
+		for( size_t i = 0; i < annual.size(); i++ )
+			EXPECT_EQ(annual[i], annual_ref[i]) << "system " << i << " with " << nthreads << " threads";
+		for( size_t j = 0; j < gen.size(); j++ )
+			EXPECT_EQ(gen[j], gen_ref[j]) << "time step " << j << " with " << nthreads << " threads";
+	}
+}
+
+TEST_F(CMPvwattsV5Fleet, InvalidSystemsAreRejected_cmod_pvwattsv5_fleet)
+{
+	// Systems can't be placed away from the weather file location
+	std::vector<ssc_number_t> extra;
+	for( size_t i = 0; i < nsys; i++ )
+	{
+		extra.insert(extra.end(), &systems[i*ncols], &systems[i*ncols] + ncols);
+		extra.push_back(0);
+	}
+	ssc_data_set_string(data, "solar_resource_file", weather_file);
+	ssc_data_set_matrix(data, "systems", &extra[0], (int)nsys, ncols + 1);
+	EXPECT_FALSE(run("pvwattsv5_fleet", data));
+
+	systems[4*ncols + 6] = 100;	// tilt out of range
+	EXPECT_FALSE(run_fleet(2));
+}
@@ -0,0 +1,196 @@
+#include <string>
+#include <vector>
+#include <fstream>
+#include <cstdio>
+
+#include <gtest/gtest.h>
+
+#include "../ssc/core.h"
+#include "../ssc/csp_common.h"
+#include "../tcs/csp_solver_pc_heat_sink.h"
+
+/**
+* Tests for csp_output_selector: outputs outside 'csp_output_subset' must not be stored, required ones
+* must still be returned as placeholders, and every connected output, including power cycle outputs,
+* must reach the 'csp_output_csv_file' sink
+*/
+
+static var_info _cm_vtab_csp_output_test[] = {
+	/*   VARTYPE           DATATYPE         NAME                   LABEL                            UNITS     META    GROUP       REQUIRED_IF   CONSTRAINTS   UI_HINTS*/
+	{ SSC_INPUT,        SSC_STRING,      "csp_output_subset",   "Outputs to store",              "-",      "",     "",         "?",          "",           "" },
+	{ SSC_INPUT,        SSC_STRING,      "csp_output_csv_file", "Output CSV file",               "-",      "",     "",         "?",          "",           "" },
+
+	{ SSC_OUTPUT,       SSC_ARRAY,       "q_kept",              "Required output in subset",     "-",      "",     "",         "*",          "",           "" },
+	{ SSC_OUTPUT,       SSC_ARRAY,       "q_required",          "Required output",               "-",      "",     "",         "*",          "",           "" },
+	{ SSC_OUTPUT,       SSC_ARRAY,       "q_optional",          "Optional output",               "-",      "",     "",         "?",          "",           "" },
+	{ SSC_OUTPUT,       SSC_ARRAY,       "q_heat_sink",         "Optional power cycle output",   "-",      "",     "",         "?",          "",           "" },
+	{ SSC_OUTPUT,       SSC_ARRAY,       "m_dot_sink",          "Required power cycle output",   "-",      "",     "",         "*",          "",           "" },
+
+	var_info_invalid };
+
+class cm_csp_output_test : public compute_module
+{
+public:
+	enum
+	{
+		E_KEPT,
+		E_REQUIRED,
+		E_OPTIONAL
+	};
+
+	bool m_is_sink;
+
+	cm_csp_output_test()
+	{
+		add_var_info(_cm_vtab_csp_output_test);
+		m_is_sink = false;
+	}
+
+	void exec() throw(general_error)
+	{
+		static C_csp_reported_outputs::S_output_info output_info[] =
+		{
+			{E_KEPT, C_csp_reported_outputs::TS_WEIGHTED_AVE},
+			{E_REQUIRED, C_csp_reported_outputs::TS_WEIGHTED_AVE},
+			{E_OPTIONAL, C_csp_reported_outputs::TS_WEIGHTED_AVE},
+
+			csp_info_invalid
+		};
+
+		int n_steps = 3;
+
+		C_csp_reported_outputs outputs;
+		outputs.construct(output_info);
+
+		C_pc_heat_sink heat_sink;
+
+		csp_output_selector reported_outputs(this, n_steps);
+		m_is_sink = reported_outputs.get_sink() != 0;
+
+		reported_outputs.assign(outputs, E_KEPT, "q_kept");
+		reported_outputs.assign(outputs, E_REQUIRED, "q_required");
+		reported_outputs.assign(outputs, E_OPTIONAL, "q_optional");
+		reported_outputs.assign(heat_sink, C_pc_heat_sink::E_Q_DOT_HEAT_SINK, "q_heat_sink");
+		reported_outputs.assign(heat_sink, C_pc_heat_sink::E_M_DOT_HTF, "m_dot_sink");
+
+		for( int i = 1; i <= n_steps; i++ )
+		{
+			double time_start = 3600.0*(i - 1);
+			std::vector<double> v_time_end(1, 3600.0*i);
+
+			outputs.value(E_KEPT, 10.0 + i);
+			outputs.value(E_REQUIRED, 20.0 + i);
+			outputs.value(E_OPTIONAL, 30.0 + i);
+			outputs.set_timestep_outputs();
+			outputs.send_to_reporting_ts_array(time_start, v_time_end, v_time_end[0]);
+
+			heat_sink.mc_reported_outputs.value(C_pc_heat_sink::E_Q_DOT_HEAT_SINK, 100.0 + i);
+			heat_sink.mc_reported_outputs.value(C_pc_heat_sink::E_M_DOT_HTF, 200.0 + i);
+			heat_sink.mc_reported_outputs.set_timestep_outputs();
+			heat_sink.write_output_intervals(time_start, v_time_end, v_time_end[0]);
+
+			if( reported_outputs.get_sink() != 0 )
+				reported_outputs.get_sink()->end_reporting_timestep(v_time_end[0]);
+		}
+	}
+};
+
+class csp_output_test_handler : public handler_interface
+{
+public:
+	csp_output_test_handler(compute_module *cm) : handler_interface(cm) {}
+
+	virtual void on_log(const std::string &, int, float) {}
+	virtual bool on_update(const std::string &, float, float) { return true; }
+};
+
+class CspOutputSelectorTest : public ::testing::Test
+{
+protected:
+	cm_csp_output_test cm;
+	csp_output_test_handler handler;
+	var_table vt;
+	std::string csv_file;
+
+	CspOutputSelectorTest() : handler(&cm) {}
+
+	void SetUp()
+	{
+		csv_file = "csp_output_selector_test.csv";
+	}
+
+	void TearDown()
+	{
+		std::remove(csv_file.c_str());
+	}
+
+	std::vector<double> get_array(const std::string &name)
+	{
+		std::vector<double> v;
+		var_data *vd = vt.lookup(name);
+		if( vd != 0 && vd->type == SSC_ARRAY )
+		{
+			for( size_t i = 0; i < vd->num.length(); i++ )
+				v.push_back(vd->num[i]);
+		}
+		return v;
+	}
+};
+
+TEST_F(CspOutputSelectorTest, AllOutputsStoredWithoutSubset_csp_common)
+{
+	ASSERT_TRUE(cm.compute(&handler, &vt));
+	EXPECT_FALSE(cm.m_is_sink);
+
+	const char *names[] = { "q_kept", "q_required", "q_optional", "q_heat_sink", "m_dot_sink" };
+	double offsets[] = { 10.0, 20.0, 30.0, 100.0, 200.0 };
+	for( int k = 0; k < 5; k++ )
+	{
+		std::vector<double> v = get_array(names[k]);
+		ASSERT_EQ(v.size(), (size_t)3) << names[k];
+		for( int i = 0; i < 3; i++ )
+			EXPECT_NEAR(v[i], offsets[k] + i + 1, 1.E-4) << names[k] << " step " << i;
+	}
+}
+
+TEST_F(CspOutputSelectorTest, SubsetAndCsvSink_csp_common)
+{
+	vt.assign("csp_output_subset", var_data("q_kept, q_heat_sink"));
+	vt.assign("csp_output_csv_file", var_data(csv_file));
+
+	ASSERT_TRUE(cm.compute(&handler, &vt));
+	EXPECT_TRUE(cm.m_is_sink);
+
+	// Stored outputs
+	std::vector<double> v_kept = get_array("q_kept");
+	std::vector<double> v_heat_sink = get_array("q_heat_sink");
+	ASSERT_EQ(v_kept.size(), (size_t)3);
+	ASSERT_EQ(v_heat_sink.size(), (size_t)3);
+	EXPECT_NEAR(v_kept[2], 13.0, 1.E-4);
+	EXPECT_NEAR(v_heat_sink[2], 103.0, 1.E-4);
+
+	// Required outputs outside the subset are placeholders, optional ones are not assigned
+	EXPECT_EQ(get_array("q_required").size(), (size_t)1);
+	EXPECT_EQ(get_array("m_dot_sink").size(), (size_t)1);
+	EXPECT_TRUE(vt.lookup("q_optional") == 0);
+
+	// Every connected output is in the file, one row per reporting timestep
+	std::ifstream file(csv_file.c_str());
+	ASSERT_TRUE(file.is_open());
+	std::string line;
+	std::getline(file, line);
+	EXPECT_EQ(line, "time_hr,q_kept,q_required,q_optional,q_heat_sink,m_dot_sink");
+	std::getline(file, line);
+	EXPECT_EQ(line, "1,11,21,31,101,201");
+	std::getline(file, line);
+	std::getline(file, line);
+	EXPECT_EQ(line, "3,13,23,33,103,203");
+	EXPECT_FALSE(std::getline(file, line));
+}
+
+TEST_F(CspOutputSelectorTest, BadCsvFileFails_csp_common)
+{
+	vt.assign("csp_output_csv_file", var_data("no_such_directory/csp_output_selector_test.csv"));
+
+	EXPECT_FALSE(cm.compute(&handler, &vt));
+}
@@ -0,0 +1,161 @@
+#include <cstring>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "../tcs/CO2_properties.h"
+
+/**
+* Tests for the batched and memoized CO2 property calls: every state must be bit-identical to the
+* single-state CO2_PH and CO2_TP calls, including states on the saturation dome and failed states
+*/
+
+class CO2PropertiesBatchTest : public ::testing::Test
+{
+protected:
+	std::vector<double> v_P, v_H, v_T;
+
+	void SetUp()
+	{
+		// Subcritical isobars across the dome, so consecutive states share saturation values,
+		// followed by supercritical states and one state outside the property range
+		double P_sub[] = { 4000.0, 6000.0 };
+		for( int j = 0; j < 2; j++ )
+		{
+			for( int i = 0; i < 12; i++ )
+			{
+				v_P.push_back(P_sub[j]);
+				v_H.push_back(150.0 + 30.0*i);
+			}
+		}
+		for( int i = 0; i < 8; i++ )
+		{
+			v_P.push_back(8000.0 + 2000.0*i);
+			v_H.push_back(250.0 + 60.0*i);
+		}
+		v_P.push_back(8000.0);
+		v_H.push_back(-1.E4);
+
+		double T[] = { 250.0, 280.0, 304.0, 310.0, 350.0, 500.0, 800.0, 1200.0 };
+		v_T.assign(T, T + 8);
+	}
+
+	static void clear(CO2_state *state)
+	{
+		memset(state, 0, sizeof(CO2_state));
+	}
+
+	static bool is_identical(const CO2_state &a, const CO2_state &b)
+	{
+		return memcmp(&a, &b, sizeof(CO2_state)) == 0;
+	}
+};
+
+TEST_F(CO2PropertiesBatchTest, PHBatchMatchesSingleCalls_CO2_properties)
+{
+	int n = (int)v_P.size();
+	std::vector<CO2_state> v_states(n);
+	std::vector<int> v_codes(n, -1);
+	for( int i = 0; i < n; i++ )
+		clear(&v_states[i]);
+
+	int first_code = CO2_PH_batch(n, &v_P[0], &v_H[0], &v_states[0], &v_codes[0]);
+
+	int first_code_direct = 0;
+	int n_two_phase = 0;
+	for( int i = 0; i < n; i++ )
+	{
+		CO2_state state;
+		clear(&state);
+		int code = CO2_PH(v_P[i], v_H[i], &state);
+		if( code != 0 && first_code_direct == 0 )
+			first_code_direct = code;
+
+		EXPECT_EQ(v_codes[i], code) << "state " << i;
+		if( code == 0 )
+		{
+			EXPECT_TRUE(is_identical(v_states[i], state)) << "state " << i << ": P = " << v_P[i] << ", H = " << v_H[i];
+			if( state.qual > 0.0 && state.qual < 1.0 )
+				n_two_phase++;
+		}
+	}
+	EXPECT_EQ(first_code, first_code_direct);
+	EXPECT_NE(first_code, 0);
+	EXPECT_GT(n_two_phase, 4);
+}
+
+TEST_F(CO2PropertiesBatchTest, TPBatchMatchesSingleCalls_CO2_properties)
+{
+	std::vector<double> v_T_in, v_P_in;
+	double P[] = { 5000.0, 7377.0, 9000.0, 25000.0 };
+	for( int j = 0; j < 4; j++ )
+	{
+		for( size_t i = 0; i < v_T.size(); i++ )
+		{
+			v_T_in.push_back(v_T[i]);
+			v_P_in.push_back(P[j]);
+		}
+	}
+
+	int n = (int)v_T_in.size();
+	std::vector<CO2_state> v_states(n);
+	std::vector<int> v_codes(n, -1);
+	for( int i = 0; i < n; i++ )
+		clear(&v_states[i]);
+
+	CO2_TP_batch(n, &v_T_in[0], &v_P_in[0], &v_states[0], &v_codes[0]);
+
+	for( int i = 0; i < n; i++ )
+	{
+		CO2_state state;
+		clear(&state);
+		int code = CO2_TP(v_T_in[i], v_P_in[i], &state);
+
+		EXPECT_EQ(v_codes[i], code) << "state " << i;
+		if( code == 0 )
+			EXPECT_TRUE(is_identical(v_states[i], state)) << "state " << i << ": T = " << v_T_in[i] << ", P = " << v_P_in[i];
+	}
+}
+
+TEST_F(CO2PropertiesBatchTest, MemoMatchesSingleCalls_CO2_properties)
+{
+	reset_CO2_memo_stats();
+
+	int n_calls = 0;
+	for( int pass = 0; pass < 2; pass++ )
+	{
+		for( size_t i = 0; i < v_T.size(); i++ )
+		{
+			CO2_state state, state_memo;
+			clear(&state);
+			clear(&state_memo);
+			int code = CO2_TP(v_T[i], 9000.0, &state);
+			EXPECT_EQ(CO2_TP_memo(v_T[i], 9000.0, &state_memo), code);
+			if( code == 0 )
+				EXPECT_TRUE(is_identical(state_memo, state)) << "T = " << v_T[i] << ", pass " << pass;
+
+			clear(&state);
+			clear(&state_memo);
+			code = CO2_PH(v_P[i], v_H[i], &state);
+			EXPECT_EQ(CO2_PH_memo(v_P[i], v_H[i], &state_memo), code);
+			if( code == 0 )
+				EXPECT_TRUE(is_identical(state_memo, state)) << "P = " << v_P[i] << ", H = " << v_H[i] << ", pass " << pass;
+
+			n_calls += 2;
+		}
+	}
+
+	// The second pass repeats the first one exactly, so it is answered from the memo
+	CO2_memo_stats stats;
+	get_CO2_memo_stats(&stats);
+	EXPECT_EQ(stats.n_memo_calls, n_calls);
+	EXPECT_GE(stats.n_memo_hits, n_calls / 2);
+
+	// A state next to a memoized one is solved, not copied
+	CO2_state state, state_memo;
+	clear(&state);
+	clear(&state_memo);
+	ASSERT_EQ(CO2_TP(v_T[4] + 1.E-9, 9000.0, &state), 0);
+	ASSERT_EQ(CO2_TP_memo(v_T[4] + 1.E-9, 9000.0, &state_memo), 0);
+	EXPECT_TRUE(is_identical(state_memo, state));
+}
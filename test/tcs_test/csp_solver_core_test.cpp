@@ -281,3 +281,93 @@ protected:
 		solver->Ssimulate(sim_setup);
 	}
 };
+
+
+/**
+ * Per-operating-mode profiling must count the monotonic solves inside the component models,
+ * not only the operating mode's own solve
+ */
+
+// Stands in for a component model that solves for its own state each time it's called
+class C_profile_component_eq : public C_monotonic_equation
+{
+public:
+	virtual int operator()(double x, double *y)
+	{
+		*y = x*x*x + x;
+		return 0;
+	}
+};
+
+class C_profile_op_mode_eq : public C_monotonic_equation
+{
+public:
+	C_profile_component_eq mc_component_eq;
+	int m_n_iter_component;
+	int m_n_eq_calls_component;
+
+	C_profile_op_mode_eq()
+	{
+		m_n_iter_component = m_n_eq_calls_component = 0;
+	}
+
+	virtual int operator()(double x, double *y)
+	{
+		C_monotonic_eq_solver c_solver(mc_component_eq);
+		c_solver.settings(1.E-8, 50, -100., 100., true);
+		double z, tol;
+		int iter;
+		c_solver.solve(0.0, 1.0, x, z, tol, iter);
+		m_n_iter_component += iter;
+		m_n_eq_calls_component += c_solver.get_n_eq_calls();
+
+		*y = z + x;
+		return 0;
+	}
+};
+
+class CspSolverOpModeProfileTest : public ::testing::Test{
+protected:
+	C_csp_solver::C_csp_solver_kernel kernel;
+	C_monotonic_eq_solver_cache cache;
+};
+
+TEST_F(CspSolverOpModeProfileTest, CountsComponentSolves_csp_solver_core){
+	kernel.init_op_mode_profile(4);
+	ASSERT_TRUE(kernel.is_op_mode_profile());
+
+	// Operating mode 2 converges after an operating mode solve, operating mode 1 is rejected without solving
+	C_profile_op_mode_eq c_eq;
+	C_monotonic_eq_solver c_solver(c_eq);
+	c_solver.settings(1.E-6, 50, -100., 100., true);
+	double x_solved, tol_solved;
+	int iter_solved;
+
+	kernel.op_mode_profile_start(2);
+	int code = cache.solve("profile_op_mode", c_solver, 0.5, 1.0, 12.0, x_solved, tol_solved, iter_solved);
+	kernel.op_mode_profile_end(code == C_monotonic_eq_solver::CONVERGED);
+
+	kernel.op_mode_profile_start(1);
+	kernel.op_mode_profile_end(false);
+
+	ASSERT_EQ(code, C_monotonic_eq_solver::CONVERGED);
+	EXPECT_NEAR(x_solved, 10.0, 1.E-4);
+
+	const std::vector<C_csp_solver::S_op_mode_profile> & v_prof = kernel.get_op_mode_profile();
+	ASSERT_EQ(v_prof.size(), (size_t)4);
+
+	EXPECT_EQ(v_prof[2].m_n_calls, 1);
+	EXPECT_EQ(v_prof[2].m_n_rejected, 0);
+	EXPECT_GT(c_eq.m_n_iter_component, iter_solved);
+	EXPECT_EQ(v_prof[2].m_n_iter, iter_solved + c_eq.m_n_iter_component);
+	EXPECT_EQ(v_prof[2].m_n_eq_calls, c_solver.get_n_eq_calls() + c_eq.m_n_eq_calls_component);
+	EXPECT_GE(v_prof[2].m_time, 0.0);
+
+	EXPECT_EQ(v_prof[1].m_n_calls, 1);
+	EXPECT_EQ(v_prof[1].m_n_rejected, 1);
+	EXPECT_EQ(v_prof[1].m_n_iter, 0);
+	EXPECT_EQ(v_prof[1].m_n_eq_calls, 0);
+
+	EXPECT_EQ(v_prof[0].m_n_calls, 0);
+	EXPECT_EQ(v_prof[3].m_n_calls, 0);
+}
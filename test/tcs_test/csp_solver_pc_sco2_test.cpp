@@ -0,0 +1,168 @@
+#include <limits>
+#include <cmath>
+#include <cstdio>
+
+#include <gtest/gtest.h>
+
+#include "../tcs/csp_solver_pc_sco2.h"
+
+/**
+* Tests for the sCO2 off-design surface: a node whose solve throws must be stored as a failed node,
+* so queries in cells around it are solved directly instead of the exception escaping get_od_point,
+* and saved solutions must only be reused for the same design
+*/
+
+class C_linear_od_function : public C_sco2_od_surface::C_od_function
+{
+	// Linear in every input, so accepted cells interpolate it exactly
+
+public:
+	double m_T_htf_hot_throw;	//[K] Solves throw above this HTF temperature
+	int m_n_calls;
+	double m_T_htf_hot_last;	//[K] Inputs of the most recent solve
+	double m_T_amb_last;		//[K]
+
+	C_linear_od_function()
+	{
+		m_T_htf_hot_throw = std::numeric_limits<double>::infinity();
+		m_n_calls = 0;
+		m_T_htf_hot_last = m_T_amb_last = std::numeric_limits<double>::quiet_NaN();
+	}
+
+	virtual int operator()(double T_htf_hot /*K*/, double m_dot_htf_ND /*-*/, double T_amb /*K*/, C_sco2_od_surface::S_od_point & od_point)
+	{
+		m_n_calls++;
+		m_T_htf_hot_last = T_htf_hot;
+		m_T_amb_last = T_amb;
+
+		if( T_htf_hot > m_T_htf_hot_throw )
+			throw(C_csp_exception("HTF temperature out of range", "C_linear_od_function"));
+
+		od_point.m_W_dot_net = 10.E3*(1.0 + 0.002*(T_htf_hot - 847.0) + 0.5*(m_dot_htf_ND - 1.0) - 0.004*(T_amb - 308.0));
+		od_point.m_eta_thermal = 0.45 + 0.0005*(T_htf_hot - 847.0) - 0.002*(T_amb - 308.0);
+		od_point.m_T_htf_cold = 700.0 + 0.3*(T_htf_hot - 847.0) + 5.0*(m_dot_htf_ND - 1.0);
+
+		return 0;
+	}
+};
+
+class Sco2OdSurfaceTest : public ::testing::Test
+{
+protected:
+	C_linear_od_function c_od;
+	C_sco2_od_surface c_surface;
+	C_sco2_od_surface::S_params s_params;
+
+	void SetUp()
+	{
+		s_params.m_T_htf_hot_des = 847.0;	//[K]
+		s_params.m_T_htf_cold_des = 700.0;	//[K]
+		s_params.m_T_amb_des = 308.0;		//[K]
+		s_params.m_W_dot_net_des = 10.E3;	//[kWe]
+		s_params.m_eta_des = 0.45;			//[-]
+	}
+};
+
+TEST_F(Sco2OdSurfaceTest, AcceptedCellsInterpolate_csp_solver_pc_sco2)
+{
+	c_surface.init(&c_od, s_params, "");
+
+	C_sco2_od_surface::S_od_point od_point;
+	ASSERT_EQ(c_surface.get_od_point(851.3, 1.03, 309.2, od_point), 0);
+
+	C_sco2_od_surface::S_od_point od_direct;
+	C_linear_od_function c_direct;
+	c_direct(851.3, 1.03, 309.2, od_direct);
+	EXPECT_NEAR(od_point.m_W_dot_net, od_direct.m_W_dot_net, 1.E-6*s_params.m_W_dot_net_des);
+	EXPECT_NEAR(od_point.m_eta_thermal, od_direct.m_eta_thermal, 1.E-9);
+	EXPECT_NEAR(od_point.m_T_htf_cold, od_direct.m_T_htf_cold, 1.E-9);
+
+	// Only the cell corners and center were solved, not the query point
+	EXPECT_EQ(c_surface.get_n_solved(), 9);
+	EXPECT_NE(c_od.m_T_htf_hot_last, 851.3);
+}
+
+TEST_F(Sco2OdSurfaceTest, ThrowingNodeFallsBackToDirectSolve_csp_solver_pc_sco2)
+{
+	// The corners of cell [847, 857] K at 857 K throw, and the cell can't be split
+	s_params.m_n_levels = 0;
+	c_od.m_T_htf_hot_throw = 855.0;
+	c_surface.init(&c_od, s_params, "");
+
+	C_sco2_od_surface::S_od_point od_point;
+	int od_code = -1;
+	ASSERT_NO_THROW(od_code = c_surface.get_od_point(851.3, 1.03, 309.2, od_point));
+	ASSERT_EQ(od_code, 0);
+
+	// The query point itself was solved
+	EXPECT_EQ(c_od.m_T_htf_hot_last, 851.3);
+	EXPECT_EQ(c_od.m_T_amb_last, 309.2);
+	C_sco2_od_surface::S_od_point od_direct;
+	C_linear_od_function c_direct;
+	c_direct(851.3, 1.03, 309.2, od_direct);
+	EXPECT_EQ(od_point.m_W_dot_net, od_direct.m_W_dot_net);
+	EXPECT_EQ(od_point.m_eta_thermal, od_direct.m_eta_thermal);
+	EXPECT_EQ(od_point.m_T_htf_cold, od_direct.m_T_htf_cold);
+	EXPECT_EQ(c_surface.get_n_solved(), 10);
+
+	// The cell state is stored, so the next query in the cell solves only its own point
+	int n_calls = c_od.m_n_calls;
+	ASSERT_EQ(c_surface.get_od_point(849.0, 1.05, 310.0, od_point), 0);
+	EXPECT_EQ(c_od.m_n_calls, n_calls + 1);
+	EXPECT_EQ(c_od.m_T_htf_hot_last, 849.0);
+
+	// A neighbouring cell without throwing nodes is still interpolated
+	n_calls = c_od.m_n_calls;
+	ASSERT_EQ(c_surface.get_od_point(843.0, 1.03, 309.2, od_point), 0);
+	EXPECT_NE(c_od.m_T_htf_hot_last, 843.0);
+	EXPECT_NEAR(od_point.m_T_htf_cold, 700.0 + 0.3*(843.0 - 847.0) + 5.0*0.03, 1.E-9);
+	EXPECT_EQ(c_od.m_n_calls, n_calls + 5);
+}
+
+TEST_F(Sco2OdSurfaceTest, DirectSolveExceptionReachesCaller_csp_solver_pc_sco2)
+{
+	// Like a solve without the surface, an exception at the query point itself is the caller's to handle
+	s_params.m_n_levels = 0;
+	c_od.m_T_htf_hot_throw = 855.0;
+	c_surface.init(&c_od, s_params, "");
+
+	C_sco2_od_surface::S_od_point od_point;
+	EXPECT_THROW(c_surface.get_od_point(856.0, 1.03, 309.2, od_point), C_csp_exception);
+}
+
+TEST_F(Sco2OdSurfaceTest, FileReusedOnlyForSameDesign_csp_solver_pc_sco2)
+{
+	const char *file_name = "csp_solver_pc_sco2_test_surface.txt";
+	std::remove(file_name);
+
+	// Each surface closes its file when it's destroyed
+	C_sco2_od_surface::S_od_point od_point;
+	s_params.m_design_id = "recomp eta 0.89 0.89 0.9 P_high 25000";
+	{
+		C_sco2_od_surface c_first;
+		c_first.init(&c_od, s_params, file_name);
+		ASSERT_EQ(c_first.get_od_point(851.3, 1.03, 309.2, od_point), 0);
+		EXPECT_EQ(c_first.get_n_solved(), 9);
+	}
+
+	// The same design reads the solutions back
+	{
+		C_sco2_od_surface c_reuse;
+		c_reuse.init(&c_od, s_params, file_name);
+		EXPECT_EQ(c_reuse.get_n_loaded(), 9);
+		ASSERT_EQ(c_reuse.get_od_point(851.3, 1.03, 309.2, od_point), 0);
+		EXPECT_EQ(c_reuse.get_n_solved(), 0);
+	}
+
+	// A design that differs only in a parameter outside the lattice and design point starts over
+	s_params.m_design_id = "recomp eta 0.89 0.89 0.91 P_high 25000";
+	{
+		C_sco2_od_surface c_new_design;
+		c_new_design.init(&c_od, s_params, file_name);
+		EXPECT_EQ(c_new_design.get_n_loaded(), 0);
+		ASSERT_EQ(c_new_design.get_od_point(851.3, 1.03, 309.2, od_point), 0);
+		EXPECT_EQ(c_new_design.get_n_solved(), 9);
+	}
+
+	std::remove(file_name);
+}
@@ -0,0 +1,237 @@
+#include <limits>
+#include <cmath>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+#include "../tcs/numeric_solvers.h"
+#include "../tcs/csp_solver_util.h"
+
+/**
+* Tests for the warm-start solver cache: solutions must match a direct solve,
+* and a warm start that fails must fall back to the caller's guesses. Also checks
+* that the per-thread solver totals count solves nested inside equations
+*/
+
+class C_cubic_mono_eq : public C_monotonic_equation
+{
+public:
+	double m_x_throw;	//[-] Equation throws for x above this value
+
+	C_cubic_mono_eq()
+	{
+		m_x_throw = std::numeric_limits<double>::infinity();
+	}
+
+	virtual int operator()(double x, double *y)
+	{
+		if( x > m_x_throw )
+			throw(C_csp_exception("x out of range", "C_cubic_mono_eq"));
+
+		*y = x*x*x + x;
+		return 0;
+	}
+};
+
+// Like a component model called from an operating mode equation: each call runs its own solve
+class C_nested_mono_eq : public C_monotonic_equation
+{
+public:
+	C_cubic_mono_eq mc_inner_eq;
+	int m_n_iter_inner;			//[-] Iterations of the nested solves
+	int m_n_eq_calls_inner;		//[-] Equation calls of the nested solves
+
+	C_nested_mono_eq()
+	{
+		m_n_iter_inner = m_n_eq_calls_inner = 0;
+	}
+
+	virtual int operator()(double x, double *y)
+	{
+		// y = z(x) + x, where z^3 + z = x
+		C_monotonic_eq_solver c_solver(mc_inner_eq);
+		c_solver.settings(1.E-8, 50, -100., 100., true);
+		double z = std::numeric_limits<double>::quiet_NaN();
+		double tol = std::numeric_limits<double>::quiet_NaN();
+		int iter = -1;
+		int code = c_solver.solve(0.0, 1.0, x, z, tol, iter);
+		m_n_iter_inner += iter;
+		m_n_eq_calls_inner += c_solver.get_n_eq_calls();
+		if( code != C_monotonic_eq_solver::CONVERGED )
+			return -1;
+
+		*y = z + x;
+		return 0;
+	}
+};
+
+class MonoEqSolverCacheTest : public ::testing::Test
+{
+protected:
+	C_cubic_mono_eq c_eq;
+	C_monotonic_eq_solver_cache c_cache;
+	double x_solved, tol_solved;
+	int iter_solved;
+
+	void SetUp()
+	{
+		x_solved = tol_solved = std::numeric_limits<double>::quiet_NaN();
+		iter_solved = -1;
+	}
+
+	int solve_direct(double y_target, double &x)
+	{
+		C_monotonic_eq_solver c_solver(c_eq);
+		c_solver.settings(1.E-6, 50, -100., 100., true);
+		double tol = std::numeric_limits<double>::quiet_NaN();
+		int iter = -1;
+		return c_solver.solve(0.0, 1.0, y_target, x, tol, iter);
+	}
+
+	int solve_cached(const char *eq_name, double y_target, double x_guess_1 = 0.0, double x_guess_2 = 1.0)
+	{
+		C_monotonic_eq_solver c_solver(c_eq);
+		c_solver.settings(1.E-6, 50, -100., 100., true);
+		return c_cache.solve(eq_name, c_solver, x_guess_1, x_guess_2, y_target, x_solved, tol_solved, iter_solved);
+	}
+};
+
+TEST_F(MonoEqSolverCacheTest, DisabledPassesThrough_numeric_solvers)
+{
+	double x_direct = std::numeric_limits<double>::quiet_NaN();
+	ASSERT_EQ(solve_direct(10.0, x_direct), C_monotonic_eq_solver::CONVERGED);
+
+	int n_eq_calls_start = C_monotonic_eq_solver::get_n_eq_calls_thread_total();
+	ASSERT_EQ(solve_cached("cubic", 10.0), C_monotonic_eq_solver::CONVERGED);
+	EXPECT_EQ(x_solved, x_direct);
+	EXPECT_GT(C_monotonic_eq_solver::get_n_eq_calls_thread_total(), n_eq_calls_start);
+
+	std::vector<C_monotonic_eq_solver_cache::S_eq_class_stats> v_stats;
+	c_cache.get_stats(v_stats);
+	EXPECT_EQ(v_stats.size(), (size_t)0);
+}
+
+TEST_F(MonoEqSolverCacheTest, WarmStartMatchesDirectSolve_numeric_solvers)
+{
+	c_cache.enable(true);
+	c_cache.set_key(3);
+
+	int n_calls_direct = 0;
+	for( int i = 0; i < 20; i++ )
+	{
+		double y_target = 10.0 + 0.1*i;
+
+		double x_direct = std::numeric_limits<double>::quiet_NaN();
+		C_monotonic_eq_solver c_solver(c_eq);
+		c_solver.settings(1.E-6, 50, -100., 100., true);
+		double tol = std::numeric_limits<double>::quiet_NaN();
+		int iter = -1;
+		ASSERT_EQ(c_solver.solve(0.0, 1.0, y_target, x_direct, tol, iter), C_monotonic_eq_solver::CONVERGED);
+		n_calls_direct += c_solver.get_n_eq_calls();
+
+		ASSERT_EQ(solve_cached("cubic", y_target), C_monotonic_eq_solver::CONVERGED) << "step " << i;
+		EXPECT_NEAR(x_solved, x_direct, 1.E-5) << "step " << i;
+	}
+
+	std::vector<C_monotonic_eq_solver_cache::S_eq_class_stats> v_stats;
+	c_cache.get_stats(v_stats);
+	ASSERT_EQ(v_stats.size(), (size_t)1);
+	EXPECT_EQ(v_stats[0].m_eq_name, "cubic");
+	EXPECT_EQ(v_stats[0].m_key, 3);
+	EXPECT_EQ(v_stats[0].m_n_solves, 20);
+	EXPECT_EQ(v_stats[0].m_n_warm_starts, 19);
+	EXPECT_EQ(v_stats[0].m_n_warm_converged, 19);
+	EXPECT_LT(v_stats[0].m_n_eq_calls, n_calls_direct);
+}
+
+TEST_F(MonoEqSolverCacheTest, EntriesKeyedByNameAndKey_numeric_solvers)
+{
+	c_cache.enable(true);
+
+	c_cache.set_key(1);
+	solve_cached("cubic_a", 10.0);
+	solve_cached("cubic_b", 10.0);
+	c_cache.set_key(2);
+	solve_cached("cubic_a", 10.0);
+	solve_cached("cubic_a", 10.0);
+
+	std::vector<C_monotonic_eq_solver_cache::S_eq_class_stats> v_stats;
+	c_cache.get_stats(v_stats);
+	ASSERT_EQ(v_stats.size(), (size_t)3);
+	for( size_t i = 0; i < v_stats.size(); i++ )
+	{
+		if( v_stats[i].m_eq_name == "cubic_a" && v_stats[i].m_key == 2 )
+		{
+			EXPECT_EQ(v_stats[i].m_n_solves, 2);
+			EXPECT_EQ(v_stats[i].m_n_warm_starts, 1);
+		}
+		else
+		{
+			EXPECT_EQ(v_stats[i].m_n_solves, 1);
+			EXPECT_EQ(v_stats[i].m_n_warm_starts, 0);
+		}
+	}
+
+	c_cache.reset();
+	c_cache.get_stats(v_stats);
+	EXPECT_EQ(v_stats.size(), (size_t)0);
+}
+
+TEST_F(MonoEqSolverCacheTest, FailedWarmStartFallsBack_numeric_solvers)
+{
+	c_cache.enable(true);
+
+	// y = 10 at x = 2
+	ASSERT_EQ(solve_cached("cubic", 10.0), C_monotonic_eq_solver::CONVERGED);
+	EXPECT_NEAR(x_solved, 2.0, 1.E-5);
+
+	// Warm start begins at x = 2, where the equation now throws, so the cold guesses must be used
+	c_eq.m_x_throw = 1.9;
+	ASSERT_EQ(solve_cached("cubic", 2.0, 0.0, 0.5), C_monotonic_eq_solver::CONVERGED);
+	EXPECT_NEAR(x_solved, 1.0, 1.E-5);
+
+	std::vector<C_monotonic_eq_solver_cache::S_eq_class_stats> v_stats;
+	c_cache.get_stats(v_stats);
+	ASSERT_EQ(v_stats.size(), (size_t)1);
+	EXPECT_EQ(v_stats[0].m_n_warm_starts, 1);
+	EXPECT_EQ(v_stats[0].m_n_warm_converged, 0);
+
+	// Without a warm start, an exception reaches the caller as before
+	c_cache.reset();
+	c_eq.m_x_throw = -1.0;
+	EXPECT_THROW(solve_cached("cubic", 2.0), C_csp_exception);
+}
+
+TEST_F(MonoEqSolverCacheTest, ThreadTotalsCountNestedSolves_numeric_solvers)
+{
+	C_nested_mono_eq c_nested;
+	int n_iter_start = C_monotonic_eq_solver::get_n_iter_thread_total();
+	int n_eq_calls_start = C_monotonic_eq_solver::get_n_eq_calls_thread_total();
+
+	C_monotonic_eq_solver c_solver(c_nested);
+	c_solver.settings(1.E-6, 50, -100., 100., true);
+	ASSERT_EQ(c_cache.solve("nested", c_solver, 0.5, 1.0, 12.0, x_solved, tol_solved, iter_solved), C_monotonic_eq_solver::CONVERGED);
+	EXPECT_NEAR(x_solved, 10.0, 1.E-4);		// z = 2
+
+	// Every nested solve ran once per outer equation call
+	EXPECT_GT(iter_solved, 0);
+	EXPECT_GT(c_nested.m_n_iter_inner, 0);
+	EXPECT_GE(c_nested.m_n_eq_calls_inner, 2 * c_solver.get_n_eq_calls());
+	EXPECT_EQ(C_monotonic_eq_solver::get_n_iter_thread_total() - n_iter_start, iter_solved + c_nested.m_n_iter_inner);
+	EXPECT_EQ(C_monotonic_eq_solver::get_n_eq_calls_thread_total() - n_eq_calls_start, c_solver.get_n_eq_calls() + c_nested.m_n_eq_calls_inner);
+
+	// Solves on other threads aren't added to this thread's totals
+	n_iter_start = C_monotonic_eq_solver::get_n_iter_thread_total();
+	n_eq_calls_start = C_monotonic_eq_solver::get_n_eq_calls_thread_total();
+	int n_eq_calls_other = -1;
+	std::thread t([&]()
+	{
+		double x;
+		solve_direct(10.0, x);
+		n_eq_calls_other = C_monotonic_eq_solver::get_n_eq_calls_thread_total();
+	});
+	t.join();
+	EXPECT_GT(n_eq_calls_other, 0);
+	EXPECT_EQ(C_monotonic_eq_solver::get_n_iter_thread_total(), n_iter_start);
+	EXPECT_EQ(C_monotonic_eq_solver::get_n_eq_calls_thread_total(), n_eq_calls_start);
+}
@@ -0,0 +1,249 @@
+#include <vector>
+#include <cmath>
+#include <limits>
+
+#include <gtest/gtest.h>
+
+#include "../tcs/sam_csp_util.h"
+#include "../tcs/htf_props.h"
+
+/**
+* Tests for the HCE heat loss tables: interpolated heat loss and absorber-to-envelope heat transfer must
+* match the full evacuated receiver energy balance between nodes, points outside of a table must be left
+* to the full energy balance, nodes that fail to solve must disable their table, and both outputs must
+* drive the grid refinement
+*/
+
+// Full evacuated receiver energy balance for one HCE type with an intact (variant 0) and a broken (variant 1) glass envelope
+class C_evac_receiver_point : public C_hce_heat_loss_table::C_point_solver
+{
+	Evacuated_Receiver mc_receiver;
+	HTFProperties mc_htf;
+	HTFProperties mc_annulus_gas;
+	AbsorberProps mc_absorber;
+	emit_table mc_eps_3;
+
+public:
+	C_evac_receiver_point()
+	{
+		mc_htf.SetFluid(HTFProperties::Therminol_VP1);
+		mc_annulus_gas.SetFluid(HTFProperties::Hydrogen_ideal);
+		mc_absorber.setMaterial(AbsorberProps::Mat_304L);
+
+		// Selective coating emittance rises with temperature
+		util::matrix_t<double> eps_3(2, 3);
+		eps_3(0, 0) = 100.0; eps_3(0, 1) = 300.0; eps_3(0, 2) = 500.0;	//[C]
+		eps_3(1, 0) = 0.06; eps_3(1, 1) = 0.08; eps_3(1, 2) = 0.13;		//[-]
+		util::matrix_t<double> eps_3_broken(1, 1, 0.09);
+		mc_eps_3.init(1, 4);
+		mc_eps_3.addTable(&eps_3);
+		mc_eps_3.addTable(&eps_3_broken);
+
+		util::matrix_t<bool> glazing_intact(1, 2, true);
+		glazing_intact(0, 1) = false;
+		util::matrix_t<double> P_a(1, 2, 1.E-4), D_5(1, 2, 0.12), D_4(1, 2, 0.115), D_3(1, 2, 0.07), D_2(1, 2, 0.066),
+			D_p(1, 2, 0.0), dirt(1, 2, 0.98), shadowing(1, 2, 0.96), tau(1, 2, 0.963), alpha_abs(1, 2, 0.96), alpha_env(1, 2, 0.02),
+			eps_4(1, 2, 0.86), eps_5(1, 2, 0.86), flow_type(1, 2, 1.0);
+		util::matrix_t<double> col_opt_eff(1, 1, 1.0), L_act(1, 1, 12.0), A_cs(1, 1, 0.25*3.14159265*0.066*0.066), D_h(1, 1, 0.066);
+		util::matrix_t<HTFProperties*> annulus_gas(1, 2, &mc_annulus_gas);
+		util::matrix_t<AbsorberProps*> absorber(1, 2, &mc_absorber);
+
+		mc_receiver.Initialize_Receiver(glazing_intact, P_a, D_5, D_4, D_3, D_2, D_p, col_opt_eff, dirt, shadowing, tau,
+			alpha_abs, alpha_env, &mc_eps_3, annulus_gas, absorber, eps_4, eps_5, L_act, &mc_htf, A_cs, D_h, flow_type);
+	}
+
+	virtual int operator()(int hn, int hv, const double *x, double *y)
+	{
+		double q_12conv, c_1ave, rho_1ave;
+		mc_receiver.EvacReceiver(x[C_hce_heat_loss_table::E_T_HTF], 2.0, x[C_hce_heat_loss_table::E_T_AMB],
+			x[C_hce_heat_loss_table::E_T_AMB] - x[C_hce_heat_loss_table::E_DT_SKY], x[C_hce_heat_loss_table::E_V_WIND],
+			x[C_hce_heat_loss_table::E_P_AMB], x[C_hce_heat_loss_table::E_Q_INC], hn, hv, 0, 0, true, 0, 0.0,
+			y[C_hce_heat_loss_table::E_Q_HEATLOSS], q_12conv, y[C_hce_heat_loss_table::E_Q_34TOT], c_1ave, rho_1ave);
+		return 0;
+	}
+};
+
+// Heat loss linear in every input, absorber-to-envelope heat transfer quadratic in wind speed. Fails above m_T_fail
+class C_analytic_point : public C_hce_heat_loss_table::C_point_solver
+{
+public:
+	double m_T_fail;	//[K]
+
+	C_analytic_point()
+	{
+		m_T_fail = std::numeric_limits<double>::infinity();
+	}
+
+	virtual int operator()(int hn, int hv, const double *x, double *y)
+	{
+		if( x[C_hce_heat_loss_table::E_T_HTF] > m_T_fail )
+			return -1;
+
+		double v = x[C_hce_heat_loss_table::E_V_WIND];
+		y[C_hce_heat_loss_table::E_Q_HEATLOSS] = 100.0 + 0.5*(x[C_hce_heat_loss_table::E_T_HTF] - 500.0) + 2.0*v;
+		y[C_hce_heat_loss_table::E_Q_34TOT] = 80.0 + 3.0*v*v;
+		return 0;
+	}
+};
+
+class HceHeatLossTableTest : public ::testing::Test
+{
+protected:
+	C_hce_heat_loss_table c_table;
+	util::matrix_t<bool> is_used;
+
+	void SetUp()
+	{
+		C_hce_heat_loss_table::S_axis *axes = c_table.ms_axes;
+		axes[C_hce_heat_loss_table::E_T_HTF].m_min = 400.0;	axes[C_hce_heat_loss_table::E_T_HTF].m_max = 660.0;	axes[C_hce_heat_loss_table::E_T_HTF].m_n = 6;
+		axes[C_hce_heat_loss_table::E_Q_INC].m_min = 0.0;	axes[C_hce_heat_loss_table::E_Q_INC].m_max = 4000.0;	axes[C_hce_heat_loss_table::E_Q_INC].m_n = 3;
+		axes[C_hce_heat_loss_table::E_T_AMB].m_min = 263.0;	axes[C_hce_heat_loss_table::E_T_AMB].m_max = 318.0;	axes[C_hce_heat_loss_table::E_T_AMB].m_n = 3;
+		axes[C_hce_heat_loss_table::E_V_WIND].m_min = 0.11;	axes[C_hce_heat_loss_table::E_V_WIND].m_max = 20.0;	axes[C_hce_heat_loss_table::E_V_WIND].m_n = 3;
+		axes[C_hce_heat_loss_table::E_DT_SKY].m_min = 0.0;	axes[C_hce_heat_loss_table::E_DT_SKY].m_max = 40.0;	axes[C_hce_heat_loss_table::E_DT_SKY].m_n = 2;
+		axes[C_hce_heat_loss_table::E_P_AMB].m_min = 80000.0;	axes[C_hce_heat_loss_table::E_P_AMB].m_max = 102000.0;	axes[C_hce_heat_loss_table::E_P_AMB].m_n = 2;
+
+		is_used.resize_fill(1, 2, true);
+	}
+
+	// Deterministic points spread over the table, away from the nodes
+	void off_node_point(int k, double *x)
+	{
+		for( int i = 0; i < C_hce_heat_loss_table::E_N_AXES; i++ )
+		{
+			double f = fmod(0.1234 + k*(0.6180339887 + 0.1*i) + 0.37*i, 1.0);
+			x[i] = c_table.ms_axes[i].m_min + f*(c_table.ms_axes[i].m_max - c_table.ms_axes[i].m_min);
+		}
+	}
+};
+
+TEST_F(HceHeatLossTableTest, TableMatchesReceiverEnergyBalance_sam_csp_util)
+{
+	std::vector<C_evac_receiver_point> v_points(2);
+	std::vector<C_hce_heat_loss_table::C_point_solver*> v_solvers;
+	for( size_t i = 0; i < v_points.size(); i++ )
+		v_solvers.push_back(&v_points[i]);
+
+	c_table.generate(is_used, v_solvers);
+
+	// Forced convection correlations for the bare absorber jump between Reynolds number ranges, so the broken glazing
+	//    table may be rejected and left to the full energy balance. If it's accepted it must be accurate.
+	ASSERT_TRUE(c_table.is_valid(0, 0)) << "max error " << c_table.get_max_error(0, 0);
+
+	C_evac_receiver_point c_full;
+	for( int hv = 0; hv < 2; hv++ )
+	{
+		if( !c_table.is_valid(0, hv) )
+			continue;
+		EXPECT_GT(c_table.get_n_nodes(0, hv), 6 * 3 * 3 * 3 * 2 * 2) << "variant " << hv;
+		EXPECT_LE(c_table.get_n_nodes(0, hv), c_table.m_n_nodes_max) << "variant " << hv;
+
+		int n_outside_tol = 0;
+		int n_points = 500;
+		for( int k = 0; k < n_points; k++ )
+		{
+			double x[C_hce_heat_loss_table::E_N_AXES], y_table[C_hce_heat_loss_table::E_N_OUTPUTS], y_full[C_hce_heat_loss_table::E_N_OUTPUTS];
+			off_node_point(k, x);
+			ASSERT_TRUE(c_table.evaluate(0, hv, x, y_table));
+			ASSERT_EQ(c_full(0, hv, x, y_full), 0);
+
+			for( int j = 0; j < C_hce_heat_loss_table::E_N_OUTPUTS; j++ )
+			{
+				double tol = c_table.m_tol_abs + c_table.m_tol_rel*fabs(y_full[j]);
+				if( fabs(y_table[j] - y_full[j]) > tol )
+					n_outside_tol++;
+				EXPECT_NEAR(y_table[j], y_full[j], 3.0*tol) << "variant " << hv << " output " << j << " point " << k;
+			}
+		}
+		// The check points only sample the table, so allow a few points just outside the tolerance
+		EXPECT_LT(n_outside_tol, n_points / 50) << "variant " << hv;
+	}
+}
+
+TEST_F(HceHeatLossTableTest, OutOfRangeFallsBack_sam_csp_util)
+{
+	C_analytic_point c_point;
+	std::vector<C_hce_heat_loss_table::C_point_solver*> v_solvers(1, &c_point);
+	is_used(0, 1) = false;
+	c_table.generate(is_used, v_solvers);
+	ASSERT_TRUE(c_table.is_valid(0, 0));
+
+	double x[C_hce_heat_loss_table::E_N_AXES], y[C_hce_heat_loss_table::E_N_OUTPUTS];
+	for( int i = 0; i < C_hce_heat_loss_table::E_N_AXES; i++ )
+	{
+		const C_hce_heat_loss_table::S_axis & axis = c_table.ms_axes[i];
+		double dx = 1.E-6*(axis.m_max - axis.m_min);
+
+		off_node_point(i, x);
+		x[i] = axis.m_min;
+		EXPECT_TRUE(c_table.evaluate(0, 0, x, y)) << "axis " << i;
+		x[i] = axis.m_max;
+		EXPECT_TRUE(c_table.evaluate(0, 0, x, y)) << "axis " << i;
+		x[i] = axis.m_min - dx;
+		EXPECT_FALSE(c_table.evaluate(0, 0, x, y)) << "axis " << i;
+		x[i] = axis.m_max + dx;
+		EXPECT_FALSE(c_table.evaluate(0, 0, x, y)) << "axis " << i;
+		x[i] = std::numeric_limits<double>::quiet_NaN();
+		EXPECT_FALSE(c_table.evaluate(0, 0, x, y)) << "axis " << i;
+	}
+
+	// No table for unused or unknown HCEs
+	off_node_point(0, x);
+	EXPECT_FALSE(c_table.is_valid(0, 1));
+	EXPECT_FALSE(c_table.evaluate(0, 1, x, y));
+	EXPECT_FALSE(c_table.evaluate(1, 0, x, y));
+	EXPECT_FALSE(c_table.evaluate(0, -1, x, y));
+}
+
+TEST_F(HceHeatLossTableTest, FailedNodesDisableTable_sam_csp_util)
+{
+	C_analytic_point c_point;
+	c_point.m_T_fail = 600.0;	//[K] Inside the HTF temperature range
+	std::vector<C_hce_heat_loss_table::C_point_solver*> v_solvers(1, &c_point);
+	c_table.generate(is_used, v_solvers);
+
+	double x[C_hce_heat_loss_table::E_N_AXES], y[C_hce_heat_loss_table::E_N_OUTPUTS];
+	off_node_point(3, x);
+	x[C_hce_heat_loss_table::E_T_HTF] = 450.0;
+	for( int hv = 0; hv < 2; hv++ )
+	{
+		EXPECT_FALSE(c_table.is_valid(0, hv)) << "variant " << hv;
+		EXPECT_FALSE(c_table.evaluate(0, hv, x, y)) << "variant " << hv;
+	}
+}
+
+TEST_F(HceHeatLossTableTest, BothOutputsDriveRefinement_sam_csp_util)
+{
+	// The heat loss alone is reproduced exactly by the initial grid, q_34tot needs more wind speed nodes
+	C_analytic_point c_point;
+	std::vector<C_hce_heat_loss_table::C_point_solver*> v_solvers(1, &c_point);
+	c_table.generate(is_used, v_solvers);
+	ASSERT_TRUE(c_table.is_valid(0, 0));
+
+	int n_init = 6 * 3 * 3 * 3 * 2 * 2;
+	int n_nodes = c_table.get_n_nodes(0, 0);
+	EXPECT_GT(n_nodes, n_init);
+	// Only the wind speed axis was refined
+	int n_wind = n_nodes / (n_init / 3);
+	EXPECT_EQ(n_nodes % (n_init / 3), 0);
+	EXPECT_EQ((n_wind - 1) % 2, 0);
+
+	for( int k = 0; k < 200; k++ )
+	{
+		double x[C_hce_heat_loss_table::E_N_AXES], y_table[C_hce_heat_loss_table::E_N_OUTPUTS], y_full[C_hce_heat_loss_table::E_N_OUTPUTS];
+		off_node_point(k, x);
+		ASSERT_TRUE(c_table.evaluate(0, 0, x, y_table));
+		c_point(0, 0, x, y_full);
+		EXPECT_NEAR(y_table[C_hce_heat_loss_table::E_Q_HEATLOSS], y_full[C_hce_heat_loss_table::E_Q_HEATLOSS], 1.E-9*y_full[C_hce_heat_loss_table::E_Q_HEATLOSS]);
+		EXPECT_NEAR(y_table[C_hce_heat_loss_table::E_Q_34TOT], y_full[C_hce_heat_loss_table::E_Q_34TOT],
+			c_table.m_tol_abs + c_table.m_tol_rel*y_full[C_hce_heat_loss_table::E_Q_34TOT]);
+	}
+
+	// Without room to refine, the table fails its check instead of returning inaccurate q_34tot
+	C_hce_heat_loss_table c_small;
+	for( int i = 0; i < C_hce_heat_loss_table::E_N_AXES; i++ )
+		c_small.ms_axes[i] = c_table.ms_axes[i];
+	c_small.m_n_nodes_max = n_init;
+	c_small.generate(is_used, v_solvers);
+	EXPECT_FALSE(c_small.is_valid(0, 0));
+	EXPECT_GT(c_small.get_max_error(0, 0), c_small.m_tol_abs);
+}
@@ -0,0 +1,228 @@
+#include <algorithm>
+#include <limits>
+#include <vector>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "../tcs/sco2_recompression_cycle.h"
+
+/**
+* Tests for the fixed high-side pressure optimizations in C_RecompCycle::auto_opt_design: the cases are
+* solved on cycle copies that are reused for the whole optimization, and the design must not depend
+* on thread timing or on the number of threads, and must be at least as good as a serial pressure sweep
+*/
+
+class RecompCycleAutoOptTest : public ::testing::Test
+{
+protected:
+	C_RecompCycle::S_auto_opt_design_parameters ms_par;
+
+	void SetUp()
+	{
+		ms_par.m_W_dot_net = 10.E3;				//[kWe]
+		ms_par.m_T_mc_in = 273.15 + 41.0;		//[K]
+		ms_par.m_T_t_in = 273.15 + 550.0;		//[K]
+		std::vector<double> DP_rel(2, -0.01);	//[-] relative pressure drops
+		ms_par.m_DP_LT = DP_rel;
+		ms_par.m_DP_HT = DP_rel;
+		ms_par.m_DP_PC = DP_rel;
+		ms_par.m_DP_PHX = DP_rel;
+		ms_par.m_UA_rec_total = 5000.0;			//[kW/K]
+		ms_par.m_LT_eff_max = 1.0;
+		ms_par.m_HT_eff_max = 1.0;
+		ms_par.m_eta_mc = 0.89;
+		ms_par.m_eta_rc = 0.89;
+		ms_par.m_eta_t = 0.9;
+		ms_par.m_N_sub_hxrs = 10;
+		ms_par.m_P_high_limit = 25.E3;			//[kPa]
+		ms_par.m_tol = 1.E-3;
+		ms_par.m_opt_tol = 1.E-3;
+		ms_par.m_N_turbine = 3600.0;			//[rpm]
+		ms_par.m_is_recomp_ok = 1;
+		ms_par.m_PR_mc_guess = 2.5;
+		ms_par.m_fixed_PR_mc = false;
+	}
+};
+
+// Collects the design log messages
+static bool recomp_auto_opt_test_log(std::string &log_msg, std::string &progress_msg, void *data, double progress, int out_type)
+{
+	static_cast<std::vector<std::string>*>(data)->push_back(log_msg);
+	return true;
+}
+
+TEST_F(RecompCycleAutoOptTest, RepeatedOptimizationsAreIdentical_sco2_recompression_cycle)
+{
+	C_RecompCycle c_rc_ref;
+	int error_code = -1;
+	c_rc_ref.auto_opt_design(ms_par, error_code);
+	ASSERT_EQ(error_code, 0);
+
+	const C_RecompCycle::S_design_solved *p_ref = c_rc_ref.get_design_solved();
+	EXPECT_GT(p_ref->m_eta_thermal, 0.3);
+	EXPECT_LT(p_ref->m_eta_thermal, 0.6);
+	EXPECT_LE(p_ref->m_pres[C_RecompCycle::MC_OUT], ms_par.m_P_high_limit*1.0001);
+
+	for( int i_run = 0; i_run < 2; i_run++ )
+	{
+		C_RecompCycle c_rc;
+		error_code = -1;
+		c_rc.auto_opt_design(ms_par, error_code);
+		ASSERT_EQ(error_code, 0);
+
+		const C_RecompCycle::S_design_solved *p_solved = c_rc.get_design_solved();
+		EXPECT_EQ(p_solved->m_eta_thermal, p_ref->m_eta_thermal) << "run " << i_run;
+		EXPECT_EQ(p_solved->m_recomp_frac, p_ref->m_recomp_frac) << "run " << i_run;
+		EXPECT_EQ(p_solved->m_pres[C_RecompCycle::MC_OUT], p_ref->m_pres[C_RecompCycle::MC_OUT]) << "run " << i_run;
+		EXPECT_EQ(p_solved->m_UA_LT, p_ref->m_UA_LT) << "run " << i_run;
+	}
+}
+
+TEST_F(RecompCycleAutoOptTest, SimpleCycleOnly_sco2_recompression_cycle)
+{
+	ms_par.m_is_recomp_ok = 0;
+
+	C_RecompCycle c_rc;
+	int error_code = -1;
+	c_rc.auto_opt_design(ms_par, error_code);
+	ASSERT_EQ(error_code, 0);
+	EXPECT_EQ(c_rc.get_design_solved()->m_recomp_frac, 0.0);
+	EXPECT_GT(c_rc.get_design_solved()->m_eta_thermal, 0.3);
+}
+
+TEST_F(RecompCycleAutoOptTest, ThreadCountDoesNotChangeDesign_sco2_recompression_cycle)
+{
+	C_RecompCycle c_rc_serial;
+	c_rc_serial.set_n_threads(1);
+	int error_code = -1;
+	c_rc_serial.auto_opt_design(ms_par, error_code);
+	ASSERT_EQ(error_code, 0);
+	const C_RecompCycle::S_design_solved *p_serial = c_rc_serial.get_design_solved();
+
+	// Each thread count assigns the cases to the cycle copies differently
+	int n_threads[] = {2, 3, 5, 16};
+	for( int i = 0; i < 4; i++ )
+	{
+		C_RecompCycle c_rc;
+		c_rc.set_n_threads(n_threads[i]);
+		error_code = -1;
+		c_rc.auto_opt_design(ms_par, error_code);
+		ASSERT_EQ(error_code, 0);
+
+		const C_RecompCycle::S_design_solved *p_solved = c_rc.get_design_solved();
+		EXPECT_EQ(p_solved->m_eta_thermal, p_serial->m_eta_thermal) << n_threads[i] << " threads";
+		EXPECT_EQ(p_solved->m_recomp_frac, p_serial->m_recomp_frac) << n_threads[i] << " threads";
+		EXPECT_EQ(p_solved->m_pres[C_RecompCycle::MC_IN], p_serial->m_pres[C_RecompCycle::MC_IN]) << n_threads[i] << " threads";
+		EXPECT_EQ(p_solved->m_pres[C_RecompCycle::MC_OUT], p_serial->m_pres[C_RecompCycle::MC_OUT]) << n_threads[i] << " threads";
+		EXPECT_EQ(p_solved->m_UA_LT, p_serial->m_UA_LT) << n_threads[i] << " threads";
+	}
+}
+
+TEST_F(RecompCycleAutoOptTest, AtLeastSerialSweepOptimum_sco2_recompression_cycle)
+{
+	C_RecompCycle c_rc;
+	c_rc.set_n_threads(4);
+	int error_code = -1;
+	c_rc.auto_opt_design(ms_par, error_code);
+	ASSERT_EQ(error_code, 0);
+	double eta_auto_opt = c_rc.get_design_solved()->m_eta_thermal;
+
+	// Serial sweep of fixed high-side pressure recompression cycle optimizations, one cycle for all pressures
+	C_RecompCycle::S_opt_design_parameters opt_par;
+	opt_par.m_W_dot_net = ms_par.m_W_dot_net;
+	opt_par.m_T_mc_in = ms_par.m_T_mc_in;
+	opt_par.m_T_t_in = ms_par.m_T_t_in;
+	opt_par.m_DP_LT = ms_par.m_DP_LT;
+	opt_par.m_DP_HT = ms_par.m_DP_HT;
+	opt_par.m_DP_PC = ms_par.m_DP_PC;
+	opt_par.m_DP_PHX = ms_par.m_DP_PHX;
+	opt_par.m_UA_rec_total = ms_par.m_UA_rec_total;
+	opt_par.m_LT_eff_max = ms_par.m_LT_eff_max;
+	opt_par.m_HT_eff_max = ms_par.m_HT_eff_max;
+	opt_par.m_eta_mc = ms_par.m_eta_mc;
+	opt_par.m_eta_rc = ms_par.m_eta_rc;
+	opt_par.m_eta_t = ms_par.m_eta_t;
+	opt_par.m_N_sub_hxrs = ms_par.m_N_sub_hxrs;
+	opt_par.m_P_high_limit = ms_par.m_P_high_limit;
+	opt_par.m_tol = ms_par.m_tol;
+	opt_par.m_opt_tol = ms_par.m_opt_tol;
+	opt_par.m_N_turbine = ms_par.m_N_turbine;
+	opt_par.m_fixed_P_mc_out = true;
+	opt_par.m_fixed_PR_mc = false;
+	opt_par.m_recomp_frac_guess = 0.3;
+	opt_par.m_fixed_recomp_frac = false;
+	opt_par.m_LT_frac_guess = 0.5;
+	opt_par.m_fixed_LT_frac = false;
+
+	C_RecompCycle c_rc_sweep;
+	double eta_sweep_max = 0.0;
+	for( double P_high = 15.E3; P_high <= ms_par.m_P_high_limit; P_high += 1.E3 )
+	{
+		opt_par.m_P_mc_out_guess = P_high;		//[kPa]
+		opt_par.m_PR_mc_guess = PR_mc_guess_fixed_P_high(P_high, ms_par.m_T_mc_in);	//[-]
+		error_code = -1;
+		c_rc_sweep.opt_design(opt_par, error_code);
+		if( error_code == 0 )
+			eta_sweep_max = std::max(eta_sweep_max, c_rc_sweep.get_design_solved()->m_eta_thermal);
+	}
+	EXPECT_GT(eta_sweep_max, 0.3);
+	EXPECT_GE(eta_auto_opt, eta_sweep_max - 1.E-4);
+}
+
+TEST_F(RecompCycleAutoOptTest, HitEtaThreadCountDoesNotChangeDesign_sco2_recompression_cycle)
+{
+	C_RecompCycle::S_auto_opt_design_hit_eta_parameters hit_eta_par;
+	hit_eta_par.m_W_dot_net = ms_par.m_W_dot_net;
+	hit_eta_par.m_eta_thermal = 0.44;
+	hit_eta_par.m_T_mc_in = ms_par.m_T_mc_in;
+	hit_eta_par.m_T_t_in = ms_par.m_T_t_in;
+	hit_eta_par.m_DP_LT = ms_par.m_DP_LT;
+	hit_eta_par.m_DP_HT = ms_par.m_DP_HT;
+	hit_eta_par.m_DP_PC = ms_par.m_DP_PC;
+	hit_eta_par.m_DP_PHX = ms_par.m_DP_PHX;
+	hit_eta_par.m_LT_eff_max = ms_par.m_LT_eff_max;
+	hit_eta_par.m_HT_eff_max = ms_par.m_HT_eff_max;
+	hit_eta_par.m_eta_mc = ms_par.m_eta_mc;
+	hit_eta_par.m_eta_rc = ms_par.m_eta_rc;
+	hit_eta_par.m_eta_t = ms_par.m_eta_t;
+	hit_eta_par.m_N_sub_hxrs = ms_par.m_N_sub_hxrs;
+	hit_eta_par.m_P_high_limit = ms_par.m_P_high_limit;
+	hit_eta_par.m_tol = ms_par.m_tol;
+	hit_eta_par.m_opt_tol = ms_par.m_opt_tol;
+	hit_eta_par.m_N_turbine = ms_par.m_N_turbine;
+	hit_eta_par.m_is_recomp_ok = 1;
+	hit_eta_par.m_PR_mc_guess = ms_par.m_PR_mc_guess;
+	hit_eta_par.m_fixed_PR_mc = false;
+	hit_eta_par.mf_callback_log = recomp_auto_opt_test_log;
+
+	// Serial design, then one that solves the first two conductance guesses in parallel
+	std::vector<std::string> v_log_serial, v_log_parallel;
+	C_RecompCycle c_rc_serial, c_rc_parallel;
+	c_rc_serial.set_n_threads(1);
+	c_rc_parallel.set_n_threads(4);
+
+	int error_code = -1;
+	std::string error_msg;
+	hit_eta_par.mp_mf_active = &v_log_serial;
+	c_rc_serial.auto_opt_design_hit_eta(hit_eta_par, error_code, error_msg);
+	ASSERT_EQ(error_code, 0) << error_msg;
+
+	error_code = -1;
+	hit_eta_par.mp_mf_active = &v_log_parallel;
+	c_rc_parallel.auto_opt_design_hit_eta(hit_eta_par, error_code, error_msg);
+	ASSERT_EQ(error_code, 0) << error_msg;
+
+	const C_RecompCycle::S_design_solved *p_serial = c_rc_serial.get_design_solved();
+	const C_RecompCycle::S_design_solved *p_parallel = c_rc_parallel.get_design_solved();
+	EXPECT_NEAR(p_serial->m_eta_thermal, hit_eta_par.m_eta_thermal, 1.E-3);
+	EXPECT_EQ(p_parallel->m_eta_thermal, p_serial->m_eta_thermal);
+	EXPECT_EQ(p_parallel->m_UA_LT, p_serial->m_UA_LT);
+	EXPECT_EQ(p_parallel->m_UA_HT, p_serial->m_UA_HT);
+	EXPECT_EQ(p_parallel->m_recomp_frac, p_serial->m_recomp_frac);
+	EXPECT_EQ(p_parallel->m_pres[C_RecompCycle::MC_OUT], p_serial->m_pres[C_RecompCycle::MC_OUT]);
+
+	// Every conductance the solver tried is logged in the same order
+	EXPECT_GT(v_log_serial.size(), 2u);
+	EXPECT_EQ(v_log_parallel, v_log_serial);
+}
@@ -0,0 +1,180 @@
+#include <string>
+#include <vector>
+#include <thread>
+#include <chrono>
+
+#include <gtest/gtest.h>
+
+#include "../tcs/ud_power_cycle.h"
+
+/**
+* Tests for C_ud_pc_table_generator with parallel off-design functions: each function must solve
+* a fixed block of points in table order, so tables and errors don't depend on thread timing
+*/
+
+class C_warm_start_od_function : public C_od_pc_function
+{
+	// Result depends on the previous point solved, like a cycle that warm starts its solvers
+
+public:
+	std::vector<S_f_inputs> mv_inputs;
+	double m_W_dot_prev;
+	int m_n_calls;
+	double m_T_htf_fail;	//[C] Points at the high mass flow rate and at least this HTF temperature fail
+
+	C_warm_start_od_function()
+	{
+		m_W_dot_prev = 0.0;
+		m_n_calls = 0;
+		m_T_htf_fail = std::numeric_limits<double>::infinity();
+	}
+
+	virtual int operator()(S_f_inputs inputs, S_f_outputs & outputs)
+	{
+		mv_inputs.push_back(inputs);
+
+		// Vary the time each point takes so threads finish out of order
+		m_n_calls++;
+		std::this_thread::sleep_for(std::chrono::microseconds(200 * ((m_n_calls * 7) % 5)));
+
+		if( inputs.m_m_dot_htf_ND > 1.05 && inputs.m_T_htf_hot >= m_T_htf_fail )
+			return 3;
+
+		outputs.m_W_dot_gross_ND = inputs.m_T_htf_hot / 574.0 - 0.01*(inputs.m_T_amb - 35.0) + 0.1*(inputs.m_m_dot_htf_ND - 1.0)
+			+ 1.E-6*m_W_dot_prev;
+		outputs.m_Q_dot_in_ND = outputs.m_W_dot_gross_ND / 0.95;
+		outputs.m_W_dot_cooling_ND = 1.0 + 1.E-6*m_W_dot_prev;
+		outputs.m_m_dot_water_ND = 1.0;
+
+		m_W_dot_prev = outputs.m_W_dot_gross_ND;
+
+		return 0;
+	}
+};
+
+static int s_n_callbacks = 0;
+
+static bool test_callback(std::string &, std::string &, void *, double, int)
+{
+	s_n_callbacks++;
+	return true;
+}
+
+class UdpcTableGeneratorTest : public ::testing::Test
+{
+protected:
+	util::matrix_t<double> T_htf_ind, T_amb_ind, m_dot_htf_ind;
+
+	// Returns the error message, or "" if the tables were generated
+	std::string generate(C_warm_start_od_function &f_main, std::vector<C_warm_start_od_function> &v_f_parallel)
+	{
+		C_ud_pc_table_generator c_generator(f_main);
+		c_generator.mf_callback = test_callback;
+		c_generator.mp_mf_active = (void*)this;
+
+		std::vector<C_od_pc_function*> v_pc_eq;
+		for( size_t i = 0; i < v_f_parallel.size(); i++ )
+			v_pc_eq.push_back(&v_f_parallel[i]);
+		c_generator.set_parallel_functions(v_pc_eq);
+
+		s_n_callbacks = 0;
+		try
+		{
+			c_generator.generate_tables(574.0, 500.0, 600.0, 9,
+				35.0, 0.0, 45.0, 7,
+				1.0, 0.5, 1.1, 6,
+				T_htf_ind, T_amb_ind, m_dot_htf_ind);
+		}
+		catch( C_csp_exception &csp_exception )
+		{
+			return csp_exception.m_error_message;
+		}
+
+		return "";
+	}
+
+	static bool is_identical(const util::matrix_t<double> &a, const util::matrix_t<double> &b)
+	{
+		if( a.nrows() != b.nrows() || a.ncols() != b.ncols() )
+			return false;
+		for( size_t i = 0; i < a.nrows(); i++ )
+			for( size_t j = 0; j < a.ncols(); j++ )
+				if( a(i, j) != b(i, j) )
+					return false;
+		return true;
+	}
+};
+
+TEST_F(UdpcTableGeneratorTest, BlocksFollowSerialOrder_ud_power_cycle)
+{
+	C_warm_start_od_function f_serial;
+	std::vector<C_warm_start_od_function> v_none;
+	ASSERT_EQ(generate(f_serial, v_none), "");
+	int n_callbacks_serial = s_n_callbacks;
+	util::matrix_t<double> T_htf_serial = T_htf_ind, T_amb_serial = T_amb_ind, m_dot_serial = m_dot_htf_ind;
+
+	C_warm_start_od_function f_main;
+	std::vector<C_warm_start_od_function> v_f_parallel(3);
+	ASSERT_EQ(generate(f_main, v_f_parallel), "");
+	EXPECT_EQ(s_n_callbacks, n_callbacks_serial);
+
+	// The functions together solve the serial sequence of points, each one a contiguous piece of it
+	std::vector<C_od_pc_function::S_f_inputs> v_inputs = f_main.mv_inputs;
+	for( size_t i = 0; i < v_f_parallel.size(); i++ )
+	{
+		EXPECT_GT(v_f_parallel[i].mv_inputs.size(), (size_t)0);
+		v_inputs.insert(v_inputs.end(), v_f_parallel[i].mv_inputs.begin(), v_f_parallel[i].mv_inputs.end());
+	}
+	ASSERT_EQ(v_inputs.size(), f_serial.mv_inputs.size());
+	for( size_t i = 0; i < v_inputs.size(); i++ )
+	{
+		EXPECT_EQ(v_inputs[i].m_T_htf_hot, f_serial.mv_inputs[i].m_T_htf_hot) << "point " << i;
+		EXPECT_EQ(v_inputs[i].m_T_amb, f_serial.mv_inputs[i].m_T_amb) << "point " << i;
+		EXPECT_EQ(v_inputs[i].m_m_dot_htf_ND, f_serial.mv_inputs[i].m_m_dot_htf_ND) << "point " << i;
+	}
+
+	// Same table layout as the serial run
+	EXPECT_EQ(T_htf_ind.nrows(), T_htf_serial.nrows());
+	EXPECT_EQ(T_amb_ind.nrows(), T_amb_serial.nrows());
+	EXPECT_EQ(m_dot_htf_ind.nrows(), m_dot_serial.nrows());
+}
+
+TEST_F(UdpcTableGeneratorTest, RepeatedRunsAreIdentical_ud_power_cycle)
+{
+	C_warm_start_od_function f_ref;
+	std::vector<C_warm_start_od_function> v_f_ref(3);
+	ASSERT_EQ(generate(f_ref, v_f_ref), "");
+	util::matrix_t<double> T_htf_ref = T_htf_ind, T_amb_ref = T_amb_ind, m_dot_ref = m_dot_htf_ind;
+
+	for( int i_run = 0; i_run < 4; i_run++ )
+	{
+		C_warm_start_od_function f_main;
+		std::vector<C_warm_start_od_function> v_f_parallel(3);
+		ASSERT_EQ(generate(f_main, v_f_parallel), "");
+		EXPECT_TRUE(is_identical(T_htf_ind, T_htf_ref)) << "run " << i_run;
+		EXPECT_TRUE(is_identical(T_amb_ind, T_amb_ref)) << "run " << i_run;
+		EXPECT_TRUE(is_identical(m_dot_htf_ind, m_dot_ref)) << "run " << i_run;
+	}
+}
+
+TEST_F(UdpcTableGeneratorTest, FirstFailureInTableOrderIsReported_ud_power_cycle)
+{
+	C_warm_start_od_function f_serial;
+	f_serial.m_T_htf_fail = 560.0;
+	std::vector<C_warm_start_od_function> v_none;
+	std::string err_serial = generate(f_serial, v_none);
+	ASSERT_NE(err_serial, "");
+	int n_callbacks_serial = s_n_callbacks;
+
+	for( int i_run = 0; i_run < 3; i_run++ )
+	{
+		C_warm_start_od_function f_main;
+		std::vector<C_warm_start_od_function> v_f_parallel(3);
+		f_main.m_T_htf_fail = 560.0;
+		for( size_t i = 0; i < v_f_parallel.size(); i++ )
+			v_f_parallel[i].m_T_htf_fail = 560.0;
+
+		EXPECT_EQ(generate(f_main, v_f_parallel), err_serial) << "run " << i_run;
+		EXPECT_EQ(s_n_callbacks, n_callbacks_serial) << "run " << i_run;
+	}
+}